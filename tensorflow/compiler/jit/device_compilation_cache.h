@@ -16,11 +16,13 @@ limitations under the License.
 #ifndef TENSORFLOW_COMPILER_JIT_DEVICE_COMPILATION_CACHE_H_
 #define TENSORFLOW_COMPILER_JIT_DEVICE_COMPILATION_CACHE_H_
 
+#include <algorithm>
 #include <cstdint>
 #include <memory>
 #include <optional>
 #include <string>
 #include <utility>
+#include <vector>
 
 #include "absl/base/nullability.h"
 #include "absl/container/flat_hash_map.h"
@@ -60,15 +62,37 @@ inline int64_t ExecutableSize<xla::PjRtLoadedExecutable>(
 }
 }  // namespace device_compilation_cache_internal
 
+// Order in which `DeviceCompilationCache::Evict` releases executables.
+enum class DeviceCompilationCacheEvictionPolicy {
+  // Executables are never evicted and the cache grows without bound.
+  kNone,
+  // Least recently requested executables are evicted first.
+  kLru,
+  // Least frequently requested executables are evicted first. Ties are broken
+  // by recency.
+  kLfu,
+};
+
 // Cache to store compiled HLO, executables and related metadata keyed by
-// `DeviceCompilationClusterSignature`. The cache owns the stored
-// CompilationResults and Executables.
-// Currently no cache eviction policy is implemented and the cache grows without
-// bound.
+// `DeviceCompilationClusterSignature`. The cache shares ownership of the stored
+// CompilationResults and Executables with the values it returns, so that an
+// evicted executable stays alive until the last launch using it releases it.
+// By default no eviction policy is used and the cache grows without bound. With
+// an eviction policy and a byte budget, `Evict` releases executables until the
+// size of the executables held by the cache fits into the budget.
 template <typename ExecutableType>
 class DeviceCompilationCache {
  public:
+  struct Config {
+    DeviceCompilationCacheEvictionPolicy eviction_policy =
+        DeviceCompilationCacheEvictionPolicy::kNone;
+    // Budget for the total size of the executables held by the cache, as
+    // reported by `ExecutableSize`. Not enforced if <= 0.
+    int64_t max_executable_bytes = 0;
+  };
+
   DeviceCompilationCache() = default;
+  explicit DeviceCompilationCache(const Config& config) : config_(config) {}
   ~DeviceCompilationCache() = default;
 
   using Key = DeviceCompilationClusterSignature;
@@ -76,8 +100,8 @@ class DeviceCompilationCache {
     DeviceCompileState compile_state = DeviceCompileState::kUncompiled;
     absl::Status compilation_status;
     int64_t request_count = 0;
-    const XlaCompiler::CompilationResult* compilation_result = nullptr;
-    ExecutableType* executable = nullptr;
+    std::shared_ptr<const XlaCompiler::CompilationResult> compilation_result;
+    std::shared_ptr<ExecutableType> executable;
   };
 
   // Returns std::nullopt if value for the supplied key is not found. If a value
@@ -89,15 +113,31 @@ class DeviceCompilationCache {
   Value LookupOrCreate(const Key& key);
 
   // Caches `compile_state`, `compilation_status`, `compilation_result` and
-  // `executable` and associates them with the provided `key`. Takes ownership
+  // `executable` and associates them with the provided `key`. Shares ownership
   // of `compilation_result` and `executable`. Does not increment the
   // corresponding `request_count`. Only arguments that are not std::nullopt are
   // updated in the cache.
   void Store(const Key& key, std::optional<DeviceCompileState> compile_state,
              std::optional<absl::Status> compilation_status,
-             std::optional<std::unique_ptr<XlaCompiler::CompilationResult>>
+             std::optional<std::shared_ptr<XlaCompiler::CompilationResult>>
                  compilation_result,
-             std::optional<std::unique_ptr<ExecutableType>> executable);
+             std::optional<std::shared_ptr<ExecutableType>> executable);
+
+  // Evicts compiled entries, in the order given by the eviction policy, until
+  // the executables held by the cache fit into `max_executable_bytes`. The
+  // entry for `key_in_use` is never evicted. Evicted entries keep their
+  // `request_count` but drop their compilation result and executable and go
+  // back to `kUncompiled`, so that the next request compiles them again (or
+  // loads them from the persistent cache). Values returned earlier keep their
+  // compilation result and executable alive. Returns the evicted executables;
+  // the caller must release them once no program using them is running.
+  std::vector<std::shared_ptr<ExecutableType>> Evict(const Key& key_in_use);
+
+  // Returns the total size of the executables held by the cache.
+  int64_t executable_bytes() const {
+    mutex_lock lock(compile_cache_mu_);
+    return executable_bytes_;
+  }
 
   std::string DebugString() const;
 
@@ -134,24 +174,26 @@ class DeviceCompilationCache {
     // The number of times a compilation with this signature has been requested.
     int64_t request_count TF_GUARDED_BY(mu) = 0;
 
+    // Value of `use_clock_` at the last request of this signature.
+    int64_t last_use TF_GUARDED_BY(mu) = 0;
+
     // Did compilation succeed?
     absl::Status compilation_status TF_GUARDED_BY(mu);
 
     // Output of the XlaCompiler.
-    std::unique_ptr<XlaCompiler::CompilationResult> compilation_result
+    std::shared_ptr<XlaCompiler::CompilationResult> compilation_result
         TF_GUARDED_BY(mu);
 
     // The XLA executable compiled from <computation>. May be null if no
     // executable has been built.
-    std::unique_ptr<ExecutableType> executable TF_GUARDED_BY(mu);
+    std::shared_ptr<ExecutableType> executable TF_GUARDED_BY(mu);
+
+    // Size of `executable`, as accounted in `executable_bytes_`.
+    int64_t executable_size TF_GUARDED_BY(mu) = 0;
 
     std::string DebugString() const {
       mutex_lock lock(mu);
 
-      int64_t executable_size =
-          device_compilation_cache_internal::ExecutableSize<ExecutableType>(
-              executable.get());
-
       int64_t hlo_module_size = 0;
       if (compilation_result != nullptr &&
           compilation_result->computation != nullptr) {
@@ -169,9 +211,15 @@ class DeviceCompilationCache {
     }
   };
 
+  const Config config_;
+
   mutable mutex compile_cache_mu_;
   absl::flat_hash_map<Key, std::unique_ptr<Entry>, Key::Hash> cache_
       TF_GUARDED_BY(compile_cache_mu_);
+  // Logical clock advanced on every lookup, used to order entries by recency.
+  mutable int64_t use_clock_ TF_GUARDED_BY(compile_cache_mu_) = 0;
+  // Sum of `executable_size` over all entries.
+  int64_t executable_bytes_ TF_GUARDED_BY(compile_cache_mu_) = 0;
 
   DeviceCompilationCache(const DeviceCompilationCache&) = delete;
   void operator=(const DeviceCompilationCache&) = delete;
@@ -183,6 +231,7 @@ DeviceCompilationCache<ExecutableType>::Lookup(const Key& key) const {
   // The outer lock protects the existence of the cache entry. It does not
   // protect the contents of the cache entry.
   Entry* entry;
+  int64_t now;
   {
     mutex_lock lock(compile_cache_mu_);
     // Find cache entry.
@@ -192,14 +241,16 @@ DeviceCompilationCache<ExecutableType>::Lookup(const Key& key) const {
     }
 
     entry = it->second.get();
+    now = ++use_clock_;
   }
 
   mutex_lock lock(entry->mu);
+  entry->last_use = now;
   Value value = {/*compile_state=*/entry->compile_state,
                  /*compilation_status=*/entry->compilation_status,
                  /*request_count=*/++entry->request_count,
-                 /*compilation_result=*/entry->compilation_result.get(),
-                 /*executable=*/entry->executable.get()};
+                 /*compilation_result=*/entry->compilation_result,
+                 /*executable=*/entry->executable};
   return value;
 }
 
@@ -209,19 +260,22 @@ DeviceCompilationCache<ExecutableType>::LookupOrCreate(const Key& key) {
   // The outer lock protects the existence of the cache entry. It does not
   // protect the contents of the cache entry.
   Entry* entry;
+  int64_t now;
   {
     mutex_lock lock(compile_cache_mu_);
     // Emplace empty cache entry if not found.
     auto it = cache_.emplace(key, std::make_unique<Entry>()).first;
     entry = it->second.get();
+    now = ++use_clock_;
   }
 
   mutex_lock lock(entry->mu);
+  entry->last_use = now;
   Value value = {/*compile_state=*/entry->compile_state,
                  /*compilation_status=*/entry->compilation_status,
                  /*request_count=*/++entry->request_count,
-                 /*compilation_result=*/entry->compilation_result.get(),
-                 /*executable=*/entry->executable.get()};
+                 /*compilation_result=*/entry->compilation_result,
+                 /*executable=*/entry->executable};
   return value;
 }
 
@@ -229,9 +283,9 @@ template <typename ExecutableType>
 void DeviceCompilationCache<ExecutableType>::Store(
     const Key& key, std::optional<DeviceCompileState> compile_state,
     std::optional<absl::Status> compilation_status,
-    std::optional<std::unique_ptr<XlaCompiler::CompilationResult>>
+    std::optional<std::shared_ptr<XlaCompiler::CompilationResult>>
         compilation_result,
-    std::optional<std::unique_ptr<ExecutableType>> executable) {
+    std::optional<std::shared_ptr<ExecutableType>> executable) {
   Entry* entry;
   {
     mutex_lock lock(compile_cache_mu_);
@@ -240,6 +294,7 @@ void DeviceCompilationCache<ExecutableType>::Store(
     entry = it->second.get();
   }
 
+  int64_t executable_size_delta = 0;
   {
     mutex_lock lock(entry->mu);
     if (compile_state.has_value()) {
@@ -253,13 +308,83 @@ void DeviceCompilationCache<ExecutableType>::Store(
     }
     if (executable.has_value()) {
       entry->executable = std::move(*executable);
+      const int64_t executable_size =
+          device_compilation_cache_internal::ExecutableSize<ExecutableType>(
+              entry->executable.get());
+      executable_size_delta = executable_size - entry->executable_size;
+      entry->executable_size = executable_size;
     }
   }
+  if (executable_size_delta != 0) {
+    mutex_lock lock(compile_cache_mu_);
+    executable_bytes_ += executable_size_delta;
+  }
 
   VLOG(4) << "Added/updated cache entry: key=" << key.HumanString()
           << ", entry=" << entry->DebugString();
 }
 
+template <typename ExecutableType>
+std::vector<std::shared_ptr<ExecutableType>>
+DeviceCompilationCache<ExecutableType>::Evict(const Key& key_in_use) {
+  std::vector<std::shared_ptr<ExecutableType>> evicted;
+  if (config_.eviction_policy == DeviceCompilationCacheEvictionPolicy::kNone ||
+      config_.max_executable_bytes <= 0) {
+    return evicted;
+  }
+
+  mutex_lock lock(compile_cache_mu_);
+  if (executable_bytes_ <= config_.max_executable_bytes) {
+    return evicted;
+  }
+
+  struct Candidate {
+    int64_t request_count;
+    int64_t last_use;
+    Entry* entry;
+  };
+  std::vector<Candidate> candidates;
+  for (const auto& [key, entry] : cache_) {
+    if (entry == nullptr || key == key_in_use) continue;
+    mutex_lock entry_lock(entry->mu);
+    // Entries being compiled asynchronously are not evicted, the compilation
+    // thread stores into them once done.
+    if (entry->compile_state != DeviceCompileState::kCompiled ||
+        entry->executable == nullptr) {
+      continue;
+    }
+    candidates.push_back({entry->request_count, entry->last_use, entry.get()});
+  }
+
+  if (config_.eviction_policy == DeviceCompilationCacheEvictionPolicy::kLfu) {
+    std::sort(candidates.begin(), candidates.end(),
+              [](const Candidate& a, const Candidate& b) {
+                if (a.request_count != b.request_count) {
+                  return a.request_count < b.request_count;
+                }
+                return a.last_use < b.last_use;
+              });
+  } else {
+    std::sort(candidates.begin(), candidates.end(),
+              [](const Candidate& a, const Candidate& b) {
+                return a.last_use < b.last_use;
+              });
+  }
+
+  for (const Candidate& candidate : candidates) {
+    if (executable_bytes_ <= config_.max_executable_bytes) break;
+    Entry* entry = candidate.entry;
+    mutex_lock entry_lock(entry->mu);
+    executable_bytes_ -= entry->executable_size;
+    entry->executable_size = 0;
+    entry->compile_state = DeviceCompileState::kUncompiled;
+    entry->compilation_status = absl::OkStatus();
+    entry->compilation_result.reset();
+    evicted.push_back(std::move(entry->executable));
+  }
+  return evicted;
+}
+
 template <typename ExecutableType>
 std::string DeviceCompilationCache<ExecutableType>::DebugString() const {
   std::string s = "DeviceCompilationCache<ExecutableType> {\n";
@@ -15,6 +15,7 @@ limitations under the License.
 
 #include "tensorflow/compiler/jit/device_compilation_cache.h"
 
+#include <cstdint>
 #include <memory>
 #include <optional>
 #include <string>
@@ -24,10 +25,13 @@ limitations under the License.
 #include <gtest/gtest.h>
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
+#include "absl/strings/str_cat.h"
 #include "tensorflow/compiler/jit/xla_compile_util.h"
 #include "tensorflow/compiler/tf2xla/xla_compiler.h"
 #include "xla/hlo/builder/xla_computation.h"
 #include "xla/tsl/protobuf/error_codes.pb.h"
+#include "tensorflow/core/lib/core/threadpool.h"
+#include "tensorflow/core/platform/env.h"
 #include "tensorflow/core/platform/errors.h"
 #include "tensorflow/core/platform/test.h"
 
@@ -36,9 +40,22 @@ namespace {
 
 struct FakeExecutable {
   std::string data;
-  explicit FakeExecutable(const std::string& s) : data(s) {}
+  int64_t size = 0;
+  explicit FakeExecutable(const std::string& s, int64_t size = 0)
+      : data(s), size(size) {}
 };
 
+}  // namespace
+
+namespace device_compilation_cache_internal {
+template <>
+int64_t ExecutableSize<FakeExecutable>(const FakeExecutable* executable) {
+  return executable != nullptr ? executable->size : 0;
+}
+}  // namespace device_compilation_cache_internal
+
+namespace {
+
 using Cache = DeviceCompilationCache<FakeExecutable>;
 using Signature = DeviceCompilationClusterSignature;
 
@@ -273,5 +290,166 @@ TEST(DeviceCompilationCache, FinalizeWithNullComputation) {
   EXPECT_TRUE(cache_value->compilation_result->computation == nullptr);
 }
 
+void StoreCompiled(Cache* cache, const Signature& key, int64_t size) {
+  cache->Store(key, DeviceCompileState::kCompiled, absl::OkStatus(),
+               std::make_unique<XlaCompiler::CompilationResult>(),
+               std::make_unique<FakeExecutable>("exe", size));
+}
+
+TEST(DeviceCompilationCacheTest, NoEvictionByDefault) {
+  auto cache = std::make_unique<Cache>();
+
+  TF_ASSERT_OK_AND_ASSIGN(auto key1, BuildSampleSignature("foo"));
+  TF_ASSERT_OK_AND_ASSIGN(auto key2, BuildSampleSignature("bar"));
+  StoreCompiled(cache.get(), key1, 100);
+  StoreCompiled(cache.get(), key2, 100);
+
+  EXPECT_EQ(cache->executable_bytes(), 200);
+  EXPECT_TRUE(cache->Evict(key2).empty());
+  EXPECT_NE(cache->Lookup(key1)->executable, nullptr);
+}
+
+TEST(DeviceCompilationCacheTest, EvictLeastRecentlyUsed) {
+  Cache::Config config;
+  config.eviction_policy = DeviceCompilationCacheEvictionPolicy::kLru;
+  config.max_executable_bytes = 250;
+  auto cache = std::make_unique<Cache>(config);
+
+  TF_ASSERT_OK_AND_ASSIGN(auto key1, BuildSampleSignature("foo"));
+  TF_ASSERT_OK_AND_ASSIGN(auto key2, BuildSampleSignature("bar"));
+  TF_ASSERT_OK_AND_ASSIGN(auto key3, BuildSampleSignature("baz"));
+  for (const Signature& key : {key1, key2, key3}) {
+    cache->LookupOrCreate(key);
+    StoreCompiled(cache.get(), key, 100);
+  }
+  // `key1` is used more often, but less recently, than `key2`.
+  cache->Lookup(key1);
+  cache->Lookup(key1);
+  cache->Lookup(key2);
+  EXPECT_EQ(cache->executable_bytes(), 300);
+
+  auto evicted = cache->Evict(key3);
+  ASSERT_EQ(evicted.size(), 1);
+  EXPECT_EQ(cache->executable_bytes(), 200);
+
+  auto cache_value = cache->Lookup(key1);
+  EXPECT_EQ(cache_value->compile_state, DeviceCompileState::kUncompiled);
+  EXPECT_EQ(cache_value->request_count, 4);
+  EXPECT_EQ(cache_value->compilation_result, nullptr);
+  EXPECT_EQ(cache_value->executable, nullptr);
+  EXPECT_NE(cache->Lookup(key2)->executable, nullptr);
+  EXPECT_NE(cache->Lookup(key3)->executable, nullptr);
+}
+
+TEST(DeviceCompilationCacheTest, EvictLeastFrequentlyUsed) {
+  Cache::Config config;
+  config.eviction_policy = DeviceCompilationCacheEvictionPolicy::kLfu;
+  config.max_executable_bytes = 250;
+  auto cache = std::make_unique<Cache>(config);
+
+  TF_ASSERT_OK_AND_ASSIGN(auto key1, BuildSampleSignature("foo"));
+  TF_ASSERT_OK_AND_ASSIGN(auto key2, BuildSampleSignature("bar"));
+  TF_ASSERT_OK_AND_ASSIGN(auto key3, BuildSampleSignature("baz"));
+  for (const Signature& key : {key1, key2, key3}) {
+    cache->LookupOrCreate(key);
+    StoreCompiled(cache.get(), key, 100);
+  }
+  cache->Lookup(key1);
+  cache->Lookup(key1);
+  cache->Lookup(key2);
+
+  auto evicted = cache->Evict(key3);
+  ASSERT_EQ(evicted.size(), 1);
+  EXPECT_EQ(cache->executable_bytes(), 200);
+  EXPECT_NE(cache->Lookup(key1)->executable, nullptr);
+  EXPECT_EQ(cache->Lookup(key2)->executable, nullptr);
+  EXPECT_NE(cache->Lookup(key3)->executable, nullptr);
+}
+
+TEST(DeviceCompilationCacheTest, EvictKeepsEntryInUseAndCompilingEntries) {
+  Cache::Config config;
+  config.eviction_policy = DeviceCompilationCacheEvictionPolicy::kLru;
+  config.max_executable_bytes = 50;
+  auto cache = std::make_unique<Cache>(config);
+
+  TF_ASSERT_OK_AND_ASSIGN(auto key1, BuildSampleSignature("foo"));
+  TF_ASSERT_OK_AND_ASSIGN(auto key2, BuildSampleSignature("bar"));
+  StoreCompiled(cache.get(), key1, 100);
+  StoreCompiled(cache.get(), key2, 100);
+  cache->Store(key1, DeviceCompileState::kCompiling, std::nullopt,
+               std::nullopt, std::nullopt);
+
+  EXPECT_TRUE(cache->Evict(key2).empty());
+  EXPECT_EQ(cache->executable_bytes(), 200);
+}
+
+TEST(DeviceCompilationCacheTest, EvictedExecutableOutlivesLookedUpValue) {
+  Cache::Config config;
+  config.eviction_policy = DeviceCompilationCacheEvictionPolicy::kLru;
+  config.max_executable_bytes = 150;
+  auto cache = std::make_unique<Cache>(config);
+
+  TF_ASSERT_OK_AND_ASSIGN(auto key1, BuildSampleSignature("foo"));
+  TF_ASSERT_OK_AND_ASSIGN(auto key2, BuildSampleSignature("bar"));
+  StoreCompiled(cache.get(), key1, 100);
+  std::optional<Cache::Value> in_flight = cache->Lookup(key1);
+  ASSERT_TRUE(in_flight.has_value());
+
+  StoreCompiled(cache.get(), key2, 100);
+  auto evicted = cache->Evict(key2);
+  ASSERT_EQ(evicted.size(), 1);
+  EXPECT_EQ(evicted[0], in_flight->executable);
+  EXPECT_EQ(cache->Lookup(key1)->executable, nullptr);
+
+  // The launch that looked up `key1` before the eviction still owns it.
+  evicted.clear();
+  ASSERT_NE(in_flight->executable, nullptr);
+  EXPECT_EQ(in_flight->executable->data, "exe");
+  EXPECT_NE(in_flight->compilation_result, nullptr);
+}
+
+TEST(DeviceCompilationCacheTest, ConcurrentCompileWhileLaunching) {
+  Cache::Config config;
+  config.eviction_policy = DeviceCompilationCacheEvictionPolicy::kLru;
+  config.max_executable_bytes = 100;
+  auto cache = std::make_unique<Cache>(config);
+
+  constexpr int kNumKeys = 4;
+  constexpr int kNumIterations = 1000;
+  std::vector<Signature> keys;
+  for (int i = 0; i < kNumKeys; ++i) {
+    TF_ASSERT_OK_AND_ASSIGN(auto key,
+                            BuildSampleSignature(absl::StrCat("fn", i)));
+    keys.push_back(std::move(key));
+  }
+
+  {
+    thread::ThreadPool pool(Env::Default(), "launch", kNumKeys + 1);
+    // Recompiles each cluster in turn, evicting the others to stay within
+    // the budget.
+    pool.Schedule([&] {
+      for (int i = 0; i < kNumIterations; ++i) {
+        const Signature& key = keys[i % kNumKeys];
+        StoreCompiled(cache.get(), key, 100);
+        cache->Evict(key);
+      }
+    });
+    // Launches whatever is cached and uses it after releasing the cache lock.
+    for (int t = 0; t < kNumKeys; ++t) {
+      pool.Schedule([&, t] {
+        for (int i = 0; i < kNumIterations; ++i) {
+          std::optional<Cache::Value> value =
+              cache->Lookup(keys[(i + t) % kNumKeys]);
+          if (!value.has_value() || value->executable == nullptr) continue;
+          EXPECT_EQ(value->executable->data, "exe");
+          EXPECT_NE(value->compilation_result, nullptr);
+        }
+      });
+    }
+  }
+
+  EXPECT_LE(cache->executable_bytes(), 100);
+}
+
 }  // namespace
 }  // namespace tensorflow
@@ -16,6 +16,8 @@ limitations under the License.
 #ifndef TENSORFLOW_COMPILER_JIT_DEVICE_COMPILER_H_
 #define TENSORFLOW_COMPILER_JIT_DEVICE_COMPILER_H_
 
+#include <algorithm>
+#include <iterator>
 #include <memory>
 #include <optional>
 #include <string>
@@ -25,6 +27,7 @@ limitations under the License.
 #include "absl/algorithm/container.h"
 #include "absl/base/call_once.h"
 #include "absl/base/nullability.h"
+#include "absl/cleanup/cleanup.h"
 #include "absl/container/flat_hash_map.h"
 #include "absl/status/status.h"
 #include "absl/types/span.h"
@@ -54,6 +57,8 @@ namespace tensorflow {
 //
 // Caches the compiled XlaCompilationResult and Executable using a
 // DeviceCompilationCache. Compilation is done only when there's a cache miss.
+// With `--tf_xla_compilation_cache_eviction_policy`, executables are evicted
+// after a compilation once the cache exceeds its byte budget.
 //
 // Uses the DeviceExecutablePersistor class for persistence and tries to load a
 // serialized executable from disk upon a request for compilation. If the
@@ -100,13 +105,17 @@ class DeviceCompiler : public ResourceBase {
   // `ExecutableType` and sets `out_executable` to point to it. The
   // resulting executable pointer may be null if the computation has no
   // non-constant outputs.
+  //
+  // The outputs share ownership with the cache, so they stay valid even if the
+  // cache evicts them while the caller is still using them.
   absl::Status CompileIfNeeded(
       const XlaCompiler::Options& options, const NameAttrList& function,
       const std::vector<XlaCompiler::Argument>& args,
       const XlaCompiler::CompileOptions& compile_options,
       DeviceCompileMode compile_mode, DeviceCompilationProfiler* profiler,
-      const XlaCompiler::CompilationResult** out_compilation_result,
-      ExecutableType** out_executable);
+      std::shared_ptr<const XlaCompiler::CompilationResult>*
+          out_compilation_result,
+      std::shared_ptr<ExecutableType>* out_executable);
 
   // As above, but for a single op.
   absl::Status CompileSingleOpIfNeeded(
@@ -114,8 +123,9 @@ class DeviceCompiler : public ResourceBase {
       const std::vector<XlaCompiler::Argument>& args,
       const XlaCompiler::CompileOptions& compile_options, OpKernelContext* ctx,
       DeviceCompilationProfiler* profiler,
-      const XlaCompiler::CompilationResult** out_compilation_result,
-      ExecutableType** out_executable);
+      std::shared_ptr<const XlaCompiler::CompilationResult>*
+          out_compilation_result,
+      std::shared_ptr<ExecutableType>* out_executable);
 
   // An override that allows the caller to specify the function explicitly.
   absl::Status CompileSingleOpIfNeeded(
@@ -124,8 +134,9 @@ class DeviceCompiler : public ResourceBase {
       const std::vector<XlaCompiler::Argument>& args,
       const XlaCompiler::CompileOptions& compile_options, OpKernelContext* ctx,
       DeviceCompilationProfiler* profiler,
-      const XlaCompiler::CompilationResult** out_compilation_result,
-      ExecutableType** out_executable);
+      std::shared_ptr<const XlaCompiler::CompilationResult>*
+          out_compilation_result,
+      std::shared_ptr<ExecutableType>* out_executable);
 
   ClientType* client() const { return compiler_client_->client(); }
   const DeviceType& device_type() const { return persistor_->device_type(); }
@@ -149,8 +160,9 @@ class DeviceCompiler : public ResourceBase {
       const std::vector<XlaCompiler::Argument>& args, CompileScope scope,
       DeviceCompileMode compile_mode, OpKernelContext* ctx,
       DeviceCompilationProfiler* profiler,
-      const XlaCompiler::CompilationResult** out_compilation_result,
-      ExecutableType** out_executable);
+      std::shared_ptr<const XlaCompiler::CompilationResult>*
+          out_compilation_result,
+      std::shared_ptr<ExecutableType>* out_executable);
 
   StatusOr<typename DeviceCompilationCache<ExecutableType>::Value>
   CompileStrict(
@@ -180,6 +192,12 @@ class DeviceCompiler : public ResourceBase {
   // cache.
   void Finalize() override;
 
+  // Evicts executables from `cache_` once it exceeds its budget. Evicted
+  // executables are destroyed once no caller holds them anymore and the
+  // programs running on the device finished.
+  void EvictFromCache(const DeviceCompilationClusterSignature& sig_in_use)
+      TF_LOCKS_EXCLUDED(evicted_mu_);
+
   std::unique_ptr<DeviceExecutablePersistor<ExecutableType, ClientType>>
       persistor_;
   std::unique_ptr<DeviceCompilerClient<ExecutableType, ClientType>>
@@ -189,6 +207,12 @@ class DeviceCompiler : public ResourceBase {
   // Pool of threads for asynchronous compilations.
   std::unique_ptr<thread::ThreadPool> async_compiler_threads_;
 
+  // Executables evicted from `cache_` that callers still held when they were
+  // evicted.
+  mutex evicted_mu_;
+  std::vector<std::shared_ptr<ExecutableType>> evicted_executables_
+      TF_GUARDED_BY(evicted_mu_);
+
   mutex cluster_mutexes_mu_;
   absl::flat_hash_map<DeviceCompilationClusterSignature, std::unique_ptr<mutex>,
                       DeviceCompilationClusterSignature::Hash>
@@ -223,6 +247,25 @@ inline absl::Status EligibleToPersist(DeviceCompileState compile_state,
   }
   return absl::OkStatus();
 }
+
+template <typename ExecutableType>
+typename DeviceCompilationCache<ExecutableType>::Config
+GetCompilationCacheConfig() {
+  const XlaOpsCommonFlags* flags = GetXlaOpsCommonFlags();
+  typename DeviceCompilationCache<ExecutableType>::Config config;
+  const std::string& policy = flags->tf_xla_compilation_cache_eviction_policy;
+  if (policy == "lru") {
+    config.eviction_policy = DeviceCompilationCacheEvictionPolicy::kLru;
+  } else if (policy == "lfu") {
+    config.eviction_policy = DeviceCompilationCacheEvictionPolicy::kLfu;
+  } else if (!policy.empty() && policy != "none") {
+    LOG(WARNING) << "Unknown compilation cache eviction policy \"" << policy
+                 << "\", executables will not be evicted.";
+  }
+  config.max_executable_bytes =
+      flags->tf_xla_compilation_cache_max_executable_bytes;
+  return config;
+}
 }  // namespace device_compiler_internal
 
 template <typename ExecutableType, typename ClientType>
@@ -233,7 +276,8 @@ DeviceCompiler<ExecutableType, ClientType>::DeviceCompiler(
         compiler_client)
     : persistor_(std::move(persistor)),
       compiler_client_(std::move(compiler_client)) {
-  cache_ = std::make_unique<DeviceCompilationCache<ExecutableType>>();
+  cache_ = std::make_unique<DeviceCompilationCache<ExecutableType>>(
+      device_compiler_internal::GetCompilationCacheConfig<ExecutableType>());
   async_compiler_threads_ = std::make_unique<tensorflow::thread::ThreadPool>(
       tensorflow::Env::Default(), "async_compiler_threads",
       kNumAsyncDeviceCompilerThreads);
@@ -250,6 +294,10 @@ DeviceCompiler<ExecutableType, ClientType>::~DeviceCompiler() {
   // is destructed, which is dependent on the order of the members in the
   // DeviceCompiler class, which is error prone if the order changes.
   async_compiler_threads_.reset();
+  {
+    mutex_lock lock(evicted_mu_);
+    evicted_executables_.clear();
+  }
   // TODO(b/110813685): Think about the program ownership model. Programs are
   // currently owned by the compilation cache which means we must wait for
   // program completion in the destructor. There are multiple compilation caches
@@ -269,8 +317,9 @@ absl::Status DeviceCompiler<ExecutableType, ClientType>::CompileIfNeeded(
     const std::vector<XlaCompiler::Argument>& args,
     const XlaCompiler::CompileOptions& compile_options,
     DeviceCompileMode compile_mode, DeviceCompilationProfiler* profiler,
-    const XlaCompiler::CompilationResult** out_compilation_result,
-    ExecutableType** out_executable) {
+    std::shared_ptr<const XlaCompiler::CompilationResult>*
+        out_compilation_result,
+    std::shared_ptr<ExecutableType>* out_executable) {
   return CompileImpl(compile_options, options, function, Canonicalize(function),
                      args, CompileScope::kFunction, compile_mode,
                      /*ctx=*/nullptr, profiler, out_compilation_result,
@@ -295,8 +344,9 @@ DeviceCompiler<ExecutableType, ClientType>::CompileSingleOpIfNeeded(
     const std::vector<XlaCompiler::Argument>& args,
     const XlaCompiler::CompileOptions& compile_options, OpKernelContext* ctx,
     DeviceCompilationProfiler* profiler,
-    const XlaCompiler::CompilationResult** out_compilation_result,
-    ExecutableType** out_executable) {
+    std::shared_ptr<const XlaCompiler::CompilationResult>*
+        out_compilation_result,
+    std::shared_ptr<ExecutableType>* out_executable) {
   const NodeDef& def = ctx->op_kernel().def();
   const NameAttrList function = GetDeviceCompilerFunction(def);
   return CompileSingleOpIfNeeded(options, function, Canonicalize(function),
@@ -312,8 +362,9 @@ DeviceCompiler<ExecutableType, ClientType>::CompileSingleOpIfNeeded(
     const std::vector<XlaCompiler::Argument>& args,
     const XlaCompiler::CompileOptions& compile_options, OpKernelContext* ctx,
     DeviceCompilationProfiler* profiler,
-    const XlaCompiler::CompilationResult** out_compilation_result,
-    ExecutableType** out_executable) {
+    std::shared_ptr<const XlaCompiler::CompilationResult>*
+        out_compilation_result,
+    std::shared_ptr<ExecutableType>* out_executable) {
   return CompileImpl(compile_options, options, function, canonical_function,
                      args, CompileScope::kOp, DeviceCompileMode::kStrict, ctx,
                      profiler, out_compilation_result, out_executable);
@@ -336,9 +387,9 @@ DeviceCompiler<ExecutableType, ClientType>::CompileStrict(
   TfGraphToHloCompiler compiler(options);
   cache_value.compile_state = DeviceCompileState::kCompiled;
 
-  std::unique_ptr<ExecutableType> out_executable;
+  std::shared_ptr<ExecutableType> out_executable;
   auto out_compilation_result =
-      std::make_unique<XlaCompiler::CompilationResult>();
+      std::make_shared<XlaCompiler::CompilationResult>();
 
   if (scope == CompileScope::kOp) {
     cache_value.compilation_status = compiler.CompileSingleOp(
@@ -377,8 +428,8 @@ DeviceCompiler<ExecutableType, ClientType>::CompileStrict(
         compiler_client_.get()));
   }
 
-  cache_value.compilation_result = out_compilation_result.get();
-  cache_value.executable = out_executable.get();
+  cache_value.compilation_result = out_compilation_result;
+  cache_value.executable = out_executable;
   cache_->Store(sig, cache_value.compile_state, cache_value.compilation_status,
                 std::move(out_compilation_result), std::move(out_executable));
 
@@ -434,11 +485,51 @@ absl::Status DeviceCompiler<ExecutableType, ClientType>::CompileAsynchronous(
     if (!s.ok()) {
       cache_->Store(signature, std::nullopt, s.status(), std::nullopt,
                     std::nullopt);
+    } else {
+      EvictFromCache(signature);
     }
   });
   return absl::OkStatus();
 }
 
+template <typename ExecutableType, typename ClientType>
+void DeviceCompiler<ExecutableType, ClientType>::EvictFromCache(
+    const DeviceCompilationClusterSignature& sig_in_use) {
+  std::vector<std::shared_ptr<ExecutableType>> evicted =
+      cache_->Evict(sig_in_use);
+  if (!evicted.empty()) {
+    for (const std::shared_ptr<ExecutableType>& executable : evicted) {
+      metrics::UpdateXlaCompilationCacheEvictionCount(
+          device_compilation_cache_internal::ExecutableSize<ExecutableType>(
+              executable.get()));
+    }
+    VLOG(2) << "Evicted " << evicted.size()
+            << " executables from the compilation cache, "
+            << cache_->executable_bytes() << " bytes of executables remain.";
+  }
+
+  // Launches may still hold evicted executables. Only the ones nobody else
+  // holds are released here: their last launch released them before this
+  // point, so waiting for the programs running now covers every program
+  // launched from them.
+  std::vector<std::shared_ptr<ExecutableType>> unused;
+  {
+    mutex_lock lock(evicted_mu_);
+    for (std::shared_ptr<ExecutableType>& executable : evicted) {
+      evicted_executables_.push_back(std::move(executable));
+    }
+    auto in_use = std::partition(
+        evicted_executables_.begin(), evicted_executables_.end(),
+        [](const std::shared_ptr<ExecutableType>& executable) {
+          return executable.use_count() > 1;
+        });
+    std::move(in_use, evicted_executables_.end(), std::back_inserter(unused));
+    evicted_executables_.erase(in_use, evicted_executables_.end());
+  }
+  if (unused.empty()) return;
+  compiler_client_->WaitForProgramsToFinish();
+}
+
 template <typename ExecutableType, typename ClientType>
 void DeviceCompiler<ExecutableType, ClientType>::Finalize() {
   const mutex_lock lock(cluster_mutexes_mu_);
@@ -471,8 +562,9 @@ absl::Status DeviceCompiler<ExecutableType, ClientType>::CompileImpl(
     const std::vector<XlaCompiler::Argument>& args, CompileScope scope,
     DeviceCompileMode compile_mode, OpKernelContext* ctx,
     DeviceCompilationProfiler* profiler,
-    const XlaCompiler::CompilationResult** out_compilation_result,
-    ExecutableType** out_executable) {
+    std::shared_ptr<const XlaCompiler::CompilationResult>*
+        out_compilation_result,
+    std::shared_ptr<ExecutableType>* out_executable) {
   DCHECK_NE(out_executable, nullptr);
   VLOG(2) << "DeviceCompiler::Compile " << DebugString();
 
@@ -502,11 +594,23 @@ absl::Status DeviceCompiler<ExecutableType, ClientType>::CompileImpl(
     VLOG(2) << "DeviceCompilationClusterSignature: " << human_signature;
   }
 
-  // Acquire the cache entry lock and compile, if necessary.
-  // TODO(phawkins): this locking will need to be restructured when we implement
-  // cache eviction.
+  // Eviction runs once the cluster lock below is released, so that waiting for
+  // the programs of evicted executables does not block other requests for this
+  // signature. Evicting entries that are in use is safe, since the cache only
+  // hands out owning references to compilation results and executables.
+  bool compiled = false;
+  absl::Cleanup evict_from_cache = [&] {
+    if (compiled) EvictFromCache(signature);
+  };
+
+  // Acquire the cache entry lock and compile, if necessary. The lock only
+  // serializes compilations of one signature.
   mutex_lock cluster_compile_lock(*cluster_mutex);
   auto cache_value = cache_->LookupOrCreate(signature);
+  if (cache_value.compile_state != DeviceCompileState::kCompiling) {
+    metrics::UpdateXlaCompilationCacheLookupCount(
+        cache_value.compile_state == DeviceCompileState::kCompiled);
+  }
 
   int64_t current_request_count = cache_value.request_count;
   VLOG(2) << "Compilation cache entry hit: "
@@ -515,8 +619,8 @@ absl::Status DeviceCompiler<ExecutableType, ClientType>::CompileImpl(
           << current_request_count;
 
   DeviceCompileState state = cache_value.compile_state;
-  *out_compilation_result = nullptr;
-  *out_executable = nullptr;
+  out_compilation_result->reset();
+  out_executable->reset();
 
   // Check if the requested entry is uncompiled and return an error if
   // compilation is disabled. This will raise an error for kLazy even if we have
@@ -553,6 +657,7 @@ absl::Status DeviceCompiler<ExecutableType, ClientType>::CompileImpl(
           cache_value,
           CompileStrict(signature, compile_options, options, args, function,
                         cache_value, scope, ctx, profiler, cluster_mutex));
+      compiled = true;
     }
   } else if (state == DeviceCompileState::kCompiling) {
     VLOG(2) << "Ongoing asynchronous compilation for signature: "
@@ -47,8 +47,8 @@ TEST(DeviceCompilerTest, TestDisabledXlaCompilation) {
   xla::LocalClient* client = xla::ClientLibrary::LocalClientOrDie();
   DeviceType device_type = DeviceType(DEVICE_CPU_XLA_JIT);
 
-  const XlaCompiler::CompilationResult* compilation_result;
-  xla::LocalExecutable* executable;
+  std::shared_ptr<const XlaCompiler::CompilationResult> compilation_result;
+  std::shared_ptr<xla::LocalExecutable> executable;
 
   using XlaDeviceExecutablePersistor =
       DeviceExecutablePersistor<xla::LocalExecutable, xla::LocalClient>;
@@ -221,8 +221,8 @@ class DeviceCompilerTest : public ::testing::Test {
 };
 
 TEST_F(DeviceCompilerTest, CompileStrictSuccess) {
-  const XlaCompiler::CompilationResult* compilation_result = nullptr;
-  xla::LocalExecutable* xla_executable = nullptr;
+  std::shared_ptr<const XlaCompiler::CompilationResult> compilation_result;
+  std::shared_ptr<xla::LocalExecutable> xla_executable;
 
   XlaCompiler::Options options = GetDefaultXlaOptions();
 
@@ -239,8 +239,8 @@ TEST_F(DeviceCompilerTest, CompileStrictSuccess) {
 }
 
 TEST_F(DeviceCompilerTest, CompileShouldCompileClusterFalse) {
-  const XlaCompiler::CompilationResult* compilation_result = nullptr;
-  xla::LocalExecutable* xla_executable = nullptr;
+  std::shared_ptr<const XlaCompiler::CompilationResult> compilation_result;
+  std::shared_ptr<xla::LocalExecutable> xla_executable;
 
   XlaCompiler::Options options = GetDefaultXlaOptions();
 
@@ -263,8 +263,8 @@ TEST_F(DeviceCompilerTest, CompileShouldCompileClusterFalse) {
 }
 
 TEST_F(DeviceCompilerTest, CompileCacheHit) {
-  const XlaCompiler::CompilationResult* compilation_result = nullptr;
-  xla::LocalExecutable* xla_executable = nullptr;
+  std::shared_ptr<const XlaCompiler::CompilationResult> compilation_result;
+  std::shared_ptr<xla::LocalExecutable> xla_executable;
 
   XlaCompiler::Options options = GetDefaultXlaOptions();
 
@@ -279,8 +279,8 @@ TEST_F(DeviceCompilerTest, CompileCacheHit) {
   EXPECT_TRUE(compilation_result != nullptr);
   EXPECT_TRUE(xla_executable != nullptr);
 
-  const XlaCompiler::CompilationResult* new_compilation_result = nullptr;
-  xla::LocalExecutable* new_xla_executable = nullptr;
+  std::shared_ptr<const XlaCompiler::CompilationResult> new_compilation_result;
+  std::shared_ptr<xla::LocalExecutable> new_xla_executable;
 
   // Request compiling the same function again.
   TF_EXPECT_OK(xla_device_compiler_->CompileIfNeeded(
@@ -296,8 +296,8 @@ TEST_F(DeviceCompilerTest, CompileCacheHit) {
 }
 
 TEST_F(DeviceCompilerTest, CompileAsyncSuccess) {
-  const XlaCompiler::CompilationResult* compilation_result = nullptr;
-  xla::LocalExecutable* xla_executable = nullptr;
+  std::shared_ptr<const XlaCompiler::CompilationResult> compilation_result;
+  std::shared_ptr<xla::LocalExecutable> xla_executable;
 
   XlaCompiler::Options options = GetDefaultXlaOptions();
 
@@ -358,8 +358,8 @@ TEST_F(DeviceCompilerTest, CompilePersistentCacheEnabled) {
   auto args = SampleArgsForAddXY();
   XlaCompiler::Options options = GetDefaultXlaOptions();
 
-  const XlaCompiler::CompilationResult* compilation_result = nullptr;
-  xla::LocalExecutable* xla_executable = nullptr;
+  std::shared_ptr<const XlaCompiler::CompilationResult> compilation_result;
+  std::shared_ptr<xla::LocalExecutable> xla_executable;
 
   TF_EXPECT_OK(xla_device_compiler->CompileIfNeeded(
       options, fn, args, XlaCompiler::CompileOptions{},
@@ -389,8 +389,8 @@ TEST_F(DeviceCompilerTest, CompilePersistentCacheEnabled) {
   auto profiler = new DeviceCompilationProfiler();
   core::ScopedUnref profiler_ref(profiler);
 
-  const XlaCompiler::CompilationResult* compilation_result_2 = nullptr;
-  xla::LocalExecutable* xla_executable_2 = nullptr;
+  std::shared_ptr<const XlaCompiler::CompilationResult> compilation_result_2;
+  std::shared_ptr<xla::LocalExecutable> xla_executable_2;
   TF_EXPECT_OK(xla_device_compiler_2->CompileIfNeeded(
       options, fn, args, XlaCompiler::CompileOptions{},
       DeviceCompileMode::kStrict, profiler, &compilation_result_2,
@@ -417,8 +417,8 @@ TEST_F(DeviceCompilerTest, CompileFailedToLoadFromPersistentCache) {
   auto args = SampleArgsForAddXY();
   XlaCompiler::Options options = GetDefaultXlaOptions();
 
-  const XlaCompiler::CompilationResult* compilation_result = nullptr;
-  xla::LocalExecutable* xla_executable = nullptr;
+  std::shared_ptr<const XlaCompiler::CompilationResult> compilation_result;
+  std::shared_ptr<xla::LocalExecutable> xla_executable;
 
   // Persist an executable.
   TF_EXPECT_OK(xla_device_compiler->CompileIfNeeded(
@@ -452,8 +452,8 @@ TEST_F(DeviceCompilerTest, CompileFailedToLoadFromPersistentCache) {
       CreateXlaDeviceCompiler(/*enable_persistence=*/true);
   core::ScopedUnref xla_device_compiler_ref_2(xla_device_compiler_2);
 
-  const XlaCompiler::CompilationResult* compilation_result_2 = nullptr;
-  xla::LocalExecutable* xla_executable_2 = nullptr;
+  std::shared_ptr<const XlaCompiler::CompilationResult> compilation_result_2;
+  std::shared_ptr<xla::LocalExecutable> xla_executable_2;
 
   EXPECT_FALSE(xla_device_compiler_2
                    ->CompileIfNeeded(options, fn, args,
@@ -479,8 +479,8 @@ TEST_F(DeviceCompilerTest, CompileStrictPersistentCacheFailedToPersist) {
   auto args = SampleArgsForAddXY();
   XlaCompiler::Options options = GetDefaultXlaOptions();
 
-  const XlaCompiler::CompilationResult* compilation_result = nullptr;
-  xla::LocalExecutable* xla_executable = nullptr;
+  std::shared_ptr<const XlaCompiler::CompilationResult> compilation_result;
+  std::shared_ptr<xla::LocalExecutable> xla_executable;
 
   auto persistor = absl::down_cast<MockXlaDeviceExecutablePersistor*>(
       xla_device_compiler->persistor());
@@ -527,8 +527,8 @@ TEST_F(DeviceCompilerTestWithDump, CompileStrictDebugInformationDumpWorks) {
 
   // Now we run the compilation. We only care that `CompileStrict` has been
   // actually called, and we don't care about whether it succeeded.
-  const XlaCompiler::CompilationResult* compilation_result = nullptr;
-  xla::LocalExecutable* xla_executable = nullptr;
+  std::shared_ptr<const XlaCompiler::CompilationResult> compilation_result;
+  std::shared_ptr<xla::LocalExecutable> xla_executable;
   XlaCompiler::Options options = GetDefaultXlaOptions();
   XlaCompiler::CompileOptions compile_options;
   NameAttrList fn;
@@ -612,8 +612,8 @@ TEST_F(OpsTestBase, CompileSingleOpSuccess) {
   auto profiler = new DeviceCompilationProfiler();
   core::ScopedUnref profiler_ref(profiler);
 
-  const XlaCompiler::CompilationResult* compilation_result = nullptr;
-  xla::LocalExecutable* xla_executable = nullptr;
+  std::shared_ptr<const XlaCompiler::CompilationResult> compilation_result;
+  std::shared_ptr<xla::LocalExecutable> xla_executable;
 
   XlaOpRegistry::RegisterCompilationKernels();
   auto flib_def = std::make_unique<FunctionLibraryDefinition>(
@@ -648,8 +648,8 @@ TEST_F(DeviceCompilerTest, Finalize) {
   NameAttrList fn;
   fn.set_name("foo");
 
-  const XlaCompiler::CompilationResult* compilation_result = nullptr;
-  xla::LocalExecutable* xla_executable = nullptr;
+  std::shared_ptr<const XlaCompiler::CompilationResult> compilation_result;
+  std::shared_ptr<xla::LocalExecutable> xla_executable;
   TF_EXPECT_OK(xla_device_compiler_->CompileIfNeeded(
       options, fn, SampleArgsForAddXY(), XlaCompiler::CompileOptions{},
       DeviceCompileMode::kStrict, profiler_, &compilation_result,
@@ -265,6 +265,8 @@ void AllocateAndParseFlags() {
   ops_flags = new XlaOpsCommonFlags;
   ops_flags->tf_xla_always_defer_compilation = false;
   ops_flags->tf_xla_async_compilation = false;
+  ops_flags->tf_xla_compilation_cache_eviction_policy = "none";
+  ops_flags->tf_xla_compilation_cache_max_executable_bytes = 0;
   ops_flags->tf_xla_use_device_api.enabled_for_xla_launch_ = true;
   ops_flags->tf_xla_use_device_api.enabled_for_compile_on_demand_ = true;
   ops_flags->tf_xla_use_device_api.enabled_for_compile_and_run_ = true;
@@ -343,6 +345,20 @@ void AllocateAndParseFlags() {
             "When lazy compilation is enabled, asynchronous compilation starts "
             "the cluster compilation in the background, and the fallback path "
             "is executed until the compilation has finished."),
+       Flag("tf_xla_compilation_cache_eviction_policy",
+            &ops_flags->tf_xla_compilation_cache_eviction_policy,
+            "Order in which compiled executables are evicted from the "
+            "compilation cache once it exceeds "
+            "tf_xla_compilation_cache_max_executable_bytes: \"none\", \"lru\" "
+            "or \"lfu\". Evicted clusters are recompiled, or loaded from "
+            "tf_xla_persistent_cache_directory if set, when requested again. "
+            "Defaults to \"none\"."),
+       Flag("tf_xla_compilation_cache_max_executable_bytes",
+            &ops_flags->tf_xla_compilation_cache_max_executable_bytes,
+            "Budget for the total size of the executables held by the "
+            "compilation cache of a device. Only used together with "
+            "tf_xla_compilation_cache_eviction_policy. Defaults to 0 "
+            "(unbounded)."),
        Flag("tf_xla_use_device_api_for_xla_launch",
             &ops_flags->tf_xla_use_device_api.enabled_for_xla_launch_,
             "If true, uses Device API (PjRt) for single device compilation and "
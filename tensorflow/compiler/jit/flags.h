@@ -151,6 +151,11 @@ struct XlaOpsCommonFlags {
   // If true, _XlaCompile compiles the cluster asynchronously with respect to
   // the main execution. The fallback path is taken while compilation happens.
   bool tf_xla_async_compilation;
+  // Eviction policy of the compilation cache: "none", "lru" or "lfu".
+  std::string tf_xla_compilation_cache_eviction_policy;
+  // Budget for the total size of the executables held by the compilation cache
+  // of a device. Only enforced with an eviction policy and if positive.
+  int64_t tf_xla_compilation_cache_max_executable_bytes;
 
   class PjRtForSingleDeviceCompilationRollout {
    public:
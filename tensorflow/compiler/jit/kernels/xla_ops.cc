@@ -126,12 +126,12 @@ template <typename ExecutableType, typename ClientType>
 class ExecutableClosure {
  public:
   explicit ExecutableClosure(
-      ClientType* client, ExecutableType* executable,
-      const XlaCompiler::CompilationResult* compilation_result,
+      ClientType* client, std::shared_ptr<ExecutableType> executable,
+      std::shared_ptr<const XlaCompiler::CompilationResult> compilation_result,
       ResourceVarsSnapshot resource_var_snapshots, int num_constant_args)
       : client_(client),
-        executable_(executable),
-        compilation_result_(compilation_result),
+        executable_(std::move(executable)),
+        compilation_result_(std::move(compilation_result)),
         resource_var_snapshots_(std::move(resource_var_snapshots)),
         num_constant_args_(num_constant_args) {}
 
@@ -139,9 +139,9 @@ class ExecutableClosure {
   ExecutableClosure& operator=(ExecutableClosure&&) = default;
 
   ClientType* client() const { return client_; }
-  ExecutableType* executable() const { return executable_; }
+  ExecutableType* executable() const { return executable_.get(); }
   const XlaCompiler::CompilationResult* compilation_result() const {
-    return compilation_result_;
+    return compilation_result_.get();
   }
   const ResourceVarsSnapshot& resource_var_snapshots() const {
     return resource_var_snapshots_;
@@ -150,8 +150,10 @@ class ExecutableClosure {
 
  private:
   ClientType* client_;
-  ExecutableType* executable_;
-  const XlaCompiler::CompilationResult* compilation_result_;
+  // Shared with the compilation cache, so that evicting the cluster from the
+  // cache does not free them before XlaRun consumes the closure.
+  std::shared_ptr<ExecutableType> executable_;
+  std::shared_ptr<const XlaCompiler::CompilationResult> compilation_result_;
   ResourceVarsSnapshot resource_var_snapshots_;
   int num_constant_args_;
 
@@ -397,8 +399,8 @@ absl::Status CompileToLocalExecutable(
     const std::vector<XlaCompiler::Argument>& args,
     DeviceCompileMode compile_mode, bool may_alias_resource_update,
     xla::LocalClient** client,
-    const XlaCompiler::CompilationResult** compilation_result,
-    xla::LocalExecutable** executable) {
+    std::shared_ptr<const XlaCompiler::CompilationResult>* compilation_result,
+    std::shared_ptr<xla::LocalExecutable>* executable) {
   // We store information about the JIT-compiled XLA computation
   // in the ResourceMgr.
   ResourceMgr* rm = ctx->resource_manager();
@@ -515,13 +517,15 @@ void XlaLocalLaunchBase::ComputeAsync(OpKernelContext* ctx, DoneCallback done) {
 
   std::vector<const Tensor*> inputs = InputsFromContext(ctx);
   std::vector<XlaCompiler::Argument> xla_compiler_args;
-  const XlaCompiler::CompilationResult* compilation_result;
+  // The compilation result and executables are shared with the compilation
+  // cache and stay alive until the launch is done, even if they are evicted.
+  std::shared_ptr<const XlaCompiler::CompilationResult> compilation_result;
 
-  xla::LocalClient* client;          // Not owned.
-  xla::LocalExecutable* executable;  // Not owned.
+  xla::LocalClient* client;  // Not owned.
+  std::shared_ptr<xla::LocalExecutable> executable;
 
-  xla::PjRtClient* pjrt_client;                // Not owned.
-  xla::PjRtLoadedExecutable* pjrt_executable;  // Not owned.
+  xla::PjRtClient* pjrt_client;  // Not owned.
+  std::shared_ptr<xla::PjRtLoadedExecutable> pjrt_executable;
 
   // Note that here we assume the shape of the variables don't change between
   // compilation and execution. The locks on the variables are released before
@@ -583,7 +587,7 @@ void XlaLocalLaunchBase::ComputeAsync(OpKernelContext* ctx, DoneCallback done) {
         OP_REQUIRES_OK_ASYNC(
             ctx,
             RunPjRtExecutable(inputs, variable_infos, *compilation_result,
-                              pjrt_client, pjrt_executable, ctx),
+                              pjrt_client, pjrt_executable.get(), ctx),
             done);
       }
       VLOG(2) << "Done executing with PJRT.";
@@ -630,7 +634,7 @@ void XlaLocalLaunchBase::ComputeAsync(OpKernelContext* ctx, DoneCallback done) {
           executable->executable()->module().input_output_alias_config();
       absl::StatusOr<std::vector<xla::ExecutionInput>> execution_inputs =
           launch_context.PopulateInputs(
-              ctx, compilation_result, resource_var_ptrs,
+              ctx, compilation_result.get(), resource_var_ptrs,
               /*missing_ctx_input_prefix=*/0, input_output_alias);
       OP_REQUIRES_OK_ASYNC(ctx, execution_inputs.status(), done);
 
@@ -654,14 +658,14 @@ void XlaLocalLaunchBase::ComputeAsync(OpKernelContext* ctx, DoneCallback done) {
 
       absl::StatusOr<xla::ExecutionOutput> execution_output = RunExecutable(
           platform_info, launch_context, std::move(*execution_inputs),
-          run_options, executable, ctx, allocator.get());
+          run_options, executable.get(), ctx, allocator.get());
       OP_REQUIRES_ASYNC(ctx, execution_output.ok(), execution_output.status(),
                         done);
 
       OP_REQUIRES_OK_ASYNC(
           ctx,
           launch_context.PopulateOutputs(
-              ctx, compilation_result, execution_output->ConsumeResult(),
+              ctx, compilation_result.get(), execution_output->ConsumeResult(),
               /*missing_ctx_input_prefix=*/0, absl::MakeSpan(variable_infos),
               input_output_alias, resource_var_ptrs),
           done);
@@ -761,11 +765,11 @@ XlaCompileOp::XlaCompileOp(OpKernelConstruction* ctx)
 void XlaCompileOp::Compute(OpKernelContext* ctx) {
   VLOG(3) << "XlaCompileOp " << def().name()
           << (must_compile_ ? "(must-compile)" : "");
-  const XlaCompiler::CompilationResult* kernel = nullptr;
+  std::shared_ptr<const XlaCompiler::CompilationResult> kernel;
   xla::LocalClient* client = nullptr;
-  xla::LocalExecutable* executable = nullptr;
+  std::shared_ptr<xla::LocalExecutable> executable;
   xla::PjRtClient* pjrt_client = nullptr;
-  xla::PjRtLoadedExecutable* pjrt_executable = nullptr;
+  std::shared_ptr<xla::PjRtLoadedExecutable> pjrt_executable;
   ResourceVarsSnapshot variables_snapshot;
 
   std::vector<const Tensor*> inputs = InputsFromContext(ctx);
@@ -857,15 +861,15 @@ void XlaCompileOp::Compute(OpKernelContext* ctx) {
   if (use_pjrt) {
     PjRtExecutableClosureStore::KeyT key =
         PjRtExecutableClosureStore::Global()->Produce(PjRtExecutableClosure(
-            pjrt_client, pjrt_executable, kernel, std::move(variables_snapshot),
-            constants_.size()));
+            pjrt_client, std::move(pjrt_executable), std::move(kernel),
+            std::move(variables_snapshot), constants_.size()));
     compilation_key.flat<tstring>()(0) = key;
     VLOG(2) << "Compiled with PJRT. compilation_key: " << key;
   } else {
     XlaExecutableClosureStore::KeyT key =
         XlaExecutableClosureStore::Global()->Produce(XlaExecutableClosure(
-            client, executable, kernel, std::move(variables_snapshot),
-            constants_.size()));
+            client, std::move(executable), std::move(kernel),
+            std::move(variables_snapshot), constants_.size()));
     compilation_key.flat<tstring>()(0) = key;
     VLOG(2) << "Compiled with XLA. compilation_key: " << key;
   }
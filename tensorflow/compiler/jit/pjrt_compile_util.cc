@@ -15,6 +15,7 @@ limitations under the License.
 
 #include "tensorflow/compiler/jit/pjrt_compile_util.h"
 
+#include <memory>
 #include <vector>
 
 #include "tensorflow/compiler/jit/device_compilation_profiler.h"
@@ -44,8 +45,10 @@ absl::Status CompileToPjRtLoadedExecutable(
     const std::vector<XlaCompiler::Argument>& args,
     DeviceCompileMode compile_mode, bool has_ref_vars,
     bool may_alias_resource_update, FunctionLibraryRuntime* flr,
-    ResourceMgr* rm, const XlaCompiler::CompilationResult** compilation_result,
-    xla::PjRtClient** client, xla::PjRtLoadedExecutable** executable) {
+    ResourceMgr* rm,
+    std::shared_ptr<const XlaCompiler::CompilationResult>* compilation_result,
+    xla::PjRtClient** client,
+    std::shared_ptr<xla::PjRtLoadedExecutable>* executable) {
   PjRtDeviceCompiler* pjrt_device_compiler;
   DeviceCompilationProfiler* profiler;
   TF_RETURN_IF_ERROR(GetOrCreatePjRtDeviceCompilerAndProfiler(
@@ -76,8 +79,9 @@ absl::Status CompileToPjRtLoadedExecutable(
     const std::vector<XlaCompiler::Argument>& args,
     DeviceCompileMode compile_mode, bool has_ref_vars,
     bool may_alias_resource_update,
-    const XlaCompiler::CompilationResult** compilation_result,
-    xla::PjRtClient** client, xla::PjRtLoadedExecutable** executable) {
+    std::shared_ptr<const XlaCompiler::CompilationResult>* compilation_result,
+    xla::PjRtClient** client,
+    std::shared_ptr<xla::PjRtLoadedExecutable>* executable) {
   TF_ASSIGN_OR_RETURN(ResourceMgr * rm, GetResourceMgrForDeviceCompiler(
                                             ctx, platform_info.device_type()));
   return CompileToPjRtLoadedExecutable(
@@ -15,6 +15,9 @@ limitations under the License.
 #ifndef TENSORFLOW_COMPILER_JIT_PJRT_COMPILE_UTIL_H_
 #define TENSORFLOW_COMPILER_JIT_PJRT_COMPILE_UTIL_H_
 
+#include <memory>
+#include <vector>
+
 #include "tensorflow/compiler/jit/xla_compile_util.h"
 #include "tensorflow/compiler/jit/xla_platform_info.h"
 #include "tensorflow/compiler/tf2xla/xla_compiler.h"
@@ -29,15 +32,17 @@ namespace tensorflow {
 // Compiles a `function` to PjRtLoadedExecutable `executable` with `ctx`.
 // The compilation result is output in `compilation_result`. The PJRT client
 // used for compilation is output in `client`. The PJRT executable is output in
-// `executable`.
+// `executable`. The compilation result and executable share ownership with the
+// compilation cache, so they outlive an eviction from the cache.
 absl::Status CompileToPjRtLoadedExecutable(
     const OpKernelContext& ctx, const XlaPlatformInfo& platform_info,
     const NameAttrList& function,
     const std::vector<XlaCompiler::Argument>& args,
     DeviceCompileMode compile_mode, bool has_ref_vars,
     bool may_alias_resource_update,
-    const XlaCompiler::CompilationResult** compilation_result,
-    xla::PjRtClient** client, xla::PjRtLoadedExecutable** executable);
+    std::shared_ptr<const XlaCompiler::CompilationResult>* compilation_result,
+    xla::PjRtClient** client,
+    std::shared_ptr<xla::PjRtLoadedExecutable>* executable);
 
 // Similar to the above function but it does not take a OpKernelContext.
 // Instead, it takes the following arguments that are obtained from
@@ -52,8 +57,10 @@ absl::Status CompileToPjRtLoadedExecutable(
     const std::vector<XlaCompiler::Argument>& args,
     DeviceCompileMode compile_mode, bool has_ref_vars,
     bool may_alias_resource_update, FunctionLibraryRuntime* flr,
-    ResourceMgr* rm, const XlaCompiler::CompilationResult** compilation_result,
-    xla::PjRtClient** client, xla::PjRtLoadedExecutable** executable);
+    ResourceMgr* rm,
+    std::shared_ptr<const XlaCompiler::CompilationResult>* compilation_result,
+    xla::PjRtClient** client,
+    std::shared_ptr<xla::PjRtLoadedExecutable>* executable);
 
 }  // namespace tensorflow
 
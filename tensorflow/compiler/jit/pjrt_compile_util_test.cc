@@ -15,6 +15,8 @@ limitations under the License.
 #if GOOGLE_CUDA || TENSORFLOW_USE_ROCM
 #include "tensorflow/compiler/jit/pjrt_compile_util.h"
 
+#include <memory>
+
 #include <gmock/gmock.h>
 #include <gtest/gtest.h>
 #include "tensorflow/cc/framework/scope.h"
@@ -76,8 +78,8 @@ TEST(PjrtCompileUtilTest, CompileToPjRtLoadedExecutable) {
 
   ResourceMgr resource_mgr("");
 
-  const XlaCompiler::CompilationResult* compilation_result = nullptr;
-  xla::PjRtLoadedExecutable* pjrt_executable = nullptr;
+  std::shared_ptr<const XlaCompiler::CompilationResult> compilation_result;
+  std::shared_ptr<xla::PjRtLoadedExecutable> pjrt_executable;
   xla::PjRtClient* pjrt_client = nullptr;
 
   TF_EXPECT_OK(CompileToPjRtLoadedExecutable(
@@ -109,8 +111,8 @@ TEST(PjrtCompileUtilTest, CompileToPjRtLoadedExecutableWithOpKernelContext) {
   params.function_library = device_setup.flr();
   OpKernelContext ctx(&params, 1);
 
-  const XlaCompiler::CompilationResult* compilation_result = nullptr;
-  xla::PjRtLoadedExecutable* pjrt_executable = nullptr;
+  std::shared_ptr<const XlaCompiler::CompilationResult> compilation_result;
+  std::shared_ptr<xla::PjRtLoadedExecutable> pjrt_executable;
   xla::PjRtClient* pjrt_client = nullptr;
 
   TF_EXPECT_OK(CompileToPjRtLoadedExecutable(
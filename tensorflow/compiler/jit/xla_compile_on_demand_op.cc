@@ -179,8 +179,8 @@ absl::Status XlaCompileOnDemandOp::Compile(
     const std::vector<XlaCompiler::Argument>& args, OpKernelContext* ctx,
     PjRtDeviceCompiler** pjrt_device_compiler,
     DeviceCompilationProfiler** profiler,
-    const XlaCompiler::CompilationResult** result,
-    xla::PjRtLoadedExecutable** executable) {
+    std::shared_ptr<const XlaCompiler::CompilationResult>* result,
+    std::shared_ptr<xla::PjRtLoadedExecutable>* executable) {
   TF_RETURN_IF_ERROR(GetOrCreatePjRtDeviceCompilerAndProfiler(
       *ctx, platform_info_, ctx->function_library(), pjrt_device_compiler,
       profiler));
@@ -202,8 +202,8 @@ absl::Status XlaCompileOnDemandOp::Compile(
     const std::vector<XlaCompiler::Argument>& args, OpKernelContext* ctx,
     XlaDeviceCompiler** xla_device_compiler,
     DeviceCompilationProfiler** profiler,
-    const XlaCompiler::CompilationResult** result,
-    xla::LocalExecutable** executable) {
+    std::shared_ptr<const XlaCompiler::CompilationResult>* result,
+    std::shared_ptr<xla::LocalExecutable>* executable) {
   // We store information about the JIT-compiled XLA computation
   // in the ResourceMgr.
   ResourceMgr* rm = ctx->resource_manager();
@@ -242,7 +242,9 @@ absl::Status XlaCompileOnDemandOp::Compile(
 }
 
 void XlaCompileOnDemandOp::Compute(OpKernelContext* ctx) {
-  const XlaCompiler::CompilationResult* result;
+  // Shared with the compilation cache so that a concurrent eviction does not
+  // free it while the op runs.
+  std::shared_ptr<const XlaCompiler::CompilationResult> result;
   DeviceCompilationProfiler* profiler;
 
   OP_REQUIRES(ctx, ctx->function_library(),
@@ -268,7 +270,7 @@ void XlaCompileOnDemandOp::Compute(OpKernelContext* ctx) {
                             variable_indices, &variables, &args));
 
     PjRtDeviceCompiler* pjrt_device_compiler = nullptr;
-    xla::PjRtLoadedExecutable* pjrt_executable = nullptr;
+    std::shared_ptr<xla::PjRtLoadedExecutable> pjrt_executable;
     absl::Status status = Compile(args, ctx, &pjrt_device_compiler, &profiler,
                                   &result, &pjrt_executable);
     // Hold the reference to the XLA device compiler and profiler during
@@ -286,7 +288,7 @@ void XlaCompileOnDemandOp::Compute(OpKernelContext* ctx) {
 
     OP_REQUIRES_OK(ctx, RunPjRtExecutable(inputs, variables, *result,
                                           pjrt_device_compiler->client(),
-                                          pjrt_executable, ctx));
+                                          pjrt_executable.get(), ctx));
 
     VLOG(2) << "Completed executing with PJRT!";
   } else {
@@ -304,7 +306,7 @@ void XlaCompileOnDemandOp::Compute(OpKernelContext* ctx) {
     }
 
     XlaDeviceCompiler* xla_device_compiler = nullptr;
-    xla::LocalExecutable* executable = nullptr;
+    std::shared_ptr<xla::LocalExecutable> executable;
     absl::Status status = Compile(args, ctx, &xla_device_compiler, &profiler,
                                   &result, &executable);
     // Hold the reference to the XLA device compiler and profiler during
@@ -317,7 +319,8 @@ void XlaCompileOnDemandOp::Compute(OpKernelContext* ctx) {
 
     // Locks are acquired again when populating the `ctx` outputs.
     OP_REQUIRES_OK(
-        ctx, Run(variable_args, result, xla_device_compiler, executable, ctx));
+        ctx, Run(variable_args, result.get(), xla_device_compiler,
+                 executable.get(), ctx));
   }
 }
 
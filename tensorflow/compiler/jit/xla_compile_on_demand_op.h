@@ -19,6 +19,7 @@ limitations under the License.
 #ifndef TENSORFLOW_COMPILER_JIT_XLA_COMPILE_ON_DEMAND_OP_H_
 #define TENSORFLOW_COMPILER_JIT_XLA_COMPILE_ON_DEMAND_OP_H_
 
+#include <memory>
 #include <vector>
 
 #include "tensorflow/compiler/jit/device_compilation_cluster_signature.h"
@@ -52,16 +53,18 @@ class XlaCompileOnDemandOp : public OpKernel {
                        DeviceCompiler<xla::LocalExecutable, xla::LocalClient>**
                            xla_device_compiler,
                        DeviceCompilationProfiler** profiler,
-                       const XlaCompiler::CompilationResult** result,
-                       xla::LocalExecutable** executable);
+                       std::shared_ptr<const XlaCompiler::CompilationResult>*
+                           result,
+                       std::shared_ptr<xla::LocalExecutable>* executable);
 
   absl::Status Compile(const std::vector<XlaCompiler::Argument>& args,
                        OpKernelContext* ctx,
                        DeviceCompiler<xla::PjRtLoadedExecutable,
                                       xla::PjRtClient>** pjrt_device_compiler,
                        DeviceCompilationProfiler** profiler,
-                       const XlaCompiler::CompilationResult** result,
-                       xla::PjRtLoadedExecutable** executable);
+                       std::shared_ptr<const XlaCompiler::CompilationResult>*
+                           result,
+                       std::shared_ptr<xla::PjRtLoadedExecutable>* executable);
 
   absl::Status Run(const ResourceVarsSnapshot& variable_args,
                    const XlaCompiler::CompilationResult* result,
@@ -161,10 +161,11 @@ class PjRtExecutionUtilGpuTest : public OpsTestBase {
   }
 
   // Compiles the op set in the context_ to a PjRtLoadedExecutable
-  void CompileToExecutable(const std::vector<XlaCompiler::Argument>& args,
-                           const XlaCompiler::CompilationResult** result,
-                           xla::PjRtLoadedExecutable** executable,
-                           XlaCompiler::CompileOptions compile_options = {}) {
+  void CompileToExecutable(
+      const std::vector<XlaCompiler::Argument>& args,
+      std::shared_ptr<const XlaCompiler::CompilationResult>* result,
+      std::shared_ptr<xla::PjRtLoadedExecutable>* executable,
+      XlaCompiler::CompileOptions compile_options = {}) {
     TF_EXPECT_OK(device_compiler_->CompileSingleOpIfNeeded(
         compiler_options_, args, compile_options, context_.get(), profiler_,
         result, executable));
@@ -194,10 +194,11 @@ class PjRtExecutionUtilTest : public OpsTestBase {
   }
 
   // Compiles the op set in the context_ to a PjRtLoadedExecutable
-  void CompileToExecutable(const std::vector<XlaCompiler::Argument>& args,
-                           const XlaCompiler::CompilationResult** result,
-                           xla::PjRtLoadedExecutable** executable,
-                           XlaCompiler::CompileOptions compile_options = {}) {
+  void CompileToExecutable(
+      const std::vector<XlaCompiler::Argument>& args,
+      std::shared_ptr<const XlaCompiler::CompilationResult>* result,
+      std::shared_ptr<xla::PjRtLoadedExecutable>* executable,
+      XlaCompiler::CompileOptions compile_options = {}) {
     TF_EXPECT_OK(device_compiler_->CompileSingleOpIfNeeded(
         compiler_options_, args, compile_options, context_.get(), profiler_,
         result, executable));
@@ -366,15 +367,16 @@ TEST_F(PjRtExecutionUtilTest, PopulateCtxOutputs) {
   args[1].type = DT_INT32;
   args[1].shape = TensorShape({1, 3});
 
-  const XlaCompiler::CompilationResult* result;
-  xla::PjRtLoadedExecutable* executable;
+  std::shared_ptr<const XlaCompiler::CompilationResult> result;
+  std::shared_ptr<xla::PjRtLoadedExecutable> executable;
   CompileToExecutable(args, &result, &executable);
 
   std::vector<const Tensor*> inputs;
   inputs.push_back(a);
   inputs.push_back(b);
-  TF_ASSERT_OK_AND_ASSIGN(auto execute_outputs,
-                          RunExecutable(inputs, {}, result, executable));
+  TF_ASSERT_OK_AND_ASSIGN(
+      auto execute_outputs,
+      RunExecutable(inputs, {}, result.get(), executable.get()));
 
   TF_EXPECT_OK(PopulateCtxOutputsFromPjRtExecutableOutputs(
       /*num_missing_prefix_ctx_inputs=*/0, inputs, {}, *result,
@@ -405,14 +407,15 @@ TEST_F(PjRtExecutionUtilTest, PopulateCtxOutputsDynamicShape) {
   args[0].type = DT_FLOAT;
   args[0].shape = TensorShape({2, 3});
 
-  const XlaCompiler::CompilationResult* result;
-  xla::PjRtLoadedExecutable* executable;
+  std::shared_ptr<const XlaCompiler::CompilationResult> result;
+  std::shared_ptr<xla::PjRtLoadedExecutable> executable;
   CompileToExecutable(args, &result, &executable);
 
   std::vector<const Tensor*> inputs;
   inputs.push_back(a);
-  TF_ASSERT_OK_AND_ASSIGN(auto execute_outputs,
-                          RunExecutable(inputs, {}, result, executable));
+  TF_ASSERT_OK_AND_ASSIGN(
+      auto execute_outputs,
+      RunExecutable(inputs, {}, result.get(), executable.get()));
 
   TF_EXPECT_OK(PopulateCtxOutputsFromPjRtExecutableOutputs(
       /*num_missing_prefix_ctx_inputs=*/0, inputs, {}, *result,
@@ -448,8 +451,8 @@ TEST_F(PjRtExecutionUtilTest, PopulateCtxOutputsVariableInputs) {
   args[1].type = DT_INT32;
   args[1].shape = TensorShape({1, 2});
 
-  const XlaCompiler::CompilationResult* result;
-  xla::PjRtLoadedExecutable* executable;
+  std::shared_ptr<const XlaCompiler::CompilationResult> result;
+  std::shared_ptr<xla::PjRtLoadedExecutable> executable;
   CompileToExecutable(args, &result, &executable);
 
   std::vector<const Tensor*> inputs = InputsFromContext(context_.get());
@@ -460,8 +463,9 @@ TEST_F(PjRtExecutionUtilTest, PopulateCtxOutputsVariableInputs) {
   TF_ASSERT_OK(GetVariableInfosFromInputs(context_->resource_manager(),
                                           context_->device(), inputs,
                                           variables_indices, &variables));
-  TF_ASSERT_OK_AND_ASSIGN(auto execute_outputs,
-                          RunExecutable(inputs, variables, result, executable));
+  TF_ASSERT_OK_AND_ASSIGN(
+      auto execute_outputs,
+      RunExecutable(inputs, variables, result.get(), executable.get()));
   TF_EXPECT_OK(PopulateCtxOutputsFromPjRtExecutableOutputs(
       /*num_missing_prefix_ctx_inputs=*/0, inputs, variables, *result,
       /*use_pjrt_tensor_buffer=*/false, execute_outputs, context_.get()));
@@ -503,11 +507,12 @@ TEST_F(PjRtExecutionUtilTest, PopulateCtxOutputsResourceUpdates) {
           constant_input_indices, inputs, variables,
           static_cast<Device*>(context_->device())));
 
-  const XlaCompiler::CompilationResult* result;
-  xla::PjRtLoadedExecutable* executable;
+  std::shared_ptr<const XlaCompiler::CompilationResult> result;
+  std::shared_ptr<xla::PjRtLoadedExecutable> executable;
   CompileToExecutable(args, &result, &executable);
-  TF_ASSERT_OK_AND_ASSIGN(auto execute_outputs,
-                          RunExecutable(inputs, variables, result, executable));
+  TF_ASSERT_OK_AND_ASSIGN(
+      auto execute_outputs,
+      RunExecutable(inputs, variables, result.get(), executable.get()));
 
   TF_EXPECT_OK(PopulateCtxOutputsFromPjRtExecutableOutputs(
       /*num_missing_prefix_ctx_inputs=*/0, inputs, variables, *result,
@@ -565,8 +570,8 @@ TEST_F(PjRtExecutionUtilTest, RunPjRtExecutable) {
   args[1].type = DT_INT32;
   args[1].shape = TensorShape({1, 2});
 
-  const XlaCompiler::CompilationResult* result;
-  xla::PjRtLoadedExecutable* executable;
+  std::shared_ptr<const XlaCompiler::CompilationResult> result;
+  std::shared_ptr<xla::PjRtLoadedExecutable> executable;
   CompileToExecutable(args, &result, &executable);
 
   std::vector<const Tensor*> inputs = InputsFromContext(context_.get());
@@ -578,7 +583,7 @@ TEST_F(PjRtExecutionUtilTest, RunPjRtExecutable) {
                                           context_->device(), inputs,
                                           variables_indices, &variables));
   TF_ASSERT_OK(RunPjRtExecutable(inputs, variables, *result, pjrt_client_,
-                                 executable, context_.get()));
+                                 executable.get(), context_.get()));
 
   Tensor* expected = CreateHostTensor<int32_t>(TensorShape({1, 2}), {4, 6});
   test::ExpectTensorEqual<int32_t>(*expected, *GetOutput(0));
@@ -614,8 +619,8 @@ TEST_F(PjRtExecutionUtilTest,
       GetResourceVariableIndicesFromContext(context_.get());
 
   absl::flat_hash_map<int, const Tensor*> variable_snapshots;
-  const XlaCompiler::CompilationResult* result;
-  xla::PjRtLoadedExecutable* executable;
+  std::shared_ptr<const XlaCompiler::CompilationResult> result;
+  std::shared_ptr<xla::PjRtLoadedExecutable> executable;
   {
     std::vector<VariableInfo> variables;
     variables.reserve(variables_indices.size());
@@ -642,7 +647,8 @@ TEST_F(PjRtExecutionUtilTest,
     TF_ASSERT_OK(LockVariables(absl::MakeSpan(updated_variables)));
     TF_ASSERT_OK(RunPjRtExecutable(
         constant_input_indices.size(), inputs, variable_snapshots,
-        updated_variables, *result, pjrt_client_, executable, context_.get()));
+        updated_variables, *result, pjrt_client_, executable.get(),
+        context_.get()));
   }
   Tensor* expected = CreateHostTensor<int32_t>(TensorShape({2}), {1, 1});
   test::ExpectTensorEqual<int32_t>(*expected, *GetOutput(0));
@@ -673,8 +679,8 @@ TEST_F(PjRtExecutionUtilTest, RunPjRtExecutableWithoutCtx) {
   args[1].type = DT_INT32;
   args[1].shape = TensorShape({1, 2});
 
-  const XlaCompiler::CompilationResult* result;
-  xla::PjRtLoadedExecutable* executable;
+  std::shared_ptr<const XlaCompiler::CompilationResult> result;
+  std::shared_ptr<xla::PjRtLoadedExecutable> executable;
   CompileToExecutable(args, &result, &executable);
 
   std::vector<const Tensor*> inputs = InputsFromContext(context_.get());
@@ -705,7 +711,7 @@ TEST_F(PjRtExecutionUtilTest, RunPjRtExecutableWithoutCtx) {
       RunPjRtExecutable(/*num_missing_prefix_ctx_inputs=*/0, inputs,
                         variable_snapshots, variables, device_type,
                         use_pjrt_tensor_buffer, *result, pjrt_device,
-                        pjrt_client_, executable));
+                        pjrt_client_, executable.get()));
 
   for (const auto& output : execute_outputs) {
     TF_ASSERT_OK(output->GetReadyFuture().Await());
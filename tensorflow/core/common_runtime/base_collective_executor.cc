@@ -18,6 +18,8 @@ limitations under the License.
 #include <functional>
 #include <utility>
 
+#include "absl/strings/str_cat.h"
+#include "tensorflow/core/common_runtime/collective_bucketer.h"
 #include "tensorflow/core/common_runtime/copy_tensor.h"
 #include "tensorflow/core/common_runtime/device_mgr.h"
 #include "tensorflow/core/common_runtime/dma_helper.h"
@@ -250,6 +252,10 @@ void BaseCollectiveExecutor::StartAbort(const absl::Status& s) {
     status = status_;
   }
   LOG(ERROR) << "BaseCollectiveExecutor::StartAbort " << s;
+  if (bucketer_ != nullptr) {
+    bucketer_->AbortStep(step_id_);
+    FailParkedBucketMembers(status);
+  }
   cem_->GetParamResolver()->StartAbort(status);
   remote_access_->StartAbort(status);
   if (cem_->GetNcclCommunicator() != nullptr) {
@@ -317,6 +323,35 @@ void BaseCollectiveExecutor::ExecuteAsync(OpKernelContext* ctx,
         col_params->is_source))
           ? &ctx->input(0)
           : nullptr;
+  if (bucketer_ != nullptr && bucketer_->IsEligible(*col_params)) {
+    if (bucketer_->Observe(step_id_, ctx->device()->name(), *col_params)) {
+      // Record the completion before anything that depends on the result can
+      // launch, so that the plan never fuses dependent all-reduces.
+      RunCollective(
+          ctx, col_params, exec_key, input, output,
+          [bucketer = bucketer_, step_id = step_id_,
+           device = ctx->device()->name(),
+           group_key = col_params->group.group_key,
+           instance_key = col_params->instance.instance_key,
+           done_safe](const absl::Status& s) {
+            bucketer->ObserveDone(step_id, device, group_key, instance_key);
+            done_safe(s);
+          });
+      return;
+    }
+    if (MaybeDeferBucketMember(ctx, col_params, exec_key, done_safe) ||
+        MaybeEnqueueBucketMember(ctx, col_params, done_safe)) {
+      return;
+    }
+  }
+  RunCollective(ctx, col_params, exec_key, input, output, done_safe);
+}
+
+void BaseCollectiveExecutor::RunCollective(OpKernelContext* ctx,
+                                           const CollectiveParams* col_params,
+                                           const std::string& exec_key,
+                                           const Tensor* input, Tensor* output,
+                                           const StatusCallback& done_safe) {
   CollectiveImplementationInterface* col_impl = nullptr;
   absl::Status status = CreateCollective(*col_params, &col_impl);
   if (!status.ok()) {
@@ -364,6 +399,266 @@ void BaseCollectiveExecutor::ExecuteAsync(OpKernelContext* ctx,
   });
 }
 
+bool BaseCollectiveExecutor::MaybeDeferBucketMember(
+    OpKernelContext* ctx, const CollectiveParams* col_params,
+    const std::string& exec_key, const StatusCallback& done) {
+  if (bucketer_->frozen()) return false;
+  int64_t id = -1;
+  absl::Status status;
+  {
+    mutex_lock l(bucket_mu_);
+    status = parked_status_;
+    if (status.ok()) {
+      BucketArrival arrival{ctx, col_params, done, exec_key};
+      if (RegisterBucketCancellationLocked(&arrival)) {
+        id = next_deferred_id_++;
+        deferred_.emplace(id, std::move(arrival));
+      } else {
+        status = absl::CancelledError("Collective bucket member was cancelled");
+      }
+    }
+  }
+  if (!status.ok()) {
+    done(status);
+    return true;
+  }
+  // The reference keeps `this` alive until the plan is frozen, which may
+  // happen after this step has been cleaned up.
+  Ref();
+  auto resume = [this, id]() {
+    ResumeDeferredBucketMember(id);
+    Unref();
+  };
+  if (!bucketer_->NotifyWhenFrozen(
+          [this, resume]() { RunClosure(resume); })) {
+    resume();
+  }
+  return true;
+}
+
+void BaseCollectiveExecutor::ResumeDeferredBucketMember(int64_t id) {
+  BucketArrival arrival;
+  {
+    mutex_lock l(bucket_mu_);
+    auto it = deferred_.find(id);
+    // The member has been failed in the meantime.
+    if (it == deferred_.end()) return;
+    arrival = std::move(it->second);
+    deferred_.erase(it);
+  }
+  DeregisterBucketCancellation(&arrival, /*may_block=*/true);
+  if (MaybeEnqueueBucketMember(arrival.ctx, arrival.col_params,
+                               arrival.done)) {
+    return;
+  }
+  RunCollective(arrival.ctx, arrival.col_params, arrival.exec_key,
+                &arrival.ctx->input(0), arrival.ctx->mutable_output(0),
+                arrival.done);
+}
+
+bool BaseCollectiveExecutor::MaybeEnqueueBucketMember(
+    OpKernelContext* ctx, const CollectiveParams* col_params,
+    const StatusCallback& done) {
+  int member_index = -1;
+  const CollectiveBucketer::Bucket* bucket =
+      bucketer_->Lookup(ctx->device()->name(), *col_params, &member_index);
+  if (bucket == nullptr) return false;
+  // A member whose size no longer matches the plan still counts as arrived so
+  // that the rest of its bucket can launch, but it runs unfused. Every worker
+  // sees the same shapes, so they all make the same choice.
+  const bool fused = ctx->input(0).NumElements() ==
+                     bucket->members[member_index].num_elements;
+  const std::string key = absl::StrCat(
+      ctx->device()->name(), ":", col_params->group.group_key, ":", bucket->id,
+      ":", ctx->frame_iter().frame_id, ":", ctx->frame_iter().iter_id);
+  std::vector<BucketArrival> arrivals;
+  absl::Status status;
+  {
+    mutex_lock l(bucket_mu_);
+    if (fused && !parked_status_.ok()) {
+      status = parked_status_;
+    } else {
+      PendingBucket& pending = pending_buckets_[key];
+      if (pending.arrivals.empty()) {
+        pending.arrivals.resize(bucket->members.size());
+      }
+      const bool complete = ++pending.num_arrived == bucket->members.size();
+      if (fused) {
+        BucketArrival& arrival = pending.arrivals[member_index];
+        DCHECK(arrival.ctx == nullptr) << "Duplicate bucket member "
+                                       << col_params->instance.instance_key;
+        arrival.ctx = ctx;
+        arrival.col_params = col_params;
+        arrival.done = done;
+        // The last member launches the bucket right away, the others wait for
+        // it unless the step is cancelled.
+        if (!complete && !RegisterBucketCancellationLocked(&arrival)) {
+          arrival = BucketArrival();
+          status =
+              absl::CancelledError("Collective bucket member was cancelled");
+        }
+      }
+      if (complete) {
+        arrivals = std::move(pending.arrivals);
+        pending_buckets_.erase(key);
+      }
+    }
+  }
+  if (!status.ok()) {
+    done(status);
+    return true;
+  }
+  if (arrivals.empty()) return fused;
+  for (BucketArrival& arrival : arrivals) {
+    DeregisterBucketCancellation(&arrival, /*may_block=*/true);
+  }
+  LaunchBucket(*bucket, std::move(arrivals));
+  return fused;
+}
+
+void BaseCollectiveExecutor::FailParkedBucketMembers(const absl::Status& s) {
+  std::vector<BucketArrival> parked;
+  {
+    mutex_lock l(bucket_mu_);
+    if (parked_status_.ok()) parked_status_ = s;
+    for (auto& it : deferred_) parked.push_back(std::move(it.second));
+    deferred_.clear();
+    for (auto& it : pending_buckets_) {
+      for (BucketArrival& arrival : it.second.arrivals) {
+        if (arrival.ctx != nullptr) parked.push_back(std::move(arrival));
+      }
+    }
+    pending_buckets_.clear();
+  }
+  if (!parked.empty()) {
+    VLOG(1) << "Failing " << parked.size() << " held back bucket members: " << s;
+  }
+  for (BucketArrival& arrival : parked) {
+    DeregisterBucketCancellation(&arrival, /*may_block=*/false);
+    arrival.done(s);
+  }
+}
+
+bool BaseCollectiveExecutor::RegisterBucketCancellationLocked(
+    BucketArrival* arrival) {
+  CancellationManager* cancel_mgr = arrival->ctx->cancellation_manager();
+  if (cancel_mgr == nullptr) return true;
+  const CancellationToken token = cancel_mgr->get_cancellation_token();
+  // The callback holds a reference so that `this` outlives it even if the
+  // step finishes while the callback is running.
+  Ref();
+  if (!cancel_mgr->RegisterCallback(token, [this]() {
+        FailParkedBucketMembers(
+            absl::CancelledError("Collective bucket member was cancelled"));
+        Unref();
+      })) {
+    Unref();
+    return false;
+  }
+  arrival->cancel_mgr = cancel_mgr;
+  arrival->cancel_token = token;
+  return true;
+}
+
+void BaseCollectiveExecutor::DeregisterBucketCancellation(
+    BucketArrival* arrival, bool may_block) {
+  if (arrival->cancel_mgr == nullptr) return;
+  // If deregistration fails the callback has run or is running, and it drops
+  // the reference itself.
+  const bool deregistered =
+      may_block
+          ? arrival->cancel_mgr->DeregisterCallback(arrival->cancel_token)
+          : arrival->cancel_mgr->TryDeregisterCallback(arrival->cancel_token);
+  arrival->cancel_mgr = nullptr;
+  if (deregistered) Unref();
+}
+
+void BaseCollectiveExecutor::LaunchBucket(
+    const CollectiveBucketer::Bucket& bucket,
+    std::vector<BucketArrival> arrivals) {
+  // The bucket runs in the context of one of its fused members, whose done
+  // callback is invoked last so that the context outlives the collective.
+  int owner = -1;
+  for (int i = 0; i < arrivals.size(); ++i) {
+    if (arrivals[i].ctx != nullptr) owner = i;
+  }
+  if (owner < 0) return;
+  auto fail_all = [&arrivals](const absl::Status& s) {
+    for (BucketArrival& arrival : arrivals) {
+      if (arrival.ctx != nullptr) arrival.done(s);
+    }
+  };
+  OpKernelContext* ctx = arrivals[owner].ctx;
+  const CollectiveParams* member_params = arrivals[owner].col_params;
+
+  auto fused = std::make_shared<Tensor>();
+  absl::Status status = ctx->allocate_temp(
+      bucket.dtype, TensorShape({bucket.num_elements}), fused.get());
+  if (!status.ok()) {
+    fail_all(status);
+    return;
+  }
+  for (int i = 0; i < arrivals.size(); ++i) {
+    if (arrivals[i].ctx == nullptr) continue;
+    CollectiveBucketer::PackMember(bucket.members[i], arrivals[i].ctx->input(0),
+                                   fused.get());
+  }
+
+  // Derive the params of the fused all-reduce from one of its members. Large
+  // fused buffers are bandwidth bound, so they always use the ring.
+  CollectiveParams* fused_params = new CollectiveParams();
+  fused_params->group = member_params->group;
+  fused_params->instance = member_params->instance;
+  fused_params->instance.shape = TensorShape({bucket.num_elements});
+  fused_params->instance.impl_details.collective_name = "RingReduce";
+  fused_params->instance.impl_details.subdiv_offsets.clear();
+  fused_params->instance.impl_details.subdiv_permutations.clear();
+  fused_params->name =
+      absl::StrCat(member_params->name, ": Bucket(", bucket.id, ")");
+  fused_params->default_rank = member_params->default_rank;
+  fused_params->merge_op = member_params->merge_op;
+  fused_params->final_op = member_params->final_op;
+  fused_params->run_group_initialization =
+      member_params->run_group_initialization;
+  fused_params->is_stateless = member_params->is_stateless;
+  CollectiveImplementationInterface* resolver_impl = nullptr;
+  status = CollectiveRegistry::LookupParamResolverInstance(
+      fused_params->instance.impl_details.collective_name, &resolver_impl);
+  if (status.ok()) {
+    status = resolver_impl->InitializeCollectiveParams(fused_params);
+  }
+  if (!status.ok()) {
+    fused_params->Unref();
+    fail_all(status);
+    return;
+  }
+
+  const std::string exec_key = absl::StrCat(
+      "bucket:", fused_params->group.group_key, ":", bucket.id, ":",
+      ctx->frame_iter().frame_id, ":", ctx->frame_iter().iter_id);
+  VLOG(1) << "Launching collective bucket " << exec_key << " with "
+          << bucket.members.size() << " members and " << bucket.num_elements
+          << " elements";
+  auto shared_arrivals =
+      std::make_shared<std::vector<BucketArrival>>(std::move(arrivals));
+  RunCollective(
+      ctx, fused_params, exec_key, fused.get(), fused.get(),
+      [&bucket, shared_arrivals, fused, fused_params,
+       owner](const absl::Status& s) {
+        core::ScopedUnref unref(fused_params);
+        std::vector<BucketArrival>& arrivals = *shared_arrivals;
+        for (int i = 0; i < arrivals.size(); ++i) {
+          if (arrivals[i].ctx == nullptr) continue;
+          if (s.ok()) {
+            CollectiveBucketer::UnpackMember(
+                bucket.members[i], *fused, arrivals[i].ctx->mutable_output(0));
+          }
+          if (i != owner) arrivals[i].done(s);
+        }
+        arrivals[owner].done(s);
+      });
+}
+
 void BaseCollectiveExecutor::CompleteParamsAsync(
     const DeviceAttributes& device, CollectiveParams* cp,
     CancellationManager* cancel_mgr, StatusCallback done) {
@@ -17,8 +17,12 @@ limitations under the License.
 
 #include <memory>
 #include <string>
+#include <vector>
 
+#include "absl/container/flat_hash_map.h"
 #include "tensorflow/core/common_runtime/buf_rendezvous.h"
+#include "tensorflow/core/common_runtime/collective_bucketer.h"
+#include "tensorflow/core/framework/cancellation.h"
 #include "tensorflow/core/framework/collective.h"
 #include "tensorflow/core/framework/device_attributes.pb.h"
 #include "tensorflow/core/platform/unbounded_work_queue.h"
@@ -98,12 +102,14 @@ class BaseCollectiveExecutor : public CollectiveExecutor {
   BaseCollectiveExecutor(CollectiveExecutorMgrInterface* cem,
                          CollectiveRemoteAccess* remote_access, int64_t step_id,
                          const DeviceMgr* dev_mgr,
-                         std::shared_ptr<UnboundedWorkQueue> work_queue)
+                         std::shared_ptr<UnboundedWorkQueue> work_queue,
+                         std::shared_ptr<CollectiveBucketer> bucketer = nullptr)
       : CollectiveExecutor(cem),
         step_id_(step_id),
         dev_mgr_(dev_mgr),
         remote_access_(remote_access),
-        work_queue_(std::move(work_queue)) {}
+        work_queue_(std::move(work_queue)),
+        bucketer_(std::move(bucketer)) {}
 
   ~BaseCollectiveExecutor() override;
 
@@ -148,8 +154,63 @@ class BaseCollectiveExecutor : public CollectiveExecutor {
   std::unordered_map<int32_t, int32_t> launched_ TF_GUARDED_BY(launch_mu_);
   mutex status_mu_;
   absl::Status status_ TF_GUARDED_BY(status_mu_);
+  // Fuses small CPU all-reduces if set. Ownership is shared between `this` and
+  // `CollectiveExecutorMgr` so that the bucket plan outlives a single step.
+  std::shared_ptr<CollectiveBucketer> bucketer_;
 
  private:
+  // A bucket member that has arrived in ExecuteAsync and is held back.
+  struct BucketArrival {
+    OpKernelContext* ctx = nullptr;
+    const CollectiveParams* col_params = nullptr;
+    StatusCallback done;
+    std::string exec_key;
+    // Set while the member is registered for cancellation.
+    CancellationManager* cancel_mgr = nullptr;
+    CancellationToken cancel_token = CancellationManager::kInvalidToken;
+  };
+  // Members of one bucket instance that have arrived so far.
+  struct PendingBucket {
+    std::vector<BucketArrival> arrivals;
+    int num_arrived = 0;
+  };
+
+  // Creates and runs the collective of `col_params` on `input` and `output`.
+  void RunCollective(OpKernelContext* ctx, const CollectiveParams* col_params,
+                     const std::string& exec_key, const Tensor* input,
+                     Tensor* output, const StatusCallback& done);
+  // Holds back an eligible all-reduce of a step other than the observer step
+  // until the bucket plan is frozen. Returns false if the plan is frozen
+  // already.
+  bool MaybeDeferBucketMember(OpKernelContext* ctx,
+                              const CollectiveParams* col_params,
+                              const std::string& exec_key,
+                              const StatusCallback& done);
+  // Runs the deferred member `id` fused or unfused once the plan is frozen.
+  void ResumeDeferredBucketMember(int64_t id);
+  // Holds back an all-reduce that is a member of a bucket and launches the
+  // bucket once all its members have arrived. Returns false if `col_params`
+  // should run unfused.
+  bool MaybeEnqueueBucketMember(OpKernelContext* ctx,
+                                const CollectiveParams* col_params,
+                                const StatusCallback& done);
+  // Packs the inputs of `arrivals` into one buffer, all-reduces it and
+  // scatters the result back to the members' outputs.
+  void LaunchBucket(const CollectiveBucketer::Bucket& bucket,
+                    std::vector<BucketArrival> arrivals);
+  // Fails every held back bucket member of this step with `s`, as well as
+  // members that arrive later.
+  void FailParkedBucketMembers(const absl::Status& s)
+      TF_LOCKS_EXCLUDED(bucket_mu_);
+  // Registers `arrival` with its cancellation manager so that cancelling the
+  // step fails it. Returns false if the step is cancelled already.
+  bool RegisterBucketCancellationLocked(BucketArrival* arrival)
+      TF_EXCLUSIVE_LOCKS_REQUIRED(bucket_mu_);
+  // Undoes RegisterBucketCancellationLocked(). Must not be called from a
+  // cancellation callback unless `may_block` is false.
+  void DeregisterBucketCancellation(BucketArrival* arrival, bool may_block)
+      TF_LOCKS_EXCLUDED(bucket_mu_);
+
   absl::Status CreateCollective(const CollectiveParams& col_params,
                                 CollectiveImplementationInterface** col_impl);
   // Check if all ops on which this collective depends on have launched.
@@ -158,6 +219,18 @@ class BaseCollectiveExecutor : public CollectiveExecutor {
   // Tries to return the status that is the original error. It returns the
   // aborted status if the collective executor is aborted.
   absl::Status GetStatus(const absl::Status& s) TF_LOCKS_EXCLUDED(status_mu_);
+
+  mutex bucket_mu_;
+  // "device:group_key:bucket_id:frame_id:iter_id" -> arrived members.
+  absl::flat_hash_map<std::string, PendingBucket> pending_buckets_
+      TF_GUARDED_BY(bucket_mu_);
+  // Members waiting for the bucket plan to be frozen, by arrival id.
+  absl::flat_hash_map<int64_t, BucketArrival> deferred_
+      TF_GUARDED_BY(bucket_mu_);
+  int64_t next_deferred_id_ TF_GUARDED_BY(bucket_mu_) = 0;
+  // Error that failed the held back members. Members arriving afterwards fail
+  // right away.
+  absl::Status parked_status_ TF_GUARDED_BY(bucket_mu_);
 };
 
 }  // namespace tensorflow
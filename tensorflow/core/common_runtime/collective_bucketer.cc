@@ -0,0 +1,282 @@
+/* Copyright 2026 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#include "tensorflow/core/common_runtime/collective_bucketer.h"
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+#include <utility>
+
+#include "absl/strings/str_cat.h"
+#include "tensorflow/core/common_runtime/dma_helper.h"
+#include "tensorflow/core/framework/op_kernel.h"
+#include "tensorflow/core/framework/types.h"
+#include "tensorflow/core/platform/logging.h"
+#include "tensorflow/core/util/env_var.h"
+
+namespace tensorflow {
+
+CollectiveBucketer::CollectiveBucketer(int64_t bucket_bytes)
+    : bucket_bytes_(bucket_bytes) {
+  DCHECK_GT(bucket_bytes_, 0);
+}
+
+/*static*/
+std::shared_ptr<CollectiveBucketer> CollectiveBucketer::CreateFromEnv() {
+  int64_t bucket_bytes = 0;
+  absl::Status s =
+      ReadInt64FromEnvVar("TF_COLLECTIVE_BUCKET_BYTES", 0, &bucket_bytes);
+  if (!s.ok()) {
+    LOG(ERROR) << "Ignoring TF_COLLECTIVE_BUCKET_BYTES: " << s;
+    return nullptr;
+  }
+  if (bucket_bytes <= 0) return nullptr;
+  VLOG(1) << "Fusing CPU all-reduces into buckets of " << bucket_bytes
+          << " bytes";
+  return std::make_shared<CollectiveBucketer>(bucket_bytes);
+}
+
+bool CollectiveBucketer::IsEligible(const CollectiveParams& col_params) const {
+  if (col_params.instance.type != REDUCTION_COLLECTIVE ||
+      col_params.group.device_type != DEVICE_CPU ||
+      !col_params.instance.impl_details.dependencies.empty() ||
+      col_params.instance.impl_details.communication_hint == "nccl" ||
+      col_params.merge_op == nullptr) {
+    return false;
+  }
+  switch (col_params.instance.data_type) {
+    case DT_BFLOAT16:
+    case DT_HALF:
+    case DT_FLOAT:
+    case DT_DOUBLE:
+    case DT_INT32:
+    case DT_INT64:
+      break;
+    default:
+      return false;
+  }
+  // Tensors that fill a bucket on their own gain nothing from fusion.
+  const int64_t bytes = col_params.instance.shape.num_elements() *
+                        DataTypeSize(col_params.instance.data_type);
+  return bytes > 0 && bytes < bucket_bytes_;
+}
+
+/*static*/
+std::string CollectiveBucketer::Signature(const CollectiveParams& col_params) {
+  return absl::StrCat(
+      DataTypeString(col_params.instance.data_type), ":",
+      col_params.merge_op ? col_params.merge_op->type_string() : "", ":",
+      col_params.final_op ? col_params.final_op->type_string() : "", ":",
+      col_params.group.group_size, ":",
+      col_params.instance.impl_details.communication_hint);
+}
+
+bool CollectiveBucketer::Observe(int64_t step_id, const std::string& device,
+                                 const CollectiveParams& col_params) {
+  mutex_lock l(mu_);
+  if (frozen_) return false;
+  if (observer_step_id_ == CollectiveExecutor::kInvalidId) {
+    VLOG(1) << "Recording collective bucket plan in step " << step_id;
+    observer_step_id_ = step_id;
+  } else if (observer_step_id_ != step_id) {
+    return false;
+  }
+  Record& record = records_[{device, col_params.group.group_key}]
+                           [col_params.instance.instance_key];
+  record.member.instance_key = col_params.instance.instance_key;
+  record.member.num_elements = col_params.instance.shape.num_elements();
+  record.dtype = col_params.instance.data_type;
+  record.signature = Signature(col_params);
+  record.launch_seq = next_seq_++;
+  record.done_seq = std::numeric_limits<int64_t>::max();
+  return true;
+}
+
+void CollectiveBucketer::ObserveDone(int64_t step_id, const std::string& device,
+                                     int32_t group_key, int32_t instance_key) {
+  mutex_lock l(mu_);
+  if (frozen_ || observer_step_id_ != step_id) return;
+  auto it = records_.find({device, group_key});
+  if (it == records_.end()) return;
+  auto rit = it->second.find(instance_key);
+  if (rit == it->second.end()) return;
+  rit->second.done_seq = next_seq_++;
+}
+
+void CollectiveBucketer::RetireStep(int64_t step_id) {
+  std::vector<std::function<void()>> callbacks;
+  {
+    mutex_lock l(mu_);
+    if (frozen_ || observer_step_id_ != step_id ||
+        step_id == CollectiveExecutor::kInvalidId) {
+      return;
+    }
+    callbacks = FreezeLocked();
+  }
+  for (auto& callback : callbacks) callback();
+}
+
+void CollectiveBucketer::AbortStep(int64_t step_id) {
+  std::vector<std::function<void()>> callbacks;
+  {
+    mutex_lock l(mu_);
+    if (frozen_ || observer_step_id_ != step_id ||
+        step_id == CollectiveExecutor::kInvalidId) {
+      return;
+    }
+    LOG(WARNING) << "Step " << step_id
+                 << " was aborted while recording the collective bucket plan; "
+                    "all-reduces will not be fused.";
+    records_.clear();
+    callbacks = FreezeLocked();
+  }
+  for (auto& callback : callbacks) callback();
+}
+
+bool CollectiveBucketer::NotifyWhenFrozen(std::function<void()> callback) {
+  mutex_lock l(mu_);
+  if (frozen_) return false;
+  frozen_callbacks_.push_back(std::move(callback));
+  return true;
+}
+
+std::vector<std::function<void()>> CollectiveBucketer::FreezeLocked() {
+  for (auto& it : records_) {
+    std::vector<Record> records;
+    records.reserve(it.second.size());
+    for (auto& rit : it.second) records.push_back(std::move(rit.second));
+    std::vector<Bucket> buckets = BuildPlan(std::move(records), bucket_bytes_);
+    auto& index = index_[it.first];
+    for (int i = 0; i < buckets.size(); ++i) {
+      for (const Member& m : buckets[i].members) {
+        index[m.instance_key] = i;
+      }
+    }
+    VLOG(1) << "Frozen collective bucket plan for device "
+            << std::get<0>(it.first) << " group " << std::get<1>(it.first)
+            << ": " << buckets.size() << " buckets";
+    plans_[it.first] = std::move(buckets);
+  }
+  records_.clear();
+  frozen_ = true;
+  std::vector<std::function<void()>> callbacks;
+  callbacks.swap(frozen_callbacks_);
+  return callbacks;
+}
+
+bool CollectiveBucketer::frozen() const {
+  mutex_lock l(mu_);
+  return frozen_;
+}
+
+const CollectiveBucketer::Bucket* CollectiveBucketer::Lookup(
+    const std::string& device, const CollectiveParams& col_params,
+    int* member_index) const {
+  mutex_lock l(mu_);
+  if (!frozen_) return nullptr;
+  const GroupKey key = {device, col_params.group.group_key};
+  auto index_it = index_.find(key);
+  if (index_it == index_.end()) return nullptr;
+  auto bucket_it = index_it->second.find(col_params.instance.instance_key);
+  if (bucket_it == index_it->second.end()) return nullptr;
+  const Bucket* bucket = &plans_.at(key)[bucket_it->second];
+  for (int i = 0; i < bucket->members.size(); ++i) {
+    if (bucket->members[i].instance_key == col_params.instance.instance_key) {
+      *member_index = i;
+      break;
+    }
+  }
+  return bucket;
+}
+
+/*static*/
+std::vector<CollectiveBucketer::Bucket> CollectiveBucketer::BuildPlan(
+    std::vector<Record> records, int64_t bucket_bytes) {
+  std::sort(records.begin(), records.end(),
+            [](const Record& a, const Record& b) {
+              return a.member.instance_key > b.member.instance_key;
+            });
+  // A bucket that is still taking members, with the latest launch and the
+  // earliest completion of its members. Its members were all pending at the
+  // same time as long as `max_launch_seq < min_done_seq`.
+  struct OpenBucket {
+    int index;
+    int64_t max_launch_seq;
+    int64_t min_done_seq;
+  };
+  std::vector<Bucket> buckets;
+  // Signature -> open bucket for that signature.
+  std::map<std::string, OpenBucket> open;
+  for (Record& r : records) {
+    const int64_t elt_bytes = DataTypeSize(r.dtype);
+    auto it = open.find(r.signature);
+    if (it != open.end()) {
+      OpenBucket& ob = it->second;
+      const Bucket& b = buckets[ob.index];
+      if ((b.num_elements + r.member.num_elements) * elt_bytes >
+              bucket_bytes ||
+          std::max(ob.max_launch_seq, r.launch_seq) >=
+              std::min(ob.min_done_seq, r.done_seq)) {
+        open.erase(it);
+        it = open.end();
+      }
+    }
+    if (it == open.end()) {
+      it = open.emplace(r.signature,
+                        OpenBucket{static_cast<int>(buckets.size()),
+                                   r.launch_seq, r.done_seq})
+               .first;
+      buckets.emplace_back();
+      buckets.back().dtype = r.dtype;
+    }
+    OpenBucket& ob = it->second;
+    ob.max_launch_seq = std::max(ob.max_launch_seq, r.launch_seq);
+    ob.min_done_seq = std::min(ob.min_done_seq, r.done_seq);
+    Bucket& b = buckets[ob.index];
+    r.member.offset = b.num_elements;
+    b.num_elements += r.member.num_elements;
+    b.members.push_back(r.member);
+  }
+  buckets.erase(std::remove_if(buckets.begin(), buckets.end(),
+                               [](const Bucket& b) {
+                                 return b.members.size() < 2;
+                               }),
+                buckets.end());
+  for (int i = 0; i < buckets.size(); ++i) buckets[i].id = i;
+  return buckets;
+}
+
+/*static*/
+void CollectiveBucketer::PackMember(const Member& member, const Tensor& input,
+                                    Tensor* fused) {
+  DCHECK_EQ(input.NumElements(), member.num_elements);
+  const int64_t elt_bytes = DataTypeSize(input.dtype());
+  std::memcpy(static_cast<char*>(DMAHelper::base(fused)) +
+                  member.offset * elt_bytes,
+              DMAHelper::base(&input), member.num_elements * elt_bytes);
+}
+
+/*static*/
+void CollectiveBucketer::UnpackMember(const Member& member,
+                                      const Tensor& fused, Tensor* output) {
+  DCHECK_EQ(output->NumElements(), member.num_elements);
+  const int64_t elt_bytes = DataTypeSize(output->dtype());
+  std::memcpy(DMAHelper::base(output),
+              static_cast<const char*>(DMAHelper::base(&fused)) +
+                  member.offset * elt_bytes,
+              member.num_elements * elt_bytes);
+}
+
+}  // namespace tensorflow
@@ -0,0 +1,190 @@
+/* Copyright 2026 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#ifndef TENSORFLOW_CORE_COMMON_RUNTIME_COLLECTIVE_BUCKETER_H_
+#define TENSORFLOW_CORE_COMMON_RUNTIME_COLLECTIVE_BUCKETER_H_
+
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <map>
+#include <memory>
+#include <string>
+#include <tuple>
+#include <vector>
+
+#include "absl/container/flat_hash_map.h"
+#include "tensorflow/core/framework/collective.h"
+#include "tensorflow/core/framework/tensor.h"
+#include "tensorflow/core/framework/types.pb.h"
+#include "tensorflow/core/platform/mutex.h"
+#include "tensorflow/core/platform/thread_annotations.h"
+
+namespace tensorflow {
+
+// Fuses small CPU all-reduces of a collective group into fixed-size buckets.
+//
+// Every worker must fuse the same instances into the same buckets in the same
+// steps, otherwise a fused all-reduce on one worker waits forever for peers
+// that run the members unfused. Bucket membership therefore cannot depend on
+// the order in which gradients become ready, nor on when a worker happens to
+// retire a step. Instead the bucketer runs in two phases:
+//
+//  1. The first step that runs an eligible all-reduce becomes the observer
+//     step. Its eligible all-reduces run unfused and are recorded per
+//     (device, group_key). All-reduces of other steps wait for the plan.
+//  2. When the observer step is cleaned up, the plan is frozen: recorded
+//     instances are ordered by descending instance key (gradients of later
+//     layers are produced first during backprop) and packed greedily into
+//     buckets of at most `bucket_bytes` with matching dtype and reduction ops.
+//     A bucket only takes instances that were all pending at the same time in
+//     the observer step: once a member completed before another instance was
+//     launched, the latter may depend on the former's result, and holding one
+//     back until the other arrives would hang. Buckets with a single member
+//     are dropped.
+//
+// The plan is a function of the instance keys, shapes and reduction ops
+// recorded in the observer step and of which of them overlapped, and it only
+// applies to steps other than the observer step, which all wait for it. Since
+// every step boundary is crossed by all workers in the same order, workers
+// whose observer steps ran the same reductions with the same overlap fuse
+// identically. A dependent all-reduce never overlaps its producer on any
+// worker, so dependencies always split buckets.
+//
+// After freezing, BaseCollectiveExecutor holds back the members of a bucket
+// until all of them have arrived, then launches the bucket as one all-reduce
+// over a packed buffer and scatters the result back into the members'
+// outputs. Buckets therefore launch in the order they become ready. Instances
+// missing from the plan keep running unfused. If the observer step is aborted
+// the plan is frozen empty, which disables fusion.
+//
+// The first step must run the same reductions on every worker, as in
+// synchronous data-parallel training where every step runs the same graph.
+class CollectiveBucketer {
+ public:
+  // Per-instance record used to build a plan.
+  struct Member {
+    int32_t instance_key = -1;
+    int64_t num_elements = 0;
+    // Offset of this member in the packed bucket, in elements.
+    int64_t offset = 0;
+  };
+
+  struct Bucket {
+    int64_t id = -1;
+    DataType dtype = DT_INVALID;
+    std::vector<Member> members;
+    int64_t num_elements = 0;
+  };
+
+  // Records of one (device, group_key) before the plan is frozen. Instances
+  // can only share a bucket if they have the same signature and were pending
+  // at the same time, i.e. each was launched before any other completed.
+  struct Record {
+    Member member;
+    DataType dtype = DT_INVALID;
+    std::string signature;
+    // Positions of the launch and the completion of the instance in the
+    // observer step. An instance that never completed stays pending.
+    int64_t launch_seq = 0;
+    int64_t done_seq = std::numeric_limits<int64_t>::max();
+  };
+
+  explicit CollectiveBucketer(int64_t bucket_bytes);
+
+  // Returns a bucketer configured by TF_COLLECTIVE_BUCKET_BYTES, or nullptr if
+  // the variable is unset or not positive.
+  static std::shared_ptr<CollectiveBucketer> CreateFromEnv();
+
+  int64_t bucket_bytes() const { return bucket_bytes_; }
+
+  // Returns true if `col_params` may be fused at all.
+  bool IsEligible(const CollectiveParams& col_params) const;
+
+  // Records an eligible all-reduce of `step_id` on `device` if no plan is
+  // frozen yet and `step_id` is the observer step, claiming it as the observer
+  // step if there is none. Returns true if it was recorded, in which case the
+  // all-reduce must run unfused.
+  bool Observe(int64_t step_id, const std::string& device,
+               const CollectiveParams& col_params) TF_LOCKS_EXCLUDED(mu_);
+
+  // Records that an all-reduce recorded by Observe() has completed. Must be
+  // called before the all-reduce's done callback, so that anything depending
+  // on its result is launched afterwards.
+  void ObserveDone(int64_t step_id, const std::string& device,
+                   int32_t group_key, int32_t instance_key)
+      TF_LOCKS_EXCLUDED(mu_);
+
+  // Freezes the plan from the recorded instances if `step_id` is the observer
+  // step. Called once the step has been cleaned up.
+  void RetireStep(int64_t step_id) TF_LOCKS_EXCLUDED(mu_);
+
+  // Freezes an empty plan if `step_id` is the observer step, since its records
+  // may be incomplete.
+  void AbortStep(int64_t step_id) TF_LOCKS_EXCLUDED(mu_);
+
+  // Calls `callback` once the plan is frozen and returns true, or returns
+  // false without calling it if the plan is frozen already.
+  bool NotifyWhenFrozen(std::function<void()> callback) TF_LOCKS_EXCLUDED(mu_);
+
+  bool frozen() const TF_LOCKS_EXCLUDED(mu_);
+
+  // Looks up the bucket of `col_params` on `device` in the frozen plan and
+  // sets `*member_index` to its position in the bucket. Returns nullptr if the
+  // instance runs unfused. The returned bucket stays valid for the lifetime of
+  // the bucketer.
+  const Bucket* Lookup(const std::string& device,
+                       const CollectiveParams& col_params,
+                       int* member_index) const TF_LOCKS_EXCLUDED(mu_);
+
+  // Packs recorded instances of one (device, group_key) into buckets.
+  // Exposed for testing.
+  static std::vector<Bucket> BuildPlan(std::vector<Record> records,
+                                       int64_t bucket_bytes);
+
+  // Copies `input` into `fused` at `member.offset`, or the matching slice of
+  // `fused` back into `output`. Tensors must be host resident.
+  static void PackMember(const Member& member, const Tensor& input,
+                         Tensor* fused);
+  static void UnpackMember(const Member& member, const Tensor& fused,
+                           Tensor* output);
+
+ private:
+  using GroupKey = std::tuple<std::string, int32_t>;
+
+  static std::string Signature(const CollectiveParams& col_params);
+
+  // Freezes the plan from `records_` and returns the callbacks waiting for it.
+  std::vector<std::function<void()>> FreezeLocked()
+      TF_EXCLUSIVE_LOCKS_REQUIRED(mu_);
+
+  const int64_t bucket_bytes_;
+
+  mutable mutex mu_;
+  bool frozen_ TF_GUARDED_BY(mu_) = false;
+  int64_t observer_step_id_ TF_GUARDED_BY(mu_) = CollectiveExecutor::kInvalidId;
+  std::vector<std::function<void()>> frozen_callbacks_ TF_GUARDED_BY(mu_);
+  // Orders launches and completions in the observer step.
+  int64_t next_seq_ TF_GUARDED_BY(mu_) = 0;
+  // (device, group_key) -> instance_key -> record, before freezing.
+  std::map<GroupKey, std::map<int32_t, Record>> records_ TF_GUARDED_BY(mu_);
+  // (device, group_key) -> buckets, after freezing.
+  std::map<GroupKey, std::vector<Bucket>> plans_ TF_GUARDED_BY(mu_);
+  // (device, group_key) -> instance_key -> index into plans_, after freezing.
+  std::map<GroupKey, absl::flat_hash_map<int32_t, int>> index_
+      TF_GUARDED_BY(mu_);
+};
+
+}  // namespace tensorflow
+#endif  // TENSORFLOW_CORE_COMMON_RUNTIME_COLLECTIVE_BUCKETER_H_
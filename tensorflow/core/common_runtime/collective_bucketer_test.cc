@@ -0,0 +1,183 @@
+/* Copyright 2026 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#include "tensorflow/core/common_runtime/collective_bucketer.h"
+
+#include <string>
+#include <vector>
+
+#include "tensorflow/core/framework/collective.h"
+#include "tensorflow/core/framework/tensor.h"
+#include "tensorflow/core/framework/tensor_testutil.h"
+#include "tensorflow/core/platform/refcount.h"
+#include "tensorflow/core/platform/test.h"
+
+namespace tensorflow {
+namespace {
+
+CollectiveBucketer::Record MakeRecord(int32_t instance_key,
+                                      int64_t num_elements,
+                                      DataType dtype = DT_FLOAT,
+                                      const std::string& signature = "sum") {
+  CollectiveBucketer::Record r;
+  r.member.instance_key = instance_key;
+  r.member.num_elements = num_elements;
+  r.dtype = dtype;
+  r.signature = signature;
+  return r;
+}
+
+std::vector<int32_t> Keys(const CollectiveBucketer::Bucket& b) {
+  std::vector<int32_t> keys;
+  for (const auto& m : b.members) keys.push_back(m.instance_key);
+  return keys;
+}
+
+TEST(CollectiveBucketerTest, PacksInDescendingInstanceKeyOrder) {
+  // 4 bytes per element, 64 byte buckets.
+  std::vector<CollectiveBucketer::Record> records = {
+      MakeRecord(1, 8), MakeRecord(2, 8), MakeRecord(3, 8), MakeRecord(4, 8),
+      MakeRecord(5, 4)};
+  std::vector<CollectiveBucketer::Bucket> buckets =
+      CollectiveBucketer::BuildPlan(records, 64);
+  ASSERT_EQ(buckets.size(), 2);
+  EXPECT_EQ(Keys(buckets[0]), std::vector<int32_t>({5, 4, 3}));
+  EXPECT_EQ(buckets[0].num_elements, 20);
+  EXPECT_EQ(buckets[0].members[0].offset, 0);
+  EXPECT_EQ(buckets[0].members[1].offset, 4);
+  EXPECT_EQ(buckets[0].members[2].offset, 12);
+  EXPECT_EQ(Keys(buckets[1]), std::vector<int32_t>({2, 1}));
+  EXPECT_EQ(buckets[1].id, 1);
+}
+
+TEST(CollectiveBucketerTest, SeparatesSignaturesAndDropsSingletons) {
+  std::vector<CollectiveBucketer::Record> records = {
+      MakeRecord(1, 4), MakeRecord(2, 4, DT_DOUBLE, "sum_double"),
+      MakeRecord(3, 4), MakeRecord(4, 4, DT_FLOAT, "max")};
+  std::vector<CollectiveBucketer::Bucket> buckets =
+      CollectiveBucketer::BuildPlan(records, 1024);
+  ASSERT_EQ(buckets.size(), 1);
+  EXPECT_EQ(Keys(buckets[0]), std::vector<int32_t>({3, 1}));
+  EXPECT_EQ(buckets[0].dtype, DT_FLOAT);
+  EXPECT_EQ(buckets[0].id, 0);
+}
+
+TEST(CollectiveBucketerTest, SplitsInstancesThatWereNotPendingTogether) {
+  // Instance 3 consumes the result of instance 2, so it was launched after
+  // instance 2 completed. Instance 1 overlapped with both.
+  std::vector<CollectiveBucketer::Record> records = {
+      MakeRecord(1, 4), MakeRecord(2, 4), MakeRecord(3, 4)};
+  records[0].launch_seq = 0;
+  records[0].done_seq = 5;
+  records[1].launch_seq = 1;
+  records[1].done_seq = 2;
+  records[2].launch_seq = 3;
+  records[2].done_seq = 4;
+  std::vector<CollectiveBucketer::Bucket> buckets =
+      CollectiveBucketer::BuildPlan(records, 1024);
+  ASSERT_EQ(buckets.size(), 1);
+  EXPECT_EQ(Keys(buckets[0]), std::vector<int32_t>({2, 1}));
+}
+
+TEST(CollectiveBucketerTest, PackAndUnpack) {
+  CollectiveBucketer::Member a{/*instance_key=*/1, /*num_elements=*/2,
+                               /*offset=*/0};
+  CollectiveBucketer::Member b{/*instance_key=*/2, /*num_elements=*/3,
+                               /*offset=*/2};
+  Tensor fused(DT_FLOAT, TensorShape({5}));
+  CollectiveBucketer::PackMember(a, test::AsTensor<float>({1, 2}), &fused);
+  CollectiveBucketer::PackMember(b, test::AsTensor<float>({3, 4, 5}), &fused);
+  test::ExpectTensorEqual<float>(fused, test::AsTensor<float>({1, 2, 3, 4, 5}));
+
+  Tensor out_b(DT_FLOAT, TensorShape({3}));
+  CollectiveBucketer::UnpackMember(b, fused, &out_b);
+  test::ExpectTensorEqual<float>(out_b, test::AsTensor<float>({3, 4, 5}));
+}
+
+core::RefCountPtr<CollectiveParams> MakeParams(int32_t instance_key) {
+  core::RefCountPtr<CollectiveParams> cp(new CollectiveParams());
+  cp->group.group_key = 1;
+  cp->instance.instance_key = instance_key;
+  cp->instance.type = REDUCTION_COLLECTIVE;
+  cp->instance.data_type = DT_FLOAT;
+  cp->instance.shape = TensorShape({4});
+  return cp;
+}
+
+TEST(CollectiveBucketerTest, FreezesWhenObserverStepRetires) {
+  const std::string device = "/device:CPU:0";
+  CollectiveBucketer bucketer(1024);
+  auto cp1 = MakeParams(1);
+  auto cp2 = MakeParams(2);
+  EXPECT_TRUE(bucketer.Observe(/*step_id=*/7, device, *cp1));
+  // Only the first step records, other steps wait for the plan.
+  EXPECT_FALSE(bucketer.Observe(/*step_id=*/8, device, *cp2));
+  EXPECT_TRUE(bucketer.Observe(/*step_id=*/7, device, *cp2));
+  bool notified = false;
+  EXPECT_TRUE(bucketer.NotifyWhenFrozen([&notified]() { notified = true; }));
+
+  bucketer.RetireStep(/*step_id=*/8);
+  EXPECT_FALSE(bucketer.frozen());
+  EXPECT_FALSE(notified);
+  int member_index = -1;
+  EXPECT_EQ(bucketer.Lookup(device, *cp1, &member_index), nullptr);
+
+  bucketer.RetireStep(/*step_id=*/7);
+  EXPECT_TRUE(bucketer.frozen());
+  EXPECT_TRUE(notified);
+  const CollectiveBucketer::Bucket* bucket =
+      bucketer.Lookup(device, *cp1, &member_index);
+  ASSERT_NE(bucket, nullptr);
+  EXPECT_EQ(Keys(*bucket), std::vector<int32_t>({2, 1}));
+  EXPECT_EQ(member_index, 1);
+  EXPECT_FALSE(bucketer.Observe(/*step_id=*/7, device, *cp1));
+  EXPECT_FALSE(bucketer.NotifyWhenFrozen([]() {}));
+}
+
+TEST(CollectiveBucketerTest, DoesNotFuseDependentAllReduces) {
+  const std::string device = "/device:CPU:0";
+  CollectiveBucketer bucketer(1024);
+  auto cp1 = MakeParams(1);
+  auto cp2 = MakeParams(2);
+  // The second all-reduce consumes the result of the first.
+  EXPECT_TRUE(bucketer.Observe(/*step_id=*/7, device, *cp1));
+  bucketer.ObserveDone(/*step_id=*/7, device, /*group_key=*/1,
+                       /*instance_key=*/1);
+  EXPECT_TRUE(bucketer.Observe(/*step_id=*/7, device, *cp2));
+  bucketer.ObserveDone(/*step_id=*/7, device, /*group_key=*/1,
+                       /*instance_key=*/2);
+  bucketer.RetireStep(/*step_id=*/7);
+  ASSERT_TRUE(bucketer.frozen());
+  int member_index = -1;
+  EXPECT_EQ(bucketer.Lookup(device, *cp1, &member_index), nullptr);
+  EXPECT_EQ(bucketer.Lookup(device, *cp2, &member_index), nullptr);
+}
+
+TEST(CollectiveBucketerTest, AbortedObserverStepFreezesEmptyPlan) {
+  const std::string device = "/device:CPU:0";
+  CollectiveBucketer bucketer(1024);
+  auto cp1 = MakeParams(1);
+  auto cp2 = MakeParams(2);
+  EXPECT_TRUE(bucketer.Observe(/*step_id=*/3, device, *cp1));
+  EXPECT_TRUE(bucketer.Observe(/*step_id=*/3, device, *cp2));
+  bucketer.AbortStep(/*step_id=*/4);
+  EXPECT_FALSE(bucketer.frozen());
+  bucketer.AbortStep(/*step_id=*/3);
+  EXPECT_TRUE(bucketer.frozen());
+  int member_index = -1;
+  EXPECT_EQ(bucketer.Lookup(device, *cp1, &member_index), nullptr);
+}
+
+}  // namespace
+}  // namespace tensorflow
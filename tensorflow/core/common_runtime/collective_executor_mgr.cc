@@ -44,7 +44,8 @@ CollectiveExecutorMgr::CollectiveExecutorMgr(
           // Use a 8MB stack size for collective operations. The default stack
           // size is 64KB in thread_manager.cc is not enough for NCCL
           // operations, b/446237508.
-          ThreadOptions{.stack_size = 8 * 1024 * 1024})) {}
+          ThreadOptions{.stack_size = 8 * 1024 * 1024})),
+      bucketer_(CollectiveBucketer::CreateFromEnv()) {}
 
 CollectiveExecutorMgr::~CollectiveExecutorMgr() {
   for (auto iter : executor_table_) {
@@ -71,7 +72,8 @@ CollectiveExecutor* CollectiveExecutorMgr::FindOrCreate(int64_t step_id) {
 CollectiveExecutor* CollectiveExecutorMgr::Create(int64_t step_id) {
   CollectiveRemoteAccessLocal* rma =
       new CollectiveRemoteAccessLocal(dev_mgr_, dev_resolver_.get(), step_id);
-  return new BaseCollectiveExecutor(this, rma, step_id, dev_mgr_, work_queue_);
+  return new BaseCollectiveExecutor(this, rma, step_id, dev_mgr_, work_queue_,
+                                    bucketer_);
 }
 
 void CollectiveExecutorMgr::Cleanup(int64_t step_id) {
@@ -85,6 +87,9 @@ void CollectiveExecutorMgr::Cleanup(int64_t step_id) {
     }
   }
   if (ce) ce->Unref();
+  // The cleanup of the step that recorded the bucket plan freezes it for the
+  // steps that wait on it.
+  if (bucketer_ != nullptr) bucketer_->RetireStep(step_id);
 }
 
 void CollectiveExecutorMgr::CleanupAll() {
@@ -95,6 +100,7 @@ void CollectiveExecutorMgr::CleanupAll() {
   }
   for (auto iter : executor_table) {
     iter.second->Unref();
+    if (bucketer_ != nullptr) bucketer_->RetireStep(iter.first);
   }
 }
 
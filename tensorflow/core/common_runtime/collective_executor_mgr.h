@@ -15,6 +15,7 @@ limitations under the License.
 #ifndef TENSORFLOW_CORE_COMMON_RUNTIME_COLLECTIVE_EXECUTOR_MGR_H_
 #define TENSORFLOW_CORE_COMMON_RUNTIME_COLLECTIVE_EXECUTOR_MGR_H_
 
+#include "tensorflow/core/common_runtime/collective_bucketer.h"
 #include "tensorflow/core/framework/collective.h"
 #include "tensorflow/core/lib/gtl/flatmap.h"
 #include "tensorflow/core/platform/unbounded_work_queue.h"
@@ -77,6 +78,9 @@ class CollectiveExecutorMgr : public CollectiveExecutorMgrInterface {
   // collective op execution.  Ownership is shared between `this` and
   // `CollectiveRemoteAccessLocal`.
   std::shared_ptr<UnboundedWorkQueue> work_queue_;
+  // Fuses small CPU all-reduces into buckets if TF_COLLECTIVE_BUCKET_BYTES is
+  // set. Shared with every CollectiveExecutor so the plan outlives a step.
+  std::shared_ptr<CollectiveBucketer> bucketer_;
 
  private:
   mutex exec_mu_;
@@ -17,6 +17,7 @@ limitations under the License.
 #include <stddef.h>
 
 #include <algorithm>
+#include <cstdint>
 #include <tuple>
 #include <unordered_set>
 #include <utility>
@@ -62,13 +63,40 @@ void CollectiveParamResolverLocal::CompleteGroupAsync(
 }
 
 namespace {
+// Smallest group for which recursive halving and doubling needs fewer steps
+// than the ring.
+constexpr int kHalvingDoublingMinGroupSize = 4;
+// All-reduces of at most this many bytes are latency-bound and use recursive
+// doubling, which needs the fewest steps but sends the whole tensor in each.
+constexpr int64_t kRecursiveDoublingMaxBytes = 64 << 10;
+
+const char* GetReductionCollectiveName(const CollectiveParams* cp) {
+  // The halving-doubling reducers only support CPU devices.
+  if (cp->group.device_type != DEVICE_CPU ||
+      cp->instance.impl_details.communication_hint == "ring" ||
+      cp->group.group_size < kHalvingDoublingMinGroupSize) {
+    return "RingReduce";
+  }
+  const int64_t num_bytes = cp->instance.shape.num_elements() *
+                            DataTypeSize(cp->instance.data_type);
+  if (num_bytes <= kRecursiveDoublingMaxBytes) {
+    return "RecursiveDoublingReduce";
+  }
+  // Rabenseifner's algorithm sends as much data as the ring in fewer steps,
+  // but folding a group whose size is not a power of two costs two extra
+  // transfers of the whole tensor.
+  const bool is_power_of_two =
+      (cp->group.group_size & (cp->group.group_size - 1)) == 0;
+  return is_power_of_two ? "RabenseifnerReduce" : "RingReduce";
+}
+
 const char* GetCollectiveName(const CollectiveParams* cp, bool nccl) {
   switch (cp->instance.type) {
     case BROADCAST_COLLECTIVE:
       return nccl ? "NcclBroadcast" : "HierarchicalTreeBroadcast";
 
     case REDUCTION_COLLECTIVE:
-      return nccl ? "NcclReduce" : "RingReduce";
+      return nccl ? "NcclReduce" : GetReductionCollectiveName(cp);
 
     case GATHER_COLLECTIVE:
       return nccl ? "NcclGather" : "RingGather";
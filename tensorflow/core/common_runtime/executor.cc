@@ -18,9 +18,11 @@ limitations under the License.
 #include <algorithm>
 #include <atomic>
 #include <memory>
+#include <type_traits>
 #include <utility>
 #include <vector>
 
+#include "absl/container/inlined_vector.h"
 #include "absl/memory/memory.h"
 #include "absl/strings/ascii.h"
 #include "absl/strings/numbers.h"
@@ -179,11 +181,19 @@ typedef absl::InlinedVector<AllocatorAttributes, 4UL> AllocatorAttributeVec;
 
 class ExecutorImpl : public Executor {
  public:
-  explicit ExecutorImpl(const LocalExecutorParams& p) : immutable_state_(p) {}
+  // If `prioritize_critical_path` is true, ready nodes are dispatched in
+  // decreasing order of the estimated cost of the longest path from them to
+  // the end of the graph. See `ExecutorState::ScheduleReadyByCriticalPath()`.
+  ExecutorImpl(const LocalExecutorParams& p, bool prioritize_critical_path)
+      : immutable_state_(p),
+        prioritize_critical_path_(prioritize_critical_path) {}
 
   absl::Status Initialize(const Graph& graph) {
     TF_RETURN_IF_ERROR(immutable_state_.Initialize(graph));
     kernel_stats_.Initialize(immutable_state_.graph_view());
+    if (prioritize_critical_path_) {
+      kernel_stats_.InitializeCriticalPaths(immutable_state_.graph_view());
+    }
     return absl::OkStatus();
   }
 
@@ -248,6 +258,95 @@ class ExecutorImpl : public Executor {
       cost_estimate.store(new_estimate, std::memory_order_relaxed);
     }
 
+    // Prepares to track the critical path of every node, i.e. the estimated
+    // cost of the longest path from the node to the end of the graph, which is
+    // then refreshed by `MaybeUpdateCriticalPaths()`. Until the first refresh,
+    // every node has the same critical path.
+    void InitializeCriticalPaths(const GraphView& gview) {
+      const int32_t num_nodes = gview.num_nodes();
+      critical_path_cycles_ =
+          std::make_unique<std::atomic_uint_fast64_t[]>(num_nodes);
+      // Order the nodes topologically, ignoring the back edges out of
+      // NextIteration nodes.
+      std::vector<int32_t> num_pending_inputs(num_nodes, 0);
+      auto for_each_successor = [](const NodeItem& item, auto fn) {
+        if (item.is_next_iteration) return;
+        for (const EdgeInfo& e : item.output_edges()) fn(e.dst_id);
+        for (const ControlEdgeInfo& e : item.output_control_edges()) {
+          fn(e.dst_id);
+        }
+      };
+      for (int32_t i = 0; i < num_nodes; ++i) {
+        if (gview.node(i) == nullptr) continue;
+        for_each_successor(*gview.node(i),
+                           [&](int32_t dst) { ++num_pending_inputs[dst]; });
+      }
+      topological_order_.clear();
+      topological_order_.reserve(num_nodes);
+      for (int32_t i = 0; i < num_nodes; ++i) {
+        if (gview.node(i) != nullptr && num_pending_inputs[i] == 0) {
+          topological_order_.push_back(i);
+        }
+      }
+      for (size_t next = 0; next < topological_order_.size(); ++next) {
+        for_each_successor(*gview.node(topological_order_[next]),
+                           [&](int32_t dst) {
+                             if (--num_pending_inputs[dst] == 0) {
+                               topological_order_.push_back(dst);
+                             }
+                           });
+      }
+    }
+
+    // Returns true iff `InitializeCriticalPaths()` has been called.
+    bool TracksCriticalPaths() const {
+      return critical_path_cycles_ != nullptr;
+    }
+
+    // Returns the estimated cost, in cycles, of the longest path from `node`
+    // to the end of the graph.
+    uint64_t CriticalPathCycles(const NodeItem& node) const {
+      return critical_path_cycles_[node.node_id].load(
+          std::memory_order_relaxed);
+    }
+
+    // Recomputes the critical paths from the current cost estimates once every
+    // `kCriticalPathUpdateIntervalSteps` calls. Called at the start of each
+    // step.
+    void MaybeUpdateCriticalPaths(const GraphView& gview) {
+      if (num_steps_.fetch_add(1, std::memory_order_relaxed) %
+              kCriticalPathUpdateIntervalSteps !=
+          0) {
+        return;
+      }
+      // Concurrent updates compute the same values from slightly different
+      // estimates, so their writes may interleave.
+      std::vector<uint64_t> critical_path(gview.num_nodes(), 0);
+      for (auto it = topological_order_.rbegin();
+           it != topological_order_.rend(); ++it) {
+        const NodeItem& item = *gview.node(*it);
+        uint64_t longest_successor_path = 0;
+        if (!item.is_next_iteration) {
+          for (const EdgeInfo& e : item.output_edges()) {
+            longest_successor_path =
+                std::max(longest_successor_path, critical_path[e.dst_id]);
+          }
+          for (const ControlEdgeInfo& e : item.output_control_edges()) {
+            longest_successor_path =
+                std::max(longest_successor_path, critical_path[e.dst_id]);
+          }
+        }
+        // Only kernels marked expensive have their cost measured.
+        const uint64_t cost =
+            is_expensive_[*it]
+                ? cost_estimates_[*it].load(std::memory_order_relaxed)
+                : kInexpensiveCostEstimateCycles;
+        critical_path[*it] = cost + longest_successor_path;
+        critical_path_cycles_[*it].store(critical_path[*it],
+                                         std::memory_order_relaxed);
+      }
+    }
+
    private:
     // Initial time (in CPU cycles) we expect an operation to take.  Used to
     // determine whether an operation should be place in a threadpool.
@@ -255,12 +354,21 @@ class ExecutorImpl : public Executor {
     static constexpr uint64_t kInitialCostEstimateCycles = 100 * 1000 * 1000;
     static constexpr uint64_t kOpIsExpensiveThresholdCycles = 8000;
     static constexpr uint64_t kCostDecay = 10;
+    // Cost (in CPU cycles) assumed for kernels that are not marked expensive,
+    // whose execution time is not measured.
+    static constexpr uint64_t kInexpensiveCostEstimateCycles = 1000;
+    static constexpr int64_t kCriticalPathUpdateIntervalSteps = 16;
     std::vector<bool> is_expensive_;
     // std::unique_ptr<std::atomic<bool>[]> is_expensive_;
     std::unique_ptr<std::atomic_uint_fast64_t[]> cost_estimates_;
+    // Only set if `InitializeCriticalPaths()` has been called.
+    std::unique_ptr<std::atomic_uint_fast64_t[]> critical_path_cycles_;
+    std::vector<int32_t> topological_order_;
+    std::atomic<int64_t> num_steps_{0};
   };
 
   ImmutableExecutorState immutable_state_;
+  const bool prioritize_critical_path_;
   KernelStats kernel_stats_;
 
   ExecutorImpl(const ExecutorImpl&) = delete;
@@ -378,6 +486,17 @@ class ExecutorState {
   // REQUIRES: `!ready->empty()`.
   void ScheduleReady(TaggedNodeSeq* ready, TaggedNodeReadyQueue* inline_ready);
 
+  // Implements ScheduleReady() when `prioritize_critical_path_` is true.
+  // Dispatches the nodes in '*ready' in decreasing order of their critical
+  // path, so that the inter-op pool starts them in roughly that order. The
+  // current thread continues with the most critical node. Inexpensive nodes
+  // that it does not run itself are dispatched in closures of up to
+  // `kMaxInexpensiveNodesPerClosure` nodes, which saves a closure and a thread
+  // wakeup per node on wide graphs.
+  void ScheduleReadyByCriticalPath(TaggedNodeSeq* ready,
+                                   TaggedNodeReadyQueue* inline_ready,
+                                   int64_t scheduled_nsec);
+
   // A wrapper for runner_ to keep track of the pending queue length. Op
   // execution should dispatch work using this function instead of using runner_
   // directly.
@@ -408,6 +527,10 @@ class ExecutorState {
   // TODO(fishx): Make it configurable if necessary.
   static constexpr uint64_t kInlineScheduleReadyThreshold = 500;
 
+  // Maximum number of inexpensive nodes that ScheduleReadyByCriticalPath()
+  // runs inline or dispatches in a single closure.
+  static constexpr size_t kMaxInexpensiveNodesPerClosure = 64;
+
   // Not owned.
   RendezvousInterface* rendezvous_;
   CollectiveExecutor* collective_executor_ = nullptr;
@@ -436,6 +559,9 @@ class ExecutorState {
   Executor::Args::Runner runner_;
   bool sync_on_finish_;
   const bool run_all_kernels_inline_;
+  // True if ready nodes are scheduled by ScheduleReadyByCriticalPath(). Never
+  // set when op order determinism is required.
+  const bool prioritize_critical_path_;
 
   PropagatorStateType propagator_;
 
@@ -486,6 +612,9 @@ ExecutorState<PropagatorStateType>::ExecutorState(
       runner_(args.runner),
       sync_on_finish_(args.sync_on_finish),
       run_all_kernels_inline_(args.run_all_kernels_inline),
+      prioritize_critical_path_(
+          kernel_stats->TracksCriticalPaths() &&
+          !std::is_same_v<PropagatorStateType, OrderedPropagatorState>),
       propagator_(immutable_state, step_id_, vlog_),
       num_outstanding_ops_(0) {
   if (args.user_intra_op_threadpool != nullptr) {
@@ -1336,6 +1465,8 @@ void ExecutorState<PropagatorStateType>::ScheduleReady(
         inline_ready->push_back(tagged_node);
       }
     }
+  } else if (prioritize_critical_path_) {
+    ScheduleReadyByCriticalPath(ready, inline_ready, scheduled_nsec);
   } else {
     const TaggedNode* curr_expensive_node = nullptr;
     TaggedNodeSeq expensive_nodes;
@@ -1413,6 +1544,80 @@ void ExecutorState<PropagatorStateType>::ScheduleReady(
   ready->clear();
 }
 
+template <class PropagatorStateType>
+void ExecutorState<PropagatorStateType>::ScheduleReadyByCriticalPath(
+    TaggedNodeSeq* ready, TaggedNodeReadyQueue* inline_ready,
+    int64_t scheduled_nsec) {
+  // Concurrent steps may update the critical paths while we sort, so the sort
+  // key is read once per node. Ties keep their order in `ready`.
+  absl::InlinedVector<std::pair<uint64_t, size_t>, 8UL> order;
+  order.reserve(ready->size());
+  for (size_t i = 0; i < ready->size(); ++i) {
+    const NodeItem& item = *(*ready)[i].node_item;
+    order.emplace_back(kernel_stats_->CriticalPathCycles(item), i);
+  }
+  std::sort(order.begin(), order.end(),
+            [](const std::pair<uint64_t, size_t>& a,
+               const std::pair<uint64_t, size_t>& b) {
+              return a.first > b.first ||
+                     (a.first == b.first && a.second < b.second);
+            });
+  TaggedNodeSeq sorted;
+  sorted.reserve(ready->size());
+  for (const auto& [cycles, index] : order) {
+    sorted.push_back((*ready)[index]);
+  }
+  ready->swap(sorted);
+
+  TaggedNodeSeq inexpensive_nodes;
+  auto dispatch_inexpensive_nodes = [&]() {
+    if (inexpensive_nodes.empty()) return;
+    RunTask([this, nodes = std::move(inexpensive_nodes), scheduled_nsec]() {
+      TaggedNodeReadyQueue inline_ready;
+      for (const TaggedNode& tagged_node : nodes) {
+        inline_ready.push_back(tagged_node);
+      }
+      ProcessInline(&inline_ready, scheduled_nsec);
+    });
+    inexpensive_nodes.clear();
+  };
+
+  // The current thread runs the most critical node if it is expensive and the
+  // thread has nothing else to do. Otherwise, it runs the most critical
+  // inexpensive nodes, unless it already runs an expensive one, which they
+  // would have to wait for.
+  const bool inline_expensive_node =
+      inline_ready != nullptr && inline_ready->empty() &&
+      !ready->front().get_is_dead() &&
+      kernel_stats_->IsExpensive(*ready->front().node_item);
+  size_t num_inline_inexpensive_nodes =
+      inline_ready != nullptr && !inline_expensive_node
+          ? kMaxInexpensiveNodesPerClosure
+          : 0;
+  for (auto it = ready->begin(); it != ready->end(); ++it) {
+    const TaggedNode& tagged_node = *it;
+    if (tagged_node.get_is_dead() ||
+        !kernel_stats_->IsExpensive(*tagged_node.node_item)) {
+      if (num_inline_inexpensive_nodes > 0) {
+        inline_ready->push_back(tagged_node);
+        --num_inline_inexpensive_nodes;
+      } else {
+        inexpensive_nodes.push_back(tagged_node);
+        if (inexpensive_nodes.size() == kMaxInexpensiveNodesPerClosure) {
+          dispatch_inexpensive_nodes();
+        }
+      }
+    } else if (inline_expensive_node && it == ready->begin()) {
+      inline_ready->push_back(tagged_node);
+    } else {
+      RunTask(std::bind(&ExecutorState::Process, this, tagged_node,
+                        scheduled_nsec),
+              /*sample_rate=*/ready->size());
+    }
+  }
+  dispatch_inexpensive_nodes();
+}
+
 template <class PropagatorStateType>
 void ExecutorState<PropagatorStateType>::ScheduleFinish() {
   // Checks condition to decide if needs to invoke Finish(). If there are
@@ -1551,6 +1756,9 @@ void ExecutorState<PropagatorStateType>::Finish() {
 }
 
 void ExecutorImpl::RunAsyncInternal(const Args& args, DoneCallback done) {
+  if (prioritize_critical_path_) {
+    kernel_stats_.MaybeUpdateCriticalPaths(immutable_state_.graph_view());
+  }
   if (OpOrderDeterminismRequired()) {
     (new ExecutorState<OrderedPropagatorState>(args, immutable_state_,
                                                &kernel_stats_))
@@ -1565,11 +1773,11 @@ void ExecutorImpl::RunAsyncInternal(const Args& args, DoneCallback done) {
   }
 }
 
-}  // namespace
-
-absl::Status NewLocalExecutor(const LocalExecutorParams& params,
-                              const Graph& graph, Executor** executor) {
-  ExecutorImpl* impl = new ExecutorImpl(params);
+absl::Status NewLocalExecutorImpl(const LocalExecutorParams& params,
+                                  const Graph& graph,
+                                  bool prioritize_critical_path,
+                                  Executor** executor) {
+  ExecutorImpl* impl = new ExecutorImpl(params, prioritize_critical_path);
   const absl::Status s = impl->Initialize(graph);
   if (s.ok()) {
     *executor = impl;
@@ -1579,6 +1787,14 @@ absl::Status NewLocalExecutor(const LocalExecutorParams& params,
   return s;
 }
 
+}  // namespace
+
+absl::Status NewLocalExecutor(const LocalExecutorParams& params,
+                              const Graph& graph, Executor** executor) {
+  return NewLocalExecutorImpl(params, graph,
+                              /*prioritize_critical_path=*/false, executor);
+}
+
 absl::Status CreateNonCachedKernel(
     Device* device, FunctionLibraryRuntime* flib,
     const std::shared_ptr<const NodeProperties>& props, int graph_def_version,
@@ -1597,21 +1813,34 @@ namespace {
 class DefaultExecutorRegistrar {
  public:
   DefaultExecutorRegistrar() {
-    Factory* factory = new Factory;
+    Factory* factory = new Factory(/*prioritize_critical_path=*/false);
     ExecutorFactory::Register("", factory);
     ExecutorFactory::Register("DEFAULT", factory);
+    // The default executor, dispatching the ready nodes with the longest
+    // estimated path to the end of the graph first. Helps on wide graphs whose
+    // critical path would otherwise queue behind cheap side branches.
+    ExecutorFactory::Register("CRITICAL_PATH_EXECUTOR",
+                              new Factory(/*prioritize_critical_path=*/true));
   }
 
  private:
   class Factory : public ExecutorFactory {
+   public:
+    explicit Factory(bool prioritize_critical_path)
+        : prioritize_critical_path_(prioritize_critical_path) {}
+
+   private:
     absl::Status NewExecutor(const LocalExecutorParams& params,
                              const Graph& graph,
                              std::unique_ptr<Executor>* out_executor) override {
       Executor* ret = nullptr;
-      TF_RETURN_IF_ERROR(NewLocalExecutor(params, graph, &ret));
+      TF_RETURN_IF_ERROR(NewLocalExecutorImpl(
+          params, graph, prioritize_critical_path_, &ret));
       out_executor->reset(ret);
       return absl::OkStatus();
     }
+
+    const bool prioritize_critical_path_;
   };
 };
 static DefaultExecutorRegistrar registrar;
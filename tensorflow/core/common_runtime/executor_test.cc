@@ -25,6 +25,7 @@ limitations under the License.
 #include "tensorflow/cc/ops/standard_ops.h"
 #include "tensorflow/core/common_runtime/device.h"
 #include "tensorflow/core/common_runtime/device_factory.h"
+#include "tensorflow/core/common_runtime/executor_factory.h"
 #include "tensorflow/core/common_runtime/graph_constructor.h"
 #include "tensorflow/core/common_runtime/kernel_benchmark_testlib.h"
 #include "tensorflow/core/common_runtime/lower_functional_ops.h"
@@ -76,8 +77,10 @@ class ExecutorTest : public ::testing::Test {
     delete exec_;
   }
 
-  // Resets executor_ with a new executor based on a graph 'gdef'.
-  void Create(std::unique_ptr<const Graph> graph) {
+  // Resets executor_ with a new executor of type 'executor_type' based on a
+  // graph 'gdef'.
+  void Create(std::unique_ptr<const Graph> graph,
+              const std::string& executor_type = "") {
     const int version = graph->versions().producer();
     LocalExecutorParams params;
     params.device = device_.get();
@@ -92,7 +95,9 @@ class ExecutorTest : public ::testing::Test {
     };
     rendez_ = NewLocalRendezvous();
     delete exec_;
-    TF_CHECK_OK(NewLocalExecutor(params, *graph, &exec_));
+    std::unique_ptr<Executor> executor;
+    TF_CHECK_OK(NewExecutor(executor_type, params, *graph, &executor));
+    exec_ = executor.release();
     runner_ = [this](std::function<void()> fn) { thread_pool_->Schedule(fn); };
   }
 
@@ -190,6 +195,38 @@ TEST_F(ExecutorTest, SimpleAdd) {
   EXPECT_EQ(2.0, V(out));  // out = 1.0 + 1.0 = 2.0
 }
 
+TEST_F(ExecutorTest, CriticalPathExecutor) {
+  // c = a + 8 * b, computed by a chain of adds next to many cheap side
+  // branches.
+  auto g = std::make_unique<Graph>(OpRegistry::Global());
+  auto in0 = test::graph::Recv(g.get(), "a", "float", ALICE, 1, BOB);
+  auto in1 = test::graph::Recv(g.get(), "b", "float", ALICE, 1, BOB);
+  for (int i = 0; i < 100; ++i) {
+    test::graph::Identity(g.get(), test::graph::Identity(g.get(), in0));
+  }
+  Node* tmp = in0;
+  for (int i = 0; i < 8; ++i) {
+    tmp = test::graph::Add(g.get(), tmp, in1);
+  }
+  test::graph::Send(g.get(), tmp, "c", BOB, 1, ALICE);
+  Create(std::move(g), "CRITICAL_PATH_EXECUTOR");
+  // Run enough steps for the critical paths to be recomputed from measured
+  // costs.
+  for (int step = 0; step < 40; ++step) {
+    Rendezvous::Args args;
+    TF_ASSERT_OK(rendez_->Send(Key(ALICE, kIncarnation, BOB, "a"), args,
+                               V(static_cast<float>(step)), false));
+    TF_ASSERT_OK(rendez_->Send(Key(ALICE, kIncarnation, BOB, "b"), args, V(1.0),
+                               false));
+    TF_ASSERT_OK(Run(rendez_));
+    Tensor out = V(-1);
+    bool is_dead = false;
+    TF_ASSERT_OK(rendez_->Recv(Key(BOB, kIncarnation, ALICE, "c"), args, &out,
+                               &is_dead));
+    EXPECT_EQ(step + 8.0, V(out));
+  }
+}
+
 TEST_F(ExecutorTest, StepStatsNumerical) {
   // Similar to SimpleAdd, but tests numerical values in StepStats
 
@@ -552,6 +589,60 @@ BENCHMARK(BM_executor)->UseRealTime()->ArgPair(8192, 32);
 // Tall fat graph
 BENCHMARK(BM_executor)->UseRealTime()->ArgPair(1024, 1024);
 
+// Create a graph with a chain of 'depth' expensive matmuls, next to 'width'
+// cheap side branches that become ready at the same time as the chain.
+// Compares the default executor with one that dispatches the chain first.
+static void BM_WideDeepGraph(::testing::benchmark::State& state,
+                             const char* executor_type) {
+  const int width = state.range(0);
+  const int depth = state.range(1);
+
+  Graph* g = new Graph(OpRegistry::Global());
+  Tensor small(DT_FLOAT, TensorShape({4, 4}));
+  small.flat<float>().setRandom();
+  Tensor large(DT_FLOAT, TensorShape({128, 128}));
+  large.flat<float>().setRandom();
+  Node* side_input = test::graph::Constant(g, small);
+  for (int i = 0; i < width; ++i) {
+    Node* side = test::graph::Identity(g, side_input);
+    test::graph::Matmul(g, side, side, false, false);
+  }
+  Node* weights = test::graph::Constant(g, large);
+  Node* chain = test::graph::Constant(g, large);
+  for (int i = 0; i < depth; ++i) {
+    chain = test::graph::Matmul(g, chain, weights, false, false);
+  }
+
+  FixupSourceAndSinkEdges(g);
+  test::Benchmark("cpu", g, /*options=*/nullptr, /*init=*/nullptr,
+                  /*rendez=*/nullptr, executor_type,
+                  /*old_benchmark_api=*/false)
+      .Run(state);
+  state.SetItemsProcessed(static_cast<int64_t>(2 * width + depth + 3) *
+                          state.iterations());
+}
+
+static void BM_WideDeepGraphDefaultExecutor(
+    ::testing::benchmark::State& state) {
+  BM_WideDeepGraph(state, "");
+}
+
+static void BM_WideDeepGraphCriticalPathExecutor(
+    ::testing::benchmark::State& state) {
+  BM_WideDeepGraph(state, "CRITICAL_PATH_EXECUTOR");
+}
+
+BENCHMARK(BM_WideDeepGraphDefaultExecutor)
+    ->UseRealTime()
+    ->ArgPair(256, 16)
+    ->ArgPair(4096, 16)
+    ->ArgPair(4096, 64);
+BENCHMARK(BM_WideDeepGraphCriticalPathExecutor)
+    ->UseRealTime()
+    ->ArgPair(256, 16)
+    ->ArgPair(4096, 16)
+    ->ArgPair(4096, 64);
+
 static void BM_const_identity(::testing::benchmark::State& state) {
   const int width = state.range(0);
   const int outputs_per_const = state.range(1);
@@ -0,0 +1,330 @@
+/* Copyright 2026 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#include "tensorflow/core/common_runtime/halving_doubling_reducer.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <utility>
+
+#include "absl/log/check.h"
+#include "absl/log/log.h"
+#include "absl/status/status.h"
+#include "absl/strings/str_cat.h"
+#include "absl/synchronization/notification.h"
+#include "tensorflow/core/common_runtime/base_collective_executor.h"
+#include "tensorflow/core/common_runtime/collective_rma_local.h"
+#include "tensorflow/core/common_runtime/collective_util.h"
+#include "tensorflow/core/common_runtime/device.h"
+#include "tensorflow/core/common_runtime/dma_helper.h"
+#include "tensorflow/core/framework/allocator.h"
+#include "tensorflow/core/framework/collective.h"
+#include "tensorflow/core/framework/op_kernel.h"
+#include "tensorflow/core/framework/tensor.h"
+#include "tensorflow/core/framework/types.h"
+#include "tensorflow/core/platform/blocking_counter.h"
+#include "tensorflow/core/platform/mutex.h"
+#include "tensorflow/core/profiler/lib/traceme.h"
+
+namespace tensorflow {
+namespace {
+
+// Step ids of the transfers that fold the ranks beyond the largest power of
+// two into their neighbors and send them the result. The exchange steps are
+// numbered from 1.
+constexpr int kFoldStep = 0;
+constexpr int kUnfoldStep = -1;
+
+}  // namespace
+
+HalvingDoublingReducer::HalvingDoublingReducer(Algorithm algorithm,
+                                               const std::string& name)
+    : algorithm_(algorithm),
+      name_(name),
+      col_ctx_(nullptr),
+      col_params_(nullptr),
+      group_size_(0),
+      num_folded_(0) {}
+
+absl::Status HalvingDoublingReducer::InitializeCollectiveParams(
+    CollectiveParams* col_params) {
+  if (col_params->instance.type != REDUCTION_COLLECTIVE) {
+    return absl::InvalidArgumentError(
+        absl::StrCat(name_, " only implements reduction collectives"));
+  }
+  if (col_params->group.device_type != DEVICE_CPU) {
+    return absl::InvalidArgumentError(
+        absl::StrCat(name_, " only supports CPU devices, got ",
+                     col_params->group.device_type.type_string()));
+  }
+  return absl::OkStatus();
+}
+
+absl::Status HalvingDoublingReducer::InitializeCollectiveContext(
+    std::shared_ptr<CollectiveContext> col_ctx) {
+  DCHECK(col_ctx->dev_mgr);
+  col_ctx_ = col_ctx;
+  col_params_ = col_ctx->col_params.get();
+  return collective_util::InitializeDeviceAndLocality(
+      col_ctx->dev_mgr, col_ctx->device_name, &col_ctx->device,
+      &col_ctx->device_locality);
+}
+
+void HalvingDoublingReducer::Run(StatusCallback done) {
+  CHECK(col_ctx_);
+  CHECK(col_params_);
+  // Like the ring, this does not require non-overlapping collectives.
+  col_ctx_->col_exec->UnblockDependencies(*col_params_);
+  group_size_ = col_params_->group.group_size;
+
+  // Reduce in place in the output.
+  if ((col_ctx_->input != col_ctx_->output) &&
+      (DMAHelper::base(col_ctx_->input) != DMAHelper::base(col_ctx_->output))) {
+    absl::Notification note;
+    absl::Status status;
+    tsl::profiler::TraceMe activity("MemCpyAsync",
+                                    tsl::profiler::TraceMeLevel::kInfo);
+    CollectiveRemoteAccessLocal::MemCpyAsync(
+        col_ctx_->op_ctx->op_device_context(),
+        col_ctx_->op_ctx->op_device_context(), col_ctx_->device,
+        col_ctx_->device, col_ctx_->op_ctx->input_alloc_attr(0),
+        col_ctx_->op_ctx->output_alloc_attr(0), col_ctx_->input,
+        col_ctx_->output, 0 /*dev_to_dev_stream_index*/,
+        [&note, &status](const absl::Status& s) {
+          status.Update(s);
+          note.Notify();
+        });
+    note.WaitForNotification();
+    if (!status.ok()) {
+      done(status);
+      return;
+    }
+  }
+
+  int num_vranks = 1;
+  while (num_vranks * 2 <= group_size_) num_vranks *= 2;
+  num_folded_ = group_size_ - num_vranks;
+  Allocator* allocator = col_ctx_->device->GetAllocator(
+      col_ctx_->op_ctx->output_alloc_attr(0));
+  ca_.reset(MakeCollectiveAdapter(col_ctx_->output, num_vranks, allocator));
+  tmp_ = Tensor(allocator, col_ctx_->output->dtype(),
+                TensorShape({ca_->Value().NumElements()}));
+
+  absl::Status s = RunAllReduce(num_vranks);
+  if (!s.ok()) {
+    LOG(ERROR) << "Aborting " << name_ << " with " << s;
+    // Cancel the transfers of the other ranks, unless this is a cancellation.
+    CancellationManager* cancellation_manager =
+        col_ctx_->op_ctx->cancellation_manager();
+    if (cancellation_manager == nullptr ||
+        (!cancellation_manager->IsCancelled() &&
+         !cancellation_manager->IsCancelling())) {
+      col_ctx_->col_exec->StartAbort(s);
+    }
+  }
+  ca_->ConsumeFinalValue(col_ctx_->output);
+  ca_.reset();
+  tmp_ = Tensor();
+  done(s);
+}
+
+absl::Status HalvingDoublingReducer::RunAllReduce(int num_vranks) {
+  const int rank = col_params_->default_rank;
+  Tensor all = Blocks(0, num_vranks, num_vranks);
+  int vrank = -1;
+  if (rank < 2 * num_folded_) {
+    // Even ranks hand their value to the next rank and wait for the result.
+    if (rank % 2 == 0) {
+      TF_RETURN_IF_ERROR(Exchange(kFoldStep, rank + 1, all, -1, nullptr));
+    } else {
+      Tensor tmp = TempPrefix(all.NumElements());
+      TF_RETURN_IF_ERROR(Exchange(kFoldStep, -1, Tensor(), rank - 1, &tmp));
+      TF_RETURN_IF_ERROR(Reduce(&all, &tmp));
+      vrank = rank / 2;
+    }
+  } else {
+    vrank = rank - num_folded_;
+  }
+
+  if (vrank >= 0) {
+    switch (algorithm_) {
+      case Algorithm::kRecursiveDoubling:
+        TF_RETURN_IF_ERROR(RunRecursiveDoubling(vrank, num_vranks));
+        break;
+      case Algorithm::kRabenseifner:
+        TF_RETURN_IF_ERROR(RunRabenseifner(vrank, num_vranks));
+        break;
+    }
+  }
+
+  if (rank < 2 * num_folded_) {
+    if (rank % 2 == 0) {
+      TF_RETURN_IF_ERROR(Exchange(kUnfoldStep, -1, Tensor(), rank + 1, &all));
+    } else {
+      TF_RETURN_IF_ERROR(Exchange(kUnfoldStep, rank - 1, all, -1, nullptr));
+    }
+  }
+  return absl::OkStatus();
+}
+
+absl::Status HalvingDoublingReducer::RunRecursiveDoubling(int vrank,
+                                                          int num_vranks) {
+  Tensor all = Blocks(0, num_vranks, num_vranks);
+  Tensor tmp = TempPrefix(all.NumElements());
+  int step = 1;
+  for (int distance = 1; distance < num_vranks; distance *= 2, ++step) {
+    const int peer = GroupRank(vrank ^ distance);
+    TF_RETURN_IF_ERROR(Exchange(step, peer, all, peer, &tmp));
+    TF_RETURN_IF_ERROR(Reduce(&all, &tmp));
+  }
+  return Finalize(&all);
+}
+
+absl::Status HalvingDoublingReducer::RunRabenseifner(int vrank,
+                                                     int num_vranks) {
+  // Before the step at `distance`, this rank and its peer hold partial sums
+  // of the same 2 * distance blocks. Each keeps the half of them that is on
+  // its side, so that eventually rank `vrank` holds the sum of block `vrank`.
+  int step = 1;
+  for (int distance = num_vranks / 2; distance >= 1; distance /= 2, ++step) {
+    const int vpeer = vrank ^ distance;
+    const int keep = vrank & ~(distance - 1);
+    const int give = vpeer & ~(distance - 1);
+    Tensor kept = Blocks(keep, keep + distance, num_vranks);
+    Tensor tmp = TempPrefix(kept.NumElements());
+    TF_RETURN_IF_ERROR(Exchange(step, GroupRank(vpeer),
+                                Blocks(give, give + distance, num_vranks),
+                                GroupRank(vpeer), &tmp));
+    TF_RETURN_IF_ERROR(Reduce(&kept, &tmp));
+  }
+  Tensor own = Blocks(vrank, vrank + 1, num_vranks);
+  TF_RETURN_IF_ERROR(Finalize(&own));
+
+  // Gather the reduced blocks in the reverse order: before the step at
+  // `distance`, this rank holds the `distance` blocks starting at `mine`.
+  for (int distance = 1; distance < num_vranks; distance *= 2, ++step) {
+    const int vpeer = vrank ^ distance;
+    const int mine = vrank & ~(distance - 1);
+    const int theirs = vpeer & ~(distance - 1);
+    Tensor received = Blocks(theirs, theirs + distance, num_vranks);
+    TF_RETURN_IF_ERROR(Exchange(step, GroupRank(vpeer),
+                                Blocks(mine, mine + distance, num_vranks),
+                                GroupRank(vpeer), &received));
+  }
+  return absl::OkStatus();
+}
+
+absl::Status HalvingDoublingReducer::Exchange(int step, int send_to,
+                                              const Tensor& send,
+                                              int recv_from, Tensor* recv) {
+  const int rank = col_params_->default_rank;
+  BlockingCounter pending((send_to >= 0 ? 1 : 0) + (recv_from >= 0 ? 1 : 0));
+  mutex mu;
+  absl::Status status;
+  StatusCallback done = [&mu, &status, &pending](const absl::Status& s) {
+    {
+      mutex_lock l(mu);
+      status.Update(s);
+    }
+    pending.DecrementCount();
+  };
+  if (send_to >= 0) {
+    const CollGroupMember& peer = col_params_->group.members[send_to];
+    col_ctx_->col_exec->remote_access()->PostToPeer(
+        peer.device.name(), peer.task,
+        absl::StrCat(name_, ":", col_ctx_->exec_key, ":", step, ":", rank, ":",
+                     send_to),
+        col_ctx_->device, col_ctx_->op_ctx->op_device_context(),
+        col_ctx_->op_ctx->output_alloc_attr(0), &send,
+        col_ctx_->device_locality, col_ctx_->op_ctx->cancellation_manager(),
+        done);
+  }
+  if (recv_from >= 0) {
+    const CollGroupMember& peer = col_params_->group.members[recv_from];
+    col_ctx_->col_exec->remote_access()->RecvFromPeer(
+        peer.device.name(), peer.task, peer.is_local,
+        absl::StrCat(name_, ":", col_ctx_->exec_key, ":", step, ":", recv_from,
+                     ":", rank),
+        col_ctx_->device, col_ctx_->op_ctx->op_device_context(),
+        col_ctx_->op_ctx->output_alloc_attr(0), recv,
+        col_ctx_->device_locality, /*dev_to_dev_stream_index=*/0,
+        col_ctx_->op_ctx->cancellation_manager(), done);
+  }
+  pending.Wait();
+  mutex_lock l(mu);
+  return status;
+}
+
+absl::Status HalvingDoublingReducer::Reduce(Tensor* chunk, Tensor* tmp) {
+  if (chunk->NumElements() == 0) return absl::OkStatus();
+  return collective_util::ComputeBinOp(col_ctx_->op_ctx, col_ctx_->op_params,
+                                       col_ctx_->device, col_params_->merge_op,
+                                       chunk, tmp);
+}
+
+absl::Status HalvingDoublingReducer::Finalize(Tensor* chunk) {
+  if (col_params_->final_op == nullptr || chunk->NumElements() == 0) {
+    return absl::OkStatus();
+  }
+  Tensor group_size = ca_->Scalar(group_size_);
+  return collective_util::ComputeBinOp(col_ctx_->op_ctx, col_ctx_->op_params,
+                                       col_ctx_->device, col_params_->final_op,
+                                       chunk, &group_size);
+}
+
+Tensor HalvingDoublingReducer::Blocks(int first_block, int end_block,
+                                      int num_blocks) const {
+  const Tensor& flat = ca_->Value();
+  const int64_t total_elts = flat.NumElements();
+  const int64_t block_elts = CollectiveAdapter::AlignedChunkElts(
+      DataTypeSize(flat.dtype()), total_elts, num_blocks);
+  const int64_t start = std::min(total_elts, first_block * block_elts);
+  const int64_t end = std::min(total_elts, end_block * block_elts);
+  // Take empty slices from the front, as CollectiveAdapter does, since the
+  // offset of a trailing empty block may be past the end of the buffer.
+  return start < end ? flat.Slice(start, end) : flat.Slice(0, 0);
+}
+
+Tensor HalvingDoublingReducer::TempPrefix(int64_t num_elements) {
+  return tmp_.Slice(0, num_elements);
+}
+
+int HalvingDoublingReducer::GroupRank(int vrank) const {
+  return vrank < num_folded_ ? 2 * vrank + 1 : vrank + num_folded_;
+}
+
+namespace {
+
+class RecursiveDoublingReducer : public HalvingDoublingReducer {
+ public:
+  RecursiveDoublingReducer()
+      : HalvingDoublingReducer(Algorithm::kRecursiveDoubling,
+                               "RecursiveDoublingReduce") {}
+};
+
+class RabenseifnerReducer : public HalvingDoublingReducer {
+ public:
+  RabenseifnerReducer()
+      : HalvingDoublingReducer(Algorithm::kRabenseifner, "RabenseifnerReduce") {
+  }
+};
+
+REGISTER_COLLECTIVE(RecursiveDoublingReduce, RecursiveDoublingReducer);
+REGISTER_COLLECTIVE(RabenseifnerReduce, RabenseifnerReducer);
+
+}  // namespace
+
+}  // namespace tensorflow
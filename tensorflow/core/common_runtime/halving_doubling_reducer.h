@@ -0,0 +1,109 @@
+/* Copyright 2026 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#ifndef TENSORFLOW_CORE_COMMON_RUNTIME_HALVING_DOUBLING_REDUCER_H_
+#define TENSORFLOW_CORE_COMMON_RUNTIME_HALVING_DOUBLING_REDUCER_H_
+
+#include <cstdint>
+#include <memory>
+#include <string>
+
+#include "absl/status/status.h"
+#include "tensorflow/core/common_runtime/base_collective_executor.h"
+#include "tensorflow/core/framework/collective.h"
+#include "tensorflow/core/framework/tensor.h"
+
+namespace tensorflow {
+
+// Collective all-reduce by recursive halving and doubling. Where the ring
+// needs 2 * (group_size - 1) sequential steps, these algorithms pair up ranks
+// at distances 1, 2, 4, ... and need O(log2(group_size)) steps, which makes
+// them faster for the small tensors whose all-reduce is latency-bound.
+//
+// A group size that is not a power of two is handled by first folding the
+// first 2 * r ranks pairwise, where r is the group size minus the largest
+// power of two below it, and sending them the result at the end.
+//
+// Only CPU devices are supported.
+class HalvingDoublingReducer : public CollectiveImplementationInterface {
+ public:
+  enum class Algorithm {
+    // Every step exchanges the whole tensor with one peer and reduces it:
+    // log2(group_size) steps, each sending the whole tensor.
+    kRecursiveDoubling,
+    // Rabenseifner's algorithm: a reduce-scatter by recursive halving followed
+    // by an all-gather by recursive doubling. 2 * log2(group_size) steps that
+    // send about twice the tensor in total, as much as the ring.
+    kRabenseifner,
+  };
+
+  HalvingDoublingReducer(Algorithm algorithm, const std::string& name);
+  ~HalvingDoublingReducer() override = default;
+
+  absl::Status InitializeCollectiveParams(
+      CollectiveParams* col_params) override;
+
+  // Initializes members of CollectiveContext not yet initialized, i.e. device
+  // and device_locality.  Also saves the CollectiveContext in this object.
+  absl::Status InitializeCollectiveContext(
+      std::shared_ptr<CollectiveContext> col_ctx) override;
+
+  // Must be called in a blockable thread.
+  void Run(StatusCallback done) override;
+
+ private:
+  // Runs the all-reduce on the output, split into `num_vranks` blocks, where
+  // `num_vranks` is the largest power of two not above the group size.
+  absl::Status RunAllReduce(int num_vranks);
+
+  // Runs the all-reduce among the ranks that take part in the power-of-two
+  // exchange. `vrank` is the rank among those.
+  absl::Status RunRecursiveDoubling(int vrank, int num_vranks);
+  absl::Status RunRabenseifner(int vrank, int num_vranks);
+
+  // Sends `send` to rank `send_to` and receives `recv` from rank `recv_from`
+  // concurrently, then waits for both. Either rank may be -1 to skip the
+  // corresponding transfer. `step` must be distinct for every exchange.
+  absl::Status Exchange(int step, int send_to, const Tensor& send,
+                        int recv_from, Tensor* recv);
+
+  // Merges `tmp` into `chunk` with the merge op.
+  absl::Status Reduce(Tensor* chunk, Tensor* tmp);
+
+  // Applies the final op, if any, to `chunk`.
+  absl::Status Finalize(Tensor* chunk);
+
+  // Returns the elements [first_block, end_block) of the flattened output,
+  // which is divided into `num_blocks` aligned blocks.
+  Tensor Blocks(int first_block, int end_block, int num_blocks) const;
+
+  // Returns the first `num_elements` elements of the temporary buffer.
+  Tensor TempPrefix(int64_t num_elements);
+
+  // Maps a rank in the power-of-two exchange to a rank of the group.
+  int GroupRank(int vrank) const;
+
+  const Algorithm algorithm_;
+  const std::string name_;
+  std::shared_ptr<CollectiveContext> col_ctx_;
+  const CollectiveParams* col_params_;  // Not owned
+  int group_size_;
+  // Number of ranks that are folded into their neighbor.
+  int num_folded_;
+  std::unique_ptr<CollectiveAdapter> ca_;
+  Tensor tmp_;
+};
+
+}  // namespace tensorflow
+#endif  // TENSORFLOW_CORE_COMMON_RUNTIME_HALVING_DOUBLING_REDUCER_H_
@@ -0,0 +1,247 @@
+/* Copyright 2026 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#include "tensorflow/core/common_runtime/halving_doubling_reducer.h"
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "absl/status/status.h"
+#include "absl/strings/str_cat.h"
+#include "tensorflow/core/common_runtime/collective_test_util.h"
+#include "tensorflow/core/common_runtime/device.h"
+#include "tensorflow/core/common_runtime/process_util.h"
+#include "tensorflow/core/framework/collective.h"
+#include "tensorflow/core/framework/fake_input.h"
+#include "tensorflow/core/framework/node_def.pb.h"
+#include "tensorflow/core/framework/node_def_builder.h"
+#include "tensorflow/core/framework/op_kernel.h"
+#include "tensorflow/core/framework/tensor.h"
+#include "tensorflow/core/framework/tensor_shape.h"
+#include "tensorflow/core/framework/tensor_testutil.h"
+#include "tensorflow/core/framework/types.pb.h"
+#include "tensorflow/core/lib/core/status_test_util.h"
+#include "tensorflow/core/platform/blocking_counter.h"
+#include "tensorflow/core/platform/env.h"
+#include "tensorflow/core/platform/test.h"
+#include "tensorflow/core/platform/test_benchmark.h"
+#include "tensorflow/core/public/version.h"
+
+namespace tensorflow {
+namespace {
+
+std::unique_ptr<OpKernel> GetBinOpKernel(const std::string& op,
+                                         DataType dtype, Device* device) {
+  NodeDef node_def;
+  TF_CHECK_OK(NodeDefBuilder(absl::StrCat(op, "_node"), op)
+                  .Attr("T", dtype)
+                  .Input(FakeInput(dtype))
+                  .Input(FakeInput(dtype))
+                  .Finalize(&node_def));
+  absl::Status status;
+  std::unique_ptr<OpKernel> k = CreateOpKernel(
+      DEVICE_CPU, device, device->GetAllocator(AllocatorAttributes()),
+      node_def, TF_GRAPH_DEF_VERSION, &status);
+  TF_CHECK_OK(status);
+  return k;
+}
+
+// One member of a CPU collective group, with its own merge and final ops.
+struct Member {
+  Device* device = nullptr;
+  std::unique_ptr<OpKernel> merge_op;
+  std::unique_ptr<OpKernel> final_op;
+  Tensor tensor;
+  absl::Status status;
+};
+
+// Sets up `group_size` CPU devices, each holding a DT_DOUBLE tensor of
+// `num_elements` elements.
+std::vector<Member> CreateMembers(const CollectiveTestEnv& test_env,
+                                  int num_elements) {
+  const int group_size = test_env.num_devices_per_worker;
+  std::vector<Member> members(group_size);
+  for (int rank = 0; rank < group_size; ++rank) {
+    Member& member = members[rank];
+    TF_CHECK_OK(test_env.device_mgr->LookupDevice(
+        absl::StrCat("/job:worker/replica:0/task:0/device:CPU:", rank),
+        &member.device));
+    member.merge_op = GetBinOpKernel("Add", DT_DOUBLE, member.device);
+    member.final_op = GetBinOpKernel("Div", DT_DOUBLE, member.device);
+    member.tensor = Tensor(DT_DOUBLE, TensorShape({num_elements}));
+  }
+  return members;
+}
+
+// Runs the all-reduce `collective_name` on every member and waits for all of
+// them to finish.
+void RunAllReduce(CollectiveTestEnv* test_env,
+                  const std::string& collective_name,
+                  std::vector<Member>* members) {
+  BlockingCounter counter(members->size());
+  for (int rank = 0; rank < members->size(); ++rank) {
+    SchedClosure([test_env, &collective_name, members, rank, &counter]() {
+      Member& member = (*members)[rank];
+      auto col_params = CreateCollectiveParams(
+          *test_env, rank, collective_name, REDUCTION_COLLECTIVE, DT_DOUBLE,
+          member.tensor.shape());
+      col_params->merge_op = member.merge_op.get();
+      col_params->final_op = member.final_op.get();
+      member.status = RunCollective(test_env, col_params.get(), member.device,
+                                    &member.tensor, &member.tensor);
+      counter.DecrementCount();
+    });
+  }
+  counter.Wait();
+}
+
+class HalvingDoublingReducerTest
+    : public ::testing::TestWithParam<std::string> {
+ protected:
+  void RunTest(int group_size, int num_elements) {
+    test_env_ = CreateCollectiveTestEnv(/*num_workers=*/1,
+                                        /*num_devices_per_worker=*/group_size,
+                                        DEVICE_CPU);
+    std::vector<Member> members = CreateMembers(*test_env_, num_elements);
+    // Integer values keep the sums exact whatever the reduction order.
+    std::vector<double> expected(num_elements);
+    for (int rank = 0; rank < group_size; ++rank) {
+      for (int i = 0; i < num_elements; ++i) {
+        const double value = rank * 10 + i;
+        members[rank].tensor.flat<double>()(i) = value;
+        expected[i] += value;
+      }
+    }
+    for (double& value : expected) value /= group_size;
+
+    RunAllReduce(test_env_.get(), GetParam(), &members);
+    for (const Member& member : members) {
+      TF_EXPECT_OK(member.status);
+      test::ExpectTensorEqual<double>(test::AsTensor<double>(expected),
+                                      member.tensor);
+    }
+  }
+
+  std::unique_ptr<CollectiveTestEnv> test_env_;
+};
+
+TEST_P(HalvingDoublingReducerTest, PowerOfTwoGroup) {
+  RunTest(/*group_size=*/2, /*num_elements=*/16);
+  RunTest(/*group_size=*/4, /*num_elements=*/1001);
+  RunTest(/*group_size=*/8, /*num_elements=*/4096);
+}
+
+TEST_P(HalvingDoublingReducerTest, FoldedGroup) {
+  RunTest(/*group_size=*/3, /*num_elements=*/17);
+  RunTest(/*group_size=*/5, /*num_elements=*/1001);
+  RunTest(/*group_size=*/7, /*num_elements=*/4096);
+}
+
+TEST_P(HalvingDoublingReducerTest, FewerElementsThanRanks) {
+  RunTest(/*group_size=*/8, /*num_elements=*/1);
+  RunTest(/*group_size=*/6, /*num_elements=*/3);
+}
+
+TEST_P(HalvingDoublingReducerTest, Failure) {
+  test_env_ = CreateCollectiveTestEnv(/*num_workers=*/1,
+                                      /*num_devices_per_worker=*/5, DEVICE_CPU);
+  test_env_->remote_access->set_fail_after(3);
+  std::vector<Member> members = CreateMembers(*test_env_, 64);
+  for (Member& member : members) {
+    test::FillIota<double>(&member.tensor, 1.0);
+  }
+  RunAllReduce(test_env_.get(), GetParam(), &members);
+  // Every device terminates with the injected error.
+  for (const Member& member : members) {
+    EXPECT_NE(member.status.message().find("Deliberate failure"),
+              std::string::npos)
+        << member.status;
+  }
+}
+
+TEST_P(HalvingDoublingReducerTest, RejectsGatherCollective) {
+  test_env_ = CreateCollectiveTestEnv(/*num_workers=*/1,
+                                      /*num_devices_per_worker=*/4, DEVICE_CPU);
+  auto col_params =
+      CreateCollectiveParams(*test_env_, 0, GetParam(), GATHER_COLLECTIVE,
+                             DT_DOUBLE, TensorShape({4}));
+  CollectiveImplementationInterface* collective_impl = nullptr;
+  TF_ASSERT_OK(CollectiveRegistry::Lookup(GetParam(), &collective_impl));
+  core::ScopedUnref unref(collective_impl);
+  EXPECT_TRUE(absl::IsInvalidArgument(
+      collective_impl->InitializeCollectiveParams(col_params.get())));
+}
+
+INSTANTIATE_TEST_SUITE_P(
+    Algorithms, HalvingDoublingReducerTest,
+    ::testing::Values("RecursiveDoublingReduce", "RabenseifnerReduce"));
+
+// Compares the all-reduce algorithms for a group of `state.range(0)` CPU
+// devices and tensors of `state.range(1)` doubles.
+void RunAllReduceBenchmark(::testing::benchmark::State& state,
+                           const std::string& collective_name) {
+  const int group_size = state.range(0);
+  const int num_elements = state.range(1);
+  std::unique_ptr<CollectiveTestEnv> test_env = CreateCollectiveTestEnv(
+      /*num_workers=*/1, group_size, DEVICE_CPU);
+  std::vector<Member> members = CreateMembers(*test_env, num_elements);
+  for (Member& member : members) {
+    test::FillIota<double>(&member.tensor, 1.0);
+  }
+  for (auto s : state) {
+    RunAllReduce(test_env.get(), collective_name, &members);
+  }
+  for (const Member& member : members) {
+    TF_CHECK_OK(member.status);
+  }
+  state.SetBytesProcessed(state.iterations() * num_elements * sizeof(double));
+}
+
+void BM_RingReduce(::testing::benchmark::State& state) {
+  RunAllReduceBenchmark(state, "RingReduce");
+}
+
+void BM_RecursiveDoublingReduce(::testing::benchmark::State& state) {
+  RunAllReduceBenchmark(state, "RecursiveDoublingReduce");
+}
+
+void BM_RabenseifnerReduce(::testing::benchmark::State& state) {
+  RunAllReduceBenchmark(state, "RabenseifnerReduce");
+}
+
+BENCHMARK(BM_RingReduce)
+    ->ArgPair(4, 256)
+    ->ArgPair(4, 64 << 10)
+    ->ArgPair(8, 256)
+    ->ArgPair(8, 1 << 20)
+    ->ArgPair(16, 256)
+    ->UseRealTime();
+BENCHMARK(BM_RecursiveDoublingReduce)
+    ->ArgPair(4, 256)
+    ->ArgPair(4, 64 << 10)
+    ->ArgPair(8, 256)
+    ->ArgPair(8, 1 << 20)
+    ->ArgPair(16, 256)
+    ->UseRealTime();
+BENCHMARK(BM_RabenseifnerReduce)
+    ->ArgPair(4, 256)
+    ->ArgPair(4, 64 << 10)
+    ->ArgPair(8, 256)
+    ->ArgPair(8, 1 << 20)
+    ->ArgPair(16, 256)
+    ->UseRealTime();
+
+}  // namespace
+}  // namespace tensorflow
@@ -0,0 +1,118 @@
+/* Copyright 2026 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#include "tensorflow/core/data/autotune_replay.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <string>
+
+#include "absl/container/flat_hash_map.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/str_cat.h"
+#include "tensorflow/core/framework/cancellation.h"
+#include "tensorflow/core/framework/model.h"
+#include "tensorflow/core/framework/model.pb.h"
+#include "tensorflow/core/platform/cpu_info.h"
+#include "tensorflow/core/platform/env.h"
+#include "tensorflow/core/platform/errors.h"
+
+namespace tensorflow {
+namespace data {
+
+absl::StatusOr<AutotuneReplayResult> ReplayAutotune(
+    const model::ModelProto& model_proto, model::AutotuneAlgorithm algorithm) {
+  std::unique_ptr<model::Model> model;
+  TF_RETURN_IF_ERROR(model::Model::FromProto(model_proto, &model));
+  model->WarmStart(model_proto);
+
+  const model::ModelProto::OptimizationParams& optimization_params =
+      model_proto.optimization_params();
+  const int64_t cpu_budget = optimization_params.cpu_budget() > 0
+                                 ? optimization_params.cpu_budget()
+                                 : port::NumSchedulableCPUs();
+  const int64_t ram_budget = optimization_params.ram_budget() > 0
+                                 ? optimization_params.ram_budget()
+                                 : std::numeric_limits<int64_t>::max();
+  model::RamBudgetManager ram_budget_manager(ram_budget);
+  CancellationManager cancellation_manager;
+  model->Optimize(
+      algorithm, [cpu_budget]() { return cpu_budget; },
+      /*ram_budget_share=*/1.0, /*fixed_ram_budget=*/ram_budget,
+      optimization_params.model_input_time(), ram_budget_manager,
+      &cancellation_manager);
+
+  // The optimization applies the tuned values to the parameter states. Copies
+  // them to the parameter values, which the timing model uses.
+  AutotuneReplayResult result;
+  std::shared_ptr<model::Node> output = model->output();
+  absl::flat_hash_map<std::string, double> parallelism_by_node;
+  for (auto& [node_name, parameter] : output->CollectTunableParameters()) {
+    parameter->value = parameter->state->value;
+    result.parameters[absl::StrCat(node_name, ":", parameter->name)] =
+        parameter->value;
+    if (parameter->name == model::kParallelism) {
+      result.total_parallelism += static_cast<int64_t>(parameter->value);
+      parallelism_by_node[node_name] = parameter->value;
+    }
+  }
+  result.maximum_buffered_bytes = output->TotalMaximumBufferedBytes();
+  model::ModelTiming model_timing(output);
+  for (const auto& stage_root : model_timing.GetStageRoots()) {
+    const model::ModelTiming::NodeTiming* timing =
+        model_timing.GetTiming(stage_root.get());
+    if (timing == nullptr) {
+      continue;
+    }
+    const double processing_time_nsec =
+        timing->total_time_nsec * timing->pipeline_ratio;
+    result.processing_time_nsec =
+        std::max(result.processing_time_nsec, processing_time_nsec);
+
+    // The nodes are restored with their recorded IDs.
+    double learned_processing_time_nsec = processing_time_nsec;
+    auto node_it = model_proto.nodes().find(stage_root->id());
+    auto parallelism_it = parallelism_by_node.find(stage_root->long_name());
+    if (node_it != model_proto.nodes().end() &&
+        node_it->second.has_cost_model() &&
+        parallelism_it != parallelism_by_node.end() &&
+        parallelism_it->second > 0) {
+      model::NodeCostModel cost_model;
+      cost_model.FromProto(node_it->second.cost_model());
+      if (!cost_model.empty()) {
+        const double parallelism = parallelism_it->second;
+        learned_processing_time_nsec =
+            (cost_model.PredictCostNsec(parallelism) / parallelism +
+             timing->total_time_nsec - timing->self_time_nsec) *
+            timing->pipeline_ratio;
+      }
+    }
+    result.learned_processing_time_nsec = std::max(
+        result.learned_processing_time_nsec, learned_processing_time_nsec);
+  }
+  return result;
+}
+
+absl::StatusOr<AutotuneReplayResult> ReplayAutotuneFromFile(
+    const std::string& fname, model::AutotuneAlgorithm algorithm) {
+  model::ModelProto model_proto;
+  TF_RETURN_IF_ERROR(
+      ReadTextOrBinaryProto(Env::Default(), fname, &model_proto));
+  return ReplayAutotune(model_proto, algorithm);
+}
+
+}  // namespace data
+}  // namespace tensorflow
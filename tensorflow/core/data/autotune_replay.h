@@ -0,0 +1,65 @@
+/* Copyright 2026 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#ifndef TENSORFLOW_CORE_DATA_AUTOTUNE_REPLAY_H_
+#define TENSORFLOW_CORE_DATA_AUTOTUNE_REPLAY_H_
+
+#include <cstdint>
+#include <string>
+
+#include "absl/container/flat_hash_map.h"
+#include "absl/status/statusor.h"
+#include "tensorflow/core/framework/model.pb.h"
+
+namespace tensorflow {
+namespace data {
+
+// Result of replaying an autotuning algorithm on a recorded model.
+struct AutotuneReplayResult {
+  // Time in nanoseconds the pipeline is estimated to take to produce an
+  // element with the tuned parameters, i.e. the time of its slowest stage.
+  double processing_time_nsec = 0.0;
+  // Like `processing_time_nsec`, but predicts the time of the stages whose root
+  // has a recorded cost model (see `model::NodeCostModel`) from that model at
+  // the tuned parallelism. The other stages use the analytical estimate. This
+  // accounts for the contention between parallel calls, which the analytical
+  // estimate ignores.
+  double learned_processing_time_nsec = 0.0;
+  // Sum of the tuned `parallelism` parameters.
+  int64_t total_parallelism = 0;
+  // Number of bytes buffered by the tuned pipeline when all buffers are full.
+  double maximum_buffered_bytes = 0.0;
+  // Tuned values of the tunable parameters, keyed by
+  // "<node long name>:<parameter name>".
+  absl::flat_hash_map<std::string, double> parameters;
+};
+
+// Replays the autotuning optimization with `algorithm` offline on
+// `model_proto`, which was recorded by a running input pipeline, e.g. saved
+// through `AutotuneOptions.performance_model_path` or by `Model::Save`. The
+// optimization uses the CPU budget, RAM budget and target time recorded in the
+// optimization parameters of `model_proto`. This makes it possible to compare
+// autotuning algorithms on the same recorded workloads without running the
+// input pipelines.
+absl::StatusOr<AutotuneReplayResult> ReplayAutotune(
+    const model::ModelProto& model_proto, model::AutotuneAlgorithm algorithm);
+
+// Like `ReplayAutotune`, but reads the model from the file `fname`.
+absl::StatusOr<AutotuneReplayResult> ReplayAutotuneFromFile(
+    const std::string& fname, model::AutotuneAlgorithm algorithm);
+
+}  // namespace data
+}  // namespace tensorflow
+
+#endif  // TENSORFLOW_CORE_DATA_AUTOTUNE_REPLAY_H_
@@ -0,0 +1,147 @@
+/* Copyright 2026 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#include "tensorflow/core/data/autotune_replay.h"
+
+#include <string>
+
+#include "absl/status/status.h"
+#include "tensorflow/core/framework/model.h"
+#include "tensorflow/core/framework/model.pb.h"
+#include "tensorflow/core/lib/core/status_test_util.h"
+#include "tensorflow/core/platform/env.h"
+#include "tensorflow/core/platform/path.h"
+#include "tensorflow/core/platform/protobuf.h"
+#include "tensorflow/core/platform/status_matchers.h"
+#include "tensorflow/core/platform/test.h"
+
+namespace tensorflow {
+namespace data {
+namespace {
+
+using ::tensorflow::data::model::AutotuneAlgorithm;
+using ::tensorflow::data::model::ModelProto;
+using ::tensorflow::data::model::NodeCostModel;
+using ::testing::DoubleNear;
+using ::testing::Pair;
+using ::testing::UnorderedElementsAre;
+
+// A parallel map over a source, where the map takes 100ns per element, with a
+// target time of 10ns per element.
+constexpr char kParallelMapModel[] = R"pb(
+  nodes: {
+    key: 1
+    value: {
+      id: 1
+      name: "ParallelMapV2"
+      autotune: true
+      num_elements: 100
+      processing_time: 10000
+      node_class: ASYNC_KNOWN_RATIO
+      ratio: 1
+      inputs: 2
+      parameters: {
+        name: "parallelism"
+        value: 1
+        state_value: 1
+        min: 1
+        max: 16
+        tunable: true
+      }
+    }
+  }
+  nodes: {
+    key: 2
+    value: {
+      id: 2
+      name: "SSTable"
+      autotune: true
+      num_elements: 100
+      node_class: KNOWN_RATIO
+    }
+  }
+  output: 1
+  optimization_params: {
+    algorithm: STAGE_BASED
+    cpu_budget: 20
+    ram_budget: 1000
+    model_input_time: 10
+  }
+)pb";
+
+ModelProto ParallelMapModel() {
+  ModelProto model_proto;
+  CHECK(protobuf::TextFormat::ParseFromString(kParallelMapModel, &model_proto));
+  return model_proto;
+}
+
+TEST(AutotuneReplayTest, StageBased) {
+  TF_ASSERT_OK_AND_ASSIGN(
+      AutotuneReplayResult result,
+      ReplayAutotune(ParallelMapModel(), AutotuneAlgorithm::STAGE_BASED));
+  EXPECT_THAT(result.parameters,
+              UnorderedElementsAre(Pair("ParallelMapV2(id:1):parallelism", 10)));
+  EXPECT_EQ(result.total_parallelism, 10);
+  EXPECT_THAT(result.processing_time_nsec, DoubleNear(10, 1e-6));
+  // Without recorded cost models, both estimates agree.
+  EXPECT_THAT(result.learned_processing_time_nsec, DoubleNear(10, 1e-6));
+}
+
+TEST(AutotuneReplayTest, CompareAlgorithms) {
+  ModelProto model_proto = ParallelMapModel();
+  // The per-element cost of the map grows with its parallelism: 20ns + 80ns *
+  // p, so the learned-cost algorithm stops adding threads early.
+  NodeCostModel cost_model;
+  cost_model.AddObservation(/*parallelism=*/1, /*cost_nsec=*/100);
+  cost_model.AddObservation(/*parallelism=*/4, /*cost_nsec=*/340);
+  cost_model.ToProto(model_proto.mutable_nodes()->at(1).mutable_cost_model());
+
+  TF_ASSERT_OK_AND_ASSIGN(
+      AutotuneReplayResult stage_based,
+      ReplayAutotune(model_proto, AutotuneAlgorithm::STAGE_BASED));
+  TF_ASSERT_OK_AND_ASSIGN(
+      AutotuneReplayResult learned_cost,
+      ReplayAutotune(model_proto, AutotuneAlgorithm::LEARNED_COST));
+  EXPECT_EQ(stage_based.total_parallelism, 10);
+  EXPECT_EQ(learned_cost.total_parallelism, 5);
+  // The processing time is estimated by the analytical model.
+  EXPECT_GT(learned_cost.processing_time_nsec,
+            stage_based.processing_time_nsec);
+  // The cost model predicts (20ns + 80ns * p) / p per element.
+  EXPECT_THAT(stage_based.learned_processing_time_nsec, DoubleNear(82, 1e-6));
+  EXPECT_THAT(learned_cost.learned_processing_time_nsec,
+              DoubleNear(84, 1e-6));
+}
+
+TEST(AutotuneReplayTest, ReplayFromFile) {
+  const std::string fname =
+      io::JoinPath(testing::TmpDir(), "autotune_replay_model.pbtxt");
+  TF_ASSERT_OK(WriteTextProto(Env::Default(), fname, ParallelMapModel()));
+  TF_ASSERT_OK_AND_ASSIGN(
+      AutotuneReplayResult result,
+      ReplayAutotuneFromFile(fname, AutotuneAlgorithm::LEARNED_COST));
+  EXPECT_EQ(result.total_parallelism, 10);
+}
+
+TEST(AutotuneReplayTest, MissingFile) {
+  EXPECT_THAT(
+      ReplayAutotuneFromFile(
+          io::JoinPath(testing::TmpDir(), "missing_autotune_replay_model"),
+          AutotuneAlgorithm::STAGE_BASED),
+      absl_testing::StatusIs(absl::StatusCode::kNotFound));
+}
+
+}  // namespace
+}  // namespace data
+}  // namespace tensorflow
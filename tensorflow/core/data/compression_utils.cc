@@ -14,8 +14,10 @@ limitations under the License.
 ==============================================================================*/
 #include "tensorflow/core/data/compression_utils.h"
 
+#include <algorithm>
 #include <cstddef>
 #include <cstdint>
+#include <functional>
 #include <limits>
 #include <string>
 #include <vector>
@@ -31,9 +33,14 @@ limitations under the License.
 #include "tensorflow/core/framework/types.h"
 #include "tensorflow/core/framework/types.pb.h"
 #include "tensorflow/core/framework/variant_op_registry.h"
+#include "tensorflow/core/platform/blocking_counter.h"
+#include "tensorflow/core/platform/cpu_info.h"
+#include "tensorflow/core/platform/env.h"
+#include "tensorflow/core/platform/errors.h"
 #include "tensorflow/core/platform/snappy.h"
 #include "tensorflow/core/platform/status.h"
 #include "tensorflow/core/platform/tstring.h"
+#include "tensorflow/core/platform/threadpool.h"
 #include "tensorflow/core/platform/types.h"
 
 namespace tensorflow {
@@ -43,7 +50,37 @@ namespace {
 // Increment this when making changes to the `CompressedElement` proto. The
 // `UncompressElement` function will determine what to read according to the
 // version.
-constexpr int kCompressedElementVersion = 0;
+constexpr int kCompressedElementVersion = 1;
+// Version of elements compressed as a single frame. Elements that fit in one
+// frame are still written with this version, so that readers which predate
+// frames can read them.
+constexpr int kSingleFrameVersion = 0;
+
+// Amount of tensor data compressed in each frame. Elements larger than this
+// are split into frames that are compressed and uncompressed in parallel.
+constexpr size_t kFrameSizeBytes = 1 << 20;  // 1 MiB
+
+// Returns the thread pool shared by all (un)compressions of framed elements.
+thread::ThreadPool* CompressionThreadPool() {
+  static thread::ThreadPool* pool = new thread::ThreadPool(
+      Env::Default(), "tf_data_compression", port::MaxParallelism());
+  return pool;
+}
+
+// Runs `fn(i)` for each frame `i` in [0, `num_frames`), running the first frame
+// on the calling thread and the others on the compression thread pool.
+void ForEachFrame(size_t num_frames, const std::function<void(size_t)>& fn) {
+  if (num_frames == 0) return;
+  BlockingCounter counter(num_frames - 1);
+  for (size_t i = 1; i < num_frames; ++i) {
+    CompressionThreadPool()->Schedule([&fn, &counter, i]() {
+      fn(i);
+      counter.DecrementCount();
+    });
+  }
+  fn(0);
+  counter.Wait();
+}
 
 }  // namespace
 
@@ -64,12 +101,162 @@ class Iov {
 
   size_t NumPieces() const { return iov_.size(); }
 
+  // Splits the iovecs into frames of `frame_size` bytes (the last frame may be
+  // smaller). Iovecs that straddle two frames are split.
+  std::vector<std::vector<struct iovec>> Split(size_t frame_size) const {
+    std::vector<std::vector<struct iovec>> frames;
+    size_t frame_bytes = frame_size;
+    for (size_t i = 0; i < idx_; ++i) {
+      char* base = static_cast<char*>(iov_[i].iov_base);
+      size_t len = iov_[i].iov_len;
+      while (len > 0) {
+        if (frame_bytes == frame_size) {
+          frames.emplace_back();
+          frame_bytes = 0;
+        }
+        const size_t piece_len = std::min(len, frame_size - frame_bytes);
+        frames.back().push_back({base, piece_len});
+        frame_bytes += piece_len;
+        base += piece_len;
+        len -= piece_len;
+      }
+    }
+    return frames;
+  }
+
  private:
   std::vector<struct iovec> iov_;
   size_t idx_;
   size_t num_bytes_;
 };
 
+namespace {
+
+// Compresses the tensor data referenced by `iov` as independent frames of
+// `kFrameSizeBytes` bytes.
+absl::Status CompressFrames(const Iov& iov, CompressedElement* out) {
+  const std::vector<std::vector<struct iovec>> frames =
+      iov.Split(kFrameSizeBytes);
+  std::vector<std::string> compressed_frames(frames.size());
+  std::vector<absl::Status> statuses(frames.size());
+  ForEachFrame(frames.size(), [&](size_t i) {
+    size_t frame_bytes = 0;
+    for (const struct iovec& piece : frames[i]) {
+      frame_bytes += piece.iov_len;
+    }
+    if (!port::Snappy_CompressFromIOVec(frames[i].data(), frame_bytes,
+                                        &compressed_frames[i])) {
+      statuses[i] = absl::InternalError("Failed to compress using snappy.");
+    }
+  });
+
+  size_t compressed_size = 0;
+  for (size_t i = 0; i < frames.size(); ++i) {
+    TF_RETURN_IF_ERROR(statuses[i]);
+    compressed_size += compressed_frames[i].size();
+  }
+  std::string* data = out->mutable_data();
+  data->reserve(compressed_size);
+  for (const std::string& compressed_frame : compressed_frames) {
+    data->append(compressed_frame);
+    out->add_compressed_frame_sizes(compressed_frame.size());
+  }
+  out->set_uncompressed_frame_size(kFrameSizeBytes);
+  out->set_version(kCompressedElementVersion);
+  return absl::OkStatus();
+}
+
+// Uncompresses the single frame of `compressed` into the memory referenced by
+// `iov`.
+absl::Status UncompressSingleFrame(const CompressedElement& compressed,
+                                   Iov& iov) {
+  const std::string& compressed_data = compressed.data();
+  size_t uncompressed_size;
+  if (!port::Snappy_GetUncompressedLength(
+          compressed_data.data(), compressed_data.size(), &uncompressed_size)) {
+    return absl::InternalError(absl::StrCat(
+        "Could not get snappy uncompressed length. Compressed data size: ",
+        compressed_data.size()));
+  }
+  if (uncompressed_size != static_cast<size_t>(iov.NumBytes())) {
+    return absl::InternalError(absl::StrCat(
+        "Uncompressed size mismatch. Snappy expects ", uncompressed_size,
+        " whereas the tensor metadata suggests ", iov.NumBytes()));
+  }
+  if (!port::Snappy_UncompressToIOVec(compressed_data.data(),
+                                      compressed_data.size(), iov.Data(),
+                                      iov.NumPieces())) {
+    return absl::InternalError("Failed to perform snappy decompression.");
+  }
+  return absl::OkStatus();
+}
+
+// Uncompresses the frames of `compressed` into the memory referenced by `iov`.
+absl::Status UncompressFrames(const CompressedElement& compressed,
+                              const Iov& iov) {
+  if (compressed.uncompressed_frame_size() == 0) {
+    return absl::InternalError("Framed compressed element has no frame size.");
+  }
+  const std::vector<std::vector<struct iovec>> frames =
+      iov.Split(compressed.uncompressed_frame_size());
+  if (frames.size() != compressed.compressed_frame_sizes_size()) {
+    return absl::InternalError(absl::StrCat(
+        "Frame count mismatch. The compressed element has ",
+        compressed.compressed_frame_sizes_size(),
+        " frames whereas the tensor metadata suggests ", frames.size()));
+  }
+  const std::string& compressed_data = compressed.data();
+  std::vector<size_t> frame_offsets(frames.size());
+  size_t offset = 0;
+  for (size_t i = 0; i < frames.size(); ++i) {
+    // The frame sizes come from the serialized element, so check each one
+    // against the remaining bytes before summing them up.
+    const uint64_t frame_size = compressed.compressed_frame_sizes(i);
+    if (frame_size > compressed_data.size() - offset) {
+      return absl::InternalError(absl::StrCat(
+          "Compressed size mismatch. Frame ", i, " holds ", frame_size,
+          " bytes whereas only ", compressed_data.size() - offset,
+          " bytes of compressed data remain"));
+    }
+    frame_offsets[i] = offset;
+    offset += frame_size;
+  }
+  if (offset != compressed_data.size()) {
+    return absl::InternalError(absl::StrCat(
+        "Compressed size mismatch. The frames hold ", offset,
+        " bytes whereas the compressed data has ", compressed_data.size()));
+  }
+
+  std::vector<absl::Status> statuses(frames.size());
+  ForEachFrame(frames.size(), [&](size_t i) {
+    const char* frame_data = compressed_data.data() + frame_offsets[i];
+    const size_t frame_size = compressed.compressed_frame_sizes(i);
+    size_t frame_bytes = 0;
+    for (const struct iovec& piece : frames[i]) {
+      frame_bytes += piece.iov_len;
+    }
+    size_t uncompressed_size;
+    if (!port::Snappy_GetUncompressedLength(frame_data, frame_size,
+                                            &uncompressed_size) ||
+        uncompressed_size != frame_bytes) {
+      statuses[i] = absl::InternalError(
+          absl::StrCat("Uncompressed size mismatch in frame ", i));
+      return;
+    }
+    if (!port::Snappy_UncompressToIOVec(frame_data, frame_size,
+                                        frames[i].data(), frames[i].size())) {
+      statuses[i] =
+          absl::InternalError("Failed to perform snappy decompression.");
+    }
+  });
+  for (const absl::Status& status : statuses) {
+    TF_RETURN_IF_ERROR(status);
+  }
+  return absl::OkStatus();
+}
+
+}  // namespace
+
 absl::Status CompressElement(const std::vector<Tensor>& element,
                              CompressedElement* out) {
   // First pass: preprocess the non`memcpy`able tensors.
@@ -134,11 +321,15 @@ absl::Status CompressElement(const std::vector<Tensor>& element,
         absl::StrCat("Encountered dataset element of size ", iov.NumBytes(),
                      ", exceeding the 4GB Snappy limit."));
   }
-  if (!port::Snappy_CompressFromIOVec(iov.Data(), iov.NumBytes(),
-                                      out->mutable_data())) {
-    return absl::InternalError("Failed to compress using snappy.");
+  if (iov.NumBytes() > kFrameSizeBytes) {
+    TF_RETURN_IF_ERROR(CompressFrames(iov, out));
+  } else {
+    if (!port::Snappy_CompressFromIOVec(iov.Data(), iov.NumBytes(),
+                                        out->mutable_data())) {
+      return absl::InternalError("Failed to compress using snappy.");
+    }
+    out->set_version(kSingleFrameVersion);
   }
-  out->set_version(kCompressedElementVersion);
   VLOG(3) << "Compressed element from " << iov.NumBytes() << " bytes to "
           << out->data().size() << " bytes";
   return absl::OkStatus();
@@ -146,7 +337,8 @@ absl::Status CompressElement(const std::vector<Tensor>& element,
 
 absl::Status UncompressElement(const CompressedElement& compressed,
                                std::vector<Tensor>* out) {
-  if (compressed.version() != kCompressedElementVersion) {
+  if (compressed.version() != kSingleFrameVersion &&
+      compressed.version() != kCompressedElementVersion) {
     return absl::InternalError(absl::StrCat(
         "Unsupported compressed element version: ", compressed.version()));
   }
@@ -224,23 +416,10 @@ absl::Status UncompressElement(const CompressedElement& compressed,
   }
 
   // Step 2: Uncompress into the iovec.
-  const std::string& compressed_data = compressed.data();
-  size_t uncompressed_size;
-  if (!port::Snappy_GetUncompressedLength(
-          compressed_data.data(), compressed_data.size(), &uncompressed_size)) {
-    return absl::InternalError(absl::StrCat(
-        "Could not get snappy uncompressed length. Compressed data size: ",
-        compressed_data.size()));
-  }
-  if (uncompressed_size != static_cast<size_t>(iov.NumBytes())) {
-    return absl::InternalError(absl::StrCat(
-        "Uncompressed size mismatch. Snappy expects ", uncompressed_size,
-        " whereas the tensor metadata suggests ", iov.NumBytes()));
-  }
-  if (!port::Snappy_UncompressToIOVec(compressed_data.data(),
-                                      compressed_data.size(), iov.Data(),
-                                      iov.NumPieces())) {
-    return absl::InternalError("Failed to perform snappy decompression.");
+  if (compressed.version() != kSingleFrameVersion) {
+    TF_RETURN_IF_ERROR(UncompressFrames(compressed, iov));
+  } else {
+    TF_RETURN_IF_ERROR(UncompressSingleFrame(compressed, iov));
   }
 
   // Third pass: deserialize nonstring, non`memcpy`able tensors.
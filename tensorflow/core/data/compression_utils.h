@@ -28,7 +28,9 @@ namespace data {
 // Compresses the components of `element` into the `CompressedElement` proto.
 //
 // In addition to writing the actual compressed bytes, `Compress` fills
-// out the per-component metadata for the `CompressedElement`.
+// out the per-component metadata for the `CompressedElement`. Elements larger
+// than 1 MiB are split into frames that are compressed in parallel on a thread
+// pool shared by all calls.
 //
 // Returns an error if the uncompressed size of the element exceeds 4GB.
 absl::Status CompressElement(const std::vector<Tensor>& element,
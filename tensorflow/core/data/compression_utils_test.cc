@@ -15,6 +15,8 @@ limitations under the License.
 #include "tensorflow/core/data/compression_utils.h"
 
 #include <cstdint>
+#include <limits>
+#include <string>
 #include <vector>
 
 #include <gmock/gmock.h>
@@ -112,6 +114,64 @@ TEST_P(ParameterizedCompressionUtilsTest, VersionMismatch) {
 INSTANTIATE_TEST_SUITE_P(Instantiation, ParameterizedCompressionUtilsTest,
                          ::testing::ValuesIn(TestCases()));
 
+std::vector<Tensor> LargeElement() {
+  std::vector<tstring> strings(300);
+  for (int i = 0; i < strings.size(); ++i) {
+    strings[i] = std::string(i * 10, 'a' + i % 26);
+  }
+  return {CreateTensor<int64_t>(TensorShape{512, 1024}),
+          CreateTensor<tstring>(TensorShape{300}, strings),
+          CreateTensor<int64_t>(TensorShape{2}, {1, 2})};
+}
+
+TEST(CompressionUtilsTest, FramedRoundTrip) {
+  std::vector<Tensor> element = LargeElement();
+  CompressedElement compressed;
+  TF_ASSERT_OK(CompressElement(element, &compressed));
+  // 4 MiB of int64s and about 450 KB of strings.
+  EXPECT_EQ(compressed.version(), 1);
+  EXPECT_EQ(compressed.compressed_frame_sizes_size(), 5);
+
+  std::vector<Tensor> round_trip_element;
+  TF_ASSERT_OK(UncompressElement(compressed, &round_trip_element));
+  TF_EXPECT_OK(
+      ExpectEqual(element, round_trip_element, /*compare_order=*/true));
+}
+
+TEST(CompressionUtilsTest, FramedSizeMismatch) {
+  CompressedElement compressed;
+  TF_ASSERT_OK(CompressElement(LargeElement(), &compressed));
+  compressed.mutable_data()->resize(compressed.data().size() - 1);
+  std::vector<Tensor> round_trip_element;
+  EXPECT_THAT(UncompressElement(compressed, &round_trip_element),
+              absl_testing::StatusIs(error::INTERNAL,
+                                     HasSubstr("Compressed size mismatch")));
+
+  CompressedElement wrong_frame_size;
+  TF_ASSERT_OK(CompressElement(LargeElement(), &wrong_frame_size));
+  wrong_frame_size.set_uncompressed_frame_size(
+      wrong_frame_size.uncompressed_frame_size() / 2);
+  EXPECT_THAT(UncompressElement(wrong_frame_size, &round_trip_element),
+              absl_testing::StatusIs(error::INTERNAL,
+                                     HasSubstr("Frame count mismatch")));
+}
+
+TEST(CompressionUtilsTest, FramedSizeOverflow) {
+  CompressedElement compressed;
+  TF_ASSERT_OK(CompressElement(LargeElement(), &compressed));
+  ASSERT_GE(compressed.compressed_frame_sizes_size(), 2);
+  // Frame sizes that wrap around to the size of the compressed data.
+  const uint64_t first = compressed.compressed_frame_sizes(0);
+  compressed.set_compressed_frame_sizes(0,
+                                        std::numeric_limits<uint64_t>::max());
+  compressed.set_compressed_frame_sizes(
+      1, compressed.compressed_frame_sizes(1) + first + 1);
+  std::vector<Tensor> round_trip_element;
+  EXPECT_THAT(UncompressElement(compressed, &round_trip_element),
+              absl_testing::StatusIs(error::INTERNAL,
+                                     HasSubstr("Compressed size mismatch")));
+}
+
 }  // namespace
 }  // namespace data
 }  // namespace tensorflow
@@ -679,6 +679,7 @@ GetOptimizationsTestCase GetOptimizationTestCase4() {
   options.mutable_optimization_options()->set_map_and_filter_fusion(true);
   options.mutable_optimization_options()->set_map_fusion(true);
   options.mutable_optimization_options()->set_map_parallelization(true);
+  options.mutable_optimization_options()->set_map_vectorization(true);
   options.mutable_optimization_options()->set_noop_elimination(true);
   options.mutable_optimization_options()->set_parallel_batch(true);
   options.mutable_optimization_options()->set_shuffle_and_repeat_fusion(true);
@@ -689,9 +690,9 @@ GetOptimizationsTestCase GetOptimizationTestCase4() {
           /*expected_enabled=*/
           {"filter_fusion", "filter_parallelization", "make_sloppy",
            "map_and_batch_fusion", "map_and_filter_fusion", "map_fusion",
-           "map_parallelization", "noop_elimination", "parallel_batch",
-           "shuffle_and_repeat_fusion", "slack", "inject_prefetch",
-           "seq_interleave_prefetch"},
+           "map_parallelization", "map_vectorization", "noop_elimination",
+           "parallel_batch", "shuffle_and_repeat_fusion", "slack",
+           "inject_prefetch", "seq_interleave_prefetch"},
           /*expected_disabled=*/{},
           /*expected_default=*/{}};
 }
@@ -94,6 +94,8 @@ void SetRootDatasetParams(const Options& options, RootDataset::Params* params) {
   }
   params->autotune_ram_budget_from_options =
       options.autotune_options().ram_budget();
+  params->autotune_performance_model_path =
+      options.autotune_options().performance_model_path();
   double ram_budget_share;
   if (experiments.contains("autotune_buffer_optimization")) {
     // When running this experiment, increase the ram_budget since it already
@@ -356,6 +358,15 @@ class RootDataset::Iterator : public DatasetIterator<RootDataset> {
           // Dynamic RAM budget should only apply to tf.data service.
           raw_ram_budget = params.ComputeInitialAutotuneRamBudget();
         }
+        if (!params.autotune_performance_model_path.empty()) {
+          absl::Status status = model_->EnableWarmStart(
+              params.autotune_performance_model_path);
+          if (!status.ok()) {
+            LOG(WARNING) << "Failed to warm-start autotuning from "
+                         << params.autotune_performance_model_path << ": "
+                         << status;
+          }
+        }
         absl::Status status = model_->OptimizeLoop(
             params.autotune_algorithm, params.autotune_cpu_budget_func,
             params.ram_budget_share, raw_ram_budget, *ram_budget_manager_,
@@ -18,6 +18,7 @@ limitations under the License.
 #include <cstdint>
 #include <functional>
 #include <memory>
+#include <string>
 #include <vector>
 
 #include "absl/status/status.h"
@@ -40,6 +41,9 @@ class RootDataset : public DatasetBase {
     std::function<int64_t()> autotune_cpu_budget_func;
     double ram_budget_share;
     int64_t autotune_ram_budget_from_options;
+    // File the autotuning performance model is warm-started from and saved to.
+    // Empty if warm-starting is disabled.
+    std::string autotune_performance_model_path;
     int64_t max_intra_op_parallelism = 1;
     int64_t private_threadpool_size = 0;
 
@@ -45,6 +45,7 @@ limitations under the License.
 #include "tensorflow/core/data/service/dispatcher.pb.h"
 #include "tensorflow/core/data/service/dispatcher_client.h"
 #include "tensorflow/core/data/service/grpc_util.h"
+#include "tensorflow/core/data/service/shared_memory_data_transfer.h"
 #include "tensorflow/core/data/service/worker.pb.h"
 #include "tensorflow/core/data/service/worker_client.h"
 #include "tensorflow/core/data/service/worker_impl.h"
@@ -429,6 +430,14 @@ DataServiceClient::CreateWorkerClient(const TaskInfo& task_info) {
         default_protocol, error::Code::NOT_FOUND,
         "Failed to find transfer server for default protocol");
   }
+  // Workers on the same host can hand elements over in shared memory.
+  if (absl::StatusOr<DataTransferServerInfo> transfer_server =
+          GetTransferServer(kSharedMemoryTransferProtocol, task_info);
+      transfer_server.ok() && IsSharedMemoryTransferServerOnThisHost(
+                                  transfer_server->compatibility_info())) {
+    return CreateAlternativeWorkerClientMaybeWithGrpcFallback(*transfer_server,
+                                                              task_info);
+  }
   return CreateGrpcWorkerClient(task_info);
 }
 
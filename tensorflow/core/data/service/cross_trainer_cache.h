@@ -18,19 +18,26 @@ limitations under the License.
 #include <cstddef>
 #include <deque>
 #include <functional>
+#include <iterator>
 #include <limits>
+#include <map>
 #include <memory>
+#include <optional>
 #include <string>
 #include <utility>
 
 #include "absl/container/flat_hash_map.h"
+#include "absl/strings/string_view.h"
 #include "tensorflow/core/data/service/byte_size.h"
+#include "tensorflow/core/data/service/cross_trainer_cache_disk_tier.h"
 #include "tensorflow/core/framework/metrics.h"
+#include "tensorflow/core/platform/env.h"
 #include "tensorflow/core/platform/errors.h"
 #include "tensorflow/core/platform/mutex.h"
 #include "tensorflow/core/platform/status.h"
 #include "tensorflow/core/platform/statusor.h"
 #include "tensorflow/core/platform/thread_annotations.h"
+#include "tensorflow/core/platform/threadpool.h"
 
 namespace tensorflow {
 namespace data {
@@ -46,6 +53,12 @@ namespace data {
 // collected when the cache becomes full. Consequently, trainers read from a
 // sliding window through the dataset and may not read the full dataset.
 //
+// Optionally, elements collected from memory are spilled to a
+// `CrossTrainerCacheDiskTier` in the background. Trainers that fall behind the
+// in-memory window then keep reading the shared sequence from disk, with
+// elements prefetched back into memory ahead of them. This requires the
+// `CachableSequence` to implement `SerializeElement` and `DeserializeElement`.
+//
 // The `CrossTrainerCache` class is thread-safe.
 //
 // Example usage:
@@ -87,8 +100,23 @@ class CachableSequence {
   // Returns the next element to be cached.
   virtual StatusOr<ElementType> GetNext() = 0;
 
-  // Returns the estimated size of the element in bytes.
+  // Returns the estimated size of the element in bytes. If the cache has a disk
+  // tier, may be called concurrently with the other methods.
   virtual size_t GetElementSizeBytes(const ElementType&) const = 0;
+
+  // Serializes the element for the disk tier of the cache. Only called if the
+  // cache has a disk tier. May be called concurrently with the other methods.
+  virtual StatusOr<std::string> SerializeElement(const ElementType&) const {
+    return absl::UnimplementedError(
+        "This sequence does not support spilling to disk.");
+  }
+
+  // Parses an element serialized by `SerializeElement`. May be called
+  // concurrently with the other methods.
+  virtual StatusOr<ElementType> DeserializeElement(absl::string_view) const {
+    return absl::UnimplementedError(
+        "This sequence does not support spilling to disk.");
+  }
 };
 
 // Sliding-window cache shared across concurrent trainers.
@@ -101,6 +129,19 @@ class CrossTrainerCache {
   explicit CrossTrainerCache(
       size_t max_cache_size_bytes,
       std::unique_ptr<CachableSequence<ElementType>> cachable_sequence);
+
+  // Creates a `CrossTrainerCache` which spills elements collected from memory
+  // to `disk_tier` in the background. Up to `max_cache_size_bytes` of elements
+  // wait to be spilled; beyond that, extending the cache waits for spilling.
+  // When a trainer reads from `disk_tier`, up to `num_prefetch_elements`
+  // following elements are read back into memory in the background. Elements
+  // waiting to be spilled and prefetched elements are not counted towards
+  // `max_cache_size_bytes`.
+  CrossTrainerCache(
+      size_t max_cache_size_bytes,
+      std::unique_ptr<CachableSequence<ElementType>> cachable_sequence,
+      std::unique_ptr<CrossTrainerCacheDiskTier> disk_tier,
+      size_t num_prefetch_elements);
   virtual ~CrossTrainerCache() = default;
   CrossTrainerCache(const CrossTrainerCache&) = delete;
   CrossTrainerCache& operator=(const CrossTrainerCache&) = delete;
@@ -138,7 +179,12 @@ class CrossTrainerCache {
   // the cached elements).
   size_t GetElementIndex(const std::string& trainer_id);
 
-  // Returns the next element for `trainer_id`.
+  // Returns the absolute index of the oldest element that can be read, either
+  // from memory or from the disk tier.
+  size_t GetOldestElementIndex();
+
+  // Returns the next element for `trainer_id` if it is in memory, or nullptr
+  // if it needs to be read from the disk tier.
   StatusOr<std::shared_ptr<const ElementType>> GetElement(
       const std::string& trainer_id);
 
@@ -149,6 +195,21 @@ class CrossTrainerCache {
   // `new_element_size_bytes` is the size of the new element being inserted.
   void FreeSpace(size_t new_element_size_bytes);
 
+  // Schedules writing the elements collected from memory to the disk tier, if
+  // it is not scheduled already.
+  void ScheduleSpill();
+
+  // Writes the elements collected from memory to the disk tier. Runs on
+  // `disk_tier_thread_pool_`.
+  void SpillElements();
+
+  // Reads the element with absolute index `element_index` from the disk tier.
+  StatusOr<std::shared_ptr<const ElementType>> ReadFromDiskTier(
+      size_t element_index);
+
+  // Prefetches the elements following `element_index` from the disk tier.
+  void SchedulePrefetch(size_t element_index);
+
   // Records the cache hit rate and cache size.
   void RecordMetrics(const CacheQueryResult& result);
 
@@ -158,6 +219,10 @@ class CrossTrainerCache {
   // The element sequence over which the sliding window cache operates.
   std::unique_ptr<CachableSequence<ElementType>> cachable_sequence_;
 
+  // Holds the elements collected from memory, if set.
+  const std::unique_ptr<CrossTrainerCacheDiskTier> disk_tier_;
+  const size_t num_prefetch_elements_;
+
   mutable mutex mu_;
   mutable condition_variable cv_;
 
@@ -178,18 +243,54 @@ class CrossTrainerCache {
   // `trainer_to_element_index_map_[trainer_id] - cache_start_index_`.
   absl::flat_hash_map<std::string, size_t> trainer_to_element_index_map_
       TF_GUARDED_BY(mu_);
+
+  // Elements collected from memory which are being written to the disk tier.
+  // They precede `cache_` and can still be read.
+  std::deque<std::shared_ptr<const ElementType>> spilling_ TF_GUARDED_BY(mu_);
+  size_t spilling_size_bytes_ TF_GUARDED_BY(mu_) = 0;
+
+  // True if `SpillElements` is scheduled or running.
+  bool spill_scheduled_ TF_GUARDED_BY(mu_) = false;
+
+  // Elements prefetched from the disk tier, keyed by absolute index. A null
+  // element is being read.
+  std::map<size_t, std::shared_ptr<const ElementType>> prefetched_
+      TF_GUARDED_BY(mu_);
+
+  // Writes elements to and prefetches elements from the disk tier in the
+  // background. Destroyed first, so that pending writes and reads finish
+  // before the other members are destroyed.
+  std::unique_ptr<thread::ThreadPool> disk_tier_thread_pool_;
 };
 
 template <class ElementType>
 CrossTrainerCache<ElementType>::CrossTrainerCache(
     size_t max_cache_size_bytes,
     std::unique_ptr<CachableSequence<ElementType>> cachable_sequence)
+    : CrossTrainerCache(max_cache_size_bytes, std::move(cachable_sequence),
+                        /*disk_tier=*/nullptr, /*num_prefetch_elements=*/0) {}
+
+template <class ElementType>
+CrossTrainerCache<ElementType>::CrossTrainerCache(
+    size_t max_cache_size_bytes,
+    std::unique_ptr<CachableSequence<ElementType>> cachable_sequence,
+    std::unique_ptr<CrossTrainerCacheDiskTier> disk_tier,
+    size_t num_prefetch_elements)
     : max_cache_size_bytes_(max_cache_size_bytes),
-      cachable_sequence_(std::move(cachable_sequence)) {
+      cachable_sequence_(std::move(cachable_sequence)),
+      disk_tier_(std::move(disk_tier)),
+      num_prefetch_elements_(disk_tier_ != nullptr ? num_prefetch_elements
+                                                   : 0) {
   DCHECK_GT(max_cache_size_bytes, 0)
       << "CrossTrainerCache size must be greater than 0.";
+  if (disk_tier_ != nullptr) {
+    disk_tier_thread_pool_ = std::make_unique<thread::ThreadPool>(
+        Env::Default(), "cross_trainer_cache_disk_tier",
+        /*num_threads=*/1);
+  }
   VLOG(2) << "Initialized tf.data service cross-trainer cache with "
-          << ByteSize::Bytes(max_cache_size_bytes) << " of memory.";
+          << ByteSize::Bytes(max_cache_size_bytes) << " of memory"
+          << (disk_tier_ != nullptr ? " and a disk tier." : ".");
 }
 
 template <class ElementType>
@@ -212,20 +313,26 @@ CrossTrainerCache<ElementType>::GetCacheQueryResult(
     const std::string& trainer_id) {
   bool should_extend_cache = false;
   while (true) {
+    std::optional<size_t> disk_element_index;
     {
       mutex_lock l(mu_);
       TF_RETURN_IF_ERROR(status_);
       if (IsElementReady(trainer_id)) {
         TF_ASSIGN_OR_RETURN(std::shared_ptr<const ElementType> element,
                             GetElement(trainer_id));
-        return CacheQueryResult{element,
-                                /*is_cache_hit=*/!should_extend_cache};
-      }
-
-      // Extends the cache or waits for another thread to extend the cache. When
-      // concurrent trainers wait for the next element, only one of them should
-      // extend the cache.
-      if (extending_cache_) {
+        if (element != nullptr) {
+          return CacheQueryResult{element,
+                                  /*is_cache_hit=*/!should_extend_cache};
+        }
+        // The element was collected from memory and is read from the disk
+        // tier without holding the lock.
+        should_extend_cache = false;
+        disk_element_index = GetElementIndex(trainer_id);
+        SchedulePrefetch(*disk_element_index);
+      } else if (extending_cache_) {
+        // Extends the cache or waits for another thread to extend the cache.
+        // When concurrent trainers wait for the next element, only one of them
+        // should extend the cache.
         should_extend_cache = false;
         cv_.wait(l);
       } else {
@@ -234,6 +341,21 @@ CrossTrainerCache<ElementType>::GetCacheQueryResult(
       }
     }
 
+    if (disk_element_index.has_value()) {
+      StatusOr<std::shared_ptr<const ElementType>> element =
+          ReadFromDiskTier(*disk_element_index);
+      if (absl::IsNotFound(element.status())) {
+        // The element was deleted from the disk tier in the meantime. Retries
+        // from the oldest element.
+        continue;
+      }
+      TF_RETURN_IF_ERROR(element.status());
+      mutex_lock l(mu_);
+      TF_RETURN_IF_ERROR(status_);
+      trainer_to_element_index_map_[trainer_id] = *disk_element_index + 1;
+      return CacheQueryResult{*element, /*is_cache_hit=*/true};
+    }
+
     if (should_extend_cache) {
       absl::Status s = ExtendCache();
       mutex_lock l(mu_);
@@ -261,8 +383,19 @@ CrossTrainerCache<ElementType>::GetElement(const std::string& trainer_id)
         element_index));
   }
 
-  std::shared_ptr<const ElementType> result =
-      cache_[element_index - cache_start_index_];
+  std::shared_ptr<const ElementType> result;
+  const size_t spilling_start_index = cache_start_index_ - spilling_.size();
+  if (element_index >= cache_start_index_) {
+    result = cache_[element_index - cache_start_index_];
+  } else if (element_index >= spilling_start_index) {
+    result = spilling_[element_index - spilling_start_index];
+  } else if (auto it = prefetched_.find(element_index);
+             it != prefetched_.end() && it->second != nullptr) {
+    result = it->second;
+    SchedulePrefetch(element_index);
+  } else {
+    return std::shared_ptr<const ElementType>();
+  }
   trainer_to_element_index_map_[trainer_id] = element_index + 1;
   return result;
 }
@@ -271,12 +404,31 @@ template <class ElementType>
 size_t CrossTrainerCache<ElementType>::GetElementIndex(
     const std::string& trainer_id) TF_EXCLUSIVE_LOCKS_REQUIRED(mu_) {
   size_t element_index = trainer_to_element_index_map_[trainer_id];
-  if (element_index < cache_start_index_) {
-    element_index = cache_start_index_;
+  const size_t oldest_element_index = GetOldestElementIndex();
+  if (element_index < oldest_element_index) {
+    element_index = oldest_element_index;
   }
   return element_index;
 }
 
+template <class ElementType>
+size_t CrossTrainerCache<ElementType>::GetOldestElementIndex()
+    TF_EXCLUSIVE_LOCKS_REQUIRED(mu_) {
+  size_t oldest_element_index = cache_start_index_ - spilling_.size();
+  if (disk_tier_ == nullptr) {
+    return oldest_element_index;
+  }
+  // The disk tier is only used if it joins up with the elements in memory. It
+  // does not if writing an element to disk failed.
+  const size_t disk_start_index = disk_tier_->start_index();
+  const size_t disk_end_index = disk_tier_->end_index();
+  if (disk_start_index < oldest_element_index &&
+      disk_end_index >= oldest_element_index) {
+    oldest_element_index = disk_start_index;
+  }
+  return oldest_element_index;
+}
+
 template <class ElementType>
 absl::Status CrossTrainerCache<ElementType>::ExtendCache()
     TF_LOCKS_EXCLUDED(mu_) {
@@ -291,10 +443,16 @@ absl::Status CrossTrainerCache<ElementType>::ExtendCache()
   }
 
   mutex_lock l(mu_);
+  // Bounds the memory held by elements waiting to be spilled.
+  while (status_.ok() && spilling_size_bytes_ > max_cache_size_bytes_) {
+    cv_.wait(l);
+  }
   TF_RETURN_IF_ERROR(status_);
   FreeSpace(new_element_size_bytes);
   cache_.push_back(std::make_shared<ElementType>(std::move(element)));
   cache_size_bytes_ += new_element_size_bytes;
+  ScheduleSpill();
+  cv_.notify_all();
   return absl::OkStatus();
 }
 
@@ -306,6 +464,10 @@ void CrossTrainerCache<ElementType>::FreeSpace(size_t new_element_size_bytes)
          cache_size_bytes_ + new_element_size_bytes > max_cache_size_bytes_) {
     size_t free_bytes =
         cachable_sequence_->GetElementSizeBytes(*cache_.front());
+    if (disk_tier_ != nullptr) {
+      spilling_.push_back(std::move(cache_.front()));
+      spilling_size_bytes_ += free_bytes;
+    }
     cache_.pop_front();
     cache_size_bytes_ -= free_bytes;
     ++cache_start_index_;
@@ -317,6 +479,106 @@ void CrossTrainerCache<ElementType>::FreeSpace(size_t new_element_size_bytes)
           << ByteSize::Bytes(cache_size_bytes_) << ".";
 }
 
+template <class ElementType>
+void CrossTrainerCache<ElementType>::ScheduleSpill()
+    TF_EXCLUSIVE_LOCKS_REQUIRED(mu_) {
+  if (spilling_.empty() || spill_scheduled_) {
+    return;
+  }
+  spill_scheduled_ = true;
+  disk_tier_thread_pool_->Schedule([this]() { SpillElements(); });
+}
+
+template <class ElementType>
+void CrossTrainerCache<ElementType>::SpillElements() TF_LOCKS_EXCLUDED(mu_) {
+  // Only one `SpillElements` runs at a time, and only it removes elements from
+  // `spilling_`.
+  while (true) {
+    std::shared_ptr<const ElementType> element;
+    size_t element_index = 0;
+    {
+      mutex_lock l(mu_);
+      if (spilling_.empty() || !status_.ok()) {
+        spilling_.clear();
+        spilling_size_bytes_ = 0;
+        spill_scheduled_ = false;
+        cv_.notify_all();
+        return;
+      }
+      element = spilling_.front();
+      element_index = cache_start_index_ - spilling_.size();
+    }
+
+    StatusOr<std::string> serialized =
+        cachable_sequence_->SerializeElement(*element);
+    absl::Status s = serialized.status();
+    if (s.ok()) {
+      s = disk_tier_->Append(element_index, *serialized);
+    }
+    if (!s.ok()) {
+      LOG_EVERY_N_SEC(WARNING, 60)
+          << "Failed to spill element " << element_index
+          << " of the tf.data service cross-trainer cache to disk: " << s;
+    }
+
+    mutex_lock l(mu_);
+    spilling_size_bytes_ -= cachable_sequence_->GetElementSizeBytes(*element);
+    spilling_.pop_front();
+    cv_.notify_all();
+  }
+}
+
+template <class ElementType>
+StatusOr<std::shared_ptr<const ElementType>>
+CrossTrainerCache<ElementType>::ReadFromDiskTier(size_t element_index)
+    TF_LOCKS_EXCLUDED(mu_) {
+  TF_ASSIGN_OR_RETURN(std::string serialized, disk_tier_->Read(element_index));
+  TF_ASSIGN_OR_RETURN(ElementType element,
+                      cachable_sequence_->DeserializeElement(serialized));
+  return std::make_shared<const ElementType>(std::move(element));
+}
+
+template <class ElementType>
+void CrossTrainerCache<ElementType>::SchedulePrefetch(size_t element_index)
+    TF_EXCLUSIVE_LOCKS_REQUIRED(mu_) {
+  if (num_prefetch_elements_ == 0) {
+    return;
+  }
+  // Elements from `spilling_start_index` on are in memory.
+  const size_t spilling_start_index = cache_start_index_ - spilling_.size();
+  for (size_t i = element_index + 1;
+       i <= element_index + num_prefetch_elements_ && i < spilling_start_index;
+       ++i) {
+    if (!prefetched_.emplace(i, nullptr).second) {
+      continue;
+    }
+    disk_tier_thread_pool_->Schedule([this, i]() {
+      StatusOr<std::shared_ptr<const ElementType>> element =
+          ReadFromDiskTier(i);
+      mutex_lock l(mu_);
+      auto it = prefetched_.find(i);
+      if (it == prefetched_.end()) {
+        return;
+      }
+      if (element.ok()) {
+        it->second = *std::move(element);
+      } else {
+        prefetched_.erase(it);
+      }
+    });
+  }
+
+  // Drops the oldest prefetched elements, which have been read by the trainers
+  // furthest behind.
+  const size_t oldest_element_index = GetOldestElementIndex();
+  for (auto it = prefetched_.begin();
+       it != prefetched_.end() &&
+       (it->first < oldest_element_index ||
+        prefetched_.size() > 2 * num_prefetch_elements_);) {
+    it = it->second != nullptr ? prefetched_.erase(it) : std::next(it);
+  }
+}
+
 template <class ElementType>
 void CrossTrainerCache<ElementType>::Cancel(absl::Status status)
     TF_LOCKS_EXCLUDED(mu_) {
@@ -0,0 +1,241 @@
+/* Copyright 2026 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#include "tensorflow/core/data/service/cross_trainer_cache_disk_tier.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <utility>
+
+#include "absl/memory/memory.h"
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/string_view.h"
+#include "tensorflow/core/data/service/byte_size.h"
+#include "tensorflow/core/lib/core/coding.h"
+#include "tensorflow/core/platform/env.h"
+#include "tensorflow/core/platform/errors.h"
+#include "tensorflow/core/platform/mutex.h"
+#include "tensorflow/core/platform/path.h"
+#include "tensorflow/core/platform/random.h"
+
+namespace tensorflow {
+namespace data {
+namespace {
+
+// Number of files the tier is split into. The tier frees space by deleting
+// whole files, so a larger number frees space in smaller steps.
+constexpr size_t kNumFiles = 8;
+
+}  // namespace
+
+absl::StatusOr<std::unique_ptr<CrossTrainerCacheDiskTier>>
+CrossTrainerCacheDiskTier::Create(Env* env, const std::string& directory,
+                                  size_t max_size_bytes) {
+  if (max_size_bytes == 0) {
+    return absl::InvalidArgumentError(
+        "tf.data service cross-trainer cache disk tier requires a positive "
+        "size.");
+  }
+  TF_RETURN_IF_ERROR(env->RecursivelyCreateDir(directory));
+  std::string file_prefix = io::JoinPath(
+      directory, absl::StrCat("cross_trainer_cache_", env->GetProcessId(), "_",
+                              random::New64()));
+  auto disk_tier = absl::WrapUnique(new CrossTrainerCacheDiskTier(
+      env, std::move(file_prefix), max_size_bytes));
+  VLOG(2) << "Initialized tf.data service cross-trainer cache disk tier at "
+          << disk_tier->file_prefix_ << " with "
+          << ByteSize::Bytes(max_size_bytes) << " of disk.";
+  return disk_tier;
+}
+
+CrossTrainerCacheDiskTier::CrossTrainerCacheDiskTier(Env* env,
+                                                     std::string file_prefix,
+                                                     size_t max_size_bytes)
+    : env_(env),
+      file_prefix_(std::move(file_prefix)),
+      max_size_bytes_(max_size_bytes),
+      max_file_size_bytes_(std::max<size_t>(max_size_bytes / kNumFiles, 1)) {}
+
+CrossTrainerCacheDiskTier::~CrossTrainerCacheDiskTier() {
+  mutex_lock l(mu_);
+  if (writer_ != nullptr) {
+    writer_->Close().IgnoreError();
+  }
+  while (!files_.empty()) {
+    DeleteOldestFile();
+  }
+}
+
+absl::Status CrossTrainerCacheDiskTier::Append(size_t index,
+                                               absl::string_view data) {
+  std::string header;
+  core::PutVarint64(&header, data.size());
+
+  mutex_lock l(mu_);
+  if (index != start_index_ + records_.size()) {
+    VLOG(3) << "Discarding tf.data service cross-trainer cache disk tier "
+            << "elements [" << start_index_ << ", "
+            << start_index_ + records_.size() << ") before appending element "
+            << index << ".";
+    while (!files_.empty()) {
+      DeleteOldestFile();
+    }
+    writer_.reset();
+    start_index_ = index;
+  }
+  if (writer_ == nullptr || files_.back()->size_bytes >= max_file_size_bytes_) {
+    TF_RETURN_IF_ERROR(StartFile(index));
+  }
+
+  File& file = *files_.back();
+  absl::Status s = writer_->Append(header);
+  if (s.ok()) s = writer_->Append(data);
+  if (!s.ok()) {
+    // The file may end with a partial record, so the next element starts a new
+    // file. Closing it flushes the records appended before.
+    writer_->Close().IgnoreError();
+    writer_.reset();
+    file.flushed_size_bytes = file.size_bytes;
+    return s;
+  }
+  records_.push_back(
+      Record{files_.back(), file.size_bytes + header.size(), data.size()});
+  file.size_bytes += header.size() + data.size();
+  size_bytes_ += header.size() + data.size();
+  while (size_bytes_ > max_size_bytes_ && files_.size() > 1) {
+    DeleteOldestFile();
+  }
+  return absl::OkStatus();
+}
+
+absl::StatusOr<std::string> CrossTrainerCacheDiskTier::Read(size_t index) {
+  Record record;
+  {
+    mutex_lock l(mu_);
+    if (index < start_index_ || index >= start_index_ + records_.size()) {
+      return absl::NotFoundError(absl::StrCat(
+          "Element ", index,
+          " is not in the tf.data service cross-trainer cache disk tier."));
+    }
+    record = records_[index - start_index_];
+    TF_RETURN_IF_ERROR(FlushForRead(record));
+  }
+
+  std::string data(record.size, '\0');
+  absl::string_view result;
+  TF_RETURN_IF_ERROR(
+      record.file->reader->Read(record.offset, record.size, &result,
+                                data.data()));
+  if (result.size() != record.size) {
+    return absl::DataLossError(absl::StrCat(
+        "Read ", result.size(), " bytes of element ", index, " from ",
+        record.file->filename, ", expected ", record.size, " bytes."));
+  }
+  if (result.data() != data.data()) {
+    data.assign(result.data(), result.size());
+  }
+  return data;
+}
+
+size_t CrossTrainerCacheDiskTier::start_index() const {
+  mutex_lock l(mu_);
+  return start_index_;
+}
+
+size_t CrossTrainerCacheDiskTier::end_index() const {
+  mutex_lock l(mu_);
+  return start_index_ + records_.size();
+}
+
+size_t CrossTrainerCacheDiskTier::size_bytes() const {
+  mutex_lock l(mu_);
+  return size_bytes_;
+}
+
+absl::Status CrossTrainerCacheDiskTier::FlushForRead(const Record& record)
+    TF_EXCLUSIVE_LOCKS_REQUIRED(mu_) {
+  if (record.offset + record.size <= record.file->flushed_size_bytes) {
+    return absl::OkStatus();
+  }
+  // Only the file being written has unflushed records. Closed files are
+  // flushed when they are closed.
+  File& file = *files_.back();
+  DCHECK_EQ(record.file.get(), &file);
+  absl::Status s = writer_->Flush();
+  if (!s.ok()) {
+    LOG(WARNING) << "Failed to flush tf.data service cross-trainer cache file "
+                 << file.filename << ": " << s;
+    // The file may not hold all of its records, so all elements are discarded.
+    while (!files_.empty()) {
+      DeleteOldestFile();
+    }
+    return absl::NotFoundError(absl::StrCat(
+        "Element ", record.file->start_index,
+        " and the following elements were discarded from the tf.data service "
+        "cross-trainer cache disk tier: ",
+        s.message()));
+  }
+  file.flushed_size_bytes = file.size_bytes;
+  return absl::OkStatus();
+}
+
+absl::Status CrossTrainerCacheDiskTier::StartFile(size_t start_index)
+    TF_EXCLUSIVE_LOCKS_REQUIRED(mu_) {
+  if (writer_ != nullptr) {
+    TF_RETURN_IF_ERROR(writer_->Close());
+    writer_.reset();
+    files_.back()->flushed_size_bytes = files_.back()->size_bytes;
+  }
+  auto file = std::make_shared<File>();
+  file->filename = absl::StrCat(file_prefix_, "_", next_file_number_++);
+  file->start_index = start_index;
+  std::unique_ptr<WritableFile> writer;
+  TF_RETURN_IF_ERROR(env_->NewWritableFile(file->filename, &writer));
+  TF_RETURN_IF_ERROR(env_->NewRandomAccessFile(file->filename, &file->reader));
+  writer_ = std::move(writer);
+  files_.push_back(std::move(file));
+  return absl::OkStatus();
+}
+
+void CrossTrainerCacheDiskTier::DeleteOldestFile()
+    TF_EXCLUSIVE_LOCKS_REQUIRED(mu_) {
+  std::shared_ptr<File> file = std::move(files_.front());
+  files_.pop_front();
+  const size_t end_index = files_.empty() ? start_index_ + records_.size()
+                                          : files_.front()->start_index;
+  while (start_index_ < end_index && !records_.empty()) {
+    records_.pop_front();
+    ++start_index_;
+  }
+  size_bytes_ -= file->size_bytes;
+  if (files_.empty()) {
+    writer_.reset();
+    size_bytes_ = 0;
+  }
+  // Readers holding the file may still read from it on file systems that
+  // support reading deleted files.
+  absl::Status s = env_->DeleteFile(file->filename);
+  if (!s.ok()) {
+    LOG(WARNING) << "Failed to delete tf.data service cross-trainer cache file "
+                 << file->filename << ": " << s;
+  }
+}
+
+}  // namespace data
+}  // namespace tensorflow
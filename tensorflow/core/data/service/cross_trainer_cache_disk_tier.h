@@ -0,0 +1,132 @@
+/* Copyright 2026 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#ifndef TENSORFLOW_CORE_DATA_SERVICE_CROSS_TRAINER_CACHE_DISK_TIER_H_
+#define TENSORFLOW_CORE_DATA_SERVICE_CROSS_TRAINER_CACHE_DISK_TIER_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <string>
+
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/string_view.h"
+#include "tensorflow/core/platform/env.h"
+#include "tensorflow/core/platform/file_system.h"
+#include "tensorflow/core/platform/mutex.h"
+#include "tensorflow/core/platform/thread_annotations.h"
+
+namespace tensorflow {
+namespace data {
+
+// Second tier of a `CrossTrainerCache`, which holds serialized elements evicted
+// from memory on local disk. Trainers that fall behind the in-memory window can
+// keep reading the shared sequence from this tier.
+//
+// Elements are appended to a small number of append-only files in `directory`.
+// Each record is the varint64-encoded size of the element followed by its
+// bytes. The offsets of the records are kept in memory. Appends are buffered;
+// the file being written is only flushed when a read needs its unflushed
+// records. When the tier exceeds
+// `max_size_bytes`, the oldest file is deleted along with its elements. Files
+// are deleted when the tier is destroyed.
+//
+// Elements are identified by their absolute index in the cached sequence. They
+// are appended in increasing index order, so the tier holds the contiguous
+// range [`start_index()`, `end_index()`).
+//
+// The `CrossTrainerCacheDiskTier` class is thread-safe.
+class CrossTrainerCacheDiskTier {
+ public:
+  // Creates a disk tier which writes files to `directory`, creating it if
+  // needed. Several tiers may share the same directory.
+  static absl::StatusOr<std::unique_ptr<CrossTrainerCacheDiskTier>> Create(
+      Env* env, const std::string& directory, size_t max_size_bytes);
+  ~CrossTrainerCacheDiskTier();
+  CrossTrainerCacheDiskTier(const CrossTrainerCacheDiskTier&) = delete;
+  CrossTrainerCacheDiskTier& operator=(const CrossTrainerCacheDiskTier&) =
+      delete;
+
+  // Appends the serialized element with absolute index `index`. If `index` is
+  // not `end_index()`, the elements held so far are discarded, since the tier
+  // only holds contiguous ranges.
+  absl::Status Append(size_t index, absl::string_view data);
+
+  // Reads the serialized element with absolute index `index`. Returns NotFound
+  // if the element is not in the tier, for example, because it was deleted.
+  absl::StatusOr<std::string> Read(size_t index);
+
+  // Returns the index of the oldest element in the tier.
+  size_t start_index() const;
+
+  // Returns the index following the newest element in the tier.
+  size_t end_index() const;
+
+  // Returns the total size of the files in bytes.
+  size_t size_bytes() const;
+
+ private:
+  struct File {
+    std::string filename;
+    std::unique_ptr<RandomAccessFile> reader;
+    size_t size_bytes = 0;
+    // Bytes of the file which are flushed and can be read.
+    size_t flushed_size_bytes = 0;
+    // Absolute index of the first element in the file.
+    size_t start_index = 0;
+  };
+
+  struct Record {
+    std::shared_ptr<const File> file;
+    uint64_t offset = 0;
+    uint64_t size = 0;
+  };
+
+  CrossTrainerCacheDiskTier(Env* env, std::string file_prefix,
+                            size_t max_size_bytes);
+
+  // Flushes the file being written so that `record` can be read from it.
+  absl::Status FlushForRead(const Record& record)
+      TF_EXCLUSIVE_LOCKS_REQUIRED(mu_);
+
+  // Starts a new file for elements starting with `start_index`.
+  absl::Status StartFile(size_t start_index) TF_EXCLUSIVE_LOCKS_REQUIRED(mu_);
+
+  // Deletes the oldest file and its elements.
+  void DeleteOldestFile() TF_EXCLUSIVE_LOCKS_REQUIRED(mu_);
+
+  Env* const env_;
+  // Prefix of the files of this tier, including the directory.
+  const std::string file_prefix_;
+  const size_t max_size_bytes_;
+  // A new file is started when the current file exceeds this size.
+  const size_t max_file_size_bytes_;
+
+  mutable mutex mu_;
+  std::deque<std::shared_ptr<File>> files_ TF_GUARDED_BY(mu_);
+  std::unique_ptr<WritableFile> writer_ TF_GUARDED_BY(mu_);
+  int64_t next_file_number_ TF_GUARDED_BY(mu_) = 0;
+  size_t size_bytes_ TF_GUARDED_BY(mu_) = 0;
+
+  // Records of elements [start_index_, start_index_ + records_.size()).
+  std::deque<Record> records_ TF_GUARDED_BY(mu_);
+  size_t start_index_ TF_GUARDED_BY(mu_) = 0;
+};
+
+}  // namespace data
+}  // namespace tensorflow
+
+#endif  // TENSORFLOW_CORE_DATA_SERVICE_CROSS_TRAINER_CACHE_DISK_TIER_H_
@@ -0,0 +1,146 @@
+/* Copyright 2026 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#include "tensorflow/core/data/service/cross_trainer_cache_disk_tier.h"
+
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "absl/status/status.h"
+#include "absl/strings/str_cat.h"
+#include "tensorflow/core/lib/core/status_test_util.h"
+#include "tensorflow/core/platform/env.h"
+#include "tensorflow/core/platform/path.h"
+#include "tensorflow/core/platform/status_matchers.h"
+#include "tensorflow/core/platform/test.h"
+
+namespace tensorflow {
+namespace data {
+namespace {
+
+using ::testing::Gt;
+using ::testing::IsEmpty;
+using ::testing::Le;
+using ::testing::SizeIs;
+
+std::string TestDirectory() {
+  return io::JoinPath(::testing::TempDir(), "cross_trainer_cache_disk_tier");
+}
+
+std::string MakeElement(size_t index) {
+  return absl::StrCat("Element ", index, std::string(100, 'x'));
+}
+
+std::vector<std::string> GetFiles(const std::string& directory) {
+  std::vector<std::string> files;
+  TF_CHECK_OK(Env::Default()->GetMatchingPaths(
+      io::JoinPath(directory, "cross_trainer_cache_*"), &files));
+  return files;
+}
+
+TEST(CrossTrainerCacheDiskTierTest, AppendAndRead) {
+  TF_ASSERT_OK_AND_ASSIGN(
+      std::unique_ptr<CrossTrainerCacheDiskTier> disk_tier,
+      CrossTrainerCacheDiskTier::Create(Env::Default(), TestDirectory(),
+                                        /*max_size_bytes=*/size_t{1} << 20));
+  for (size_t i = 0; i < 100; ++i) {
+    TF_ASSERT_OK(disk_tier->Append(i, MakeElement(i)));
+  }
+  EXPECT_EQ(disk_tier->start_index(), 0);
+  EXPECT_EQ(disk_tier->end_index(), 100);
+  EXPECT_THAT(disk_tier->size_bytes(), Gt(100 * MakeElement(0).size()));
+  for (size_t i = 0; i < 100; ++i) {
+    EXPECT_THAT(disk_tier->Read(i),
+                absl_testing::IsOkAndHolds(MakeElement(i)));
+  }
+  EXPECT_THAT(disk_tier->Read(100),
+              absl_testing::StatusIs(absl::StatusCode::kNotFound));
+}
+
+TEST(CrossTrainerCacheDiskTierTest, ReadsElementsWhileAppending) {
+  TF_ASSERT_OK_AND_ASSIGN(
+      std::unique_ptr<CrossTrainerCacheDiskTier> disk_tier,
+      CrossTrainerCacheDiskTier::Create(Env::Default(), TestDirectory(),
+                                        /*max_size_bytes=*/size_t{1} << 20));
+  for (size_t i = 0; i < 100; ++i) {
+    TF_ASSERT_OK(disk_tier->Append(i, MakeElement(i)));
+    // The newest element is only flushed when it is read.
+    EXPECT_THAT(disk_tier->Read(i),
+                absl_testing::IsOkAndHolds(MakeElement(i)));
+    EXPECT_THAT(disk_tier->Read(i / 2),
+                absl_testing::IsOkAndHolds(MakeElement(i / 2)));
+  }
+}
+
+TEST(CrossTrainerCacheDiskTierTest, DeletesOldestElements) {
+  const size_t max_size_bytes = 20 * MakeElement(0).size();
+  TF_ASSERT_OK_AND_ASSIGN(
+      std::unique_ptr<CrossTrainerCacheDiskTier> disk_tier,
+      CrossTrainerCacheDiskTier::Create(Env::Default(), TestDirectory(),
+                                        max_size_bytes));
+  for (size_t i = 0; i < 1000; ++i) {
+    TF_ASSERT_OK(disk_tier->Append(i, MakeElement(i)));
+    EXPECT_THAT(disk_tier->size_bytes(), Le(max_size_bytes));
+  }
+  EXPECT_THAT(disk_tier->start_index(), Gt(900));
+  EXPECT_EQ(disk_tier->end_index(), 1000);
+  EXPECT_THAT(disk_tier->Read(0),
+              absl_testing::StatusIs(absl::StatusCode::kNotFound));
+  for (size_t i = disk_tier->start_index(); i < 1000; ++i) {
+    EXPECT_THAT(disk_tier->Read(i),
+                absl_testing::IsOkAndHolds(MakeElement(i)));
+  }
+}
+
+TEST(CrossTrainerCacheDiskTierTest, NonContiguousAppendDiscardsElements) {
+  TF_ASSERT_OK_AND_ASSIGN(
+      std::unique_ptr<CrossTrainerCacheDiskTier> disk_tier,
+      CrossTrainerCacheDiskTier::Create(Env::Default(), TestDirectory(),
+                                        /*max_size_bytes=*/size_t{1} << 20));
+  for (size_t i = 0; i < 10; ++i) {
+    TF_ASSERT_OK(disk_tier->Append(i, MakeElement(i)));
+  }
+  TF_ASSERT_OK(disk_tier->Append(20, MakeElement(20)));
+  EXPECT_EQ(disk_tier->start_index(), 20);
+  EXPECT_EQ(disk_tier->end_index(), 21);
+  EXPECT_THAT(disk_tier->Read(5),
+              absl_testing::StatusIs(absl::StatusCode::kNotFound));
+  EXPECT_THAT(disk_tier->Read(20),
+              absl_testing::IsOkAndHolds(MakeElement(20)));
+}
+
+TEST(CrossTrainerCacheDiskTierTest, DeletesFilesOnDestruction) {
+  const std::string directory =
+      io::JoinPath(TestDirectory(), "DeletesFilesOnDestruction");
+  TF_ASSERT_OK_AND_ASSIGN(
+      std::unique_ptr<CrossTrainerCacheDiskTier> disk_tier,
+      CrossTrainerCacheDiskTier::Create(Env::Default(), directory,
+                                        /*max_size_bytes=*/size_t{1} << 20));
+  TF_ASSERT_OK(disk_tier->Append(0, MakeElement(0)));
+  EXPECT_THAT(GetFiles(directory), SizeIs(1));
+  disk_tier.reset();
+  EXPECT_THAT(GetFiles(directory), IsEmpty());
+}
+
+TEST(CrossTrainerCacheDiskTierTest, InvalidSize) {
+  EXPECT_THAT(CrossTrainerCacheDiskTier::Create(Env::Default(), TestDirectory(),
+                                                /*max_size_bytes=*/0),
+              absl_testing::StatusIs(absl::StatusCode::kInvalidArgument));
+}
+
+}  // namespace
+}  // namespace data
+}  // namespace tensorflow
@@ -22,14 +22,18 @@ limitations under the License.
 
 #include "absl/container/flat_hash_map.h"
 #include "absl/memory/memory.h"
+#include "absl/strings/numbers.h"
 #include "absl/strings/str_cat.h"
+#include "absl/strings/string_view.h"
 #include "absl/time/time.h"
+#include "tensorflow/core/data/service/cross_trainer_cache_disk_tier.h"
 #include "tensorflow/core/framework/tensor.h"
 #include "tensorflow/core/framework/tensor_testutil.h"
 #include "tensorflow/core/lib/monitoring/cell_reader.h"
 #include "tensorflow/core/platform/env.h"
 #include "tensorflow/core/platform/errors.h"
 #include "tensorflow/core/platform/mutex.h"
+#include "tensorflow/core/platform/path.h"
 #include "tensorflow/core/platform/random.h"
 #include "tensorflow/core/platform/status.h"
 #include "tensorflow/core/platform/status_matchers.h"
@@ -44,8 +48,10 @@ namespace {
 using ::tensorflow::monitoring::testing::CellReader;
 using ::tensorflow::testing::IsOkAndHolds;
 using ::tensorflow::testing::StatusIs;
+using ::testing::ElementsAreArray;
 using ::testing::Gt;
 using ::testing::HasSubstr;
+using ::testing::Lt;
 using ::testing::Pointee;
 using ::testing::UnorderedElementsAreArray;
 
@@ -61,6 +67,35 @@ class InfiniteRange : public CachableSequence<int64_t> {
   int64_t next_ = 0;
 };
 
+// `InfiniteRange` which can be spilled to a disk tier.
+class SpillableInfiniteRange : public InfiniteRange {
+ public:
+  absl::StatusOr<std::string> SerializeElement(
+      const int64_t& element) const override {
+    return absl::StrCat(element);
+  }
+
+  absl::StatusOr<int64_t> DeserializeElement(
+      absl::string_view serialized) const override {
+    int64_t element;
+    if (!absl::SimpleAtoi(serialized, &element)) {
+      return absl::DataLossError(absl::StrCat("Invalid element ", serialized));
+    }
+    return element;
+  }
+};
+
+std::unique_ptr<CrossTrainerCacheDiskTier> MakeDiskTier(
+    size_t max_size_bytes) {
+  absl::StatusOr<std::unique_ptr<CrossTrainerCacheDiskTier>> disk_tier =
+      CrossTrainerCacheDiskTier::Create(
+          Env::Default(),
+          io::JoinPath(::testing::TempDir(), "cross_trainer_cache"),
+          max_size_bytes);
+  TF_CHECK_OK(disk_tier.status());
+  return *std::move(disk_tier);
+}
+
 class TensorDataset : public CachableSequence<Tensor> {
  public:
   absl::StatusOr<Tensor> GetNext() override { return Tensor("Test Tensor"); }
@@ -262,6 +297,118 @@ TEST(CrossTrainerCacheTest, AlternateTrainerExtendsCache) {
               absl_testing::IsOkAndHolds(Pointee(Gt(5))));
 }
 
+TEST(CrossTrainerCacheTest, SlowTrainersReadSpilledData) {
+  CrossTrainerCache<int64_t> cache(
+      /*max_cache_size_bytes=*/5 * sizeof(int64_t),
+      std::make_unique<SpillableInfiniteRange>(),
+      MakeDiskTier(/*max_size_bytes=*/size_t{1} << 20),
+      /*num_prefetch_elements=*/4);
+  for (int i = 0; i < 100; ++i) {
+    EXPECT_THAT(cache.Get("Fast trainer"),
+                absl_testing::IsOkAndHolds(Pointee(i)));
+  }
+
+  // Elements discarded from memory are read from disk.
+  for (int i = 0; i < 100; ++i) {
+    EXPECT_THAT(cache.Get("Slow trainer"),
+                absl_testing::IsOkAndHolds(Pointee(i)));
+  }
+  for (int i = 100; i < 110; ++i) {
+    EXPECT_THAT(cache.Get("Slow trainer"),
+                absl_testing::IsOkAndHolds(Pointee(i)));
+    EXPECT_THAT(cache.Get("Fast trainer"),
+                absl_testing::IsOkAndHolds(Pointee(i)));
+  }
+}
+
+TEST(CrossTrainerCacheTest, SlowTrainersSkipDataDeletedFromDisk) {
+  // The disk tier holds some tens of elements.
+  std::unique_ptr<CrossTrainerCacheDiskTier> disk_tier =
+      MakeDiskTier(/*max_size_bytes=*/100);
+  CrossTrainerCacheDiskTier* disk_tier_ptr = disk_tier.get();
+  CrossTrainerCache<int64_t> cache(
+      /*max_cache_size_bytes=*/5 * sizeof(int64_t),
+      std::make_unique<SpillableInfiniteRange>(), std::move(disk_tier),
+      /*num_prefetch_elements=*/4);
+  for (int i = 0; i < 1000; ++i) {
+    EXPECT_THAT(cache.Get("Fast trainer"),
+                absl_testing::IsOkAndHolds(Pointee(i)));
+  }
+  // Waits for the elements collected from memory to be spilled.
+  while (disk_tier_ptr->end_index() < 995) {
+    Env::Default()->SleepForMicroseconds(1000);
+  }
+
+  absl::StatusOr<std::shared_ptr<const int64_t>> first =
+      cache.Get("Slow trainer");
+  ASSERT_THAT(first, absl_testing::IsOkAndHolds(Pointee(Gt(900))));
+  ASSERT_THAT(first, absl_testing::IsOkAndHolds(Pointee(Lt(995))));
+  for (int64_t i = **first + 1; i < 1000; ++i) {
+    EXPECT_THAT(cache.Get("Slow trainer"),
+                absl_testing::IsOkAndHolds(Pointee(i)));
+  }
+}
+
+TEST(CrossTrainerCacheTest, DiskTierRequiresSerialization) {
+  // `InfiniteRange` does not support spilling, so nothing is written to disk.
+  // Slow trainers skip the data collected from memory.
+  std::unique_ptr<CrossTrainerCacheDiskTier> disk_tier =
+      MakeDiskTier(/*max_size_bytes=*/size_t{1} << 20);
+  CrossTrainerCacheDiskTier* disk_tier_ptr = disk_tier.get();
+  CrossTrainerCache<int64_t> cache(
+      /*max_cache_size_bytes=*/5 * sizeof(int64_t),
+      std::make_unique<InfiniteRange>(), std::move(disk_tier),
+      /*num_prefetch_elements=*/4);
+  for (int i = 0; i < 100; ++i) {
+    EXPECT_THAT(cache.Get("Fast trainer"),
+                absl_testing::IsOkAndHolds(Pointee(i)));
+  }
+
+  std::vector<int64_t> slow_trainer_elements;
+  while (slow_trainer_elements.empty() || slow_trainer_elements.back() < 99) {
+    TF_ASSERT_OK_AND_ASSIGN(std::shared_ptr<const int64_t> next,
+                            cache.Get("Slow trainer"));
+    slow_trainer_elements.push_back(*next);
+  }
+  EXPECT_TRUE(SequenceIsIncreasing(slow_trainer_elements));
+  EXPECT_EQ(disk_tier_ptr->end_index(), 0);
+}
+
+TEST(CrossTrainerCacheTest, ConcurrentReadersWithDiskTier) {
+  size_t num_trainers = 10;
+  size_t num_elements_to_read = 200;
+  CrossTrainerCache<int64_t> cache(
+      /*max_cache_size_bytes=*/3 * sizeof(int64_t),
+      std::make_unique<SpillableInfiniteRange>(),
+      MakeDiskTier(/*max_size_bytes=*/size_t{1} << 20),
+      /*num_prefetch_elements=*/8);
+
+  std::vector<std::vector<int64_t>> results(num_trainers);
+  std::vector<std::unique_ptr<Thread>> reader_threads;
+  for (size_t i = 0; i < num_trainers; ++i) {
+    std::vector<int64_t>& result = results[i];
+    reader_threads.push_back(absl::WrapUnique(Env::Default()->StartThread(
+        /*thread_options=*/{}, /*name=*/absl::StrCat("Trainer_", i),
+        [&cache, num_elements_to_read, &result, i]() {
+          for (size_t j = 0; j < num_elements_to_read; ++j) {
+            // Randomly slows down some trainers.
+            if (random::New64() % 5 == 0) {
+              Env::Default()->SleepForMicroseconds(2000);
+            }
+            TF_ASSERT_OK_AND_ASSIGN(std::shared_ptr<const int64_t> next,
+                                    cache.Get(absl::StrCat("Trainer_", i)));
+            result.push_back(*next);
+          }
+        })));
+  }
+  reader_threads.clear();
+
+  // The disk tier is large enough for every trainer to read every element.
+  for (const std::vector<int64_t>& result : results) {
+    EXPECT_THAT(result, ElementsAreArray(GetRange(num_elements_to_read)));
+  }
+}
+
 TEST(CrossTrainerCacheTest, CacheHitMetrics) {
   CellReader<int64_t> cell_reader(
       "/tensorflow/data/service/cross_trainer_cache_queries");
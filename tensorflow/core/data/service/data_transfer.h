@@ -124,6 +124,10 @@ class DataTransferServer {
   // Return the port that this server is listening on.
   virtual int Port() const = 0;
 
+  // Returns the address clients connect to, or an empty string if the address
+  // is derived from `WorkerConfig::data_transfer_address` and `Port()`.
+  virtual std::string Address() const { return ""; }
+
   // Register a DataTransferServer factory under `name`.
   static void Register(std::string name, ServerFactoryT factory);
 
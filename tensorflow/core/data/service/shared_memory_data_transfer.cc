@@ -0,0 +1,841 @@
+/* Copyright 2026 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#include "tensorflow/core/data/service/shared_memory_data_transfer.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "absl/container/flat_hash_map.h"
+#include "absl/container/flat_hash_set.h"
+#include "absl/memory/memory.h"
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/ascii.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/string_view.h"
+#include "tensorflow/core/data/service/data_transfer.h"
+#include "tensorflow/core/data/service/worker.pb.h"
+#include "tensorflow/core/framework/allocator.h"
+#include "tensorflow/core/framework/mapped_tensor_buffer.h"
+#include "tensorflow/core/framework/metrics.h"
+#include "tensorflow/core/framework/tensor.h"
+#include "tensorflow/core/framework/tensor.pb.h"
+#include "tensorflow/core/framework/tensor_shape.h"
+#include "tensorflow/core/framework/types.h"
+#include "tensorflow/core/lib/core/coding.h"
+#include "tensorflow/core/lib/random/random.h"
+#include "tensorflow/core/platform/env.h"
+#include "tensorflow/core/platform/errors.h"
+#include "tensorflow/core/platform/host_info.h"
+#include "tensorflow/core/platform/mutex.h"
+#include "tensorflow/core/platform/statusor.h"
+#include "tensorflow/core/platform/thread_annotations.h"
+#include "tensorflow/core/protobuf/service_config.pb.h"
+
+#if defined(__linux__)
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif  // defined(__linux__)
+
+namespace tensorflow {
+namespace data {
+
+std::string SharedMemoryHostId() {
+  static const std::string* host_id = [] {
+    std::string boot_id;
+    if (!ReadFileToString(Env::Default(), "/proc/sys/kernel/random/boot_id",
+                          &boot_id)
+             .ok()) {
+      boot_id.clear();
+    }
+    return new std::string(absl::StrCat(
+        port::Hostname(), "/", absl::StripAsciiWhitespace(boot_id)));
+  }();
+  return *host_id;
+}
+
+bool IsSharedMemoryTransferServerOnThisHost(
+    absl::string_view compatibility_info) {
+  return !compatibility_info.empty() &&
+         compatibility_info == SharedMemoryHostId();
+}
+
+#if defined(__linux__)
+namespace {
+
+constexpr size_t kAlignment = 64;
+// Smallest segment created, so that small elements share a size class.
+constexpr size_t kMinSegmentBytes = 64 << 10;
+// Number of segments kept per client. More segments are created while the
+// client holds on to more elements, and retired once it releases them.
+constexpr size_t kMaxCachedSegments = 8;
+// Upper bound of a control message. Element data is sent in the segments.
+constexpr size_t kMaxMessageBytes = 64 << 10;
+// Upper bound of the error message forwarded to the client.
+constexpr size_t kMaxErrorMessageBytes = 16 << 10;
+// Upper bound of the released segment ids sent with one request.
+constexpr size_t kMaxReleasedSegmentsPerRequest = 1024;
+
+// How a tensor is stored in a segment.
+enum class Encoding : uint32_t {
+  // The tensor's bytes, which the client aliases.
+  kRaw = 0,
+  // A serialized `TensorProto`.
+  kProto = 1,
+};
+
+size_t AlignUp(size_t offset, size_t alignment) {
+  return (offset + alignment - 1) / alignment * alignment;
+}
+
+absl::Status ConnectionClosedError() {
+  return absl::UnavailableError(
+      "Shared memory data transfer connection was closed.");
+}
+
+// Sends `data` as one message, passing `fd_to_pass` along if it is >= 0.
+absl::Status SendMessage(int fd, absl::string_view data, int fd_to_pass) {
+  if (data.size() > kMaxMessageBytes) {
+    return absl::InternalError(absl::StrCat(
+        "Shared memory data transfer message of ", data.size(),
+        " bytes exceeds the limit of ", kMaxMessageBytes, " bytes."));
+  }
+  struct iovec iov;
+  iov.iov_base = const_cast<char*>(data.data());
+  iov.iov_len = data.size();
+  struct msghdr msg = {};
+  msg.msg_iov = &iov;
+  msg.msg_iovlen = 1;
+  alignas(struct cmsghdr) char control[CMSG_SPACE(sizeof(int))];
+  if (fd_to_pass >= 0) {
+    std::memset(control, 0, sizeof(control));
+    msg.msg_control = control;
+    msg.msg_controllen = sizeof(control);
+    struct cmsghdr* cmsg = CMSG_FIRSTHDR(&msg);
+    cmsg->cmsg_level = SOL_SOCKET;
+    cmsg->cmsg_type = SCM_RIGHTS;
+    cmsg->cmsg_len = CMSG_LEN(sizeof(int));
+    std::memcpy(CMSG_DATA(cmsg), &fd_to_pass, sizeof(int));
+  }
+  ssize_t sent;
+  do {
+    sent = sendmsg(fd, &msg, MSG_NOSIGNAL);
+  } while (sent < 0 && errno == EINTR);
+  if (sent < 0) {
+    return errno == EPIPE || errno == ECONNRESET
+               ? ConnectionClosedError()
+               : errors::IOError("sendmsg", errno);
+  }
+  return absl::OkStatus();
+}
+
+// Receives one message into `buffer`. Sets `received_fd` to the file
+// descriptor passed along with the message, or -1.
+absl::Status ReceiveMessage(int fd, std::string& buffer, int& received_fd) {
+  received_fd = -1;
+  buffer.resize(kMaxMessageBytes);
+  struct iovec iov;
+  iov.iov_base = buffer.data();
+  iov.iov_len = buffer.size();
+  struct msghdr msg = {};
+  msg.msg_iov = &iov;
+  msg.msg_iovlen = 1;
+  alignas(struct cmsghdr) char control[CMSG_SPACE(sizeof(int))];
+  msg.msg_control = control;
+  msg.msg_controllen = sizeof(control);
+  ssize_t received;
+  do {
+    received = recvmsg(fd, &msg, MSG_CMSG_CLOEXEC);
+  } while (received < 0 && errno == EINTR);
+  if (received < 0) {
+    return errno == ECONNRESET ? ConnectionClosedError()
+                               : errors::IOError("recvmsg", errno);
+  }
+  for (struct cmsghdr* cmsg = CMSG_FIRSTHDR(&msg); cmsg != nullptr;
+       cmsg = CMSG_NXTHDR(&msg, cmsg)) {
+    if (cmsg->cmsg_level == SOL_SOCKET && cmsg->cmsg_type == SCM_RIGHTS &&
+        cmsg->cmsg_len == CMSG_LEN(sizeof(int))) {
+      std::memcpy(&received_fd, CMSG_DATA(cmsg), sizeof(int));
+    }
+  }
+  if (received == 0) {
+    if (received_fd >= 0) close(received_fd);
+    return ConnectionClosedError();
+  }
+  if (msg.msg_flags & (MSG_TRUNC | MSG_CTRUNC)) {
+    if (received_fd >= 0) close(received_fd);
+    return absl::DataLossError(
+        "Shared memory data transfer message was truncated.");
+  }
+  buffer.resize(received);
+  return absl::OkStatus();
+}
+
+// Fills `addr` with the socket address for `address`. Addresses starting with
+// '@' are in the abstract socket namespace.
+absl::StatusOr<socklen_t> ToSocketAddress(absl::string_view address,
+                                          struct sockaddr_un& addr) {
+  addr = {};
+  addr.sun_family = AF_UNIX;
+  if (address.empty() || address.size() >= sizeof(addr.sun_path)) {
+    return absl::InvalidArgumentError(absl::StrCat(
+        "Invalid shared memory data transfer address '", address, "'."));
+  }
+  std::memcpy(addr.sun_path, address.data(), address.size());
+  if (address[0] == '@') {
+    addr.sun_path[0] = '\0';
+    return offsetof(struct sockaddr_un, sun_path) + address.size();
+  }
+  return sizeof(addr);
+}
+
+// A segment of shared memory, as created by the server.
+class Segment {
+ public:
+  static absl::StatusOr<std::unique_ptr<Segment>> Create(int64_t id,
+                                                          size_t capacity) {
+    int fd = memfd_create("tf_data_service_element", MFD_CLOEXEC);
+    if (fd < 0) {
+      return errors::IOError("memfd_create", errno);
+    }
+    if (ftruncate(fd, capacity) != 0) {
+      absl::Status s = errors::IOError("ftruncate", errno);
+      close(fd);
+      return s;
+    }
+    void* data =
+        mmap(nullptr, capacity, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (data == MAP_FAILED) {
+      absl::Status s = errors::IOError("mmap", errno);
+      close(fd);
+      return s;
+    }
+    return absl::WrapUnique(
+        new Segment(id, fd, static_cast<char*>(data), capacity));
+  }
+
+  ~Segment() {
+    munmap(data_, capacity_);
+    close(fd_);
+  }
+
+  int64_t id() const { return id_; }
+  int fd() const { return fd_; }
+  char* data() const { return data_; }
+  size_t capacity() const { return capacity_; }
+
+  // Whether the client holds tensors referring to this segment.
+  bool in_use = false;
+  // Whether the client has mapped this segment.
+  bool sent = false;
+
+ private:
+  Segment(int64_t id, int fd, char* data, size_t capacity)
+      : id_(id), fd_(fd), data_(data), capacity_(capacity) {}
+
+  const int64_t id_;
+  const int fd_;
+  char* const data_;
+  const size_t capacity_;
+};
+
+// Server side state of a client connection.
+struct ClientSegments {
+  std::vector<std::unique_ptr<Segment>> segments;
+  int64_t next_segment_id = 1;
+
+  Segment* Find(int64_t id) {
+    for (const std::unique_ptr<Segment>& segment : segments) {
+      if (segment->id() == id) return segment.get();
+    }
+    return nullptr;
+  }
+
+  // Returns the smallest free segment with at least `size` bytes, creating a
+  // new one if there is none. Retires free segments beyond
+  // `kMaxCachedSegments`, appending their ids to `retired`.
+  absl::StatusOr<Segment*> Acquire(size_t size, std::vector<int64_t>& retired) {
+    Segment* best = nullptr;
+    for (const std::unique_ptr<Segment>& segment : segments) {
+      if (!segment->in_use && segment->capacity() >= size &&
+          (best == nullptr || segment->capacity() < best->capacity())) {
+        best = segment.get();
+      }
+    }
+    if (best == nullptr) {
+      const size_t capacity = std::max(
+          AlignUp(size, static_cast<size_t>(sysconf(_SC_PAGESIZE))),
+          kMinSegmentBytes);
+      TF_ASSIGN_OR_RETURN(std::unique_ptr<Segment> segment,
+                          Segment::Create(next_segment_id++, capacity));
+      best = segment.get();
+      segments.push_back(std::move(segment));
+    }
+    best->in_use = true;
+
+    // Retires the smallest free segments first, as they are the least likely
+    // to fit the next elements.
+    std::sort(segments.begin(), segments.end(),
+              [](const std::unique_ptr<Segment>& a,
+                 const std::unique_ptr<Segment>& b) {
+                return a->capacity() < b->capacity();
+              });
+    for (auto it = segments.begin();
+         it != segments.end() && segments.size() > kMaxCachedSegments;) {
+      if ((*it)->in_use) {
+        ++it;
+        continue;
+      }
+      if ((*it)->sent) retired.push_back((*it)->id());
+      it = segments.erase(it);
+    }
+    return best;
+  }
+};
+
+class SharedMemoryDataTransferServer : public DataTransferServer {
+ public:
+  explicit SharedMemoryDataTransferServer(GetElementT get_element)
+      : get_element_(std::move(get_element)) {}
+
+  ~SharedMemoryDataTransferServer() override {
+    std::vector<std::unique_ptr<Thread>> client_threads;
+    {
+      mutex_lock l(mu_);
+      stopped_ = true;
+      if (listen_fd_ >= 0) shutdown(listen_fd_, SHUT_RDWR);
+      for (int fd : client_fds_) shutdown(fd, SHUT_RDWR);
+    }
+    accept_thread_.reset();
+    {
+      mutex_lock l(mu_);
+      client_threads = std::move(client_threads_);
+    }
+    client_threads.clear();
+    if (listen_fd_ >= 0) close(listen_fd_);
+  }
+
+  absl::Status Start(const experimental::WorkerConfig& config) override {
+    address_ = absl::StrCat("@tf_data_service_shm.",
+                            Env::Default()->GetProcessId(), ".",
+                            random::New64());
+    struct sockaddr_un addr;
+    TF_ASSIGN_OR_RETURN(socklen_t addr_len, ToSocketAddress(address_, addr));
+    int fd = socket(AF_UNIX, SOCK_SEQPACKET | SOCK_CLOEXEC, 0);
+    if (fd < 0) {
+      return errors::IOError("socket", errno);
+    }
+    if (bind(fd, reinterpret_cast<struct sockaddr*>(&addr), addr_len) != 0 ||
+        listen(fd, SOMAXCONN) != 0) {
+      absl::Status s = errors::IOError(absl::StrCat("bind ", address_), errno);
+      close(fd);
+      return s;
+    }
+    listen_fd_ = fd;
+    accept_thread_ = absl::WrapUnique(Env::Default()->StartThread(
+        {}, "tf_data_shm_transfer_server", [this] { AcceptLoop(); }));
+    return absl::OkStatus();
+  }
+
+  int Port() const override { return -1; }
+
+  std::string Address() const override { return address_; }
+
+  absl::StatusOr<std::string> GetCompatibilityInfo() const override {
+    return SharedMemoryHostId();
+  }
+
+ private:
+  void AcceptLoop() {
+    while (true) {
+      int fd = accept4(listen_fd_, nullptr, nullptr, SOCK_CLOEXEC);
+      if (fd < 0) {
+        if (errno == EINTR || errno == ECONNABORTED) continue;
+        mutex_lock l(mu_);
+        if (!stopped_) {
+          LOG(ERROR) << "Shared memory data transfer server at " << address_
+                     << " stopped accepting clients: "
+                     << errors::IOError("accept", errno);
+        }
+        return;
+      }
+      mutex_lock l(mu_);
+      if (stopped_) {
+        close(fd);
+        return;
+      }
+      client_fds_.insert(fd);
+      client_threads_.push_back(absl::WrapUnique(Env::Default()->StartThread(
+          {}, "tf_data_shm_transfer_client", [this, fd] {
+            ServeClient(fd);
+            mutex_lock l(mu_);
+            client_fds_.erase(fd);
+            close(fd);
+          })));
+    }
+  }
+
+  void ServeClient(int fd) {
+    ClientSegments client;
+    std::string request_buffer;
+    std::string response;
+    while (true) {
+      int unused_fd;
+      absl::Status s = ReceiveMessage(fd, request_buffer, unused_fd);
+      if (unused_fd >= 0) close(unused_fd);
+      if (!s.ok()) {
+        if (!absl::IsUnavailable(s)) {
+          LOG(WARNING) << "Failed to receive shared memory data transfer "
+                       << "request: " << s;
+        }
+        return;
+      }
+      Segment* segment = nullptr;
+      response.clear();
+      s = HandleRequest(request_buffer, client, response, segment);
+      if (!s.ok()) {
+        response.clear();
+        core::PutVarint32(&response, static_cast<uint32_t>(s.code()));
+        response.append(s.message().substr(0, kMaxErrorMessageBytes));
+        segment = nullptr;
+      }
+      const int fd_to_pass =
+          segment != nullptr && !segment->sent ? segment->fd() : -1;
+      s = SendMessage(fd, response, fd_to_pass);
+      if (!s.ok()) {
+        if (!absl::IsUnavailable(s)) {
+          LOG(WARNING) << "Failed to send shared memory data transfer "
+                       << "response: " << s;
+        }
+        return;
+      }
+      if (segment != nullptr) segment->sent = true;
+    }
+  }
+
+  // Serves one request. Sets `segment` to the segment holding the element, if
+  // any.
+  absl::Status HandleRequest(absl::string_view request_buffer,
+                             ClientSegments& client, std::string& response,
+                             Segment*& segment) {
+    uint32_t num_released;
+    if (!core::GetVarint32(&request_buffer, &num_released)) {
+      return absl::DataLossError("Malformed shared memory transfer request.");
+    }
+    for (uint32_t i = 0; i < num_released; ++i) {
+      uint64_t id;
+      if (!core::GetVarint64(&request_buffer, &id)) {
+        return absl::DataLossError("Malformed shared memory transfer request.");
+      }
+      if (Segment* released = client.Find(id); released != nullptr) {
+        released->in_use = false;
+      }
+    }
+    GetElementRequest request;
+    if (!request.ParseFromArray(request_buffer.data(), request_buffer.size())) {
+      return absl::DataLossError("Failed to parse GetElementRequest.");
+    }
+
+    GetElementResult result;
+    TF_RETURN_IF_ERROR(get_element_(&request, &result));
+
+    // Lays out the components, followed by their index.
+    std::vector<std::string> serialized(result.components.size());
+    std::vector<size_t> offsets(result.components.size());
+    std::string index;
+    size_t size = 0;
+    for (size_t i = 0; i < result.components.size(); ++i) {
+      const Tensor& t = result.components[i];
+      size_t bytes;
+      Encoding encoding;
+      if (DataTypeCanUseMemcpy(t.dtype())) {
+        encoding = Encoding::kRaw;
+        size = AlignUp(size, kAlignment);
+        bytes = t.tensor_data().size();
+      } else {
+        encoding = Encoding::kProto;
+        TensorProto proto;
+        t.AsProtoTensorContent(&proto);
+        if (!proto.SerializeToString(&serialized[i])) {
+          return absl::InternalError(
+              absl::StrCat("Failed to serialize tensor ", t.DebugString()));
+        }
+        bytes = serialized[i].size();
+      }
+      offsets[i] = size;
+      core::PutVarint32(&index, t.dtype());
+      core::PutVarint32(&index, static_cast<uint32_t>(encoding));
+      core::PutVarint32(&index, t.dims());
+      for (int64_t dim : t.shape().dim_sizes()) {
+        core::PutVarint64(&index, dim);
+      }
+      core::PutVarint64(&index, size);
+      core::PutVarint64(&index, bytes);
+      size += bytes;
+    }
+    const size_t index_offset = size;
+    size += index.size();
+
+    std::vector<int64_t> retired;
+    if (!result.components.empty()) {
+      TF_ASSIGN_OR_RETURN(segment, client.Acquire(size, retired));
+      for (size_t i = 0; i < result.components.size(); ++i) {
+        absl::string_view data = serialized[i].empty()
+                                     ? result.components[i].tensor_data()
+                                     : absl::string_view(serialized[i]);
+        if (!data.empty()) {
+          std::memcpy(segment->data() + offsets[i], data.data(), data.size());
+        }
+      }
+      std::memcpy(segment->data() + index_offset, index.data(), index.size());
+    }
+
+    core::PutVarint32(&response, static_cast<uint32_t>(absl::StatusCode::kOk));
+    core::PutVarint64(&response, result.element_index);
+    core::PutVarint32(&response, (result.end_of_sequence ? 1 : 0) |
+                                     (result.skip ? 2 : 0));
+    core::PutVarint32(&response, retired.size());
+    for (int64_t id : retired) {
+      core::PutVarint64(&response, id);
+    }
+    core::PutVarint64(&response, segment != nullptr ? segment->id() : 0);
+    core::PutVarint64(&response, segment != nullptr ? segment->capacity() : 0);
+    core::PutVarint64(&response, index_offset);
+    core::PutVarint64(&response, index.size());
+    core::PutVarint32(&response, result.components.size());
+    return absl::OkStatus();
+  }
+
+  const GetElementT get_element_;
+  std::string address_;
+  std::unique_ptr<Thread> accept_thread_;
+
+  // Set before the accept thread starts.
+  int listen_fd_ = -1;
+
+  mutex mu_;
+  bool stopped_ TF_GUARDED_BY(mu_) = false;
+  absl::flat_hash_set<int> client_fds_ TF_GUARDED_BY(mu_);
+  std::vector<std::unique_ptr<Thread>> client_threads_ TF_GUARDED_BY(mu_);
+};
+
+// A read-only mapping of a segment on the client side.
+class Mapping {
+ public:
+  Mapping(const char* data, size_t size) : data_(data), size_(size) {}
+  ~Mapping() { munmap(const_cast<char*>(data_), size_); }
+
+  const char* data() const { return data_; }
+  size_t size() const { return size_; }
+
+ private:
+  const char* const data_;
+  const size_t size_;
+};
+
+// Ids of the segments whose tensors were all released by the client.
+struct ReleasedSegments {
+  mutex mu;
+  std::vector<int64_t> ids TF_GUARDED_BY(mu);
+};
+
+// Keeps the segment of one element in use on the server until all tensors
+// aliasing it are released.
+class SegmentLease {
+ public:
+  SegmentLease(int64_t id, std::shared_ptr<const Mapping> mapping,
+               std::shared_ptr<ReleasedSegments> released)
+      : id_(id), mapping_(std::move(mapping)), released_(std::move(released)) {}
+
+  ~SegmentLease() {
+    mutex_lock l(released_->mu);
+    released_->ids.push_back(id_);
+  }
+
+ private:
+  const int64_t id_;
+  const std::shared_ptr<const Mapping> mapping_;
+  const std::shared_ptr<ReleasedSegments> released_;
+};
+
+absl::Status MalformedResponse() {
+  return absl::DataLossError("Malformed shared memory transfer response.");
+}
+
+class SharedMemoryDataTransferClient : public DataTransferClient {
+ public:
+  static absl::StatusOr<std::unique_ptr<SharedMemoryDataTransferClient>>
+  Connect(absl::string_view address, Allocator* allocator) {
+    struct sockaddr_un addr;
+    TF_ASSIGN_OR_RETURN(socklen_t addr_len, ToSocketAddress(address, addr));
+    int fd = socket(AF_UNIX, SOCK_SEQPACKET | SOCK_CLOEXEC, 0);
+    if (fd < 0) {
+      return errors::IOError("socket", errno);
+    }
+    if (connect(fd, reinterpret_cast<struct sockaddr*>(&addr), addr_len) !=
+        0) {
+      absl::Status s =
+          errors::IOError(absl::StrCat("connect ", address), errno);
+      close(fd);
+      return s;
+    }
+    VLOG(2) << "Create SharedMemoryDataTransferClient for " << address << ".";
+    return absl::WrapUnique(new SharedMemoryDataTransferClient(fd, allocator));
+  }
+
+  ~SharedMemoryDataTransferClient() override { close(fd_); }
+
+  absl::Status GetElement(const GetElementRequest& req,
+                          GetElementResult& result) override {
+    VLOG(3) << "GetElement for task " << req.task_id()
+            << " over shared memory.";
+    mutex_lock l(mu_);
+    if (cancelled_.load()) {
+      return absl::CancelledError("Client was cancelled.");
+    }
+    const int64_t start_time_us = env_->NowMicros();
+
+    std::string request;
+    {
+      mutex_lock released_lock(released_->mu);
+      std::vector<int64_t>& ids = released_->ids;
+      const size_t n = std::min(ids.size(), kMaxReleasedSegmentsPerRequest);
+      core::PutVarint32(&request, n);
+      for (size_t i = 0; i < n; ++i) {
+        core::PutVarint64(&request, ids[i]);
+      }
+      ids.erase(ids.begin(), ids.begin() + n);
+    }
+    if (!req.AppendToString(&request)) {
+      return absl::InternalError("Failed to serialize GetElementRequest.");
+    }
+    absl::Status s = SendMessage(fd_, request, /*fd_to_pass=*/-1);
+    int segment_fd = -1;
+    if (s.ok()) {
+      s = ReceiveMessage(fd_, buffer_, segment_fd);
+    }
+    if (!s.ok()) {
+      return cancelled_.load() ? absl::CancelledError("Client was cancelled.")
+                               : s;
+    }
+    s = ParseResponse(buffer_, segment_fd, result);
+    if (s.ok()) {
+      metrics::RecordTFDataServiceGetElementDuration(
+          kSharedMemoryTransferProtocol, env_->NowMicros() - start_time_us);
+    }
+    return s;
+  }
+
+  void TryCancel() override {
+    VLOG(2) << "Cancel SharedMemoryDataTransferClient.";
+    cancelled_.store(true);
+    shutdown(fd_, SHUT_RDWR);
+  }
+
+  absl::StatusOr<std::string> GetCompatibilityInfo() const override {
+    return SharedMemoryHostId();
+  }
+
+  absl::Status CheckCompatibility(
+      const std::string& server_compatibility_info) const override {
+    if (!IsSharedMemoryTransferServerOnThisHost(server_compatibility_info)) {
+      return absl::FailedPreconditionError(absl::StrCat(
+          "The shared memory transfer server runs on host ",
+          server_compatibility_info, ", but the client runs on host ",
+          SharedMemoryHostId(), "."));
+    }
+    return absl::OkStatus();
+  }
+
+ private:
+  SharedMemoryDataTransferClient(int fd, Allocator* allocator)
+      : fd_(fd), allocator_(allocator) {}
+
+  absl::Status ParseResponse(absl::string_view response, int segment_fd,
+                             GetElementResult& result)
+      TF_EXCLUSIVE_LOCKS_REQUIRED(mu_) {
+    // `segment_fd` is owned by this function and closed on all paths.
+    uint32_t code;
+    if (!core::GetVarint32(&response, &code)) {
+      if (segment_fd >= 0) close(segment_fd);
+      return MalformedResponse();
+    }
+    if (code != static_cast<uint32_t>(absl::StatusCode::kOk)) {
+      if (segment_fd >= 0) close(segment_fd);
+      return absl::Status(static_cast<absl::StatusCode>(code), response);
+    }
+    uint64_t element_index;
+    uint32_t flags, num_retired;
+    if (!core::GetVarint64(&response, &element_index) ||
+        !core::GetVarint32(&response, &flags) ||
+        !core::GetVarint32(&response, &num_retired)) {
+      if (segment_fd >= 0) close(segment_fd);
+      return MalformedResponse();
+    }
+    for (uint32_t i = 0; i < num_retired; ++i) {
+      uint64_t id;
+      if (!core::GetVarint64(&response, &id)) {
+        if (segment_fd >= 0) close(segment_fd);
+        return MalformedResponse();
+      }
+      mappings_.erase(id);
+    }
+    uint64_t segment_id, capacity, index_offset, index_size;
+    uint32_t num_components;
+    if (!core::GetVarint64(&response, &segment_id) ||
+        !core::GetVarint64(&response, &capacity) ||
+        !core::GetVarint64(&response, &index_offset) ||
+        !core::GetVarint64(&response, &index_size) ||
+        !core::GetVarint32(&response, &num_components)) {
+      if (segment_fd >= 0) close(segment_fd);
+      return MalformedResponse();
+    }
+    if (segment_fd >= 0) {
+      void* data =
+          mmap(nullptr, capacity, PROT_READ, MAP_SHARED, segment_fd, 0);
+      const int mmap_errno = errno;
+      close(segment_fd);
+      if (data == MAP_FAILED) {
+        return errors::IOError("mmap", mmap_errno);
+      }
+      mappings_[segment_id] =
+          std::make_shared<Mapping>(static_cast<const char*>(data), capacity);
+    }
+
+    result.element_index = element_index;
+    result.end_of_sequence = flags & 1;
+    result.skip = flags & 2;
+    result.components.clear();
+    if (segment_id == 0) {
+      return num_components == 0 ? absl::OkStatus() : MalformedResponse();
+    }
+    auto it = mappings_.find(segment_id);
+    if (it == mappings_.end()) {
+      return absl::DataLossError(absl::StrCat(
+          "Shared memory segment ", segment_id, " is not mapped."));
+    }
+    const std::shared_ptr<const Mapping>& mapping = it->second;
+    auto lease =
+        std::make_shared<const SegmentLease>(segment_id, mapping, released_);
+    if (index_offset > mapping->size() ||
+        index_size > mapping->size() - index_offset) {
+      return MalformedResponse();
+    }
+    absl::string_view index(mapping->data() + index_offset, index_size);
+
+    result.components.reserve(num_components);
+    for (uint32_t c = 0; c < num_components; ++c) {
+      uint32_t dtype, encoding, rank;
+      if (!core::GetVarint32(&index, &dtype) ||
+          !core::GetVarint32(&index, &encoding) ||
+          !core::GetVarint32(&index, &rank)) {
+        return MalformedResponse();
+      }
+      TensorShape shape;
+      for (uint32_t d = 0; d < rank; ++d) {
+        uint64_t dim;
+        if (!core::GetVarint64(&index, &dim)) {
+          return MalformedResponse();
+        }
+        TF_RETURN_IF_ERROR(shape.AddDimWithStatus(dim));
+      }
+      uint64_t offset, size;
+      if (!core::GetVarint64(&index, &offset) ||
+          !core::GetVarint64(&index, &size) || offset > index_offset ||
+          size > index_offset - offset) {
+        return MalformedResponse();
+      }
+      const char* data = mapping->data() + offset;
+      const DataType type = static_cast<DataType>(dtype);
+      if (encoding == static_cast<uint32_t>(Encoding::kRaw)) {
+        if (!DataTypeCanUseMemcpy(type) ||
+            size != shape.num_elements() * DataTypeSize(type)) {
+          return MalformedResponse();
+        }
+        if (size == 0) {
+          result.components.emplace_back(type, shape);
+        } else {
+          result.components.emplace_back(
+              type, shape,
+              core::RefCountPtr<TensorBuffer>(
+                  new MappedTensorBuffer(lease, data, size, "shm")));
+        }
+      } else if (encoding == static_cast<uint32_t>(Encoding::kProto)) {
+        TensorProto proto;
+        Tensor t;
+        if (!proto.ParseFromArray(data, size) ||
+            !(allocator_ != nullptr ? t.FromProto(allocator_, proto)
+                                    : t.FromProto(proto))) {
+          return absl::InternalError("Failed to parse tensor.");
+        }
+        result.components.push_back(std::move(t));
+      } else {
+        return MalformedResponse();
+      }
+    }
+    return absl::OkStatus();
+  }
+
+  const int fd_;
+  Allocator* const allocator_;
+  std::atomic<bool> cancelled_ = false;
+  const std::shared_ptr<ReleasedSegments> released_ =
+      std::make_shared<ReleasedSegments>();
+
+  // Serializes requests, so that responses match them.
+  mutex mu_;
+  absl::flat_hash_map<int64_t, std::shared_ptr<const Mapping>> mappings_
+      TF_GUARDED_BY(mu_);
+  std::string buffer_ TF_GUARDED_BY(mu_);
+};
+
+class SharedMemoryDataTransferRegistrar {
+ public:
+  SharedMemoryDataTransferRegistrar() {
+    DataTransferServer::Register(
+        kSharedMemoryTransferProtocol,
+        [](DataTransferServer::GetElementT get_element,
+           std::shared_ptr<DataTransferServer>* server) {
+          *server =
+              std::make_shared<SharedMemoryDataTransferServer>(get_element);
+          return absl::OkStatus();
+        });
+    DataTransferClient::Register(
+        kSharedMemoryTransferProtocol,
+        [](DataTransferClient::Config config,
+           std::unique_ptr<DataTransferClient>* client) {
+          TF_ASSIGN_OR_RETURN(*client, SharedMemoryDataTransferClient::Connect(
+                                           config.address, config.allocator));
+          return absl::OkStatus();
+        });
+  }
+};
+static SharedMemoryDataTransferRegistrar shared_memory_data_transfer_registrar;
+
+}  // namespace
+#endif  // defined(__linux__)
+
+}  // namespace data
+}  // namespace tensorflow
@@ -0,0 +1,55 @@
+/* Copyright 2026 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#ifndef TENSORFLOW_CORE_DATA_SERVICE_SHARED_MEMORY_DATA_TRANSFER_H_
+#define TENSORFLOW_CORE_DATA_SERVICE_SHARED_MEMORY_DATA_TRANSFER_H_
+
+#include <string>
+
+#include "absl/strings/string_view.h"
+
+namespace tensorflow {
+namespace data {
+
+// Data transfer protocol for clients running on the same host as the tf.data
+// service worker.
+//
+// The client sends `GetElementRequest`s over a Unix domain socket. The server
+// writes each element into a shared memory segment taken from a small ring of
+// segments kept per client, and passes the segment's file descriptor to the
+// client the first time it uses it. The client maps the segments and returns
+// tensors aliasing the mapping, so that tensors of memcpy-able types are not
+// copied on the client side. Other tensors are sent as serialized
+// `TensorProto`s. A segment is reused once the client released all tensors
+// referring to it.
+//
+// Workers offer the protocol if `WorkerConfig::data_transfer_protocol` is
+// "shm". Clients which do not request a specific protocol use it automatically
+// for workers on the same host, and fall back to gRPC otherwise. Only
+// supported on Linux.
+constexpr const char kSharedMemoryTransferProtocol[] = "shm";
+
+// Returns an identifier of the host, which is the same for all processes
+// sharing the kernel of this host.
+std::string SharedMemoryHostId();
+
+// Returns true if a shared memory transfer server with the given compatibility
+// info runs on the same host as the caller.
+bool IsSharedMemoryTransferServerOnThisHost(
+    absl::string_view compatibility_info);
+
+}  // namespace data
+}  // namespace tensorflow
+
+#endif  // TENSORFLOW_CORE_DATA_SERVICE_SHARED_MEMORY_DATA_TRANSFER_H_
@@ -17,13 +17,17 @@ limitations under the License.
 #include <algorithm>
 #include <memory>
 #include <optional>
+#include <string>
 #include <utility>
 #include <vector>
 
+#include "absl/strings/str_cat.h"
+#include "absl/strings/string_view.h"
 #include "tensorflow/core/data/metric_utils.h"
 #include "tensorflow/core/data/service/byte_size.h"
 #include "tensorflow/core/data/service/common.h"
 #include "tensorflow/core/data/service/cross_trainer_cache.h"
+#include "tensorflow/core/data/service/cross_trainer_cache_disk_tier.h"
 #include "tensorflow/core/data/service/data_transfer.h"
 #include "tensorflow/core/data/service/thread_safe_buffer.h"
 #include "tensorflow/core/data/service/worker.pb.h"
@@ -32,6 +36,7 @@ limitations under the License.
 #include "tensorflow/core/framework/dataset.h"
 #include "tensorflow/core/framework/model.h"
 #include "tensorflow/core/framework/tensor.h"
+#include "tensorflow/core/framework/tensor.pb.h"
 #include "tensorflow/core/framework/tensor_util.h"
 #include "tensorflow/core/framework/types.h"
 #include "tensorflow/core/lib/gtl/cleanup.h"
@@ -50,6 +55,9 @@ namespace {
 constexpr int64_t kWaitBeforeSkipUs = 100 * 1000;  // 100ms.
 constexpr size_t kDefaultCrossTrainerCacheSizeBytes =
     10 * (size_t{1} << 30);  // 10GB
+// The default disk tier holds this many times the in-memory cache.
+constexpr size_t kDefaultCrossTrainerCacheSpillSizeFactor = 10;
+constexpr size_t kDefaultCrossTrainerCacheSpillPrefetchElements = 16;
 
 }  // namespace
 
@@ -116,8 +124,26 @@ absl::Status TaskRunner::Create(const experimental::WorkerConfig& worker_config,
         worker_config.cross_trainer_cache_size_bytes() > 0
             ? worker_config.cross_trainer_cache_size_bytes()
             : kDefaultCrossTrainerCacheSizeBytes;
-    out = std::make_unique<CachingTaskRunner>(std::move(iterator),
-                                              max_cache_size_bytes);
+    std::unique_ptr<CrossTrainerCacheDiskTier> disk_tier;
+    size_t num_prefetch_elements = 0;
+    if (!worker_config.cross_trainer_cache_spill_directory().empty()) {
+      const size_t max_spill_size_bytes =
+          worker_config.cross_trainer_cache_spill_size_bytes() > 0
+              ? worker_config.cross_trainer_cache_spill_size_bytes()
+              : kDefaultCrossTrainerCacheSpillSizeFactor * max_cache_size_bytes;
+      TF_ASSIGN_OR_RETURN(
+          disk_tier, CrossTrainerCacheDiskTier::Create(
+                         Env::Default(),
+                         worker_config.cross_trainer_cache_spill_directory(),
+                         max_spill_size_bytes));
+      num_prefetch_elements =
+          worker_config.cross_trainer_cache_spill_prefetch_elements() > 0
+              ? worker_config.cross_trainer_cache_spill_prefetch_elements()
+              : kDefaultCrossTrainerCacheSpillPrefetchElements;
+    }
+    out = std::make_unique<CachingTaskRunner>(
+        std::move(iterator), max_cache_size_bytes, std::move(disk_tier),
+        num_prefetch_elements);
   } else {
     out = std::make_unique<FirstComeFirstServedTaskRunner>(std::move(iterator));
   }
@@ -198,11 +224,14 @@ std::shared_ptr<model::Model> FirstComeFirstServedTaskRunner::model() const {
   return model_;
 }
 
-CachingTaskRunner::CachingTaskRunner(std::unique_ptr<TaskIterator> iterator,
-                                     size_t max_cache_size_bytes)
+CachingTaskRunner::CachingTaskRunner(
+    std::unique_ptr<TaskIterator> iterator, size_t max_cache_size_bytes,
+    std::unique_ptr<CrossTrainerCacheDiskTier> disk_tier,
+    size_t num_prefetch_elements)
     : fcfs_task_runner_(std::move(iterator)),
       cache_(max_cache_size_bytes,
-             std::make_unique<GetElementResultSequence>(fcfs_task_runner_)) {
+             std::make_unique<GetElementResultSequence>(fcfs_task_runner_),
+             std::move(disk_tier), num_prefetch_elements) {
   LOG(INFO) << "Initialized tf.data service cross-trainer cache with "
             << ByteSize::Bytes(max_cache_size_bytes) << " of memory.";
 }
@@ -238,6 +267,51 @@ size_t CachingTaskRunner::GetElementResultSequence::GetElementSizeBytes(
   return element.EstimatedMemoryUsageBytes();
 }
 
+absl::StatusOr<std::string>
+CachingTaskRunner::GetElementResultSequence::SerializeElement(
+    const GetElementResult& element) const {
+  GetElementResponse response;
+  for (const Tensor& component : element.components) {
+    component.AsProtoTensorContent(
+        response.mutable_uncompressed()->add_components());
+  }
+  response.set_element_index(element.element_index);
+  response.set_end_of_sequence(element.end_of_sequence);
+  response.set_skip_task(element.skip);
+  std::string serialized;
+  if (!response.SerializeToString(&serialized)) {
+    return absl::InternalError(absl::StrCat(
+        "Failed to serialize element ", element.element_index,
+        " of the tf.data service cross-trainer cache."));
+  }
+  return serialized;
+}
+
+absl::StatusOr<GetElementResult>
+CachingTaskRunner::GetElementResultSequence::DeserializeElement(
+    absl::string_view serialized) const {
+  GetElementResponse response;
+  if (!response.ParseFromArray(serialized.data(), serialized.size())) {
+    return absl::DataLossError(
+        "Failed to parse an element of the tf.data service cross-trainer "
+        "cache.");
+  }
+  GetElementResult result;
+  for (const TensorProto& proto : response.uncompressed().components()) {
+    Tensor component;
+    if (!component.FromProto(proto)) {
+      return absl::DataLossError(absl::StrCat(
+          "Failed to parse a component of element ", response.element_index(),
+          " of the tf.data service cross-trainer cache."));
+    }
+    result.components.push_back(std::move(component));
+  }
+  result.element_index = response.element_index();
+  result.end_of_sequence = response.end_of_sequence();
+  result.skip = response.skip_task();
+  return result;
+}
+
 void CachingTaskRunner::Cancel() {
   VLOG(2) << "Cancelling tf.data service cross-trainer cache task.";
   if (!cache_.IsCancelled()) {
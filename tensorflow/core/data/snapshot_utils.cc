@@ -18,6 +18,7 @@ limitations under the License.
 #include <algorithm>
 #include <climits>
 #include <functional>
+#include <iterator>
 #include <memory>
 #include <new>
 #include <optional>
@@ -39,6 +40,7 @@ limitations under the License.
 #include "tensorflow/core/framework/graph.pb.h"
 #include "tensorflow/core/framework/tensor.h"
 #include "tensorflow/core/framework/tensor.pb.h"
+#include "tensorflow/core/lib/hash/crc32c.h"
 #include "tensorflow/core/lib/io/buffered_inputstream.h"
 #include "tensorflow/core/lib/io/random_inputstream.h"
 #include "tensorflow/core/lib/io/record_writer.h"
@@ -49,6 +51,7 @@ limitations under the License.
 #include "tensorflow/core/platform/file_system.h"
 #include "tensorflow/core/platform/path.h"
 #include "tensorflow/core/platform/random.h"
+#include "tensorflow/core/platform/snappy.h"
 #include "tensorflow/core/platform/strcat.h"
 #include "tensorflow/core/platform/stringprintf.h"
 #include "tensorflow/core/profiler/lib/traceme.h"
@@ -129,6 +132,9 @@ absl::Status Writer::Create(Env* env, const std::string& filename,
       *out_writer =
           std::make_unique<TFRecordWriter>(filename, compression_type);
       break;
+    case 3:
+      *out_writer = std::make_unique<BlockWriter>(filename, compression_type);
+      break;
     default:
       return absl::InvalidArgumentError(absl::StrCat(
           "Snapshot writer version: ", version, " is not supported."));
@@ -363,6 +369,108 @@ absl::Status CustomWriter::WriteRecord(const absl::Cord& data) {
 }
 #endif  // TF_CORD_SUPPORT
 
+BlockWriter::BlockWriter(const std::string& filename,
+                         const std::string& compression_type,
+                         size_t block_size_bytes)
+    : filename_(filename),
+      compression_type_(compression_type),
+      block_size_bytes_(block_size_bytes) {}
+
+absl::Status BlockWriter::Initialize(tensorflow::Env* env) {
+  if (compression_type_ == io::compression::kSnappy) {
+    compression_ = kSnappy;
+  } else if (compression_type_ == io::compression::kNone) {
+    compression_ = kNone;
+  } else {
+    return absl::InvalidArgumentError(
+        absl::StrCat("Compression ", compression_type_,
+                     " is not supported by snapshot version 3."));
+  }
+  return env->NewWritableFile(filename_, &dest_);
+}
+
+absl::Status BlockWriter::WriteTensors(const std::vector<Tensor>& tensors) {
+  for (const auto& tensor : tensors) {
+    TensorProto proto;
+    tensor.AsProtoTensorContent(&proto);
+    const size_t size = proto.ByteSizeLong();
+    core::PutVarint64(&block_, size);
+    const size_t position = block_.size();
+    block_.resize(position + size);
+    if (!proto.SerializeToArray(&block_[position], size)) {
+      return absl::DataLossError(
+          ProtoSerializationErrorMessage(proto, filename_));
+    }
+  }
+  ++block_num_elements_;
+  if (block_.size() >= block_size_bytes_) {
+    TF_RETURN_IF_ERROR(FlushBlock());
+  }
+  return absl::OkStatus();
+}
+
+absl::Status BlockWriter::FlushBlock() {
+  if (block_num_elements_ == 0) {
+    return absl::OkStatus();
+  }
+  absl::string_view data = block_;
+  std::string compressed;
+  if (compression_ == kSnappy) {
+    if (!port::Snappy_Compress(block_.data(), block_.size(), &compressed)) {
+      return absl::InternalError("Failed to compress using snappy.");
+    }
+    data = compressed;
+  }
+  char checksum[kBlockChecksumSize];
+  core::EncodeFixed32(checksum,
+                      crc32c::Mask(crc32c::Value(data.data(), data.size())));
+  TF_RETURN_IF_ERROR(dest_->Append(data));
+  TF_RETURN_IF_ERROR(
+      dest_->Append(absl::string_view(checksum, sizeof(checksum))));
+
+  core::PutFixed64(&index_, offset_);
+  core::PutFixed64(&index_, data.size());
+  core::PutFixed64(&index_, block_.size());
+  core::PutFixed64(&index_, block_num_elements_);
+  offset_ += data.size() + kBlockChecksumSize;
+  ++num_blocks_;
+  block_.clear();
+  block_num_elements_ = 0;
+  return absl::OkStatus();
+}
+
+absl::Status BlockWriter::Sync() {
+  TF_RETURN_IF_ERROR(FlushBlock());
+  return dest_->Sync();
+}
+
+absl::Status BlockWriter::Close() {
+  if (dest_ == nullptr) {
+    return absl::OkStatus();
+  }
+  TF_RETURN_IF_ERROR(FlushBlock());
+  std::string footer;
+  core::PutFixed64(&footer, offset_);
+  core::PutFixed64(&footer, num_blocks_);
+  core::PutFixed32(&footer,
+                   crc32c::Mask(crc32c::Value(index_.data(), index_.size())));
+  core::PutFixed32(&footer, compression_);
+  core::PutFixed64(&footer, kMagic);
+  DCHECK_EQ(footer.size(), kFooterSize);
+  TF_RETURN_IF_ERROR(dest_->Append(index_));
+  TF_RETURN_IF_ERROR(dest_->Append(footer));
+  TF_RETURN_IF_ERROR(dest_->Close());
+  dest_ = nullptr;
+  return absl::OkStatus();
+}
+
+BlockWriter::~BlockWriter() {
+  absl::Status s = Close();
+  if (!s.ok()) {
+    LOG(ERROR) << "Could not finish writing file: " << s;
+  }
+}
+
 absl::Status Reader::Create(Env* env, const std::string& filename,
                             const std::string& compression_type, int version,
                             const DataTypeVector& dtypes,
@@ -380,6 +488,9 @@ absl::Status Reader::Create(Env* env, const std::string& filename,
       *out_reader =
           std::make_unique<TFRecordReader>(filename, compression_type, dtypes);
       break;
+    case 3:
+      *out_reader = std::make_unique<BlockReader>(filename, dtypes);
+      break;
     default:
       return absl::InvalidArgumentError(absl::StrCat(
           "Snapshot reader version: ", version, " is not supported."));
@@ -530,13 +641,10 @@ class Reader::Dataset : public DatasetBase {
                                    current_checkpoint_id_);
     }
 
-    // TODO(frankchn): Optimize this to not parse every single element.
+    // Files written in version 3 are skipped without parsing the skipped
+    // elements.
     absl::Status AdvanceToStartIndex(IteratorContext* ctx) {
-      for (int64_t i = 0; i < start_index_; ++i) {
-        std::vector<Tensor> unused;
-        TF_RETURN_IF_ERROR(reader_->ReadTensors(&unused));
-      }
-      return absl::OkStatus();
+      return reader_->SkipRecords(start_index_);
     }
 
     std::unique_ptr<Reader> reader_;
@@ -1030,6 +1138,206 @@ absl::Status CustomReader::ReadRecord(absl::Cord* record) {
 }
 #endif  // TF_CORD_SUPPORT
 
+BlockReader::BlockReader(const std::string& filename,
+                         const DataTypeVector& dtypes)
+    : filename_(filename), dtypes_(dtypes) {}
+
+absl::Status BlockReader::Corrupted(absl::string_view reason) const {
+  return absl::DataLossError(absl::StrCat("Snapshot file ", filename_,
+                                          " is corrupted: ", reason));
+}
+
+absl::Status BlockReader::Initialize(Env* env) {
+  uint64_t file_size;
+  TF_RETURN_IF_ERROR(env->GetFileSize(filename_, &file_size));
+  TF_RETURN_IF_ERROR(env->NewRandomAccessFile(filename_, &file_));
+  if (file_size < BlockWriter::kFooterSize) {
+    return Corrupted("missing footer");
+  }
+  char footer_scratch[BlockWriter::kFooterSize];
+  absl::string_view footer;
+  TF_RETURN_IF_ERROR(file_->Read(file_size - BlockWriter::kFooterSize,
+                                 BlockWriter::kFooterSize, &footer,
+                                 footer_scratch));
+  if (footer.size() != BlockWriter::kFooterSize ||
+      core::DecodeFixed64(footer.data() + 24) != BlockWriter::kMagic) {
+    return Corrupted("bad magic number");
+  }
+  const uint64_t index_offset = core::DecodeFixed64(footer.data());
+  const uint64_t num_blocks = core::DecodeFixed64(footer.data() + 8);
+  const uint32_t index_crc =
+      crc32c::Unmask(core::DecodeFixed32(footer.data() + 16));
+  const uint32_t compression = core::DecodeFixed32(footer.data() + 20);
+  if (compression != BlockWriter::kNone &&
+      compression != BlockWriter::kSnappy) {
+    return Corrupted(absl::StrCat("unknown compression ", compression));
+  }
+  compression_ = static_cast<BlockWriter::Compression>(compression);
+  if (index_offset > file_size - BlockWriter::kFooterSize) {
+    return Corrupted("bad index offset");
+  }
+  const size_t index_size = file_size - BlockWriter::kFooterSize - index_offset;
+  if (index_size != num_blocks * BlockWriter::kIndexEntrySize) {
+    return Corrupted("bad index size");
+  }
+  std::string index_scratch(index_size, '\0');
+  absl::string_view index;
+  TF_RETURN_IF_ERROR(
+      file_->Read(index_offset, index_size, &index, index_scratch.data()));
+  if (index.size() != index_size ||
+      crc32c::Value(index.data(), index.size()) != index_crc) {
+    return Corrupted("index checksum mismatch");
+  }
+  blocks_.clear();
+  blocks_.reserve(num_blocks);
+  num_elements_ = 0;
+  for (uint64_t i = 0; i < num_blocks; ++i) {
+    const char* entry = index.data() + i * BlockWriter::kIndexEntrySize;
+    Block block;
+    block.offset = core::DecodeFixed64(entry);
+    block.size = core::DecodeFixed64(entry + 8);
+    block.uncompressed_size = core::DecodeFixed64(entry + 16);
+    block.num_elements = core::DecodeFixed64(entry + 24);
+    block.first_element = num_elements_;
+    if (block.offset > index_offset ||
+        block.size > index_offset - block.offset ||
+        index_offset - block.offset - block.size <
+            BlockWriter::kBlockChecksumSize) {
+      return Corrupted(absl::StrCat("block ", i, " is out of bounds"));
+    }
+    num_elements_ += block.num_elements;
+    blocks_.push_back(block);
+  }
+  next_element_ = 0;
+  current_block_ = -1;
+  current_elements_.clear();
+  return absl::OkStatus();
+}
+
+int64_t BlockReader::BlockForElement(int64_t index) const {
+  auto it = std::upper_bound(
+      blocks_.begin(), blocks_.end(), index,
+      [](int64_t index, const Block& block) {
+        return index < block.first_element;
+      });
+  return std::distance(blocks_.begin(), it) - 1;
+}
+
+absl::Status BlockReader::ReadBlock(
+    int64_t block_index, std::vector<std::vector<Tensor>>* elements) const {
+  if (block_index < 0 || block_index >= num_blocks()) {
+    return absl::OutOfRangeError(
+        absl::StrCat("Block ", block_index, " is out of range [0, ",
+                     blocks_.size(), ") in snapshot file ", filename_));
+  }
+  tsl::profiler::TraceMe activity(
+      [&]() { return absl::StrCat("BlockReader::ReadBlock#", block_index); },
+      tsl::profiler::TraceMeLevel::kInfo);
+  const Block& block = blocks_[block_index];
+  const size_t stored_size = block.size + BlockWriter::kBlockChecksumSize;
+  std::string scratch(stored_size, '\0');
+  absl::string_view stored;
+  TF_RETURN_IF_ERROR(
+      file_->Read(block.offset, stored_size, &stored, scratch.data()));
+  if (stored.size() != stored_size) {
+    return Corrupted(absl::StrCat("block ", block_index, " is truncated"));
+  }
+  absl::string_view data = stored.substr(0, block.size);
+  if (crc32c::Unmask(core::DecodeFixed32(stored.data() + block.size)) !=
+      crc32c::Value(data.data(), data.size())) {
+    return Corrupted(
+        absl::StrCat("checksum mismatch in block ", block_index));
+  }
+  std::string uncompressed;
+  if (compression_ == BlockWriter::kSnappy) {
+    size_t uncompressed_size;
+    if (!port::Snappy_GetUncompressedLength(data.data(), data.size(),
+                                            &uncompressed_size) ||
+        uncompressed_size != block.uncompressed_size) {
+      return Corrupted(absl::StrCat("block ", block_index,
+                                    " has an unexpected uncompressed size"));
+    }
+    uncompressed.resize(uncompressed_size);
+    if (!port::Snappy_Uncompress(data.data(), data.size(),
+                                 uncompressed.data())) {
+      return Corrupted(
+          absl::StrCat("cannot decompress block ", block_index));
+    }
+    data = uncompressed;
+  }
+
+  elements->clear();
+  elements->reserve(block.num_elements);
+  for (int64_t i = 0; i < block.num_elements; ++i) {
+    std::vector<Tensor> element;
+    element.reserve(dtypes_.size());
+    for (int j = 0; j < dtypes_.size(); ++j) {
+      uint64_t size;
+      if (!core::GetVarint64(&data, &size) || size > data.size()) {
+        return Corrupted(
+            absl::StrCat("block ", block_index, " is truncated"));
+      }
+      TensorProto proto;
+      Tensor tensor;
+      if (!proto.ParseFromArray(data.data(), size) ||
+          !tensor.FromProto(proto)) {
+        return absl::DataLossError(absl::StrCat(
+            "Unable to parse tensor from stored proto in file: ", filename_,
+            ", block ", block_index));
+      }
+      data.remove_prefix(size);
+      element.push_back(std::move(tensor));
+    }
+    elements->push_back(std::move(element));
+  }
+  if (!data.empty()) {
+    return Corrupted(
+        absl::StrCat("block ", block_index, " has trailing bytes"));
+  }
+  return absl::OkStatus();
+}
+
+absl::Status BlockReader::ReadTensors(std::vector<Tensor>* read_tensors) {
+  if (next_element_ >= num_elements_) {
+    return absl::OutOfRangeError("End of file");
+  }
+  if (current_block_ < 0 ||
+      next_element_ >= blocks_[current_block_].first_element +
+                           blocks_[current_block_].num_elements) {
+    const int64_t block_index = BlockForElement(next_element_);
+    current_block_ = -1;
+    TF_RETURN_IF_ERROR(ReadBlock(block_index, &current_elements_));
+    current_block_ = block_index;
+  }
+  *read_tensors = std::move(
+      current_elements_[next_element_ - blocks_[current_block_].first_element]);
+  ++next_element_;
+  return absl::OkStatus();
+}
+
+absl::Status BlockReader::Seek(int64_t index) {
+  if (index < 0 || index > num_elements_) {
+    return absl::OutOfRangeError(
+        absl::StrCat("Cannot seek to element ", index, " of snapshot file ",
+                     filename_, ", which has ", num_elements_, " elements."));
+  }
+  // Elements are moved out of the current block when read, so it must be
+  // decoded again to seek backwards.
+  if (index < next_element_) {
+    current_block_ = -1;
+  }
+  next_element_ = index;
+  return absl::OkStatus();
+}
+
+absl::Status BlockReader::SkipRecords(int64_t num_records) {
+  if (num_records > num_elements_ - next_element_) {
+    next_element_ = num_elements_;
+    return absl::OutOfRangeError("End of file");
+  }
+  return Seek(next_element_ + num_records);
+}
+
 absl::Status WriteMetadataFile(
     Env* env, const std::string& dir,
     const experimental::SnapshotMetadataRecord* metadata) {
@@ -173,6 +173,68 @@ class CustomWriter : public Writer {
   int num_complex_ = 0;
 };
 
+// Writes snapshots with a block-compressed file format (version 3) that
+// supports random access.
+//
+// Elements are serialized into blocks of about `block_size_bytes` uncompressed
+// bytes, and each block is compressed on its own. The file ends with an index
+// holding the offset and element count of every block, followed by a
+// fixed-size footer, so that `BlockReader` can seek to any element without
+// decompressing the blocks before it and can decompress blocks in parallel.
+//
+// File layout:
+//   block*: compressed elements, masked CRC32C of the compressed elements (4)
+//   index: for each block, its offset, compressed size, uncompressed size and
+//     number of elements (8 each)
+//   footer: index offset (8), number of blocks (8), masked CRC32C of the
+//     index (4), compression (4), magic number (8)
+//
+// Each element in a block is a sequence of length-prefixed (varint64)
+// serialized `TensorProto`s, one per component.
+class BlockWriter : public Writer {
+ public:
+  static constexpr const size_t kDefaultBlockSizeBytes = 4 << 20;  // 4 MiB
+  static constexpr const size_t kBlockChecksumSize = sizeof(uint32_t);
+  static constexpr const size_t kIndexEntrySize = 4 * sizeof(uint64_t);
+  static constexpr const size_t kFooterSize = 32;
+  static constexpr const uint64_t kMagic = 0x334b4c424e534654;  // "TFSNBLK3"
+
+  // Values of the compression field of the footer.
+  enum Compression : uint32_t { kNone = 0, kSnappy = 1 };
+
+  BlockWriter(const std::string& filename, const std::string& compression_type,
+              size_t block_size_bytes = kDefaultBlockSizeBytes);
+
+  absl::Status WriteTensors(const std::vector<Tensor>& tensors) override;
+
+  // Compresses and writes the elements written so far as a block.
+  absl::Status Sync() override;
+
+  // Writes the last block, the index and the footer. A file is only readable
+  // once it has been closed.
+  absl::Status Close() override;
+
+  ~BlockWriter() override;
+
+ protected:
+  absl::Status Initialize(tensorflow::Env* env) override;
+
+ private:
+  absl::Status FlushBlock();
+
+  const std::string filename_;
+  const std::string compression_type_;
+  const size_t block_size_bytes_;
+  std::unique_ptr<WritableFile> dest_;
+  Compression compression_ = kNone;
+  // Serialized elements of the block being built.
+  std::string block_;
+  uint64_t block_num_elements_ = 0;
+  uint64_t offset_ = 0;
+  std::string index_;
+  uint64_t num_blocks_ = 0;
+};
+
 // Interface class for reading snapshot files previous written with Writer.
 class Reader {
  public:
@@ -366,6 +428,63 @@ class CustomReader : public Reader {
   std::vector<bool> simple_tensor_mask_;  // true for simple, false for complex.
 };
 
+// Reads snapshots previously written with `BlockWriter`.
+class BlockReader : public Reader {
+ public:
+  // The compression type is recorded in the file, so it is not an argument.
+  BlockReader(const std::string& filename, const DataTypeVector& dtypes);
+
+  // Reads Tensors into `read_tensors`. Returns OK on success, OutOfRange for
+  // end of file, or an error status if there is an error.
+  absl::Status ReadTensors(std::vector<Tensor>* read_tensors) override;
+
+  // Skips `num_records` without decompressing the skipped blocks.
+  absl::Status SkipRecords(int64_t num_records) override;
+
+  // Positions the reader before the element at `index`. Seeking to
+  // `num_elements()` positions the reader at the end of the file.
+  absl::Status Seek(int64_t index);
+
+  int64_t num_elements() const { return num_elements_; }
+  int64_t num_blocks() const { return blocks_.size(); }
+
+  // Returns the index of the block that contains the element at `index`.
+  int64_t BlockForElement(int64_t index) const;
+
+  // Reads and decompresses the elements of block `block_index`. Does not
+  // change the position of the reader and is thread-safe, so that callers can
+  // decompress several blocks in parallel.
+  absl::Status ReadBlock(int64_t block_index,
+                         std::vector<std::vector<Tensor>>* elements) const;
+
+ protected:
+  absl::Status Initialize(Env* env) override;
+
+ private:
+  struct Block {
+    uint64_t offset;
+    uint64_t size;
+    uint64_t uncompressed_size;
+    // Index of the first element of the block in the file.
+    int64_t first_element;
+    int64_t num_elements;
+  };
+
+  absl::Status Corrupted(absl::string_view reason) const;
+
+  const std::string filename_;
+  const DataTypeVector dtypes_;
+  std::unique_ptr<RandomAccessFile> file_;
+  BlockWriter::Compression compression_ = BlockWriter::kNone;
+  std::vector<Block> blocks_;
+  int64_t num_elements_ = 0;
+  // Index of the next element to read.
+  int64_t next_element_ = 0;
+  // The decoded elements of block `current_block_`, if non-negative.
+  int64_t current_block_ = -1;
+  std::vector<std::vector<Tensor>> current_elements_;
+};
+
 // Writes snapshot metadata to the given directory.
 absl::Status WriteMetadataFile(
     Env* env, const std::string& dir,
@@ -15,6 +15,7 @@ limitations under the License.
 
 #include "tensorflow/core/data/snapshot_utils.h"
 
+#include <cstdint>
 #include <memory>
 #include <string>
 #include <vector>
@@ -28,6 +29,7 @@ limitations under the License.
 #include "tensorflow/core/platform/logging.h"
 #include "tensorflow/core/platform/test.h"
 #include "tensorflow/core/platform/test_benchmark.h"
+#include "tensorflow/core/platform/threadpool.h"
 
 namespace tensorflow {
 namespace data {
@@ -98,6 +100,123 @@ TEST(SnapshotUtilTest, CombinationRoundTripTest) {
   SnapshotRoundTrip(io::compression::kNone, 2);
   SnapshotRoundTrip(io::compression::kGzip, 2);
   SnapshotRoundTrip(io::compression::kSnappy, 2);
+
+  SnapshotRoundTrip(io::compression::kNone, 3);
+  SnapshotRoundTrip(io::compression::kSnappy, 3);
+}
+
+class TestBlockWriter : public BlockWriter {
+ public:
+  using BlockWriter::BlockWriter;
+  using BlockWriter::Initialize;
+};
+
+// Writes `num_elements` scalar int64 elements holding their index to a
+// version 3 file with blocks of about `block_size_bytes` bytes.
+std::string WriteBlockSnapshot(int64_t num_elements, size_t block_size_bytes) {
+  std::string filename = LocalTempFilename();
+  TestBlockWriter writer(filename, io::compression::kSnappy, block_size_bytes);
+  TF_CHECK_OK(writer.Initialize(Env::Default()));
+  for (int64_t i = 0; i < num_elements; ++i) {
+    TF_CHECK_OK(writer.WriteTensors({Tensor(i)}));
+  }
+  TF_CHECK_OK(writer.Close());
+  return filename;
+}
+
+TEST(SnapshotUtilTest, BlockReaderSeekAndSkip) {
+  const std::string filename =
+      WriteBlockSnapshot(/*num_elements=*/1000, /*block_size_bytes=*/256);
+  std::unique_ptr<Reader> reader;
+  TF_ASSERT_OK(Reader::Create(Env::Default(), filename,
+                              io::compression::kSnappy, 3, {DT_INT64},
+                              &reader));
+  auto* block_reader = static_cast<BlockReader*>(reader.get());
+  EXPECT_EQ(block_reader->num_elements(), 1000);
+  EXPECT_GT(block_reader->num_blocks(), 1);
+
+  std::vector<Tensor> read_tensors;
+  TF_ASSERT_OK(block_reader->Seek(617));
+  TF_ASSERT_OK(block_reader->ReadTensors(&read_tensors));
+  EXPECT_EQ(read_tensors[0].scalar<int64_t>()(), 617);
+  TF_ASSERT_OK(block_reader->SkipRecords(300));
+  TF_ASSERT_OK(block_reader->ReadTensors(&read_tensors));
+  EXPECT_EQ(read_tensors[0].scalar<int64_t>()(), 918);
+  // Seeking backwards re-reads the current block.
+  TF_ASSERT_OK(block_reader->Seek(917));
+  TF_ASSERT_OK(block_reader->ReadTensors(&read_tensors));
+  EXPECT_EQ(read_tensors[0].scalar<int64_t>()(), 917);
+
+  EXPECT_TRUE(absl::IsOutOfRange(block_reader->SkipRecords(1000)));
+  EXPECT_TRUE(absl::IsOutOfRange(block_reader->ReadTensors(&read_tensors)));
+  EXPECT_TRUE(absl::IsOutOfRange(block_reader->Seek(1001)));
+  TF_ASSERT_OK(Env::Default()->DeleteFile(filename));
+}
+
+TEST(SnapshotUtilTest, BlockReaderParallelReadBlock) {
+  const std::string filename =
+      WriteBlockSnapshot(/*num_elements=*/1000, /*block_size_bytes=*/256);
+  std::unique_ptr<Reader> reader;
+  TF_ASSERT_OK(Reader::Create(Env::Default(), filename,
+                              io::compression::kSnappy, 3, {DT_INT64},
+                              &reader));
+  auto* block_reader = static_cast<BlockReader*>(reader.get());
+
+  std::vector<std::vector<std::vector<Tensor>>> blocks(
+      block_reader->num_blocks());
+  std::vector<absl::Status> statuses(block_reader->num_blocks());
+  {
+    thread::ThreadPool pool(Env::Default(), "read_block", 4);
+    for (int64_t i = 0; i < block_reader->num_blocks(); ++i) {
+      pool.Schedule([&, i]() {
+        statuses[i] = block_reader->ReadBlock(i, &blocks[i]);
+      });
+    }
+  }
+  int64_t next = 0;
+  for (int64_t i = 0; i < blocks.size(); ++i) {
+    TF_ASSERT_OK(statuses[i]);
+    for (const std::vector<Tensor>& element : blocks[i]) {
+      EXPECT_EQ(block_reader->BlockForElement(next), i);
+      EXPECT_EQ(element[0].scalar<int64_t>()(), next++);
+    }
+  }
+  EXPECT_EQ(next, 1000);
+  TF_ASSERT_OK(Env::Default()->DeleteFile(filename));
+}
+
+TEST(SnapshotUtilTest, BlockReaderDetectsCorruption) {
+  const std::string filename =
+      WriteBlockSnapshot(/*num_elements=*/100, /*block_size_bytes=*/256);
+  std::string contents;
+  TF_ASSERT_OK(ReadFileToString(Env::Default(), filename, &contents));
+
+  // Flip a byte of the first block.
+  std::string corrupted = contents;
+  corrupted[1] ^= 0x1;
+  TF_ASSERT_OK(WriteStringToFile(Env::Default(), filename, corrupted));
+  std::unique_ptr<Reader> reader;
+  TF_ASSERT_OK(Reader::Create(Env::Default(), filename,
+                              io::compression::kSnappy, 3, {DT_INT64},
+                              &reader));
+  std::vector<Tensor> read_tensors;
+  EXPECT_TRUE(absl::IsDataLoss(reader->ReadTensors(&read_tensors)));
+
+  // Flip a byte of the index.
+  corrupted = contents;
+  corrupted[corrupted.size() - BlockWriter::kFooterSize - 1] ^= 0x1;
+  TF_ASSERT_OK(WriteStringToFile(Env::Default(), filename, corrupted));
+  EXPECT_TRUE(absl::IsDataLoss(Reader::Create(Env::Default(), filename,
+                                              io::compression::kSnappy, 3,
+                                              {DT_INT64}, &reader)));
+
+  // Truncate the footer.
+  TF_ASSERT_OK(WriteStringToFile(Env::Default(), filename,
+                                 contents.substr(0, contents.size() - 1)));
+  EXPECT_TRUE(absl::IsDataLoss(Reader::Create(Env::Default(), filename,
+                                              io::compression::kSnappy, 3,
+                                              {DT_INT64}, &reader)));
+  TF_ASSERT_OK(Env::Default()->DeleteFile(filename));
 }
 
 TEST(SnapshotUtilTest, MetadataFileRoundTrip) {
@@ -200,11 +319,21 @@ void SnapshotTFRecordReaderGzipBenchmark(::testing::benchmark::State& state) {
   SnapshotReaderBenchmarkLoop(state, io::compression::kGzip, 2);
 }
 
+void SnapshotBlockReaderNoneBenchmark(::testing::benchmark::State& state) {
+  SnapshotReaderBenchmarkLoop(state, io::compression::kNone, 3);
+}
+
+void SnapshotBlockReaderSnappyBenchmark(::testing::benchmark::State& state) {
+  SnapshotReaderBenchmarkLoop(state, io::compression::kSnappy, 3);
+}
+
 BENCHMARK(SnapshotCustomReaderNoneBenchmark);
 BENCHMARK(SnapshotCustomReaderGzipBenchmark);
 BENCHMARK(SnapshotCustomReaderSnappyBenchmark);
 BENCHMARK(SnapshotTFRecordReaderNoneBenchmark);
 BENCHMARK(SnapshotTFRecordReaderGzipBenchmark);
+BENCHMARK(SnapshotBlockReaderNoneBenchmark);
+BENCHMARK(SnapshotBlockReaderSnappyBenchmark);
 
 void SnapshotWriterBenchmarkLoop(::testing::benchmark::State& state,
                                  std::string compression_type, int version) {
@@ -251,12 +380,22 @@ void SnapshotTFRecordWriterSnappyBenchmark(::testing::benchmark::State& state) {
   SnapshotWriterBenchmarkLoop(state, io::compression::kSnappy, 2);
 }
 
+void SnapshotBlockWriterNoneBenchmark(::testing::benchmark::State& state) {
+  SnapshotWriterBenchmarkLoop(state, io::compression::kNone, 3);
+}
+
+void SnapshotBlockWriterSnappyBenchmark(::testing::benchmark::State& state) {
+  SnapshotWriterBenchmarkLoop(state, io::compression::kSnappy, 3);
+}
+
 BENCHMARK(SnapshotCustomWriterNoneBenchmark);
 BENCHMARK(SnapshotCustomWriterGzipBenchmark);
 BENCHMARK(SnapshotCustomWriterSnappyBenchmark);
 BENCHMARK(SnapshotTFRecordWriterNoneBenchmark);
 BENCHMARK(SnapshotTFRecordWriterGzipBenchmark);
 BENCHMARK(SnapshotTFRecordWriterSnappyBenchmark);
+BENCHMARK(SnapshotBlockWriterNoneBenchmark);
+BENCHMARK(SnapshotBlockWriterSnappyBenchmark);
 
 }  // namespace
 }  // namespace snapshot_util
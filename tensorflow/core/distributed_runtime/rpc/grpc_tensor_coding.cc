@@ -16,6 +16,10 @@ limitations under the License.
 #include "tensorflow/core/distributed_runtime/rpc/grpc_tensor_coding.h"
 
 #include <cstddef>
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
 
 #include "grpcpp/impl/codegen/byte_buffer.h"
 #include "grpcpp/support/byte_buffer.h"
@@ -28,7 +32,9 @@ limitations under the License.
 #include "tensorflow/core/framework/tensor_shape.pb.h"
 #include "tensorflow/core/lib/gtl/inlined_vector.h"
 #include "tensorflow/core/lib/io/proto_encode_helper.h"
+#include "tensorflow/core/platform/coding.h"
 #include "tensorflow/core/platform/env.h"
+#include "tensorflow/core/platform/tstring.h"
 #include "tensorflow/core/protobuf/worker.pb.h"
 
 namespace tensorflow {
@@ -138,17 +144,111 @@ static void EncodeSkeleton(const Tensor& val, io::ProtoEncodeHelper* e) {
 #endif
 }
 
+// Tensor data (or, for DT_STRING tensors, individual strings) larger than
+// this is shared with the ByteBuffer instead of being copied into it.
+static constexpr int kLargeTensorBytes = 1024;
+static constexpr int64_t kProtoBufLimitBytes = 1LL << 31;
+
+static absl::Status ProtoBufLimitError(int64_t bytes) {
+  return absl::InternalError(absl::StrCat(
+      "Cannot encode a Tensor that exceeds the 2GB protobuf limit. ",
+      "Exceeded bytes: ", bytes - kProtoBufLimitBytes));
+}
+
+// Appends to "*slices" a slice that shares "size" bytes at "data", which are
+// owned by the backing store of "val".
+static void AppendSharedSlice(const Tensor& val, const char* data, size_t size,
+                              std::vector<::grpc::Slice>* slices) {
+  const TensorBuffer* buf = DMAHelper::buffer(&val);
+  buf->Ref();
+  slices->emplace_back(
+      const_cast<void*>(static_cast<const void*>(data)), size,
+      [](void* backing) { static_cast<TensorBuffer*>(backing)->Unref(); },
+      const_cast<TensorBuffer*>(buf));
+}
+
+// Moves "*bytes" into a slice appended to "*slices", without copying it.
+static void AppendOwnedSlice(std::string* bytes,
+                             std::vector<::grpc::Slice>* slices) {
+  if (bytes->empty()) return;
+  auto* owned = new std::string(std::move(*bytes));
+  bytes->clear();
+  slices->emplace_back(
+      owned->data(), owned->size(),
+      [](void* backing) { delete static_cast<std::string*>(backing); }, owned);
+}
+
+// Encodes a DT_STRING "val" the way Tensor::AsProtoTensorContent() does, i.e.
+// as a tensor_content holding the varint32 lengths of all strings followed by
+// their bytes, but straight into slices instead of through a TensorProto.
+// Strings larger than "kLargeTensorBytes" whose bytes are owned by the tensor
+// are shared with "*result"; everything else is copied once.
+static absl::Status EncodeStringTensorToByteBuffer(
+    const RecvTensorResponse& response, const Tensor& val,
+    ::grpc::ByteBuffer* result) {
+  const auto strings = val.flat<tstring>();
+  const int64_t num_strings = strings.size();
+  int64_t content_bytes = 0;
+  for (int64_t i = 0; i < num_strings; ++i) {
+    content_bytes += core::VarintLength(strings(i).size()) + strings(i).size();
+  }
+  if (content_bytes > kProtoBufLimitBytes) {
+    return ProtoBufLimitError(content_bytes);
+  }
+
+  absl::InlinedVector<char, 128UL> skeleton(
+      SkeletonEncodingSizeUpperBound(val));
+  io::ProtoEncodeHelper e_skeleton(skeleton.data(), skeleton.size());
+  EncodeSkeleton(val, &e_skeleton);
+  uint32_t overall_tensor_proto_bytesize =
+      (e_skeleton.size() +
+       VarLengthEncodingSize(TensorProto::kTensorContentFieldNumber,
+                             content_bytes));
+
+  // (A) through (D2), as for other dtypes.
+  std::string header;
+  response.AppendToString(&header);
+  static const int kVarintMax32 = 5;  // Max length of varint32 encoding
+  absl::InlinedVector<char, 1024UL> space(header.size() + e_skeleton.size() +
+                                          4 * kVarintMax32);
+  io::ProtoEncodeHelper e(space.data(), space.size());
+  e.WriteRawBytes(header);
+  e.WriteVarlengthBeginning(RecvTensorResponse::kTensorFieldNumber,
+                            overall_tensor_proto_bytesize);
+  e.WriteRawBytes(absl::string_view(e_skeleton.data(), e_skeleton.size()));
+  e.WriteVarlengthBeginning(TensorProto::kTensorContentFieldNumber,
+                            content_bytes);
+
+  // The string lengths, which start the tensor_content.
+  std::string pending(e.data(), e.size());
+  for (int64_t i = 0; i < num_strings; ++i) {
+    core::PutVarint32(&pending, strings(i).size());
+  }
+
+  // (E) The string bytes. Only LARGE strings own heap storage that lives as
+  // long as the tensor buffer; the others are inline or views.
+  std::vector<::grpc::Slice> slices;
+  for (int64_t i = 0; i < num_strings; ++i) {
+    const tstring& s = strings(i);
+    if (s.type() == tstring::LARGE && s.size() > kLargeTensorBytes) {
+      AppendOwnedSlice(&pending, &slices);
+      AppendSharedSlice(val, s.data(), s.size(), &slices);
+    } else {
+      pending.append(s.data(), s.size());
+    }
+  }
+  AppendOwnedSlice(&pending, &slices);
+
+  ::grpc::ByteBuffer tmp(slices.data(), slices.size());
+  result->Swap(&tmp);
+  return absl::OkStatus();
+}
+
 absl::Status EncodeTensorToByteBuffer(bool is_dead, const Tensor& val,
                                       bool require_ack,
                                       ::grpc::ByteBuffer* result) {
-  const int kLargeTensorBytes = 1024;
-  const int64_t kProtoBufLimitBytes = 1LL << 31;
-
   if (val.TotalBytes() > kProtoBufLimitBytes) {
-    size_t exceeded_bytes = val.TotalBytes() - kProtoBufLimitBytes;
-    return absl::InternalError(absl::StrCat(
-        "Cannot encode a Tensor that exceeds the 2GB protobuf limit. ",
-        "Exceeded bytes: ", exceeded_bytes));
+    return ProtoBufLimitError(val.TotalBytes());
   }
 
   RecvTensorResponse response;
@@ -157,7 +257,9 @@ absl::Status EncodeTensorToByteBuffer(bool is_dead, const Tensor& val,
   }
   response.set_require_ack(require_ack);
   response.set_send_start_micros(Env::Default()->NowMicros());
-  if (!DataTypeCanUseMemcpy(val.dtype())) {
+  if (val.dtype() == DT_STRING) {
+    return EncodeStringTensorToByteBuffer(response, val, result);
+  } else if (!DataTypeCanUseMemcpy(val.dtype())) {
     // Straightforward but slow path for complicated kinds of tensor data
     // TODO(jeff,sanjay): If this becomes an issue, we could
     // go directly from val -> ByteBuffer, with some effort.
@@ -15,6 +15,9 @@ limitations under the License.
 
 #include "tensorflow/core/distributed_runtime/rpc/grpc_tensor_coding.h"
 
+#include <string>
+#include <vector>
+
 #include "grpcpp/support/byte_buffer.h"
 #include "grpcpp/support/slice.h"
 #include "absl/status/status.h"
@@ -103,6 +106,32 @@ TEST_F(GrpcTensorCodingTest, Simple) {
 
 TEST_F(GrpcTensorCodingTest, StringTensor) { DoTestForStrings(DT_STRING); }
 
+TEST_F(GrpcTensorCodingTest, LargeStrings) {
+  // Mix strings that are copied with strings that are large enough to share.
+  Tensor a(DT_STRING, TensorShape({2, 3}));
+  auto strings = a.flat<tstring>();
+  for (int i = 0; i < strings.size(); ++i) {
+    strings(i) = std::string(i % 2 == 0 ? 10 : 5000 + i, 'a' + i);
+  }
+  Validate(a, false);
+
+  ::grpc::ByteBuffer buf;
+  TF_ASSERT_OK(grpc::EncodeTensorToByteBuffer(/*is_dead=*/false, a,
+                                              /*require_ack=*/false, &buf));
+  std::vector<::grpc::Slice> slices;
+  ASSERT_TRUE(buf.Dump(&slices).ok());
+  // Each large string has a slice of its own that points into the tensor.
+  int num_shared = 0;
+  for (const auto& slice : slices) {
+    for (int i = 1; i < strings.size(); i += 2) {
+      if (reinterpret_cast<const char*>(slice.begin()) == strings(i).data()) {
+        ++num_shared;
+      }
+    }
+  }
+  EXPECT_EQ(num_shared, 3);
+}
+
 TEST_F(GrpcTensorCodingTest, LargeTensor) {
   Tensor t(DT_INT8, TensorShape({1, 1 + (1LL << 31)}));
   ::grpc::ByteBuffer buf;
@@ -240,6 +240,53 @@ static void BM_RPC(::testing::benchmark::State& state) {
 }
 BENCHMARK(BM_RPC)->ArgPair(30, 2)->ArgPair(30, 1000)->ArgPair(30, 100000);
 
+// Sends a DT_STRING tensor holding state.range(1) bytes in strings of
+// state.range(0) bytes each to a second worker, which returns the total length
+// of the strings. Measures the cost of string tensor encoding and decoding
+// across RPCs.
+static void BM_RecvStringTensor(::testing::benchmark::State& state) {
+  const int string_size = state.range(0);
+  const int num_strings = state.range(1) / string_size;
+  const Cluster* cluster = GetCluster();
+
+  using namespace ::tensorflow::ops;  // NOLINT(build/namespaces)
+  Scope s = Scope::NewRootScope();
+  Output x = Const(s.WithOpName("x"), tstring(), {num_strings});
+  Output lengths =
+      StringLength(s.WithDevice(cluster->devices[1].name()), x);
+  Sum(s.WithOpName("y"), lengths, 0);
+  GraphDef def;
+  TF_CHECK_OK(s.ToGraphDef(&def));
+  graph::SetDefaultDevice(cluster->devices[0].name(), &def);
+
+  std::unique_ptr<Session> session(NewSession(cluster->options));
+  TF_CHECK_OK(session->Create(def));
+  Tensor strings(DT_STRING, TensorShape({num_strings}));
+  auto flat = strings.flat<tstring>();
+  for (int i = 0; i < num_strings; ++i) {
+    flat(i) = std::string(string_size, 'a' + i % 26);
+  }
+
+  std::vector<Tensor> outputs;
+  for (int i = 0; i < 3; i++) {
+    TF_CHECK_OK(session->Run({{"x", strings}}, {"y:0"}, {}, &outputs));
+  }
+  for (auto _ : state) {
+    outputs.clear();
+    TF_CHECK_OK(session->Run({{"x", strings}}, {"y:0"}, {}, &outputs));
+    CHECK_EQ(outputs[0].scalar<int32_t>()(),
+             static_cast<int32_t>(num_strings) * string_size);
+  }
+  TF_CHECK_OK(session->Close());
+  state.SetBytesProcessed(state.iterations() * num_strings * string_size);
+}
+BENCHMARK(BM_RecvStringTensor)
+    ->ArgPair(16, 1 << 20)
+    ->ArgPair(1 << 10, 1 << 20)
+    ->ArgPair(64 << 10, 1 << 20)
+    ->ArgPair(1 << 10, 64 << 20)
+    ->ArgPair(64 << 10, 64 << 20);
+
 static void BM_SingleDevice(::testing::benchmark::State& state) {
   const int width = state.range(0);
   const int num_stages = state.range(1);
@@ -15,6 +15,9 @@ limitations under the License.
 
 #include "tensorflow/core/distributed_runtime/tensor_coding.h"
 
+#include <cstdint>
+#include <vector>
+
 #include "google/protobuf/any.pb.h"
 #include "absl/status/status.h"
 #include "xla/tsl/platform/errors.h"
@@ -23,7 +26,9 @@ limitations under the License.
 #include "tensorflow/core/framework/tensor.pb.h"
 #include "tensorflow/core/framework/tensor_shape.h"
 #include "tensorflow/core/framework/tensor_shape.pb.h"
+#include "tensorflow/core/platform/coding.h"
 #include "tensorflow/core/platform/errors.h"
+#include "tensorflow/core/platform/tstring.h"
 
 namespace tensorflow {
 
@@ -149,6 +154,28 @@ bool ReadNestedMessage(protobuf::io::CodedInputStream* input,
   return input->DecrementRecursionDepthAndPopLimit(p.first);
 }
 
+// Decodes the "num_bytes" bytes of tensor_content of a DT_STRING tensor, as
+// encoded by port::EncodeStringList(), directly into the strings of "*t".
+bool ReadStringTensorContent(protobuf::io::CodedInputStream* input,
+                             int num_bytes, Tensor* t) {
+  auto strings = t->flat<tstring>();
+  const int64_t num_strings = strings.size();
+  // Every string takes at least one byte for its length.
+  if (num_strings > num_bytes) return false;
+  std::vector<uint32_t> sizes(num_strings);
+  int64_t total_bytes = 0;
+  for (uint32_t& size : sizes) {
+    if (!input->ReadVarint32(&size)) return false;
+    total_bytes += core::VarintLength(size) + size;
+  }
+  if (total_bytes != num_bytes) return false;
+  for (int64_t i = 0; i < num_strings; ++i) {
+    strings(i).resize_uninitialized(sizes[i]);
+    if (!input->ReadRaw(strings(i).mdata(), sizes[i])) return false;
+  }
+  return true;
+}
+
 }  // namespace
 
 bool TensorResponse::ParseTensorSubmessage(
@@ -178,7 +205,10 @@ bool TensorResponse::ParseTensorSubmessage(
         if ((wt != WIRETYPE_VARINT) || !input->ReadVarint32(&v)) return false;
         if (seen_tensor_content) return false;
         tensor_meta->set_dtype(static_cast<DataType>(static_cast<int>(v)));
-        if (!DataTypeCanUseMemcpy(tensor_meta->dtype())) return false;
+        if (!DataTypeCanUseMemcpy(tensor_meta->dtype()) &&
+            tensor_meta->dtype() != DT_STRING) {
+          return false;
+        }
         break;
       }
       case TensorProto::kTensorShapeFieldNumber: {
@@ -212,6 +242,11 @@ bool TensorResponse::ParseTensorSubmessage(
           return false;
         }
         Tensor t(allocator_, tensor_meta->dtype(), shape);
+        if (t.dtype() == DT_STRING) {
+          if (!ReadStringTensorContent(input, num_bytes, &t)) return false;
+          tensor_ = std::move(t);
+          break;
+        }
         absl::string_view buf = t.tensor_data();
         if (static_cast<size_t>(num_bytes) != buf.size()) return false;
         // TODO(jeff,sanjay): Figure out a way to avoid this copy if
@@ -159,6 +159,32 @@ TEST_F(TensorResponseTest, Simple) {
 
 TEST_F(TensorResponseTest, StringTensor) { DoTestForStrings(DT_STRING); }
 
+TEST_F(TensorResponseTest, LargeStrings) {
+  Tensor a(DT_STRING, TensorShape({3, 2}));
+  auto strings = a.flat<tstring>();
+  for (int i = 0; i < strings.size(); ++i) {
+    strings(i) = std::string(i % 2 == 0 ? i : 100000 + i, 'a' + i);
+  }
+  Validate(a, false, true);
+}
+
+TEST_F(TensorResponseTest, StringContentSizeMismatch) {
+  RecvTensorResponse proto;
+  test::AsTensor<tstring>({"abc", "de"}).AsProtoTensorContent(
+      proto.mutable_tensor());
+  // Drop the last byte of the string data.
+  std::string* content = proto.mutable_tensor()->mutable_tensor_content();
+  content->pop_back();
+  std::string encoded;
+  proto.AppendToString(&encoded);
+
+  StringSource source(&encoded, 1024);
+  TensorResponse response;
+  DummyDevice cpu_device(Env::Default());
+  response.InitAlloc(&cpu_device, AllocatorAttributes());
+  EXPECT_TRUE(absl::IsInvalidArgument(response.ParseFrom(&source)));
+}
+
 TEST_F(TensorResponseTest, InitPartialOverflow) {
   RecvTensorResponse response;
   TensorProto* tensor_proto = response.mutable_tensor();
@@ -0,0 +1,66 @@
+/* Copyright 2026 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef TENSORFLOW_CORE_FRAMEWORK_MAPPED_TENSOR_BUFFER_H_
+#define TENSORFLOW_CORE_FRAMEWORK_MAPPED_TENSOR_BUFFER_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <utility>
+
+#include "absl/strings/string_view.h"
+#include "tensorflow/core/framework/allocation_description.pb.h"
+#include "tensorflow/core/framework/tensor.h"
+
+namespace tensorflow {
+
+// MappedTensorBuffer is a TensorBuffer that aliases `size` bytes at `data` of
+// read-only memory owned by `owner`, e.g. a memory-mapped file or a shared
+// memory segment. Every buffer holds a reference on `owner`, so the memory
+// stays mapped until the last tensor aliasing it is released.
+class MappedTensorBuffer : public TensorBuffer {
+ public:
+  MappedTensorBuffer(std::shared_ptr<const void> owner, const char* data,
+                     size_t size, absl::string_view allocator_name = "mmap")
+      : TensorBuffer(const_cast<char*>(data)),
+        owner_(std::move(owner)),
+        size_(size),
+        allocator_name_(allocator_name) {}
+
+  size_t size() const override { return size_; }
+
+  TensorBuffer* root_buffer() override { return this; }
+
+  void FillAllocationDescription(AllocationDescription* proto) const override {
+    proto->set_requested_bytes(static_cast<int64_t>(size_));
+    proto->set_allocator_name(allocator_name_);
+    proto->set_ptr(reinterpret_cast<uintptr_t>(data()));
+  }
+
+  // The memory is read-only and may be shared with other processes, so the
+  // buffer must never be forwarded to a kernel output and written in place.
+  bool OwnsMemory() const override { return false; }
+
+ private:
+  const std::shared_ptr<const void> owner_;
+  const size_t size_;
+  const std::string allocator_name_;
+};
+
+}  // namespace tensorflow
+
+#endif  // TENSORFLOW_CORE_FRAMEWORK_MAPPED_TENSOR_BUFFER_H_
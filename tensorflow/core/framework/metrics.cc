@@ -38,6 +38,21 @@ auto* persistent_cache_load_count = tsl::monitoring::Counter<0>::New(
     "/tensorflow/core/persistent_cache_load_count",
     "The number of times a binary is loaded from the persistent cache.");
 
+auto* xla_compilation_cache_lookup_count = tsl::monitoring::Counter<1>::New(
+    "/tensorflow/core/xla_compilation_cache_lookup_count",
+    "The number of lookups of a compiled cluster in the XLA compilation "
+    "cache.",
+    "result");
+
+auto* xla_compilation_cache_eviction_count = tsl::monitoring::Counter<0>::New(
+    "/tensorflow/core/xla_compilation_cache_eviction_count",
+    "The number of executables evicted from the XLA compilation cache.");
+
+auto* xla_compilation_cache_evicted_bytes = tsl::monitoring::Counter<0>::New(
+    "/tensorflow/core/xla_compilation_cache_evicted_bytes",
+    "The total size of the executables evicted from the XLA compilation "
+    "cache.");
+
 auto* aot_bef_mlir_load_count = tsl::monitoring::Counter<0>::New(
     "/tensorflow/core/aot_bef_mlir_load_count",
     "The number of times BEF and MLIR are deserialized instead of generated "
@@ -852,6 +867,21 @@ void UpdatePersistentCacheLoadCount() {
   persistent_cache_load_count_cell->IncrementBy(1);
 }
 
+void UpdateXlaCompilationCacheLookupCount(bool hit) {
+  static auto* hit_cell = xla_compilation_cache_lookup_count->GetCell("hit");
+  static auto* miss_cell = xla_compilation_cache_lookup_count->GetCell("miss");
+  (hit ? hit_cell : miss_cell)->IncrementBy(1);
+}
+
+void UpdateXlaCompilationCacheEvictionCount(int64_t executable_bytes) {
+  static auto* eviction_count_cell =
+      xla_compilation_cache_eviction_count->GetCell();
+  static auto* evicted_bytes_cell =
+      xla_compilation_cache_evicted_bytes->GetCell();
+  eviction_count_cell->IncrementBy(1);
+  evicted_bytes_cell->IncrementBy(executable_bytes);
+}
+
 void UpdateAotBefMlirLoadCount() {
   static auto* aot_bef_mlir_load_count_cell =
       aot_bef_mlir_load_count->GetCell();
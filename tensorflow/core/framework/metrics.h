@@ -302,6 +302,14 @@ void RecordPipelineProcessingTime(const std::string& id,
 // Increments the count of binaries loaded from the persistent cache.
 void UpdatePersistentCacheLoadCount();
 
+// Records a lookup of a cluster in the XLA compilation cache. `hit` is true if
+// the cluster was already compiled.
+void UpdateXlaCompilationCacheLookupCount(bool hit);
+
+// Records that an executable of `executable_bytes` was evicted from the XLA
+// compilation cache.
+void UpdateXlaCompilationCacheEvictionCount(int64_t executable_bytes);
+
 // Increments the count of BEF and MLIR deserialized.
 void UpdateAotBefMlirLoadCount();
 
@@ -19,10 +19,14 @@ limitations under the License.
 #include <cmath>
 #include <cstdint>
 #include <limits>
+#include <list>
 #include <memory>
 #include <optional>
 #include <queue>
+#include <string>
+#include <vector>
 
+#include "absl/status/status.h"
 #include "absl/time/clock.h"
 #include "tensorflow/core/framework/cancellation.h"
 #include "tensorflow/core/framework/metrics.h"
@@ -64,6 +68,19 @@ constexpr double kBufferDownsizeMultipliter = 0.9;
 // Threshold of low buffer watermark before a buffer is a candidate for
 // upsizing.
 constexpr int64_t kBufferLowWatermarkThreshold = 2;
+// Weight by which the observations of node cost models are multiplied each time
+// a new observation is added.
+constexpr double kCostModelDecay = 0.9;
+// Minimum number of elements a node needs to produce between two optimizations
+// for its per-element processing time to be used as a cost model observation.
+constexpr int64_t kMinCostObservationElements = 10;
+// Nodes that have produced fewer elements use the statistics of the warm-start
+// model, if any.
+constexpr int64_t kWarmStartMinElements = 100;
+// Minimum relative decrease of the time of the longest stage for the
+// learned-cost optimization to increase its parallelism. Contention makes the
+// time approach a floor, which additional threads barely improve.
+constexpr double kMinLearnedCostImprovement = 0.01;
 
 constexpr char kDataService[] = "DataService";
 constexpr char kFlatMap[] = "FlatMap";
@@ -403,6 +420,61 @@ absl::Status ModelFromProtoHelper(ModelProto model,
   return absl::OkStatus();
 }
 
+// Returns the key of the `index`-th input named `name` of the node with key
+// `parent_key`. Keys identify nodes by their position in the pipeline, so that
+// they match across runs of the same input pipeline, unlike node IDs.
+std::string InputNodeKey(absl::string_view parent_key, int64_t index,
+                         absl::string_view name) {
+  return absl::StrCat(parent_key, "/", index, ":", name);
+}
+
+// Returns the keys of the nodes of the tree rooted in `root`.
+absl::flat_hash_map<const Node*, std::string> NodeKeys(
+    std::shared_ptr<Node> root) {
+  absl::flat_hash_map<const Node*, std::string> keys;
+  keys[root.get()] = root->name();
+  std::list<std::shared_ptr<Node>> queue = {root};
+  while (!queue.empty()) {
+    std::shared_ptr<Node> node = queue.front();
+    queue.pop_front();
+    const std::string key = keys[node.get()];
+    int64_t index = 0;
+    for (const auto& input : node->inputs()) {
+      keys[input.get()] = InputNodeKey(key, index++, input->name());
+      queue.push_back(input);
+    }
+  }
+  return keys;
+}
+
+// Returns the keys of the nodes of `model_proto` by node ID.
+absl::flat_hash_map<int64_t, std::string> NodeKeys(
+    const ModelProto& model_proto) {
+  absl::flat_hash_map<int64_t, std::string> keys;
+  const auto& nodes = model_proto.nodes();
+  if (!nodes.contains(model_proto.output())) {
+    return keys;
+  }
+  keys[model_proto.output()] = nodes.at(model_proto.output()).name();
+  std::list<int64_t> queue = {model_proto.output()};
+  while (!queue.empty()) {
+    int64_t id = queue.front();
+    queue.pop_front();
+    const std::string key = keys[id];
+    int64_t index = 0;
+    for (int64_t input_id : nodes.at(id).inputs()) {
+      const int64_t input_index = index++;
+      auto it = nodes.find(input_id);
+      if (it == nodes.end() || keys.contains(input_id)) {
+        continue;
+      }
+      keys[input_id] = InputNodeKey(key, input_index, it->second.name());
+      queue.push_back(input_id);
+    }
+  }
+  return keys;
+}
+
 // The first input of InterleaveMany corresponds to the input dataset whose
 // elements are used to create the (derived) input datasets whose elements are
 // interleaved as output.
@@ -1970,6 +2042,17 @@ void Node::CollectBufferParametersToUpsize(
   }
 }
 
+void Node::RestoreStatistics(const ModelProto::Node& node_proto) {
+  mutex_lock l(mu_);
+  num_elements_.store(node_proto.num_elements());
+  processing_time_.store(node_proto.processing_time());
+  bytes_consumed_.store(node_proto.bytes_consumed());
+  bytes_produced_.store(node_proto.bytes_produced());
+  // Recomputes the per-element processing time from the restored statistics.
+  previous_processing_time_ = 0;
+  UpdateProcessingTimeEma();
+}
+
 void Node::SyncStateValuesToParameterValues(const std::string& parameter_name) {
   // We need to first collect the parameters because `parameter->state->mu` must
   // be locked before the node mutex `mu_`;
@@ -2351,6 +2434,17 @@ void Model::Optimize(AutotuneAlgorithm algorithm,
     snapshot = output_->Snapshot();
   }
   MaybeSyncStateValuesToValues(snapshot);
+  bool warm_start;
+  {
+    tf_shared_lock l(mu_);
+    warm_start = !warm_start_fname_.empty() || !warm_start_nodes_.empty();
+  }
+  if (algorithm == AutotuneAlgorithm::LEARNED_COST || warm_start) {
+    absl::flat_hash_map<const Node*, std::string> node_keys =
+        NodeKeys(snapshot);
+    RecordCostObservations(snapshot, node_keys);
+    ApplyWarmStart(snapshot, node_keys);
+  }
   int64_t total_ram_budget;
   if (fixed_ram_budget.has_value()) {
     total_ram_budget = fixed_ram_budget.value();
@@ -2402,6 +2496,10 @@ void Model::Optimize(AutotuneAlgorithm algorithm,
       OptimizeStageBased(snapshot, optimization_params, cancellation_manager,
                          ram_budget_manager);
       break;
+    case AutotuneAlgorithm::LEARNED_COST:
+      OptimizeLearnedCost(snapshot, optimization_params, cancellation_manager,
+                          ram_budget_manager);
+      break;
     default:
       VLOG(2) << "Autotuning algorithm was not recognized. Aborting "
                  "optimization.";
@@ -2566,17 +2664,18 @@ absl::Status Model::OptimizeLoop(AutotuneAlgorithm algorithm,
         current_time_ms = EnvTime::NowMicros() / EnvTime::kMillisToMicros;
       }
       if (cancellation_manager->IsCancelled()) {
-        return absl::OkStatus();
+        break;
       }
     }
 
     int64_t start_ms = EnvTime::NowMicros() / EnvTime::kMillisToMicros;
     double model_input_time = 0.0;
     // Model input time is set to 0 for all optimization algorithms except for
-    // stage-based optimization algorithm for historical reason. In stage-based
-    // optimization algorithm, the model input time is used as a target
+    // stage-based and learned-cost optimization algorithms for historical
+    // reason. In these algorithms, the model input time is used as a target
     // optimization time of all stages in the pipeline.
-    if (algorithm == AutotuneAlgorithm::STAGE_BASED) {
+    if (algorithm == AutotuneAlgorithm::STAGE_BASED ||
+        algorithm == AutotuneAlgorithm::LEARNED_COST) {
       model_input_time = ComputeTargetTimeNsec();
     }
     Optimize(algorithm, cpu_budget_func, ram_budget_share, fixed_ram_budget,
@@ -2586,15 +2685,24 @@ absl::Status Model::OptimizeLoop(AutotuneAlgorithm algorithm,
 
     // Exponentially increase the period of running the optimization until a
     // threshold is reached.
+    bool reached_max_period;
     {
       mutex_lock l(mu_);
+      reached_max_period = optimization_period_ms_ == kOptimizationPeriodMaxMs;
       optimization_period_ms_ =
           std::min(optimization_period_ms_ << 1, kOptimizationPeriodMaxMs);
     }
+    // Saves the model once optimizations are infrequent, so that a run which
+    // is interrupted still leaves a recent model for later runs.
+    if (reached_max_period) {
+      MaybeSaveWarmStart();
+    }
     current_time_ms = EnvTime::NowMicros() / EnvTime::kMillisToMicros;
     last_optimization_ms = current_time_ms;
     FlushMetrics();
   }
+  MaybeSaveWarmStart();
+  return absl::OkStatus();
 }
 
 void Model::OptimizeGradientDescent(
@@ -2756,6 +2864,234 @@ void Model::OptimizeHillClimbHelper(
     UpdateStateValues(&parameters);
   }
 }
+void NodeCostModel::RecordStatistics(int64_t num_elements,
+                                     int64_t processing_time,
+                                     double parallelism) {
+  if (last_num_elements_ < 0 || num_elements < last_num_elements_ ||
+      processing_time < last_processing_time_) {
+    // This is either the first call or the statistics were reset, e.g. because
+    // the iterator was recreated. The statistics are the base of the next
+    // observation.
+    last_num_elements_ = num_elements;
+    last_processing_time_ = processing_time;
+    return;
+  }
+  const int64_t delta_elements = num_elements - last_num_elements_;
+  if (delta_elements < kMinCostObservationElements) {
+    return;
+  }
+  if (parallelism >= 1.0) {
+    AddObservation(parallelism,
+                   static_cast<double>(processing_time - last_processing_time_) /
+                       static_cast<double>(delta_elements));
+  }
+  last_num_elements_ = num_elements;
+  last_processing_time_ = processing_time;
+}
+
+void NodeCostModel::AddObservation(double parallelism, double cost_nsec) {
+  weight_ = kCostModelDecay * weight_ + 1.0;
+  sum_parallelism_ = kCostModelDecay * sum_parallelism_ + parallelism;
+  sum_cost_ = kCostModelDecay * sum_cost_ + cost_nsec;
+  sum_parallelism_squared_ =
+      kCostModelDecay * sum_parallelism_squared_ + parallelism * parallelism;
+  sum_parallelism_cost_ =
+      kCostModelDecay * sum_parallelism_cost_ + parallelism * cost_nsec;
+}
+
+double NodeCostModel::PredictCostNsec(double parallelism) const {
+  if (empty()) {
+    return 0.0;
+  }
+  const double mean_parallelism = sum_parallelism_ / weight_;
+  const double mean_cost = sum_cost_ / weight_;
+  const double variance =
+      sum_parallelism_squared_ / weight_ - mean_parallelism * mean_parallelism;
+  // Observations at (nearly) a single parallelism value do not determine the
+  // slope.
+  constexpr double kMinVariance = 1e-3;
+  if (variance < kMinVariance) {
+    return mean_cost;
+  }
+  const double covariance =
+      sum_parallelism_cost_ / weight_ - mean_parallelism * mean_cost;
+  // A decreasing cost is attributed to noise rather than to parallelism, since
+  // predicting it would make the optimization maximize parallelism.
+  double slope = std::max(covariance / variance, 0.0);
+  double intercept = mean_cost - slope * mean_parallelism;
+  if (intercept < 0.0) {
+    // Fits a line through the origin and the mean observation instead, so that
+    // costs remain positive.
+    intercept = 0.0;
+    slope = mean_cost / mean_parallelism;
+  }
+  return intercept + slope * parallelism;
+}
+
+void NodeCostModel::ToProto(
+    ModelProto::Node::CostModel* cost_model_proto) const {
+  cost_model_proto->set_weight(weight_);
+  cost_model_proto->set_sum_parallelism(sum_parallelism_);
+  cost_model_proto->set_sum_cost(sum_cost_);
+  cost_model_proto->set_sum_parallelism_squared(sum_parallelism_squared_);
+  cost_model_proto->set_sum_parallelism_cost(sum_parallelism_cost_);
+}
+
+void NodeCostModel::FromProto(
+    const ModelProto::Node::CostModel& cost_model_proto) {
+  weight_ = cost_model_proto.weight();
+  sum_parallelism_ = cost_model_proto.sum_parallelism();
+  sum_cost_ = cost_model_proto.sum_cost();
+  sum_parallelism_squared_ = cost_model_proto.sum_parallelism_squared();
+  sum_parallelism_cost_ = cost_model_proto.sum_parallelism_cost();
+}
+
+void Model::RecordCostObservations(
+    std::shared_ptr<Node> snapshot,
+    const absl::flat_hash_map<const Node*, std::string>& node_keys) {
+  struct Statistics {
+    const std::string* key;
+    int64_t num_elements;
+    int64_t processing_time;
+    double parallelism;
+  };
+  Node::NodeVector nodes =
+      snapshot->CollectNodes(TraversalOrder::BFS, IsAnyNode);
+  nodes.push_back(snapshot);
+  NodeParallelismParameters node_parallelism;
+  std::vector<Statistics> statistics;
+  for (const auto& node : nodes) {
+    Parameter* parallelism = node_parallelism.Get(node.get());
+    if (parallelism == nullptr) {
+      continue;
+    }
+    // The state value is the parallelism the node ran with since the previous
+    // optimization. The state lock must be acquired before the model lock.
+    double parallelism_value;
+    {
+      tf_shared_lock l(*parallelism->state->mu);
+      parallelism_value = parallelism->state->value;
+    }
+    statistics.push_back({&node_keys.at(node.get()), node->num_elements(),
+                          node->processing_time(), parallelism_value});
+  }
+  mutex_lock l(mu_);
+  for (const Statistics& node_statistics : statistics) {
+    cost_models_[*node_statistics.key].RecordStatistics(
+        node_statistics.num_elements, node_statistics.processing_time,
+        node_statistics.parallelism);
+  }
+}
+
+void Model::ApplyWarmStart(
+    std::shared_ptr<Node> snapshot,
+    const absl::flat_hash_map<const Node*, std::string>& node_keys) {
+  Node::NodeVector nodes =
+      snapshot->CollectNodes(TraversalOrder::BFS, IsAnyNode);
+  nodes.push_back(snapshot);
+  tf_shared_lock l(mu_);
+  if (warm_start_nodes_.empty()) {
+    return;
+  }
+  for (const auto& node : nodes) {
+    if (node->num_elements() >= kWarmStartMinElements) {
+      continue;
+    }
+    auto it = warm_start_nodes_.find(node_keys.at(node.get()));
+    if (it == warm_start_nodes_.end() ||
+        it->second.num_elements() <= node->num_elements()) {
+      continue;
+    }
+    VLOG(3) << "Using the warm-start statistics of " << node->long_name();
+    node->RestoreStatistics(it->second);
+  }
+}
+
+void Model::WarmStart(const ModelProto& model_proto) {
+  absl::flat_hash_map<int64_t, std::string> node_keys = NodeKeys(model_proto);
+  mutex_lock l(mu_);
+  for (const auto& [id, key] : node_keys) {
+    const ModelProto::Node& node_proto = model_proto.nodes().at(id);
+    if (node_proto.has_cost_model()) {
+      cost_models_[key].FromProto(node_proto.cost_model());
+    }
+    warm_start_nodes_[key] = node_proto;
+  }
+  VLOG(2) << "Warm-started autotuning with " << node_keys.size()
+          << " recorded nodes.";
+}
+
+absl::Status Model::EnableWarmStart(const std::string& fname) {
+  ModelProto model_proto;
+  absl::Status status = ReadBinaryProto(Env::Default(), fname, &model_proto);
+  if (status.ok()) {
+    WarmStart(model_proto);
+  } else if (absl::IsNotFound(status)) {
+    VLOG(2) << "Autotuning performance model " << fname
+            << " does not exist yet; autotuning is not warm-started.";
+  } else {
+    return status;
+  }
+  mutex_lock l(mu_);
+  warm_start_fname_ = fname;
+  return absl::OkStatus();
+}
+
+absl::Status Model::SaveWarmStart(const std::string& fname) {
+  ModelProto model_proto;
+  {
+    tf_shared_lock l(mu_);
+    if (snapshot_ == nullptr) {
+      return absl::FailedPreconditionError(
+          "Cannot save the autotuning performance model before the first "
+          "optimization.");
+    }
+    TF_RETURN_IF_ERROR(ModelToProtoHelper(snapshot_, &model_proto));
+    model_proto.set_id_counter(id_counter_);
+    *model_proto.mutable_optimization_params() = optimization_params_;
+    if (dataset_name_.has_value()) {
+      model_proto.set_dataset_name(dataset_name_.value());
+    }
+    for (const auto& [id, key] : NodeKeys(model_proto)) {
+      auto it = cost_models_.find(key);
+      if (it != cost_models_.end() && !it->second.empty()) {
+        it->second.ToProto(
+            model_proto.mutable_nodes()->at(id).mutable_cost_model());
+      }
+    }
+  }
+  {
+    tf_shared_lock l(gap_mu_);
+    *model_proto.mutable_gap_times() = {gap_times_usec_.begin(),
+                                        gap_times_usec_.end()};
+  }
+  // Writes to a temporary file first, so that a run which reads the model
+  // concurrently or after an interrupted write does not see a partial model.
+  const std::string tmp_fname =
+      absl::StrCat(fname, ".tmp.", Env::Default()->NowMicros());
+  TF_RETURN_IF_ERROR(WriteBinaryProto(Env::Default(), tmp_fname, model_proto));
+  return Env::Default()->RenameFile(tmp_fname, fname);
+}
+
+void Model::MaybeSaveWarmStart() {
+  std::string fname;
+  {
+    tf_shared_lock l(mu_);
+    if (snapshot_ == nullptr) {
+      return;
+    }
+    fname = warm_start_fname_;
+  }
+  if (fname.empty()) {
+    return;
+  }
+  absl::Status status = SaveWarmStart(fname);
+  if (!status.ok()) {
+    LOG(WARNING) << "Failed to save the autotuning performance model to "
+                 << fname << ": " << status;
+  }
+}
+
 void Model::RecordIteratorGapTime(uint64_t duration_usec) {
   mutex_lock l(gap_mu_);
   // Drop duration if it is too large.
@@ -3019,6 +3355,154 @@ void Model::OptimizeStageBasedNonAsyncInterleaveManyNodes(
   }
 }
 
+void Model::OptimizeLearnedCost(std::shared_ptr<Node> snapshot,
+                                const OptimizationParams& optimization_params,
+                                CancellationManager* cancellation_manager,
+                                RamBudgetManager& ram_budget_manager) {
+  VLOG(2) << "Starting optimization of tunable parameters with learned node "
+             "costs and a target time of "
+          << optimization_params.model_input_time() << " nanoseconds.";
+  // A stage of the pipeline (see `ModelTiming`), whose root has its
+  // per-element processing time predicted by a cost model.
+  struct Stage {
+    Node* root;
+    // The `parallelism` parameter of the root, or nullptr if it has none.
+    Parameter* parallelism;
+    NodeCostModel cost_model;
+    // Time the other nodes of the stage take per element of the root. It is
+    // assumed not to depend on the parallelism of the root.
+    double inputs_time_nsec;
+    double pipeline_ratio;
+
+    // Returns the predicted time the stage takes to produce the elements
+    // needed for one element of the pipeline output.
+    double PredictTimeNsec() const {
+      const double parallelism_value =
+          parallelism == nullptr ? 1.0 : parallelism->value;
+      return PredictTimeNsec(parallelism_value);
+    }
+    double PredictTimeNsec(double parallelism_value) const {
+      return (cost_model.PredictCostNsec(parallelism_value) /
+                  parallelism_value +
+              inputs_time_nsec) *
+             pipeline_ratio;
+    }
+  };
+
+  Node::NodeVector nodes =
+      snapshot->CollectNodes(TraversalOrder::BFS, IsAnyNode);
+  nodes.push_back(snapshot);
+  Node::ModelParameters tunable_parameters;
+  for (const auto& node : nodes) {
+    Node::ModelParameters node_tunable_parameters =
+        node->CollectNodeTunableParameters();
+    tunable_parameters.insert(tunable_parameters.end(),
+                              node_tunable_parameters.begin(),
+                              node_tunable_parameters.end());
+  }
+
+  absl::flat_hash_map<const Node*, std::string> node_keys = NodeKeys(snapshot);
+  ModelTiming model_timing(snapshot);
+  NodeParallelismParameters node_parallelism;
+  std::vector<Stage> stages;
+  for (const auto& root : model_timing.GetStageRoots()) {
+    const ModelTiming::NodeTiming* timing = model_timing.GetTiming(root.get());
+    if (timing == nullptr) {
+      continue;
+    }
+    Stage stage{root.get(), node_parallelism.Get(root.get()), NodeCostModel(),
+                timing->total_time_nsec - timing->self_time_nsec,
+                timing->pipeline_ratio};
+    if (stage.parallelism == nullptr) {
+      stage.cost_model.AddObservation(/*parallelism=*/1.0,
+                                      timing->self_time_nsec);
+    } else {
+      {
+        tf_shared_lock l(mu_);
+        auto it = cost_models_.find(node_keys.at(root.get()));
+        if (it != cost_models_.end()) {
+          stage.cost_model = it->second;
+        }
+      }
+      if (stage.cost_model.empty()) {
+        // Falls back to the constant cost assumed by the analytical models,
+        // whose self time is the cost divided by the parallelism.
+        stage.cost_model.AddObservation(
+            /*parallelism=*/1.0,
+            timing->self_time_nsec * stage.parallelism->value);
+      }
+    }
+    stages.push_back(std::move(stage));
+  }
+  if (stages.empty()) {
+    metrics::RecordTFDataAutotuneStoppingCriteria("empty_critical_queue");
+    return;
+  }
+  // Initialize the parallelism parameter values to minimal before tuning.
+  int64_t total_parallelism = 0;
+  for (auto& [node_name, parameter] : tunable_parameters) {
+    if (parameter->name != kParallelism) {
+      continue;
+    }
+    parameter->value = std::max(parameter->min, 1.0);
+    total_parallelism += static_cast<int64_t>(parameter->value);
+  }
+
+  while (!cancellation_manager->IsCancelled()) {
+    Stage* slowest = &stages.front();
+    double slowest_time_nsec = slowest->PredictTimeNsec();
+    for (Stage& stage : stages) {
+      const double time_nsec = stage.PredictTimeNsec();
+      if (time_nsec > slowest_time_nsec) {
+        slowest = &stage;
+        slowest_time_nsec = time_nsec;
+      }
+    }
+    if (slowest_time_nsec <= optimization_params.model_input_time()) {
+      break;
+    }
+    // Removes the `<index>` of `[<index>]` to reduce the number of labels.
+    const std::string root_name = RemoveArrayIndices(slowest->root->long_name());
+    Parameter* parallelism = slowest->parallelism;
+    if (parallelism == nullptr) {
+      metrics::RecordTFDataAutotuneStoppingCriteria(
+          absl::StrCat("no_optimizable_parameter:", root_name));
+      break;
+    }
+    if (parallelism->value >= parallelism->max) {
+      metrics::RecordTFDataAutotuneStoppingCriteria(
+          absl::StrCat("parameter_max_exceeded:", root_name));
+      break;
+    }
+    if (total_parallelism >= optimization_params.cpu_budget()) {
+      metrics::RecordTFDataAutotuneStoppingCriteria(
+          absl::StrCat("cpu_budget_exceeded:", root_name));
+      break;
+    }
+    if (slowest->PredictTimeNsec(parallelism->value + 1.0) >
+        slowest_time_nsec * (1.0 - kMinLearnedCostImprovement)) {
+      // The contention between parallel calls outweighs the additional
+      // parallelism.
+      metrics::RecordTFDataAutotuneStoppingCriteria(
+          absl::StrCat("total_time_not_improved:", root_name));
+      break;
+    }
+    parallelism->value += 1.0;
+    ++total_parallelism;
+    if (TotalMaximumBufferedBytes(snapshot) >
+        optimization_params.ram_budget()) {
+      parallelism->value -= 1.0;
+      metrics::RecordTFDataAutotuneStoppingCriteria(
+          absl::StrCat("ram_budget_exceeded:", root_name));
+      break;
+    }
+  }
+  if (ram_budget_manager.RequestModelAllocation(
+          TotalMaximumBufferedBytes(snapshot))) {
+    UpdateStateValues(&tunable_parameters);
+  }
+}
+
 void Model::OptimizeBuffers(std::shared_ptr<Node> snapshot,
                             int64_t ram_budget) {
   VLOG(2) << "Starting optimization of buffer_size parameters.";
@@ -644,6 +644,14 @@ class Node {
     estimated_element_size_ = estimated_element_size;
   }
 
+  // Replaces the number of elements, processing time, and consumed and
+  // produced bytes of this node with those recorded in `node_proto`, typically
+  // by a previous run of the same input pipeline. This is used on model
+  // snapshots to estimate the performance of nodes that have not recorded
+  // enough elements yet.
+  void RestoreStatistics(const ModelProto::Node& node_proto)
+      TF_LOCKS_EXCLUDED(mu_);
+
  protected:
   // Used for (incrementally) recording metrics. The class is thread-safe.
   class Metrics {
@@ -919,6 +927,49 @@ std::shared_ptr<Node> MakeAsyncUnknownRatioNode(
 // as pass-through between inputs and output.
 std::shared_ptr<Node> MakeUnknownNode(Node::Args args);
 
+// Model of the time a node spends producing an element as a function of its
+// parallelism `p`: `cost(p) = intercept + slope * p`. The analytical node models
+// assume that the cost does not depend on `p`. A positive slope captures the
+// contention between parallel calls (e.g. for memory bandwidth or locks), which
+// makes additional parallelism less effective than these models predict.
+//
+// The coefficients are fit by least squares to the per-element processing
+// times observed at the parallelism values the node ran with. Observations are
+// exponentially decayed, so that the model follows changes of the workload.
+class NodeCostModel {
+ public:
+  // Records that the node has produced `num_elements` elements in
+  // `processing_time` nanoseconds in total, and ran with `parallelism` since the
+  // previous call. Adds an observation of the per-element cost in between if
+  // the node produced enough elements.
+  void RecordStatistics(int64_t num_elements, int64_t processing_time,
+                        double parallelism);
+
+  // Adds an observation of the per-element cost `cost_nsec` at `parallelism`.
+  void AddObservation(double parallelism, double cost_nsec);
+
+  // Returns true if there are no observations.
+  bool empty() const { return weight_ == 0.0; }
+
+  // Returns the predicted per-element cost in nanoseconds at `parallelism`. If
+  // all observations were made at the same parallelism, returns their average.
+  double PredictCostNsec(double parallelism) const;
+
+  void ToProto(ModelProto::Node::CostModel* cost_model_proto) const;
+  void FromProto(const ModelProto::Node::CostModel& cost_model_proto);
+
+ private:
+  double weight_ = 0.0;
+  double sum_parallelism_ = 0.0;
+  double sum_cost_ = 0.0;
+  double sum_parallelism_squared_ = 0.0;
+  double sum_parallelism_cost_ = 0.0;
+
+  // Statistics passed to the previous `RecordStatistics()` call.
+  int64_t last_num_elements_ = -1;
+  int64_t last_processing_time_ = 0;
+};
+
 // Abstract representation of a TensorFlow input pipeline that can be used
 // for collecting runtime information and optimizing performance. It collects
 // runtime information about execution of the input pipeline that is used to
@@ -1027,6 +1078,22 @@ class Model {
                            std::unique_ptr<Model>* model,
                            OptimizationParams* optimization_params);
 
+  // Warm-starts autotuning from `model_proto`, which was saved by a previous
+  // run of the same input pipeline. Nodes are matched by their position in the
+  // pipeline. Until a node has recorded enough elements, optimization uses the
+  // statistics recorded for it in `model_proto`. The node cost models saved in
+  // `model_proto` are used by the `LEARNED_COST` algorithm.
+  void WarmStart(const ModelProto& model_proto) TF_LOCKS_EXCLUDED(mu_);
+
+  // Warm-starts autotuning from the model saved to `fname` by a previous run,
+  // if the file exists, and makes `OptimizeLoop` periodically save the model to
+  // `fname` for later runs.
+  absl::Status EnableWarmStart(const std::string& fname) TF_LOCKS_EXCLUDED(mu_);
+
+  // Saves the latest optimization snapshot, its optimization parameters and
+  // the node cost models to `fname`, in the format read by `WarmStart`.
+  absl::Status SaveWarmStart(const std::string& fname) TF_LOCKS_EXCLUDED(mu_);
+
   // Records gap time between consecutive `GetNext()` calls.
   void RecordIteratorGapTime(uint64_t duration_usec);
 
@@ -1086,6 +1153,24 @@ class Model {
   // Flushes metrics recorded by the model.
   void FlushMetrics() TF_LOCKS_EXCLUDED(mu_);
 
+  // Adds the statistics of the nodes with a `parallelism` parameter in
+  // `snapshot` to their cost models.
+  void RecordCostObservations(
+      std::shared_ptr<Node> snapshot,
+      const absl::flat_hash_map<const Node*, std::string>& node_keys)
+      TF_LOCKS_EXCLUDED(mu_);
+
+  // Replaces the statistics of the nodes in `snapshot` that have recorded few
+  // elements with those of the warm-start model, if any.
+  void ApplyWarmStart(
+      std::shared_ptr<Node> snapshot,
+      const absl::flat_hash_map<const Node*, std::string>& node_keys)
+      TF_LOCKS_EXCLUDED(mu_);
+
+  // Saves the model for warm-starting later runs if `EnableWarmStart` was
+  // called, logging failures.
+  void MaybeSaveWarmStart() TF_LOCKS_EXCLUDED(mu_);
+
   // This optimization algorithm starts by setting all tunable parallelism
   // parameters to the minimum value. It then improves current parameters by
   // making a step in the direction opposite to the gradient of `OutputTime` and
@@ -1155,6 +1240,18 @@ class Model {
       CancellationManager* cancellation_manager,
       RamBudgetManager& ram_budget_manager);
 
+  // This optimization behaves similarly to the stage-based optimization, but
+  // predicts the processing time of stage roots from their learned cost models
+  // (see `NodeCostModel`). It repeatedly increases the parallelism of the root
+  // of the longest stage by 1 until either the longest stage is faster than the
+  // target time, increasing its parallelism is not predicted to make it
+  // noticeably faster, or the memory or CPU budget is fully utilized. Roots
+  // without a cost model are assumed to have a constant per-element cost.
+  void OptimizeLearnedCost(std::shared_ptr<Node> snapshot,
+                           const OptimizationParams& optimization_params,
+                           CancellationManager* cancellation_manager,
+                           RamBudgetManager& ram_budget_manager);
+
   // Determines if we should stop the gradient descent optimization iterations
   // based on number of increasable parameters, CPU budget, RAM budget and
   // current resource usage.
@@ -1221,6 +1318,16 @@ class Model {
   std::shared_ptr<Node> snapshot_ TF_GUARDED_BY(mu_);
   // Stores the optimization parameters used by autotune.
   OptimizationParams optimization_params_ TF_GUARDED_BY(mu_);
+  // Cost models of the nodes with a `parallelism` parameter, keyed by the
+  // position of the node in the pipeline.
+  absl::flat_hash_map<std::string, NodeCostModel> cost_models_
+      TF_GUARDED_BY(mu_);
+  // Nodes of the warm-start model, keyed by their position in the pipeline.
+  absl::flat_hash_map<std::string, ModelProto::Node> warm_start_nodes_
+      TF_GUARDED_BY(mu_);
+  // File to which `OptimizeLoop` saves the model for warm-starting later runs.
+  // Empty if warm-starting is not enabled.
+  std::string warm_start_fname_ TF_GUARDED_BY(mu_);
   // Stores the model id in the string format
   std::string model_id_;
 };
@@ -27,6 +27,7 @@ limitations under the License.
 
 #include <gtest/gtest.h>
 #include "absl/status/status.h"
+#include "absl/strings/str_cat.h"
 #include "tensorflow/core/framework/cancellation.h"
 #include "tensorflow/core/framework/model.pb.h"
 #include "tensorflow/core/framework/op_def.pb.h"
@@ -34,6 +35,8 @@ limitations under the License.
 #include "tensorflow/core/lib/core/threadpool.h"
 #include "tensorflow/core/lib/gtl/cleanup.h"
 #include "tensorflow/core/lib/monitoring/cell_reader.h"
+#include "tensorflow/core/platform/env.h"
+#include "tensorflow/core/platform/path.h"
 #include "tensorflow/core/platform/stringprintf.h"
 #include "tensorflow/core/platform/test.h"
 
@@ -3159,6 +3162,300 @@ TEST_F(ModelTimingTest, OptimizeStageBased_PipelineRatioLessThanOne) {
   EXPECT_EQ(14, GetNode(/*node_id=*/1)->parameter_value("parallelism"));
 }
 
+TEST(NodeCostModelTest, ConstantCost) {
+  NodeCostModel cost_model;
+  EXPECT_TRUE(cost_model.empty());
+  cost_model.AddObservation(/*parallelism=*/4, /*cost_nsec=*/100);
+  cost_model.AddObservation(/*parallelism=*/4, /*cost_nsec=*/100);
+  EXPECT_FALSE(cost_model.empty());
+  EXPECT_DOUBLE_EQ(cost_model.PredictCostNsec(1), 100);
+  EXPECT_DOUBLE_EQ(cost_model.PredictCostNsec(8), 100);
+}
+
+TEST(NodeCostModelTest, FitsContention) {
+  NodeCostModel cost_model;
+  cost_model.AddObservation(/*parallelism=*/1, /*cost_nsec=*/100);
+  cost_model.AddObservation(/*parallelism=*/2, /*cost_nsec=*/120);
+  cost_model.AddObservation(/*parallelism=*/4, /*cost_nsec=*/160);
+  EXPECT_NEAR(cost_model.PredictCostNsec(3), 140, 1e-6);
+  EXPECT_NEAR(cost_model.PredictCostNsec(8), 240, 1e-6);
+}
+
+TEST(NodeCostModelTest, IgnoresDecreasingCost) {
+  NodeCostModel cost_model;
+  cost_model.AddObservation(/*parallelism=*/1, /*cost_nsec=*/120);
+  cost_model.AddObservation(/*parallelism=*/2, /*cost_nsec=*/80);
+  EXPECT_NEAR(cost_model.PredictCostNsec(8),
+              cost_model.PredictCostNsec(1), 1e-6);
+}
+
+TEST(NodeCostModelTest, RecordStatistics) {
+  NodeCostModel cost_model;
+  cost_model.RecordStatistics(/*num_elements=*/0, /*processing_time=*/0,
+                              /*parallelism=*/1);
+  cost_model.RecordStatistics(/*num_elements=*/100, /*processing_time=*/10000,
+                              /*parallelism=*/1);
+  EXPECT_DOUBLE_EQ(cost_model.PredictCostNsec(1), 100);
+  // Too few elements for an observation.
+  cost_model.RecordStatistics(/*num_elements=*/105, /*processing_time=*/20000,
+                              /*parallelism=*/2);
+  EXPECT_DOUBLE_EQ(cost_model.PredictCostNsec(1), 100);
+  cost_model.RecordStatistics(/*num_elements=*/200, /*processing_time=*/30000,
+                              /*parallelism=*/2);
+  EXPECT_NEAR(cost_model.PredictCostNsec(2), 200, 1e-6);
+  EXPECT_NEAR(cost_model.PredictCostNsec(3), 300, 1e-6);
+  // Statistics of a new iterator only reset the base of the observations.
+  cost_model.RecordStatistics(/*num_elements=*/10, /*processing_time=*/100000,
+                              /*parallelism=*/2);
+  EXPECT_NEAR(cost_model.PredictCostNsec(3), 300, 1e-6);
+}
+
+TEST(NodeCostModelTest, ProtoRoundTrip) {
+  NodeCostModel cost_model;
+  cost_model.AddObservation(/*parallelism=*/1, /*cost_nsec=*/100);
+  cost_model.AddObservation(/*parallelism=*/4, /*cost_nsec=*/160);
+  ModelProto::Node::CostModel cost_model_proto;
+  cost_model.ToProto(&cost_model_proto);
+  NodeCostModel restored_cost_model;
+  restored_cost_model.FromProto(cost_model_proto);
+  EXPECT_DOUBLE_EQ(restored_cost_model.PredictCostNsec(8),
+                   cost_model.PredictCostNsec(8));
+}
+
+// A parallel map over a source, where the map takes 100ns per element.
+constexpr char kParallelMapModel[] = R"pb(
+  nodes: {
+    key: 1
+    value: {
+      id: 1
+      name: "ParallelMapV2"
+      autotune: true
+      num_elements: 100
+      processing_time: 10000
+      node_class: ASYNC_KNOWN_RATIO
+      ratio: 1
+      inputs: 2
+      parameters: {
+        name: "parallelism"
+        value: 1
+        state_value: 1
+        min: 1
+        max: 16
+        tunable: true
+      }
+    }
+  }
+  nodes: {
+    key: 2
+    value: {
+      id: 2
+      name: "SSTable"
+      autotune: true
+      num_elements: 100
+      node_class: KNOWN_RATIO
+    }
+  }
+  output: 1
+)pb";
+
+// The same pipeline as `kParallelMapModel` with different node IDs, before it
+// produced any elements.
+constexpr char kNewParallelMapModel[] = R"pb(
+  nodes: {
+    key: 7
+    value: {
+      id: 7
+      name: "ParallelMapV2"
+      autotune: true
+      node_class: ASYNC_KNOWN_RATIO
+      ratio: 1
+      inputs: 8
+      parameters: {
+        name: "parallelism"
+        value: 1
+        state_value: 1
+        min: 1
+        max: 16
+        tunable: true
+      }
+    }
+  }
+  nodes: {
+    key: 8
+    value: {
+      id: 8
+      name: "SSTable"
+      autotune: true
+      node_class: KNOWN_RATIO
+    }
+  }
+  output: 7
+)pb";
+
+TEST_F(ModelTimingTest, OptimizeLearnedCost_OneStage) {
+  BuildModelFromProto(R"pb(
+    nodes: {
+      key: 1
+      value: {
+        id: 1
+        name: "ParallelMapV2"
+        autotune: true
+        num_elements: 97
+        buffered_elements: 3
+        processing_time: 5000
+        bytes_produced: 10000
+        node_class: ASYNC_KNOWN_RATIO
+        ratio: 1
+        inputs: 2
+        parameters: {
+          name: "parallelism"
+          value: 4
+          min: 1
+          max: 16
+          tunable: true
+        }
+      }
+    }
+    nodes: {
+      key: 2
+      value: {
+        id: 2
+        name: "Map"
+        autotune: true
+        num_elements: 100
+        processing_time: 3000
+        node_class: KNOWN_RATIO
+        ratio: 1
+        inputs: 3
+      }
+    }
+    nodes: {
+      key: 3
+      value: {
+        id: 3
+        name: "SSTable"
+        autotune: true
+        num_elements: 100
+        processing_time: 1000
+        node_class: KNOWN_RATIO
+      }
+    }
+    output: 1
+  )pb");
+
+  CancellationManager cancellation_manager;
+  RamBudgetManager ram_budget_manager(0);
+  model_->Optimize(AutotuneAlgorithm::LEARNED_COST, CpuBudgetFunc(20),
+                   /*ram_budget_share=*/1.0,
+                   /*fixed_ram_budget=*/1000,
+                   /*model_input_time=*/50, ram_budget_manager,
+                   &cancellation_manager);
+
+  // Without a cost model, the result matches the stage-based optimization.
+  EXPECT_EQ(5, GetNode(/*node_id=*/1)->parameter_value("parallelism"));
+}
+
+TEST_F(ModelTimingTest, OptimizeLearnedCost_Contention) {
+  ModelProto model_proto;
+  ASSERT_TRUE(
+      protobuf::TextFormat::ParseFromString(kParallelMapModel, &model_proto));
+  // The per-element cost grows with the parallelism: 20ns + 80ns * p.
+  NodeCostModel cost_model;
+  cost_model.AddObservation(/*parallelism=*/1, /*cost_nsec=*/100);
+  cost_model.AddObservation(/*parallelism=*/4, /*cost_nsec=*/340);
+  cost_model.ToProto(
+      model_proto.mutable_nodes()->at(1).mutable_cost_model());
+  BuildModelFromProto(kParallelMapModel);
+  model_->WarmStart(model_proto);
+
+  CancellationManager cancellation_manager;
+  RamBudgetManager ram_budget_manager(0);
+  model_->Optimize(AutotuneAlgorithm::LEARNED_COST, CpuBudgetFunc(20),
+                   /*ram_budget_share=*/1.0,
+                   /*fixed_ram_budget=*/1000,
+                   /*model_input_time=*/10, ram_budget_manager,
+                   &cancellation_manager);
+
+  // The time per element is 20ns / p + 80ns, which improves by less than 1%
+  // beyond a parallelism of 5.
+  EXPECT_EQ(5, GetNode(/*node_id=*/1)->parameter_value("parallelism"));
+}
+
+TEST_F(ModelTimingTest, OptimizeLearnedCost_NoContention) {
+  BuildModelFromProto(kParallelMapModel);
+
+  CancellationManager cancellation_manager;
+  RamBudgetManager ram_budget_manager(0);
+  model_->Optimize(AutotuneAlgorithm::LEARNED_COST, CpuBudgetFunc(20),
+                   /*ram_budget_share=*/1.0,
+                   /*fixed_ram_budget=*/1000,
+                   /*model_input_time=*/10, ram_budget_manager,
+                   &cancellation_manager);
+
+  EXPECT_EQ(10, GetNode(/*node_id=*/1)->parameter_value("parallelism"));
+}
+
+TEST_F(ModelTimingTest, WarmStart) {
+  ModelProto recorded_model_proto;
+  ASSERT_TRUE(protobuf::TextFormat::ParseFromString(kParallelMapModel,
+                                                    &recorded_model_proto));
+  BuildModelFromProto(kNewParallelMapModel);
+
+  CancellationManager cancellation_manager;
+  RamBudgetManager ram_budget_manager(0);
+  model_->Optimize(AutotuneAlgorithm::STAGE_BASED, CpuBudgetFunc(20),
+                   /*ram_budget_share=*/1.0,
+                   /*fixed_ram_budget=*/1000,
+                   /*model_input_time=*/10, ram_budget_manager,
+                   &cancellation_manager);
+  // Nodes without elements are not tuned.
+  EXPECT_EQ(1, GetNode(/*node_id=*/7)->parameter_value("parallelism"));
+
+  model_->WarmStart(recorded_model_proto);
+  model_->Optimize(AutotuneAlgorithm::STAGE_BASED, CpuBudgetFunc(20),
+                   /*ram_budget_share=*/1.0,
+                   /*fixed_ram_budget=*/1000,
+                   /*model_input_time=*/10, ram_budget_manager,
+                   &cancellation_manager);
+  EXPECT_EQ(10, GetNode(/*node_id=*/7)->parameter_value("parallelism"));
+  // The statistics of the model itself are not changed.
+  EXPECT_EQ(0, GetNode(/*node_id=*/7)->num_elements());
+}
+
+TEST_F(ModelTimingTest, SaveAndEnableWarmStart) {
+  const std::string fname =
+      io::JoinPath(testing::TmpDir(), "autotune_performance_model");
+  BuildModelFromProto(kParallelMapModel);
+  EXPECT_EQ(model_->SaveWarmStart(fname).code(),
+            absl::StatusCode::kFailedPrecondition);
+
+  CancellationManager cancellation_manager;
+  RamBudgetManager ram_budget_manager(0);
+  model_->Optimize(AutotuneAlgorithm::STAGE_BASED, CpuBudgetFunc(20),
+                   /*ram_budget_share=*/1.0,
+                   /*fixed_ram_budget=*/1000,
+                   /*model_input_time=*/10, ram_budget_manager,
+                   &cancellation_manager);
+  TF_ASSERT_OK(model_->SaveWarmStart(fname));
+  ModelProto saved_model_proto;
+  TF_ASSERT_OK(ReadBinaryProto(Env::Default(), fname, &saved_model_proto));
+  EXPECT_EQ(saved_model_proto.nodes_size(), 2);
+  EXPECT_EQ(saved_model_proto.optimization_params().cpu_budget(), 20);
+
+  BuildModelFromProto(kNewParallelMapModel);
+  TF_ASSERT_OK(model_->EnableWarmStart(fname));
+  model_->Optimize(AutotuneAlgorithm::STAGE_BASED, CpuBudgetFunc(20),
+                   /*ram_budget_share=*/1.0,
+                   /*fixed_ram_budget=*/1000,
+                   /*model_input_time=*/10, ram_budget_manager,
+                   &cancellation_manager);
+  EXPECT_EQ(10, GetNode(/*node_id=*/7)->parameter_value("parallelism"));
+
+  // A missing file means that this is the first run.
+  BuildModelFromProto(kNewParallelMapModel);
+  TF_EXPECT_OK(model_->EnableWarmStart(absl::StrCat(fname, "_missing")));
+}
+
 TEST_F(ModelTimingTest, ComputeTargetTime) {
   model_ = std::make_unique<Model>();
 
@@ -132,6 +132,7 @@ ThreadWorkSource::ThreadWorkSource()
       blocking_inflight_(0),
       non_blocking_inflight_(0),
       traceme_id_(0),
+      numa_node_(port::kNUMANoAffinity),
       version_(0),
       sub_thread_pool_waiter_(nullptr) {
   queue_waiters_.next = &queue_waiters_;
@@ -261,6 +262,14 @@ int64_t ThreadWorkSource::GetTracemeId() {
 
 void ThreadWorkSource::SetTracemeId(int64_t value) { traceme_id_ = value; }
 
+int ThreadWorkSource::GetNumaNode() {
+  return numa_node_.load(std::memory_order_relaxed);
+}
+
+void ThreadWorkSource::SetNumaNode(int numa_node) {
+  numa_node_.store(numa_node, std::memory_order_relaxed);
+}
+
 void ThreadWorkSource::SetWaiter(uint64_t version, Waiter* waiter,
                                  mutex* mutex) {
   {
@@ -306,6 +315,7 @@ unsigned ThreadWorkSource::NonBlockingWorkShardingFactor() {
 
 std::string ThreadWorkSource::ToString() {
   return absl::StrCat("traceme_id = ", GetTracemeId(),
+                      ", numa node = ", GetNumaNode(),
                       ", inter queue size = ", TaskQueueSize(true),
                       ", inter inflight = ", GetInflightTaskCount(true),
                       ", intra queue size = ", TaskQueueSize(false),
@@ -316,10 +326,11 @@ RunHandlerThreadPool::RunHandlerThreadPool(
     int num_blocking_threads, int num_non_blocking_threads, Env* env,
     const ThreadOptions& thread_options, const std::string& name,
     Eigen::MaxSizeVector<mutex>* waiters_mu,
-    Eigen::MaxSizeVector<Waiter>* queue_waiters)
+    Eigen::MaxSizeVector<Waiter>* queue_waiters, int num_numa_nodes)
     : num_threads_(num_blocking_threads + num_non_blocking_threads),
       num_blocking_threads_(num_blocking_threads),
       num_non_blocking_threads_(num_non_blocking_threads),
+      num_numa_nodes_(std::max(num_numa_nodes, 1)),
       thread_data_(num_threads_),
       env_(env, thread_options, name),
       name_(name),
@@ -338,9 +349,21 @@ RunHandlerThreadPool::RunHandlerThreadPool(
           "TF_RUN_HANDLER_SUB_THREAD_POOL_END_REQUEST_PERCENTAGE",
           std::vector<double>({0.4, 1}))) {
   thread_data_.resize(num_threads_);
+  // Blocking and non-blocking threads are each spread evenly over the NUMA
+  // nodes, so that every node has threads for both kinds of work.
+  if (num_numa_nodes_ > 1) {
+    for (int i = 0; i < num_threads_; ++i) {
+      thread_data_[i].numa_node =
+          i < num_blocking_threads_
+              ? i * num_numa_nodes_ / num_blocking_threads_
+              : (i - num_blocking_threads_) * num_numa_nodes_ /
+                    num_non_blocking_threads_;
+    }
+  }
   VLOG(1) << "Creating RunHandlerThreadPool " << name << " with  "
           << num_blocking_threads_ << " blocking threads and "
-          << num_non_blocking_threads_ << " non-blocking threads.";
+          << num_non_blocking_threads_ << " non-blocking threads over "
+          << num_numa_nodes_ << " NUMA nodes.";
 }
 
 RunHandlerThreadPool::~RunHandlerThreadPool() {
@@ -369,12 +392,16 @@ void RunHandlerThreadPool::Start() {
     }
     thread_data_[i].sub_thread_pool_id = sub_thread_pool_id;
     const bool is_blocking_thread = (i < num_blocking_threads) ? true : false;
+    const int numa_node = thread_data_[i].numa_node;
     // The blocking threads will handle both inter and intra op workload;
     // non-blocking thread will handle intra op workload only; and the
     // sub thread pool is only provided for blocking threads.
     // Name the threads accordingly.
     thread_data_[i].thread.reset(env_.CreateThread(
-        [this, is_blocking_thread, i, sub_thread_pool_id]() {
+        [this, is_blocking_thread, i, sub_thread_pool_id, numa_node]() {
+          if (numa_node != port::kNUMANoAffinity && port::NUMAEnabled()) {
+            port::NUMASetThreadNodeAffinity(numa_node);
+          }
           WorkerLoop(i, is_blocking_thread);
         },
         is_blocking_thread
@@ -446,6 +473,18 @@ void RunHandlerThreadPool::SetThreadWorkSources(
       }
       token = (token + 1) % num_shards;
     }
+    if (num_numa_nodes_ > 1) {
+      // Steal from the requests homed on the thread's node before crossing
+      // nodes. The start request stays first since the thread waits on it for
+      // new work.
+      Eigen::MaxSizeVector<ThreadWorkSource*>* sources =
+          thread_data_[tid].new_thread_work_sources.get();
+      const int numa_node = thread_data_[tid].numa_node;
+      std::stable_partition(sources->begin() + 1, sources->end(),
+                            [numa_node](ThreadWorkSource* tws) {
+                              return tws->GetNumaNode() == numa_node;
+                            });
+    }
     thread_data_[tid].sources_not_empty.notify_all();
   }
 }
@@ -475,6 +514,12 @@ int RunHandlerThreadPool::NumNonBlockingThreads() const {
   return num_non_blocking_threads_;
 }
 
+int RunHandlerThreadPool::NumNumaNodes() const { return num_numa_nodes_; }
+
+int RunHandlerThreadPool::ThreadNumaNode(int tid) const {
+  return thread_data_[tid].numa_node;
+}
+
 RunHandlerThreadPool::ThreadData::ThreadData()
     : new_version(0),
       current_index(0),
@@ -486,7 +531,8 @@ RunHandlerThreadPool::ThreadData::ThreadData()
       current_thread_work_sources(
           new Eigen::MaxSizeVector<ThreadWorkSource*>(static_cast<int32_t>(
               ParamFromEnvWithDefault("TF_RUN_HANDLER_MAX_CONCURRENT_HANDLERS",
-                                      kMaxConcurrentHandlers)))) {}
+                                      kMaxConcurrentHandlers)))),
+      numa_node(port::kNUMANoAffinity) {}
 
 Task RunHandlerThreadPool::FindTask(
     int searching_range_start, int searching_range_end, int thread_id,
@@ -786,7 +832,11 @@ class RunHandlerPool::Impl {
         run_handler_thread_pool_(new internal::RunHandlerThreadPool(
             num_inter_op_threads, num_intra_op_threads, Env::Default(),
             ThreadOptions(), "tf_run_handler_pool", &waiters_mu_,
-            &queue_waiters_)),
+            &queue_waiters_,
+            ParamFromEnvBoolWithDefault("TF_RUN_HANDLER_USE_NUMA_AFFINITY",
+                                        false)
+                ? port::NUMANumNodes()
+                : 1)),
         iterations_(0),
         version_(0),
         sub_thread_pool_end_request_percentage_(ParamFromEnvWithDefault(
@@ -807,6 +857,8 @@ class RunHandlerPool::Impl {
       queue_waiter.next = &queue_waiter;
       queue_waiter.prev = &queue_waiter;
     }
+    num_active_handlers_per_numa_node_.resize(
+        run_handler_thread_pool_->NumNumaNodes());
     run_handler_thread_pool_->Start();
   }
 
@@ -870,6 +922,7 @@ class RunHandlerPool::Impl {
       handler_impl = free_handlers_.back();
       handler_impl->Reset(step_id, options);
       free_handlers_.pop_back();
+      AssignHomeNumaNode(handler_impl);
 
       num_active_requests = sorted_active_handlers_.size() + 1;
       thread_work_sources->resize(num_active_requests);
@@ -915,6 +968,10 @@ class RunHandlerPool::Impl {
     // Remove this handler from this list and add it to the list of free
     // handlers.
     sorted_active_handlers_.erase(iter);
+    const int numa_node = handler->tws()->GetNumaNode();
+    if (numa_node != port::kNUMANoAffinity) {
+      --num_active_handlers_per_numa_node_[numa_node];
+    }
     free_handlers_.push_back(handler);
     DCHECK_LE(free_handlers_.size(), max_handlers_);
     LogInfo();
@@ -940,6 +997,19 @@ class RunHandlerPool::Impl {
       const Eigen::MaxSizeVector<internal::ThreadWorkSource*>&
           thread_work_sources);
 
+  // Sets the work sources of threads [first_tid, first_tid + num_threads),
+  // which are either all blocking or all non-blocking threads.
+  void SetThreadWorkSources(
+      int first_tid, int num_threads, int num_active_requests,
+      uint64_t version,
+      const Eigen::MaxSizeVector<internal::ThreadWorkSource*>&
+          thread_work_sources);
+
+  // Homes the handler on the NUMA node with the fewest active handlers, if the
+  // pool is NUMA-aware.
+  void AssignHomeNumaNode(RunHandler::Impl* handler)
+      TF_EXCLUSIVE_LOCKS_REQUIRED(mu_);
+
   void LogInfo() TF_EXCLUSIVE_LOCKS_REQUIRED(mu_);
 
   // Maximum number of handlers pre-created during pool construction time. The
@@ -961,6 +1031,9 @@ class RunHandlerPool::Impl {
   std::list<RunHandler::Impl*> sorted_active_handlers_ TF_GUARDED_BY(mu_);
   std::vector<RunHandler::Impl*> free_handlers_ TF_GUARDED_BY(mu_);
   std::vector<std::unique_ptr<RunHandler::Impl>> handlers_ TF_GUARDED_BY(mu_);
+  // Number of active handlers homed on each NUMA node. Has a single entry if
+  // the pool is not NUMA-aware.
+  std::vector<int> num_active_handlers_per_numa_node_ TF_GUARDED_BY(mu_);
 
   // Histogram of elapsed runtime of every handler (in ms).
   histogram::Histogram time_hist_ TF_GUARDED_BY(mu_);
@@ -995,26 +1068,66 @@ void RunHandlerPool::Impl::RecomputePoolStats(
   int num_blocking_threads = run_handler_thread_pool()->NumBlockingThreads();
   int num_non_blocking_threads = num_threads - num_blocking_threads;
 
-  std::vector<int> request_idx_list = ChooseRequestsWithExponentialDistribution(
-      num_active_requests, num_blocking_threads);
-  for (int i = 0; i < num_blocking_threads; ++i) {
-    VLOG(2) << "Set work for tid=" << i
-            << " with start_request_idx=" << request_idx_list[i];
-    run_handler_thread_pool()->SetThreadWorkSources(
-        i, request_idx_list[i], version, thread_work_sources);
-  }
+  SetThreadWorkSources(/*first_tid=*/0, num_blocking_threads,
+                       num_active_requests, version, thread_work_sources);
+  SetThreadWorkSources(/*first_tid=*/num_blocking_threads,
+                       num_non_blocking_threads, num_active_requests, version,
+                       thread_work_sources);
+}
 
-  request_idx_list = ChooseRequestsWithExponentialDistribution(
-      num_active_requests, num_non_blocking_threads);
-  for (int i = 0; i < num_non_blocking_threads; ++i) {
-    VLOG(2) << "Set work for tid=" << (i + num_blocking_threads)
-            << " with start_request_idx=" << request_idx_list[i];
-    run_handler_thread_pool()->SetThreadWorkSources(
-        i + num_blocking_threads, request_idx_list[i], version,
-        thread_work_sources);
+void RunHandlerPool::Impl::SetThreadWorkSources(
+    int first_tid, int num_threads, int num_active_requests, uint64_t version,
+    const Eigen::MaxSizeVector<internal::ThreadWorkSource*>&
+        thread_work_sources) {
+  internal::RunHandlerThreadPool* pool = run_handler_thread_pool();
+  // The threads pinned to a NUMA node are contiguous. Each such group spreads
+  // its start requests over the requests homed on its node, if there are any.
+  // Without NUMA affinity, all threads form a single group.
+  int group_start = 0;
+  while (group_start < num_threads) {
+    const int numa_node = pool->ThreadNumaNode(first_tid + group_start);
+    int group_end = group_start + 1;
+    while (group_end < num_threads &&
+           pool->ThreadNumaNode(first_tid + group_end) == numa_node) {
+      ++group_end;
+    }
+    std::vector<int> local_requests;
+    if (numa_node != port::kNUMANoAffinity) {
+      for (int i = 0; i < num_active_requests; ++i) {
+        if (thread_work_sources[i]->GetNumaNode() == numa_node) {
+          local_requests.push_back(i);
+        }
+      }
+    }
+    std::vector<int> request_idx_list =
+        ChooseRequestsWithExponentialDistribution(
+            local_requests.empty() ? num_active_requests
+                                   : local_requests.size(),
+            group_end - group_start);
+    for (int i = 0; i < group_end - group_start; ++i) {
+      const int start_request_idx = local_requests.empty()
+                                        ? request_idx_list[i]
+                                        : local_requests[request_idx_list[i]];
+      VLOG(2) << "Set work for tid=" << (first_tid + group_start + i)
+              << " with start_request_idx=" << start_request_idx;
+      pool->SetThreadWorkSources(first_tid + group_start + i,
+                                 start_request_idx, version,
+                                 thread_work_sources);
+    }
+    group_start = group_end;
   }
 }
 
+void RunHandlerPool::Impl::AssignHomeNumaNode(RunHandler::Impl* handler) {
+  if (num_active_handlers_per_numa_node_.size() <= 1) return;
+  const int numa_node = std::distance(
+      num_active_handlers_per_numa_node_.begin(),
+      std::min_element(num_active_handlers_per_numa_node_.begin(),
+                       num_active_handlers_per_numa_node_.end()));
+  ++num_active_handlers_per_numa_node_[numa_node];
+  handler->tws()->SetNumaNode(numa_node);
+}
+
 void RunHandlerPool::Impl::LogInfo() {
   if (iterations_++ % 50000 == 10 && VLOG_IS_ON(1)) {
     int num_active_requests = sorted_active_handlers_.size();
@@ -1113,6 +1226,8 @@ thread::ThreadPoolInterface* RunHandler::AsIntraThreadPoolInterface() {
   return impl_->thread_pool_interface();
 }
 
+int RunHandler::numa_node() const { return impl_->tws()->GetNumaNode(); }
+
 RunHandler::~RunHandler() { impl_->pool_impl()->ReleaseHandler(impl_); }
 
 }  // namespace tensorflow
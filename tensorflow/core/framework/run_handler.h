@@ -20,6 +20,7 @@ limitations under the License.
 #include "tensorflow/core/lib/histogram/histogram.h"
 #include "tensorflow/core/platform/context.h"
 #include "tensorflow/core/platform/mutex.h"
+#include "tensorflow/core/platform/numa.h"
 #include "tensorflow/core/platform/thread_annotations.h"
 #include "tensorflow/core/protobuf/config.pb.h"
 
@@ -90,12 +91,23 @@ class RunHandlerPool {
 // pool since it maintains a global view across all sessions and optimizes pool
 // scheduling to improve (median and tail) latency.
 //
+// When the pool is NUMA-aware (TF_RUN_HANDLER_USE_NUMA_AFFINITY), every
+// handler is assigned a home NUMA node on Get(). Its closures are preferably
+// run by the threads pinned to that node, so that the temporaries they
+// allocate are first touched, and thus placed, on the node's memory.
+//
 // This class is thread safe.
 class RunHandler {
  public:
   void ScheduleInterOpClosure(std::function<void()> fn);
   thread::ThreadPoolInterface* AsIntraThreadPoolInterface();
 
+  // Returns the home NUMA node of this handler, or port::kNUMANoAffinity if
+  // the pool is not NUMA-aware. Callers that allocate request-scoped buffers
+  // explicitly may use it to pick a node-local allocator, e.g.
+  // ProcessState::GetCPUAllocator(numa_node()).
+  int numa_node() const;
+
   ~RunHandler();
 
  private:
@@ -184,6 +196,12 @@ class ThreadWorkSource {
 
   unsigned NonBlockingWorkShardingFactor();
 
+  // The NUMA node whose threads should preferably run the tasks of this work
+  // source, or port::kNUMANoAffinity.
+  int GetNumaNode();
+
+  void SetNumaNode(int numa_node);
+
   std::string ToString();
 
  private:
@@ -205,6 +223,7 @@ class ThreadWorkSource {
   mutex waiters_mu_;
   Waiter queue_waiters_ TF_GUARDED_BY(waiters_mu_);
   std::atomic<int64_t> traceme_id_;
+  std::atomic<int> numa_node_;
 
   mutex run_handler_waiter_mu_;
   uint64_t version_ TF_GUARDED_BY(run_handler_waiter_mu_);
@@ -220,11 +239,16 @@ class RunHandlerThreadPool {
     int thread_id;               // Worker thread index in pool.
   };
 
+  // If num_numa_nodes > 1, blocking and non-blocking threads are each split
+  // into num_numa_nodes contiguous groups, and the threads of group n are
+  // pinned to NUMA node n. Threads then look for work in the work sources
+  // homed on their own node before stealing from other nodes.
   RunHandlerThreadPool(int num_blocking_threads, int num_non_blocking_threads,
                        Env* env, const ThreadOptions& thread_options,
                        const std::string& name,
                        Eigen::MaxSizeVector<mutex>* waiters_mu,
-                       Eigen::MaxSizeVector<Waiter>* queue_waiters);
+                       Eigen::MaxSizeVector<Waiter>* queue_waiters,
+                       int num_numa_nodes = 1);
 
   ~RunHandlerThreadPool();
 
@@ -237,7 +261,9 @@ class RunHandlerThreadPool {
 
   // Set work queues from which the thread 'tid' can steal its work.
   // The request with start_request_idx will be attempted first. Other requests
-  // will be attempted in FIFO order based on their arrival time.
+  // will be attempted in FIFO order based on their arrival time. If the pool
+  // is NUMA-aware, the requests homed on the thread's node are attempted
+  // before the others.
   void SetThreadWorkSources(
       int tid, int start_request_idx, uint64_t version,
       const Eigen::MaxSizeVector<ThreadWorkSource*>& thread_work_sources);
@@ -252,6 +278,12 @@ class RunHandlerThreadPool {
 
   int NumNonBlockingThreads() const;
 
+  int NumNumaNodes() const;
+
+  // Returns the NUMA node that thread 'tid' is pinned to, or
+  // port::kNUMANoAffinity if the pool is not NUMA-aware.
+  int ThreadNumaNode(int tid) const;
+
   void WorkerLoop(int thread_id, bool may_steal_blocking_work);
 
   // Search tasks from Requets range searching_range_start to
@@ -286,11 +318,13 @@ class RunHandlerThreadPool {
         current_thread_work_sources;
 
     int sub_thread_pool_id;
+    int numa_node;
   };
 
   const int num_threads_;
   const int num_blocking_threads_;
   const int num_non_blocking_threads_;
+  const int num_numa_nodes_;
   Eigen::MaxSizeVector<ThreadData> thread_data_;
   internal::RunHandlerEnvironment env_;
   std::atomic<bool> cancelled_;
@@ -17,7 +17,9 @@ limitations under the License.
 
 #include "tensorflow/core/framework/run_handler.h"
 
+#include <algorithm>
 #include <memory>
+#include <numeric>
 #include <vector>
 
 #define EIGEN_USE_THREADS
@@ -30,9 +32,13 @@ limitations under the License.
 #include "tensorflow/core/graph/testlib.h"
 #include "tensorflow/core/lib/strings/strcat.h"
 #include "tensorflow/core/platform/blocking_counter.h"
+#include "tensorflow/core/platform/cpu_info.h"
 #include "tensorflow/core/platform/env.h"
 #include "tensorflow/core/platform/logging.h"
+#include "tensorflow/core/platform/mutex.h"
+#include "tensorflow/core/platform/numa.h"
 #include "tensorflow/core/platform/test.h"
+#include "tensorflow/core/platform/test_benchmark.h"
 #include "tensorflow/core/public/session.h"
 #include "tensorflow/core/public/session_options.h"
 
@@ -426,6 +432,71 @@ TEST(RunHandlerThreadPool, FindTask) {
   }
 }
 
+TEST(RunHandlerThreadPool, NumaLocalWorkSourcesFirst) {
+  setenv("TF_RUN_HANDLER_USE_SUB_THREAD_POOL", "false", true);
+  Eigen::MaxSizeVector<mutex> waiters_mu(1);
+  waiters_mu.resize(1);
+  Eigen::MaxSizeVector<internal::Waiter> waiters(1);
+  waiters.resize(1);
+  internal::RunHandlerThreadPool* run_handler_thread_pool =
+      new internal::RunHandlerThreadPool(
+          /*num_blocking_threads=*/2, /*num_non_blocking_threads=*/0,
+          Env::Default(), ThreadOptions(), "tf_run_handler_pool", &waiters_mu,
+          &waiters, /*num_numa_nodes=*/2);
+  EXPECT_EQ(run_handler_thread_pool->NumNumaNodes(), 2);
+
+  // Requests 0 and 1 are homed on node 1, request 2 on node 0.
+  Eigen::MaxSizeVector<internal::ThreadWorkSource*> thread_work_sources(3);
+  thread_work_sources.resize(3);
+  internal::ThreadWorkSource tws[3];
+  for (int i = 0; i < 3; ++i) {
+    tws[i].SetNumaNode(i < 2 ? 1 : 0);
+    thread_work_sources[i] = &tws[i];
+  }
+
+  mutex mu;
+  std::vector<int> executed;
+  BlockingCounter counter(2);
+  for (int i = 1; i < 3; ++i) {
+    run_handler_thread_pool->AddWorkToQueue(&tws[i], /*is_blocking=*/true,
+                                            [&mu, &executed, &counter, i] {
+                                              mutex_lock l(mu);
+                                              executed.push_back(i);
+                                              counter.DecrementCount();
+                                            });
+  }
+  // Thread 0 runs on node 0. Its start request is remote and empty, so it
+  // should run the task of the local request 2 before that of the remote
+  // request 1, even though request 1 arrived first.
+  run_handler_thread_pool->SetThreadWorkSources(
+      /*tid=*/0, /*start_request_idx=*/0, /*version=*/1, thread_work_sources);
+  run_handler_thread_pool->StartOneThreadForTesting();
+  counter.Wait();
+  {
+    mutex_lock l(mu);
+    EXPECT_EQ(executed, std::vector<int>({2, 1}));
+  }
+  delete run_handler_thread_pool;
+}
+
+TEST(RunHandlerThreadPool, NumaNodesOfThreads) {
+  Eigen::MaxSizeVector<mutex> waiters_mu(1);
+  waiters_mu.resize(1);
+  Eigen::MaxSizeVector<internal::Waiter> waiters(1);
+  waiters.resize(1);
+  internal::RunHandlerThreadPool run_handler_thread_pool(
+      /*num_blocking_threads=*/4, /*num_non_blocking_threads=*/2,
+      Env::Default(), ThreadOptions(), "tf_run_handler_pool", &waiters_mu,
+      &waiters, /*num_numa_nodes=*/2);
+  // Blocking and non-blocking threads are each split evenly across nodes.
+  EXPECT_EQ(run_handler_thread_pool.ThreadNumaNode(0), 0);
+  EXPECT_EQ(run_handler_thread_pool.ThreadNumaNode(1), 0);
+  EXPECT_EQ(run_handler_thread_pool.ThreadNumaNode(2), 1);
+  EXPECT_EQ(run_handler_thread_pool.ThreadNumaNode(3), 1);
+  EXPECT_EQ(run_handler_thread_pool.ThreadNumaNode(4), 0);
+  EXPECT_EQ(run_handler_thread_pool.ThreadNumaNode(5), 1);
+}
+
 TEST(RunHandlerThreadPool, RoundRobinExecution) {
   // Set up environment for 1 sub thread pool.
   setenv("TF_RUN_HANDLER_USE_SUB_THREAD_POOL", "true", true);
@@ -811,5 +882,61 @@ TEST_F(RunHandlerTest, TestWaitTimeout) {
   EXPECT_NE(next_handle.get(), nullptr);
 }
 
+// Issues requests from kConcurrentRequests client threads. Each request runs
+// kClosuresPerRequest inter-op closures that fill and reduce a temporary
+// buffer. Reports the QPS as items per second and the p99 request latency.
+// Run on a multi-socket host to compare the NUMA-aware pool (/1) with the
+// default one (/0).
+void BM_RunHandlerPoolRequests(::testing::benchmark::State& state) {
+  const bool use_numa_affinity = state.range(0);
+  setenv("TF_RUN_HANDLER_USE_NUMA_AFFINITY",
+         use_numa_affinity ? "true" : "false", true);
+  constexpr int kConcurrentRequests = 16;
+  constexpr int kClosuresPerRequest = 8;
+  constexpr int kTemporarySize = 256 << 10;
+
+  const int num_threads = port::MaxParallelism();
+  RunHandlerPool pool(num_threads, num_threads);
+  thread::ThreadPool clients(Env::Default(), "clients", kConcurrentRequests);
+  mutex mu;
+  std::vector<int64_t> latencies_us;
+  int64_t step_id = 0;
+  for (auto s : state) {
+    BlockingCounter requests_done(kConcurrentRequests);
+    for (int r = 0; r < kConcurrentRequests; ++r) {
+      clients.Schedule([&, step_id = step_id++]() {
+        const uint64_t start_us = Env::Default()->NowMicros();
+        std::unique_ptr<RunHandler> handler = pool.Get(step_id);
+        BlockingCounter closures_done(kClosuresPerRequest);
+        std::vector<float> sums(kClosuresPerRequest);
+        for (int c = 0; c < kClosuresPerRequest; ++c) {
+          handler->ScheduleInterOpClosure([&closures_done, &sums, c]() {
+            std::vector<float> temporary(kTemporarySize, 1.0f);
+            sums[c] =
+                std::accumulate(temporary.begin(), temporary.end(), 0.0f);
+            closures_done.DecrementCount();
+          });
+        }
+        closures_done.Wait();
+        handler.reset();
+        {
+          mutex_lock l(mu);
+          latencies_us.push_back(Env::Default()->NowMicros() - start_us);
+        }
+        requests_done.DecrementCount();
+      });
+    }
+    requests_done.Wait();
+  }
+  state.SetItemsProcessed(state.iterations() * kConcurrentRequests);
+  if (!latencies_us.empty()) {
+    std::sort(latencies_us.begin(), latencies_us.end());
+    state.counters["p99_us"] =
+        latencies_us[std::min(latencies_us.size() - 1,
+                              latencies_us.size() * 99 / 100)];
+  }
+}
+BENCHMARK(BM_RunHandlerPoolRequests)->Arg(0)->Arg(1)->UseRealTime();
+
 }  // namespace
 }  // namespace tensorflow
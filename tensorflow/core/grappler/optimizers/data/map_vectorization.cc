@@ -0,0 +1,468 @@
+/* Copyright 2026 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow/core/grappler/optimizers/data/map_vectorization.h"
+
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "absl/container/flat_hash_map.h"
+#include "absl/container/flat_hash_set.h"
+#include "absl/strings/str_cat.h"
+#include "tensorflow/core/framework/attr_value.pb.h"
+#include "tensorflow/core/framework/attr_value_util.h"
+#include "tensorflow/core/framework/function.h"
+#include "tensorflow/core/framework/node_def.pb.h"
+#include "tensorflow/core/framework/node_def_util.h"
+#include "tensorflow/core/framework/op.h"
+#include "tensorflow/core/framework/tensor_shape.h"
+#include "tensorflow/core/framework/types.h"
+#include "tensorflow/core/grappler/clusters/cluster.h"
+#include "tensorflow/core/grappler/grappler_item.h"
+#include "tensorflow/core/grappler/mutable_graph_view.h"
+#include "tensorflow/core/grappler/optimizers/custom_graph_optimizer_registry.h"
+#include "tensorflow/core/grappler/optimizers/data/function_utils.h"
+#include "tensorflow/core/grappler/optimizers/data/graph_utils.h"
+#include "tensorflow/core/grappler/utils.h"
+#include "tensorflow/core/lib/gtl/map_util.h"
+
+namespace tensorflow {
+namespace grappler {
+namespace {
+
+constexpr char kBatchDataset[] = "BatchDataset";
+constexpr char kBatchDatasetV2[] = "BatchDatasetV2";
+constexpr char kMapDataset[] = "MapDataset";
+constexpr char kParallelMapDataset[] = "ParallelMapDataset";
+constexpr char kParallelMapDatasetV2[] = "ParallelMapDatasetV2";
+constexpr char kMapDefun[] = "MapDefun";
+constexpr char kConst[] = "Const";
+constexpr char kParseExampleV2[] = "ParseExampleV2";
+constexpr char kFuncAttr[] = "f";
+constexpr char kTargumentsAttr[] = "Targuments";
+constexpr char kOutputShapesAttr[] = "output_shapes";
+constexpr char kOutputTypesAttr[] = "output_types";
+constexpr char kOutputShapesInternalAttr[] = "_output_shapes";
+
+// Ops whose output value at each position only depends on the input value at
+// the same position.
+bool IsUnaryElementwise(const NodeDef& node) {
+  static const auto* const kOps = new absl::flat_hash_set<std::string>(
+      {"Abs", "Cast", "Ceil", "Cos", "Exp", "Expm1", "Floor", "Identity", "Log",
+       "Log1p", "LogicalNot", "Neg", "Reciprocal", "Relu", "Relu6", "Round",
+       "Rsqrt", "Sigmoid", "Sign", "Sin", "Sqrt", "Square", "StopGradient",
+       "Tanh"});
+  return kOps->contains(node.op());
+}
+
+// Ops whose output value at each position only depends on the (broadcast)
+// input values at the same position.
+bool IsBinaryElementwise(const NodeDef& node) {
+  static const auto* const kOps = new absl::flat_hash_set<std::string>(
+      {"Add", "AddV2", "Div", "DivNoNan", "Equal", "FloorDiv", "FloorMod",
+       "Greater", "GreaterEqual", "Less", "LessEqual", "LogicalAnd",
+       "LogicalOr", "Maximum", "Minimum", "Mul", "NotEqual", "Pow", "RealDiv",
+       "SquaredDifference", "Sub", "TruncateDiv"});
+  return kOps->contains(node.op());
+}
+
+bool IsMap(const NodeDef& node) {
+  return node.op() == kMapDataset || node.op() == kParallelMapDataset ||
+         node.op() == kParallelMapDatasetV2;
+}
+
+// What the vectorization knows about a tensor of the map function.
+struct TensorInfo {
+  // Whether the tensor gets a leading batch dimension when the function is
+  // applied to a batch, i.e. whether it depends on the batched arguments.
+  bool batched = false;
+  // The shape of the tensor for a single element. Always fully defined for
+  // batched tensors.
+  PartialTensorShape shape;
+};
+
+using TensorInfoMap = absl::flat_hash_map<std::string, TensorInfo>;
+
+// Returns whether broadcasting an unbatched tensor of shape `shape` against
+// elements of shape `element_shape` leaves the element shape unchanged, so
+// that the batch dimension is not broadcast against any dimension of `shape`.
+bool BroadcastsIntoElement(const PartialTensorShape& shape,
+                           const PartialTensorShape& element_shape) {
+  if (shape.unknown_rank() || shape.dims() > element_shape.dims()) {
+    return false;
+  }
+  for (int i = 1; i <= shape.dims(); ++i) {
+    const int64_t dim = shape.dim_size(shape.dims() - i);
+    if (dim != 1 && dim != element_shape.dim_size(element_shape.dims() - i)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+// Computes the output of a binary element-wise op. Returns false if the batch
+// dimension of the vectorized op could be broadcast differently from the
+// element dimensions.
+bool BinaryElementwiseOutput(const TensorInfo& x, const TensorInfo& y,
+                             TensorInfo* output) {
+  if (x.batched && y.batched) {
+    if (!x.shape.IsIdenticalTo(y.shape)) return false;
+    *output = x;
+    return true;
+  }
+  if (x.batched || y.batched) {
+    const TensorInfo& batched = x.batched ? x : y;
+    const TensorInfo& unbatched = x.batched ? y : x;
+    if (!BroadcastsIntoElement(unbatched.shape, batched.shape)) return false;
+    *output = batched;
+    return true;
+  }
+  output->batched = false;
+  if (x.shape.dims() == 0) {
+    output->shape = y.shape;
+  } else if (y.shape.dims() == 0 || x.shape.IsIdenticalTo(y.shape)) {
+    output->shape = x.shape;
+  } else {
+    output->shape = PartialTensorShape();
+  }
+  return true;
+}
+
+// Infers the outputs of `node` applied to a batch of elements from its
+// `inputs` and adds them to `tensors`. Returns false if `node` cannot be
+// applied to a batch as is.
+bool InferOutputs(const NodeDef& node, const std::vector<TensorInfo>& inputs,
+                  TensorInfoMap* tensors) {
+  const OpDef* op_def;
+  if (!OpRegistry::Global()->LookUpOpDef(node.op(), &op_def).ok() ||
+      op_def->output_arg_size() == 0) {
+    return false;
+  }
+  const std::string output_key =
+      absl::StrCat(node.name(), ":", op_def->output_arg(0).name(), ":0");
+
+  if (node.op() == kConst) {
+    const AttrValue* value = gtl::FindOrNull(node.attr(), "value");
+    if (value == nullptr || !value->has_tensor()) return false;
+    TensorInfo& output = (*tensors)[output_key];
+    output.shape = PartialTensorShape(value->tensor().tensor_shape());
+    return true;
+  }
+  if (IsUnaryElementwise(node)) {
+    if (inputs.size() != 1) return false;
+    (*tensors)[output_key] = inputs[0];
+    return true;
+  }
+  if (IsBinaryElementwise(node)) {
+    if (inputs.size() != 2) return false;
+    TensorInfo output;
+    if (!BinaryElementwiseOutput(inputs[0], inputs[1], &output)) return false;
+    (*tensors)[output_key] = std::move(output);
+    return true;
+  }
+  if (node.op() == kParseExampleV2) {
+    // Parsing a vector of serialized examples produces the dense features of
+    // each example stacked along the batch dimension. Sparse and ragged
+    // features would be merged into a single sparse or ragged tensor instead.
+    int64_t num_sparse;
+    DataTypeVector ragged_value_types;
+    std::vector<PartialTensorShape> dense_shapes;
+    if (!GetNodeAttr(node, "num_sparse", &num_sparse).ok() || num_sparse != 0 ||
+        !GetNodeAttr(node, "ragged_value_types", &ragged_value_types).ok() ||
+        !ragged_value_types.empty() ||
+        !GetNodeAttr(node, "dense_shapes", &dense_shapes).ok()) {
+      return false;
+    }
+    if (inputs.empty() || !inputs[0].batched || inputs[0].shape.dims() != 0) {
+      return false;
+    }
+    for (int i = 1; i < inputs.size(); ++i) {
+      if (inputs[i].batched) return false;
+    }
+    for (int i = 0; i < dense_shapes.size(); ++i) {
+      if (!dense_shapes[i].IsFullyDefined()) return false;
+      TensorInfo& output =
+          (*tensors)[absl::StrCat(node.name(), ":dense_values:", i)];
+      output.batched = true;
+      output.shape = dense_shapes[i];
+    }
+    return true;
+  }
+  return false;
+}
+
+// Returns whether `function` can be applied to a batch of elements as is. The
+// first `element_shapes.size()` arguments of `function` are batched and have
+// the given element shapes, the remaining ones are captured inputs with
+// (possibly unknown) shapes `captured_shapes`.
+bool CanVectorize(const FunctionDef& function,
+                  const std::vector<PartialTensorShape>& element_shapes,
+                  const std::vector<PartialTensorShape>& captured_shapes) {
+  const OpDef& signature = function.signature();
+  TensorInfoMap tensors;
+  for (int i = 0; i < signature.input_arg_size(); ++i) {
+    TensorInfo& info = tensors[signature.input_arg(i).name()];
+    if (i < element_shapes.size()) {
+      info.batched = true;
+      info.shape = element_shapes[i];
+    } else {
+      info.shape = captured_shapes[i - element_shapes.size()];
+    }
+  }
+
+  // The nodes of a function are not necessarily topologically sorted, so the
+  // nodes are visited until the inputs of all of them are known.
+  std::vector<const NodeDef*> pending;
+  for (const NodeDef& node : function.node_def()) {
+    pending.push_back(&node);
+  }
+  while (!pending.empty()) {
+    std::vector<const NodeDef*> blocked;
+    for (const NodeDef* node : pending) {
+      std::vector<TensorInfo> inputs;
+      bool ready = true;
+      for (const std::string& input : node->input()) {
+        if (IsControlInput(input)) continue;
+        auto it = tensors.find(input);
+        if (it == tensors.end()) {
+          ready = false;
+          break;
+        }
+        inputs.push_back(it->second);
+      }
+      if (!ready) {
+        blocked.push_back(node);
+        continue;
+      }
+      if (!InferOutputs(*node, inputs, &tensors)) {
+        VLOG(2) << "Cannot vectorize node " << node->name() << " ("
+                << node->op() << ") of function " << signature.name();
+        return false;
+      }
+    }
+    if (blocked.size() == pending.size()) return false;
+    pending = std::move(blocked);
+  }
+
+  // Unbatched outputs would be produced once per batch instead of once per
+  // element.
+  for (const auto& output_arg : signature.output_arg()) {
+    const std::string* ret = gtl::FindOrNull(function.ret(), output_arg.name());
+    if (ret == nullptr) return false;
+    const TensorInfo* info = gtl::FindOrNull(tensors, *ret);
+    if (info == nullptr || !info->batched) return false;
+  }
+  return true;
+}
+
+// Returns a copy of `function` for batched arguments. Shape annotations of the
+// original function describe single elements and are dropped.
+FunctionDef MakeVectorizedFunction(const FunctionDef& function) {
+  FunctionDef vectorized_function = function;
+  vectorized_function.clear_arg_attr();
+  for (NodeDef& node : *vectorized_function.mutable_node_def()) {
+    node.mutable_attr()->erase(kOutputShapesInternalAttr);
+  }
+  return vectorized_function;
+}
+
+// Returns a function that applies the function of `map_node` to each element
+// of a batch with `MapDefun`.
+FunctionDef MakeMapDefunFunction(const NodeDef& map_node,
+                                 const DataTypeVector& input_types,
+                                 const DataTypeVector& captured_types,
+                                 const DataTypeVector& output_types,
+                                 const std::vector<PartialTensorShape>&
+                                     output_shapes) {
+  FunctionDef function;
+  std::vector<std::string> inputs;
+  for (int i = 0; i < input_types.size(); ++i) {
+    inputs.push_back(absl::StrCat("args_", i));
+    function_utils::AddFunctionInput(inputs.back(), &function, input_types[i]);
+  }
+  for (int i = 0; i < captured_types.size(); ++i) {
+    inputs.push_back(absl::StrCat("captured_", i));
+    function_utils::AddFunctionInput(inputs.back(), &function,
+                                     captured_types[i]);
+  }
+
+  AttrValue targuments_attr;
+  SetAttrValue(input_types, &targuments_attr);
+  AttrValue tcaptured_attr;
+  SetAttrValue(captured_types, &tcaptured_attr);
+  AttrValue output_types_attr;
+  SetAttrValue(output_types, &output_types_attr);
+  AttrValue output_shapes_attr;
+  SetAttrValue(output_shapes, &output_shapes_attr);
+  NodeDef* map_defun = function_utils::AddNode(
+      /*name=*/"", kMapDefun, inputs,
+      {{kTargumentsAttr, targuments_attr},
+       {"Tcaptured", tcaptured_attr},
+       {kOutputTypesAttr, output_types_attr},
+       {kOutputShapesAttr, output_shapes_attr},
+       {kFuncAttr, map_node.attr().at(kFuncAttr)}},
+      &function);
+
+  for (int i = 0; i < output_types.size(); ++i) {
+    const std::string output_name = absl::StrCat("output_", i);
+    OpDef::ArgDef* output_arg = function.mutable_signature()->add_output_arg();
+    output_arg->set_name(output_name);
+    output_arg->set_type(output_types[i]);
+    (*function.mutable_ret())[output_name] =
+        absl::StrCat(map_defun->name(), ":output:", i);
+  }
+  return function;
+}
+
+}  // namespace
+
+absl::Status MapVectorization::OptimizeAndCollectStats(
+    Cluster* cluster, const GrapplerItem& item, GraphDef* output,
+    OptimizationStats* stats) {
+  *output = item.graph;
+  MutableGraphView graph(output);
+  absl::flat_hash_set<std::string> nodes_to_delete;
+  FunctionLibraryDefinition function_library(OpRegistry::Global(),
+                                             item.graph.library());
+
+  for (const NodeDef& node : item.graph.node()) {
+    if (node.op() != kBatchDataset && node.op() != kBatchDatasetV2) {
+      continue;
+    }
+    const NodeDef& batch_node = node;
+    const NodeDef* map_node = graph_utils::GetInputNode(batch_node, graph);
+    if (map_node == nullptr || !IsMap(*map_node)) continue;
+    // The map is removed, so it must not have other consumers.
+    if (graph.GetFanout(graph.GetOutputPort(map_node->name(), 0)).size() !=
+        1) {
+      continue;
+    }
+
+    const FunctionDef* function =
+        function_library.Find(map_node->attr().at(kFuncAttr).func().name());
+    if (function == nullptr ||
+        function_utils::IsFunctionStateful(function_library, *function,
+                                           /*skip_assert=*/true)) {
+      continue;
+    }
+
+    // The input elements are batched ahead of the map, which requires their
+    // shapes to be fully defined. Otherwise, batching could fail on elements
+    // that the map would have brought to the same shape.
+    const NodeDef* input_node = graph_utils::GetInputNode(*map_node, graph);
+    std::vector<PartialTensorShape> element_shapes;
+    DataTypeVector input_types;
+    if (input_node == nullptr ||
+        !GetNodeAttr(*input_node, kOutputShapesAttr, &element_shapes).ok() ||
+        !graph_utils::GetDatasetOutputTypesAttr(*input_node, &input_types)
+             .ok() ||
+        element_shapes.empty() || element_shapes.size() != input_types.size()) {
+      continue;
+    }
+    bool batchable = true;
+    for (int i = 0; i < element_shapes.size(); ++i) {
+      batchable &= element_shapes[i].IsFullyDefined() &&
+                   input_types[i] != DT_VARIANT &&
+                   input_types[i] != DT_RESOURCE;
+    }
+    if (!batchable) continue;
+
+    DataTypeVector captured_types;
+    DataTypeVector output_types;
+    std::vector<PartialTensorShape> output_shapes;
+    if (!GetNodeAttr(*map_node, kTargumentsAttr, &captured_types).ok() ||
+        !GetNodeAttr(*map_node, kOutputTypesAttr, &output_types).ok() ||
+        !GetNodeAttr(*map_node, kOutputShapesAttr, &output_shapes).ok() ||
+        output_types.empty() || output_types.size() != output_shapes.size() ||
+        function->signature().input_arg_size() !=
+            input_types.size() + captured_types.size() ||
+        function->signature().output_arg_size() != output_types.size()) {
+      continue;
+    }
+    std::vector<PartialTensorShape> captured_shapes(captured_types.size());
+    for (int i = 0; i < captured_types.size(); ++i) {
+      const NodeDef* captured_node =
+          graph_utils::GetInputNode(*map_node, graph, i + 1);
+      if (captured_node != nullptr && captured_node->op() == kConst &&
+          captured_node->attr().at("value").has_tensor()) {
+        captured_shapes[i] = PartialTensorShape(
+            captured_node->attr().at("value").tensor().tensor_shape());
+      }
+    }
+
+    AttrValue func_attr = map_node->attr().at(kFuncAttr);
+    FunctionDef vectorized_function;
+    if (CanVectorize(*function, element_shapes, captured_shapes)) {
+      vectorized_function = MakeVectorizedFunction(*function);
+    } else {
+      vectorized_function =
+          MakeMapDefunFunction(*map_node, input_types, captured_types,
+                               output_types, output_shapes);
+      func_attr.mutable_func()->clear_attr();
+    }
+    graph_utils::SetUniqueGraphFunctionName(
+        absl::StrCat("vectorized_", function->signature().name()),
+        output->mutable_library(), &vectorized_function);
+    func_attr.mutable_func()->set_name(vectorized_function.signature().name());
+    *output->mutable_library()->add_function() = vectorized_function;
+
+    // Batches the input of the map, with the batch dimension of the original
+    // batch.
+    int64_t batch_dim = -1;
+    std::vector<PartialTensorShape> batch_output_shapes;
+    if (GetNodeAttr(batch_node, kOutputShapesAttr, &batch_output_shapes).ok() &&
+        !batch_output_shapes.empty() && batch_output_shapes[0].dims() > 0) {
+      batch_dim = batch_output_shapes[0].dim_size(0);
+    }
+    std::vector<PartialTensorShape> batched_shapes;
+    for (const PartialTensorShape& element_shape : element_shapes) {
+      batched_shapes.push_back(
+          PartialTensorShape({batch_dim}).Concatenate(element_shape));
+    }
+    NodeDef new_batch_node = batch_node;
+    graph_utils::SetUniqueGraphNodeName(batch_node.op(), graph.graph(),
+                                        &new_batch_node);
+    new_batch_node.set_input(0, map_node->input(0));
+    SetAttrValue(batched_shapes,
+                 &(*new_batch_node.mutable_attr())[kOutputShapesAttr]);
+    SetAttrValue(input_types,
+                 &(*new_batch_node.mutable_attr())[kOutputTypesAttr]);
+    const NodeDef* new_batch = graph.AddNode(std::move(new_batch_node));
+
+    // Maps the vectorized function over the batches.
+    NodeDef new_map_node = *map_node;
+    graph_utils::SetUniqueGraphNodeName(map_node->op(), graph.graph(),
+                                        &new_map_node);
+    new_map_node.set_input(0, new_batch->name());
+    (*new_map_node.mutable_attr())[kFuncAttr] = std::move(func_attr);
+    graph_utils::CopyShapesAndTypesAttrs(batch_node, &new_map_node);
+    const NodeDef* new_map = graph.AddNode(std::move(new_map_node));
+
+    TF_RETURN_IF_ERROR(graph.UpdateFanouts(batch_node.name(), new_map->name()));
+    nodes_to_delete.insert(map_node->name());
+    nodes_to_delete.insert(batch_node.name());
+    stats->num_changes++;
+  }
+
+  TF_RETURN_IF_ERROR(graph.DeleteNodes(nodes_to_delete));
+  return absl::OkStatus();
+}
+
+REGISTER_GRAPH_OPTIMIZER_AS(MapVectorization, "map_vectorization");
+
+}  // namespace grappler
+}  // namespace tensorflow
@@ -0,0 +1,325 @@
+/* Copyright 2026 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow/core/grappler/optimizers/data/map_vectorization.h"
+
+#include <string>
+#include <vector>
+
+#include "absl/strings/string_view.h"
+#include "tensorflow/core/framework/attr_value_util.h"
+#include "tensorflow/core/framework/function.h"
+#include "tensorflow/core/framework/function_testlib.h"
+#include "tensorflow/core/framework/node_def_util.h"
+#include "tensorflow/core/framework/tensor.h"
+#include "tensorflow/core/framework/tensor_shape.h"
+#include "tensorflow/core/framework/tensor_testutil.h"
+#include "tensorflow/core/grappler/grappler_item.h"
+#include "tensorflow/core/grappler/optimizers/data/function_utils.h"
+#include "tensorflow/core/grappler/optimizers/data/graph_utils.h"
+#include "tensorflow/core/lib/core/status_test_util.h"
+#include "tensorflow/core/platform/test.h"
+
+namespace tensorflow {
+namespace grappler {
+namespace {
+
+using test::function::NDef;
+using FDH = FunctionDefHelper;
+
+NodeDef MakeMapNode(absl::string_view name, absl::string_view input_node_name,
+                    FDH::AttrValueWrapper function, DataType output_type,
+                    const PartialTensorShape& output_shape) {
+  return NDef(name, "MapDataset", {std::string(input_node_name)},
+              {{"f", function},
+               {"Targuments", {}},
+               {"output_shapes", std::vector<PartialTensorShape>{output_shape}},
+               {"output_types", DataTypeVector{output_type}}});
+}
+
+NodeDef MakeBatchNode(absl::string_view name, absl::string_view input_node_name,
+                      DataType output_type,
+                      const PartialTensorShape& element_shape) {
+  return NDef(
+      name, "BatchDatasetV2",
+      {std::string(input_node_name), "batch_size", "drop_remainder"},
+      {{"parallel_copy", false},
+       {"output_shapes",
+        std::vector<PartialTensorShape>{
+            PartialTensorShape({-1}).Concatenate(element_shape)}},
+       {"output_types", DataTypeVector{output_type}}});
+}
+
+NodeDef MakeRangeNode(const PartialTensorShape& shape) {
+  return NDef("range", "RangeDataset", {"start", "stop", "step"},
+              {{"output_shapes", std::vector<PartialTensorShape>{shape}},
+               {"output_types", DataTypeVector{DT_INT64}}});
+}
+
+// Returns a pipeline `range -> map(function) -> batch`.
+GrapplerItem MakeMapAndBatchItem(FDH::AttrValueWrapper function,
+                                 const PartialTensorShape& range_shape,
+                                 const PartialTensorShape& output_shape,
+                                 const std::vector<FunctionDef>& library) {
+  GrapplerItem item;
+  item.graph = test::function::GDef(
+      {NDef("start", "Const", {}, {{"value", 0}, {"dtype", DT_INT64}}),
+       NDef("stop", "Const", {}, {{"value", 10}, {"dtype", DT_INT64}}),
+       NDef("step", "Const", {}, {{"value", 1}, {"dtype", DT_INT64}}),
+       NDef("batch_size", "Const", {}, {{"value", 5}, {"dtype", DT_INT64}}),
+       NDef("drop_remainder", "Const", {},
+            {{"value", false}, {"dtype", DT_BOOL}}),
+       MakeRangeNode(range_shape),
+       MakeMapNode("map", "range", function, DT_INT64, output_shape),
+       MakeBatchNode("batch", "map", DT_INT64, output_shape),
+       NDef("Sink", "Identity", {"batch"}, {})},
+      library);
+  item.fetch.push_back("Sink");
+  return item;
+}
+
+// Adds a vector of constants to a scalar. Applied to a batch of scalars, the
+// addition would broadcast the batch against the vector.
+FunctionDef XPlusVector() {
+  return FDH::Create(
+      "XPlusVector", {"x: int64"}, {"y: int64"}, {},
+      {{{"v"},
+        "Const",
+        {},
+        {{"value", test::AsTensor<int64_t>({1, 2, 3})}, {"dtype", DT_INT64}}},
+       {{"y"}, "AddV2", {"x", "v:output:0"}, {{"T", DT_INT64}}}},
+      {{"y", "y:z:0"}});
+}
+
+// Parses a dense feature of two floats and normalizes it.
+FunctionDef ParseAndNormalize() {
+  const Tensor kEmptyStrings(DT_STRING, TensorShape({0}));
+  return FDH::Create(
+      "ParseAndNormalize", {"serialized: string"}, {"features: float"}, {},
+      {{{"names"},
+        "Const",
+        {},
+        {{"value", kEmptyStrings}, {"dtype", DT_STRING}}},
+       {{"sparse_keys"},
+        "Const",
+        {},
+        {{"value", kEmptyStrings}, {"dtype", DT_STRING}}},
+       {{"dense_keys"},
+        "Const",
+        {},
+        {{"value", test::AsTensor<tstring>({"x"})}, {"dtype", DT_STRING}}},
+       {{"ragged_keys"},
+        "Const",
+        {},
+        {{"value", kEmptyStrings}, {"dtype", DT_STRING}}},
+       {{"dense_default"},
+        "Const",
+        {},
+        {{"value", Tensor(DT_FLOAT, TensorShape({0}))}, {"dtype", DT_FLOAT}}},
+       {{"parse"},
+        "ParseExampleV2",
+        {"serialized", "names:output:0", "sparse_keys:output:0",
+         "dense_keys:output:0", "ragged_keys:output:0",
+         "dense_default:output:0"},
+        {{"Tdense", DataTypeVector{DT_FLOAT}},
+         {"num_sparse", 0},
+         {"sparse_types", DataTypeVector{}},
+         {"ragged_value_types", DataTypeVector{}},
+         {"ragged_split_types", DataTypeVector{}},
+         {"dense_shapes",
+          std::vector<PartialTensorShape>{PartialTensorShape({2})}}}},
+       {{"mean"},
+        "Const",
+        {},
+        {{"value", test::AsTensor<float>({1.0f, 2.0f})}, {"dtype", DT_FLOAT}}},
+       {{"centered"},
+        "Sub",
+        {"parse:dense_values:0", "mean:output:0"},
+        {{"T", DT_FLOAT}}},
+       {{"scale"},
+        "Const",
+        {},
+        {{"value", test::AsScalar<float>(0.5f)}, {"dtype", DT_FLOAT}}},
+       {{"features"},
+        "Mul",
+        {"centered:z:0", "scale:output:0"},
+        {{"T", DT_FLOAT}}}},
+      {{"features", "features:z:0"}});
+}
+
+const FunctionDef& GetMapFunction(const NodeDef& map_node,
+                                  const GraphDef& graph) {
+  return graph.library().function(graph_utils::FindGraphFunctionWithName(
+      map_node.attr().at("f").func().name(), graph.library()));
+}
+
+TEST(MapVectorizationTest, VectorizesElementwiseFunction) {
+  GrapplerItem item = MakeMapAndBatchItem(
+      FDH::FunctionRef("XTimesTwo", {{"T", DT_INT64}}), PartialTensorShape({}),
+      PartialTensorShape({}), {test::function::XTimesTwo()});
+
+  MapVectorization optimizer;
+  GraphDef output;
+  TF_ASSERT_OK(optimizer.Optimize(nullptr, item, &output));
+  EXPECT_FALSE(graph_utils::ContainsGraphNodeWithName("map", output));
+  EXPECT_FALSE(graph_utils::ContainsGraphNodeWithName("batch", output));
+
+  const NodeDef& batch_node = output.node(
+      graph_utils::FindGraphNodeWithOp("BatchDatasetV2", output));
+  const NodeDef& map_node =
+      output.node(graph_utils::FindGraphNodeWithOp("MapDataset", output));
+  EXPECT_EQ(batch_node.input(0), "range");
+  EXPECT_EQ(batch_node.input(1), "batch_size");
+  EXPECT_EQ(batch_node.input(2), "drop_remainder");
+  EXPECT_EQ(map_node.input(0), batch_node.name());
+  EXPECT_EQ(output.node(graph_utils::FindGraphNodeWithName("Sink", output))
+                .input(0),
+            map_node.name());
+
+  std::vector<PartialTensorShape> batch_output_shapes;
+  TF_ASSERT_OK(
+      GetNodeAttr(batch_node, "output_shapes", &batch_output_shapes));
+  ASSERT_EQ(batch_output_shapes.size(), 1);
+  EXPECT_TRUE(batch_output_shapes[0].IsIdenticalTo(PartialTensorShape({-1})));
+
+  const FunctionDef& function = GetMapFunction(map_node, output);
+  EXPECT_EQ(function.signature().name(), "vectorized_XTimesTwo");
+  EXPECT_TRUE(function_utils::ContainsFunctionNodeWithOp("Mul", function));
+  EXPECT_FALSE(
+      function_utils::ContainsFunctionNodeWithOp("MapDefun", function));
+  EXPECT_EQ(map_node.attr().at("f").func().attr().at("T").type(), DT_INT64);
+}
+
+TEST(MapVectorizationTest, VectorizesParseAndNormalize) {
+  GrapplerItem item;
+  item.graph = test::function::GDef(
+      {NDef("serialized", "Const", {},
+            {{"value", test::AsTensor<tstring>({"a", "b"})},
+             {"dtype", DT_STRING}}),
+       NDef("batch_size", "Const", {}, {{"value", 5}, {"dtype", DT_INT64}}),
+       NDef("drop_remainder", "Const", {},
+            {{"value", false}, {"dtype", DT_BOOL}}),
+       NDef("examples", "TensorSliceDataset", {"serialized"},
+            {{"Toutput_types", DataTypeVector{DT_STRING}},
+             {"output_shapes",
+              std::vector<PartialTensorShape>{PartialTensorShape({})}}}),
+       NDef("map", "MapDataset", {"examples"},
+            {{"f", FDH::FunctionRef("ParseAndNormalize")},
+             {"Targuments", {}},
+             {"output_shapes",
+              std::vector<PartialTensorShape>{PartialTensorShape({2})}},
+             {"output_types", DataTypeVector{DT_FLOAT}}}),
+       MakeBatchNode("batch", "map", DT_FLOAT, PartialTensorShape({2})),
+       NDef("Sink", "Identity", {"batch"}, {})},
+      {ParseAndNormalize()});
+  item.fetch.push_back("Sink");
+
+  MapVectorization optimizer;
+  GraphDef output;
+  TF_ASSERT_OK(optimizer.Optimize(nullptr, item, &output));
+  const NodeDef& map_node =
+      output.node(graph_utils::FindGraphNodeWithOp("MapDataset", output));
+  EXPECT_EQ(output.node(graph_utils::FindGraphNodeWithName(map_node.input(0),
+                                                           output))
+                .input(0),
+            "examples");
+  const FunctionDef& function = GetMapFunction(map_node, output);
+  EXPECT_TRUE(
+      function_utils::ContainsFunctionNodeWithOp("ParseExampleV2", function));
+  EXPECT_FALSE(
+      function_utils::ContainsFunctionNodeWithOp("MapDefun", function));
+}
+
+TEST(MapVectorizationTest, FallsBackToMapDefun) {
+  GrapplerItem item = MakeMapAndBatchItem(
+      FDH::FunctionRef("XTimesFour", {{"T", DT_INT64}}), PartialTensorShape({}),
+      PartialTensorShape({}),
+      {test::function::XTimesTwo(), test::function::XTimesFour()});
+
+  MapVectorization optimizer;
+  GraphDef output;
+  TF_ASSERT_OK(optimizer.Optimize(nullptr, item, &output));
+  EXPECT_FALSE(graph_utils::ContainsGraphNodeWithName("map", output));
+
+  const NodeDef& map_node =
+      output.node(graph_utils::FindGraphNodeWithOp("MapDataset", output));
+  EXPECT_TRUE(map_node.attr().at("f").func().attr().empty());
+  const FunctionDef& function = GetMapFunction(map_node, output);
+  EXPECT_EQ(function.signature().name(), "vectorized_XTimesFour");
+  const int map_defun_index =
+      function_utils::FindFunctionNodeWithOp("MapDefun", function);
+  ASSERT_NE(map_defun_index, -1);
+  const NodeDef& map_defun = function.node_def(map_defun_index);
+  EXPECT_EQ(map_defun.attr().at("f").func().name(), "XTimesFour");
+  EXPECT_EQ(map_defun.attr().at("f").func().attr().at("T").type(), DT_INT64);
+  EXPECT_EQ(map_defun.input(0), function.signature().input_arg(0).name());
+}
+
+TEST(MapVectorizationTest, FallsBackToMapDefunIfBroadcastingChanges) {
+  GrapplerItem item = MakeMapAndBatchItem(
+      FDH::FunctionRef("XPlusVector"), PartialTensorShape({}),
+      PartialTensorShape({3}), {XPlusVector()});
+
+  MapVectorization optimizer;
+  GraphDef output;
+  TF_ASSERT_OK(optimizer.Optimize(nullptr, item, &output));
+  const NodeDef& map_node =
+      output.node(graph_utils::FindGraphNodeWithOp("MapDataset", output));
+  EXPECT_TRUE(function_utils::ContainsFunctionNodeWithOp(
+      "MapDefun", GetMapFunction(map_node, output)));
+}
+
+TEST(MapVectorizationTest, NoChangeIfInputShapeIsUnknown) {
+  GrapplerItem item = MakeMapAndBatchItem(
+      FDH::FunctionRef("XTimesTwo", {{"T", DT_INT64}}),
+      PartialTensorShape({-1}), PartialTensorShape({-1}),
+      {test::function::XTimesTwo()});
+
+  MapVectorization optimizer;
+  GraphDef output;
+  TF_ASSERT_OK(optimizer.Optimize(nullptr, item, &output));
+  EXPECT_TRUE(graph_utils::ContainsGraphNodeWithName("map", output));
+  EXPECT_TRUE(graph_utils::ContainsGraphNodeWithName("batch", output));
+}
+
+TEST(MapVectorizationTest, NoChangeForStatefulFunction) {
+  GrapplerItem item = MakeMapAndBatchItem(
+      FDH::FunctionRef("RandomUniformFn"), PartialTensorShape({}),
+      PartialTensorShape({}), {test::function::RandomUniform()});
+
+  MapVectorization optimizer;
+  GraphDef output;
+  TF_ASSERT_OK(optimizer.Optimize(nullptr, item, &output));
+  EXPECT_TRUE(graph_utils::ContainsGraphNodeWithName("map", output));
+  EXPECT_TRUE(graph_utils::ContainsGraphNodeWithName("batch", output));
+}
+
+TEST(MapVectorizationTest, NoChangeIfMapHasOtherConsumers) {
+  GrapplerItem item = MakeMapAndBatchItem(
+      FDH::FunctionRef("XTimesTwo", {{"T", DT_INT64}}), PartialTensorShape({}),
+      PartialTensorShape({}), {test::function::XTimesTwo()});
+  *item.graph.add_node() = NDef("Sink2", "Identity", {"map"}, {});
+  item.fetch.push_back("Sink2");
+
+  MapVectorization optimizer;
+  GraphDef output;
+  TF_ASSERT_OK(optimizer.Optimize(nullptr, item, &output));
+  EXPECT_TRUE(graph_utils::ContainsGraphNodeWithName("map", output));
+  EXPECT_TRUE(graph_utils::ContainsGraphNodeWithName("batch", output));
+}
+
+}  // namespace
+}  // namespace grappler
+}  // namespace tensorflow
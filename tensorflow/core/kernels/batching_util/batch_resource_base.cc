@@ -1342,10 +1342,10 @@ void BatchResourceBase::ProcessFuncBatch(
       batch->task(batch->num_tasks() - 1).captured_inputs;
   args.insert(args.end(), captured_inputs.begin(), captured_inputs.end());
 
-  RecordBatchDelayMetrics(
-      *batch, model_name, op_name, processed_size,
-      /*batch_schedule_time=*/absl::FromUnixNanos(EnvTime::NowNanos()),
-      GetBatchTimeout());
+  const absl::Time batch_schedule_time =
+      absl::FromUnixNanos(EnvTime::NowNanos());
+  RecordBatchDelayMetrics(*batch, model_name, op_name, processed_size,
+                          batch_schedule_time, GetBatchTimeout());
 
   // Releases the cleanup method here, because the callback of the function
   // library runtime will handle it now.
@@ -1366,6 +1366,17 @@ void BatchResourceBase::ProcessFuncBatch(
                          if (!final_status.ok()) {
                            return;
                          }
+                         // Register the batch latency for in-process use.
+                         const absl::Duration latency =
+                             absl::FromUnixNanos(EnvTime::NowNanos()) -
+                             batch_schedule_time;
+                         if (latency > absl::ZeroDuration()) {
+                           GlobalBatchStatsRegistry()
+                               .model(model_name, op_name)
+                               .batch_size(processed_size)
+                               .latency()
+                               .Register(latency);
+                         }
                          if (last_task.forced_warmup_batch_size == 0) {
                            final_status = SplitOutputTensors(
                                combined_outputs, batch.get(), unbatched_tasks);
@@ -138,6 +138,8 @@ class BatchResourceBase : public ResourceBase {
 
     bool IsDeadlineExceeded(absl::Time now) const override;
 
+    std::optional<absl::Time> deadline() const override { return rpc_deadline; }
+
     bool IsCancelled() const override;
 
     // Create a split task from this one. The caller needs to setup the inputs
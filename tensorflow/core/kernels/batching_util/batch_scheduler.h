@@ -37,6 +37,7 @@ limitations under the License.
 #include <iterator>
 #include <memory>
 #include <optional>
+#include <type_traits>
 #include <utility>
 #include <vector>
 
@@ -112,6 +113,10 @@ class BatchTask {
   // `now` is passed by the caller to amortize absl::Now() across iterations.
   virtual bool IsDeadlineExceeded(absl::Time now) const { return false; }
 
+  // Returns the time by which the task must complete, if it has one (e.g. the
+  // deadline of the RPC that issued it).
+  virtual std::optional<absl::Time> deadline() const { return std::nullopt; }
+
   // Returns true if the RPC has been cancelled by the client.
   virtual bool IsCancelled() const { return false; }
 
@@ -366,6 +371,10 @@ class Batch {
   // empty, return the null value.
   std::optional<uint64_t> EarliestTaskStartTime() const;
 
+  // Returns the earliest deadline of the tasks in the batch, or the null value
+  // if none of them has a deadline.
+  std::optional<absl::Time> EarliestTaskDeadline() const;
+
  private:
   mutable mutex mu_;
 
@@ -387,6 +396,9 @@ class Batch {
   // If the batch is empty, the value is undefined.
   uint64_t earliest_task_start_time_micros_ TF_GUARDED_BY(mu_);
 
+  // The minimum deadline of all tasks in the batch that have one.
+  std::optional<absl::Time> earliest_task_deadline_ TF_GUARDED_BY(mu_);
+
   Batch(const Batch&) = delete;
   void operator=(const Batch&) = delete;
 };
@@ -502,6 +514,13 @@ void Batch<TaskType>::AddTask(std::unique_ptr<TaskType> task,
       earliest_task_start_time_micros_ =
           std::min(earliest_task_start_time_micros_, start_time_micros);
     }
+    if constexpr (std::is_base_of_v<BatchTask, TaskType>) {
+      std::optional<absl::Time> deadline = tasks_.back()->deadline();
+      if (deadline.has_value() && (!earliest_task_deadline_.has_value() ||
+                                   *deadline < *earliest_task_deadline_)) {
+        earliest_task_deadline_ = deadline;
+      }
+    }
   }
 }
 
@@ -516,6 +535,14 @@ std::optional<uint64_t> Batch<TaskType>::EarliestTaskStartTime() const {
   }
 }
 
+template <typename TaskType>
+std::optional<absl::Time> Batch<TaskType>::EarliestTaskDeadline() const {
+  {
+    mutex_lock l(mu_);
+    return earliest_task_deadline_;
+  }
+}
+
 template <typename TaskType>
 std::vector<std::unique_ptr<TaskType>> Batch<TaskType>::RemoveAllTasks() {
   DCHECK(IsClosed());
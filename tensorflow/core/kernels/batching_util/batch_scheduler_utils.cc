@@ -75,6 +75,82 @@ int32_t GetPrevAllowedBatchSize(int batch_size,
   return *result;
 }
 
+namespace {
+
+// Implements the MAXIMIZE_THROUGHPUT_PER_COST batch padding policy.
+int MaximizeThroughputPerCost(int candidate_size,
+                              const std::vector<int32_t>& allowed_batch_sizes,
+                              bool disable_padding,
+                              ModelBatchStats& model_batch_stats) {
+  const int32_t pad_up_size = GetNextAllowedBatchSize(
+      candidate_size, allowed_batch_sizes, disable_padding);
+  if (pad_up_size == candidate_size) {
+    return candidate_size;  // Good, no padding is necessary.
+  }
+  std::vector<int32_t> batch_down_sizes;  // In decreasing order.
+  for (auto it = allowed_batch_sizes.rbegin(); it != allowed_batch_sizes.rend();
+       ++it) {
+    if (*it < candidate_size) {
+      batch_down_sizes.push_back(*it);
+    }
+  }
+  if (batch_down_sizes.empty()) {
+    return candidate_size;
+  }
+
+  // All options are compared using the same measure: the TPU cost if it is
+  // known for the padded size, the batch latency otherwise.
+  const bool use_tpu_cost =
+      model_batch_stats.batch_size(pad_up_size).tpu_cost().mean().has_value();
+  auto mean_cost = [&](int32_t batch_size) {
+    BatchSizeStats& stats = model_batch_stats.batch_size(batch_size);
+    return use_tpu_cost ? stats.tpu_cost().mean() : stats.latency().mean();
+  };
+  const int64_t latency_slo_micros = model_batch_stats.latency_slo_micros();
+  auto meets_latency_slo = [&](int32_t batch_size) {
+    if (latency_slo_micros <= 0) return true;
+    std::optional<absl::Duration> latency =
+        model_batch_stats.batch_size(batch_size).latency().mean();
+    return !latency.has_value() ||
+           *latency <= absl::Microseconds(latency_slo_micros);
+  };
+  const bool explore = model_batch_stats.RegisterPaddingDecision() %
+                           kPaddingPolicyExplorationInterval ==
+                       kPaddingPolicyExplorationInterval - 1;
+
+  std::optional<absl::Duration> pad_up_cost = mean_cost(pad_up_size);
+  if (!pad_up_cost.has_value()) {
+    // Padding up is the default, and how we learn the cost of the padded size.
+    return candidate_size;
+  }
+  // Number of real requests processed per second of cost.
+  int best_size = candidate_size;
+  double best_throughput =
+      candidate_size / absl::ToDoubleSeconds(*pad_up_cost);
+  bool best_meets_latency_slo = meets_latency_slo(pad_up_size);
+  for (int32_t batch_down_size : batch_down_sizes) {
+    std::optional<absl::Duration> cost = mean_cost(batch_down_size);
+    if (!cost.has_value()) {
+      if (explore) {
+        return batch_down_size;
+      }
+      continue;
+    }
+    if (!meets_latency_slo(batch_down_size)) {
+      continue;
+    }
+    const double throughput = batch_down_size / absl::ToDoubleSeconds(*cost);
+    if (!best_meets_latency_slo || throughput > best_throughput) {
+      best_size = batch_down_size;
+      best_throughput = throughput;
+      best_meets_latency_slo = true;
+    }
+  }
+  return best_size;
+}
+
+}  // namespace
+
 int ApplyBatchPaddingPolicy(int candidate_size,
                             const std::vector<int32_t>& allowed_batch_sizes,
                             bool disable_padding,
@@ -86,6 +162,19 @@ int ApplyBatchPaddingPolicy(int candidate_size,
   if (batch_padding_policy == kPadUpPolicy) {
     return candidate_size;
   }
+  if (batch_padding_policy == kMaximizeThroughputPerCostPolicy) {
+    if (model_batch_stats == nullptr) {
+      LOG_FIRST_N(ERROR, 1)
+          << kMaximizeThroughputPerCostPolicy
+          << " batch padding policy has been chosen "
+             "but no ModelBatchStats passed to the batch scheduler; will "
+             "fall back on the "
+          << kPadUpPolicy << " policy.";
+      return candidate_size;
+    }
+    return MaximizeThroughputPerCost(candidate_size, allowed_batch_sizes,
+                                     disable_padding, *model_batch_stats);
+  }
   bool minimize_tpu_cost_per_request;
   if (batch_padding_policy == kBatchDownPolicy) {
     minimize_tpu_cost_per_request = false;
@@ -174,6 +263,20 @@ void RecordLazyCancelledTaskMetrics(int64_t size, absl::string_view reason) {
   size_cell->GetCell(std::string(reason))->IncrementBy(size);
 }
 
+void RecordDeadlineRejectedTaskMetrics(int64_t size) {
+  static auto* count_cell = tensorflow::monitoring::Counter<0>::New(
+      "/tensorflow/serving/batching/deadline_rejected_task_count",
+      "Tracks the number of tasks rejected on arrival because they could not "
+      "complete before their deadline.");
+  count_cell->GetCell()->IncrementBy(1);
+
+  static auto* size_cell = tensorflow::monitoring::Counter<0>::New(
+      "/tensorflow/serving/batching/deadline_rejected_task_size",
+      "Tracks the sum of task sizes rejected on arrival because they could "
+      "not complete before their deadline.");
+  size_cell->GetCell()->IncrementBy(size);
+}
+
 }  // namespace internal
 }  // namespace serving
 }  // namespace tensorflow
@@ -65,11 +65,26 @@ int ApplyBatchPaddingPolicy(int candidate_size,
 //     to either PAD_UP or BATCH_DOWN so as to minimize the TPU costs per
 //     real request. In this case, it would compare (batch_16_cost / 16) and
 //     (batch_32_cost / 18).
+//   - MAXIMIZE_THROUGHPUT_PER_COST: a profile-guided policy that considers
+//     padding up and batching down to every smaller allowed size (16, but
+//     also 8, 4, ...), and picks the option that processes the most real
+//     requests per unit of cost, e.g. the largest of (16 / batch_16_cost),
+//     (8 / batch_8_cost) and (18 / batch_32_cost). The cost is the TPU cost
+//     when it is known for the padded size and the batch latency otherwise.
+//     Sizes whose mean latency exceeds the model's latency SLO are avoided.
+//     Once every `kPaddingPolicyExplorationInterval` decisions, the policy
+//     batches down to a smaller allowed size it has no statistics for yet, so
+//     that it learns the costs of all allowed sizes online.
 //
 inline constexpr absl::string_view kBatchDownPolicy = "BATCH_DOWN";
 inline constexpr absl::string_view kPadUpPolicy = "PAD_UP";
 inline constexpr absl::string_view kMinimizeTpuCostPerRequestPolicy =
     "MINIMIZE_TPU_COST_PER_REQUEST";
+inline constexpr absl::string_view kMaximizeThroughputPerCostPolicy =
+    "MAXIMIZE_THROUGHPUT_PER_COST";
+
+// See MAXIMIZE_THROUGHPUT_PER_COST above.
+inline constexpr int64_t kPaddingPolicyExplorationInterval = 64;
 
 // Trims the batch to the next allowed batch size when possible and when
 // configured by batch_padding_policy.
@@ -104,6 +119,10 @@ inline constexpr absl::string_view kLazyCancellationReasonRpcCancelled =
 
 void RecordLazyCancelledTaskMetrics(int64_t size, absl::string_view reason);
 
+// Records a task rejected on arrival because it could not complete before its
+// deadline.
+void RecordDeadlineRejectedTaskMetrics(int64_t size);
+
 }  // namespace internal
 }  // namespace serving
 }  // namespace tensorflow
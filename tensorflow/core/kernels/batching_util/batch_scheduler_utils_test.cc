@@ -245,6 +245,94 @@ TEST(ApplyBatchPaddingPolicyTest,
             3);
 }
 
+TEST(ApplyBatchPaddingPolicyTest,
+     MaximizeThroughputPerCostPicksAnySmallerSize) {
+  ModelBatchStats model_batch_stats;
+  model_batch_stats.batch_size(2).tpu_cost().Register(absl::Seconds(1));
+  model_batch_stats.batch_size(4).tpu_cost().Register(absl::Seconds(1.5));
+  model_batch_stats.batch_size(8).tpu_cost().Register(absl::Seconds(2.5));
+
+  // 4 / 1.5 beats 2 / 1 and 6 / 2.5.
+  EXPECT_EQ(ApplyBatchPaddingPolicy(6, {2, 4, 8}, false,
+                                    kMaximizeThroughputPerCostPolicy,
+                                    &model_batch_stats),
+            4);
+  // 7 / 2.5 beats 4 / 1.5.
+  EXPECT_EQ(ApplyBatchPaddingPolicy(7, {2, 4, 8}, false,
+                                    kMaximizeThroughputPerCostPolicy,
+                                    &model_batch_stats),
+            7);
+}
+
+TEST(ApplyBatchPaddingPolicyTest,
+     MaximizeThroughputPerCostFallsBackOnLatency) {
+  ModelBatchStats model_batch_stats;
+  model_batch_stats.batch_size(2).latency().Register(absl::Milliseconds(2));
+  model_batch_stats.batch_size(4).latency().Register(absl::Milliseconds(5));
+
+  EXPECT_EQ(ApplyBatchPaddingPolicy(3, {2, 4}, false,
+                                    kMaximizeThroughputPerCostPolicy,
+                                    &model_batch_stats),
+            2);
+}
+
+TEST(ApplyBatchPaddingPolicyTest,
+     MaximizeThroughputPerCostRespectsLatencySlo) {
+  ModelBatchStats model_batch_stats;
+  model_batch_stats.batch_size(2).tpu_cost().Register(absl::Seconds(2));
+  model_batch_stats.batch_size(4).tpu_cost().Register(absl::Seconds(2.1));
+  model_batch_stats.batch_size(2).latency().Register(absl::Milliseconds(3));
+  model_batch_stats.batch_size(4).latency().Register(absl::Milliseconds(6));
+
+  EXPECT_EQ(ApplyBatchPaddingPolicy(3, {2, 4}, false,
+                                    kMaximizeThroughputPerCostPolicy,
+                                    &model_batch_stats),
+            3);
+  // Padding up to 4 is cheaper per request but misses the SLO.
+  model_batch_stats.SetLatencySloMicros(5000);
+  EXPECT_EQ(ApplyBatchPaddingPolicy(3, {2, 4}, false,
+                                    kMaximizeThroughputPerCostPolicy,
+                                    &model_batch_stats),
+            2);
+}
+
+TEST(ApplyBatchPaddingPolicyTest,
+     MaximizeThroughputPerCostMissingPadUpCostReturnsCandidateSize) {
+  ModelBatchStats model_batch_stats;
+  model_batch_stats.batch_size(2).tpu_cost().Register(absl::Seconds(1));
+
+  EXPECT_EQ(ApplyBatchPaddingPolicy(3, {2, 4}, false,
+                                    kMaximizeThroughputPerCostPolicy,
+                                    &model_batch_stats),
+            3);
+}
+
+TEST(ApplyBatchPaddingPolicyTest,
+     MaximizeThroughputPerCostExploresSizesWithoutStats) {
+  ModelBatchStats model_batch_stats;
+  model_batch_stats.batch_size(8).tpu_cost().Register(absl::Seconds(1));
+
+  int num_explored = 0;
+  for (int i = 0; i < kPaddingPolicyExplorationInterval; ++i) {
+    const int size = ApplyBatchPaddingPolicy(
+        6, {2, 4, 8}, false, kMaximizeThroughputPerCostPolicy,
+        &model_batch_stats);
+    if (size != 6) {
+      // The largest smaller size without stats.
+      EXPECT_EQ(size, 4);
+      ++num_explored;
+    }
+  }
+  EXPECT_EQ(num_explored, 1);
+}
+
+TEST(ApplyBatchPaddingPolicyTest,
+     MaximizeThroughputPerCostNoModelStatsReturnsCandidateSize) {
+  EXPECT_EQ(ApplyBatchPaddingPolicy(3, {2, 4}, false,
+                                    kMaximizeThroughputPerCostPolicy, nullptr),
+            3);
+}
+
 TEST(ApplyBatchPaddingPolicyTest, UnsupportedPolicy) {
   EXPECT_EQ(ApplyBatchPaddingPolicy(3, {2, 4}, false, "UNSUPPORTED", nullptr),
             3);
@@ -69,6 +69,7 @@ namespace tensorflow::serving {
 // Default values for when there is no recorded statistic in ModelBatchStats.
 constexpr int64_t kNumBatchThreadsUnknown = -1;
 constexpr int64_t kBatchTimeoutMicrosUnknown = -1;
+constexpr int64_t kLatencySloMicrosUnknown = -1;
 
 // Tracks the average cost of registered samples.
 //
@@ -122,8 +123,13 @@ class BatchSizeStats {
  public:
   CostTracker& tpu_cost() { return tpu_cost_; };
 
+  // Tracks the wall time it takes to process a batch of this size, from the
+  // moment the batch is scheduled until its outputs are available.
+  CostTracker& latency() { return latency_; };
+
  private:
   CostTracker tpu_cost_;
+  CostTracker latency_;
 };
 
 // Tracks statistics for a particular model.
@@ -188,6 +194,24 @@ class ModelBatchStats {
     return batch_timeout_micros_.load(std::memory_order_relaxed);
   }
 
+  // Sets the latency objective for processing a batch of this model. Batch
+  // padding policies that use batch statistics avoid batch sizes whose mean
+  // latency exceeds it.
+  void SetLatencySloMicros(int64_t latency_slo_micros) {
+    latency_slo_micros_.store(latency_slo_micros, std::memory_order_relaxed);
+  }
+
+  int64_t latency_slo_micros() const {
+    return latency_slo_micros_.load(std::memory_order_relaxed);
+  }
+
+  // Returns the number of batch padding decisions made for this model before
+  // this one. Used by batch padding policies to occasionally explore batch
+  // sizes they have no statistics for.
+  int64_t RegisterPaddingDecision() {
+    return num_padding_decisions_.fetch_add(1, std::memory_order_relaxed);
+  }
+
  private:
   mutable mutex mu_;
 
@@ -212,6 +236,12 @@ class ModelBatchStats {
   // The timeout in microseconds for this model (after which the current batch
   // is sent to be processed by the TPU).
   std::atomic<int64_t> batch_timeout_micros_ = kBatchTimeoutMicrosUnknown;
+
+  // The latency objective for processing a batch of this model.
+  std::atomic<int64_t> latency_slo_micros_ = kLatencySloMicrosUnknown;
+
+  // The number of batch padding decisions made for this model.
+  std::atomic<int64_t> num_padding_decisions_ = 0;
 };
 
 // Tracks batch statistics for all models.
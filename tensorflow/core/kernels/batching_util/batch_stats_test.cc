@@ -148,6 +148,22 @@ TEST(BatchStatsTest, NumBatchThreadsIsCorrect) {
   ASSERT_EQ(stats.num_batch_threads(), 16);
 }
 
+TEST(BatchStatsTest, LatencySloIsCorrect) {
+  ModelBatchStats stats;
+
+  // Originally the latency SLO is -1 if unassigned.
+  ASSERT_EQ(stats.latency_slo_micros(), -1);
+
+  stats.SetLatencySloMicros(2000);
+  ASSERT_EQ(stats.latency_slo_micros(), 2000);
+}
+
+TEST(BatchStatsTest, PaddingDecisionsAreCounted) {
+  ModelBatchStats stats;
+  ASSERT_EQ(stats.RegisterPaddingDecision(), 0);
+  ASSERT_EQ(stats.RegisterPaddingDecision(), 1);
+}
+
 }  // namespace
 
 }  // namespace tensorflow::serving
@@ -102,7 +102,8 @@ namespace serving {
 // down over the lifetime of a server.
 //
 // The batch thread pool round-robins through the queues, running one batch
-// from a queue and then moving to the next queue. Each queue behaves like a
+// from a queue and then moving to the next queue. (Options can instead rank
+// batches by priority, or by deadline.) Each queue behaves like a
 // BasicBatchScheduler instance, in the sense that it has maximum batch size and
 // timeout parameters, which govern when a batch is eligible to be processed.
 //
@@ -163,6 +164,20 @@ class SharedBatchScheduler
     // will be prioritized based on a (priority, arrival_time) key.
     bool rank_queues = false;
 
+    // If true, when multiple queues have available batches to process, the
+    // batch that must start soonest to meet its deadline is processed first.
+    // A batch must start by the time its oldest task has waited the queue's
+    // `batch_timeout_micros`, and early enough to finish before the earliest
+    // deadline of its tasks (see BatchTask::deadline()) given the mean
+    // processing time recorded in the queue's `model_batch_stats` for batches
+    // of its size. Ties are broken round-robin. Takes precedence over
+    // `rank_queues`.
+    //
+    // Useful when queues serving models with different latency objectives
+    // share the scheduler, so that the batches of a fast model are not stuck
+    // behind those of a slow one.
+    bool schedule_earliest_deadline_first = false;
+
     // If true, Create() will return a global instance of the scheduler. Only
     // the options provided in the first Create() call will be used to
     // initialize the global scheduler.
@@ -276,6 +291,15 @@ class SharedBatchScheduler
     // requested.
     ModelBatchStats* model_batch_stats = nullptr;
 
+    // If true, Schedule() rejects with a DEADLINE_EXCEEDED error any task that
+    // cannot complete before its deadline (see BatchTask::deadline()), i.e.
+    // whose deadline is earlier than now plus the mean time recorded in
+    // `model_batch_stats` to process a batch just large enough to hold it. No
+    // work is spent on such tasks. Without `model_batch_stats`, or before any
+    // batch of that size has been processed, only tasks whose deadline has
+    // already passed are rejected.
+    bool reject_tasks_missing_deadline = false;
+
     // If true, queue implementation would split high priority and low priority
     // inputs into two sub queues.
     bool enable_priority_queue = false;
@@ -880,6 +904,12 @@ class Queue {
   // batch and if so will return the priority of that batch.
   std::optional<BatchPriorityKey> PeekBatchPriority() const;
 
+  // Without mutating the queue, checks if ScheduleBatch() will return a valid
+  // batch and if so will return the latest time, in microseconds, at which
+  // that batch can start processing and still meet its deadline. See
+  // Options::schedule_earliest_deadline_first.
+  std::optional<int64_t> PeekBatchDeadline() const;
+
   // Retrieves the low priority tasks that can be padded to a high priority
   // batch of the specified size.
   std::vector<std::unique_ptr<TaskType>> GetLowPriorityTasksForPadding(
@@ -952,6 +982,14 @@ class Queue {
   std::optional<BatchPriorityKey> PeekBatchPriorityImpl() const
       TF_EXCLUSIVE_LOCKS_REQUIRED(mu_);
 
+  // Returns the mean time recorded in `options_.model_batch_stats` to process
+  // a batch holding `batch_size` tasks' worth of inputs, or zero if unknown.
+  absl::Duration EstimatedProcessingTime(size_t batch_size) const;
+
+  // Returns a DEADLINE_EXCEEDED error if `task` cannot complete before its
+  // deadline. See QueueOptions::reject_tasks_missing_deadline.
+  absl::Status ValidateTaskDeadline(const TaskType& task) const;
+
   // Determines whether the low priority tasks in `low_priority_tasks_` can
   // form a batch on their own. If yes, returns a batch that is ready to be
   // processed. Otherwise, returns an empty unique_ptr.
@@ -1325,6 +1363,7 @@ void SharedBatchScheduler<TaskType>::GetNextWorkItem_Locked(
   internal::Queue<TaskType>* queue_for_batch = nullptr;
   std::optional<typename internal::Queue<TaskType>::BatchPriorityKey>
       batch_priority_key;
+  std::optional<int64_t> earliest_batch_deadline;
   const int num_queues = queues_.size();
   for (int num_queues_tried = 0;
        !BatchExists(batch_to_process) && num_queues_tried < num_queues;
@@ -1339,7 +1378,16 @@ void SharedBatchScheduler<TaskType>::GetNextWorkItem_Locked(
 
     bool queue_has_work = false;
 
-    if (options_.rank_queues) {
+    if (options_.schedule_earliest_deadline_first) {
+      std::optional<int64_t> deadline =
+          (*next_queue_to_schedule_)->PeekBatchDeadline();
+      queue_has_work = deadline.has_value();
+      if (deadline.has_value() && (!earliest_batch_deadline.has_value() ||
+                                   *deadline < *earliest_batch_deadline)) {
+        earliest_batch_deadline = deadline;
+        queue_for_batch = next_queue_to_schedule_->get();
+      }
+    } else if (options_.rank_queues) {
       auto key = (*next_queue_to_schedule_)->PeekBatchPriority();
       queue_has_work = key.has_value();
       if (key.has_value() && (!batch_priority_key.has_value() ||
@@ -1372,7 +1420,7 @@ void SharedBatchScheduler<TaskType>::GetNextWorkItem_Locked(
     }
   }
 
-  if (options_.rank_queues && batch_priority_key.has_value()) {
+  if (batch_priority_key.has_value() || earliest_batch_deadline.has_value()) {
     batch_to_process = queue_for_batch->ScheduleBatch();
   }
 
@@ -1654,6 +1702,7 @@ absl::Status Queue<TaskType>::Schedule(std::unique_ptr<TaskType>* task) {
       warmup_tasks_.AddTask(std::move(*task), env_->NowMicros());
       notify_of_schedulable_warmup_batch = true;
     } else if (options_.enable_priority_aware_batch_scheduler) {
+      TF_RETURN_IF_ERROR(ValidateTaskDeadline(**task));
       if ((*task)->size() > options_.input_batch_size_limit) {
         return absl::InvalidArgumentError(absl::StrFormat(
             "Task size %d is larger than maximum input batch size %d",
@@ -1666,6 +1715,7 @@ absl::Status Queue<TaskType>::Schedule(std::unique_ptr<TaskType>* task) {
         notify_of_schedulable_batch = true;
       }
     } else {
+      TF_RETURN_IF_ERROR(ValidateTaskDeadline(**task));
       if (IsLowPriorityTask(task)) {
         // Insert the task to the low priority task queue instead of the high
         // priority batch queue below.
@@ -2135,6 +2185,78 @@ Queue<TaskType>::PeekBatchPriorityImpl() const {
   return std::make_pair(priority, effective_start_time_micros);
 }
 
+template <typename TaskType>
+std::optional<int64_t> Queue<TaskType>::PeekBatchDeadline() const {
+  uint64_t start_time_micros;
+  size_t batch_size = 0;
+  std::optional<absl::Time> task_deadline;
+  {
+    mutex_lock l(mu_);
+    std::optional<BatchPriorityKey> key = PeekBatchPriorityImpl();
+    if (!key.has_value()) {
+      return std::nullopt;
+    }
+    start_time_micros = key->second;
+    // The priority aware queue does not track task deadlines; its batches are
+    // due when their oldest task times out.
+    if (!options_.enable_priority_aware_batch_scheduler) {
+      // The front batch is the next one to be scheduled: either the oldest
+      // closed batch or, if there is none, the open batch.
+      const Batch<TaskType>& batch = *GetBatches().front();
+      batch_size = batch.size();
+      task_deadline = batch.EarliestTaskDeadline();
+    }
+  }
+
+  int64_t deadline_micros = start_time_micros + options_.batch_timeout_micros;
+  if (task_deadline.has_value()) {
+    const absl::Time latest_start_time =
+        *task_deadline - EstimatedProcessingTime(
+                             std::min(batch_size, max_execution_batch_size_));
+    deadline_micros =
+        std::min(deadline_micros, absl::ToUnixMicros(latest_start_time));
+  }
+  return deadline_micros;
+}
+
+template <typename TaskType>
+absl::Duration Queue<TaskType>::EstimatedProcessingTime(
+    size_t batch_size) const {
+  if (options_.model_batch_stats == nullptr) {
+    return absl::ZeroDuration();
+  }
+  const int padded_batch_size = GetNextAllowedBatchSize(
+      batch_size, options_.allowed_batch_sizes, options_.disable_padding);
+  return options_.model_batch_stats->batch_size(padded_batch_size)
+      .latency()
+      .mean()
+      .value_or(absl::ZeroDuration());
+}
+
+template <typename TaskType>
+absl::Status Queue<TaskType>::ValidateTaskDeadline(const TaskType& task) const {
+  if (!options_.reject_tasks_missing_deadline) {
+    return absl::OkStatus();
+  }
+  if constexpr (std::is_base_of_v<BatchTask, TaskType>) {
+    std::optional<absl::Time> deadline = task.deadline();
+    if (!deadline.has_value()) {
+      return absl::OkStatus();
+    }
+    const absl::Time now = absl::FromUnixMicros(env_->NowMicros());
+    const absl::Duration processing_time = EstimatedProcessingTime(task.size());
+    if (now + processing_time > *deadline) {
+      RecordDeadlineRejectedTaskMetrics(task.size());
+      return absl::DeadlineExceededError(absl::StrFormat(
+          "Task of size %d cannot complete before its deadline: the deadline "
+          "is %s away, and processing a batch of this size takes %s.",
+          task.size(), absl::FormatDuration(*deadline - now),
+          absl::FormatDuration(processing_time)));
+    }
+  }
+  return absl::OkStatus();
+}
+
 template <typename TaskType>
 std::unique_ptr<Batch<TaskType>> Queue<TaskType>::ScheduleLowPriorityBatch() {
   std::unique_ptr<Batch<TaskType>> batch_to_schedule;
@@ -35,6 +35,7 @@ limitations under the License.
 #include "absl/log/log.h"
 #include "absl/status/status.h"
 #include "absl/strings/str_cat.h"
+#include "absl/strings/string_view.h"
 #include "absl/synchronization/mutex.h"
 #include "absl/synchronization/notification.h"
 #include "absl/time/clock.h"
@@ -61,6 +62,7 @@ namespace {
 
 using ::tensorflow::serving::internal::kLazyCancellationReasonDeadlineExceeded;
 using ::tensorflow::serving::internal::kLazyCancellationReasonRpcCancelled;
+using ::testing::ElementsAre;
 using ::testing::HasSubstr;
 using ::tsl::monitoring::testing::CellReader;
 
@@ -96,6 +98,8 @@ class FakeTask : public BatchTask {
     return deadline_.has_value() && now > *deadline_;
   }
 
+  std::optional<absl::Time> deadline() const override { return deadline_; }
+
   bool IsCancelled() const override { return cancelled_; }
 
   void set_deadline(absl::Time deadline) { deadline_ = deadline; }
@@ -4959,6 +4963,176 @@ TEST_P(SharedBatchSchedulerPriorityAwareTest,
 INSTANTIATE_TEST_SUITE_P(Parameter, SharedBatchSchedulerPriorityAwareTest,
                          ::testing::Bool());
 
+// Creates a shared-batch-scheduler that runs the batch with the earliest
+// deadline first. Batch threads start once `env` advances by 100us, so that
+// tests can enqueue tasks in several queues before any is scheduled.
+absl::StatusOr<std::shared_ptr<Scheduler>>
+CreateEarliestDeadlineFirstScheduler(Env* env) {
+  Scheduler::Options options;
+  options.num_batch_threads = 1;
+  options.env = env;
+  options.schedule_earliest_deadline_first = true;
+  options.batch_threads_startup_delay_micros = 100;
+  std::shared_ptr<Scheduler> scheduler;
+  TF_RETURN_IF_ERROR(Scheduler::Create(options, &scheduler));
+  return scheduler;
+}
+
+// Schedules a task of size `task_size` that must complete by `deadline`.
+absl::Status ScheduleTaskWithDeadline(size_t task_size, absl::Time deadline,
+                                      BatchScheduler<FakeTask>* scheduler) {
+  auto task = std::make_unique<FakeTask>(task_size);
+  task->set_deadline(deadline);
+  return scheduler->Schedule(&task);
+}
+
+TEST(SharedBatchSchedulerEarliestDeadlineFirstTest, RunsEarliestDeadlineFirst) {
+  test_util::FakeClockEnv env(Env::Default());
+  absl::Notification start_teardown, stop_teardown;
+  std::unique_ptr<Thread> teardown_thread =
+      CreateFakeClockAdvancerThread(&env, &start_teardown, &stop_teardown);
+
+  {
+    absl::Mutex mu;
+    std::vector<std::string> execution_order;
+    absl::Notification all_processed;
+    auto callback = [&](absl::string_view name) {
+      return [&, name](std::unique_ptr<Batch<FakeTask>> batch) {
+        absl::MutexLock l(mu);
+        execution_order.push_back(std::string(name));
+        if (execution_order.size() == 2) all_processed.Notify();
+      };
+    };
+
+    TF_ASSERT_OK_AND_ASSIGN(std::shared_ptr<Scheduler> scheduler,
+                            CreateEarliestDeadlineFirstScheduler(&env));
+    QueueOptions options = CreateQueueOptions(
+        /*max_execution_batch_size=*/10, /*input_batch_size_limit=*/10,
+        /*batch_timeout_micros=*/1000 * 1000, /*max_enqueued_batches=*/10,
+        /*enable_large_batch_splitting=*/false, /*split_func=*/nullptr);
+    // Round-robin would serve `queue_loose` first.
+    TF_ASSERT_OK_AND_ASSIGN(
+        std::unique_ptr<Queue> queue_loose,
+        CreateQueue(scheduler, options, callback("loose")));
+    TF_ASSERT_OK_AND_ASSIGN(
+        std::unique_ptr<Queue> queue_tight,
+        CreateQueue(scheduler, options, callback("tight")));
+
+    const absl::Time now = absl::FromUnixMicros(env.NowMicros());
+    TF_ASSERT_OK(ScheduleTaskWithDeadline(
+        /*task_size=*/10, now + absl::Milliseconds(500), queue_loose.get()));
+    TF_ASSERT_OK(ScheduleTaskWithDeadline(
+        /*task_size=*/10, now + absl::Milliseconds(5), queue_tight.get()));
+
+    env.BlockUntilThreadsAsleep(1);
+    env.AdvanceByMicroseconds(100);
+    all_processed.WaitForNotification();
+
+    absl::MutexLock l(mu);
+    EXPECT_THAT(execution_order, ElementsAre("tight", "loose"));
+    start_teardown.Notify();
+  }
+  stop_teardown.Notify();
+}
+
+TEST(SharedBatchSchedulerEarliestDeadlineFirstTest,
+     AccountsForEstimatedProcessingTime) {
+  test_util::FakeClockEnv env(Env::Default());
+  absl::Notification start_teardown, stop_teardown;
+  std::unique_ptr<Thread> teardown_thread =
+      CreateFakeClockAdvancerThread(&env, &start_teardown, &stop_teardown);
+
+  {
+    absl::Mutex mu;
+    std::vector<std::string> execution_order;
+    absl::Notification all_processed;
+    auto callback = [&](absl::string_view name) {
+      return [&, name](std::unique_ptr<Batch<FakeTask>> batch) {
+        absl::MutexLock l(mu);
+        execution_order.push_back(std::string(name));
+        if (execution_order.size() == 2) all_processed.Notify();
+      };
+    };
+
+    // Batches of the slow model take 50ms, so they must start 50ms before
+    // their deadline.
+    ModelBatchStats slow_model_batch_stats;
+    slow_model_batch_stats.batch_size(10).latency().Register(
+        absl::Milliseconds(50));
+
+    TF_ASSERT_OK_AND_ASSIGN(std::shared_ptr<Scheduler> scheduler,
+                            CreateEarliestDeadlineFirstScheduler(&env));
+    QueueOptions options = CreateQueueOptions(
+        /*max_execution_batch_size=*/10, /*input_batch_size_limit=*/10,
+        /*batch_timeout_micros=*/1000 * 1000, /*max_enqueued_batches=*/10,
+        /*enable_large_batch_splitting=*/false, /*split_func=*/nullptr);
+    TF_ASSERT_OK_AND_ASSIGN(std::unique_ptr<Queue> queue_fast,
+                            CreateQueue(scheduler, options, callback("fast")));
+    options.model_batch_stats = &slow_model_batch_stats;
+    TF_ASSERT_OK_AND_ASSIGN(std::unique_ptr<Queue> queue_slow,
+                            CreateQueue(scheduler, options, callback("slow")));
+
+    const absl::Time deadline =
+        absl::FromUnixMicros(env.NowMicros()) + absl::Milliseconds(100);
+    TF_ASSERT_OK(
+        ScheduleTaskWithDeadline(/*task_size=*/10, deadline, queue_fast.get()));
+    TF_ASSERT_OK(
+        ScheduleTaskWithDeadline(/*task_size=*/10, deadline, queue_slow.get()));
+
+    env.BlockUntilThreadsAsleep(1);
+    env.AdvanceByMicroseconds(100);
+    all_processed.WaitForNotification();
+
+    absl::MutexLock l(mu);
+    EXPECT_THAT(execution_order, ElementsAre("slow", "fast"));
+    start_teardown.Notify();
+  }
+  stop_teardown.Notify();
+}
+
+TEST(SharedBatchSchedulerEarliestDeadlineFirstTest,
+     RejectsTasksThatCannotMeetTheirDeadline) {
+  ModelBatchStats model_batch_stats;
+  model_batch_stats.batch_size(4).latency().Register(absl::Milliseconds(20));
+
+  TF_ASSERT_OK_AND_ASSIGN(std::shared_ptr<Scheduler> scheduler,
+                          CreateSharedBatchScheduler(/*num_batch_threads=*/1));
+  QueueOptions options = CreateQueueOptions(
+      /*max_execution_batch_size=*/8, /*input_batch_size_limit=*/8,
+      /*batch_timeout_micros=*/0, /*max_enqueued_batches=*/10,
+      /*enable_large_batch_splitting=*/false, /*split_func=*/nullptr);
+  options.allowed_batch_sizes = {4, 8};
+  options.model_batch_stats = &model_batch_stats;
+  options.reject_tasks_missing_deadline = true;
+  TF_ASSERT_OK_AND_ASSIGN(
+      std::unique_ptr<Queue> queue,
+      CreateQueue(scheduler, options,
+                  [](std::unique_ptr<Batch<FakeTask>> batch) {}));
+
+  CellReader<int64_t> rejected_task_count_reader(
+      "/tensorflow/serving/batching/deadline_rejected_task_count");
+  CellReader<int64_t> rejected_task_size_reader(
+      "/tensorflow/serving/batching/deadline_rejected_task_size");
+
+  // A batch holding a task of size 3 is padded to 4, which takes 20ms.
+  EXPECT_THAT(ScheduleTaskWithDeadline(/*task_size=*/3,
+                                       absl::Now() + absl::Milliseconds(5),
+                                       queue.get()),
+              absl_testing::StatusIs(absl::StatusCode::kDeadlineExceeded,
+                                     HasSubstr("cannot complete")));
+  TF_EXPECT_OK(ScheduleTaskWithDeadline(
+      /*task_size=*/3, absl::Now() + absl::Seconds(10), queue.get()));
+  TF_EXPECT_OK(ScheduleTask(/*task_size=*/3, queue.get()));
+  // Nothing is known about batches of size 8, but the deadline has passed.
+  EXPECT_THAT(ScheduleTaskWithDeadline(/*task_size=*/6,
+                                       absl::Now() - absl::Milliseconds(1),
+                                       queue.get()),
+              absl_testing::StatusIs(absl::StatusCode::kDeadlineExceeded));
+
+  EXPECT_EQ(rejected_task_count_reader.Delta(), 2);
+  EXPECT_EQ(rejected_task_size_reader.Delta(), 9);
+}
+
 TEST(SharedBatchSchedulerPriorityPolicyTest,
      WarmupTasksProcessedBySeparateThreadPool) {
   // Create scheduler with 1 batch thread and 1 warmup thread.
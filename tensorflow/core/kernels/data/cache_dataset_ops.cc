@@ -23,9 +23,14 @@ limitations under the License.
 #include <vector>
 
 #include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/match.h"
 #include "absl/strings/str_cat.h"
 #include "absl/strings/str_format.h"
+#include "absl/strings/string_view.h"
+#include "absl/strings/strip.h"
 #include "tensorflow/core/data/global_shuffle_utils.h"
+#include "tensorflow/core/data/hash_utils.h"
 #include "tensorflow/core/data/name_utils.h"
 #include "tensorflow/core/data/serialization_utils.h"
 #include "tensorflow/core/framework/dataset.h"
@@ -35,6 +40,7 @@ limitations under the License.
 #include "tensorflow/core/framework/tensor.h"
 #include "tensorflow/core/kernels/data/cache_ops.h"
 #include "tensorflow/core/kernels/data/iterator_ops.h"
+#include "tensorflow/core/kernels/data/memory_cache_arena.h"
 #include "tensorflow/core/lib/core/errors.h"
 #include "tensorflow/core/lib/strings/stringprintf.h"
 #include "tensorflow/core/platform/env.h"
@@ -78,6 +84,29 @@ constexpr char kIncompleteCacheErrorMessage[] =
     "contents of the dataset  will be discarded. This can happen if you have "
     "an input pipeline similar to `dataset.cache().take(k).repeat()`. You "
     "should use `dataset.take(k).cache().repeat()` instead.";
+
+// Returns the path of the arena selected by the `filename` argument of a
+// memory cache, or an empty string if the cache is private to this process.
+std::string ArenaPath(absl::string_view filename) {
+  if (!absl::ConsumePrefix(&filename, kMemoryCacheArenaPrefix)) return "";
+  return std::string(filename);
+}
+
+// Returns the fingerprint of the input pipeline `input`, which identifies the
+// arenas a memory cache of `input` may attach to. Captured tensors are
+// serialized into the graph, so pipelines over different data differ.
+absl::StatusOr<uint64_t> ArenaFingerprint(OpKernelContext* ctx,
+                                          const DatasetBase* input) {
+  SerializationContext::Params params(ctx);
+  params.external_state_policy = ExternalStatePolicy::POLICY_IGNORE;
+  GraphDef graph_def;
+  TF_RETURN_IF_ERROR(
+      AsGraphDef(input, SerializationContext(params), &graph_def));
+  uint64_t fingerprint = 0;
+  TF_RETURN_IF_ERROR(HashGraph(graph_def, &fingerprint));
+  return fingerprint;
+}
+
 }  // namespace
 
 class DatasetRandomAccessCache {
@@ -765,12 +794,26 @@ class CacheDatasetOp::FileDatasetV2 : public CacheDatasetOp::FileDatasetBase {
 class CacheDatasetOp::MemoryDatasetBase : public DatasetBase {
  public:
   explicit MemoryDatasetBase(OpKernelContext* ctx, const DatasetBase* input,
-                             std::shared_ptr<MemoryCache> cache)
+                             std::shared_ptr<MemoryCache> cache,
+                             tstring filename)
       : DatasetBase(DatasetContext(ctx)),
         input_(input),
-        cache_(std::move(cache)) {
+        cache_(std::move(cache)),
+        filename_(std::move(filename)),
+        arena_path_(ArenaPath(filename_)) {
     input_->Ref();
     random_indexing_compatible_ = input_->RandomIndexingCompatible();
+    if (!arena_path_.empty()) {
+      absl::StatusOr<uint64_t> fingerprint = ArenaFingerprint(ctx, input_);
+      if (fingerprint.ok()) {
+        arena_fingerprint_ = *fingerprint;
+      } else {
+        LOG(WARNING) << "Not sharing the cache through " << arena_path_
+                     << ": cannot fingerprint the input pipeline: "
+                     << fingerprint.status();
+        arena_path_.clear();
+      }
+    }
   }
 
   ~MemoryDatasetBase() override { input_->Unref(); }
@@ -909,7 +952,10 @@ class CacheDatasetOp::MemoryDatasetBase : public DatasetBase {
       mutex_lock l(mu_);
       iterator_.reset();
       cache_->Reset();
-      if (reader->Contains(prefix(), kCacheCompleted)) {
+      // A completed cache backed by an arena is attached to the arena
+      // instead of being rebuilt from the checkpointed elements.
+      if (reader->Contains(prefix(), kCacheCompleted) &&
+          !dataset()->AttachArena(ctx->env(), cache_)) {
         std::vector<std::vector<Tensor>> temp_cache;
         TF_RETURN_IF_ERROR(
             ReadElementsFromCheckpoint(ctx, reader, prefix(), &temp_cache));
@@ -934,6 +980,10 @@ class CacheDatasetOp::MemoryDatasetBase : public DatasetBase {
       }
 
       absl::Status Initialize(IteratorContext* ctx) override {
+        {
+          mutex_lock l(mu_);
+          StartArena(ctx->env());
+        }
         return dataset()->input_->MakeIterator(ctx, this, prefix(),
                                                &input_impl_);
       }
@@ -947,16 +997,17 @@ class CacheDatasetOp::MemoryDatasetBase : public DatasetBase {
         if (*end_of_sequence) {
           if (!cache_->IsCompleted()) {
             VLOG(2) << "Finalizing the cache because EOF has been reached.";
-            cache_->Complete(std::move(temp_cache_));
+            CompleteCache(ctx->env());
           }
           return absl::OkStatus();
         }
         RecordBufferEnqueue(ctx, *out_tensors);
         temp_cache_.emplace_back(*out_tensors);
+        AppendToArena(*out_tensors);
         if (temp_cache_.size() == dataset()->input_->Cardinality()) {
           VLOG(2) << "Finalizing the cache because its size matches the "
                      "expected input cardinality.";
-          cache_->Complete(std::move(temp_cache_));
+          CompleteCache(ctx->env());
         }
         return absl::OkStatus();
       }
@@ -984,15 +1035,65 @@ class CacheDatasetOp::MemoryDatasetBase : public DatasetBase {
         if (!reader->Contains(prefix(), kCacheCompleted)) {
           TF_RETURN_IF_ERROR(
               ReadElementsFromCheckpoint(ctx, reader, prefix(), &temp_cache_));
+          // Rewrite the arena so that it matches the restored elements.
+          arena_writer_.reset();
+          StartArena(ctx->env());
+          for (const std::vector<Tensor>& element : temp_cache_) {
+            AppendToArena(element);
+          }
         }
         return RestoreInput(ctx, reader, input_impl_);
       }
 
      private:
+      // Starts writing the arena of the dataset, if it has one. Failing to
+      // write the arena is not an error: the cache then stays private to this
+      // process.
+      void StartArena(Env* env) TF_EXCLUSIVE_LOCKS_REQUIRED(mu_) {
+        if (dataset()->arena_path_.empty() || arena_writer_ != nullptr) return;
+        auto writer = MemoryCacheArenaWriter::Create(
+            env, dataset()->arena_path_, dataset()->arena_fingerprint_);
+        if (!writer.ok()) {
+          LOG(WARNING) << "Not sharing the cache through "
+                       << dataset()->arena_path_ << ": " << writer.status();
+          return;
+        }
+        arena_writer_ = *std::move(writer);
+      }
+
+      void AppendToArena(const std::vector<Tensor>& element)
+          TF_EXCLUSIVE_LOCKS_REQUIRED(mu_) {
+        if (arena_writer_ == nullptr) return;
+        absl::Status s = arena_writer_->Append(element);
+        if (!s.ok()) {
+          LOG(WARNING) << "Not sharing the cache through "
+                       << dataset()->arena_path_ << ": " << s;
+          arena_writer_.reset();
+        }
+      }
+
+      // Completes the cache, from the published arena if there is one so
+      // that this process shares its memory with the other readers.
+      void CompleteCache(Env* env) TF_EXCLUSIVE_LOCKS_REQUIRED(mu_) {
+        if (arena_writer_ != nullptr) {
+          absl::Status s = arena_writer_->Finish();
+          arena_writer_.reset();
+          if (!s.ok()) {
+            LOG(WARNING) << "Failed to publish the cache to "
+                         << dataset()->arena_path_ << ": " << s;
+          } else if (dataset()->AttachArena(env, cache_)) {
+            temp_cache_.clear();
+            return;
+          }
+        }
+        cache_->Complete(std::move(temp_cache_));
+      }
+
       mutex mu_;
       std::unique_ptr<IteratorBase> input_impl_ TF_GUARDED_BY(mu_);
       MemoryCache* const cache_ TF_GUARDED_BY(mu_);  // not owned.
       std::vector<std::vector<Tensor>> temp_cache_ TF_GUARDED_BY(mu_);
+      std::unique_ptr<MemoryCacheArenaWriter> arena_writer_ TF_GUARDED_BY(mu_);
     };  // MemoryWriterIterator
 
     class MemoryReaderIterator : public DatasetIterator<MemoryDatasetBase> {
@@ -1069,7 +1170,7 @@ class CacheDatasetOp::MemoryDatasetBase : public DatasetBase {
 
     absl::Status InitializeIterator(IteratorContext* ctx)
         TF_EXCLUSIVE_LOCKS_REQUIRED(mu_) {
-      if (cache_->IsCompleted()) {
+      if (cache_->IsCompleted() || dataset()->AttachArena(ctx->env(), cache_)) {
         iterator_ = std::make_unique<MemoryReaderIterator>(
             MemoryReaderIterator::Params{dataset(),
                                          absl::StrCat(prefix(), kImpl)},
@@ -1090,9 +1191,34 @@ class CacheDatasetOp::MemoryDatasetBase : public DatasetBase {
     GlobalShuffleIterator global_shuffle_iterator_;
   };  // MemoryIterator
 
+  // Completes `cache` from the arena published at `arena_path_`, if any.
+  // Returns whether the cache was attached to the arena.
+  bool AttachArena(Env* env, MemoryCache* cache) const {
+    if (arena_path_.empty()) return false;
+    std::vector<std::vector<Tensor>> elements;
+    absl::Status s = ReadMemoryCacheArena(env, arena_path_, arena_fingerprint_,
+                                          output_dtypes(), &elements);
+    if (!s.ok()) {
+      if (!absl::IsNotFound(s)) {
+        LOG(WARNING) << "Ignoring the cache published at " << arena_path_
+                     << ": " << s;
+      }
+      return false;
+    }
+    VLOG(2) << "Attached the cache to " << arena_path_;
+    cache->Complete(std::move(elements));
+    return true;
+  }
+
   mutable mutex mu_;
   const DatasetBase* const input_;
   const std::shared_ptr<MemoryCache> cache_;
+  // The `filename` argument of the op: empty, or `kMemoryCacheArenaPrefix`
+  // followed by `arena_path_`. `arena_path_` is cleared if the input pipeline
+  // cannot be fingerprinted.
+  const tstring filename_;
+  std::string arena_path_;
+  uint64_t arena_fingerprint_ = 0;
   mutable std::unique_ptr<DatasetRandomAccessCache> dataset_random_access_cache_
       TF_GUARDED_BY(mu_);
   mutable std::unique_ptr<IteratorRandomAccessCache>
@@ -1106,8 +1232,9 @@ class CacheDatasetOp::MemoryDatasetBase : public DatasetBase {
 class CacheDatasetOp::MemoryDataset : public CacheDatasetOp::MemoryDatasetBase {
  public:
   MemoryDataset(OpKernelContext* ctx, const DatasetBase* input,
-                MemoryCacheManager* manager, ResourceHandle&& resource_handle)
-      : MemoryDatasetBase(ctx, input, manager->get()),
+                MemoryCacheManager* manager, ResourceHandle&& resource_handle,
+                tstring filename)
+      : MemoryDatasetBase(ctx, input, manager->get(), std::move(filename)),
         manager_(manager),
         resource_handle_(std::move(resource_handle)),
         resource_mgr_(ctx->resource_manager()) {}
@@ -1128,7 +1255,7 @@ class CacheDatasetOp::MemoryDataset : public CacheDatasetOp::MemoryDatasetBase {
     Node* input_node = nullptr;
     TF_RETURN_IF_ERROR(b->AddInputDataset(ctx, input_, &input_node));
     Node* filename_node = nullptr;
-    TF_RETURN_IF_ERROR(b->AddScalar(tstring(""), &filename_node));
+    TF_RETURN_IF_ERROR(b->AddScalar(filename_, &filename_node));
     TF_RETURN_IF_ERROR(
         b->AddDataset(this, {input_node, filename_node}, output));
     return absl::OkStatus();
@@ -1148,8 +1275,8 @@ class CacheDatasetOp::MemoryDatasetV2
  public:
   MemoryDatasetV2(OpKernelContext* ctx, const DatasetBase* input,
                   MemoryCacheManager* manager, ResourceHandle&& resource_handle,
-                  bool owns_resource)
-      : MemoryDatasetBase(ctx, input, manager->get()),
+                  bool owns_resource, tstring filename)
+      : MemoryDatasetBase(ctx, input, manager->get(), std::move(filename)),
         manager_(manager),
         owns_resource_(owns_resource),
         resource_handle_(std::move(resource_handle)),
@@ -1173,7 +1300,7 @@ class CacheDatasetOp::MemoryDatasetV2
     Node* input_node = nullptr;
     TF_RETURN_IF_ERROR(b->AddInputDataset(ctx, input_, &input_node));
     Node* filename_node = nullptr;
-    TF_RETURN_IF_ERROR(b->AddScalar(tstring(""), &filename_node));
+    TF_RETURN_IF_ERROR(b->AddScalar(filename_, &filename_node));
     Node* resource_handle_node = nullptr;
     Tensor handle(DT_RESOURCE, TensorShape({}));
     handle.scalar<ResourceHandle>()() = resource_handle_;
@@ -1199,7 +1326,8 @@ void CacheDatasetOp::MakeDataset(OpKernelContext* ctx, DatasetBase* input,
   // Parse out the filenames tensor.
   tstring filename;
   OP_REQUIRES_OK(ctx, ParseScalarArgument<tstring>(ctx, kFileName, &filename));
-  if (filename.empty()) {
+  if (filename.empty() ||
+      absl::StartsWith(filename, kMemoryCacheArenaPrefix)) {
     static std::atomic<int64_t> resource_id_counter(0);
     const std::string& container = ctx->resource_manager()->default_container();
     auto name = strings::StrCat(ctx->op_kernel().name(), "/", kMemoryCache, "_",
@@ -1226,7 +1354,7 @@ void CacheDatasetOp::MakeDataset(OpKernelContext* ctx, DatasetBase* input,
       }
       // Ownership of manager is transferred onto `MemoryDatasetV2`.
       *output = new MemoryDatasetV2(ctx, input, manager, std::move(handle),
-                                    owns_resource);
+                                    owns_resource, filename);
     } else {
       MemoryCacheManager* manager;
       OP_REQUIRES_OK(
@@ -1238,7 +1366,8 @@ void CacheDatasetOp::MakeDataset(OpKernelContext* ctx, DatasetBase* input,
       auto handle =
           MakeResourceHandle<MemoryCacheManager>(ctx, container, name);
       // Ownership of manager is transferred onto `MemoryDataset`.
-      *output = new MemoryDataset(ctx, input, manager, std::move(handle));
+      *output =
+          new MemoryDataset(ctx, input, manager, std::move(handle), filename);
     }
   } else {
     if (op_version_ == 2) {
@@ -16,9 +16,15 @@ limitations under the License.
 #include <utility>
 #include <vector>
 
+#include "absl/status/status.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/strip.h"
 #include "tensorflow/core/data/dataset_test_base.h"
 #include "tensorflow/core/data/dataset_utils.h"
 #include "tensorflow/core/data/serialization_utils.h"
+#include "tensorflow/core/framework/allocation_description.pb.h"
+#include "tensorflow/core/framework/tensor_description.pb.h"
+#include "tensorflow/core/kernels/data/memory_cache_arena.h"
 #include "tensorflow/core/platform/path.h"
 
 namespace tensorflow {
@@ -87,7 +93,10 @@ class CacheDatasetOpTest : public DatasetOpsTestBase {
     if (!cache_filename_.empty()) {
       std::vector<std::string> cache_files;
       absl::Status s = device_->env()->GetMatchingPaths(
-          absl::StrCat(cache_filename_, "*"), &cache_files);
+          absl::StrCat(absl::StripPrefix(cache_filename_,
+                                         kMemoryCacheArenaPrefix),
+                       "*"),
+          &cache_files);
       if (!s.ok()) {
         LOG(WARNING) << "Failed to get matching files on " << cache_filename_
                      << "* : " << s;
@@ -155,6 +164,21 @@ CacheDatasetParams CacheDatasetParams4() {
                             kNodeName);
 }
 
+// Test case 5: cache data in memory, shared through an arena file.
+CacheDatasetParams CacheDatasetParams5() {
+  auto tensor_slice_dataset_params = TensorSliceDatasetParams(
+      /*components=*/{CreateTensor<int64_t>(TensorShape{3, 3, 1},
+                                            {0, 1, 2, 3, 4, 5, 6, 7, 8})},
+      /*node_name=*/"tensor_slice");
+  return CacheDatasetParams(
+      std::move(tensor_slice_dataset_params),
+      /*filename=*/
+      absl::StrCat(kMemoryCacheArenaPrefix,
+                   io::JoinPath(testing::TmpDir(), "cache_arena")),
+      /*output_dtypes=*/{DT_INT64},
+      /*output_shapes=*/{PartialTensorShape({3, 1})}, kNodeName);
+}
+
 std::vector<GetNextTestCase<CacheDatasetParams>> GetNextTestCases() {
   return {{/*dataset_params=*/CacheDatasetParams1(),
            /*expected_outputs=*/
@@ -167,7 +191,11 @@ std::vector<GetNextTestCase<CacheDatasetParams>> GetNextTestCases() {
            CreateTensors<int64_t>(TensorShape({3, 1}),
                                   {{0, 1, 2}, {3, 4, 5}, {6, 7, 8}})},
           {/*dataset_params=*/CacheDatasetParams4(),
-           /*expected_outputs=*/{}}};
+           /*expected_outputs=*/{}},
+          {/*dataset_params=*/CacheDatasetParams5(),
+           /*expected_outputs=*/
+           CreateTensors<int64_t>(TensorShape({3, 1}),
+                                  {{0, 1, 2}, {3, 4, 5}, {6, 7, 8}})}};
 }
 
 class ParameterizedGetNextTest : public CacheDatasetOpTest,
@@ -375,6 +403,74 @@ INSTANTIATE_TEST_CASE_P(CacheDatasetOpTest,
                         ParameterizedIteratorSaveAndRestoreTest,
                         ::testing::ValuesIn(IteratorSaveAndRestoreTestCases()));
 
+// Reads all elements of a dataset created from `params` into `out_tensors`
+// and sets `all_mapped` to whether every element aliases a mapped arena.
+absl::Status ReadFromArena(CacheDatasetOpTest* test,
+                           const CacheDatasetParams& params,
+                           std::vector<Tensor>* out_tensors,
+                           bool* all_mapped) {
+  std::unique_ptr<TestDataset> dataset;
+  TF_RETURN_IF_ERROR(test->MakeDataset(params, &dataset));
+  std::unique_ptr<TestIterator> iterator;
+  TF_RETURN_IF_ERROR(test->MakeIterator(params, *dataset, &iterator));
+  *all_mapped = true;
+  bool end_of_sequence = false;
+  while (!end_of_sequence) {
+    std::vector<Tensor> next;
+    TF_RETURN_IF_ERROR(iterator->GetNext(&next, &end_of_sequence));
+    for (const Tensor& t : next) {
+      TensorDescription description;
+      t.FillDescription(&description);
+      *all_mapped &=
+          description.allocation_description().allocator_name() == "mmap";
+    }
+    out_tensors->insert(out_tensors->end(), next.begin(), next.end());
+  }
+  return absl::OkStatus();
+}
+
+TEST_F(CacheDatasetOpTest, ArenaIsSharedWithSamePipeline) {
+  auto dataset_params = CacheDatasetParams5();
+  TF_ASSERT_OK(Initialize(dataset_params));
+  bool end_of_sequence = false;
+  std::vector<Tensor> out_tensors;
+  while (!end_of_sequence) {
+    TF_EXPECT_OK(iterator_->GetNext(iterator_ctx_.get(), &out_tensors,
+                                    &end_of_sequence));
+  }
+  const std::string arena_path(
+      absl::StripPrefix(dataset_params.filename(), kMemoryCacheArenaPrefix));
+  TF_EXPECT_OK(device_->env()->FileExists(arena_path));
+
+  // Another dataset of the same pipeline, e.g. in another process, reads the
+  // published elements instead of its input.
+  out_tensors.clear();
+  bool all_mapped = false;
+  TF_ASSERT_OK(
+      ReadFromArena(this, CacheDatasetParams5(), &out_tensors, &all_mapped));
+  EXPECT_TRUE(all_mapped);
+  TF_EXPECT_OK(ExpectEqual(
+      out_tensors,
+      CreateTensors<int64_t>(TensorShape({3, 1}),
+                             {{0, 1, 2}, {3, 4, 5}, {6, 7, 8}}),
+      /*compare_order=*/true));
+
+  // A dataset with a different input ignores the arena at the same path.
+  auto other_params = CacheDatasetParams(
+      TensorSliceDatasetParams(
+          /*components=*/{CreateTensor<int64_t>(TensorShape{1, 3, 1},
+                                                {9, 9, 9})},
+          /*node_name=*/"tensor_slice"),
+      dataset_params.filename(), /*output_dtypes=*/{DT_INT64},
+      /*output_shapes=*/{PartialTensorShape({3, 1})}, kNodeName);
+  out_tensors.clear();
+  TF_ASSERT_OK(ReadFromArena(this, other_params, &out_tensors, &all_mapped));
+  EXPECT_FALSE(all_mapped);
+  TF_EXPECT_OK(ExpectEqual(
+      out_tensors, CreateTensors<int64_t>(TensorShape({3, 1}), {{9, 9, 9}}),
+      /*compare_order=*/true));
+}
+
 TEST_F(CacheDatasetOpTest, NegativeIndexTest) {
   auto params = CacheDatasetParams3();
   TF_ASSERT_OK(Initialize(params));
@@ -36,6 +36,7 @@ limitations under the License.
 #include "absl/strings/string_view.h"
 #include "absl/time/clock.h"
 #include "absl/time/time.h"
+#include "tensorflow/core/data/dataset_utils.h"
 #include "tensorflow/core/data/hash_utils.h"
 #include "tensorflow/core/data/serialization_utils.h"
 #include "tensorflow/core/data/snapshot_utils.h"
@@ -82,6 +83,7 @@ namespace experimental {
 /* static */ constexpr const char* const
     SnapshotDatasetV2Op::kShardFuncTarguments;
 /* static */ constexpr const int SnapshotDatasetV2Op::kFileFormatVersion;
+/* static */ constexpr const int SnapshotDatasetV2Op::kBlockFileFormatVersion;
 
 // ==== Snapshot Implementation ====
 
@@ -117,7 +119,8 @@ class SnapshotDatasetV2Op::Dataset : public DatasetBase {
  public:
   Dataset(OpKernelContext* ctx, const DatasetBase* input, uint64_t hash,
           const std::string& path, const std::string& compression,
-          const std::string& reader_prefix, const std::string& writer_prefix,
+          int file_format_version, const std::string& reader_prefix,
+          const std::string& writer_prefix,
           std::unique_ptr<CapturedFunction> reader_func,
           std::unique_ptr<CapturedFunction> shard_func)
       : DatasetBase(DatasetContext(ctx)),
@@ -125,6 +128,7 @@ class SnapshotDatasetV2Op::Dataset : public DatasetBase {
         hash_(hash),
         path_(path),
         compression_(compression),
+        file_format_version_(file_format_version),
         reader_prefix_(reader_prefix),
         writer_prefix_(writer_prefix),
         reader_func_(std::move(reader_func)),
@@ -246,6 +250,9 @@ class SnapshotDatasetV2Op::Dataset : public DatasetBase {
   const uint64_t hash_;
   const tstring path_;
   const std::string compression_;
+  // Version of the files written by this dataset. Files are read according
+  // to the version recorded in the snapshot metadata.
+  const int file_format_version_;
   const std::string reader_prefix_;
   const std::string writer_prefix_;
 
@@ -432,7 +439,7 @@ class SnapshotDatasetV2Op::Dataset : public DatasetBase {
           auto writer = std::make_unique<snapshot_util::AsyncWriter>(
               ctx->env(), shard_index, snapshot_shard_directory,
               current_checkpoint_id_, dataset()->compression_,
-              kFileFormatVersion, dataset()->output_dtypes(),
+              dataset()->file_format_version_, dataset()->output_dtypes(),
               [this](absl::Status s) {
                 if (!s.ok()) {
                   LOG(ERROR) << "AsyncWriter in snapshot writer failed: " << s;
@@ -516,7 +523,7 @@ class SnapshotDatasetV2Op::Dataset : public DatasetBase {
       metadata.set_creation_timestamp(EnvTime::NowMicros());
       metadata.set_graph_hash(absl::StrCat(dataset()->hash_));
       metadata.set_run_id(absl::StrCat(run_id_));
-      metadata.set_version(kFileFormatVersion);
+      metadata.set_version(dataset()->file_format_version_);
       for (const auto& output_dtype : dataset()->output_dtypes()) {
         metadata.add_dtype(output_dtype);
       }
@@ -752,6 +759,8 @@ SnapshotDatasetV2Op::SnapshotDatasetV2Op(OpKernelConstruction* ctx)
   OP_REQUIRES_OK(ctx, ctx->GetAttr(kHash, &hash));
   hash_ = static_cast<uint64_t>(hash);
 
+  use_block_format_ = GetExperiments().contains("snapshot_block_format");
+
   OP_REQUIRES_OK(ctx, FunctionMetadata::Create(ctx, kReaderFunc, reader_params,
                                                &reader_func_metadata_));
   OP_REQUIRES_OK(ctx, FunctionMetadata::Create(ctx, kShardFunc, shard_params,
@@ -792,9 +801,13 @@ void SnapshotDatasetV2Op::MakeDataset(OpKernelContext* ctx, DatasetBase* input,
                  CapturedFunction::Create(ctx, shard_func_metadata_,
                                           kShardFuncOtherArgs, &shard_func));
 
+  const int file_format_version =
+      use_block_format_ && compression != io::compression::kGzip
+          ? kBlockFileFormatVersion
+          : kFileFormatVersion;
   *output = new SnapshotDatasetV2Op::Dataset(
-      ctx, input, hash, path, compression, reader_prefix_, writer_prefix_,
-      std::move(reader_func), std::move(shard_func));
+      ctx, input, hash, path, compression, file_format_version, reader_prefix_,
+      writer_prefix_, std::move(reader_func), std::move(shard_func));
 }
 
 namespace {
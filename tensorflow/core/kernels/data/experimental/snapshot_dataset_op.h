@@ -73,6 +73,9 @@ class SnapshotDatasetV2Op : public UnaryDatasetOpKernel {
 
  private:
   static constexpr const int kFileFormatVersion = 2;
+  // Block-compressed format written if the "snapshot_block_format" experiment
+  // is enabled. It supports snappy and no compression.
+  static constexpr const int kBlockFileFormatVersion = 3;
 
   class Dataset;
 
@@ -81,6 +84,7 @@ class SnapshotDatasetV2Op : public UnaryDatasetOpKernel {
   std::vector<PartialTensorShape> output_shapes_;
 
   std::string compression_;
+  bool use_block_format_ = false;
   std::string reader_prefix_;
   std::string writer_prefix_;
   bool hash_valid_;
@@ -0,0 +1,284 @@
+/* Copyright 2026 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#include "tensorflow/core/kernels/data/memory_cache_arena.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/string_view.h"
+#include "tensorflow/core/framework/mapped_tensor_buffer.h"
+#include "tensorflow/core/framework/tensor.h"
+#include "tensorflow/core/framework/tensor.pb.h"
+#include "tensorflow/core/framework/tensor_shape.h"
+#include "tensorflow/core/framework/types.h"
+#include "tensorflow/core/lib/core/coding.h"
+#include "tensorflow/core/lib/hash/crc32c.h"
+#include "tensorflow/core/lib/random/random.h"
+#include "tensorflow/core/platform/env.h"
+#include "tensorflow/core/platform/errors.h"
+
+namespace tensorflow {
+namespace data {
+namespace {
+
+constexpr char kHeaderMagic[] = "TFMCARN1";
+constexpr uint64_t kTrailerMagic = 0x314e5241434d4654ull;  // "TFMCARN1"
+constexpr size_t kHeaderSize = 64;
+// index offset, number of elements, number of components, index crc, magic.
+constexpr size_t kTrailerSize = 8 + 8 + 4 + 4 + 8;
+constexpr size_t kAlignment = 64;
+
+// How a tensor is stored in the arena.
+enum class Encoding : uint32_t {
+  // The tensor's bytes, which readers alias.
+  kRaw = 0,
+  // A serialized `TensorProto`.
+  kProto = 1,
+};
+
+absl::Status CorruptArena(const std::string& path, absl::string_view reason) {
+  return absl::DataLossError(
+      absl::StrCat("Memory cache arena ", path, " is corrupted: ", reason));
+}
+
+}  // namespace
+
+absl::StatusOr<std::unique_ptr<MemoryCacheArenaWriter>>
+MemoryCacheArenaWriter::Create(Env* env, const std::string& path,
+                               uint64_t fingerprint) {
+  std::string temp_path = absl::StrCat(path, ".tmp.", random::New64());
+  std::unique_ptr<WritableFile> file;
+  TF_RETURN_IF_ERROR(env->NewWritableFile(temp_path, &file));
+  std::unique_ptr<MemoryCacheArenaWriter> writer(new MemoryCacheArenaWriter(
+      env, path, std::move(temp_path), std::move(file)));
+  std::string header(kHeaderMagic, sizeof(kHeaderMagic) - 1);
+  core::PutFixed64(&header, fingerprint);
+  header.resize(kHeaderSize, '\0');
+  TF_RETURN_IF_ERROR(writer->file_->Append(header));
+  writer->offset_ = kHeaderSize;
+  return writer;
+}
+
+MemoryCacheArenaWriter::MemoryCacheArenaWriter(
+    Env* env, std::string path, std::string temp_path,
+    std::unique_ptr<WritableFile> file)
+    : env_(env),
+      path_(std::move(path)),
+      temp_path_(std::move(temp_path)),
+      file_(std::move(file)) {}
+
+MemoryCacheArenaWriter::~MemoryCacheArenaWriter() {
+  if (finished_) return;
+  file_->Close().IgnoreError();
+  absl::Status s = env_->DeleteFile(temp_path_);
+  if (!s.ok()) {
+    LOG(WARNING) << "Failed to delete " << temp_path_ << ": " << s;
+  }
+}
+
+absl::Status MemoryCacheArenaWriter::AppendPadding() {
+  const size_t padding = (kAlignment - offset_ % kAlignment) % kAlignment;
+  if (padding == 0) return absl::OkStatus();
+  TF_RETURN_IF_ERROR(file_->Append(std::string(padding, '\0')));
+  offset_ += padding;
+  return absl::OkStatus();
+}
+
+absl::Status MemoryCacheArenaWriter::Append(
+    const std::vector<Tensor>& element) {
+  if (finished_) {
+    return absl::FailedPreconditionError(
+        absl::StrCat("Memory cache arena ", path_, " is already finished."));
+  }
+  if (num_components_ < 0) {
+    num_components_ = element.size();
+  } else if (num_components_ != static_cast<int64_t>(element.size())) {
+    return absl::InvalidArgumentError(absl::StrCat(
+        "Expected elements with ", num_components_, " components, got ",
+        element.size()));
+  }
+  for (const Tensor& t : element) {
+    absl::string_view data;
+    std::string serialized;
+    Encoding encoding;
+    if (DataTypeCanUseMemcpy(t.dtype())) {
+      TF_RETURN_IF_ERROR(AppendPadding());
+      encoding = Encoding::kRaw;
+      data = t.tensor_data();
+    } else {
+      encoding = Encoding::kProto;
+      TensorProto proto;
+      t.AsProtoTensorContent(&proto);
+      if (!proto.SerializeToString(&serialized)) {
+        return absl::InternalError(
+            absl::StrCat("Failed to serialize tensor ", t.DebugString()));
+      }
+      data = serialized;
+    }
+    core::PutVarint32(&index_, t.dtype());
+    core::PutVarint32(&index_, static_cast<uint32_t>(encoding));
+    core::PutVarint32(&index_, t.dims());
+    for (int64_t dim : t.shape().dim_sizes()) {
+      core::PutVarint64(&index_, dim);
+    }
+    core::PutVarint64(&index_, offset_);
+    core::PutVarint64(&index_, data.size());
+    TF_RETURN_IF_ERROR(file_->Append(data));
+    offset_ += data.size();
+  }
+  ++num_elements_;
+  return absl::OkStatus();
+}
+
+absl::Status MemoryCacheArenaWriter::Finish() {
+  if (finished_) return absl::OkStatus();
+  const uint64_t index_offset = offset_;
+  std::string trailer;
+  core::PutFixed64(&trailer, index_offset);
+  core::PutFixed64(&trailer, num_elements_);
+  core::PutFixed32(&trailer, std::max<int64_t>(num_components_, 0));
+  core::PutFixed32(&trailer,
+                   crc32c::Mask(crc32c::Value(index_.data(), index_.size())));
+  core::PutFixed64(&trailer, kTrailerMagic);
+  TF_RETURN_IF_ERROR(file_->Append(index_));
+  TF_RETURN_IF_ERROR(file_->Append(trailer));
+  TF_RETURN_IF_ERROR(file_->Close());
+  TF_RETURN_IF_ERROR(env_->RenameFile(temp_path_, path_));
+  finished_ = true;
+  return absl::OkStatus();
+}
+
+absl::Status ReadMemoryCacheArena(Env* env, const std::string& path,
+                                  uint64_t fingerprint,
+                                  const DataTypeVector& dtypes,
+                                  std::vector<std::vector<Tensor>>* elements) {
+  TF_RETURN_IF_ERROR(env->FileExists(path));
+  std::unique_ptr<ReadOnlyMemoryRegion> mapped;
+  TF_RETURN_IF_ERROR(env->NewReadOnlyMemoryRegionFromFile(path, &mapped));
+  std::shared_ptr<const ReadOnlyMemoryRegion> region = std::move(mapped);
+  const char* base = static_cast<const char*>(region->data());
+  const uint64_t length = region->length();
+  if (length < kHeaderSize + kTrailerSize ||
+      absl::string_view(base, sizeof(kHeaderMagic) - 1) != kHeaderMagic ||
+      core::DecodeFixed64(base + length - 8) != kTrailerMagic) {
+    return CorruptArena(path, "bad magic number");
+  }
+  const uint64_t arena_fingerprint =
+      core::DecodeFixed64(base + sizeof(kHeaderMagic) - 1);
+  if (arena_fingerprint != fingerprint) {
+    return absl::FailedPreconditionError(absl::StrCat(
+        "Memory cache arena ", path, " was written by an input pipeline with "
+        "fingerprint ", arena_fingerprint, ", but the dataset has fingerprint ",
+        fingerprint));
+  }
+
+  const char* trailer = base + length - kTrailerSize;
+  const uint64_t index_offset = core::DecodeFixed64(trailer);
+  const uint64_t num_elements = core::DecodeFixed64(trailer + 8);
+  const uint32_t num_components = core::DecodeFixed32(trailer + 16);
+  const uint32_t index_crc = crc32c::Unmask(core::DecodeFixed32(trailer + 20));
+  if (index_offset < kHeaderSize || index_offset > length - kTrailerSize) {
+    return CorruptArena(path, "bad index offset");
+  }
+  absl::string_view index(base + index_offset,
+                          length - kTrailerSize - index_offset);
+  if (crc32c::Value(index.data(), index.size()) != index_crc) {
+    return CorruptArena(path, "index checksum mismatch");
+  }
+  if (num_elements > 0 && num_components != dtypes.size()) {
+    return absl::FailedPreconditionError(absl::StrCat(
+        "Memory cache arena ", path, " holds elements with ", num_components,
+        " components, but the dataset produces ", dtypes.size()));
+  }
+
+  std::vector<std::vector<Tensor>> result;
+  result.reserve(num_elements);
+  for (uint64_t e = 0; e < num_elements; ++e) {
+    std::vector<Tensor> element;
+    element.reserve(num_components);
+    for (uint32_t c = 0; c < num_components; ++c) {
+      uint32_t dtype, encoding, rank;
+      if (!core::GetVarint32(&index, &dtype) ||
+          !core::GetVarint32(&index, &encoding) ||
+          !core::GetVarint32(&index, &rank)) {
+        return CorruptArena(path, "truncated index");
+      }
+      if (dtype != dtypes[c]) {
+        return absl::FailedPreconditionError(absl::StrCat(
+            "Memory cache arena ", path, " holds ",
+            DataTypeString(static_cast<DataType>(dtype)),
+            " tensors in component ", c, ", but the dataset produces ",
+            DataTypeString(dtypes[c])));
+      }
+      TensorShape shape;
+      for (uint32_t d = 0; d < rank; ++d) {
+        uint64_t dim;
+        if (!core::GetVarint64(&index, &dim)) {
+          return CorruptArena(path, "truncated index");
+        }
+        TF_RETURN_IF_ERROR(shape.AddDimWithStatus(dim));
+      }
+      uint64_t offset, size;
+      if (!core::GetVarint64(&index, &offset) ||
+          !core::GetVarint64(&index, &size)) {
+        return CorruptArena(path, "truncated index");
+      }
+      if (offset < kHeaderSize || offset > index_offset ||
+          size > index_offset - offset) {
+        return CorruptArena(path, "tensor out of bounds");
+      }
+      const char* data = base + offset;
+      if (encoding == static_cast<uint32_t>(Encoding::kRaw)) {
+        const DataType type = static_cast<DataType>(dtype);
+        if (size != shape.num_elements() * DataTypeSize(type)) {
+          return CorruptArena(path, "tensor size does not match its shape");
+        }
+        if (size == 0) {
+          element.emplace_back(type, shape);
+        } else {
+          element.emplace_back(type, shape,
+                               core::RefCountPtr<TensorBuffer>(
+                                   new MappedTensorBuffer(region, data, size)));
+        }
+      } else if (encoding == static_cast<uint32_t>(Encoding::kProto)) {
+        TensorProto proto;
+        Tensor t;
+        if (!proto.ParseFromArray(data, size) || !t.FromProto(proto)) {
+          return CorruptArena(path, "cannot parse tensor");
+        }
+        element.push_back(std::move(t));
+      } else {
+        return CorruptArena(path, "unknown tensor encoding");
+      }
+    }
+    result.push_back(std::move(element));
+  }
+  if (!index.empty()) {
+    return CorruptArena(path, "trailing bytes in index");
+  }
+  *elements = std::move(result);
+  return absl::OkStatus();
+}
+
+}  // namespace data
+}  // namespace tensorflow
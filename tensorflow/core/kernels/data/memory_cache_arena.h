@@ -0,0 +1,102 @@
+/* Copyright 2026 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#ifndef TENSORFLOW_CORE_KERNELS_DATA_MEMORY_CACHE_ARENA_H_
+#define TENSORFLOW_CORE_KERNELS_DATA_MEMORY_CACHE_ARENA_H_
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "tensorflow/core/framework/tensor.h"
+#include "tensorflow/core/framework/types.h"
+#include "tensorflow/core/platform/env.h"
+
+namespace tensorflow {
+namespace data {
+
+// Prefix of the `filename` argument of `CacheDataset` that selects an
+// in-memory cache backed by a shared arena file, e.g.
+// "mmap:///dev/shm/train_cache". The rest of the filename is the arena path.
+inline constexpr char kMemoryCacheArenaPrefix[] = "mmap://";
+
+// A memory cache arena is an append-only file holding the elements of a
+// completed in-memory cache. The first process to fill the cache writes the
+// arena; other processes on the same host, and the same process after a
+// restart, map it read-only instead of recomputing the cache. Tensors of
+// memcpy-able dtypes alias the mapping, so all processes share one copy of the
+// cache through the page cache. Other dtypes are stored as `TensorProto`s and
+// copied when the arena is read.
+//
+// An arena records the fingerprint of the input pipeline that produced it, and
+// is only attached to caches of pipelines with the same fingerprint.
+//
+// Layout: a 64-byte header holding the fingerprint, the tensor data (each raw
+// tensor aligned to 64 bytes), an index describing every tensor, and a
+// fixed-size trailer. Only the index is checksummed, so that attaching to an
+// arena does not touch its data.
+class MemoryCacheArenaWriter {
+ public:
+  // Starts writing an arena that will be published at `path` for the input
+  // pipeline with the given `fingerprint`. Elements are appended to a
+  // temporary file in the same directory.
+  static absl::StatusOr<std::unique_ptr<MemoryCacheArenaWriter>> Create(
+      Env* env, const std::string& path, uint64_t fingerprint);
+
+  // Deletes the temporary file unless the arena has been published.
+  ~MemoryCacheArenaWriter();
+
+  // Appends one dataset element.
+  absl::Status Append(const std::vector<Tensor>& element);
+
+  // Writes the index and atomically renames the temporary file to `path`. If
+  // several processes publish an arena at the same path, the last one wins;
+  // readers that mapped an earlier one keep using it.
+  absl::Status Finish();
+
+  int64_t num_elements() const { return num_elements_; }
+
+ private:
+  MemoryCacheArenaWriter(Env* env, std::string path, std::string temp_path,
+                         std::unique_ptr<WritableFile> file);
+
+  absl::Status AppendPadding();
+
+  Env* const env_;
+  const std::string path_;
+  const std::string temp_path_;
+  std::unique_ptr<WritableFile> file_;
+  uint64_t offset_ = 0;
+  std::string index_;
+  int64_t num_elements_ = 0;
+  int64_t num_components_ = -1;
+  bool finished_ = false;
+};
+
+// Maps the arena published at `path` and returns its elements. Returns
+// `NotFound` if no arena has been published at `path` and
+// `FailedPrecondition` if the arena was written by an input pipeline with a
+// different `fingerprint` or does not hold elements of `dtypes`.
+absl::Status ReadMemoryCacheArena(Env* env, const std::string& path,
+                                  uint64_t fingerprint,
+                                  const DataTypeVector& dtypes,
+                                  std::vector<std::vector<Tensor>>* elements);
+
+}  // namespace data
+}  // namespace tensorflow
+
+#endif  // TENSORFLOW_CORE_KERNELS_DATA_MEMORY_CACHE_ARENA_H_
@@ -0,0 +1,159 @@
+/* Copyright 2026 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#include "tensorflow/core/kernels/data/memory_cache_arena.h"
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "absl/status/status.h"
+#include "absl/strings/str_cat.h"
+#include "tensorflow/core/framework/tensor.h"
+#include "tensorflow/core/framework/tensor_testutil.h"
+#include "tensorflow/core/lib/core/status_test_util.h"
+#include "tensorflow/core/platform/env.h"
+#include "tensorflow/core/platform/path.h"
+#include "tensorflow/core/platform/test.h"
+
+namespace tensorflow {
+namespace data {
+namespace {
+
+constexpr uint64_t kFingerprint = 0x1234567890abcdefull;
+
+std::string ArenaPath(const std::string& name) {
+  return io::JoinPath(testing::TmpDir(), name);
+}
+
+std::vector<std::vector<Tensor>> MakeElements() {
+  std::vector<std::vector<Tensor>> elements;
+  for (int i = 0; i < 3; ++i) {
+    elements.push_back(
+        {test::AsTensor<float>({1.0f * i, 2.0f * i, 3.0f}, TensorShape({3})),
+         test::AsScalar<int64_t>(i),
+         test::AsTensor<tstring>({"a", std::string(i, 'b')},
+                                 TensorShape({2}))});
+  }
+  // An element with empty tensors.
+  elements.push_back({Tensor(DT_FLOAT, TensorShape({0, 4})),
+                      test::AsScalar<int64_t>(7),
+                      Tensor(DT_STRING, TensorShape({0}))});
+  return elements;
+}
+
+TEST(MemoryCacheArenaTest, RoundTrip) {
+  const std::string path = ArenaPath("round_trip");
+  const std::vector<std::vector<Tensor>> expected = MakeElements();
+  auto writer =
+      MemoryCacheArenaWriter::Create(Env::Default(), path, kFingerprint);
+  TF_ASSERT_OK(writer.status());
+  for (const auto& element : expected) {
+    TF_ASSERT_OK((*writer)->Append(element));
+  }
+  // Nothing is published before Finish().
+  EXPECT_TRUE(absl::IsNotFound(Env::Default()->FileExists(path)));
+  TF_ASSERT_OK((*writer)->Finish());
+  EXPECT_EQ((*writer)->num_elements(), expected.size());
+  writer->reset();
+
+  std::vector<std::vector<Tensor>> elements;
+  TF_ASSERT_OK(ReadMemoryCacheArena(Env::Default(), path, kFingerprint,
+                                    {DT_FLOAT, DT_INT64, DT_STRING},
+                                    &elements));
+  ASSERT_EQ(elements.size(), expected.size());
+  for (size_t i = 0; i < expected.size(); ++i) {
+    ASSERT_EQ(elements[i].size(), expected[i].size());
+    for (size_t j = 0; j < expected[i].size(); ++j) {
+      test::ExpectTensorEqual<void>(elements[i][j], expected[i][j]);
+    }
+    EXPECT_TRUE(elements[i][0].IsAligned());
+  }
+}
+
+TEST(MemoryCacheArenaTest, MissingArenaIsNotFound) {
+  std::vector<std::vector<Tensor>> elements;
+  EXPECT_TRUE(absl::IsNotFound(ReadMemoryCacheArena(
+      Env::Default(), ArenaPath("missing"), kFingerprint, {DT_FLOAT},
+      &elements)));
+}
+
+TEST(MemoryCacheArenaTest, UnfinishedArenaIsDiscarded) {
+  const std::string path = ArenaPath("unfinished");
+  {
+    auto writer =
+      MemoryCacheArenaWriter::Create(Env::Default(), path, kFingerprint);
+    TF_ASSERT_OK(writer.status());
+    TF_ASSERT_OK((*writer)->Append({test::AsScalar<int64_t>(1)}));
+  }
+  std::vector<std::string> files;
+  TF_ASSERT_OK(
+      Env::Default()->GetMatchingPaths(absl::StrCat(path, "*"), &files));
+  EXPECT_TRUE(files.empty());
+}
+
+TEST(MemoryCacheArenaTest, RejectsMismatchedDtypes) {
+  const std::string path = ArenaPath("mismatched");
+  auto writer =
+      MemoryCacheArenaWriter::Create(Env::Default(), path, kFingerprint);
+  TF_ASSERT_OK(writer.status());
+  TF_ASSERT_OK((*writer)->Append({test::AsScalar<int64_t>(1)}));
+  TF_ASSERT_OK((*writer)->Finish());
+
+  std::vector<std::vector<Tensor>> elements;
+  EXPECT_TRUE(absl::IsFailedPrecondition(ReadMemoryCacheArena(
+      Env::Default(), path, kFingerprint, {DT_FLOAT}, &elements)));
+  EXPECT_TRUE(absl::IsFailedPrecondition(ReadMemoryCacheArena(
+      Env::Default(), path, kFingerprint, {DT_INT64, DT_INT64}, &elements)));
+}
+
+TEST(MemoryCacheArenaTest, RejectsMismatchedFingerprint) {
+  const std::string path = ArenaPath("other_pipeline");
+  auto writer =
+      MemoryCacheArenaWriter::Create(Env::Default(), path, kFingerprint);
+  TF_ASSERT_OK(writer.status());
+  TF_ASSERT_OK((*writer)->Append({test::AsScalar<int64_t>(1)}));
+  TF_ASSERT_OK((*writer)->Finish());
+
+  std::vector<std::vector<Tensor>> elements;
+  EXPECT_TRUE(absl::IsFailedPrecondition(ReadMemoryCacheArena(
+      Env::Default(), path, kFingerprint + 1, {DT_INT64}, &elements)));
+  TF_EXPECT_OK(ReadMemoryCacheArena(Env::Default(), path, kFingerprint,
+                                    {DT_INT64}, &elements));
+}
+
+TEST(MemoryCacheArenaTest, DetectsCorruption) {
+  const std::string path = ArenaPath("corrupted");
+  auto writer =
+      MemoryCacheArenaWriter::Create(Env::Default(), path, kFingerprint);
+  TF_ASSERT_OK(writer.status());
+  TF_ASSERT_OK((*writer)->Append({test::AsScalar<int64_t>(1)}));
+  TF_ASSERT_OK((*writer)->Finish());
+
+  std::string contents;
+  TF_ASSERT_OK(ReadFileToString(Env::Default(), path, &contents));
+  // Flip a byte of the index, which follows the 64-byte header and the data.
+  contents[72] ^= 0x1;
+  TF_ASSERT_OK(WriteStringToFile(Env::Default(), path, contents));
+
+  std::vector<std::vector<Tensor>> elements;
+  EXPECT_TRUE(absl::IsDataLoss(
+      ReadMemoryCacheArena(Env::Default(), path, kFingerprint, {DT_INT64},
+                           &elements)));
+}
+
+}  // namespace
+}  // namespace data
+}  // namespace tensorflow
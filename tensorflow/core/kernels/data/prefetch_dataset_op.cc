@@ -22,10 +22,12 @@ limitations under the License.
 #include <functional>
 #include <limits>
 #include <memory>
+#include <optional>
 #include <string>
 #include <utility>
 #include <vector>
 
+#include "absl/container/flat_hash_set.h"
 #include "absl/log/check.h"
 #include "absl/log/log.h"
 #include "absl/status/status.h"
@@ -44,6 +46,7 @@ limitations under the License.
 #include "tensorflow/core/framework/stats_aggregator.h"
 #include "tensorflow/core/framework/tensor.h"
 #include "tensorflow/core/kernels/data/prefetch_autotuner.h"
+#include "tensorflow/core/kernels/data/prefetch_ring_buffer.h"
 #include "tensorflow/core/lib/gtl/cleanup.h"
 #include "tensorflow/core/lib/strings/str_util.h"
 #include "tensorflow/core/lib/strings/stringprintf.h"
@@ -84,13 +87,15 @@ constexpr char kErrorMessageSuffix[] = ".error_message";
 class PrefetchDatasetOp::Dataset : public DatasetBase {
  public:
   Dataset(OpKernelContext* ctx, const DatasetBase* input, int64_t buffer_size,
-          int64_t slack_period, bool legacy_autotune, int64_t buffer_size_min)
+          int64_t slack_period, bool legacy_autotune, int64_t buffer_size_min,
+          bool use_ring_buffer)
       : DatasetBase(DatasetContext(ctx)),
         input_(input),
         buffer_size_(buffer_size),
         slack_period_(slack_period),
         legacy_autotune_(legacy_autotune),
-        buffer_size_min_(buffer_size_min) {
+        buffer_size_min_(buffer_size_min),
+        use_ring_buffer_(use_ring_buffer) {
     input_->Ref();
     random_indexing_compatible_ = absl::OkStatus();
     if (input_ != nullptr) {
@@ -181,6 +186,10 @@ class PrefetchDatasetOp::Dataset : public DatasetBase {
               legacy_autotune_ ? 0 : params.dataset->buffer_size_, mu_,
               cond_var_)) {
       slack_us_ = 0;
+      if (params.dataset->use_ring_buffer_) {
+        ring_ = std::make_unique<PrefetchRingBuffer<BufferElement>>(
+            std::max<int64_t>(params.dataset->buffer_size_, 1));
+      }
     }
 
     ~Iterator() override {
@@ -200,6 +209,7 @@ class PrefetchDatasetOp::Dataset : public DatasetBase {
       if (buffer_size_->value == model::kAutotune) {
         buffer_size_->value = buffer_size_min_;
       }
+      ring_limit_ = buffer_limit();
       cancellation_manager_ = std::make_unique<CancellationManager>();
       TF_RETURN_IF_ERROR(RegisterCancellationCallback(
           ctx->cancellation_manager(), [this]() { CancelThreads(); },
@@ -219,7 +229,9 @@ class PrefetchDatasetOp::Dataset : public DatasetBase {
     absl::Status GetNextInternal(IteratorContext* ctx,
                                  std::vector<Tensor>* out_tensors,
                                  bool* end_of_sequence) override {
-      const auto& stats_aggregator = ctx->stats_aggregator();
+      if (ring_) {
+        return GetNextFromRing(ctx, out_tensors, end_of_sequence);
+      }
       {
         mutex_lock l(*mu_);
         TF_RETURN_IF_ERROR(EnsureThreadsStarted(ctx));
@@ -247,21 +259,7 @@ class PrefetchDatasetOp::Dataset : public DatasetBase {
 
         DCHECK_EQ(buffer_limit(), 0);
       }
-
-      mutex_lock input_l(input_mu_);
-      {
-        mutex_lock l(*mu_);
-        if (stats_aggregator) {
-          stats_aggregator->AddScalar(
-              stats_utils::BufferSizeScalarName(dataset()->node_name()),
-              static_cast<float>(buffer_.size()), num_elements());
-          stats_aggregator->AddScalar(
-              stats_utils::BufferCapacityScalarName(dataset()->node_name()),
-              static_cast<float>(buffer_limit()), num_elements());
-        }
-        // Release mu_
-      }
-      return input_impl_->GetNext(ctx, out_tensors, end_of_sequence);
+      return GetNextFromInput(ctx, out_tensors, end_of_sequence);
     }
 
    protected:
@@ -290,22 +288,21 @@ class PrefetchDatasetOp::Dataset : public DatasetBase {
       // all GetNext threads are blocked.
       mutex_lock input_l(input_mu_);
       mutex_lock l(*mu_);
+      // Also block the `GetNext` threads popping from the ring buffer.
+      mutex_lock ring_l(ring_mu_);
       TF_RETURN_IF_ERROR(SaveInput(ctx, writer, input_impl_));
       TF_RETURN_IF_ERROR(
-          writer->WriteScalar(prefix(), kBufferSize, buffer_.size()));
+          writer->WriteScalar(prefix(), kBufferSize, NumBuffered()));
+      if (ring_) {
+        absl::Status s;
+        size_t i = 0;
+        ring_->ForEach([&](const BufferElement& buffer_element) {
+          if (s.ok()) s = WriteBufferElement(writer, i++, buffer_element);
+        });
+        return s;
+      }
       for (size_t i = 0; i < buffer_.size(); i++) {
-        auto& buffer_element = buffer_[i];
-        TF_RETURN_IF_ERROR(WriteStatus(writer, i, buffer_element.status));
-        if (buffer_element.status.ok()) {
-          TF_RETURN_IF_ERROR(writer->WriteScalar(
-              absl::StrCat(prefix(), "::", i),
-              absl::StrCat(kBuffer, kSizeSuffix), buffer_element.value.size()));
-          for (size_t j = 0; j < buffer_element.value.size(); j++) {
-            TF_RETURN_IF_ERROR(writer->WriteTensor(
-                absl::StrCat(prefix(), "::", i),
-                absl::StrCat(kBuffer, "[", j, "]"), buffer_element.value[j]));
-          }
-        }
+        TF_RETURN_IF_ERROR(WriteBufferElement(writer, i, buffer_[i]));
       }
       return absl::OkStatus();
     }
@@ -321,6 +318,13 @@ class PrefetchDatasetOp::Dataset : public DatasetBase {
       if (!ctx->symbolic_checkpoint()) {
         TF_RETURN_IF_ERROR(RestoreBuffer(ctx, reader));
       }
+      if (ring_) {
+        DCHECK_EQ(ring_->size(), 0);
+        while (!buffer_.empty()) {
+          ring_->Push(std::move(buffer_.front()));
+          buffer_.pop_front();
+        }
+      }
 
       if (ctx->warm_start()) {
         TF_RETURN_IF_ERROR(EnsureThreadsStarted(ctx));
@@ -336,14 +340,26 @@ class PrefetchDatasetOp::Dataset : public DatasetBase {
       // right away to avoid introducing tracing overhead.
       if (mu_->try_lock()) {
         limit = buffer_limit();
-        size = buffer_.size();
-        if (!buffer_.empty()) {
-          std::vector<std::string> shapes(buffer_.front().value.size());
-          for (const auto& component : buffer_.front().value) {
+        size = NumBuffered();
+        auto add_shapes = [&result](const BufferElement& buffer_element) {
+          std::vector<std::string> shapes;
+          shapes.reserve(buffer_element.value.size());
+          for (const auto& component : buffer_element.value) {
             shapes.push_back(component.shape().DebugString());
           }
           result.push_back(std::make_pair("next_element_shapes",
                                           absl::StrJoin(shapes, ",")));
+        };
+        if (ring_) {
+          // Holding `ring_mu_` in addition to `mu_` keeps all `GetNext`
+          // threads from popping the element, which the prefetch thread
+          // never touches once pushed.
+          if (ring_mu_.try_lock()) {
+            ring_->PeekFront(add_shapes);
+            ring_mu_.unlock();
+          }
+        } else if (!buffer_.empty()) {
+          add_shapes(buffer_.front());
         }
         mu_->unlock();
       }
@@ -439,33 +455,220 @@ class PrefetchDatasetOp::Dataset : public DatasetBase {
       cond_var_->notify_all();
     }
 
-    absl::Status Consume(IteratorContext* ctx, std::vector<Tensor>* out_tensors,
-                         bool* end_of_sequence)
-        TF_EXCLUSIVE_LOCKS_REQUIRED(mu_) {
+    // Returns the number of buffered elements.
+    size_t NumBuffered() const TF_EXCLUSIVE_LOCKS_REQUIRED(*mu_) {
+      return ring_ ? ring_->size() : buffer_.size();
+    }
+
+    // Reads an element directly from the input, which is how elements are
+    // produced while the buffer limit is zero.
+    absl::Status GetNextFromInput(IteratorContext* ctx,
+                                  std::vector<Tensor>* out_tensors,
+                                  bool* end_of_sequence)
+        TF_LOCKS_EXCLUDED(*mu_) {
+      const auto& stats_aggregator = ctx->stats_aggregator();
+      mutex_lock input_l(input_mu_);
+      {
+        mutex_lock l(*mu_);
+        if (stats_aggregator) {
+          stats_aggregator->AddScalar(
+              stats_utils::BufferSizeScalarName(dataset()->node_name()),
+              static_cast<float>(NumBuffered()), num_elements());
+          stats_aggregator->AddScalar(
+              stats_utils::BufferCapacityScalarName(dataset()->node_name()),
+              static_cast<float>(buffer_limit()), num_elements());
+        }
+        // Release mu_
+      }
+      return input_impl_->GetNext(ctx, out_tensors, end_of_sequence);
+    }
+
+    // `GetNextInternal` for iterators that buffer elements in `ring_`.
+    // Elements are popped without acquiring `mu_`, which is only taken when
+    // the buffer is empty. An element is popped and consumed while holding
+    // `ring_mu_`, so that `SaveInternal` never observes an element which has
+    // left the buffer without being handed to the caller.
+    absl::Status GetNextFromRing(IteratorContext* ctx,
+                                 std::vector<Tensor>* out_tensors,
+                                 bool* end_of_sequence)
+        TF_LOCKS_EXCLUDED(*mu_) {
+      std::optional<BufferElement> buffer_element;
+      absl::Status s;
+      int64_t num_buffered = 0;
+      if (threads_started_) {
+        tf_shared_lock ring_l(ring_mu_);
+        if (TryPopFromRing(&buffer_element)) {
+          s = ConsumeFromRing(ctx, *std::move(buffer_element), out_tensors,
+                              end_of_sequence, &num_buffered);
+        }
+      }
+      if (!buffer_element.has_value()) {
+        mutex_lock l(*mu_);
+        TF_RETURN_IF_ERROR(EnsureThreadsStarted(ctx));
+        // The prefetch thread checks `ring_consumers_waiting_` after each
+        // push, and we check the size of the buffer after incrementing it,
+        // so an element pushed after we give up on popping always wakes us.
+        ring_consumers_waiting_.fetch_add(1);
+        auto cleanup =
+            gtl::MakeCleanup([this] { ring_consumers_waiting_.fetch_sub(1); });
+        while (true) {
+          // `prefetch_thread_finished_` is set after the last element has
+          // been pushed, so it must be read before trying to pop.
+          const bool finished = prefetch_thread_finished_;
+          if (TryPopFromRing(&buffer_element) || finished ||
+              buffer_limit() == 0) {
+            break;
+          }
+          // If the buffer is not empty, another `GetNext` call has claimed
+          // its elements. The next push wakes us.
+          if (legacy_autotune_) {
+            auto_tuner_->RecordEmpty();
+            buffer_size_->value = auto_tuner_->buffer_limit();
+            ring_limit_ = auto_tuner_->buffer_limit();
+          }
+          RecordStop(ctx);
+          cond_var_->wait(l);
+          RecordStart(ctx);
+        }
+        if (!buffer_element.has_value()) {
+          if (prefetch_thread_finished_) {
+            *end_of_sequence = true;
+            return absl::OkStatus();
+          }
+        } else {
+          // `SaveInternal` also acquires `mu_`, so it cannot run between
+          // popping and consuming the element.
+          tf_shared_lock ring_l(ring_mu_);
+          s = ConsumeFromRing(ctx, *std::move(buffer_element), out_tensors,
+                              end_of_sequence, &num_buffered);
+        }
+      }
+      if (buffer_element.has_value()) {
+        FinishConsumeFromRing(s, num_buffered, *out_tensors);
+        return s;
+      }
+      return GetNextFromInput(ctx, out_tensors, end_of_sequence);
+    }
+
+    // Pops the oldest element of `ring_` into `*buffer_element`, which must be
+    // empty. `BufferElement` cannot be assigned, so it is moved into place.
+    bool TryPopFromRing(std::optional<BufferElement>* buffer_element) {
+      std::optional<BufferElement> popped = ring_->TryPop();
+      if (!popped.has_value()) return false;
+      buffer_element->emplace(*std::move(popped));
+      return true;
+    }
+
+    // Records the buffer statistics observed by a consumer.
+    void RecordBufferStats(IteratorContext* ctx, int64_t num_buffered,
+                           int64_t buffer_limit) {
       const auto& stats_aggregator = ctx->stats_aggregator();
       if (stats_aggregator) {
-        double buffer_limit_ = buffer_limit();
         stats_aggregator->AddToHistogram(
             stats_utils::BufferUtilizationHistogramName(dataset()->node_name()),
-            {static_cast<float>(buffer_.size()) /
-             static_cast<float>(buffer_limit_)},
+            {static_cast<float>(num_buffered) /
+             static_cast<float>(buffer_limit)},
             num_elements());
         stats_aggregator->AddScalar(
             stats_utils::BufferSizeScalarName(dataset()->node_name()),
-            static_cast<float>(buffer_.size()), num_elements());
+            static_cast<float>(num_buffered), num_elements());
         stats_aggregator->AddScalar(
             stats_utils::BufferCapacityScalarName(dataset()->node_name()),
-            static_cast<float>(buffer_limit_), num_elements());
+            static_cast<float>(buffer_limit), num_elements());
+      }
+    }
+
+    absl::Status Consume(IteratorContext* ctx, std::vector<Tensor>* out_tensors,
+                         bool* end_of_sequence)
+        TF_EXCLUSIVE_LOCKS_REQUIRED(mu_) {
+      RecordBufferStats(ctx, buffer_.size(), buffer_limit());
+      absl::Status s = ConsumeElement(ctx, buffer_.front(), out_tensors);
+      // Tells the legacy prefetch autotuner the size of an element to enable
+      // memory budget prediction.
+      if (s.ok() && legacy_autotune_ && !auto_tuner_->HasElementSize()) {
+        // TODO(jimlintw): Consider using a moving average to better
+        // estimate the element size instead of relying on the
+        // first-seen element size
+        auto_tuner_->SetElementSize(GetAllocatedBytes(*out_tensors));
       }
+      if (legacy_autotune_) {
+        auto_tuner_->RecordConsumption(buffer_.size());
+        buffer_size_->value = auto_tuner_->buffer_limit();
+      }
+      buffer_.pop_front();
+
+      metrics::RecordTFDataPrefetchDequeue(dataset()->node_name());
+      metrics::RecordTFDataPrefetchBufferSize(dataset()->node_name(),
+                                              buffer_.size());
+      *end_of_sequence = false;
+
+      // Wake the prefetch thread, in case it has been waiting for space
+      // in the buffer. Also wake up threads from other calls to GetNext.
+      //
+      // TODO(mrry): Consider using different condition variables for
+      // GetNext and Prefetch.
+      cond_var_->notify_all();
+      return s;
+    }
+
+    // `Consume` for an element popped from `ring_`. Sets `*num_buffered` to
+    // the number of elements left in `ring_`. The autotuner state is guarded
+    // by `mu_`, so consumptions of a full buffer are only flagged here and
+    // handed to the autotuner by the prefetch thread.
+    absl::Status ConsumeFromRing(IteratorContext* ctx,
+                                 BufferElement buffer_element,
+                                 std::vector<Tensor>* out_tensors,
+                                 bool* end_of_sequence, int64_t* num_buffered)
+        TF_SHARED_LOCKS_REQUIRED(ring_mu_) {
+      *num_buffered = ring_->size();
+      const int64_t buffer_limit = ring_limit_;
+      if (legacy_autotune_ && *num_buffered + 1 >= buffer_limit) {
+        ring_observed_full_ = true;
+      }
+      RecordBufferStats(ctx, *num_buffered + 1, buffer_limit);
+      absl::Status s = ConsumeElement(ctx, buffer_element, out_tensors);
+      metrics::RecordTFDataPrefetchDequeue(dataset()->node_name());
+      metrics::RecordTFDataPrefetchBufferSize(dataset()->node_name(),
+                                              *num_buffered);
+      *end_of_sequence = false;
+      return s;
+    }
+
+    // Completes `ConsumeFromRing` after `ring_mu_` is released, since it may
+    // acquire `mu_`.
+    void FinishConsumeFromRing(const absl::Status& status,
+                               int64_t num_buffered,
+                               const std::vector<Tensor>& out_tensors)
+        TF_LOCKS_EXCLUDED(*mu_, ring_mu_) {
+      // Wake the prefetch thread once enough elements have been consumed for
+      // it to refill a batch of slots.
+      const int64_t producer_wake_size = producer_wake_size_;
+      if (producer_wake_size >= 0 && num_buffered <= producer_wake_size) {
+        mutex_lock l(*mu_);
+        cond_var_->notify_all();
+      }
+      if (status.ok() && legacy_autotune_ && !ring_has_element_size_) {
+        mutex_lock l(*mu_);
+        if (!auto_tuner_->HasElementSize()) {
+          auto_tuner_->SetElementSize(GetAllocatedBytes(out_tensors));
+        }
+        ring_has_element_size_ = true;
+      }
+    }
+
+    // Forwards the status and (if OK) the value of a buffered element.
+    absl::Status ConsumeElement(IteratorContext* ctx,
+                                BufferElement& buffer_element,
+                                std::vector<Tensor>* out_tensors) {
       // A new element is available. Forward the status from computing it, and
       // (if we successfully got an element) the output values.
-      absl::Status s = buffer_.front().status;
+      absl::Status s = buffer_element.status;
       if (s.ok()) {
-        uint64_t buffer_element_id = buffer_.front().uid;
+        uint64_t buffer_element_id = buffer_element.uid;
 
         // 1. Calculate the exact time this element sat in the buffer
         int64_t residence_time_us =
-            EnvTime::NowMicros() - buffer_.front().created_us;
+            EnvTime::NowMicros() - buffer_element.created_us;
 
         // 2. Record it to our Histogram
         metrics::RecordTFDataPrefetchResidenceTime(dataset()->node_name(),
@@ -490,7 +693,7 @@ class PrefetchDatasetOp::Dataset : public DatasetBase {
             (num_elements() + 1) % dataset()->slack_period_ == 0) {
           // TODO(rachelim): Consider doing something more sophisticated
           // to decide how long to sleep for; e.g. using a kalman filter.
-          int64_t slack_us = EnvTime::NowMicros() - buffer_.front().created_us;
+          int64_t slack_us = EnvTime::NowMicros() - buffer_element.created_us;
           // Every slack_period_-th element, update the most recent slack time,
           // measured by the duration between when the element is prefetched
           // and when it is consumed. We add kSleepFactor * slack_us_ to the
@@ -499,41 +702,26 @@ class PrefetchDatasetOp::Dataset : public DatasetBase {
           slack_us_ = kSleepFactor * slack_us_ + slack_us;
           VLOG(2) << "Setting slack_us_: " << slack_us_;
         }
-        *out_tensors = std::move(buffer_.front().value);
-        ctx->MergeCheckpoint(&buffer_.front().checkpoint);
+        *out_tensors = std::move(buffer_element.value);
+        ctx->MergeCheckpoint(&buffer_element.checkpoint);
         RecordBufferDequeue(ctx, *out_tensors);
-        // Tells the legacy prefetch autotuner the size of an element to enable
-        // memory budget prediction.
-        if (legacy_autotune_ && !auto_tuner_->HasElementSize()) {
-          // TODO(jimlintw): Consider using a moving average to better
-          // estimate the element size instead of relying on the
-          // first-seen element size
-          auto_tuner_->SetElementSize(GetAllocatedBytes(*out_tensors));
-        }
       } else {
         // If status not ok, we still record the dequeue event to make sure each
         // enqueue event is paired with a dequeue event even in the presence of
         // errors.
-        RecordBufferDequeue(ctx, buffer_.front().value);
+        RecordBufferDequeue(ctx, buffer_element.value);
       }
-      if (legacy_autotune_) {
-        auto_tuner_->RecordConsumption(buffer_.size());
+      return s;
+    }
+
+    // Hands the consumptions flagged by `ConsumeFromRing` to the legacy
+    // autotuner and publishes the resulting buffer limit.
+    void UpdateRingLimit() TF_EXCLUSIVE_LOCKS_REQUIRED(*mu_) {
+      if (legacy_autotune_ && ring_observed_full_.exchange(false)) {
+        auto_tuner_->RecordConsumption(auto_tuner_->buffer_limit());
         buffer_size_->value = auto_tuner_->buffer_limit();
       }
-      buffer_.pop_front();
-
-      metrics::RecordTFDataPrefetchDequeue(dataset()->node_name());
-      metrics::RecordTFDataPrefetchBufferSize(dataset()->node_name(),
-                                              buffer_.size());
-      *end_of_sequence = false;
-
-      // Wake the prefetch thread, in case it has been waiting for space
-      // in the buffer. Also wake up threads from other calls to GetNext.
-      //
-      // TODO(mrry): Consider using different condition variables for
-      // GetNext and Prefetch.
-      cond_var_->notify_all();
-      return s;
+      ring_limit_ = buffer_limit();
     }
 
     absl::Status EnsureThreadsStarted(IteratorContext* ctx)
@@ -543,6 +731,7 @@ class PrefetchDatasetOp::Dataset : public DatasetBase {
             std::make_shared<IteratorContext>(*ctx);
         prefetch_thread_ = ctx->StartThread(
             "tf_data_prefetch", [this, new_ctx]() { PrefetchThread(new_ctx); });
+        threads_started_ = true;
       }
       return absl::OkStatus();
     }
@@ -559,11 +748,23 @@ class PrefetchDatasetOp::Dataset : public DatasetBase {
         // 1. Wait for a slot in the buffer.
         {
           mutex_lock l(*mu_);
-          while (!cancelled_ && buffer_.size() >= buffer_limit()) {
+          if (ring_) UpdateRingLimit();
+          while (!cancelled_ && NumBuffered() >= buffer_limit()) {
+            if (ring_) {
+              // Ask consumers to wake us once a quarter of the buffer is
+              // free, so that we refill it in batches. The size is checked
+              // again after publishing the threshold to not miss a wakeup.
+              const int64_t limit = buffer_limit();
+              producer_wake_size_ = std::max<int64_t>(
+                  limit - std::max<int64_t>(limit / 4, 1), 0);
+              if (NumBuffered() < limit) break;
+            }
             RecordStop(ctx.get());
             cond_var_->wait(l);
             RecordStart(ctx.get());
+            if (ring_) UpdateRingLimit();
           }
+          producer_wake_size_ = -1;
 
           if (cancelled_) {
             prefetch_thread_finished_ = true;
@@ -607,7 +808,21 @@ class PrefetchDatasetOp::Dataset : public DatasetBase {
         }
 
         // 3. Signal that the element has been produced.
-        {
+        if (ring_) {
+          RecordBufferEnqueue(ctx.get(), buffer_element.value);
+          buffer_element.created_us = EnvTime::NowMicros();
+          ring_->Push(std::move(buffer_element));
+
+          metrics::RecordTFDataPrefetchEnqueue(dataset()->node_name());
+          metrics::RecordTFDataPrefetchBufferSize(dataset()->node_name(),
+                                                  ring_->size());
+
+          // Only wake a consumer if one is waiting for an element.
+          if (ring_consumers_waiting_ > 0) {
+            mutex_lock l(*mu_);
+            cond_var_->notify_one();
+          }
+        } else {
           mutex_lock l(*mu_);
           RecordBufferEnqueue(ctx.get(), buffer_element.value);
           buffer_element.created_us = EnvTime::NowMicros();
@@ -623,6 +838,23 @@ class PrefetchDatasetOp::Dataset : public DatasetBase {
       }
     }
 
+    absl::Status WriteBufferElement(IteratorStateWriter* writer, size_t index,
+                                    const BufferElement& buffer_element)
+        TF_EXCLUSIVE_LOCKS_REQUIRED(*mu_) {
+      TF_RETURN_IF_ERROR(WriteStatus(writer, index, buffer_element.status));
+      if (buffer_element.status.ok()) {
+        TF_RETURN_IF_ERROR(writer->WriteScalar(
+            absl::StrCat(prefix(), "::", index),
+            absl::StrCat(kBuffer, kSizeSuffix), buffer_element.value.size()));
+        for (size_t j = 0; j < buffer_element.value.size(); j++) {
+          TF_RETURN_IF_ERROR(writer->WriteTensor(
+              absl::StrCat(prefix(), "::", index),
+              absl::StrCat(kBuffer, "[", j, "]"), buffer_element.value[j]));
+        }
+      }
+      return absl::OkStatus();
+    }
+
     absl::Status WriteStatus(IteratorStateWriter* writer, size_t index,
                              const absl::Status& status)
         TF_EXCLUSIVE_LOCKS_REQUIRED(*mu_) {
@@ -697,6 +929,25 @@ class PrefetchDatasetOp::Dataset : public DatasetBase {
     // tree. We record the interleave depth so that it can be included in the
     // trace metadata.
     int64_t interleave_depth_ = -1;
+
+    // If the "prefetch_ring_buffer" experiment is enabled, elements are
+    // buffered in `ring_` instead of `buffer_`. `GetNext` threads pop from it
+    // without acquiring `mu_`, holding `ring_mu_` in shared mode so that
+    // `SaveInternal` can block them.
+    std::unique_ptr<PrefetchRingBuffer<BufferElement>> ring_;
+    mutable mutex ring_mu_ TF_ACQUIRED_AFTER(*mu_);
+    std::atomic<bool> threads_started_ = false;
+    // Number of `GetNext` threads blocked on an empty ring buffer.
+    std::atomic<int64_t> ring_consumers_waiting_ = 0;
+    // If non-negative, the buffer size at which consumers wake the prefetch
+    // thread.
+    std::atomic<int64_t> producer_wake_size_ = -1;
+    // `buffer_limit()` as of the last time the prefetch thread checked it.
+    std::atomic<int64_t> ring_limit_ = 0;
+    // Set when an element is consumed from a full ring buffer.
+    std::atomic<bool> ring_observed_full_ = false;
+    std::atomic<bool> ring_has_element_size_ = false;
+
     std::unique_ptr<Thread> prefetch_thread_ TF_GUARDED_BY(*mu_);
   };
 
@@ -714,6 +965,9 @@ class PrefetchDatasetOp::Dataset : public DatasetBase {
   // parameter.
   const int64_t buffer_size_min_ = 0;
 
+  // Determines whether elements are buffered in a `PrefetchRingBuffer`.
+  const bool use_ring_buffer_ = false;
+
   absl::Status random_indexing_compatible_;
   TraceMeMetadata traceme_metadata_;
 };
@@ -729,10 +983,12 @@ PrefetchDatasetOp::PrefetchDatasetOp(OpKernelConstruction* ctx)
   if (ctx->HasAttr(kBufferSizeMin)) {
     OP_REQUIRES_OK(ctx, ctx->GetAttr(kBufferSizeMin, &buffer_size_min_));
   }
-  if (GetExperiments().contains("autotune_buffer_optimization")) {
+  const absl::flat_hash_set<std::string> experiments = GetExperiments();
+  if (experiments.contains("autotune_buffer_optimization")) {
     legacy_autotune_ = false;
     buffer_size_min_ = std::max(static_cast<int64_t>(1), buffer_size_min_);
   }
+  use_ring_buffer_ = experiments.contains("prefetch_ring_buffer");
 }
 
 void PrefetchDatasetOp::MakeDataset(OpKernelContext* ctx, DatasetBase* input,
@@ -751,7 +1007,7 @@ void PrefetchDatasetOp::MakeDataset(OpKernelContext* ctx, DatasetBase* input,
   }
 
   *output = new Dataset(ctx, input, buffer_size, slack_period_,
-                        legacy_autotune_, buffer_size_min_);
+                        legacy_autotune_, buffer_size_min_, use_ring_buffer_);
 }
 
 namespace {
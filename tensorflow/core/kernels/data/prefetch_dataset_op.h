@@ -45,6 +45,7 @@ class PrefetchDatasetOp : public UnaryDatasetOpKernel {
   int64_t slack_period_ = 0;
   bool legacy_autotune_ = true;
   int64_t buffer_size_min_ = 0;
+  bool use_ring_buffer_ = false;
 };
 
 }  // namespace data
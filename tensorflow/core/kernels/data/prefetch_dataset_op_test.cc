@@ -327,6 +327,51 @@ IteratorSaveAndRestoreTestCases() {
 ITERATOR_SAVE_AND_RESTORE_TEST_P(PrefetchDatasetOpTest, PrefetchDatasetParams,
                                  IteratorSaveAndRestoreTestCases())
 
+// Runs the iterator with elements buffered in a `PrefetchRingBuffer`.
+class PrefetchRingBufferTest
+    : public PrefetchDatasetOpTest,
+      public ::testing::WithParamInterface<PrefetchDatasetParams> {
+ protected:
+  void SetUp() override {
+    setenv("TF_JOB_NAME", "test_job", /*overwrite=*/1);
+    setenv("TF_TASK_ID", "0", /*overwrite=*/1);
+    setenv("TF_DATA_EXPERIMENT_OPT_IN", "prefetch_ring_buffer",
+           /*overwrite=*/1);
+  }
+
+  void TearDown() override {
+    unsetenv("TF_JOB_NAME");
+    unsetenv("TF_TASK_ID");
+    unsetenv("TF_DATA_EXPERIMENT_OPT_IN");
+  }
+};
+
+TEST_P(PrefetchRingBufferTest, GetNext) {
+  auto dataset_params = GetParam();
+  TF_ASSERT_OK(Initialize(dataset_params));
+  TF_ASSERT_OK(CheckIteratorGetNext(
+      CreateTensors<int64_t>(
+          TensorShape{1}, {{0}, {1}, {2}, {3}, {4}, {5}, {6}, {7}, {8}, {9}}),
+      /*compare_order=*/true));
+}
+
+TEST_P(PrefetchRingBufferTest, SaveAndRestore) {
+  auto dataset_params = GetParam();
+  TF_ASSERT_OK(Initialize(dataset_params));
+  TF_ASSERT_OK(CheckIteratorSaveAndRestore(
+      dataset_params.iterator_prefix(),
+      CreateTensors<int64_t>(
+          TensorShape{1}, {{0}, {1}, {2}, {3}, {4}, {5}, {6}, {7}, {8}, {9}}),
+      /*breakpoints=*/{0, 4, 11}, /*compare_order=*/true));
+}
+
+INSTANTIATE_TEST_SUITE_P(PrefetchDatasetOpTest, PrefetchRingBufferTest,
+                         ::testing::Values(PrefetchDatasetParams1(),
+                                           PrefetchDatasetParams2(),
+                                           PrefetchDatasetParams3(),
+                                           PrefetchDatasetParams4(),
+                                           PrefetchDatasetParams5()));
+
 TEST_F(PrefetchDatasetOpTest, InvalidBufferSize) {
   auto dataset_params = InvalidBufferSizePrefetchDatasetParams();
   EXPECT_EQ(Initialize(dataset_params).code(), error::INVALID_ARGUMENT);
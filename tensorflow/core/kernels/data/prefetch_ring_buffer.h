@@ -0,0 +1,214 @@
+/* Copyright 2026 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#ifndef TENSORFLOW_CORE_KERNELS_DATA_PREFETCH_RING_BUFFER_H_
+#define TENSORFLOW_CORE_KERNELS_DATA_PREFETCH_RING_BUFFER_H_
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <thread>  // NOLINT(build/c++11)
+#include <utility>
+
+namespace tensorflow {
+namespace data {
+
+// A lock-free FIFO with a single producer and any number of consumers, used by
+// `PrefetchDataset` to hand elements from its prefetch thread to `GetNext`
+// callers without serializing them on a mutex.
+//
+// Elements live in ring segments whose capacity is a power of two. Each slot
+// carries a sequence number that tells consumers whether it holds an element
+// and the producer whether it has been consumed. When the producer finds its
+// segment full it links a segment of twice the capacity and continues there;
+// consumers drain the old segment before moving on. The buffer thus grows to
+// whatever limit the caller enforces (e.g. a limit raised by
+// `PrefetchAutotuner`) without ever moving an element. Retired segments are
+// kept until the buffer is destroyed, which bounds the memory overhead by the
+// capacity of the largest segment.
+//
+// The buffer does not block: callers bound its size and wait for elements or
+// space themselves, using `size()`.
+template <typename T>
+class PrefetchRingBuffer {
+ public:
+  explicit PrefetchRingBuffer(int64_t initial_capacity = 1)
+      : first_segment_(new Segment(RoundUpToPowerOfTwo(initial_capacity))),
+        producer_segment_(first_segment_),
+        consumer_segment_(first_segment_) {}
+
+  ~PrefetchRingBuffer() {
+    Segment* segment = first_segment_;
+    while (segment != nullptr) {
+      Segment* next = segment->next.load(std::memory_order_relaxed);
+      delete segment;
+      segment = next;
+    }
+  }
+
+  PrefetchRingBuffer(const PrefetchRingBuffer&) = delete;
+  PrefetchRingBuffer& operator=(const PrefetchRingBuffer&) = delete;
+
+  // Appends `element`. Must not be called by two threads at the same time.
+  void Push(T element) {
+    Segment* segment = producer_segment_;
+    const uint64_t position = segment->tail;
+    Slot* slot = &segment->slots[position & segment->mask];
+    while (slot->sequence.load(std::memory_order_acquire) != position) {
+      // The slot still holds the element pushed one lap ago. If the buffer
+      // holds fewer elements than the segment has slots, a consumer has
+      // claimed that element and is about to release the slot.
+      if (size_.load() > static_cast<int64_t>(segment->mask)) {
+        Segment* next = new Segment(2 * (segment->mask + 1));
+        segment->next.store(next, std::memory_order_release);
+        producer_segment_ = next;
+        Push(std::move(element));
+        return;
+      }
+      std::this_thread::yield();
+    }
+    slot->value.emplace(std::move(element));
+    slot->sequence.store(position + 1, std::memory_order_release);
+    segment->tail = position + 1;
+    size_.fetch_add(1);
+  }
+
+  // Removes and returns the oldest element, or returns `std::nullopt` if the
+  // buffer is empty. Safe to call from any number of threads, concurrently
+  // with `Push`.
+  std::optional<T> TryPop() {
+    Segment* segment = consumer_segment_.load(std::memory_order_acquire);
+    while (true) {
+      std::optional<T> element = TryPopFrom(segment);
+      if (element.has_value()) return element;
+      Segment* next = segment->next.load(std::memory_order_acquire);
+      if (next == nullptr) return std::nullopt;
+      // The producer has moved on, so every element of `segment` was
+      // published before `next`. Look once more before retiring `segment`.
+      std::optional<T> last_element = TryPopFrom(segment);
+      if (last_element.has_value()) return last_element;
+      if (consumer_segment_.compare_exchange_strong(segment, next)) {
+        segment = next;
+      }
+    }
+  }
+
+  // Number of elements pushed and not yet popped.
+  int64_t size() const { return size_.load(); }
+
+  // Calls `fn` on the oldest element and returns true, or returns false if
+  // the buffer is empty. May run concurrently with `Push`, but requires that
+  // no other thread pops concurrently.
+  template <typename Fn>
+  bool PeekFront(Fn fn) const {
+    for (Segment* segment = consumer_segment_.load(std::memory_order_acquire);
+         segment != nullptr;
+         segment = segment->next.load(std::memory_order_acquire)) {
+      const uint64_t position = segment->head.load(std::memory_order_relaxed);
+      const Slot& slot = segment->slots[position & segment->mask];
+      if (slot.sequence.load(std::memory_order_acquire) == position + 1) {
+        fn(*slot.value);
+        return true;
+      }
+      // The producer publishes the slots of a segment in order, so the
+      // segment holds no other element.
+    }
+    return false;
+  }
+
+  // Calls `fn` on each buffered element, oldest first. Requires that no
+  // other thread pushes or pops concurrently.
+  template <typename Fn>
+  void ForEach(Fn fn) const {
+    for (Segment* segment = consumer_segment_.load(); segment != nullptr;
+         segment = segment->next.load()) {
+      for (uint64_t position = segment->head.load();
+           position != segment->tail; ++position) {
+        fn(*segment->slots[position & segment->mask].value);
+      }
+    }
+  }
+
+ private:
+  struct Slot {
+    // `position + 1` once the element for `position` has been published, and
+    // `position + capacity` once it has been consumed.
+    std::atomic<uint64_t> sequence;
+    std::optional<T> value;
+  };
+
+  struct Segment {
+    explicit Segment(uint64_t capacity)
+        : mask(capacity - 1), slots(new Slot[capacity]) {
+      for (uint64_t i = 0; i < capacity; ++i) {
+        slots[i].sequence.store(i, std::memory_order_relaxed);
+      }
+    }
+
+    const uint64_t mask;
+    const std::unique_ptr<Slot[]> slots;
+    // Next position to consume. Kept on its own cache line so that consumers
+    // contending on it do not slow down the producer.
+    alignas(64) std::atomic<uint64_t> head{0};
+    // Next position to produce. Only accessed by the producer.
+    alignas(64) uint64_t tail = 0;
+    std::atomic<Segment*> next{nullptr};
+  };
+
+  // Segments have at least two slots, so that the sequence number of a
+  // published slot differs from that of the slot's next free position.
+  static uint64_t RoundUpToPowerOfTwo(int64_t n) {
+    uint64_t capacity = 2;
+    while (static_cast<int64_t>(capacity) < n) capacity <<= 1;
+    return capacity;
+  }
+
+  std::optional<T> TryPopFrom(Segment* segment) {
+    uint64_t position = segment->head.load(std::memory_order_relaxed);
+    while (true) {
+      Slot* slot = &segment->slots[position & segment->mask];
+      const int64_t diff =
+          static_cast<int64_t>(slot->sequence.load(std::memory_order_acquire) -
+                               (position + 1));
+      if (diff < 0) return std::nullopt;
+      if (diff > 0) {
+        // Another consumer claimed `position`.
+        position = segment->head.load(std::memory_order_relaxed);
+        continue;
+      }
+      if (segment->head.compare_exchange_weak(position, position + 1,
+                                              std::memory_order_relaxed)) {
+        std::optional<T> element(std::move(slot->value));
+        slot->value.reset();
+        slot->sequence.store(position + segment->mask + 1,
+                             std::memory_order_release);
+        size_.fetch_sub(1);
+        return element;
+      }
+    }
+  }
+
+  Segment* const first_segment_;
+  // Only accessed by the producer.
+  Segment* producer_segment_;
+  std::atomic<Segment*> consumer_segment_;
+  std::atomic<int64_t> size_{0};
+};
+
+}  // namespace data
+}  // namespace tensorflow
+
+#endif  // TENSORFLOW_CORE_KERNELS_DATA_PREFETCH_RING_BUFFER_H_
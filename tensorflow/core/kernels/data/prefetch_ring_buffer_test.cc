@@ -0,0 +1,221 @@
+/* Copyright 2026 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#include "tensorflow/core/kernels/data/prefetch_ring_buffer.h"
+
+#include <atomic>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <optional>
+#include <thread>  // NOLINT(build/c++11)
+#include <vector>
+
+#include "absl/strings/str_cat.h"
+#include "tensorflow/core/platform/env.h"
+#include "tensorflow/core/platform/mutex.h"
+#include "tensorflow/core/platform/test.h"
+#include "tensorflow/core/platform/test_benchmark.h"
+
+namespace tensorflow {
+namespace data {
+namespace {
+
+TEST(PrefetchRingBufferTest, FifoAcrossGrowth) {
+  PrefetchRingBuffer<std::unique_ptr<int>> ring(/*initial_capacity=*/2);
+  EXPECT_FALSE(ring.TryPop().has_value());
+  // Interleave pushes and pops so that the first segment wraps around before
+  // the buffer grows.
+  int next_push = 0;
+  int next_pop = 0;
+  for (int round = 0; round < 4; ++round) {
+    for (int i = 0; i < 3 * (round + 1); ++i) {
+      ring.Push(std::make_unique<int>(next_push++));
+    }
+    EXPECT_EQ(ring.size(), next_push - next_pop);
+    for (int i = 0; i < 2 * round + 1; ++i) {
+      std::optional<std::unique_ptr<int>> element = ring.TryPop();
+      ASSERT_TRUE(element.has_value());
+      EXPECT_EQ(**element, next_pop++);
+    }
+  }
+
+  std::vector<int> buffered;
+  ring.ForEach([&](const std::unique_ptr<int>& element) {
+    buffered.push_back(*element);
+  });
+  ASSERT_EQ(buffered.size(), next_push - next_pop);
+  for (int i = 0; i < buffered.size(); ++i) {
+    EXPECT_EQ(buffered[i], next_pop + i);
+  }
+
+  while (next_pop < next_push) {
+    std::optional<std::unique_ptr<int>> element = ring.TryPop();
+    ASSERT_TRUE(element.has_value());
+    EXPECT_EQ(**element, next_pop++);
+  }
+  EXPECT_FALSE(ring.TryPop().has_value());
+  EXPECT_EQ(ring.size(), 0);
+}
+
+TEST(PrefetchRingBufferTest, PeekFront) {
+  PrefetchRingBuffer<std::unique_ptr<int>> ring(/*initial_capacity=*/2);
+  int front = -1;
+  auto peek = [&front](const std::unique_ptr<int>& element) {
+    front = *element;
+  };
+  EXPECT_FALSE(ring.PeekFront(peek));
+  // Grow the buffer and drain the first segment, so that the oldest element
+  // is in a later segment.
+  for (int i = 0; i < 5; ++i) {
+    ring.Push(std::make_unique<int>(i));
+  }
+  for (int i = 0; i < 3; ++i) {
+    ASSERT_TRUE(ring.PeekFront(peek));
+    EXPECT_EQ(front, i);
+    ASSERT_TRUE(ring.TryPop().has_value());
+  }
+  ASSERT_TRUE(ring.PeekFront(peek));
+  EXPECT_EQ(front, 3);
+  EXPECT_EQ(ring.size(), 2);
+}
+
+TEST(PrefetchRingBufferTest, ConcurrentConsumers) {
+  constexpr int kNumElements = 100000;
+  constexpr int kNumConsumers = 4;
+  constexpr int kBufferLimit = 16;
+  PrefetchRingBuffer<int64_t> ring(/*initial_capacity=*/4);
+  std::atomic<bool> done = false;
+  std::vector<std::vector<int64_t>> consumed(kNumConsumers);
+  {
+    std::vector<std::unique_ptr<Thread>> consumers;
+    for (int c = 0; c < kNumConsumers; ++c) {
+      consumers.emplace_back(Env::Default()->StartThread(
+          ThreadOptions(), absl::StrCat("consumer_", c), [&, c]() {
+            while (true) {
+              // Read `done` first: it is set after the last push.
+              const bool finished = done;
+              std::optional<int64_t> element = ring.TryPop();
+              if (element.has_value()) {
+                consumed[c].push_back(*element);
+              } else if (finished) {
+                return;
+              }
+            }
+          }));
+    }
+    for (int64_t i = 0; i < kNumElements; ++i) {
+      while (ring.size() >= kBufferLimit) std::this_thread::yield();
+      ring.Push(i);
+    }
+    done = true;
+  }
+
+  // Every element is consumed exactly once, and each consumer sees elements
+  // in the order they were pushed.
+  std::vector<bool> seen(kNumElements);
+  for (const std::vector<int64_t>& elements : consumed) {
+    for (int i = 0; i < elements.size(); ++i) {
+      if (i > 0) EXPECT_LT(elements[i - 1], elements[i]);
+      EXPECT_FALSE(seen[elements[i]]);
+      seen[elements[i]] = true;
+    }
+  }
+  for (int i = 0; i < kNumElements; ++i) {
+    EXPECT_TRUE(seen[i]) << i;
+  }
+  EXPECT_EQ(ring.size(), 0);
+}
+
+// Measures how fast one producer hands elements to `num_consumers` consumers
+// through a buffer bounded to `kBufferLimit` elements. Both sides spin while
+// the buffer is full or empty, so that only the cost of the handoff itself is
+// measured.
+constexpr int64_t kBufferLimit = 64;
+
+template <typename Buffer>
+void RunHandoffBenchmark(::testing::benchmark::State& state, Buffer* buffer) {
+  const int num_consumers = state.range(0);
+  std::atomic<bool> done = false;
+  {
+    std::vector<std::unique_ptr<Thread>> consumers;
+    for (int c = 0; c < num_consumers; ++c) {
+      consumers.emplace_back(Env::Default()->StartThread(
+          ThreadOptions(), absl::StrCat("consumer_", c), [&]() {
+            while (true) {
+              const bool finished = done;
+              if (!buffer->TryPop().has_value()) {
+                if (finished) return;
+                std::this_thread::yield();
+              }
+            }
+          }));
+    }
+    int64_t i = 0;
+    for (auto s : state) {
+      while (buffer->size() >= kBufferLimit) std::this_thread::yield();
+      buffer->Push(i++);
+    }
+    done = true;
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+
+// The mutex-guarded deque that `PrefetchDataset` uses by default.
+class MutexDeque {
+ public:
+  void Push(int64_t element) {
+    mutex_lock l(mu_);
+    buffer_.push_back(element);
+  }
+
+  std::optional<int64_t> TryPop() {
+    mutex_lock l(mu_);
+    if (buffer_.empty()) return std::nullopt;
+    int64_t element = buffer_.front();
+    buffer_.pop_front();
+    return element;
+  }
+
+  int64_t size() {
+    mutex_lock l(mu_);
+    return buffer_.size();
+  }
+
+ private:
+  mutex mu_;
+  std::deque<int64_t> buffer_ TF_GUARDED_BY(mu_);
+};
+
+void BM_PrefetchRingBufferHandoff(::testing::benchmark::State& state) {
+  PrefetchRingBuffer<int64_t> buffer(kBufferLimit);
+  RunHandoffBenchmark(state, &buffer);
+}
+
+void BM_MutexDequeHandoff(::testing::benchmark::State& state) {
+  MutexDeque buffer;
+  RunHandoffBenchmark(state, &buffer);
+}
+
+BENCHMARK(BM_PrefetchRingBufferHandoff)
+    ->Arg(1)
+    ->Arg(2)
+    ->Arg(4)
+    ->Arg(8)
+    ->UseRealTime();
+BENCHMARK(BM_MutexDequeHandoff)->Arg(1)->Arg(2)->Arg(4)->Arg(8)->UseRealTime();
+
+}  // namespace
+}  // namespace data
+}  // namespace tensorflow
@@ -14,6 +14,7 @@ limitations under the License.
 ==============================================================================*/
 #include "tensorflow/core/kernels/data/shuffle_dataset_op.h"
 
+#include <array>
 #include <atomic>
 #include <cstdint>
 #include <deque>
@@ -27,6 +28,7 @@ limitations under the License.
 
 #include "absl/container/flat_hash_set.h"
 #include "absl/status/status.h"
+#include "absl/status/statusor.h"
 #include "absl/strings/str_cat.h"
 #include "tensorflow/core/data/dataset_utils.h"
 #include "tensorflow/core/data/name_utils.h"
@@ -36,11 +38,13 @@ limitations under the License.
 #include "tensorflow/core/framework/resource_mgr.h"
 #include "tensorflow/core/framework/tensor.h"
 #include "tensorflow/core/kernels/data/random_seed_ops.h"
+#include "tensorflow/core/kernels/random_index_shuffle.h"
 #include "tensorflow/core/lib/core/errors.h"
 #include "tensorflow/core/lib/random/philox_random.h"
 #include "tensorflow/core/lib/random/random.h"
 #include "tensorflow/core/lib/random/random_distributions.h"
 #include "tensorflow/core/platform/errors.h"
+#include "tensorflow/core/platform/hash.h"
 #include "tensorflow/core/platform/stringprintf.h"
 
 namespace tensorflow {
@@ -66,11 +70,14 @@ namespace data {
 
 const int64_t kLogIntervalMicros = 10 * 1000000;  // 10 seconds.
 const int64_t kMaxEpochsInBuffer = 3;
+// Number of rounds of `random::index_shuffle` used to permute indices.
+constexpr int32_t kIndexShuffleRounds = 8;
 
 constexpr char kNumRandomSamples[] = "num_random_samples";
 constexpr char kDataProduced[] = "data_produced";
 constexpr char kEndOfInputSequence[] = "end_of_input_sequence";
 constexpr char kEpoch[] = "epoch";
+constexpr char kElementCount[] = "element_count";
 constexpr char kNumElements[] = "num_elements";
 constexpr char kSlicesSize[] = "slices_size";
 constexpr char kSlicesStart[] = "slices_start";
@@ -83,6 +90,24 @@ constexpr char kShuffleDatasetV2[] = "ShuffleDatasetV2";
 constexpr char kShuffleDatasetV3[] = "ShuffleDatasetV3";
 constexpr char kShuffleAndRepeatDatasetV1[] = "ShuffleAndRepeatDataset";
 constexpr char kShuffleAndRepeatDatasetV2[] = "ShuffleAndRepeatDatasetV2";
+constexpr char kLazyGlobalShuffle[] = "lazy_global_shuffle";
+
+namespace {
+
+// Returns the key of the `random::index_shuffle` permutation for the given
+// seeds. Each `epoch` of the same seeds is permuted differently.
+std::array<uint32_t, 3> IndexShuffleKey(int64_t seed, int64_t seed2,
+                                        int64_t epoch = 0) {
+  const uint64_t seed_high_bits =
+      (static_cast<uint64_t>(seed) >> 32) ^ (static_cast<uint64_t>(seed2) >> 32);
+  return {static_cast<uint32_t>(seed), static_cast<uint32_t>(seed2),
+          static_cast<uint32_t>(
+              epoch == 0 ? seed_high_bits
+                         : Hash64Combine(seed_high_bits,
+                                         static_cast<uint64_t>(epoch)))};
+}
+
+}  // namespace
 
 ShuffleDatasetOpBase::ShuffleDatasetOpBase(OpKernelConstruction* ctx)
     : UnaryDatasetOpKernel(ctx) {}
@@ -99,6 +124,8 @@ class ShuffleDatasetOpBase::ShuffleDatasetBase : public DatasetBase {
         buffer_size_(buffer_size),
         seed_generator_(std::move(seed_generator)),
         count_(count),
+        input_cardinality_(ComputeInputCardinality(input)),
+        lazy_global_shuffle_(GetExperiments().contains(kLazyGlobalShuffle)),
         traceme_metadata_(
             {{"buffer_size",
               absl::StrFormat("%lld", static_cast<long long>(buffer_size))}}) {
@@ -140,14 +167,25 @@ class ShuffleDatasetOpBase::ShuffleDatasetBase : public DatasetBase {
   absl::Status Get(OpKernelContext* ctx, int64_t index,
                    std::vector<Tensor>* out_tensors) const override {
     TF_RETURN_IF_ERROR(CheckRandomAccessCompatible(index));
-    {
-      mutex_lock l(mu_);
-      if (shuffled_indices_.empty()) {
-        InitializeRandomAccessIndices();
-      }
-    }
     int64_t shuffled_index;
-    {
+    if (lazy_global_shuffle_) {
+      // The permutation is computed on demand rather than materialized, so
+      // random access uses constant memory regardless of the cardinality. When
+      // the input is repeated, each epoch is a different permutation of the
+      // input.
+      const int64_t epoch = index / input_cardinality_;
+      shuffled_index = static_cast<int64_t>(random::index_shuffle(
+          static_cast<uint64_t>(index % input_cardinality_),
+          IndexShuffleKey(seed_generator_->seed(), seed_generator_->seed2(),
+                          epoch),
+          static_cast<uint64_t>(input_cardinality_ - 1), kIndexShuffleRounds));
+    } else {
+      {
+        mutex_lock l(mu_);
+        if (shuffled_indices_.empty()) {
+          InitializeRandomAccessIndices();
+        }
+      }
       tf_shared_lock l(mu_);
       shuffled_index = shuffled_indices_[index];
     }
@@ -164,6 +202,12 @@ class ShuffleDatasetOpBase::ShuffleDatasetBase : public DatasetBase {
 
   std::unique_ptr<IteratorBase> MakeIteratorInternal(
       const std::string& prefix) const override {
+    if (UseLazyGlobalShuffle()) {
+      return std::make_unique<GlobalShuffleIterator>(
+          GlobalShuffleIterator::Params{
+              this, name_utils::IteratorPrefix(op_type(), prefix)},
+          seed_generator_.get());
+    }
     return std::make_unique<Iterator>(
         Iterator::Params{this, name_utils::IteratorPrefix(op_type(), prefix)},
         seed_generator_.get());
@@ -187,7 +231,184 @@ class ShuffleDatasetOpBase::ShuffleDatasetBase : public DatasetBase {
     }
   }
 
+  // Returns true if iterators should shuffle the input by permuting its
+  // indices instead of buffering its elements. This requires the
+  // "lazy_global_shuffle" experiment, an input which supports random access,
+  // and a buffer covering the whole input, in which case both approaches
+  // produce a uniformly random permutation of each epoch.
+  bool UseLazyGlobalShuffle() const {
+    if (!lazy_global_shuffle_ || !input_->RandomIndexingCompatible().ok()) {
+      return false;
+    }
+    if (input_cardinality_ <= 0) {
+      return false;
+    }
+    return buffer_size_ == kUnknownCardinality ||
+           buffer_size_ >= input_cardinality_;
+  }
+
  protected:
+  static int64_t ComputeInputCardinality(const DatasetBase* input) {
+    CardinalityOptions options;
+    options.set_compute_level(
+        CardinalityOptions::CARDINALITY_COMPUTE_MODERATE);
+    return input->Cardinality(options);
+  }
+
+  // Iterator which produces a random permutation of each epoch of the input
+  // without buffering its elements. The permutation is computed lazily by
+  // `random::index_shuffle` and applied through the index mapper of the input
+  // iterator, so memory use does not depend on the cardinality of the input.
+  class GlobalShuffleIterator : public DatasetIterator<ShuffleDatasetBase> {
+   public:
+    GlobalShuffleIterator(const Params& params, SeedGenerator* seed_generator)
+        : DatasetIterator<ShuffleDatasetBase>(params),
+          seed_generator_(seed_generator) {}
+
+    bool SymbolicCheckpointCompatible() const override { return true; }
+
+    absl::Status Initialize(IteratorContext* ctx) override {
+      mutex_lock l(mu_);
+      seed_generator_->GenerateSeeds(&seed_, &seed2_);
+      return absl::OkStatus();
+    }
+
+    absl::Status GetNextInternal(IteratorContext* ctx,
+                                 std::vector<Tensor>* out_tensors,
+                                 bool* end_of_sequence) override {
+      mutex_lock l(mu_);
+      while (true) {
+        if (!input_impl_) {
+          if (dataset()->count_ != -1 && epoch_ >= dataset()->count_) {
+            *end_of_sequence = true;
+            return absl::OkStatus();
+          }
+          TF_RETURN_IF_ERROR(PrepareNextEpoch(ctx));
+        }
+        IteratorContext::Params params(ctx);
+        params.index_mapper = GetIndexMapper(ctx->index_mapper());
+        IteratorContext shuffle_ctx(params);
+        TF_RETURN_IF_ERROR(
+            input_impl_->GetNext(&shuffle_ctx, out_tensors, end_of_sequence));
+        ctx->MergeCheckpoint(shuffle_ctx.checkpoint());
+        if (!*end_of_sequence) {
+          ++element_count_;
+          return absl::OkStatus();
+        }
+        input_impl_.reset();
+        if (element_count_ == 0) {
+          // The input is empty, so repeating it would loop forever.
+          return absl::OkStatus();
+        }
+      }
+    }
+
+    IndexMapperFn GetIndexMapper(IndexMapperFn parent_index_mapper) const
+        override TF_EXCLUSIVE_LOCKS_REQUIRED(mu_) {
+      const std::array<uint32_t, 3> key = IndexShuffleKey(seed_, seed2_);
+      const uint64_t max_index =
+          static_cast<uint64_t>(dataset()->input_cardinality_ - 1);
+      return [parent_index_mapper, key,
+              max_index](size_t element_position) -> absl::StatusOr<size_t> {
+        if (parent_index_mapper != nullptr) {
+          TF_ASSIGN_OR_RETURN(element_position,
+                              parent_index_mapper(element_position));
+        }
+        if (element_position > max_index) {
+          return absl::OutOfRangeError("Out of range");
+        }
+        return static_cast<size_t>(random::index_shuffle(
+            static_cast<uint64_t>(element_position), key, max_index,
+            kIndexShuffleRounds));
+      };
+    }
+
+   protected:
+    std::shared_ptr<model::Node> CreateNode(
+        IteratorContext* ctx, model::Node::Args args) const override {
+      return model::MakeKnownRatioNode(std::move(args),
+                                       /*ratio=*/1);
+    }
+
+    absl::Status SaveInternal(SerializationContext* ctx,
+                              IteratorStateWriter* writer) override {
+      mutex_lock l(mu_);
+      TF_RETURN_IF_ERROR(
+          writer->WriteScalar(prefix(), kEpochNumRandomSamples,
+                              seed_generator_->num_random_samples()));
+      TF_RETURN_IF_ERROR(writer->WriteScalar(prefix(), kSeed, seed_));
+      TF_RETURN_IF_ERROR(writer->WriteScalar(prefix(), kSeed2, seed2_));
+      TF_RETURN_IF_ERROR(writer->WriteScalar(prefix(), kEpoch, epoch_));
+      TF_RETURN_IF_ERROR(
+          writer->WriteScalar(prefix(), kElementCount, element_count_));
+      TF_RETURN_IF_ERROR(writer->WriteScalar(
+          prefix(), kEndOfInputSequence, static_cast<int64_t>(!input_impl_)));
+      if (input_impl_) {
+        TF_RETURN_IF_ERROR(SaveInput(ctx, writer, input_impl_));
+      }
+      return absl::OkStatus();
+    }
+
+    absl::Status RestoreInternal(IteratorContext* ctx,
+                                 IteratorStateReader* reader) override {
+      mutex_lock l(mu_);
+      int64_t num_random_samples;
+      TF_RETURN_IF_ERROR(reader->ReadScalar(prefix(), kEpochNumRandomSamples,
+                                            &num_random_samples));
+      seed_generator_->set_num_random_samples(num_random_samples);
+      seed_generator_->Reset();
+      TF_RETURN_IF_ERROR(reader->ReadScalar(prefix(), kSeed, &seed_));
+      TF_RETURN_IF_ERROR(reader->ReadScalar(prefix(), kSeed2, &seed2_));
+      TF_RETURN_IF_ERROR(reader->ReadScalar(prefix(), kEpoch, &epoch_));
+      TF_RETURN_IF_ERROR(
+          reader->ReadScalar(prefix(), kElementCount, &element_count_));
+      int64_t input_empty;
+      TF_RETURN_IF_ERROR(
+          reader->ReadScalar(prefix(), kEndOfInputSequence, &input_empty));
+      if (static_cast<bool>(input_empty)) {
+        input_impl_.reset();
+        return absl::OkStatus();
+      }
+      IteratorContext::Params params(ctx);
+      params.restored_element_count = element_count_;
+      params.index_mapper = GetIndexMapper(ctx->index_mapper());
+      IteratorContext restore_ctx(params);
+      TF_RETURN_IF_ERROR(dataset()->input_->MakeIterator(
+          &restore_ctx, this, prefix(), &input_impl_));
+      TF_RETURN_IF_ERROR(RestoreInput(&restore_ctx, reader, input_impl_));
+      ctx->MergeCheckpoint(restore_ctx.checkpoint());
+      return absl::OkStatus();
+    }
+
+    TraceMeMetadata GetTraceMeMetadata() const override {
+      return dataset()->traceme_metadata_;
+    }
+
+   private:
+    absl::Status PrepareNextEpoch(IteratorContext* ctx)
+        TF_EXCLUSIVE_LOCKS_REQUIRED(mu_) {
+      if (epoch_ > 0) {
+        // The first epoch uses the seeds generated by `Initialize`.
+        seed_generator_->GenerateSeeds(&seed_, &seed2_);
+      }
+      element_count_ = 0;
+      TF_RETURN_IF_ERROR(dataset()->input_->MakeIterator(
+          ctx, this, prefix(), &input_impl_));
+      ++epoch_;
+      return absl::OkStatus();
+    }
+
+    mutex mu_;
+    SeedGenerator* const seed_generator_ TF_GUARDED_BY(mu_);  // Not owned.
+    std::unique_ptr<IteratorBase> input_impl_ TF_GUARDED_BY(mu_);
+    int64_t seed_ TF_GUARDED_BY(mu_) = 0;
+    int64_t seed2_ TF_GUARDED_BY(mu_) = 0;
+    // Number of epochs started so far.
+    int64_t epoch_ TF_GUARDED_BY(mu_) = 0;
+    // Number of elements produced in the current epoch.
+    int64_t element_count_ TF_GUARDED_BY(mu_) = 0;
+  };
+
   class Iterator : public DatasetIterator<ShuffleDatasetBase> {
    public:
     explicit Iterator(const Params& params, SeedGenerator* seed_generator)
@@ -603,6 +824,11 @@ class ShuffleDatasetOpBase::ShuffleDatasetBase : public DatasetBase {
   // fuse shuffle and repeat together, and make the shuffle dataset op
   // responsible for repeating as well.
   const int64_t count_;
+  // Cardinality of `input_`, computed once since random access needs it for
+  // every element.
+  const int64_t input_cardinality_;
+  // Whether the "lazy_global_shuffle" experiment is enabled.
+  const bool lazy_global_shuffle_;
   const TraceMeMetadata traceme_metadata_;
   mutable mutex mu_;
   mutable std::vector<std::int64_t> shuffled_indices_ TF_GUARDED_BY(mu_);
@@ -11,9 +11,12 @@ limitations under the License.
 ==============================================================================*/
 #include "tensorflow/core/kernels/data/shuffle_dataset_op.h"
 
+#include <cstdint>
 #include <string>
 #include <utility>
+#include <vector>
 
+#include "absl/status/statusor.h"
 #include "tensorflow/core/data/dataset_test_base.h"
 #include "tensorflow/core/data/dataset_utils.h"
 #include "tensorflow/core/data/serialization_utils.h"
@@ -584,6 +587,134 @@ INSTANTIATE_TEST_CASE_P(ShuffleDatasetOpTest,
                         ParameterizedIteratorSaveAndRestoreTest,
                         ::testing::ValuesIn(IteratorSaveAndRestoreTestCases()));
 
+// Runs the iterator with the "lazy_global_shuffle" experiment, which permutes
+// the indices of the input instead of buffering its elements.
+class LazyGlobalShuffleTest
+    : public ShuffleDatasetOpTest,
+      public ::testing::WithParamInterface<ShuffleDatasetParams> {
+ protected:
+  void SetUp() override {
+    setenv("TF_JOB_NAME", "test_job", /*overwrite=*/1);
+    setenv("TF_TASK_ID", "0", /*overwrite=*/1);
+    setenv("TF_DATA_EXPERIMENT_OPT_IN", "lazy_global_shuffle",
+           /*overwrite=*/1);
+  }
+
+  void TearDown() override {
+    unsetenv("TF_JOB_NAME");
+    unsetenv("TF_TASK_ID");
+    unsetenv("TF_DATA_EXPERIMENT_OPT_IN");
+  }
+
+  // Reads all elements from `iterator_`.
+  absl::StatusOr<std::vector<Tensor>> GetAllElements() {
+    std::vector<Tensor> out_tensors;
+    bool end_of_sequence = false;
+    while (!end_of_sequence) {
+      std::vector<Tensor> next;
+      TF_RETURN_IF_ERROR(
+          iterator_->GetNext(iterator_ctx_.get(), &next, &end_of_sequence));
+      out_tensors.insert(out_tensors.end(), next.begin(), next.end());
+    }
+    return out_tensors;
+  }
+};
+
+ShuffleDatasetParams LazyGlobalShuffleDatasetParams() {
+  return ShuffleDatasetParams(RangeDatasetParams(0, 10, 1),
+                              /*buffer_size=*/10,
+                              /*seed=*/1,
+                              /*seed2=*/2,
+                              /*count=*/1,
+                              /*reshuffle_each_iteration=*/false,
+                              /*output_dtypes=*/{DT_INT64},
+                              /*output_shapes=*/{PartialTensorShape({})},
+                              /*node_name=*/kShuffleNodeName);
+}
+
+ShuffleDatasetParams LazyGlobalShuffleAndRepeatDatasetParams() {
+  return ShuffleDatasetParams(RangeDatasetParams(0, 10, 1),
+                              /*buffer_size=*/kUnknownCardinality,
+                              /*seed=*/1,
+                              /*seed2=*/2,
+                              /*count=*/2,
+                              /*reshuffle_each_iteration=*/false,
+                              /*output_dtypes=*/{DT_INT64},
+                              /*output_shapes=*/{PartialTensorShape({})},
+                              /*node_name=*/kShuffleAndRepeatNodeName);
+}
+
+TEST_P(LazyGlobalShuffleTest, EachEpochIsAPermutation) {
+  auto dataset_params = GetParam();
+  TF_ASSERT_OK(Initialize(dataset_params));
+  TF_ASSERT_OK_AND_ASSIGN(std::vector<Tensor> out_tensors, GetAllElements());
+  ASSERT_EQ(out_tensors.size(),
+            static_cast<size_t>(10 * dataset_params.count()));
+
+  std::vector<Tensor> range =
+      CreateTensors<int64_t>(TensorShape({}), {{0}, {1}, {2}, {3}, {4}, {5},
+                                               {6}, {7}, {8}, {9}});
+  for (int64_t epoch = 0; epoch < dataset_params.count(); ++epoch) {
+    std::vector<Tensor> epoch_tensors(out_tensors.begin() + 10 * epoch,
+                                      out_tensors.begin() + 10 * (epoch + 1));
+    TF_EXPECT_OK(ExpectEqual(epoch_tensors, range, /*compare_order=*/false));
+  }
+}
+
+TEST_P(LazyGlobalShuffleTest, SaveAndRestore) {
+  auto dataset_params = GetParam();
+  TF_ASSERT_OK(Initialize(dataset_params));
+  // The seeds are fixed, so every iterator produces the same sequence.
+  TF_ASSERT_OK_AND_ASSIGN(std::vector<Tensor> expected_outputs,
+                          GetAllElements());
+  TF_ASSERT_OK(CheckIteratorSaveAndRestore(dataset_params.iterator_prefix(),
+                                           expected_outputs,
+                                           /*breakpoints=*/{0, 4, 11, 25},
+                                           /*compare_order=*/true));
+}
+
+TEST_P(LazyGlobalShuffleTest, RandomAccessIsAPermutation) {
+  auto dataset_params = GetParam();
+  TF_ASSERT_OK(Initialize(dataset_params));
+  std::vector<Tensor> out_tensors;
+  for (int64_t i = 0; i < 10 * dataset_params.count(); ++i) {
+    std::vector<Tensor> element;
+    TF_ASSERT_OK(dataset_->Get(dataset_ctx_.get(), i, &element));
+    out_tensors.insert(out_tensors.end(), element.begin(), element.end());
+  }
+  std::vector<Tensor> range =
+      CreateTensors<int64_t>(TensorShape({}), {{0}, {1}, {2}, {3}, {4}, {5},
+                                               {6}, {7}, {8}, {9}});
+  for (int64_t epoch = 0; epoch < dataset_params.count(); ++epoch) {
+    std::vector<Tensor> epoch_tensors(out_tensors.begin() + 10 * epoch,
+                                      out_tensors.begin() + 10 * (epoch + 1));
+    TF_EXPECT_OK(ExpectEqual(epoch_tensors, range, /*compare_order=*/false));
+  }
+}
+
+TEST_P(LazyGlobalShuffleTest, RandomAccessPermutesEachEpochDifferently) {
+  auto dataset_params = GetParam();
+  if (dataset_params.count() < 2) {
+    GTEST_SKIP() << "The input is not repeated.";
+  }
+  TF_ASSERT_OK(Initialize(dataset_params));
+  std::vector<std::vector<Tensor>> epochs(2);
+  for (int64_t i = 0; i < 20; ++i) {
+    std::vector<Tensor> element;
+    TF_ASSERT_OK(dataset_->Get(dataset_ctx_.get(), i, &element));
+    epochs[i / 10].insert(epochs[i / 10].end(), element.begin(),
+                          element.end());
+  }
+  TF_EXPECT_OK(ExpectEqual(epochs[0], epochs[1], /*compare_order=*/false));
+  EXPECT_FALSE(
+      ExpectEqual(epochs[0], epochs[1], /*compare_order=*/true).ok());
+}
+
+INSTANTIATE_TEST_SUITE_P(
+    ShuffleDatasetOpTest, LazyGlobalShuffleTest,
+    ::testing::Values(LazyGlobalShuffleDatasetParams(),
+                      LazyGlobalShuffleAndRepeatDatasetParams()));
+
 TEST_F(ShuffleDatasetOpTest, InvalidArguments) {
   std::vector<ShuffleDatasetParams> dataset_params_vec(
       {ShuffleDatasetParamsWithInvalidBufferSize(),
@@ -15,16 +15,34 @@ limitations under the License.
 
 // Tests kernels of lookup ops.
 
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "absl/status/status.h"
+#include "absl/strings/match.h"
+#include "tensorflow/core/common_runtime/device.h"
+#include "tensorflow/core/common_runtime/device_factory.h"
+#include "tensorflow/core/framework/allocator.h"
 #include "tensorflow/core/framework/fake_input.h"
 #include "tensorflow/core/framework/lookup_interface.h"
 #include "tensorflow/core/framework/node_def_builder.h"
 #include "tensorflow/core/framework/op.h"
+#include "tensorflow/core/framework/op_kernel.h"
+#include "tensorflow/core/framework/resource_mgr.h"
 #include "tensorflow/core/framework/shape_inference_testutil.h"
+#include "tensorflow/core/framework/tensor_testutil.h"
 #include "tensorflow/core/framework/types.h"
 #include "tensorflow/core/kernels/lookup_table_op.h"
 #include "tensorflow/core/kernels/ops_testutil.h"
 #include "tensorflow/core/lib/core/status_test_util.h"
+#include "tensorflow/core/lib/core/threadpool.h"
+#include "tensorflow/core/platform/blocking_counter.h"
+#include "tensorflow/core/platform/env.h"
 #include "tensorflow/core/platform/test.h"
+#include "tensorflow/core/platform/test_benchmark.h"
+#include "tensorflow/core/public/version.h"
 
 namespace tensorflow {
 namespace {
@@ -100,5 +118,216 @@ TEST_F(LookupOpsTest, AnonymousHashTable_RefCounting) {
   EXPECT_FALSE(alive);
 }
 
+TEST_F(LookupOpsTest, MutableHashTableV2_NumShardsSelectsShardedTable) {
+  TF_ASSERT_OK(NodeDefBuilder("table", "MutableHashTableV2")
+                   .Attr("key_dtype", DT_INT64)
+                   .Attr("value_dtype", DT_FLOAT)
+                   .Attr("num_shards", 3)
+                   .Finalize(node_def()));
+  TF_ASSERT_OK(InitOp());
+  TF_ASSERT_OK(RunOpKernel());
+
+  lookup::LookupInterface* table = nullptr;
+  TF_ASSERT_OK(LookupResource(context_.get(),
+                              GetOutput(0)->scalar<ResourceHandle>()(),
+                              &table));
+  core::ScopedUnref unref(table);
+  auto* sharded =
+      dynamic_cast<lookup::ShardedMutableHashTable<int64_t, float>*>(table);
+  ASSERT_NE(sharded, nullptr);
+  EXPECT_EQ(sharded->num_shards(), 4);
+}
+
+TEST_F(LookupOpsTest, MutableHashTableV2_RejectsOutOfRangeNumShards) {
+  TF_ASSERT_OK(NodeDefBuilder("table", "MutableHashTableV2")
+                   .Attr("key_dtype", DT_INT64)
+                   .Attr("value_dtype", DT_FLOAT)
+                   .Attr("num_shards", lookup::kMaxHashTableShards + 1)
+                   .Finalize(node_def()));
+  TF_ASSERT_OK(InitOp());
+  absl::Status status = RunOpKernel();
+  EXPECT_EQ(status.code(), absl::StatusCode::kInvalidArgument);
+  EXPECT_TRUE(absl::StrContains(status.message(), "num_shards")) << status;
+}
+
+using ScalarTable = lookup::ShardedMutableHashTable<int64_t, float>;
+
+TEST(ShardedMutableHashTableTest, InsertFindRemove) {
+  core::RefCountPtr<ScalarTable> table(new ScalarTable(4, TensorShape()));
+  constexpr int64_t kNumKeys = 1000;
+  Tensor keys(DT_INT64, TensorShape({kNumKeys}));
+  Tensor values(DT_FLOAT, TensorShape({kNumKeys}));
+  for (int64_t i = 0; i < kNumKeys; ++i) {
+    keys.flat<int64_t>()(i) = i * 7919;
+    values.flat<float>()(i) = i;
+  }
+  TF_ASSERT_OK(table->Insert(nullptr, keys, values));
+  EXPECT_EQ(table->size(), kNumKeys);
+
+  Tensor found(DT_FLOAT, TensorShape({kNumKeys}));
+  TF_ASSERT_OK(
+      table->Find(nullptr, keys, &found, test::AsScalar<float>(-1.0f)));
+  test::ExpectTensorEqual<float>(found, values);
+
+  // Overwrite one key and remove the first half of them.
+  TF_ASSERT_OK(table->Insert(nullptr, test::AsTensor<int64_t>({7919}),
+                             test::AsTensor<float>({42.0f})));
+  Tensor removed(DT_INT64, TensorShape({kNumKeys / 2}));
+  for (int64_t i = 0; i < kNumKeys / 2; ++i) {
+    removed.flat<int64_t>()(i) = i * 7919;
+  }
+  TF_ASSERT_OK(table->Remove(nullptr, removed));
+  EXPECT_EQ(table->size(), kNumKeys / 2);
+
+  Tensor probe = test::AsTensor<int64_t>({7919, 600 * 7919, 1});
+  Tensor probe_out(DT_FLOAT, TensorShape({3}));
+  TF_ASSERT_OK(table->Find(nullptr, probe, &probe_out,
+                           test::AsTensor<float>({-1.0f, -2.0f, -3.0f})));
+  test::ExpectTensorEqual<float>(probe_out,
+                                 test::AsTensor<float>({-1.0f, 600.0f, -3.0f}));
+}
+
+TEST(ShardedMutableHashTableTest, TensorValuesAndImport) {
+  core::RefCountPtr<lookup::ShardedMutableHashTable<tstring, int32_t>> table(
+      new lookup::ShardedMutableHashTable<tstring, int32_t>(2,
+                                                            TensorShape({2})));
+  TF_ASSERT_OK(table->Insert(
+      nullptr, test::AsTensor<tstring>({"a", "b"}),
+      test::AsTensor<int32_t>({1, 2, 3, 4}, TensorShape({2, 2}))));
+  TF_ASSERT_OK(table->ImportValues(
+      nullptr, test::AsTensor<tstring>({"b", "c"}),
+      test::AsTensor<int32_t>({5, 6, 7, 8}, TensorShape({2, 2}))));
+  EXPECT_EQ(table->size(), 2);
+
+  Tensor found(DT_INT32, TensorShape({3, 2}));
+  TF_ASSERT_OK(table->Find(nullptr, test::AsTensor<tstring>({"a", "b", "c"}),
+                           &found, test::AsTensor<int32_t>({0, -1})));
+  test::ExpectTensorEqual<int32_t>(
+      found, test::AsTensor<int32_t>({0, -1, 5, 6, 7, 8}, TensorShape({3, 2})));
+}
+
+TEST(ShardedMutableHashTableTest, ConcurrentFindAndInsert) {
+  core::RefCountPtr<ScalarTable> table(new ScalarTable(8, TensorShape()));
+  constexpr int kNumThreads = 8;
+  constexpr int64_t kKeysPerThread = 2000;
+  {
+    thread::ThreadPool pool(Env::Default(), "sharded_table_test",
+                            kNumThreads);
+    for (int t = 0; t < kNumThreads; ++t) {
+      pool.Schedule([&table, t]() {
+        for (int64_t i = 0; i < kKeysPerThread; ++i) {
+          const int64_t key = t * kKeysPerThread + i;
+          TF_CHECK_OK(table->Insert(nullptr, test::AsTensor<int64_t>({key}),
+                                    test::AsTensor<float>({1.0f * key})));
+          Tensor out(DT_FLOAT, TensorShape({1}));
+          TF_CHECK_OK(table->Find(nullptr, test::AsTensor<int64_t>({key}),
+                                  &out, test::AsScalar<float>(-1.0f)));
+          CHECK_EQ(out.flat<float>()(0), 1.0f * key);
+        }
+      });
+    }
+  }
+  EXPECT_EQ(table->size(), kNumThreads * kKeysPerThread);
+}
+
+// Creates a MutableHashTableV2 resource by running its op kernel directly, so
+// that the benchmark can compare against the unsharded
+// MutableHashTableOfScalars, which is only reachable through
+// LookupTableFactory.
+core::RefCountPtr<lookup::LookupInterface> MakeMutableHashTable(
+    int num_shards) {
+  std::unique_ptr<Device> device(
+      DeviceFactory::NewDevice("CPU", {}, "/job:a/replica:0/task:0"));
+
+  NodeDef table_node_def;
+  TF_CHECK_OK(NodeDefBuilder("table", "MutableHashTableV2")
+                  .Attr("key_dtype", DT_INT64)
+                  .Attr("value_dtype", DT_FLOAT)
+                  .Attr("num_shards", num_shards)
+                  .Finalize(&table_node_def));
+  absl::Status status;
+  std::unique_ptr<OpKernel> table_op(
+      CreateOpKernel(DEVICE_CPU, device.get(), cpu_allocator(),
+                     table_node_def, TF_GRAPH_DEF_VERSION, &status));
+  TF_CHECK_OK(status);
+
+  OpKernelContext::Params params;
+  params.device = device.get();
+  params.resource_manager = device->resource_manager();
+  params.op_kernel = table_op.get();
+  std::vector<AllocatorAttributes> attrs;
+  test::SetOutputAttrs(&params, &attrs);
+  OpKernelContext table_context(&params);
+  table_op->Compute(&table_context);
+  TF_CHECK_OK(table_context.status());
+
+  // The returned reference keeps the table alive once the device and its
+  // resource manager are gone.
+  lookup::LookupInterface* table = nullptr;
+  TF_CHECK_OK(LookupResource(
+      &table_context,
+      table_context.mutable_output(0)->scalar<ResourceHandle>()(), &table));
+  return core::RefCountPtr<lookup::LookupInterface>(table);
+}
+
+// Measures lookup throughput of a table shared by `num_threads` threads, each
+// of which does one insert batch for every 16 lookup batches. Zero shards is
+// the existing MutableHashTableOfScalars behind a single table-wide lock; one
+// shard is the open-addressing table behind a single lock.
+void BM_ShardedMutableHashTableMixed(::testing::benchmark::State& state) {
+  const int num_threads = state.range(0);
+  const int num_shards = state.range(1);
+  constexpr int64_t kNumKeys = 1 << 20;
+  constexpr int64_t kBatchSize = 64;
+  constexpr int kBatchesPerThread = 512;
+
+  core::RefCountPtr<lookup::LookupInterface> table =
+      MakeMutableHashTable(num_shards);
+  {
+    Tensor keys(DT_INT64, TensorShape({kNumKeys}));
+    Tensor values(DT_FLOAT, TensorShape({kNumKeys}));
+    for (int64_t i = 0; i < kNumKeys; ++i) {
+      keys.flat<int64_t>()(i) = i;
+      values.flat<float>()(i) = i;
+    }
+    TF_CHECK_OK(table->Insert(nullptr, keys, values));
+  }
+  const Tensor default_value = test::AsScalar<float>(0.0f);
+
+  thread::ThreadPool pool(Env::Default(), "bm_sharded_table", num_threads);
+  std::atomic<uint64_t> seed(1);
+  for (auto s : state) {
+    BlockingCounter done(num_threads);
+    for (int t = 0; t < num_threads; ++t) {
+      pool.Schedule([&]() {
+        uint64_t x = seed.fetch_add(1) * 0x9e3779b97f4a7c15ULL;
+        Tensor keys(DT_INT64, TensorShape({kBatchSize}));
+        Tensor values(DT_FLOAT, TensorShape({kBatchSize}));
+        for (int b = 0; b < kBatchesPerThread; ++b) {
+          for (int64_t i = 0; i < kBatchSize; ++i) {
+            x ^= x << 13;
+            x ^= x >> 7;
+            x ^= x << 17;
+            keys.flat<int64_t>()(i) = x % kNumKeys;
+          }
+          if (b % 16 == 0) {
+            TF_CHECK_OK(table->Insert(nullptr, keys, values));
+          } else {
+            TF_CHECK_OK(table->Find(nullptr, keys, &values, default_value));
+          }
+        }
+        done.DecrementCount();
+      });
+    }
+    done.Wait();
+  }
+  state.SetItemsProcessed(static_cast<int64_t>(state.iterations()) *
+                          num_threads * kBatchesPerThread * kBatchSize);
+}
+
+BENCHMARK(BM_ShardedMutableHashTableMixed)
+    ->UseRealTime()
+    ->ArgsProduct({{1, 4, 16, 32}, {0, 1, 64}});
+
 }  // namespace
 }  // namespace tensorflow
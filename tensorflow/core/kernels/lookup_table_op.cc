@@ -15,11 +15,14 @@ limitations under the License.
 
 #include "tensorflow/core/kernels/lookup_table_op.h"
 #define EIGEN_USE_THREADS
+#include <algorithm>
+#include <cstdint>
 #include <string>
 #include <type_traits>
 #include <utility>
 
 #include "absl/status/status.h"
+#include "absl/status/statusor.h"
 #include "absl/strings/str_cat.h"
 #include "tensorflow/core/framework/register_types.h"
 #include "tensorflow/core/framework/types.h"
@@ -27,6 +30,7 @@ limitations under the License.
 #include "tensorflow/core/kernels/initializable_lookup_table.h"
 #include "tensorflow/core/lib/gtl/inlined_vector.h"
 #include "tensorflow/core/lib/hash/hash.h"
+#include "tensorflow/core/platform/cpu_info.h"
 #include "tensorflow/core/platform/random.h"
 
 namespace tensorflow {
@@ -1128,6 +1132,77 @@ REGISTER_KERNEL(tstring, tstring);
 
 #undef REGISTER_KERNEL
 
+namespace {
+
+// Returns the number of shards requested by the `num_shards` attr of `kernel`,
+// or 0 if the attr is absent or zero. -1 requests one shard per schedulable
+// CPU. Other values outside [1, kMaxHashTableShards] are rejected.
+absl::StatusOr<int64_t> NumShardsAttr(OpKernel* kernel) {
+  int64_t num_shards = 0;
+  if (!TryGetNodeAttr(kernel->def(), "num_shards", &num_shards)) return 0;
+  if (num_shards == -1) {
+    return std::min<int64_t>(port::MaxParallelism(),
+                            lookup::kMaxHashTableShards);
+  }
+  if (num_shards < -1 || num_shards > lookup::kMaxHashTableShards) {
+    return absl::InvalidArgumentError(
+        absl::StrCat("num_shards must be -1, 0 or in [1, ",
+                     lookup::kMaxHashTableShards, "], got ", num_shards));
+  }
+  return num_shards;
+}
+
+}  // namespace
+
+// MutableHashTableV2 uses the sharded open-addressing table when `num_shards`
+// is set.
+template <class K, class V>
+struct LookupTableFactory<lookup::MutableHashTableOfScalars<K, V>> {
+  static lookup::LookupInterface* Create(OpKernelContext* ctx,
+                                         OpKernel* kernel) {
+    const absl::StatusOr<int64_t> num_shards = NumShardsAttr(kernel);
+    if (!num_shards.ok()) {
+      // The caller releases the returned table when `ctx` holds an error.
+      ctx->SetStatus(num_shards.status());
+      return new lookup::ShardedMutableHashTable<K, V>(1, TensorShape());
+    }
+    if (*num_shards == 0) {
+      return new lookup::MutableHashTableOfScalars<K, V>(ctx, kernel);
+    }
+    return new lookup::ShardedMutableHashTable<K, V>(*num_shards,
+                                                     TensorShape());
+  }
+};
+
+// MutableHashTableOfTensorsV2 uses the sharded open-addressing table when
+// `num_shards` is set.
+template <class K, class V>
+struct LookupTableFactory<lookup::MutableHashTableOfTensors<K, V>> {
+  static lookup::LookupInterface* Create(OpKernelContext* ctx,
+                                         OpKernel* kernel) {
+    const absl::StatusOr<int64_t> num_shards = NumShardsAttr(kernel);
+    if (num_shards.ok() && *num_shards == 0) {
+      return new lookup::MutableHashTableOfTensors<K, V>(ctx, kernel);
+    }
+    TensorShape value_shape;
+    absl::Status status = num_shards.status();
+    if (status.ok()) {
+      status = GetNodeAttr(kernel->def(), "value_shape", &value_shape);
+    }
+    if (status.ok() && !TensorShapeUtils::IsVector(value_shape)) {
+      status = absl::InvalidArgumentError(
+          absl::StrCat("Default value must be a vector, got shape ",
+                       value_shape.DebugString()));
+    }
+    if (!status.ok()) {
+      // The caller releases the returned table when `ctx` holds an error.
+      ctx->SetStatus(status);
+    }
+    return new lookup::ShardedMutableHashTable<K, V>(
+        status.ok() ? *num_shards : 1, value_shape);
+  }
+};
+
 // Register the MutableHashTable op.
 #define REGISTER_KERNEL(key_dtype, value_dtype)                                \
   REGISTER_KERNEL_BUILDER(                                                     \
@@ -16,7 +16,13 @@ limitations under the License.
 #ifndef TENSORFLOW_CORE_KERNELS_LOOKUP_TABLE_OP_H_
 #define TENSORFLOW_CORE_KERNELS_LOOKUP_TABLE_OP_H_
 
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
 #include "absl/container/flat_hash_map.h"
+#include "absl/numeric/bits.h"
 #include "tensorflow/core/framework/bounds_check.h"
 #include "tensorflow/core/framework/lookup_interface.h"
 #include "tensorflow/core/framework/op_kernel.h"
@@ -28,12 +34,25 @@ limitations under the License.
 #include "tensorflow/core/lib/core/errors.h"
 #include "tensorflow/core/lib/core/status.h"
 #include "tensorflow/core/lib/gtl/map_util.h"
+#include "tensorflow/core/lib/hash/hash.h"
 #include "tensorflow/core/platform/errors.h"
 #include "tensorflow/core/platform/macros.h"
+#include "tensorflow/core/platform/mutex.h"
 #include "tensorflow/core/platform/thread_annotations.h"
 
 namespace tensorflow {
 
+// Creates the table resource for LookupTableOp and AnonymousLookupTableOp.
+// The default creates a `Container`; specialize it to pick the table
+// implementation from the node's attrs at kernel run time.
+template <class Container>
+struct LookupTableFactory {
+  static lookup::LookupInterface* Create(OpKernelContext* ctx,
+                                         OpKernel* kernel) {
+    return new Container(ctx, kernel);
+  }
+};
+
 // Lookup table op that supports different table implementations specified by
 // the 'Container' template. Container must be derived from LookupInterface. The
 // key and value are of the templated type "key_dtype" and "value_dtype"
@@ -69,7 +88,8 @@ class LookupTableOp : public OpKernel {
     auto creator =
         [ctx, this](lookup::LookupInterface** ret)
             TF_EXCLUSIVE_LOCKS_REQUIRED(mu_) {
-              lookup::LookupInterface* container = new Container(ctx, this);
+              lookup::LookupInterface* container =
+                  LookupTableFactory<Container>::Create(ctx, this);
               if (!ctx->status().ok()) {
                 container->Unref();
                 return ctx->status();
@@ -145,7 +165,8 @@ class AnonymousLookupTableOp : public OpKernel {
   explicit AnonymousLookupTableOp(OpKernelConstruction* ctx) : OpKernel(ctx) {}
 
   void Compute(OpKernelContext* ctx) override {
-    lookup::LookupInterface* table = new Container(ctx, this);
+    lookup::LookupInterface* table =
+        LookupTableFactory<Container>::Create(ctx, this);
     if (!ctx->status().ok()) {
       table->Unref();
       return;
@@ -345,6 +366,443 @@ class HashTable : public InitializableLookupTable {
   absl::flat_hash_map<K, V> table_;
 };
 
+// Upper bound on the number of shards of a ShardedMutableHashTable. The shard
+// index is taken from the top bits of the hash, which must stay clear of the
+// bits used for the control byte fragment.
+inline constexpr int64_t kMaxHashTableShards = 4096;
+
+// Mutable hash table that splits its keys over a power-of-two number of
+// shards, each an open-addressing table with linear probing guarded by its own
+// reader/writer lock. Lookups only take shared locks, and a batch of keys is
+// grouped by shard so that every shard is locked at most once per call. This
+// keeps readers from contending with writers that touch other shards, which
+// is the common case for large embedding tables updated online.
+//
+// Each shard stores a one-byte control word per slot (empty, deleted, or a
+// 7-bit fragment of the hash of a present key) in its own array, so probing
+// scans a dense byte array and only compares full keys on a fragment match.
+// Keys and values live in separate flat arrays; values of a slot are stored
+// contiguously, `value_shape.num_elements()` of them per slot.
+//
+// Used by MutableHashTableV2 and MutableHashTableOfTensorsV2 when their
+// `num_shards` attr is non-zero.
+template <class K, class V>
+class ShardedMutableHashTable final : public LookupInterface {
+ public:
+  // `num_shards` must be in [1, kMaxHashTableShards] and is rounded up to a
+  // power of two. `value_shape` is empty for scalar values, or a vector shape
+  // for MutableHashTableOfTensors.
+  ShardedMutableHashTable(int64_t num_shards, const TensorShape& value_shape)
+      : value_shape_(value_shape),
+        value_dim_(value_shape.num_elements()),
+        num_shards_(absl::bit_ceil(static_cast<uint64_t>(
+            std::clamp<int64_t>(num_shards, 1, kMaxHashTableShards)))),
+        shard_bits_(absl::countr_zero(num_shards_)),
+        shards_(new Shard[num_shards_]) {
+    DCHECK(num_shards >= 1 && num_shards <= kMaxHashTableShards) << num_shards;
+  }
+
+  size_t size() const override {
+    size_t ret = 0;
+    for (uint64_t s = 0; s < num_shards_; ++s) {
+      tf_shared_lock l(shards_[s].mu);
+      ret += shards_[s].num_full;
+    }
+    return ret;
+  }
+
+  absl::Status Find(OpKernelContext* ctx, const Tensor& key, Tensor* value,
+                    const Tensor& default_value) override {
+    const auto key_values = key.flat<K>();
+    auto value_values = value->flat<V>();
+    const auto default_flat = default_value.flat<V>();
+
+    // is_full_size_default is true:
+    //   Each key has an independent default value, key_values(i)
+    //   corresponding uses the i-th default value.
+    //
+    // is_full_size_default is false:
+    //   All keys will share the first default value.
+    const bool is_full_size_default =
+        (value_values.size() == default_flat.size());
+
+    ForEachShard(key_values, [&](const Shard& shard, int64_t i, uint64_t hash)
+                                 TF_NO_THREAD_SAFETY_ANALYSIS {
+      const V* found = shard.Lookup(SubtleMustCopyIfIntegral(key_values(i)),
+                                    hash, value_dim_);
+      V* out = value_values.data() + i * value_dim_;
+      if (found != nullptr) {
+        std::copy_n(found, value_dim_, out);
+      } else {
+        std::copy_n(
+            default_flat.data() + (is_full_size_default ? i * value_dim_ : 0),
+            value_dim_, out);
+      }
+    });
+    return absl::OkStatus();
+  }
+
+  absl::Status Insert(OpKernelContext* ctx, const Tensor& keys,
+                      const Tensor& values) override {
+    return DoInsert(false, keys, values);
+  }
+
+  absl::Status Remove(OpKernelContext* ctx, const Tensor& keys) override {
+    const auto key_values = keys.flat<K>();
+    ForEachShardMutable(key_values, [&](Shard& shard, int64_t i, uint64_t hash)
+                                        TF_NO_THREAD_SAFETY_ANALYSIS {
+      shard.Erase(SubtleMustCopyIfIntegral(key_values(i)), hash, value_dim_);
+    });
+    return absl::OkStatus();
+  }
+
+  absl::Status ImportValues(OpKernelContext* ctx, const Tensor& keys,
+                            const Tensor& values) override {
+    return DoInsert(true, keys, values);
+  }
+
+  absl::Status ExportValues(OpKernelContext* ctx) override {
+    std::vector<std::unique_ptr<tf_shared_lock>> locks = LockAllShared();
+    const int64_t size = SizeLocked();
+
+    TensorShape values_shape({size});
+    values_shape.AppendShape(value_shape_);
+    Tensor* keys;
+    Tensor* values;
+    TF_RETURN_IF_ERROR(
+        ctx->allocate_output("keys", TensorShape({size}), &keys));
+    TF_RETURN_IF_ERROR(ctx->allocate_output("values", values_shape, &values));
+    ExportKeysAndValues(keys, values);
+    return absl::OkStatus();
+  }
+
+  DataType key_dtype() const override { return DataTypeToEnum<K>::v(); }
+
+  DataType value_dtype() const override { return DataTypeToEnum<V>::v(); }
+
+  TensorShape key_shape() const final { return TensorShape(); }
+
+  TensorShape value_shape() const override { return value_shape_; }
+
+  int64_t MemoryUsed() const override {
+    int64_t ret = sizeof(ShardedMutableHashTable) + num_shards_ * sizeof(Shard);
+    for (uint64_t s = 0; s < num_shards_; ++s) {
+      tf_shared_lock l(shards_[s].mu);
+      ret += shards_[s].capacity *
+             (sizeof(uint8_t) + sizeof(K) + value_dim_ * sizeof(V));
+    }
+    return ret;
+  }
+
+  absl::Status AsGraphDef(GraphDefBuilder* builder, Node** out) const override {
+    std::vector<std::unique_ptr<tf_shared_lock>> locks = LockAllShared();
+    const int64_t size = SizeLocked();
+    TensorShape values_shape({size});
+    values_shape.AppendShape(value_shape_);
+    Tensor keys(key_dtype(), TensorShape({size}));
+    Tensor values(value_dtype(), values_shape);
+    ExportKeysAndValues(&keys, &values);
+
+    // We set use_node_name_sharing with a unique node name so that the resource
+    // can outlive the kernel that created it, as for the unsharded tables.
+    const bool is_scalar = value_shape_.dims() == 0;
+    auto opts = builder->opts()
+                    .WithName(UniqueNodeName(is_scalar
+                                                 ? "MutableHashTableFromGraphDef"
+                                                 : "MutableHashTableOfTensors"))
+                    .WithAttr("use_node_name_sharing", true)
+                    .WithAttr("key_dtype", key_dtype())
+                    .WithAttr("value_dtype", value_dtype())
+                    .WithAttr("num_shards", static_cast<int64_t>(num_shards_));
+    if (!is_scalar) {
+      opts = opts.WithAttr("value_shape", value_shape_);
+    }
+    Node* table = ops::SourceOp(
+        is_scalar ? "MutableHashTableV2" : "MutableHashTableOfTensorsV2", opts);
+    Node* keys_node = ops::SourceOp(
+        "Const",
+        builder->opts().WithAttr("dtype", key_dtype()).WithAttr("value", keys));
+    Node* values_node =
+        ops::SourceOp("Const", builder->opts()
+                                   .WithAttr("dtype", value_dtype())
+                                   .WithAttr("value", values));
+    Node* import_table =
+        ops::TernaryOp("LookupTableImportV2", table, keys_node, values_node,
+                       builder->opts()
+                           .WithAttr("Tin", key_dtype())
+                           .WithAttr("Tout", value_dtype()));
+    *out = ops::UnaryOp("Identity", table,
+                        builder->opts().WithControlInput(import_table));
+    return absl::OkStatus();
+  }
+
+  int64_t num_shards() const { return num_shards_; }
+
+ private:
+  static constexpr uint8_t kEmpty = 0;
+  static constexpr uint8_t kDeleted = 1;
+  static constexpr uint8_t kFullBit = 0x80;
+  static constexpr int64_t kMinCapacity = 16;
+
+  // Aligned to a cache line so that the locks of neighbouring shards do not
+  // share one.
+  struct alignas(64) Shard {
+    mutable mutex mu;
+    int64_t capacity TF_GUARDED_BY(mu) = 0;
+    int64_t num_full TF_GUARDED_BY(mu) = 0;
+    int64_t num_deleted TF_GUARDED_BY(mu) = 0;
+    std::unique_ptr<uint8_t[]> ctrl TF_GUARDED_BY(mu);
+    std::unique_ptr<K[]> keys TF_GUARDED_BY(mu);
+    std::unique_ptr<V[]> values TF_GUARDED_BY(mu);
+
+    // Returns the value slots of `key`, or nullptr if it is not present.
+    const V* Lookup(const K& key, uint64_t hash, int64_t value_dim) const
+        TF_SHARED_LOCKS_REQUIRED(mu) {
+      const int64_t slot = FindSlot(key, hash);
+      return slot < 0 ? nullptr : values.get() + slot * value_dim;
+    }
+
+    void InsertOrAssign(const K& key, uint64_t hash, const V* value,
+                        int64_t value_dim) TF_EXCLUSIVE_LOCKS_REQUIRED(mu) {
+      int64_t slot = FindSlot(key, hash);
+      if (slot < 0) {
+        if ((num_full + num_deleted + 1) * 4 > capacity * 3) {
+          // Rehash in place when tombstones dominate, otherwise grow.
+          Rehash(num_full * 2 >= capacity ? std::max(capacity * 2, kMinCapacity)
+                                          : capacity,
+                 value_dim);
+        }
+        slot = FindFreeSlot(hash);
+        if (ctrl[slot] == kDeleted) --num_deleted;
+        ctrl[slot] = Fragment(hash);
+        keys[slot] = key;
+        ++num_full;
+      }
+      std::copy_n(value, value_dim, values.get() + slot * value_dim);
+    }
+
+    void Erase(const K& key, uint64_t hash, int64_t value_dim)
+        TF_EXCLUSIVE_LOCKS_REQUIRED(mu) {
+      const int64_t slot = FindSlot(key, hash);
+      if (slot < 0) return;
+      ctrl[slot] = kDeleted;
+      // Release any memory held by non-trivial keys and values eagerly.
+      keys[slot] = K();
+      std::fill_n(values.get() + slot * value_dim, value_dim, V());
+      --num_full;
+      ++num_deleted;
+    }
+
+    void Clear() TF_EXCLUSIVE_LOCKS_REQUIRED(mu) {
+      capacity = 0;
+      num_full = 0;
+      num_deleted = 0;
+      ctrl.reset();
+      keys.reset();
+      values.reset();
+    }
+
+   private:
+    // Bits 40-46 of the hash; the high bits select the shard and the low
+    // bits the slot.
+    static uint8_t Fragment(uint64_t hash) {
+      return kFullBit | static_cast<uint8_t>((hash >> 40) & 0x7f);
+    }
+
+    int64_t FindSlot(const K& key, uint64_t hash) const
+        TF_SHARED_LOCKS_REQUIRED(mu) {
+      if (capacity == 0) return -1;
+      const uint8_t fragment = Fragment(hash);
+      const uint64_t mask = capacity - 1;
+      for (uint64_t i = hash & mask;; i = (i + 1) & mask) {
+        const uint8_t c = ctrl[i];
+        if (c == kEmpty) return -1;
+        if (c == fragment && keys[i] == key) return i;
+      }
+    }
+
+    int64_t FindFreeSlot(uint64_t hash) const TF_SHARED_LOCKS_REQUIRED(mu) {
+      const uint64_t mask = capacity - 1;
+      uint64_t i = hash & mask;
+      while (ctrl[i] & kFullBit) i = (i + 1) & mask;
+      return i;
+    }
+
+    void Rehash(int64_t new_capacity, int64_t value_dim)
+        TF_EXCLUSIVE_LOCKS_REQUIRED(mu) {
+      std::unique_ptr<uint8_t[]> old_ctrl = std::move(ctrl);
+      std::unique_ptr<K[]> old_keys = std::move(keys);
+      std::unique_ptr<V[]> old_values = std::move(values);
+      const int64_t old_capacity = capacity;
+
+      capacity = new_capacity;
+      num_deleted = 0;
+      ctrl.reset(new uint8_t[capacity]());
+      keys.reset(new K[capacity]);
+      values.reset(new V[capacity * value_dim]);
+      for (int64_t i = 0; i < old_capacity; ++i) {
+        if (!(old_ctrl[i] & kFullBit)) continue;
+        const uint64_t hash = HashKey(old_keys[i]);
+        const int64_t slot = FindFreeSlot(hash);
+        ctrl[slot] = old_ctrl[i];
+        keys[slot] = std::move(old_keys[i]);
+        std::move(old_values.get() + i * value_dim,
+                  old_values.get() + (i + 1) * value_dim,
+                  values.get() + slot * value_dim);
+      }
+    }
+  };
+
+  template <typename T>
+  static uint64_t HashKeyImpl(const T& key) {
+    return static_cast<uint64_t>(key);
+  }
+  static uint64_t HashKeyImpl(const tstring& key) { return Hash64(key); }
+
+  // Finalizes the key hash so that integer keys, which hash to themselves,
+  // spread over both the shard and the slot bits.
+  static uint64_t HashKey(const K& key) {
+    uint64_t h = HashKeyImpl(key);
+    h ^= h >> 33;
+    h *= 0xff51afd7ed558ccdULL;
+    h ^= h >> 33;
+    h *= 0xc4ceb9fe1a85ec53ULL;
+    h ^= h >> 33;
+    return h;
+  }
+
+  // The shard index comes from the high bits of the hash and the slot index
+  // from the low bits, so the two are independent.
+  uint64_t ShardIndex(uint64_t hash) const {
+    return shard_bits_ == 0 ? 0 : (hash >> (64 - shard_bits_));
+  }
+
+  // Groups the keys by shard, preserving their relative order, and calls
+  // `fn(shard, key_index, hash)` for each of them with the shard locked by
+  // `Lock`. Each shard is locked once.
+  template <typename Lock, typename ShardT, typename KeyFlat, typename Fn>
+  void ForEachShardImpl(ShardT* shards, const KeyFlat& key_values,
+                        Fn fn) const {
+    const int64_t n = key_values.size();
+    if (n == 0) return;
+    if (num_shards_ == 1) {
+      Lock l(shards[0].mu);
+      for (int64_t i = 0; i < n; ++i) {
+        fn(shards[0], i, HashKey(SubtleMustCopyIfIntegral(key_values(i))));
+      }
+      return;
+    }
+    std::vector<uint64_t> hashes(n);
+    std::vector<int64_t> offsets(num_shards_ + 1, 0);
+    for (int64_t i = 0; i < n; ++i) {
+      hashes[i] = HashKey(SubtleMustCopyIfIntegral(key_values(i)));
+      ++offsets[ShardIndex(hashes[i]) + 1];
+    }
+    for (uint64_t s = 0; s < num_shards_; ++s) {
+      offsets[s + 1] += offsets[s];
+    }
+    std::vector<int64_t> order(n);
+    {
+      std::vector<int64_t> next(offsets.begin(), offsets.end() - 1);
+      for (int64_t i = 0; i < n; ++i) {
+        order[next[ShardIndex(hashes[i])]++] = i;
+      }
+    }
+    for (uint64_t s = 0; s < num_shards_; ++s) {
+      if (offsets[s] == offsets[s + 1]) continue;
+      Lock l(shards[s].mu);
+      for (int64_t j = offsets[s]; j < offsets[s + 1]; ++j) {
+        fn(shards[s], order[j], hashes[order[j]]);
+      }
+    }
+  }
+
+  template <typename KeyFlat, typename Fn>
+  void ForEachShard(const KeyFlat& key_values, Fn fn) const {
+    ForEachShardImpl<tf_shared_lock>(static_cast<const Shard*>(shards_.get()),
+                                     key_values, fn);
+  }
+
+  template <typename KeyFlat, typename Fn>
+  void ForEachShardMutable(const KeyFlat& key_values, Fn fn) {
+    ForEachShardImpl<mutex_lock>(shards_.get(), key_values, fn);
+  }
+
+  absl::Status DoInsert(bool clear, const Tensor& keys, const Tensor& values)
+      TF_NO_THREAD_SAFETY_ANALYSIS {
+    const auto key_values = keys.flat<K>();
+    const auto value_values = values.flat<V>();
+
+    if (clear) {
+      // Import replaces the whole table atomically, so hold every shard.
+      std::vector<std::unique_ptr<mutex_lock>> locks;
+      locks.reserve(num_shards_);
+      for (uint64_t s = 0; s < num_shards_; ++s) {
+        locks.push_back(std::make_unique<mutex_lock>(shards_[s].mu));
+        shards_[s].Clear();
+      }
+      for (int64_t i = 0; i < key_values.size(); ++i) {
+        const K key = SubtleMustCopyIfIntegral(key_values(i));
+        const uint64_t hash = HashKey(key);
+        shards_[ShardIndex(hash)].InsertOrAssign(
+            key, hash, value_values.data() + i * value_dim_, value_dim_);
+      }
+      return absl::OkStatus();
+    }
+
+    ForEachShardMutable(key_values, [&](Shard& shard, int64_t i, uint64_t hash)
+                                        TF_NO_THREAD_SAFETY_ANALYSIS {
+      shard.InsertOrAssign(SubtleMustCopyIfIntegral(key_values(i)), hash,
+                           value_values.data() + i * value_dim_, value_dim_);
+    });
+    return absl::OkStatus();
+  }
+
+  // Takes a shared lock on every shard, in shard order.
+  std::vector<std::unique_ptr<tf_shared_lock>> LockAllShared() const {
+    std::vector<std::unique_ptr<tf_shared_lock>> locks;
+    locks.reserve(num_shards_);
+    for (uint64_t s = 0; s < num_shards_; ++s) {
+      locks.push_back(std::make_unique<tf_shared_lock>(shards_[s].mu));
+    }
+    return locks;
+  }
+
+  // Returns the number of entries. Requires all shards to be locked.
+  int64_t SizeLocked() const TF_NO_THREAD_SAFETY_ANALYSIS {
+    int64_t size = 0;
+    for (uint64_t s = 0; s < num_shards_; ++s) {
+      size += shards_[s].num_full;
+    }
+    return size;
+  }
+
+  // Writes all keys and values into `keys` and `values`, which must be sized
+  // for size() entries. Requires all shards to be locked.
+  void ExportKeysAndValues(Tensor* keys, Tensor* values) const
+      TF_NO_THREAD_SAFETY_ANALYSIS {
+    auto keys_data = keys->flat<K>();
+    auto values_data = values->flat<V>();
+    int64_t i = 0;
+    for (uint64_t s = 0; s < num_shards_; ++s) {
+      const Shard& shard = shards_[s];
+      for (int64_t slot = 0; slot < shard.capacity; ++slot) {
+        if (!(shard.ctrl[slot] & kFullBit)) continue;
+        keys_data(i) = shard.keys[slot];
+        std::copy_n(shard.values.get() + slot * value_dim_, value_dim_,
+                    values_data.data() + i * value_dim_);
+        ++i;
+      }
+    }
+  }
+
+  const TensorShape value_shape_;
+  const int64_t value_dim_;
+  const uint64_t num_shards_;
+  const int shard_bits_;
+  std::unique_ptr<Shard[]> shards_;
+};
+
 }  // namespace lookup
 
 }  // namespace tensorflow
@@ -34,6 +34,7 @@ limitations under the License.
 #include "tensorflow/core/lib/strings/stringprintf.h"
 #include "tensorflow/core/platform/logging.h"
 #include "tensorflow/core/platform/types.h"
+#include "tensorflow/core/util/env_var.h"
 #include "tensorflow/core/util/tensor_bundle/tensor_bundle.h"
 #include "tensorflow/core/util/tensor_slice_reader.h"
 #include "tensorflow/core/util/tensor_slice_reader_cache.h"
@@ -253,6 +254,50 @@ namespace {
 // Tensors larger than this threshold will be restored from a thread-pool.
 const int64_t kLargeShapeThreshold = 16 << 20;  // 16M
 
+// Returns the BundleReader options used by RestoreV2. Setting
+// TF_RESTORE_USE_MMAP=1 restores tensors as aliases of the memory-mapped data
+// files instead of copies, which roughly halves peak memory when restoring
+// large checkpoints for inference.
+BundleReader::Options RestoreReaderOptions(BundleCache* cache) {
+  static const bool use_mmap = [] {
+    bool value = false;
+    absl::Status s = ReadBoolFromEnvVar("TF_RESTORE_USE_MMAP", false, &value);
+    if (!s.ok()) {
+      LOG(WARNING) << s;
+    }
+    return value;
+  }();
+  BundleReader::Options options;
+  options.cache = cache;
+  options.use_mmap = use_mmap;
+  return options;
+}
+
+// Returns true and fills "options" if RestoreV2 should restore full tensors
+// with BundleReader::LookupMultiple, i.e. if TF_RESTORE_PARALLEL_READ_THREADS
+// is positive. TF_RESTORE_MAX_INFLIGHT_MB optionally bounds the bytes being
+// read at any one time.
+bool ParallelReadOptionsFromEnv(BundleReader::ParallelReadOptions* options) {
+  int64_t num_threads = 0;
+  absl::Status s =
+      ReadInt64FromEnvVar("TF_RESTORE_PARALLEL_READ_THREADS", 0, &num_threads);
+  if (!s.ok()) {
+    LOG(WARNING) << s;
+    return false;
+  }
+  if (num_threads <= 0) return false;
+  options->num_threads = num_threads;
+
+  int64_t max_inflight_mb = 0;
+  s = ReadInt64FromEnvVar("TF_RESTORE_MAX_INFLIGHT_MB", 0, &max_inflight_mb);
+  if (!s.ok()) {
+    LOG(WARNING) << s;
+  } else if (max_inflight_mb > 0) {
+    options->max_inflight_bytes = max_inflight_mb << 20;
+  }
+  return true;
+}
+
 // A restore operation for a single tensor.  Small tensors may be restored
 // directly from the op thread to improve read locality.  Large tensors can be
 // restored from a thread pool: this requires creating a separate BundleReader
@@ -287,7 +332,8 @@ struct RestoreOp {
 
   // Run this restore operation using a new BundleReader.
   void run_with_new_reader(BundleCache* cache) {
-    BundleReader reader(tsl::Env::Default(), reader_prefix, {cache, false});
+    BundleReader reader(tsl::Env::Default(), reader_prefix,
+                        RestoreReaderOptions(cache));
     if (!reader.status().ok()) {
       status = reader.status();
       return;
@@ -362,6 +408,44 @@ struct RestoreOp {
   absl::Status status;
 };
 
+// Restores the full tensors of "restore_ops" with a single
+// BundleReader::LookupMultiple call, and the slices one by one.
+absl::Status RunWithParallelReads(
+    OpKernelContext* context, BundleReader* reader,
+    const BundleReader::ParallelReadOptions& options,
+    std::vector<RestoreOp>& restore_ops) {
+  std::vector<std::string> keys;
+  std::vector<Tensor*> vals;
+  for (RestoreOp& restore_op : restore_ops) {
+    if (!restore_op.shape_and_slice.empty()) {
+      TF_RETURN_IF_ERROR(restore_op.run(reader));
+      continue;
+    }
+    TensorShape restored_full_shape;
+    TF_RETURN_IF_ERROR(
+        reader->LookupTensorShape(restore_op.tensor_name, &restored_full_shape));
+    Tensor* restored_tensor;
+    TF_RETURN_IF_ERROR(context->allocate_output(
+        restore_op.idx, restored_full_shape, &restored_tensor));
+    keys.push_back(restore_op.tensor_name);
+    vals.push_back(restored_tensor);
+  }
+  return reader->LookupMultiple(keys, vals, options);
+}
+
+absl::Status CheckRestoredDtypes(OpKernelContext* context,
+                                 const std::vector<RestoreOp>& restore_ops) {
+  for (const RestoreOp& restore_op : restore_ops) {
+    if (restore_op.dtype != context->mutable_output(restore_op.idx)->dtype()) {
+      return absl::InvalidArgumentError(absl::StrCat(
+          "tensor_name = ", restore_op.tensor_name, "; expected dtype ",
+          DataTypeString(restore_op.dtype), " does not equal restored dtype ",
+          DataTypeString(context->mutable_output(restore_op.idx)->dtype())));
+    }
+  }
+  return absl::OkStatus();
+}
+
 }  // namespace
 
 absl::Status RestoreTensorsV2(OpKernelContext* context, const Tensor& prefix,
@@ -382,7 +466,8 @@ absl::Status RestoreTensorsV2(OpKernelContext* context, const Tensor& prefix,
 
   tsl::Env* const env = tsl::Env::Default();
   BundleCache cache(env);
-  BundleReader default_reader(env, prefix_string, {&cache, false});
+  BundleReader default_reader(env, prefix_string,
+                              RestoreReaderOptions(&cache));
   TF_RETURN_IF_ERROR(default_reader.status());
 
   TF_RETURN_IF_ERROR(default_reader.SortForSequentialAccess<RestoreOp>(
@@ -407,6 +492,14 @@ absl::Status RestoreTensorsV2(OpKernelContext* context, const Tensor& prefix,
     return absl::InvalidArgumentError(error_msg);
   }
 
+  BundleReader::ParallelReadOptions parallel_read_options;
+  if (ParallelReadOptionsFromEnv(&parallel_read_options)) {
+    TF_RETURN_IF_ERROR(RunWithParallelReads(context, &default_reader,
+                                            parallel_read_options,
+                                            restore_ops));
+    return CheckRestoredDtypes(context, restore_ops);
+  }
+
   // Split restore ops into two groups: large and small. We schedule
   // large ops first, to prevent them from waiting on the small op.
   std::vector<RestoreOp*> large_restore_ops;
@@ -471,16 +564,7 @@ absl::Status RestoreTensorsV2(OpKernelContext* context, const Tensor& prefix,
     }
   }
 
-  for (const RestoreOp& restore_op : restore_ops) {
-    if (restore_op.dtype != context->mutable_output(restore_op.idx)->dtype()) {
-      return absl::InvalidArgumentError(absl::StrCat(
-          "tensor_name = ", restore_op.tensor_name, "; expected dtype ",
-          DataTypeString(restore_op.dtype), " does not equal restored dtype ",
-          DataTypeString(context->mutable_output(restore_op.idx)->dtype())));
-    }
-  }
-
-  return absl::OkStatus();
+  return CheckRestoredDtypes(context, restore_ops);
 }
 
 }  // namespace tensorflow
@@ -88,11 +88,17 @@ REGISTER_OP("BatchFunction")
     //     to either PAD_UP or BATCH_DOWN so as to minimize the TPU costs per
     //     real request. In this case, it would compare (batch_16_cost / 16) and
     //     (batch_32_cost / 18).
+    //   - MAXIMIZE_THROUGHPUT_PER_COST: a profile-guided policy that picks,
+    //     among padding up and batching down to any smaller allowed size, the
+    //     option that processes the most real requests per unit of measured
+    //     cost, skipping sizes whose measured latency exceeds the model's
+    //     latency SLO.
     //
     // WARNING: Not all batch schedulers might support this attribute.
     .Attr(
         "batch_padding_policy: "
-        "{'PAD_UP', 'BATCH_DOWN', 'MINIMIZE_TPU_COST_PER_REQUEST'} = 'PAD_UP'")
+        "{'PAD_UP', 'BATCH_DOWN', 'MINIMIZE_TPU_COST_PER_REQUEST', "
+        "'MAXIMIZE_THROUGHPUT_PER_COST'} = 'PAD_UP'")
     .Attr("Tin: list(type)")
     .Attr("Tcaptured: list(type) >= 0")
     .Attr("Tout: list(type)")
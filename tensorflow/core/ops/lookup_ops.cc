@@ -402,6 +402,7 @@ REGISTER_OP("MutableHashTableV2")
     .Attr("use_node_name_sharing: bool = false")
     .Attr("key_dtype: type")
     .Attr("value_dtype: type")
+    .Attr("num_shards: int = 0")
     .SetIsStateful()
     .SetShapeFn(MutableHashTableShapeFn);
 
@@ -409,6 +410,7 @@ REGISTER_OP("AnonymousMutableHashTable")
     .Output("table_handle: resource")
     .Attr("key_dtype: type")
     .Attr("value_dtype: type")
+    .Attr("num_shards: int = 0")
     .SetIsStateful()
     .SetShapeFn(MutableHashTableShapeFn);
 
@@ -431,6 +433,7 @@ REGISTER_OP("MutableHashTableOfTensorsV2")
     .Attr("key_dtype: type")
     .Attr("value_dtype: type")
     .Attr("value_shape: shape = {}")
+    .Attr("num_shards: int = 0")
     .SetIsStateful()
     .SetShapeFn(MutableHashTableOfTensorsShapeFn);
 
@@ -439,6 +442,7 @@ REGISTER_OP("AnonymousMutableHashTableOfTensors")
     .Attr("key_dtype: type")
     .Attr("value_dtype: type")
     .Attr("value_shape: shape = {}")
+    .Attr("num_shards: int = 0")
     .SetIsStateful()
     .SetShapeFn(MutableHashTableOfTensorsShapeFn);
 
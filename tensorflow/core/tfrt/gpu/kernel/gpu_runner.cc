@@ -337,9 +337,9 @@ std::vector<XlaCompiler::Argument> BuildXlaCompilerArguments(
 
 absl::Status CompileProgram(
     const GpuRunInputs& run_inputs, int device_idx,
-    const XlaCompiler::CompilationResult** compilation_result,
+    std::shared_ptr<const XlaCompiler::CompilationResult>* compilation_result,
     xla::PjRtClient** pjrt_client,
-    xla::PjRtLoadedExecutable** pjrt_executable) {
+    std::shared_ptr<xla::PjRtLoadedExecutable>* pjrt_executable) {
   std::vector<XlaCompiler::Argument> xla_compiler_args =
       BuildXlaCompilerArguments(run_inputs.args);
 
@@ -426,10 +426,12 @@ GpuRunner::Run(GpuRunInputs run_inputs) {
   const int device_idx = device_reservation.device_index();
   VLOG(1) << "GpuRunner selected device " << device_idx << ".";
 
-  // Compile the program.
-  const XlaCompiler::CompilationResult* compilation_result;
-  xla::PjRtClient* pjrt_client;                // Not owned.
-  xla::PjRtLoadedExecutable* pjrt_executable;  // Not owned.
+  // Compile the program. The closure below holds shared ownership of the
+  // compilation result and executable so that a cache eviction cannot free
+  // them before the asynchronous execution runs.
+  std::shared_ptr<const XlaCompiler::CompilationResult> compilation_result;
+  xla::PjRtClient* pjrt_client;  // Not owned.
+  std::shared_ptr<xla::PjRtLoadedExecutable> pjrt_executable;
   TF_RETURN_IF_ERROR(CompileProgram(run_inputs, device_idx, &compilation_result,
                                     &pjrt_client, &pjrt_executable));
 
@@ -461,10 +463,11 @@ GpuRunner::Run(GpuRunInputs run_inputs) {
       transferred_args_to_wait,
       [run_inputs = std::move(run_inputs),
        transferred_args = std::move(transferred_args), results = results,
-       compilation_result, pjrt_client, pjrt_executable, device_idx]() mutable {
-        auto execution_outputs =
-            ExecuteProgram(run_inputs, transferred_args, compilation_result,
-                           pjrt_client, pjrt_executable, device_idx);
+       compilation_result = std::move(compilation_result), pjrt_client,
+       pjrt_executable = std::move(pjrt_executable), device_idx]() mutable {
+        auto execution_outputs = ExecuteProgram(
+            run_inputs, transferred_args, compilation_result.get(),
+            pjrt_client, pjrt_executable.get(), device_idx);
         CHECK_EQ(results.size(), execution_outputs->size());  // Crash OK.
 
         if (!execution_outputs.ok()) {
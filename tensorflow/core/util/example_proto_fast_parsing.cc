@@ -15,6 +15,7 @@ limitations under the License.
 #include "tensorflow/core/util/example_proto_fast_parsing.h"
 
 #include <algorithm>
+#include <cstring>
 #include <functional>
 #include <optional>
 #include <utility>
@@ -1100,6 +1101,229 @@ class TensorVector {
   T* data_ = nullptr;
 };
 
+// Returns true if `config` can be parsed by FastParseDenseColumnar(), i.e. it
+// only has dense features of fixed shape.
+bool IsDenseColumnarConfig(const Config& config) {
+  if (!config.columnar_dense || config.collect_feature_stats) return false;
+  if (config.dense.empty()) return false;
+  if (!config.sparse.empty() || !config.ragged.empty()) return false;
+  for (const Config::Dense& dense : config.dense) {
+    if (dense.variable_length) return false;
+  }
+  return true;
+}
+
+// If the value list of `feature` (positioned after the oneof tag, see
+// parsed::Feature::ParseDataType) consists of exactly one packed field, points
+// `payload` at its packed bytes and returns true.
+bool GetPackedPayload(const parsed::Feature& feature,
+                      absl::string_view* payload) {
+  const absl::string_view serialized = feature.GetSerialized();
+  protobuf::io::CodedInputStream stream(
+      reinterpret_cast<const uint8_t*>(serialized.data()), serialized.size());
+  uint32_t length;
+  if (!stream.ReadVarint32(&length)) return false;
+  const size_t list_begin = stream.CurrentPosition();
+  if (length > serialized.size() - list_begin) return false;
+  if (!stream.ExpectTag(kDelimitedTag(1))) return false;
+  uint32_t packed_length;
+  if (!stream.ReadVarint32(&packed_length)) return false;
+  const size_t packed_begin = stream.CurrentPosition();
+  if (packed_begin - list_begin + packed_length != length) return false;
+  *payload = serialized.substr(packed_begin, packed_length);
+  return true;
+}
+
+// Decodes exactly `n` varints from `packed` into `out`. Runs of single-byte
+// varints, the common case for ids and counts, are decoded eight at a time
+// from a single 64-bit load.
+bool DecodePackedVarints(absl::string_view packed, size_t n, int64_t* out) {
+  const uint8_t* p = reinterpret_cast<const uint8_t*>(packed.data());
+  const uint8_t* const end = p + packed.size();
+  size_t i = 0;
+  while (i < n) {
+    if (port::kLittleEndian && end - p >= 8 && n - i >= 8) {
+      uint64_t word;
+      memcpy(&word, p, sizeof(word));
+      if ((word & 0x8080808080808080ULL) == 0) {
+        for (int k = 0; k < 8; ++k) {
+          out[i + k] = static_cast<int64_t>((word >> (8 * k)) & 0x7f);
+        }
+        p += 8;
+        i += 8;
+        continue;
+      }
+    }
+    uint64_t value = 0;
+    for (int shift = 0;; shift += 7) {
+      // Like CodedInputStream::ReadVarint64, reject varints over 10 bytes.
+      if (p == end || shift >= 70) return false;
+      const uint8_t byte = *p++;
+      value |= static_cast<uint64_t>(byte & 0x7f) << shift;
+      if ((byte & 0x80) == 0) break;
+    }
+    out[i++] = static_cast<int64_t>(value);
+  }
+  return p == end;
+}
+
+// Parses examples [start, end) of a batch accepted by IsDenseColumnarConfig().
+// The examples are first scanned once to build an offset table holding the
+// value list of every (example, feature) pair; the output tensors are then
+// filled one feature at a time. Packed float lists are copied straight into
+// the output and packed int64 lists are decoded with DecodePackedVarints();
+// everything else goes through the parsed::Feature decoders, which also
+// produce the error messages of FastParseSerializedExample().
+absl::Status ParseDenseColumnarMiniBatch(
+    const Config& config, absl::Span<const tstring> serialized,
+    absl::Span<const tstring> example_names,
+    const PresizedCuckooMap<std::pair<size_t, Type>>& config_index,
+    SeededHasher hasher, size_t start, size_t end,
+    std::vector<Tensor>* output_dense) {
+  const size_t num_dense = config.dense.size();
+  auto example_name = [&](size_t e) -> absl::string_view {
+    return !example_names.empty() ? example_names[e] : "<unknown>";
+  };
+
+  // features[(e - start) * num_dense + d] is the value list of dense feature
+  // d in example e; present[] tells whether the example has the feature.
+  std::vector<parsed::Feature> features((end - start) * num_dense);
+  std::vector<bool> present((end - start) * num_dense, false);
+  parsed::Example parsed_example;
+  for (size_t e = start; e < end; ++e) {
+    parsed_example.clear();
+    if (!ParseExample(serialized[e], &parsed_example)) {
+      return absl::InvalidArgumentError(absl::StrCat(
+          "Could not parse example input, value: '", serialized[e], "'"));
+    }
+    const size_t row = (e - start) * num_dense;
+    const size_t parsed_example_size = parsed_example.size();
+    for (size_t i = 0; i < parsed_example_size; ++i) {
+      // Last entry in the map overwrites all the previous ones.
+      parsed::FeatureMapEntry& name_and_feature =
+          parsed_example[parsed_example_size - i - 1];
+      const absl::string_view feature_name = name_and_feature.first;
+      std::pair<size_t, Type> d_and_type;
+      if (!config_index.Find(hasher(feature_name), &d_and_type)) continue;
+      const size_t d = d_and_type.first;
+      if (feature_name != config.dense[d].feature_name) continue;
+
+      parsed::Feature& feature = name_and_feature.second;
+      DataType example_dtype;
+      TF_RETURN_IF_ERROR(feature.ParseDataType(&example_dtype));
+      if (example_dtype == DT_INVALID) continue;
+      if (present[row + d]) {
+        LogDenseFeatureDataLoss(feature_name);
+        continue;
+      }
+      if (example_dtype != config.dense[d].dtype) {
+        return absl::InvalidArgumentError(absl::StrCat(
+            "Name: ", example_name(e), ", Key: ", feature_name,
+            ", Index: ", e, ".  Data types don't match. Data type: ",
+            DataTypeString(example_dtype),
+            " but expected type: ", DataTypeString(config.dense[d].dtype)));
+      }
+      present[row + d] = true;
+      features[row + d] = feature;
+    }
+  }
+
+  for (size_t d = 0; d < num_dense; ++d) {
+    const Config::Dense& dense = config.dense[d];
+    const size_t num_elements = dense.elements_per_stride;
+    Tensor& out = (*output_dense)[d];
+    for (size_t e = start; e < end; ++e) {
+      const size_t offset = e * num_elements;
+      const size_t cell = (e - start) * num_dense + d;
+      if (!present[cell]) {
+        if (dense.default_value.NumElements() == 0) {
+          return absl::InvalidArgumentError(absl::StrCat(
+              "Name: ", example_name(e), ", Feature: ", dense.feature_name,
+              " (data type: ", DataTypeString(dense.dtype), ")",
+              " is required but could not be found."));
+        }
+        switch (dense.dtype) {
+          case DT_INT64:
+            std::copy_n(dense.default_value.flat<int64_t>().data(),
+                        num_elements, out.flat<int64_t>().data() + offset);
+            break;
+          case DT_FLOAT:
+            std::copy_n(dense.default_value.flat<float>().data(),
+                        num_elements, out.flat<float>().data() + offset);
+            break;
+          case DT_STRING:
+            std::copy_n(dense.default_value.flat<tstring>().data(),
+                        num_elements, out.flat<tstring>().data() + offset);
+            break;
+          default:
+            LOG(FATAL) << "Should not happen.";
+        }
+        continue;
+      }
+
+      parsed::Feature& feature = features[cell];
+      auto example_error = [&](absl::string_view suffix) {
+        return absl::InvalidArgumentError(
+            absl::StrCat("Name: ", example_name(e), ", Key: ",
+                         dense.feature_name, ", Index: ", e, ".  ", suffix));
+      };
+      auto parse_error = [&] {
+        return example_error("Can't parse serialized Example.");
+      };
+      auto shape_error = [&](size_t size, absl::string_view type_str) {
+        return example_error(strings::StrCat(
+            "Number of ", type_str,
+            " values != expected.  "
+            "Values size: ",
+            size, " but output shape: ", dense.shape.DebugString()));
+      };
+
+      absl::string_view packed;
+      switch (dense.dtype) {
+        case DT_INT64: {
+          int64_t* out_p = out.flat<int64_t>().data() + offset;
+          if (GetPackedPayload(feature, &packed) &&
+              DecodePackedVarints(packed, num_elements, out_p)) {
+            break;
+          }
+          LimitedArraySlice<int64_t> slice(out_p, num_elements);
+          if (!feature.ParseInt64List(&slice)) return parse_error();
+          if (slice.EndDistance() != 0) {
+            return shape_error(num_elements - slice.EndDistance(), "int64");
+          }
+          break;
+        }
+        case DT_FLOAT: {
+          float* out_p = out.flat<float>().data() + offset;
+          if (port::kLittleEndian && GetPackedPayload(feature, &packed) &&
+              packed.size() == num_elements * sizeof(float)) {
+            memcpy(out_p, packed.data(), packed.size());
+            break;
+          }
+          LimitedArraySlice<float> slice(out_p, num_elements);
+          if (!feature.ParseFloatList(&slice)) return parse_error();
+          if (slice.EndDistance() != 0) {
+            return shape_error(num_elements - slice.EndDistance(), "float");
+          }
+          break;
+        }
+        case DT_STRING: {
+          tstring* out_p = out.flat<tstring>().data() + offset;
+          LimitedArraySlice<tstring> slice(out_p, num_elements);
+          if (!feature.ParseBytesList(&slice)) return parse_error();
+          if (slice.EndDistance() != 0) {
+            return shape_error(num_elements - slice.EndDistance(), "bytes");
+          }
+          break;
+        }
+        default:
+          LOG(FATAL) << "Should not happen.";
+      }
+    }
+  }
+  return absl::OkStatus();
+}
+
 void CountSparseFeatures(
     const std::vector<std::vector<SparseBuffer>>& sparse_buffers, size_t d,
     size_t* total_num_features, size_t* max_num_features) {
@@ -1233,6 +1457,25 @@ absl::Status FastParseExample(const Config& config,
   //   in small batches.
   //   Maybe accept outside parameter #num_minibatches?
 
+  if (IsDenseColumnarConfig(config)) {
+    std::vector<absl::Status> status_of_minibatch(num_minibatches);
+    auto ProcessMiniBatch = [&](size_t minibatch) {
+      status_of_minibatch[minibatch] = ParseDenseColumnarMiniBatch(
+          config, serialized, example_names, config_index, hasher,
+          first_example_of_minibatch(minibatch),
+          first_example_of_minibatch(minibatch + 1), &fixed_dense_values);
+    };
+    ParallelFor(ProcessMiniBatch, num_minibatches, thread_pool);
+    for (absl::Status& status : status_of_minibatch) {
+      TF_RETURN_IF_ERROR(status);
+    }
+    result->dense_values.reserve(config.dense.size());
+    for (size_t d = 0; d < config.dense.size(); ++d) {
+      result->dense_values.push_back(std::move(fixed_dense_values[d]));
+    }
+    return absl::OkStatus();
+  }
+
   // Do minibatches in parallel.
   std::vector<std::vector<SparseBuffer>> sparse_buffers(num_minibatches);
   std::vector<std::vector<SparseBuffer>> varlen_dense_buffers(num_minibatches);
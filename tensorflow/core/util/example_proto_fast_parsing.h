@@ -97,6 +97,12 @@ struct FastParseExampleConfig {
   // If `true`, `Result::feature_stats` will contain one
   // `PerExampleFeatureStats` for each serialized example in the input.
   bool collect_feature_stats = false;
+
+  // If `true` and every feature is dense with a fixed shape,
+  // `FastParseExample()` parses each minibatch column by column: it first
+  // locates the value lists of all features in all examples, then decodes
+  // packed float and int64 lists directly into the output tensors.
+  bool columnar_dense = true;
 };
 
 // Statistics about the features in each example passed to
@@ -24,8 +24,11 @@ limitations under the License.
 #include "absl/strings/str_cat.h"
 #include "tensorflow/core/example/example.pb.h"
 #include "tensorflow/core/example/feature.pb.h"
+#include "tensorflow/core/framework/tensor.h"
+#include "tensorflow/core/lib/core/threadpool.h"
 #include "tensorflow/core/lib/random/philox_random.h"
 #include "tensorflow/core/lib/random/simple_philox.h"
+#include "tensorflow/core/platform/env.h"
 #include "tensorflow/core/platform/protobuf.h"
 #include "tensorflow/core/platform/test.h"
 #include "tensorflow/core/platform/test_benchmark.h"
@@ -422,6 +425,155 @@ TEST(FastParse, FuzzTest) {
   }
 }
 
+// Builds `num_examples` Examples resembling a ranking model input: scalar and
+// embedding float features, id lists with a mix of small and large ids, and a
+// string feature. Some examples omit features so that defaults are used.
+std::vector<tstring> MakeDenseBatch(int num_examples, int num_scalars,
+                                    int embedding_dim, int num_id_lists,
+                                    int ids_per_list, random::SimplePhilox* rng,
+                                    FastParseExampleConfig* config) {
+  for (int f = 0; f < num_scalars; ++f) {
+    Tensor default_value(DT_FLOAT, {1});
+    default_value.flat<float>()(0) = -1.0f;
+    config->dense.emplace_back(absl::StrCat("scalar_", f), DT_FLOAT,
+                               PartialTensorShape({1}), default_value, false,
+                               1);
+  }
+  config->dense.emplace_back("embedding", DT_FLOAT,
+                             PartialTensorShape({embedding_dim}), Tensor(),
+                             false, embedding_dim);
+  for (int f = 0; f < num_id_lists; ++f) {
+    Tensor default_value(DT_INT64, {ids_per_list});
+    default_value.flat<int64_t>().setConstant(-1);
+    config->dense.emplace_back(absl::StrCat("ids_", f), DT_INT64,
+                               PartialTensorShape({ids_per_list}),
+                               default_value, false, ids_per_list);
+  }
+  config->dense.emplace_back("label", DT_STRING, PartialTensorShape({1}),
+                             Tensor(), false, 1);
+
+  std::vector<tstring> serialized;
+  for (int i = 0; i < num_examples; ++i) {
+    Example example;
+    auto& features = *example.mutable_features()->mutable_feature();
+    for (int f = 0; f < num_scalars; ++f) {
+      if (rng->Uniform(10) == 0) continue;
+      features[absl::StrCat("scalar_", f)].mutable_float_list()->add_value(
+          rng->RandFloat());
+    }
+    for (int j = 0; j < embedding_dim; ++j) {
+      features["embedding"].mutable_float_list()->add_value(rng->RandFloat());
+    }
+    for (int f = 0; f < num_id_lists; ++f) {
+      if (rng->Uniform(10) == 0) continue;
+      auto* ids = features[absl::StrCat("ids_", f)].mutable_int64_list();
+      for (int j = 0; j < ids_per_list; ++j) {
+        switch (rng->Uniform(4)) {
+          case 0:
+            ids->add_value(rng->Rand64());
+            break;
+          case 1:
+            ids->add_value(-static_cast<int64_t>(rng->Uniform(1000)));
+            break;
+          default:
+            ids->add_value(rng->Uniform(128));
+        }
+      }
+    }
+    features["label"].mutable_bytes_list()->add_value(absl::StrCat("l", i));
+    serialized.push_back(Serialize(example));
+  }
+  return serialized;
+}
+
+TEST(FastParse, ColumnarDenseMatchesRowWise) {
+  random::PhiloxRandom philox(42);
+  random::SimplePhilox rng(&philox);
+  FastParseExampleConfig config;
+  std::vector<tstring> serialized =
+      MakeDenseBatch(/*num_examples=*/300, /*num_scalars=*/5,
+                     /*embedding_dim=*/16, /*num_id_lists=*/4,
+                     /*ids_per_list=*/20, &rng, &config);
+  // Concatenated Examples repeat every key; the last value wins.
+  serialized.push_back(absl::StrCat(serialized[0], serialized[1]));
+  // A non-packed float list goes through the generic decoder.
+  const std::string float_list = absl::StrCat("\x0d", std::string(4, '\0'));
+  const std::string feature =
+      absl::StrCat("\x12", std::string(1, float_list.size()), float_list);
+  const std::string map_entry =
+      absl::StrCat("\x0a\x08scalar_0\x12", std::string(1, feature.size()),
+                   feature);
+  const std::string features =
+      absl::StrCat("\x0a", std::string(1, map_entry.size()), map_entry);
+  serialized.push_back(absl::StrCat(
+      serialized[2], "\x0a", std::string(1, features.size()), features));
+
+  thread::ThreadPool thread_pool(Env::Default(), "test", 4);
+  for (thread::ThreadPool* pool : {
+           static_cast<thread::ThreadPool*>(nullptr),
+           &thread_pool,
+       }) {
+    Result columnar;
+    ASSERT_TRUE(FastParseExample(config, serialized, {}, pool, &columnar).ok());
+    config.columnar_dense = false;
+    Result row_wise;
+    ASSERT_TRUE(FastParseExample(config, serialized, {}, pool, &row_wise).ok());
+    config.columnar_dense = true;
+
+    ASSERT_EQ(columnar.dense_values.size(), row_wise.dense_values.size());
+    for (size_t d = 0; d < columnar.dense_values.size(); ++d) {
+      EXPECT_EQ(columnar.dense_values[d].DebugString(/*num_values=*/-1),
+                row_wise.dense_values[d].DebugString(/*num_values=*/-1));
+    }
+  }
+}
+
+TEST(FastParse, ColumnarDenseInt64TooManyElementsReportsError) {
+  FastParseExampleConfig config;
+  AddDenseFeature("ids", DT_INT64, {2}, false, 2, &config);
+  Example example;
+  auto* ids =
+      (*example.mutable_features()->mutable_feature())["ids"].mutable_int64_list();
+  for (int i = 0; i < 9; ++i) ids->add_value(i);
+  const std::vector<tstring> serialized = {tstring(Serialize(example))};
+
+  Result result;
+  const absl::Status status =
+      FastParseExample(config, serialized, {}, nullptr, &result);
+  EXPECT_TRUE(absl::IsInvalidArgument(status));
+  EXPECT_NE(status.ToString().find("Number of int64 values != expected"),
+            std::string::npos);
+}
+
+void BM_FastParseDenseExample(::testing::benchmark::State& state) {
+  const int batch_size = state.range(0);
+  const bool columnar = state.range(1);
+  random::PhiloxRandom philox(7);
+  random::SimplePhilox rng(&philox);
+  FastParseExampleConfig config;
+  const std::vector<tstring> serialized =
+      MakeDenseBatch(batch_size, /*num_scalars=*/40, /*embedding_dim=*/64,
+                     /*num_id_lists=*/20, /*ids_per_list=*/16, &rng, &config);
+  config.columnar_dense = columnar;
+  thread::ThreadPool thread_pool(Env::Default(), "benchmark", 4);
+  size_t bytes = 0;
+  for (const tstring& s : serialized) bytes += s.size();
+
+  for (auto s : state) {
+    Result result;
+    TF_CHECK_OK(
+        FastParseExample(config, serialized, {}, &thread_pool, &result));
+  }
+  state.SetBytesProcessed(state.iterations() * bytes);
+  state.SetItemsProcessed(state.iterations() * batch_size);
+}
+BENCHMARK(BM_FastParseDenseExample)
+    ->ArgPair(128, 0)
+    ->ArgPair(128, 1)
+    ->ArgPair(1024, 0)
+    ->ArgPair(1024, 1)
+    ->UseRealTime();
+
 TEST(TestFastParseExample, Empty) {
   Result result;
   FastParseExampleConfig config;
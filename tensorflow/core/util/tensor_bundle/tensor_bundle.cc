@@ -15,15 +15,18 @@ limitations under the License.
 
 #include "tensorflow/core/util/tensor_bundle/tensor_bundle.h"
 
+#include <algorithm>
 #include <cstdlib>
 #include <cstring>
 #include <memory>
+#include <tuple>
 #include <utility>
 
 #include "absl/base/call_once.h"
 #include "absl/synchronization/mutex.h"
 #include "xla/tsl/lib/io/buffered_file.h"
 #include "xla/tsl/util/byte_swap_array.h"
+#include "tensorflow/core/framework/mapped_tensor_buffer.h"
 #include "tensorflow/core/framework/register_types.h"
 #include "tensorflow/core/framework/tensor.pb.h"
 #include "tensorflow/core/framework/tensor_shape.pb.h"
@@ -227,6 +230,16 @@ absl::Status ReadVariantTensor(io::InputBuffer* buffered_file, Tensor* ret,
   return absl::OkStatus();
 }
 
+absl::Status ChecksumMismatchError(absl::string_view prefix, int32_t shard_id,
+                                   int64_t size, uint32_t stored_crc32c,
+                                   uint32_t actual_crc32c) {
+  return absl::DataLossError(absl::StrCat(
+      "TensorBundle at ", prefix, " shard ", shard_id, " (", size,
+      " bytes): Checksum does not match: stored ",
+      absl::StrFormat("%08u", stored_crc32c),
+      " vs. calculated on the restored bytes ", actual_crc32c));
+}
+
 char* GetBackingBuffer(const Tensor& val) {
   CHECK(DataTypeCanUseMemcpy(val.dtype())) << val.dtype();
   return const_cast<char*>(val.tensor_data().data());
@@ -798,7 +811,8 @@ BundleReader::BundleReader(Env* env, absl::string_view prefix, Options options)
       iter_(nullptr),
       need_to_swap_bytes_(false),
       enable_multi_threading_for_testing_(
-          options.enable_multi_threading_for_testing) {
+          options.enable_multi_threading_for_testing),
+      use_mmap_(options.use_mmap) {
   if (cache_ == nullptr) {
     // Make a cache for use just by this BundleReader.
     owned_cache_ = std::make_unique<BundleCache>(env);
@@ -892,8 +906,75 @@ absl::Status BundleReader::GetBundleEntryProto(absl::string_view key,
   return absl::OkStatus();
 }
 
+absl::Status BundleReader::GetMappedValue(const BundleEntryProto& entry,
+                                          Tensor* val, bool* restored) {
+  *restored = false;
+  if (need_to_swap_bytes_ || !DataTypeCanUseMemcpy(entry.dtype()) ||
+      entry.size() == 0) {
+    return absl::OkStatus();
+  }
+  const TensorShape stored_shape(entry.shape());
+  if (entry.size() !=
+      stored_shape.num_elements() * DataTypeSize(entry.dtype())) {
+    // Let the copying path report the invalid size.
+    return absl::OkStatus();
+  }
+
+  std::shared_ptr<const ReadOnlyMemoryRegion> region;
+  absl::Status status = cache_->GetMappedFile(
+      DataFilename(prefix_, entry.shard_id(), num_shards_), &region);
+  if (!status.ok()) {
+    VLOG(1) << "Falling back to reading " << prefix_ << " shard "
+            << entry.shard_id() << " without mmap: " << status;
+    return absl::OkStatus();
+  }
+  if (entry.offset() < 0 || entry.offset() + entry.size() > region->length()) {
+    return absl::OkStatus();
+  }
+
+  const char* data = static_cast<const char*>(region->data()) + entry.offset();
+  // A caller-allocated "val" keeps its buffer: the entry is copied out of the
+  // mapping, which still skips the buffered reads of the copying path.
+  const bool preallocated = val->NumElements() != 0;
+  if (preallocated) {
+    if (val->dtype() != entry.dtype() || val->TotalBytes() != entry.size()) {
+      return absl::OkStatus();
+    }
+  } else if (reinterpret_cast<intptr_t>(data) % EIGEN_MAX_ALIGN_BYTES != 0) {
+    VLOG(2) << "Not aliasing " << key() << " in " << prefix_
+            << ": its offset is not a multiple of " << EIGEN_MAX_ALIGN_BYTES
+            << " bytes; see BundleWriter::Options::data_alignment.";
+    return absl::OkStatus();
+  }
+
+  // This touches every page of the entry once, but unlike the copying path it
+  // neither allocates nor writes a second copy of the data.
+  const uint32_t actual_crc32c = crc32c::Value(data, entry.size());
+  if (crc32c::Unmask(entry.crc32c()) != actual_crc32c) {
+    return ChecksumMismatchError(prefix_, entry.shard_id(), entry.size(),
+                                 crc32c::Unmask(entry.crc32c()),
+                                 actual_crc32c);
+  }
+
+  if (preallocated) {
+    memcpy(const_cast<char*>(val->tensor_data().data()), data, entry.size());
+  } else {
+    *val = Tensor(entry.dtype(), stored_shape,
+                  core::RefCountPtr<TensorBuffer>(new MappedTensorBuffer(
+                      std::move(region), data, entry.size())));
+  }
+  *restored = true;
+  return absl::OkStatus();
+}
+
 absl::Status BundleReader::GetValue(const BundleEntryProto& entry,
                                     Tensor* val) {
+  if (use_mmap_) {
+    bool restored = false;
+    TF_RETURN_IF_ERROR(GetMappedValue(entry, val, &restored));
+    if (restored) return absl::OkStatus();
+  }
+
   Tensor* ret = val;
   const TensorShape stored_shape(TensorShape(entry.shape()));
   if (val->NumElements() == 0) {
@@ -1024,11 +1105,9 @@ absl::Status BundleReader::GetValue(const BundleEntryProto& entry,
         GetStringBackingBuffer(*ret), &actual_crc32c, need_to_swap_bytes_));
   }
   if (crc32c::Unmask(entry.crc32c()) != actual_crc32c) {
-    return absl::DataLossError(absl::StrCat(
-        "TensorBundle at ", prefix_, " shard ", entry.shard_id(), " (",
-        entry.size(), " bytes): Checksum does not match: stored ",
-        absl::StrFormat("%08u", crc32c::Unmask(entry.crc32c())),
-        " vs. calculated on the restored bytes ", actual_crc32c));
+    return ChecksumMismatchError(prefix_, entry.shard_id(), entry.size(),
+                                 crc32c::Unmask(entry.crc32c()),
+                                 actual_crc32c);
   }
 
   *val = *ret;
@@ -1050,6 +1129,169 @@ absl::Status BundleReader::Lookup(absl::string_view key, Tensor* val) {
   }
 }
 
+namespace {
+
+// A memcpy-able tensor planned for a parallel read.
+struct PlannedEntry {
+  int32_t shard_id;
+  int64_t offset;
+  int64_t size;
+  uint32_t crc32c;  // Unmasked.
+  char* dest;
+};
+
+// A single read covering one or more consecutive PlannedEntry objects of one
+// data file.
+struct PlannedRead {
+  int32_t shard_id;
+  int64_t offset;
+  int64_t size;
+  size_t begin;  // Range of covered entries.
+  size_t end;
+};
+
+// Reads [offset, offset + size) of "file" into "dest".
+absl::Status ReadFully(RandomAccessFile* file, int64_t offset, int64_t size,
+                       char* dest) {
+  absl::string_view sp;
+  TF_RETURN_IF_ERROR(file->Read(offset, sp, absl::MakeSpan(dest, size)));
+  if (sp.size() != size) {
+    return absl::DataLossError(absl::StrCat("Requested ", size,
+                                            " bytes but read ", sp.size(),
+                                            " bytes at offset ", offset));
+  }
+  if (sp.data() != dest) {
+    memmove(dest, sp.data(), size);
+  }
+  return absl::OkStatus();
+}
+
+}  // namespace
+
+absl::Status BundleReader::LookupMultiple(absl::Span<const std::string> keys,
+                                          absl::Span<Tensor* const> vals,
+                                          const ParallelReadOptions& options) {
+  if (keys.size() != vals.size()) {
+    return absl::InvalidArgumentError(
+        absl::StrCat("Got ", keys.size(), " keys but ", vals.size(),
+                     " output tensors"));
+  }
+
+  // Looks up the metadata of every key, restores the tensors that cannot be
+  // read with a plain memcpy, and allocates the rest.
+  std::vector<PlannedEntry> entries;
+  entries.reserve(keys.size());
+  for (size_t i = 0; i < keys.size(); ++i) {
+    BundleEntryProto entry;
+    TF_RETURN_IF_ERROR(GetBundleEntryProto(keys[i], &entry));
+    Tensor* val = vals[i];
+    if (!entry.slices().empty()) {
+      TF_RETURN_IF_ERROR(GetSliceValue(
+          keys[i], entry,
+          /* a full slice */ TensorSlice(TensorShape(entry.shape()).dims()),
+          val));
+      continue;
+    }
+    if (use_mmap_ || need_to_swap_bytes_ ||
+        !DataTypeCanUseMemcpy(entry.dtype())) {
+      TF_RETURN_IF_ERROR(GetValue(entry, val));
+      continue;
+    }
+    if (val->NumElements() == 0) {
+      *val = Tensor(entry.dtype(), TensorShape(entry.shape()));
+    }
+    if (entry.size() != val->TotalBytes()) {
+      return absl::DataLossError(absl::StrCat(
+          "Invalid size in bundle entry: key ", keys[i], "; stored size ",
+          entry.size(), "; expected size ", val->TotalBytes()));
+    }
+    entries.push_back({entry.shard_id(), entry.offset(), entry.size(),
+                       crc32c::Unmask(entry.crc32c()),
+                       const_cast<char*>(val->tensor_data().data())});
+  }
+  if (entries.empty()) return absl::OkStatus();
+
+  // Plans the reads in file order, merging neighboring small entries.
+  absl::c_sort(entries, [](const PlannedEntry& a, const PlannedEntry& b) {
+    return std::tie(a.shard_id, a.offset) < std::tie(b.shard_id, b.offset);
+  });
+  std::vector<PlannedRead> reads;
+  for (size_t i = 0; i < entries.size(); ++i) {
+    const PlannedEntry& e = entries[i];
+    if (!reads.empty()) {
+      PlannedRead& last = reads.back();
+      const int64_t last_end = last.offset + last.size;
+      if (last.shard_id == e.shard_id && e.offset >= last_end &&
+          e.offset - last_end <= options.max_merge_gap_bytes &&
+          e.offset + e.size - last.offset <= options.max_merged_read_bytes) {
+        last.size = e.offset + e.size - last.offset;
+        last.end = i + 1;
+        continue;
+      }
+    }
+    reads.push_back({e.shard_id, e.offset, e.size, i, i + 1});
+  }
+
+  // Reads one planned range and verifies the checksums of its entries.
+  auto run_read = [this, &entries](const PlannedRead& read) -> absl::Status {
+    RandomAccessFile* file = nullptr;
+    TF_RETURN_IF_ERROR(cache_->GetFile(
+        DataFilename(prefix_, read.shard_id, num_shards_), &file));
+    if (read.end - read.begin == 1) {
+      TF_RETURN_IF_ERROR(
+          ReadFully(file, read.offset, read.size, entries[read.begin].dest));
+    } else {
+      std::unique_ptr<char[]> staging(new char[read.size]);
+      TF_RETURN_IF_ERROR(
+          ReadFully(file, read.offset, read.size, staging.get()));
+      for (size_t i = read.begin; i < read.end; ++i) {
+        memcpy(entries[i].dest, staging.get() + entries[i].offset - read.offset,
+               entries[i].size);
+      }
+    }
+    for (size_t i = read.begin; i < read.end; ++i) {
+      const PlannedEntry& e = entries[i];
+      const uint32_t actual_crc32c = crc32c::Value(e.dest, e.size);
+      if (e.crc32c != actual_crc32c) {
+        return ChecksumMismatchError(prefix_, e.shard_id, e.size, e.crc32c,
+                                     actual_crc32c);
+      }
+    }
+    return absl::OkStatus();
+  };
+
+  absl::Mutex mu;
+  int64_t inflight_bytes = 0;
+  absl::Status status;
+  {
+    thread::ThreadPool pool(
+        env_, "bundle_parallel_read",
+        std::max<int>(1, std::min<size_t>(options.num_threads, reads.size())));
+    for (const PlannedRead& read : reads) {
+      {
+        absl::MutexLock l(mu);
+        // Admits the read once it fits in the budget, or when nothing else is
+        // in flight so that oversized reads still make progress. Stops
+        // issuing reads after the first error.
+        auto can_issue = [&]() {
+          return !status.ok() || inflight_bytes == 0 ||
+                 inflight_bytes + read.size <= options.max_inflight_bytes;
+        };
+        mu.Await(absl::Condition(&can_issue));
+        if (!status.ok()) break;
+        inflight_bytes += read.size;
+      }
+      pool.Schedule([&, read]() {
+        absl::Status s = run_read(read);
+        absl::MutexLock l(mu);
+        inflight_bytes -= read.size;
+        status.Update(s);
+      });
+    }
+  }
+  return status;
+}
+
 absl::Status BundleReader::ReadCurrent(Tensor* val) {
   CHECK(val != nullptr);
   BundleEntryProto entry;
@@ -1293,6 +1535,29 @@ absl::Status BundleCache::GetFile(const std::string& fname,
   return f->open_status;
 }
 
+absl::Status BundleCache::GetMappedFile(
+    const std::string& fname,
+    std::shared_ptr<const ReadOnlyMemoryRegion>* region) {
+  FileState* f;
+  {
+    absl::MutexLock l(mu_);
+    auto& slot = opened_files_[fname];
+    if (slot == nullptr) {
+      slot = std::make_unique<FileState>();
+    }
+    f = slot.get();
+  }
+
+  absl::call_once(f->map_once, [this, &fname, f] {
+    std::unique_ptr<ReadOnlyMemoryRegion> mapped;
+    f->map_status = env_->NewReadOnlyMemoryRegionFromFile(fname, &mapped);
+    f->region = std::move(mapped);
+  });
+
+  *region = f->region;
+  return f->map_status;
+}
+
 namespace {
 inline char* AlignedMalloc(size_t size) {
   char* buffer = static_cast<char*>(
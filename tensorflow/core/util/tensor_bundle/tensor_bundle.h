@@ -122,6 +122,10 @@ class BundleWriter {
     Options() {}
     // Alignment, in bytes, for tensor data.
     // Must be >= 1. The default size of 1 densely packs tensors.
+    //
+    // A BundleReader with "use_mmap" set only aliases entries whose offset is
+    // a multiple of EIGEN_MAX_ALIGN_BYTES, so bundles meant to be restored
+    // that way should use a multiple of it (e.g. 64).
     int data_alignment{1};
   };
   BundleWriter(Env* env, absl::string_view prefix,
@@ -217,6 +221,21 @@ class BundleReader {
 
     // For tests only.
     bool enable_multi_threading_for_testing = false;
+
+    // If true, tensors of memcpy-able dtypes are restored as Tensors that
+    // alias a read-only memory mapping of their data file instead of being
+    // copied into a freshly allocated buffer. If the caller passes an already
+    // allocated tensor to Lookup(), the entry is copied into it from the
+    // mapping instead. Entries that need byte swapping, or whose file system
+    // does not support memory mapping, fall back to the copying path, as do
+    // entries that are not aligned to EIGEN_MAX_ALIGN_BYTES in the file (see
+    // BundleWriter::Options::data_alignment; the default writer alignment
+    // packs tensors densely, so most of its entries are not aligned).
+    // Checksums are still verified, on the mapped bytes.
+    //
+    // The mapping stays alive as long as any tensor restored from it, so
+    // restored tensors may outlive the BundleReader and its BundleCache.
+    bool use_mmap = false;
   };
   BundleReader(Env* env, absl::string_view prefix, Options options);
 
@@ -268,6 +287,40 @@ class BundleReader {
   // REQUIRES: status().ok()
   absl::Status Lookup(absl::string_view key, Tensor* val);
 
+  // Options for "LookupMultiple()".
+  struct ParallelReadOptions {
+    // Number of threads issuing reads.
+    int num_threads = 8;
+
+    // Upper bound on the number of bytes being read at any one time, summed
+    // over all threads. Bounds the staging memory of merged reads and the
+    // outstanding I/O. A single read larger than this is issued on its own.
+    int64_t max_inflight_bytes = int64_t{256} << 20;
+
+    // Entries of the same data file that are at most this many bytes apart
+    // (e.g. alignment padding) are fetched with a single read into a staging
+    // buffer, up to "max_merged_read_bytes" per read. Entries larger than
+    // "max_merged_read_bytes" are always read directly into their tensor.
+    int64_t max_merge_gap_bytes = int64_t{64} << 10;
+    int64_t max_merged_read_bytes = int64_t{4} << 20;
+  };
+
+  // Looks up the full tensors keyed by "keys" into the corresponding "vals",
+  // following the contract of "Lookup()" for each of them.
+  //
+  // Reads of memcpy-able tensors are planned by data file and offset, merged
+  // when adjacent, and issued in parallel from a pool of
+  // "options.num_threads" threads owned by this call. Other tensors (strings,
+  // variants, partitioned or byte-swapped tensors, or any tensor when
+  // "use_mmap" is set) are looked up serially.
+  //
+  // Validates the stored crc32c checksum of every tensor. On error, "vals" may
+  // contain nonsense data.
+  // REQUIRES: status().ok() && keys.size() == vals.size()
+  absl::Status LookupMultiple(absl::Span<const std::string> keys,
+                              absl::Span<Tensor* const> vals,
+                              const ParallelReadOptions& options);
+
   // Looks up the tensor pointed to by the internal iterator.
   //
   // On error, "val" may contain nonsense data.
@@ -323,6 +376,14 @@ class BundleReader {
   // Usage for "val" follows the comment of "Lookup()".
   absl::Status GetValue(const BundleEntryProto& entry, Tensor* val);
 
+  // Attempts to restore "entry" into "val" as a tensor that aliases the
+  // memory-mapped data file, or, if "val" is already allocated, by copying
+  // from the mapping into it. Sets "*restored" to false, leaving "val"
+  // untouched, if the entry must go through the copying path of "GetValue()".
+  // REQUIRES: use_mmap_
+  absl::Status GetMappedValue(const BundleEntryProto& entry, Tensor* val,
+                              bool* restored);
+
   // Reads the slice described by "slice_spec".  The corresponding full tensor
   // has key "ful_tensor_key" and metadata proto "full_tensor_entry".
   // REQUIRES: full_tensor_entry.slices_size() > 0
@@ -360,6 +421,8 @@ class BundleReader {
 
   bool enable_multi_threading_for_testing_ = false;
 
+  bool use_mmap_ = false;
+
   BundleReader(const BundleReader&) = delete;
   void operator=(const BundleReader&) = delete;
 };
@@ -401,6 +464,14 @@ class BundleCache {
   // while the BundleCache lives.
   absl::Status GetFile(const std::string& fname, RandomAccessFile** file);
 
+  // Get a read-only memory mapping of fname, mapped on first use and shared
+  // by all callers. The mapping remains valid while either the BundleCache or
+  // any copy of "region" lives. Fails if the file system does not support
+  // memory mapping.
+  absl::Status GetMappedFile(
+      const std::string& fname,
+      std::shared_ptr<const ReadOnlyMemoryRegion>* region);
+
  private:
   // State for each opened file (opened on first read).
   struct FileState {
@@ -408,6 +479,11 @@ class BundleCache {
 
     std::unique_ptr<RandomAccessFile> file;
     absl::Status open_status;  // Records any error encountered on open
+
+    absl::once_flag map_once;  // Ensures file is mapped at most once.
+
+    std::shared_ptr<const ReadOnlyMemoryRegion> region;
+    absl::Status map_status;  // Records any error encountered on mapping
   };
 
   FileState* EnsureOpened(std::string name);
@@ -1261,6 +1261,188 @@ TEST(TensorBundleTest, LargeVariableLoadingTest) {
   }
 }
 
+// Returns true iff the data of "t" lies within the mapping of "fname" held by
+// "cache".
+bool AliasesMappedFile(const Tensor& t, BundleCache* cache,
+                       const std::string& fname) {
+  std::shared_ptr<const ReadOnlyMemoryRegion> region;
+  if (!cache->GetMappedFile(fname, &region).ok()) return false;
+  const char* begin = static_cast<const char*>(region->data());
+  const char* data = t.tensor_data().data();
+  return data >= begin && data + t.TotalBytes() <= begin + region->length();
+}
+
+TEST(TensorBundleTest, MmapRestore) {
+  {
+    BundleWriter::Options opts;
+    opts.data_alignment = 64;
+    BundleWriter writer(Env::Default(), Prefix("mmap"), opts);
+    TF_EXPECT_OK(writer.Add("floats", Constant_100x100<float>(3)));
+    TF_EXPECT_OK(writer.Add("ints", Constant_2x3<int64_t>(7)));
+    TF_EXPECT_OK(writer.Add("strings", test::AsTensor<tstring>({"a", "b"})));
+    TF_ASSERT_OK(writer.Finish());
+  }
+  Tensor floats;
+  {
+    BundleCache cache(Env::Default());
+    BundleReader::Options options;
+    options.cache = &cache;
+    options.use_mmap = true;
+    BundleReader reader(Env::Default(), Prefix("mmap"), options);
+    TF_ASSERT_OK(reader.status());
+    Expect<int64_t>(&reader, "ints", Constant_2x3<int64_t>(7));
+    Expect<tstring>(&reader, "strings", test::AsTensor<tstring>({"a", "b"}));
+
+    TF_ASSERT_OK(reader.Lookup("floats", &floats));
+    EXPECT_TRUE(AliasesMappedFile(floats, &cache,
+                                  DataFilename(Prefix("mmap"), 0, 1)));
+  }
+  // The restored tensor keeps the mapping alive after the reader and the
+  // cache are gone.
+  test::ExpectTensorEqual<float>(floats, Constant_100x100<float>(3));
+}
+
+TEST(TensorBundleTest, MmapRestoreIntoPreallocatedTensor) {
+  {
+    BundleWriter::Options opts;
+    opts.data_alignment = 64;
+    BundleWriter writer(Env::Default(), Prefix("mmap_preallocated"), opts);
+    TF_EXPECT_OK(writer.Add("floats", Constant_100x100<float>(4)));
+    TF_ASSERT_OK(writer.Finish());
+  }
+  BundleReader::Options options;
+  options.use_mmap = true;
+  BundleReader reader(Env::Default(), Prefix("mmap_preallocated"), options);
+  TF_ASSERT_OK(reader.status());
+
+  Tensor floats(DT_FLOAT, TensorShape({100, 100}));
+  const char* buffer = floats.tensor_data().data();
+  TF_ASSERT_OK(reader.Lookup("floats", &floats));
+  EXPECT_EQ(floats.tensor_data().data(), buffer);
+  test::ExpectTensorEqual<float>(floats, Constant_100x100<float>(4));
+}
+
+TEST(TensorBundleTest, MmapRestoreFallsBackForMisalignedEntries) {
+  {
+    BundleWriter writer(Env::Default(), Prefix("mmap_misaligned"));
+    TF_EXPECT_OK(writer.Add("a_byte", Constant(true, TensorShape({1}))));
+    TF_EXPECT_OK(writer.Add("b_floats", Constant_100x100<float>(5)));
+    TF_ASSERT_OK(writer.Finish());
+  }
+  BundleCache cache(Env::Default());
+  BundleReader::Options options;
+  options.cache = &cache;
+  options.use_mmap = true;
+  BundleReader reader(Env::Default(), Prefix("mmap_misaligned"), options);
+  TF_ASSERT_OK(reader.status());
+
+  Tensor floats;
+  TF_ASSERT_OK(reader.Lookup("b_floats", &floats));
+  test::ExpectTensorEqual<float>(floats, Constant_100x100<float>(5));
+  EXPECT_TRUE(floats.IsAligned());
+  EXPECT_FALSE(AliasesMappedFile(
+      floats, &cache, DataFilename(Prefix("mmap_misaligned"), 0, 1)));
+}
+
+TEST(TensorBundleTest, MmapRestoreVerifiesChecksum) {
+  {
+    BundleWriter::Options opts;
+    opts.data_alignment = 64;
+    BundleWriter writer(Env::Default(), Prefix("mmap_corrupt"), opts);
+    TF_EXPECT_OK(writer.Add("foo", Constant_2x3(1.f)));
+    TF_ASSERT_OK(writer.Finish());
+  }
+  const std::string datafile = DataFilename(Prefix("mmap_corrupt"), 0, 1);
+  std::string data;
+  TF_ASSERT_OK(ReadFileToString(Env::Default(), datafile, &data));
+  data[0] = ~data[0];
+  TF_ASSERT_OK(WriteStringToFile(Env::Default(), datafile, data));
+
+  BundleReader::Options options;
+  options.use_mmap = true;
+  BundleReader reader(Env::Default(), Prefix("mmap_corrupt"), options);
+  TF_ASSERT_OK(reader.status());
+  Tensor val;
+  absl::Status status = reader.Lookup("foo", &val);
+  EXPECT_TRUE(absl::IsDataLoss(status));
+  EXPECT_TRUE(absl::StrContains(status.ToString(), "Checksum does not match"));
+}
+
+TEST(TensorBundleTest, LookupMultiple) {
+  {
+    BundleWriter writer(Env::Default(), Prefix("multi_a"));
+    TF_EXPECT_OK(writer.Add("a_000", Constant_2x3<float>(0)));
+    TF_EXPECT_OK(writer.Add("a_001", Constant_2x3<int64_t>(1)));
+    TF_EXPECT_OK(writer.Add("a_002", test::AsTensor<tstring>({"x", "y"})));
+    TF_EXPECT_OK(writer.Add("a_003", Constant_2x3<float>(3)));
+    TF_ASSERT_OK(writer.Finish());
+  }
+  {
+    BundleWriter::Options opts;
+    opts.data_alignment = 64;
+    BundleWriter writer(Env::Default(), Prefix("multi_b"), opts);
+    TF_EXPECT_OK(writer.Add("b_000", Constant_100x100<float>(10)));
+    TF_EXPECT_OK(writer.Add("b_001", Constant_2x3<double>(11)));
+    TF_EXPECT_OK(writer.Add("b_002", Constant_100x100<int32_t>(12)));
+    TF_ASSERT_OK(writer.Finish());
+  }
+  TF_ASSERT_OK(MergeBundles(Env::Default(),
+                            {Prefix("multi_a"), Prefix("multi_b")},
+                            Prefix("multi")));
+
+  BundleReader reader(Env::Default(), Prefix("multi"));
+  TF_ASSERT_OK(reader.status());
+  const std::vector<std::string> keys = {"b_002", "a_000", "a_002", "b_000",
+                                         "a_003", "b_001", "a_001"};
+  std::vector<Tensor> vals(keys.size());
+  std::vector<Tensor*> val_ptrs;
+  for (Tensor& val : vals) val_ptrs.push_back(&val);
+
+  BundleReader::ParallelReadOptions options;
+  options.num_threads = 4;
+  // Forces the 100x100 tensors to be read on their own and bounds the budget
+  // below their size, so that both merged and oversized reads are exercised.
+  options.max_merged_read_bytes = 1024;
+  options.max_inflight_bytes = 2048;
+  TF_ASSERT_OK(reader.LookupMultiple(keys, val_ptrs, options));
+
+  test::ExpectTensorEqual<int32_t>(vals[0], Constant_100x100<int32_t>(12));
+  test::ExpectTensorEqual<float>(vals[1], Constant_2x3<float>(0));
+  test::ExpectTensorEqual<tstring>(vals[2], test::AsTensor<tstring>({"x", "y"}));
+  test::ExpectTensorEqual<float>(vals[3], Constant_100x100<float>(10));
+  test::ExpectTensorEqual<float>(vals[4], Constant_2x3<float>(3));
+  test::ExpectTensorEqual<double>(vals[5], Constant_2x3<double>(11));
+  test::ExpectTensorEqual<int64_t>(vals[6], Constant_2x3<int64_t>(1));
+
+  std::vector<Tensor*> too_few = {&vals[0]};
+  EXPECT_TRUE(absl::IsInvalidArgument(
+      reader.LookupMultiple(keys, too_few, options)));
+  EXPECT_TRUE(absl::IsNotFound(
+      reader.LookupMultiple({"no_such_key"}, too_few, options)));
+}
+
+TEST(TensorBundleTest, LookupMultipleVerifiesChecksums) {
+  {
+    BundleWriter writer(Env::Default(), Prefix("multi_corrupt"));
+    TF_EXPECT_OK(writer.Add("foo", Constant_2x3(1.f)));
+    TF_EXPECT_OK(writer.Add("goo", Constant_2x3(2.f)));
+    TF_ASSERT_OK(writer.Finish());
+  }
+  const std::string datafile = DataFilename(Prefix("multi_corrupt"), 0, 1);
+  std::string data;
+  TF_ASSERT_OK(ReadFileToString(Env::Default(), datafile, &data));
+  data[data.size() - 1] = ~data[data.size() - 1];
+  TF_ASSERT_OK(WriteStringToFile(Env::Default(), datafile, data));
+
+  BundleReader reader(Env::Default(), Prefix("multi_corrupt"));
+  TF_ASSERT_OK(reader.status());
+  Tensor foo, goo;
+  absl::Status status = reader.LookupMultiple({"foo", "goo"}, {&foo, &goo},
+                                              BundleReader::ParallelReadOptions());
+  EXPECT_TRUE(absl::IsDataLoss(status));
+  EXPECT_TRUE(absl::StrContains(status.ToString(), "Checksum does not match"));
+}
+
 absl::Status CreateFile(Env* env, const std::string& fname) {
   std::unique_ptr<WritableFile> file;
   TF_RETURN_IF_ERROR(env->NewWritableFile(fname, &file));
@@ -1327,6 +1509,22 @@ TEST(BundleCacheTest, ConcurrentGetFile) {
   }
 }
 
+TEST(BundleCacheTest, GetMappedFileSharesMapping) {
+  Env* env = Env::Default();
+  BundleCache cache(env);
+  const std::string fname = Prefix("mapped");
+  TF_EXPECT_OK(WriteStringToFile(env, fname, "contents"));
+
+  std::shared_ptr<const ReadOnlyMemoryRegion> r1;
+  std::shared_ptr<const ReadOnlyMemoryRegion> r2;
+  TF_ASSERT_OK(cache.GetMappedFile(fname, &r1));
+  TF_ASSERT_OK(cache.GetMappedFile(fname, &r2));
+  EXPECT_EQ(r1.get(), r2.get());
+  EXPECT_EQ(absl::string_view(static_cast<const char*>(r1->data()),
+                              r1->length()),
+            "contents");
+}
+
 class TensorBundleAlignmentTest : public ::testing::Test {
  protected:
   template <typename T>
@@ -1407,6 +1605,52 @@ BENCHMARK(BM_BundleAlignment)->ArgPair(4096, 512);
 BENCHMARK(BM_BundleAlignment)->ArgPair(4096, 4096);
 BENCHMARK(BM_BundleAlignment)->ArgPair(4096, 1048576);
 
+// Restores a 4-shard bundle of 128 MiB of float tensors with LookupMultiple,
+// reporting throughput against the number of read threads. The data files are
+// typically in the page cache after the first iteration, so this measures the
+// CPU side of the restore (syscalls, copies and checksums).
+static void BM_BundleLookupMultiple(::testing::benchmark::State& state) {
+  const int num_threads = state.range(0);
+  constexpr int kNumShards = 4;
+  constexpr int kTensorsPerShard = 32;
+  constexpr int64_t kTensorElements = 256 << 10;  // 1 MiB of floats.
+  std::vector<tstring> prefixes;
+  std::vector<std::string> keys;
+  for (int shard = 0; shard < kNumShards; ++shard) {
+    prefixes.push_back(Prefix(absl::StrCat("parallel_", shard)));
+    BundleWriter writer(Env::Default(), prefixes.back());
+    for (int i = 0; i < kTensorsPerShard; ++i) {
+      keys.push_back(absl::StrCat("t_", shard, "_", i));
+      TF_CHECK_OK(writer.Add(
+          keys.back(),
+          Constant(static_cast<float>(i), TensorShape({kTensorElements}))));
+    }
+    TF_CHECK_OK(writer.Finish());
+  }
+  TF_CHECK_OK(MergeBundles(Env::Default(), prefixes, Prefix("parallel")));
+
+  BundleReader reader(Env::Default(), Prefix("parallel"));
+  TF_CHECK_OK(reader.status());
+  BundleReader::ParallelReadOptions options;
+  options.num_threads = num_threads;
+  for (auto s : state) {
+    std::vector<Tensor> vals(keys.size());
+    std::vector<Tensor*> val_ptrs;
+    for (Tensor& val : vals) val_ptrs.push_back(&val);
+    TF_CHECK_OK(reader.LookupMultiple(keys, val_ptrs, options));
+  }
+  state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) *
+                          keys.size() * kTensorElements * sizeof(float));
+}
+
+BENCHMARK(BM_BundleLookupMultiple)
+    ->UseRealTime()
+    ->Arg(1)
+    ->Arg(2)
+    ->Arg(4)
+    ->Arg(8)
+    ->Arg(16);
+
 static void BM_BundleWriterSmallTensor(::testing::benchmark::State& state) {
   const int64_t bytes = state.range(0);
   Tensor t = Constant(static_cast<int8_t>('a'), TensorShape{bytes});
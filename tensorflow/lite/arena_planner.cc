@@ -18,8 +18,11 @@ limitations under the License.
 
 #include <algorithm>
 #include <cstdint>
+#include <iterator>
 #include <limits>
 #include <memory>
+#include <numeric>
+#include <random>
 #include <utility>
 #include <vector>
 
@@ -34,6 +37,170 @@ constexpr int32_t kLastActiveNodeUndefined =
 constexpr int32_t kNodeNotAssigned = std::numeric_limits<int32_t>::max();
 constexpr int32_t kScalarTensorBytes = 4;
 
+// Upper bound on the number of order perturbations tried by the offset search.
+constexpr int kMaxOffsetSearchIterations = 64;
+// Upper bound on the work of one offset search, in visited pairs of tensors.
+constexpr size_t kOffsetSearchBudget = size_t{1} << 24;
+
+namespace {
+
+// A tensor to be placed in the non-persistent arena.
+struct ArenaItem {
+  size_t size;
+  int32_t first_node;
+  int32_t last_node;
+};
+
+size_t AlignOffset(size_t alignment, size_t offset) {
+  const size_t remainder = offset % alignment;
+  return remainder == 0 ? offset : offset + (alignment - remainder);
+}
+
+// Places `items` one by one in the given `order`, each into the smallest gap
+// between already placed items with overlapping lifetimes (as
+// `SimpleMemoryArena::Allocate` does), and returns the resulting arena size.
+// The caller guarantees that the sum of all aligned sizes does not overflow.
+size_t PlaceInOrder(const std::vector<ArenaItem>& items,
+                    const std::vector<int>& order, size_t alignment,
+                    std::vector<size_t>* offsets) {
+  constexpr size_t kOffsetNotAssigned = std::numeric_limits<size_t>::max();
+  offsets->assign(items.size(), 0);
+  // Indices of placed items, sorted by offset.
+  std::vector<int> placed;
+  placed.reserve(items.size());
+  size_t high_water_mark = 0;
+  for (int i : order) {
+    const ArenaItem& item = items[i];
+    if (item.size == 0) continue;
+    size_t best_offset = kOffsetNotAssigned;
+    size_t best_gap = kOffsetNotAssigned;
+    size_t current_offset = 0;
+    for (int p : placed) {
+      const ArenaItem& other = items[p];
+      if (other.last_node < item.first_node ||
+          other.first_node > item.last_node) {
+        continue;
+      }
+      const size_t aligned_offset = AlignOffset(alignment, current_offset);
+      const size_t other_offset = (*offsets)[p];
+      if (aligned_offset + item.size <= other_offset &&
+          other_offset - aligned_offset < best_gap) {
+        best_offset = aligned_offset;
+        best_gap = other_offset - aligned_offset;
+        // An exact fit is as good as it gets.
+        if (best_gap == item.size) break;
+      }
+      current_offset = std::max(current_offset, other_offset + other.size);
+    }
+    if (best_offset == kOffsetNotAssigned) {
+      best_offset = AlignOffset(alignment, current_offset);
+    }
+    (*offsets)[i] = best_offset;
+    high_water_mark = std::max(high_water_mark, best_offset + item.size);
+    placed.insert(std::upper_bound(placed.begin(), placed.end(), i,
+                                   [offsets](int a, int b) {
+                                     return (*offsets)[a] < (*offsets)[b];
+                                   }),
+                  i);
+  }
+  return high_water_mark;
+}
+
+// Searches for offsets of `items` that give a small arena. `items` must be in
+// the order the default planner allocates them, so the result is never worse
+// than the default plan. Tries a few classic strip-packing orders, then a
+// bounded number of random swaps in the best order found so far, and stops
+// early once the arena is as small as the peak of live bytes.
+std::vector<size_t> SearchOffsets(const std::vector<ArenaItem>& items,
+                                  size_t alignment, int num_nodes) {
+  const int n = static_cast<int>(items.size());
+  auto lifetime_end = [&](int i) {
+    return std::min(items[i].last_node, static_cast<int32_t>(num_nodes));
+  };
+  auto lifetime = [&](int i) {
+    return static_cast<size_t>(lifetime_end(i) - items[i].first_node + 1);
+  };
+
+  // No arena can be smaller than the most bytes alive at any one node.
+  std::vector<size_t> live_bytes(num_nodes + 2, 0);
+  for (int i = 0; i < n; ++i) {
+    live_bytes[std::max(items[i].first_node, 0)] +=
+        AlignOffset(alignment, items[i].size);
+    live_bytes[lifetime_end(i) + 1] -= AlignOffset(alignment, items[i].size);
+  }
+  size_t lower_bound = 0;
+  size_t running = 0;
+  for (size_t bytes : live_bytes) {
+    running += bytes;
+    lower_bound = std::max(lower_bound, running);
+  }
+
+  std::vector<int> default_order(n);
+  std::iota(default_order.begin(), default_order.end(), 0);
+  auto sorted_order = [&](auto less) {
+    std::vector<int> order = default_order;
+    std::stable_sort(order.begin(), order.end(), less);
+    return order;
+  };
+  const std::vector<std::vector<int>> candidates = {
+      default_order,
+      // Longest lifetime first.
+      sorted_order([&](int a, int b) {
+        if (lifetime(a) != lifetime(b)) return lifetime(a) > lifetime(b);
+        return items[a].size > items[b].size;
+      }),
+      // Largest size x lifetime area first.
+      sorted_order([&](int a, int b) {
+        return items[a].size * lifetime(a) > items[b].size * lifetime(b);
+      }),
+      // Earliest first, largest first among tensors created by the same node.
+      sorted_order([&](int a, int b) {
+        if (items[a].first_node != items[b].first_node) {
+          return items[a].first_node < items[b].first_node;
+        }
+        return items[a].size > items[b].size;
+      }),
+  };
+
+  std::vector<size_t> best_offsets;
+  std::vector<int> best_order;
+  size_t best_size = std::numeric_limits<size_t>::max();
+  std::vector<size_t> offsets;
+  for (const std::vector<int>& order : candidates) {
+    const size_t size = PlaceInOrder(items, order, alignment, &offsets);
+    if (size < best_size) {
+      best_size = size;
+      best_order = order;
+      best_offsets.swap(offsets);
+    }
+    if (best_size <= lower_bound) return best_offsets;
+  }
+
+  const size_t pairs_per_placement =
+      std::max<size_t>(1, static_cast<size_t>(n) * static_cast<size_t>(n));
+  const int iterations = static_cast<int>(std::min<size_t>(
+      kMaxOffsetSearchIterations, kOffsetSearchBudget / pairs_per_placement));
+  // Seeded deterministically so that equal inputs give equal plans.
+  std::minstd_rand rng(n);
+  for (int it = 0; it < iterations && n > 1; ++it) {
+    const int a = rng() % n;
+    const int b = rng() % n;
+    if (a == b) continue;
+    std::swap(best_order[a], best_order[b]);
+    const size_t size = PlaceInOrder(items, best_order, alignment, &offsets);
+    if (size < best_size) {
+      best_size = size;
+      best_offsets.swap(offsets);
+      if (best_size <= lower_bound) break;
+    } else {
+      std::swap(best_order[a], best_order[b]);
+    }
+  }
+  return best_offsets;
+}
+
+}  // namespace
+
 ArenaPlanner::ArenaPlanner(TfLiteContext* context,
                            std::unique_ptr<GraphInfo> graph_info,
                            bool preserve_all_tensors, int tensor_alignment,
@@ -71,13 +238,20 @@ TfLiteStatus ArenaPlanner::ResetAllocations() {
   // all allocs to be cleared. if this is not set, the slow path is taken
   // (Purge) which inspects each alloc. Both paths give the exact same result.
   last_active_node_ = kLastActiveNodeUndefined;
+  widen_to_stages_ = !node_stage_.empty();
   return kTfLiteOk;
 }
 
 TfLiteStatus ArenaPlanner::ResetAllocationsAfter(int node) {
   TfLiteTensor* tensors = graph_info_->tensors();
   for (int i = 0; i < static_cast<int>(allocs_.size()); ++i) {
-    if (allocs_[i].first_node > node && allocs_[i].size > 0) {
+    // With widened lifetimes a tensor produced after `node` may have been
+    // allocated from an earlier node, so also check the node producing it.
+    const bool produced_after_node =
+        allocs_[i].first_node > node ||
+        (widen_to_stages_ && i < static_cast<int>(alloc_node_.size()) &&
+         alloc_node_[i] > node && alloc_node_[i] != kNodeNotAssigned);
+    if (produced_after_node && allocs_[i].size > 0) {
       TfLiteTensor& tensor = tensors[i];
       if (tensor.allocation_type == kTfLiteArenaRw) {
         allocs_[i].reset();
@@ -85,15 +259,41 @@ TfLiteStatus ArenaPlanner::ResetAllocationsAfter(int node) {
       }
     }
   }
-  if (last_active_node_ > node) {
+  if (last_active_node_ > node || widen_to_stages_) {
     arena_.CalculateActiveAllocs(allocs_, node);
   } else {
     arena_.PurgeAfter(node);
   }
   last_active_node_ = node;
+  // Incremental planning goes node by node, so the rest of the plan only
+  // supports sequential execution. Allocations kept from before are
+  // supersets of their sequential lifetimes, so they remain valid.
+  widen_to_stages_ = false;
   return kTfLiteOk;
 }
 
+void ArenaPlanner::SetPlanForConcurrentStages(bool value) {
+  plan_for_concurrent_stages_ = value;
+}
+
+int32_t ArenaPlanner::FirstNode(int32_t tensor_index) const {
+  const int32_t node = alloc_node_[tensor_index];
+  if (!widen_to_stages_ || node < 0 ||
+      node >= static_cast<int32_t>(node_stage_.size())) {
+    return node;
+  }
+  return stage_first_node_[node_stage_[node]];
+}
+
+int32_t ArenaPlanner::LastNode(int32_t tensor_index) const {
+  const int32_t node = dealloc_node_[tensor_index];
+  if (!widen_to_stages_ || node < 0 ||
+      node >= static_cast<int32_t>(node_stage_.size())) {
+    return node;
+  }
+  return stage_last_node_[node_stage_[node]];
+}
+
 int ArenaPlanner::FindSharedTensor(int tensor_index) {
   auto actual_tensor_it = actual_tensor_id_.find(tensor_index);
   if (actual_tensor_it != actual_tensor_id_.end()) {
@@ -333,6 +533,27 @@ TfLiteStatus ArenaPlanner::PlanAllocations() {
   }
   // Note that graph outputs will never be scheduled for deallocation. We
   // could do that here for completeness, but it won't have any effect.
+
+  // Nodes of the same stage may run at the same time, in any order. A tensor
+  // is then live from the first node of the stage producing it to the last
+  // node of the stage consuming it last, in execution plan order. Tensors
+  // live in a common stage get overlapping lifetimes and never share memory.
+  node_stage_.clear();
+  stage_first_node_.clear();
+  stage_last_node_.clear();
+  if (plan_for_concurrent_stages_ && !preserve_all_tensors_) {
+    node_stage_ = AssignConcurrentStages(graph_info_.get());
+    for (int i = 0; i < static_cast<int>(node_stage_.size()); ++i) {
+      const int stage = node_stage_[i];
+      if (stage >= static_cast<int>(stage_first_node_.size())) {
+        stage_first_node_.resize(stage + 1, i);
+        stage_last_node_.resize(stage + 1, i);
+      }
+      stage_first_node_[stage] = std::min(stage_first_node_[stage], i);
+      stage_last_node_[stage] = std::max(stage_last_node_[stage], i);
+    }
+  }
+  widen_to_stages_ = !node_stage_.empty();
   return kTfLiteOk;
 }
 
@@ -509,15 +730,22 @@ TfLiteStatus ArenaPlanner::CalculateAllocations(
     last_active_node_ = last_node;
     return kTfLiteOk;
   }
+  // The whole non-persistent arena is planned at once when planning starts
+  // from scratch, which is when the plan cache and offset search apply.
+  bool plan_whole_arena = false;
   if (first_node < last_active_node_) {
     arena_.ResetAllocs();
     last_active_node_ = first_node;
+    plan_whole_arena =
+        first_node == 0 && (optimize_offsets_ || plan_cache_size_ > 0);
   } else {
     // NOMUTANTS -- This function has no impact on the results, it only makes
     // exection faster.
     arena_.PurgeActiveAllocs(first_node);
   }
   CreateTensorAllocationVector(tensors_allocated);
+  // ArenaRw tensors owning their buffer, if the arena is planned at once.
+  std::vector<int32_t> arena_tensors;
   // Vector of ids of already allocated tensors, ordered by offset.
   for (const auto& tensor_index : *tensors_allocated) {
     TfLiteTensor& tensor = tensors[tensor_index];
@@ -541,10 +769,14 @@ TfLiteStatus ArenaPlanner::CalculateAllocations(
       }
     }
     if (tensor.allocation_type == kTfLiteArenaRw) {
-      TF_LITE_ENSURE_STATUS(
-          arena_.Allocate(context_, tensor_alignment_, tensor.bytes,
-                          tensor_index, alloc_node_[tensor_index],
-                          dealloc_node_[tensor_index], &allocs_[tensor_index]));
+      if (plan_whole_arena) {
+        arena_tensors.push_back(tensor_index);
+      } else {
+        TF_LITE_ENSURE_STATUS(arena_.Allocate(
+            context_, tensor_alignment_, tensor.bytes, tensor_index,
+            FirstNode(tensor_index), LastNode(tensor_index),
+            &allocs_[tensor_index]));
+      }
     }
     // Check allocs_[].size to prevent from reallocation of persistent tensors.
     // Only allocate ArenaRwPersistent tensors which own their buffer.
@@ -559,10 +791,84 @@ TfLiteStatus ArenaPlanner::CalculateAllocations(
       }
     }
   }
+  if (!arena_tensors.empty()) {
+    TF_LITE_ENSURE_STATUS(AllocateArenaTensors(arena_tensors));
+  }
   last_active_node_ = last_node;
   return kTfLiteOk;
 }
 
+void ArenaPlanner::SetPlanCacheSize(int size) {
+  plan_cache_size_ = std::max(size, 0);
+  while (plan_cache_.size() > plan_cache_size_) plan_cache_.pop_back();
+}
+
+TfLiteStatus ArenaPlanner::AllocateArenaTensors(
+    const std::vector<int32_t>& tensors) {
+  const TfLiteTensor* graph_tensors = graph_info_->tensors();
+  std::vector<size_t> key;
+  key.reserve(4 * tensors.size());
+  for (int32_t tensor_index : tensors) {
+    key.push_back(tensor_index);
+    key.push_back(graph_tensors[tensor_index].bytes);
+    key.push_back(FirstNode(tensor_index));
+    key.push_back(LastNode(tensor_index));
+  }
+
+  std::vector<size_t> offsets;
+  auto cached = std::find_if(
+      plan_cache_.begin(), plan_cache_.end(),
+      [&key](const CachedArenaPlan& plan) { return plan.key == key; });
+  if (cached != plan_cache_.end()) {
+    offsets = cached->offsets;
+    plan_cache_.splice(plan_cache_.begin(), plan_cache_, cached);
+  } else if (optimize_offsets_) {
+    std::vector<ArenaItem> items;
+    items.reserve(tensors.size());
+    size_t total_bytes = 0;
+    for (int32_t tensor_index : tensors) {
+      const size_t bytes = graph_tensors[tensor_index].bytes;
+      // Offsets never exceed the sum of all aligned sizes, so checking the
+      // sum once is enough to rule out overflow in the search.
+      TF_LITE_ENSURE(context_,
+                     bytes <= std::numeric_limits<size_t>::max() - total_bytes -
+                                  2 * tensor_alignment_);
+      total_bytes += AlignOffset(tensor_alignment_, bytes);
+      items.push_back({bytes, FirstNode(tensor_index), LastNode(tensor_index)});
+    }
+    offsets = SearchOffsets(
+        items, tensor_alignment_,
+        static_cast<int>(graph_info_->num_execution_nodes()));
+  }
+
+  if (offsets.empty()) {
+    // Cache miss without offset search: plan greedily as usual.
+    offsets.reserve(tensors.size());
+    for (int32_t tensor_index : tensors) {
+      TF_LITE_ENSURE_STATUS(arena_.Allocate(
+          context_, tensor_alignment_, graph_tensors[tensor_index].bytes,
+          tensor_index, FirstNode(tensor_index), LastNode(tensor_index),
+          &allocs_[tensor_index]));
+      offsets.push_back(allocs_[tensor_index].offset);
+    }
+  } else {
+    for (int i = 0; i < tensors.size(); ++i) {
+      const int32_t tensor_index = tensors[i];
+      TF_LITE_ENSURE_STATUS(arena_.AllocateAt(
+          context_, tensor_alignment_, offsets[i],
+          graph_tensors[tensor_index].bytes, tensor_index,
+          FirstNode(tensor_index), LastNode(tensor_index),
+          &allocs_[tensor_index]));
+    }
+  }
+
+  if (cached == plan_cache_.end() && plan_cache_size_ > 0) {
+    plan_cache_.push_front({std::move(key), std::move(offsets)});
+    if (plan_cache_.size() > plan_cache_size_) plan_cache_.pop_back();
+  }
+  return kTfLiteOk;
+}
+
 bool AreTensorsAllocatedInSameArena(int32_t root_tensor_index,
                                     int32_t tensor_index,
                                     const TfLiteTensor* tensors) {
@@ -17,6 +17,7 @@ limitations under the License.
 
 #include <cstddef>
 #include <cstdint>
+#include <list>
 #include <memory>
 #include <unordered_map>
 #include <unordered_set>
@@ -72,6 +73,27 @@ class ArenaPlanner : public MemoryPlanner {
   // Returns the base arena location for a given allocation type.
   std::intptr_t BasePointer(TfLiteAllocationType type);
 
+  // When enabled, offsets of the non-persistent arena are chosen by a bounded
+  // search over several allocation orders instead of a single greedy pass,
+  // which lowers the arena size at the cost of slower planning.
+  // WARNING: This is an experimental API and subject to change.
+  void SetOptimizeOffsets(bool value) { optimize_offsets_ = value; }
+
+  // Keeps the offsets of up to `size` recent plans of the non-persistent
+  // arena, keyed by the sizes and lifetimes of its tensors. Switching back to a
+  // previously seen set of input shapes then reuses the cached offsets instead
+  // of planning again. Zero disables the cache.
+  // WARNING: This is an experimental API and subject to change.
+  void SetPlanCacheSize(int size);
+
+  // When enabled, `PlanAllocations` groups the execution plan into stages with
+  // `AssignConcurrentStages` and extends tensor lifetimes to whole stages, so
+  // that the nodes of a stage may run concurrently. Must be set before
+  // `PlanAllocations`. The extension is dropped for the rest of the plan after
+  // `ResetAllocationsAfter`, which only supports sequential execution.
+  // WARNING: This is an experimental API and subject to change.
+  void SetPlanForConcurrentStages(bool value);
+
  private:
   // Check whether the input tensor's memory may be shared the output tensor.
   // tensor_changed: true if the output tensor modifies the tensor data. For
@@ -120,6 +142,16 @@ class ArenaPlanner : public MemoryPlanner {
   // Return the index of the tensor owing `tensor_index's` buffer.
   int FindSharedTensor(int tensor_index);
 
+  // Assigns offsets in `arena_` to all `tensors`, which must own their
+  // buffers, using the plan cache and the offset search if enabled.
+  // `tensors` are in the order produced by `CreateTensorAllocationVector`.
+  TfLiteStatus AllocateArenaTensors(const std::vector<int32_t>& tensors);
+
+  // First and last node of the lifetime of `tensor_index` used for arena
+  // allocations, extended to whole stages if planning for concurrent stages.
+  int32_t FirstNode(int32_t tensor_index) const;
+  int32_t LastNode(int32_t tensor_index) const;
+
   TfLiteContext* context_;
   std::unique_ptr<GraphInfo> graph_info_;
 
@@ -166,6 +198,30 @@ class ArenaPlanner : public MemoryPlanner {
 
   // Store number of references to each tensor.
   std::vector<int> refcounts_;
+
+  // If true, `AllocateArenaTensors` searches for a smaller arena.
+  bool optimize_offsets_ = false;
+
+  // A cached plan of the non-persistent arena. `key` holds the index, size,
+  // first node and last node of each planned tensor, which fully determine
+  // the resulting offsets.
+  struct CachedArenaPlan {
+    std::vector<size_t> key;
+    std::vector<size_t> offsets;
+  };
+  // Most recently used plans first.
+  std::list<CachedArenaPlan> plan_cache_;
+  int plan_cache_size_ = 0;
+
+  // If true, `PlanAllocations` computes the concurrent stages below.
+  bool plan_for_concurrent_stages_ = false;
+  // True while arena allocations use lifetimes extended to whole stages.
+  bool widen_to_stages_ = false;
+  // Stage of each node in the execution plan, and the first and last node of
+  // each stage. Empty unless planning for concurrent stages.
+  std::vector<int> node_stage_;
+  std::vector<int> stage_first_node_;
+  std::vector<int> stage_last_node_;
 };
 
 }  // namespace tflite
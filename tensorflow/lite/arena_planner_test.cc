@@ -1003,6 +1003,134 @@ TEST_F(ArenaPlannerTest, ComplexGraph) {
   EXPECT_EQ(GetOffset(8), 32);
 }
 
+// Builds the graph of `ComplexGraph` with the given tensor sizes.
+TestGraph* CreateComplexGraph(std::unique_ptr<TestGraph>* graph,
+                              const std::vector<int>& sizes) {
+  *graph = std::make_unique<TestGraph>(
+      std::initializer_list<int>{0},
+      std::initializer_list<TestOp>{
+          /* in, out, tmp */
+          {{0}, {1}, {}},
+          {{1}, {2}, {}},
+          {{1}, {3}, {}},
+          {{1}, {4}, {}},
+          {{2, 3, 4}, {5}, {}},
+          {{5}, {6}, {}},
+          {{5}, {7}, {}},
+          {{6, 7}, {8}, {}},
+      },
+      std::initializer_list<int>{8});
+  for (int i = 0; i < sizes.size(); ++i) {
+    (*(*graph)->tensors())[i].bytes = sizes[i];
+  }
+  return graph->get();
+}
+
+TEST_F(ArenaPlannerTest, OptimizedOffsetsShrinkArena) {
+  const std::vector<int> sizes = {20, 56, 16, 8, 28, 28, 48, 8, 4};
+  std::unique_ptr<TestGraph> graph;
+  size_t greedy_size, optimized_size, persistent_size;
+
+  SetGraph(CreateComplexGraph(&graph, sizes));
+  Execute(0, graph->nodes().size() - 1);
+  planner_->GetAllocInfo(&greedy_size, &persistent_size);
+
+  SetGraph(CreateComplexGraph(&graph, sizes));
+  planner_->SetOptimizeOffsets(true);
+  Execute(0, graph->nodes().size() - 1);
+  planner_->GetAllocInfo(&optimized_size, &persistent_size);
+  EXPECT_EQ(greedy_size, 156);
+  EXPECT_EQ(optimized_size, 128);
+
+  // Tensors alive at the same time must not overlap. Tensor 5 shares the
+  // buffer of tensor 2.
+  const std::vector<std::pair<int, int>> lifetimes = {
+      {0, 8}, {0, 3}, {1, 4}, {2, 4}, {3, 4}, {4, 6}, {5, 7}, {6, 7}, {7, 8}};
+  for (int i = 0; i < lifetimes.size(); ++i) {
+    for (int j = i + 1; j < lifetimes.size(); ++j) {
+      if (lifetimes[i].second < lifetimes[j].first ||
+          lifetimes[j].second < lifetimes[i].first ||
+          (i == 2 && j == 5)) {
+        continue;
+      }
+      EXPECT_TRUE(GetOffset(i) + sizes[i] <= GetOffset(j) ||
+                  GetOffset(j) + sizes[j] <= GetOffset(i))
+          << "tensors " << i << " and " << j << " overlap";
+    }
+  }
+}
+
+TEST_F(ArenaPlannerTest, ConcurrentStagesKeepTensorsApart) {
+  // Two branches interleaved in the execution plan. Nodes 0 and 2 form the
+  // first stage, nodes 1 and 3 the second one.
+  TestGraph graph({0},
+                  {
+                      /* in, out, tmp */
+                      {{0}, {1}, {}, kTfLiteBuiltinAdd, kTfLiteInplaceOpNone},
+                      {{1}, {2}, {}, kTfLiteBuiltinAdd, kTfLiteInplaceOpNone},
+                      {{0}, {3}, {}, kTfLiteBuiltinAdd, kTfLiteInplaceOpNone},
+                      {{3}, {4}, {}, kTfLiteBuiltinAdd, kTfLiteInplaceOpNone},
+                      {{2, 4}, {5}, {}, kTfLiteBuiltinAdd,
+                       kTfLiteInplaceOpNone},
+                  },
+                  {5});
+  for (int i = 0; i < 6; ++i) (*graph.tensors())[i].bytes = 16;
+  SetGraph(&graph);
+  Execute(0, graph.nodes().size() - 1);
+  // Run in order, tensor 3 can reuse the buffer of tensor 1.
+  EXPECT_EQ(GetOffset(1), GetOffset(3));
+
+  planner_->SetPlanForConcurrentStages(true);
+  ASSERT_EQ(planner_->PlanAllocations(), kTfLiteOk);
+  Execute(0, graph.nodes().size() - 1);
+  auto overlap = [this](int a, int b) {
+    return GetOffset(a) < GetOffsetAfter(b) && GetOffset(b) < GetOffsetAfter(a);
+  };
+  EXPECT_FALSE(overlap(1, 3));
+  EXPECT_FALSE(overlap(1, 4));
+  EXPECT_FALSE(overlap(2, 3));
+  EXPECT_FALSE(overlap(2, 4));
+  // Tensor 5 is produced after the branches, so it may reuse their memory.
+  size_t arena_size, persistent_size;
+  planner_->GetAllocInfo(&arena_size, &persistent_size);
+  EXPECT_EQ(arena_size, 5 * 16);
+}
+
+TEST_F(ArenaPlannerTest, PlanCacheReusesOffsets) {
+  const std::vector<int> sizes_a = {20, 56, 16, 8, 28, 28, 48, 8, 4};
+  const std::vector<int> sizes_b = {40, 12, 12, 64, 8, 12, 16, 32, 8};
+  std::unique_ptr<TestGraph> graph_a;
+  std::unique_ptr<TestGraph> graph_b;
+  std::unique_ptr<TestGraph> graph_a2;
+  CreateComplexGraph(&graph_b, sizes_b);
+  CreateComplexGraph(&graph_a2, sizes_a);
+
+  SetGraph(CreateComplexGraph(&graph_a, sizes_a));
+  planner_->SetOptimizeOffsets(true);
+  planner_->SetPlanCacheSize(2);
+  Execute(0, graph_a->nodes().size() - 1);
+  std::vector<std::ptrdiff_t> offsets_a;
+  for (int i = 0; i < sizes_a.size(); ++i) offsets_a.push_back(GetOffset(i));
+
+  // Simulate `ResizeInputTensor` followed by `AllocateTensors`.
+  SwapGraph(graph_b.get());
+  ResetAllocations();
+  Execute(0, graph_->nodes().size() - 1);
+  for (int i = 0; i < sizes_b.size(); ++i) {
+    EXPECT_EQ((*graph_->tensors())[i].bytes, sizes_b[i]);
+  }
+
+  // Switching back to the first shapes reuses the cached offsets, even with
+  // the offset search disabled.
+  planner_->SetOptimizeOffsets(false);
+  SwapGraph(graph_a2.get());
+  ResetAllocations();
+  Execute(0, graph_->nodes().size() - 1);
+  for (int i = 0; i < sizes_a.size(); ++i) {
+    EXPECT_EQ(GetOffset(i), offsets_a[i]) << "tensor " << i;
+  }
+}
+
 TEST_F(ArenaPlannerTest, GraphWithIntermediates) {
   TestGraph graph({0, 1},
                   {
@@ -35,6 +35,7 @@ limitations under the License.
 #include "tensorflow/lite/core/signature_runner.h"
 #include "tensorflow/lite/core/subgraph.h"
 #include "tensorflow/lite/external_cpu_backend_context.h"
+#include "tensorflow/lite/inter_op_thread_pool.h"
 #include "tensorflow/lite/internal/signature_def.h"
 #include "tensorflow/lite/interpreter_options.h"
 #include "tensorflow/lite/logger.h"
@@ -210,6 +211,7 @@ void Interpreter::AddSubgraphs(int subgraphs_to_add,
     if (allocator_ != nullptr) {
       subgraph->SetAllocator(allocator_);
     }
+    subgraph->SetInterOpThreadPool(inter_op_thread_pool_.get());
     subgraphs_.emplace_back(std::move(subgraph));
   }
 }
@@ -532,9 +534,20 @@ TfLiteStatus Interpreter::ApplyOptionsImpl(InterpreterOptions* options) {
   }
   options_ = std::make_unique<InterpreterOptions>(*options);
 
+  const int num_inter_op_threads = options_->GetNumInterOpThreads();
+  if (num_inter_op_threads > 1 &&
+      (!inter_op_thread_pool_ ||
+       inter_op_thread_pool_->num_threads() != num_inter_op_threads)) {
+    inter_op_thread_pool_ =
+        std::make_unique<InterOpThreadPool>(num_inter_op_threads);
+  } else if (num_inter_op_threads <= 1) {
+    inter_op_thread_pool_.reset();
+  }
+
   // Set InterpreterOptions object to SubGraph.
   for (auto& subgraph : subgraphs_) {
     subgraph->SetOptions(options_.get());
+    subgraph->SetInterOpThreadPool(inter_op_thread_pool_.get());
   }
   return kTfLiteOk;
 }
@@ -52,6 +52,7 @@ limitations under the License.
 #include "tensorflow/lite/experimental/resource/initialization_status.h"
 #include "tensorflow/lite/experimental/resource/resource_base.h"
 #include "tensorflow/lite/external_cpu_backend_context.h"
+#include "tensorflow/lite/inter_op_thread_pool.h"
 #include "tensorflow/lite/internal/signature_def.h"
 #include "tensorflow/lite/interpreter_options.h"
 #include "tensorflow/lite/portable_type_to_tflitetype.h"
@@ -1064,6 +1065,10 @@ class Interpreter {
   // nullptr if necessary.
   std::unique_ptr<ExternalCpuBackendContext> own_external_cpu_backend_context_;
 
+  // Pool shared by all subgraphs to run independent nodes concurrently, if
+  // `InterpreterOptions::SetNumInterOpThreads` asked for more than one thread.
+  std::unique_ptr<InterOpThreadPool> inter_op_thread_pool_;
+
   // Subgraphs
   std::vector<std::unique_ptr<Subgraph>> subgraphs_;
 
@@ -47,6 +47,7 @@ limitations under the License.
 #include "tensorflow/lite/experimental/resource/initialization_status.h"
 #include "tensorflow/lite/experimental/resource/resource_base.h"
 #include "tensorflow/lite/graph_info.h"
+#include "tensorflow/lite/inter_op_thread_pool.h"
 #include "tensorflow/lite/logger.h"
 #include "tensorflow/lite/memory_planner.h"
 #include "tensorflow/lite/minimal_logging.h"
@@ -637,6 +638,13 @@ TfLiteStatus Subgraph::ReplaceNodeSubsetsWithDelegateKernels(
 
 TfLiteExternalContext* Subgraph::GetExternalContext(
     TfLiteExternalContextType type) {
+  if (type == kTfLiteCpuBackendContext) {
+    // Kernels running on an inter-op worker use the worker's own context, as
+    // the cpu backend context does not support concurrent use.
+    TfLiteExternalContext* worker_context =
+        InterOpThreadPool::CurrentCpuBackendContext();
+    if (worker_context != nullptr) return worker_context;
+  }
   if (static_cast<int>(type) >= 0 && type < kTfLiteMaxExternalContexts) {
     return external_contexts_[type];
   }
@@ -1602,13 +1610,27 @@ TfLiteStatus Subgraph::PrepareOpsAndTensors() {
 #ifdef TFLITE_USE_SIMPLE_MEMORY_PLANNER
     memory_planner_.reset(new SimplePlanner(&context_, CreateGraphInfo()));
 #else
-    memory_planner_ = std::make_unique<ArenaPlanner>(
+    auto arena_planner = std::make_unique<ArenaPlanner>(
         &context_, CreateGraphInfo(), ShouldPreserveAllTensors(),
         kDefaultTensorAlignment, subgraph_index_, allocator_);
+    if (options_) {
+      arena_planner->SetOptimizeOffsets(options_->GetOptimizeMemoryPlan());
+      arena_planner->SetPlanCacheSize(options_->GetMemoryPlanCacheSize());
+      memory_planned_for_concurrency_ = options_->GetNumInterOpThreads() > 1 &&
+                                        !ShouldPreserveAllTensors();
+      arena_planner->SetPlanForConcurrentStages(
+          memory_planned_for_concurrency_);
+    }
+    memory_planner_ = std::move(arena_planner);
 #endif
     memory_planner_->PlanAllocations();
   }
 
+  if (next_execution_plan_index_to_plan_allocation_ == 0) {
+    invoked_since_planning_ = false;
+    concurrent_stages_.clear();
+  }
+
   // Execute arena allocations.
   TF_LITE_ENSURE_STATUS(memory_planner_->ExecuteAllocations(
       next_execution_plan_index_to_plan_allocation_,
@@ -1658,6 +1680,43 @@ TfLiteStatus Subgraph::RemoveUnusedInputs() {
   return kTfLiteOk;
 }
 
+TfLiteStatus Subgraph::EnsureNodeInputsReadable(
+    const TfLiteNode& node, const TfLiteRegistration& registration) {
+  for (int i = 0; i < node.inputs->size; ++i) {
+    int tensor_index = node.inputs->data[i];
+    if (tensor_index == kTfLiteOptionalTensor) {
+      continue;
+    }
+    TfLiteTensor* tensor = &tensors_[tensor_index];
+    if (tensor->delegate && tensor->delegate != node.delegate &&
+        tensor->data_is_stale) {
+      TF_LITE_ENSURE_STATUS(EnsureTensorDataIsReadable(tensor_index));
+    }
+    if (tensor->data.raw == nullptr && tensor->bytes > 0 &&
+        tensor->allocation_type != kTfLiteNonCpu) {
+      if (registration.builtin_code == kTfLiteBuiltinReshape && i == 1 &&
+          tensor->dims->size != 1) {
+        // In general, having a tensor here with no buffer will be an error.
+        // However, for the reshape operator, the second input tensor is
+        // sometimes only used for the shape, not for the data. Thus, null
+        // buffer is ok in this situation.
+        // The situation where null buffer is not ok for reshape operator is
+        // only when there are 2 inputs given to the node and the one
+        // corresponding to the shape (i == 1) is a vector that contains all
+        // dimensions. See `GetOutputShape()` function in
+        // `tensorflow/lite/kernels/reshape.cc`
+        continue;
+      } else {
+        // In all other cases, we need to return an error as otherwise we will
+        // trigger a null pointer dereference (likely).
+        ReportError("Input tensor %d lacks data", tensor_index);
+        return kTfLiteError;
+      }
+    }
+  }
+  return kTfLiteOk;
+}
+
 TfLiteStatus Subgraph::Invoke() {
   auto status = InvokeImpl();
   telemetry::TelemetryReportEvent(&context_, "Invoke", status);
@@ -1684,6 +1743,14 @@ TfLiteStatus Subgraph::InvokeImpl() {
       tflite::OnTfLiteSubgraphInvoke(name_.c_str(), subgraph_index_);
 #endif  // TF_LITE_TENSORFLOW_PROFILER
 
+  if (CanInvokeConcurrently()) {
+    status = InvokeConcurrently();
+#ifdef TF_LITE_TENSORFLOW_PROFILER
+    tflite::OnTfLiteSubgraphInvokeEnd(trace_subgraph);
+#endif  // TF_LITE_TENSORFLOW_PROFILER
+    return status;
+  }
+
   // Invocations are always done in node order.
   // Note that calling Invoke repeatedly will cause the original memory plan to
   // be reused, unless either ResizeInputTensor() or AllocateTensors() has been
@@ -1722,38 +1789,7 @@ TfLiteStatus Subgraph::InvokeImpl() {
     TFLITE_SCOPED_TAGGED_OPERATOR_PROFILE(
         profile_op ? profiler_.get() : nullptr, op_name, node_index);
 
-    for (int i = 0; i < node.inputs->size; ++i) {
-      int tensor_index = node.inputs->data[i];
-      if (tensor_index == kTfLiteOptionalTensor) {
-        continue;
-      }
-      TfLiteTensor* tensor = &tensors_[tensor_index];
-      if (tensor->delegate && tensor->delegate != node.delegate &&
-          tensor->data_is_stale) {
-        TF_LITE_ENSURE_STATUS(EnsureTensorDataIsReadable(tensor_index));
-      }
-      if (tensor->data.raw == nullptr && tensor->bytes > 0 &&
-          tensor->allocation_type != kTfLiteNonCpu) {
-        if (registration.builtin_code == kTfLiteBuiltinReshape && i == 1 &&
-            tensor->dims->size != 1) {
-          // In general, having a tensor here with no buffer will be an error.
-          // However, for the reshape operator, the second input tensor is
-          // sometimes only used for the shape, not for the data. Thus, null
-          // buffer is ok in this situation.
-          // The situation where null buffer is not ok for reshape operator is
-          // only when there are 2 inputs given to the node and the one
-          // corresponding to the shape (i == 1) is a vector that contains all
-          // dimensions. See `GetOutputShape()` function in
-          // `tensorflow/lite/kernels/reshape.cc`
-          continue;
-        } else {
-          // In all other cases, we need to return an error as otherwise we will
-          // trigger a null pointer dereference (likely).
-          ReportError("Input tensor %d lacks data", tensor_index);
-          return kTfLiteError;
-        }
-      }
-    }
+    TF_LITE_ENSURE_STATUS(EnsureNodeInputsReadable(node, registration));
     // Allocate dynamic tensors which memory is required to be allocated
     // before executing the node.
     MayAllocateOpOutput(&node);
@@ -1807,9 +1843,77 @@ TfLiteStatus Subgraph::InvokeImpl() {
 #ifdef TF_LITE_TENSORFLOW_PROFILER
   tflite::OnTfLiteSubgraphInvokeEnd(trace_subgraph);
 #endif  // TF_LITE_TENSORFLOW_PROFILER
+  invoked_since_planning_ = true;
   return status;
 }
 
+bool Subgraph::CanInvokeConcurrently() const {
+  return inter_op_thread_pool_ != nullptr &&
+         inter_op_thread_pool_->num_threads() > 1 &&
+         memory_planned_for_concurrency_ && invoked_since_planning_ &&
+         !has_dynamic_tensors_ &&
+         next_execution_plan_index_to_prepare_ == execution_plan_.size() &&
+         next_execution_plan_index_to_plan_allocation_ ==
+             execution_plan_.size() &&
+         profiler_ == nullptr &&
+         !(options_ && options_->GetDynamicAllocationForLargeTensors() > 0) &&
+         (control_edges_ == nullptr || control_edges_->empty());
+}
+
+TfLiteStatus Subgraph::InvokeConcurrently() {
+  if (concurrent_stages_.empty()) {
+    const std::vector<int> node_stages =
+        AssignConcurrentStages(CreateGraphInfo().get());
+    for (int i = 0; i < node_stages.size(); ++i) {
+      if (node_stages[i] >= concurrent_stages_.size()) {
+        concurrent_stages_.resize(node_stages[i] + 1);
+      }
+      concurrent_stages_[node_stages[i]].push_back(i);
+    }
+  }
+  EnsureTensorsVectorCapacity();
+
+  std::vector<TfLiteStatus> statuses;
+  for (const std::vector<int>& stage : concurrent_stages_) {
+    for (int execution_plan_index : stage) {
+      const int node_index = execution_plan_[execution_plan_index];
+      TfLiteNode& node = nodes_and_registration_[node_index].first;
+      TF_LITE_ENSURE_STATUS(EnsureNodeInputsReadable(
+          node, nodes_and_registration_[node_index].second));
+    }
+
+    if (check_cancelled_func_ != nullptr &&
+        check_cancelled_func_(cancellation_data_)) {
+      ReportError("Client requested cancel during Invoke()");
+      return kTfLiteError;
+    }
+
+    if (continue_invocation_ && !continue_invocation_->test_and_set()) {
+      // `Cancel` is called and cancellation flag is flipped.
+      ReportError("Client requested cancel during Invoke()");
+      return kTfLiteCancelled;
+    }
+
+    statuses.assign(stage.size(), kTfLiteOk);
+    inter_op_thread_pool_->ParallelFor(stage.size(), [&](int i) {
+      const int node_index = execution_plan_[stage[i]];
+      auto& [node, registration] = nodes_and_registration_[node_index];
+      statuses[i] = OpInvoke(registration, &node);
+    });
+
+    // Errors are reported on the calling thread, in execution plan order.
+    for (int i = 0; i < stage.size(); ++i) {
+      if (statuses[i] == kTfLiteOk) continue;
+      const int node_index = execution_plan_[stage[i]];
+      const auto& [node, registration] = nodes_and_registration_[node_index];
+      auto err = ReportOpError(&context_, node, registration, node_index,
+                               "failed to invoke");
+      return statuses[i] == kTfLiteCancelled ? statuses[i] : err;
+    }
+  }
+  return kTfLiteOk;
+}
+
 TfLiteStatus Subgraph::ResizeTensor(TfLiteContext* context,
                                     TfLiteTensor* tensor,
                                     TfLiteIntArray* new_size) {
@@ -47,6 +47,8 @@ limitations under the License.
 
 namespace tflite {
 
+class InterOpThreadPool;
+
 #ifndef DOXYGEN_SKIP
 class SingleOpModel;  // Class for friend declarations.
 
@@ -499,6 +501,14 @@ class Subgraph {
   // WARNING: This is an experimental API and subject to change.
   const InterpreterOptions* GetOptions() const { return options_; }
 
+  // WARNING: This is an experimental API and subject to change.
+  // Sets the pool used to run independent nodes concurrently when
+  // `InterpreterOptions::GetNumInterOpThreads()` is greater than one. The pool
+  // is owned by the interpreter and shared by its subgraphs.
+  void SetInterOpThreadPool(InterOpThreadPool* pool) {
+    inter_op_thread_pool_ = pool;
+  }
+
   // WARNING: This is an experimental API and subject to change.
   // True if all intermediates tensors should be preserved for debugging.
   bool ShouldPreserveAllTensors() const {
@@ -812,6 +822,22 @@ class Subgraph {
   // Does not report invoke status through profiler.
   TfLiteStatus InvokeImpl();
 
+  // Returns true if the next invocation may run the stages computed by
+  // `AssignConcurrentStages` on `inter_op_thread_pool_`. This requires a
+  // static graph that is fully prepared, a memory plan made for concurrent
+  // stages, and one sequential invocation since planning so that kernels
+  // finish their lazy initialization on a single thread.
+  bool CanInvokeConcurrently() const;
+
+  // Runs the execution plan stage by stage, running the nodes of each stage
+  // concurrently on `inter_op_thread_pool_`.
+  TfLiteStatus InvokeConcurrently();
+
+  // Checks that the inputs of `node` can be read by the kernel, copying data
+  // back from delegate buffers if needed.
+  TfLiteStatus EnsureNodeInputsReadable(const TfLiteNode& node,
+                                        const TfLiteRegistration& registration);
+
   // Allow a delegate to look at the graph and modify the graph to handle
   // parts of the graph themselves. After this is called, the graph may
   // contain new nodes that replace 1 more nodes.
@@ -1250,6 +1276,22 @@ class Subgraph {
   // `InterpreterOptions` object which is being used and owned by Interpreter.
   InterpreterOptions* options_;
 
+  // Pool running independent nodes concurrently, owned by the Interpreter.
+  // Null if inter-op parallelism is disabled.
+  InterOpThreadPool* inter_op_thread_pool_ = nullptr;
+
+  // True if the memory planner extends tensor lifetimes to the concurrent
+  // stages of the execution plan.
+  bool memory_planned_for_concurrency_ = false;
+
+  // True once the subgraph was invoked sequentially since it was last planned
+  // from the first node.
+  bool invoked_since_planning_ = false;
+
+  // Execution plan indices of the nodes of each concurrent stage, computed on
+  // the first concurrent invocation after planning.
+  std::vector<std::vector<int>> concurrent_stages_;
+
   // Control edges (i.e., dependencies between nodes in addition to their data
   // dependencies); can be nullptr. Will be initialized from metadata associated
   // with the owning interpreter; the pointee is owned by the owning
@@ -17,11 +17,14 @@ limitations under the License.
 #include <cstddef>
 #include <cstdint>
 #include <cstring>
+#include <memory>
+#include <string>
 
 #include "flatbuffers/flexbuffers.h"
 #include "tensorflow/lite/core/c/common.h"
 #include "tensorflow/lite/core/subgraph.h"
 #include "tensorflow/lite/experimental/resource/cache_buffer.h"
+#include "tensorflow/lite/experimental/resource/paged_cache_buffer.h"
 #include "tensorflow/lite/experimental/resource/resource_base.h"
 #include "tensorflow/lite/kernels/internal/runtime_shape.h"
 #include "tensorflow/lite/kernels/internal/tensor_ctypes.h"
@@ -44,12 +47,25 @@ static const int kDefaultTransformerLayerId = 0;
 
 static const int KVCACHE_KEY_RESOURCE = 42;
 static const int KVCACHE_VALUE_RESOURCE = 43;
+// In paged mode, layer i keeps its cache in resource
+// KVCACHE_PAGED_RESOURCE_BASE + i.
+static const int KVCACHE_PAGED_RESOURCE_BASE = 1 << 20;
 
 struct OpData {
   int num_layers;
   int layer_index;
   int max_num_entries;
   int first_slot_index;
+  // Paged mode is enabled by a positive `kv_cache_block_size` option. The
+  // outputs are then resource handles of a PagedCacheBuffer instead of full
+  // dense caches, and memory is drawn block by block from a KVBlockPool shared
+  // by all layers. The pool holds at most `kv_cache_pool_blocks` blocks
+  // (default: enough for every layer to hold `kv_cache_max` entries), and is
+  // shared across interpreters when `kv_cache_pool_name` is set.
+  int block_size;
+  int pool_blocks;
+  std::string pool_name;
+  resource::PagedCacheBuffer* paged_cache;
   // Pointers to the key and value cache buffers that this Op doesn't own
   // (and therefore does not free on destruction of this Op).
   resource::CacheBuffer* key_cache_buffer;
@@ -72,9 +88,89 @@ void* KVCacheInit(TfLiteContext* context, const char* buffer, size_t length) {
   op_data->is_initialized = false;
   op_data->key_cache_ptr = nullptr;
   op_data->value_cache_ptr = nullptr;
+  op_data->block_size = 0;
+  op_data->pool_blocks = 0;
+  op_data->paged_cache = nullptr;
   return op_data;
 }
 
+// Returns the block pool used by the paged caches of other layers in this
+// subgraph, if any.
+std::shared_ptr<resource::KVBlockPool> FindSubgraphPool(
+    resource::ResourceMap* resources, int num_layers) {
+  for (int i = 0; i < num_layers; ++i) {
+    auto* cache = resource::GetTypedResource<resource::PagedCacheBuffer>(
+        resources, KVCACHE_PAGED_RESOURCE_BASE + i,
+        resource::ResourceBase::ResourceType::kPagedCacheBuffer);
+    if (cache != nullptr) return cache->shared_pool();
+  }
+  return nullptr;
+}
+
+TfLiteStatus PreparePagedOutput(TfLiteContext* context, TfLiteTensor* output,
+                                int resource_id) {
+  output->type = kTfLiteResource;
+  output->allocation_type = kTfLiteDynamic;
+  TfLiteIntArray* dims = TfLiteIntArrayCreate(1);
+  dims->data[0] = 1;
+  TF_LITE_ENSURE_OK(context, context->ResizeTensor(context, output, dims));
+  TF_LITE_ENSURE_OK(context, TfLiteTensorRealloc(sizeof(int32_t), output));
+  output->bytes = sizeof(int32_t);
+  output->data.i32[0] = resource_id;
+  return kTfLiteOk;
+}
+
+TfLiteStatus KVCachePreparePaged(TfLiteContext* context, TfLiteNode* node,
+                                 OpData* op_data, const TfLiteTensor* key) {
+  const int num_heads = key->dims->data[2];
+  const int head_dim = key->dims->data[3];
+  const size_t block_elements =
+      2 * static_cast<size_t>(op_data->block_size) * num_heads * head_dim;
+  const int resource_id = KVCACHE_PAGED_RESOURCE_BASE + op_data->layer_index;
+
+  Subgraph* subgraph = reinterpret_cast<Subgraph*>(context->impl_);
+  auto& resources = subgraph->resources();
+  TF_LITE_ENSURE_OK(
+      context,
+      resource::CreateTypedResourceIfNotAvailable(
+          &resources, resource_id,
+          resource::ResourceBase::ResourceType::kPagedCacheBuffer,
+          [&]() -> std::unique_ptr<resource::PagedCacheBuffer> {
+            std::shared_ptr<resource::KVBlockPool> pool;
+            if (!op_data->pool_name.empty()) {
+              pool = resource::KVBlockPool::GetOrCreateShared(
+                  op_data->pool_name, op_data->pool_blocks, block_elements);
+            } else {
+              pool = FindSubgraphPool(&resources, op_data->num_layers);
+              if (pool == nullptr) {
+                pool = std::make_shared<resource::KVBlockPool>(
+                    op_data->pool_blocks, block_elements);
+              }
+            }
+            if (pool == nullptr || pool->block_elements() != block_elements) {
+              return nullptr;
+            }
+            return std::make_unique<resource::PagedCacheBuffer>(
+                std::move(pool), op_data->block_size, num_heads, head_dim);
+          }));
+  op_data->paged_cache = resource::GetTypedResource<resource::PagedCacheBuffer>(
+      &resources, resource_id,
+      resource::ResourceBase::ResourceType::kPagedCacheBuffer);
+  TF_LITE_ENSURE(context, op_data->paged_cache != nullptr);
+  TF_LITE_ENSURE_EQ(context, op_data->paged_cache->num_heads(), num_heads);
+  TF_LITE_ENSURE_EQ(context, op_data->paged_cache->head_dim(), head_dim);
+
+  TfLiteTensor* kfull;
+  TfLiteTensor* vfull;
+  TF_LITE_ENSURE_OK(context,
+                    GetOutputSafe(context, node, kFullKeyTensor, &kfull));
+  TF_LITE_ENSURE_OK(context,
+                    GetOutputSafe(context, node, kFullValueTensor, &vfull));
+  TF_LITE_ENSURE_OK(context, PreparePagedOutput(context, kfull, resource_id));
+  TF_LITE_ENSURE_OK(context, PreparePagedOutput(context, vfull, resource_id));
+  return kTfLiteOk;
+}
+
 TfLiteStatus KVCachePrepare(TfLiteContext* context, TfLiteNode* node) {
   TF_LITE_ENSURE_EQ(context, NumInputs(node), 3);
   TF_LITE_ENSURE_EQ(context, NumOutputs(node), 2);
@@ -96,6 +192,17 @@ TfLiteStatus KVCachePrepare(TfLiteContext* context, TfLiteNode* node) {
     op_data->layer_index =
         layer_index > 0 ? layer_index : kDefaultTransformerLayerId;
     op_data->first_slot_index = 0;
+    int32_t block_size = flexbuffer_map["kv_cache_block_size"].AsInt32();
+    if (block_size > 0) {
+      const int blocks_per_layer =
+          (op_data->max_num_entries + block_size - 1) / block_size;
+      int32_t pool_blocks = flexbuffer_map["kv_cache_pool_blocks"].AsInt32();
+      op_data->block_size = block_size;
+      op_data->pool_blocks = pool_blocks > 0
+                                 ? pool_blocks
+                                 : blocks_per_layer * op_data->num_layers;
+      op_data->pool_name = flexbuffer_map["kv_cache_pool_name"].AsString().str();
+    }
     op_data->is_initialized = true;
   }
 
@@ -121,6 +228,10 @@ TfLiteStatus KVCachePrepare(TfLiteContext* context, TfLiteNode* node) {
   TF_LITE_ENSURE(context, GetTensorShape(key).Dims(0) == 1);
   TF_LITE_ENSURE(context, HaveSameShapes(key, value));
 
+  if (op_data->block_size > 0) {
+    return KVCachePreparePaged(context, node, op_data, key);
+  }
+
   // Create the key and value caches. Currently statically sized.
   TfLiteTensor* kfull;
   TfLiteTensor* vfull;
@@ -227,6 +338,65 @@ void KVCacheFree(TfLiteContext* context, void* buffer) {
   delete static_cast<OpData*>(buffer);
 }
 
+TfLiteStatus KVCacheEvalPaged(TfLiteContext* context, TfLiteNode* node,
+                              OpData* op_data) {
+  const TfLiteTensor* position;
+  TF_LITE_ENSURE_OK(context,
+                    GetInputSafe(context, node, kPositionTensor, &position));
+  const TfLiteTensor* key;
+  TF_LITE_ENSURE_OK(context, GetInputSafe(context, node, kKeyTensor, &key));
+  const TfLiteTensor* value;
+  TF_LITE_ENSURE_OK(context, GetInputSafe(context, node, kValueTensor, &value));
+  resource::PagedCacheBuffer* cache = op_data->paged_cache;
+
+  const int64_t max_num_entries = op_data->max_num_entries;
+  const int64_t num_slots_needed = GetTensorShape(key).Dims(1);
+  const int elements_in_one_entry = cache->num_heads() * cache->head_dim();
+  const size_t num_bytes_per_tensor = sizeof(float) * elements_in_one_entry;
+
+  TF_LITE_ENSURE(context, num_slots_needed <= max_num_entries);
+
+  // Same sliding window as the dense cache, but evicting the oldest entries
+  // returns their blocks to the pool instead of shifting the whole cache.
+  const int64_t input_first_idx = position->data.i64[0];
+  const int64_t input_last_idx = input_first_idx + num_slots_needed - 1;
+  const int64_t cache_last_slot_idx =
+      op_data->first_slot_index + max_num_entries - 1;
+  if (input_first_idx < op_data->first_slot_index) {
+    TF_LITE_KERNEL_LOG(
+        context,
+        "Can not specify a position before this cache's first slot index of %d",
+        op_data->first_slot_index);
+    return kTfLiteError;
+  }
+  const int64_t slots_to_shift =
+      std::max(static_cast<int64_t>(0), input_last_idx - cache_last_slot_idx);
+  if (slots_to_shift >= max_num_entries) {
+    cache->Clear();
+  } else if (slots_to_shift > 0) {
+    cache->DropFront(slots_to_shift);
+  }
+  op_data->first_slot_index += slots_to_shift;
+
+  const int64_t first_slot = input_first_idx - op_data->first_slot_index;
+  if (cache->Reserve(first_slot + num_slots_needed) != kTfLiteOk) {
+    TF_LITE_KERNEL_LOG(context,
+                       "KV cache block pool exhausted: all %d blocks are in "
+                       "use.",
+                       cache->pool().max_blocks());
+    return kTfLiteError;
+  }
+  for (int64_t i = 0; i < num_slots_needed; ++i) {
+    const size_t input_offset = i * elements_in_one_entry;
+    memcpy(cache->GetKey(first_slot + i), key->data.f + input_offset,
+           num_bytes_per_tensor);
+    memcpy(cache->GetValue(first_slot + i), value->data.f + input_offset,
+           num_bytes_per_tensor);
+  }
+  cache->SetNumEntries(first_slot + num_slots_needed);
+  return kTfLiteOk;
+}
+
 TfLiteStatus KVCacheEval(TfLiteContext* context, TfLiteNode* node) {
   const TfLiteTensor* position;
   TF_LITE_ENSURE_OK(context,
@@ -235,6 +405,10 @@ TfLiteStatus KVCacheEval(TfLiteContext* context, TfLiteNode* node) {
   TF_LITE_ENSURE_OK(context, GetInputSafe(context, node, kKeyTensor, &key));
   const TfLiteTensor* value;
   TF_LITE_ENSURE_OK(context, GetInputSafe(context, node, kValueTensor, &value));
+  OpData* op_data = reinterpret_cast<OpData*>(node->user_data);
+  if (op_data->block_size > 0) {
+    return KVCacheEvalPaged(context, node, op_data);
+  }
 
   // Prepare the outputs.
   TfLiteTensor* kfull;
@@ -243,7 +417,6 @@ TfLiteStatus KVCacheEval(TfLiteContext* context, TfLiteNode* node) {
                     GetOutputSafe(context, node, kFullKeyTensor, &kfull));
   TF_LITE_ENSURE_OK(context,
                     GetOutputSafe(context, node, kFullValueTensor, &vfull));
-  OpData* op_data = reinterpret_cast<OpData*>(node->user_data);
 
   float* key_cache_ptr = op_data->key_cache_buffer->GetBuffer();
   float* value_cache_ptr = op_data->value_cache_buffer->GetBuffer();
@@ -17,8 +17,12 @@ limitations under the License.
 #include <vector>
 
 #include <gtest/gtest.h>
+#include "flatbuffers/flexbuffers.h"  // from @flatbuffers
 #include "tensorflow/lite/c/c_api_types.h"
+#include "tensorflow/lite/core/subgraph.h"
 #include "tensorflow/lite/experimental/genai/genai_ops.h"
+#include "tensorflow/lite/experimental/resource/paged_cache_buffer.h"
+#include "tensorflow/lite/experimental/resource/resource_base.h"
 #include "tensorflow/lite/kernels/test_util.h"
 #include "tensorflow/lite/schema/schema_generated.h"
 
@@ -77,6 +81,125 @@ class SimpleCacheOpModel : public SingleOpModel {
   int vfull_;
 };
 
+// A KV cache op in paged mode. Its outputs are resource handles of the
+// layer's PagedCacheBuffer.
+class PagedCacheOpModel : public SingleOpModel {
+ public:
+  PagedCacheOpModel(const TensorData& pos_tensor, const TensorData& k_tensor,
+                    const TensorData& v_tensor, int max_num_entries,
+                    int block_size, int pool_blocks) {
+    pos_ = AddInput(pos_tensor);
+    k_ = AddInput(k_tensor);
+    v_ = AddInput(v_tensor);
+    kfull_ = AddOutput(k_tensor.type);
+    vfull_ = AddOutput(v_tensor.type);
+
+    flexbuffers::Builder fbb;
+    fbb.Map([&]() {
+      fbb.Int("kv_cache_max", max_num_entries);
+      fbb.Int("kv_cache_block_size", block_size);
+      fbb.Int("kv_cache_pool_blocks", pool_blocks);
+    });
+    fbb.Finish();
+    SetCustomOp("KV_Cache", fbb.GetBuffer(), ops::custom::Register_KV_CACHE);
+
+    BuildInterpreter({GetShape(pos_), GetShape(k_), GetShape(v_)});
+  }
+
+  void SetPosition(const std::vector<int64_t>& data) {
+    PopulateTensor(pos_, data);
+  }
+  void SetKey(const std::vector<float>& data) { PopulateTensor(k_, data); }
+  void SetValue(const std::vector<float>& data) { PopulateTensor(v_, data); }
+
+  const resource::PagedCacheBuffer* GetCache() {
+    const TfLiteTensor* kfull = interpreter_->tensor(kfull_);
+    const TfLiteTensor* vfull = interpreter_->tensor(vfull_);
+    EXPECT_EQ(kfull->type, kTfLiteResource);
+    EXPECT_EQ(kfull->data.i32[0], vfull->data.i32[0]);
+    return resource::GetTypedResource<resource::PagedCacheBuffer>(
+        &interpreter_->primary_subgraph().resources(), kfull->data.i32[0],
+        resource::ResourceBase::ResourceType::kPagedCacheBuffer);
+  }
+
+ protected:
+  int pos_;
+  int k_;
+  int v_;
+  int kfull_;
+  int vfull_;
+};
+
+TEST(PagedCacheOpTest, AllocatesBlocksOnDemand) {
+  PagedCacheOpModel m({TensorType_INT64, {2}},
+                      {TensorType_FLOAT32, {1, 2, 2, 3}},
+                      {TensorType_FLOAT32, {1, 2, 2, 3}},
+                      /*max_num_entries=*/kDefaultMaxNumCacheEntries,
+                      /*block_size=*/16, /*pool_blocks=*/0);
+
+  m.SetPosition({0, 1});
+  std::vector<float> key = {1, 5, -6, 2, 4, 3, 8, 9, -8, 7, 2, 11};
+  m.SetKey(key);
+  std::vector<float> value = {2, 3, -4, 5, 6, 7, 1, 8, -12, 11, 14, 21};
+  m.SetValue(value);
+  ASSERT_EQ(m.Invoke(), kTfLiteOk);
+
+  const resource::PagedCacheBuffer* cache = m.GetCache();
+  ASSERT_NE(cache, nullptr);
+  EXPECT_EQ(cache->GetNumEntries(), 2);
+  // Only one block is used although the cache can hold 2048 entries.
+  EXPECT_EQ(cache->block_table().size(), 1);
+  for (int slot = 0; slot < 2; ++slot) {
+    for (int i = 0; i < 6; ++i) {
+      ASSERT_EQ(cache->GetKey(slot)[i], key[slot * 6 + i]);
+      ASSERT_EQ(cache->GetValue(slot)[i], value[slot * 6 + i]);
+    }
+  }
+}
+
+TEST(PagedCacheOpTest, SlidingWindowReusesBlocks) {
+  PagedCacheOpModel m({TensorType_INT64, {2}},
+                      {TensorType_FLOAT32, {1, 2, 2, 3}},
+                      {TensorType_FLOAT32, {1, 2, 2, 3}},
+                      /*max_num_entries=*/8, /*block_size=*/2,
+                      /*pool_blocks=*/0);
+
+  for (int64_t pos = 0; pos < 20; pos += 2) {
+    m.SetPosition({pos, pos + 1});
+    m.SetKey(std::vector<float>(12, pos));
+    m.SetValue(std::vector<float>(12, -pos));
+    ASSERT_EQ(m.Invoke(), kTfLiteOk);
+  }
+
+  // The cache holds positions 12..19 and never needed more than 4 blocks.
+  const resource::PagedCacheBuffer* cache = m.GetCache();
+  ASSERT_NE(cache, nullptr);
+  EXPECT_EQ(cache->GetNumEntries(), 8);
+  EXPECT_EQ(cache->block_table().size(), 4);
+  EXPECT_EQ(cache->pool().NumBlocksInUse(), 4);
+  EXPECT_EQ(cache->GetKey(0)[0], 12);
+  EXPECT_EQ(cache->GetValue(7)[0], -18);
+
+  // Positions before the window are rejected.
+  m.SetPosition({0, 1});
+  ASSERT_EQ(m.Invoke(), kTfLiteError);
+}
+
+TEST(PagedCacheOpTest, FailsWhenPoolIsExhausted) {
+  PagedCacheOpModel m({TensorType_INT64, {2}},
+                      {TensorType_FLOAT32, {1, 2, 2, 3}},
+                      {TensorType_FLOAT32, {1, 2, 2, 3}},
+                      /*max_num_entries=*/8, /*block_size=*/2,
+                      /*pool_blocks=*/2);
+
+  m.SetPosition({0, 1});
+  ASSERT_EQ(m.Invoke(), kTfLiteOk);
+  m.SetPosition({2, 3});
+  ASSERT_EQ(m.Invoke(), kTfLiteOk);
+  m.SetPosition({4, 5});
+  ASSERT_EQ(m.Invoke(), kTfLiteError);
+}
+
 TEST(SimpleCacheOp1Test, BasicTest) {
   SimpleCacheOpModel m({TensorType_INT64, {2}},
                        {TensorType_FLOAT32, {1, 2, 2, 3}},
@@ -15,14 +15,22 @@ limitations under the License.
 
 #include <math.h>
 
+#include <algorithm>
+#include <cmath>
 #include <cstddef>
 #include <cstdint>
 #include <cstring>
 #include <limits>
+#include <vector>
 
 #include "flatbuffers/flexbuffers.h"
 #include "tensorflow/lite/c/c_api_types.h"
 #include "tensorflow/lite/core/c/common.h"
+#include "tensorflow/lite/core/subgraph.h"
+#include "tensorflow/lite/experimental/resource/paged_cache_buffer.h"
+#include "tensorflow/lite/experimental/resource/resource_base.h"
+#include "tensorflow/lite/kernels/cpu_backend_context.h"
+#include "tensorflow/lite/kernels/cpu_backend_threadpool.h"
 #include "tensorflow/lite/kernels/internal/common.h"
 #include "tensorflow/lite/kernels/internal/reference/add.h"
 #include "tensorflow/lite/kernels/internal/reference/batch_matmul.h"
@@ -33,6 +41,7 @@ limitations under the License.
 #include "tensorflow/lite/kernels/internal/tensor_ctypes.h"
 #include "tensorflow/lite/kernels/internal/types.h"
 #include "tensorflow/lite/kernels/kernel_util.h"
+#include "tensorflow/lite/types/fp16.h"
 
 namespace tflite {
 namespace ops {
@@ -57,18 +66,321 @@ static const int kReshape2TempTensorIndex = 7;
 static const int kBroadcastKTempTensorIndex = 8;
 static const int kBroadcastVTempTensorIndex = 9;
 
+// The reference kernel materializes every intermediate of the attention graph
+// in temporaries. The optimized kernel fuses QK^T, masking, softmax and the
+// product with V into a single tiled pass and needs no temporaries.
+enum KernelType {
+  kReference,
+  kGenericOptimized,
+};
+
+// Rows of Q and of K/V processed per tile by the fused kernel. A tile of
+// scores is kQueryTile x kKeyTile floats, which stays resident in L1.
+static const int kQueryTile = 16;
+static const int kKeyTile = 64;
+
 struct OpData {
   float scale;
   int scratch_tensor_index;
+  bool use_fused_kernel;
+};
+
+// Dimensions of one attention problem. Q and the output are laid out as
+// [batch, q_len, num_heads, head_dim], K and V as
+// [batch, kv_len, num_kv_heads, head_dim].
+struct AttentionShape {
+  int batches;
+  int q_len;
+  int kv_len;
+  int num_heads;
+  int num_kv_heads;
+  int head_dim;
+  // Element strides of the attention mask over [batch, head, q, kv]; zero
+  // along broadcast dimensions.
+  int mask_strides[4];
+};
+
+inline float ToFloat(float x) { return x; }
+inline float ToFloat(TfLiteFloat16 x) { return fp16_ieee_to_fp32_value(x.data); }
+
+inline void FromFloat(float x, float* out) { *out = x; }
+inline void FromFloat(float x, TfLiteFloat16* out) {
+  out->data = fp16_ieee_from_fp32_value(x);
+}
+
+// Returns `row` as float. Float rows are used in place; other types are
+// converted into `scratch`.
+inline const float* RowAsFloat(const float* row, int head_dim,
+                               float* scratch) {
+  return row;
+}
+
+inline const float* RowAsFloat(const TfLiteFloat16* row, int head_dim,
+                               float* scratch) {
+  for (int d = 0; d < head_dim; ++d) scratch[d] = ToFloat(row[d]);
+  return scratch;
+}
+
+// K or V stored as a dense [batch, kv_len, num_kv_heads, head_dim] tensor.
+template <typename T>
+struct DenseKV {
+  const T* data;
+  int kv_len;
+  int num_kv_heads;
+  int head_dim;
+
+  const T* Row(int b, int pos, int kv_h) const {
+    return data +
+           ((static_cast<size_t>(b) * kv_len + pos) * num_kv_heads + kv_h) *
+               head_dim;
+  }
+};
+
+// K or V read in place from a paged KV cache through its block table.
+struct PagedKV {
+  const resource::PagedCacheBuffer* cache;
+  bool value;
+
+  const float* Row(int b, int pos, int kv_h) const {
+    const float* entry = value ? cache->GetValue(pos) : cache->GetKey(pos);
+    return entry + kv_h * cache->head_dim();
+  }
+};
+
+// Flash-attention style SDPA over the heads [head_begin, head_end) of the
+// flattened [batch, num_heads] space. For each tile of queries it streams K/V
+// in tiles, keeping a running row max and row sum so that softmax(QK^T + M)V
+// is accumulated without ever materializing a full score row. Inner loops are
+// unit-stride over head_dim so that they vectorize.
+template <typename T, typename KV>
+class FusedAttentionTask : public cpu_backend_threadpool::Task {
+ public:
+  FusedAttentionTask(const AttentionShape& shape, float scale, const T* query,
+                     const KV& key, const KV& value, const T* mask, T* output,
+                     int head_begin, int head_end)
+      : shape_(shape),
+        scale_(scale),
+        query_(query),
+        key_(key),
+        value_(value),
+        mask_(mask),
+        output_(output),
+        head_begin_(head_begin),
+        head_end_(head_end) {}
+
+  void Run() override {
+    const int head_dim = shape_.head_dim;
+    q_tile_.resize(kQueryTile * head_dim);
+    k_tile_.resize(kKeyTile * head_dim);
+    v_tile_.resize(kKeyTile * head_dim);
+    scores_.resize(kQueryTile * kKeyTile);
+    acc_.resize(kQueryTile * head_dim);
+    row_max_.resize(kQueryTile);
+    row_sum_.resize(kQueryTile);
+
+    const int group_size = shape_.num_heads / shape_.num_kv_heads;
+    for (int bh = head_begin_; bh < head_end_; ++bh) {
+      const int b = bh / shape_.num_heads;
+      const int h = bh % shape_.num_heads;
+      // K/V heads are shared by consecutive query heads, matching
+      // torch.repeat_interleave in the reference path.
+      const int kv_h = h / group_size;
+      for (int q0 = 0; q0 < shape_.q_len; q0 += kQueryTile) {
+        RunTile(b, h, kv_h, q0, std::min(kQueryTile, shape_.q_len - q0));
+      }
+    }
+  }
+
+ private:
+  void RunTile(int b, int h, int kv_h, int q0, int q_count) {
+    const int head_dim = shape_.head_dim;
+    const int q_stride = shape_.num_heads * head_dim;
+
+    const T* q_base =
+        query_ + (static_cast<size_t>(b) * shape_.q_len + q0) * q_stride +
+        h * head_dim;
+    for (int i = 0; i < q_count; ++i) {
+      const T* q_row = q_base + i * q_stride;
+      float* dst = &q_tile_[i * head_dim];
+      for (int d = 0; d < head_dim; ++d) dst[d] = ToFloat(q_row[d]) * scale_;
+    }
+    std::fill(acc_.begin(), acc_.begin() + q_count * head_dim, 0.0f);
+    std::fill(row_max_.begin(), row_max_.end(),
+              -std::numeric_limits<float>::infinity());
+    std::fill(row_sum_.begin(), row_sum_.end(), 0.0f);
+
+    const T* mask_base = mask_ + b * shape_.mask_strides[0] +
+                         h * shape_.mask_strides[1] +
+                         q0 * shape_.mask_strides[2];
+
+    for (int k0 = 0; k0 < shape_.kv_len; k0 += kKeyTile) {
+      const int k_count = std::min(kKeyTile, shape_.kv_len - k0);
+      for (int j = 0; j < k_count; ++j) {
+        k_rows_[j] = RowAsFloat(key_.Row(b, k0 + j, kv_h), head_dim,
+                                &k_tile_[j * head_dim]);
+        v_rows_[j] = RowAsFloat(value_.Row(b, k0 + j, kv_h), head_dim,
+                                &v_tile_[j * head_dim]);
+      }
+
+      // S = Q K^T + M for this tile.
+      for (int i = 0; i < q_count; ++i) {
+        const float* q_row = &q_tile_[i * head_dim];
+        const T* mask_row = mask_base + i * shape_.mask_strides[2] +
+                            k0 * shape_.mask_strides[3];
+        float* score_row = &scores_[i * kKeyTile];
+        for (int j = 0; j < k_count; ++j) {
+          const float* k_row = k_rows_[j];
+          float dot = 0.0f;
+          for (int d = 0; d < head_dim; ++d) dot += q_row[d] * k_row[d];
+          score_row[j] = dot + ToFloat(mask_row[j * shape_.mask_strides[3]]);
+        }
+      }
+
+      // Online softmax: rescale what has been accumulated so far to the new
+      // running max, then accumulate exp(S - max) V for this tile.
+      for (int i = 0; i < q_count; ++i) {
+        float* score_row = &scores_[i * kKeyTile];
+        float tile_max = -std::numeric_limits<float>::infinity();
+        for (int j = 0; j < k_count; ++j) {
+          tile_max = std::max(tile_max, score_row[j]);
+        }
+        const float new_max = std::max(row_max_[i], tile_max);
+        // Every key seen so far is fully masked out.
+        if (new_max == -std::numeric_limits<float>::infinity()) continue;
+
+        float* acc_row = &acc_[i * head_dim];
+        const float correction = std::exp(row_max_[i] - new_max);
+        if (correction != 1.0f) {
+          for (int d = 0; d < head_dim; ++d) acc_row[d] *= correction;
+        }
+        float sum = row_sum_[i] * correction;
+        for (int j = 0; j < k_count; ++j) {
+          const float p = std::exp(score_row[j] - new_max);
+          sum += p;
+          const float* v_row = v_rows_[j];
+          for (int d = 0; d < head_dim; ++d) acc_row[d] += p * v_row[d];
+        }
+        row_sum_[i] = sum;
+        row_max_[i] = new_max;
+      }
+    }
+
+    T* out_base =
+        output_ + (static_cast<size_t>(b) * shape_.q_len + q0) * q_stride +
+        h * head_dim;
+    for (int i = 0; i < q_count; ++i) {
+      // Rows whose keys are all masked out produce zeros.
+      const float inv_sum = row_sum_[i] > 0.0f ? 1.0f / row_sum_[i] : 0.0f;
+      const float* acc_row = &acc_[i * head_dim];
+      T* out_row = out_base + i * q_stride;
+      for (int d = 0; d < head_dim; ++d) {
+        FromFloat(acc_row[d] * inv_sum, &out_row[d]);
+      }
+    }
+  }
+
+  const AttentionShape shape_;
+  const float scale_;
+  const T* query_;
+  const KV key_;
+  const KV value_;
+  const T* mask_;
+  T* output_;
+  const int head_begin_;
+  const int head_end_;
+
+  std::vector<float> q_tile_;
+  std::vector<float> k_tile_;
+  std::vector<float> v_tile_;
+  // Float views of the K/V rows of the current tile.
+  const float* k_rows_[kKeyTile];
+  const float* v_rows_[kKeyTile];
+  std::vector<float> scores_;
+  std::vector<float> acc_;
+  std::vector<float> row_max_;
+  std::vector<float> row_sum_;
 };
 
 void* SDPAInit(TfLiteContext* context, const char* buffer, size_t length) {
   OpData* op_data = new OpData();
   op_data->scale = 0.0f;
+  op_data->use_fused_kernel = false;
   context->AddTensors(context, kNumTempTensors, &op_data->scratch_tensor_index);
   return op_data;
 }
 
+// Returns the paged KV cache whose resource id is held by `tensor`, or nullptr
+// if there is no such cache.
+const resource::PagedCacheBuffer* GetPagedCache(TfLiteContext* context,
+                                                const TfLiteTensor* tensor) {
+  if (tensor->data.raw == nullptr) return nullptr;
+  Subgraph* subgraph = reinterpret_cast<Subgraph*>(context->impl_);
+  return resource::GetTypedResource<resource::PagedCacheBuffer>(
+      &subgraph->resources(), tensor->data.i32[0],
+      resource::ResourceBase::ResourceType::kPagedCacheBuffer);
+}
+
+TfLiteStatus PrepareFused(TfLiteContext* context, TfLiteNode* node,
+                          const TfLiteTensor* q_tensor,
+                          const TfLiteTensor* k_tensor,
+                          const TfLiteTensor* v_tensor,
+                          const TfLiteTensor* mask_tensor) {
+  TF_LITE_ENSURE(context, q_tensor->type == kTfLiteFloat32 ||
+                              q_tensor->type == kTfLiteFloat16);
+  TF_LITE_ENSURE_TYPES_EQ(context, mask_tensor->type, q_tensor->type);
+  TfLiteTensor* output_tensor;
+  TF_LITE_ENSURE_OK(
+      context, GetOutputSafe(context, node, kOutputTensor, &output_tensor));
+  TF_LITE_ENSURE_TYPES_EQ(context, output_tensor->type, q_tensor->type);
+
+  const int batches = q_tensor->dims->data[0];
+  const int q_len = q_tensor->dims->data[1];
+  const int num_heads = q_tensor->dims->data[2];
+  const int head_dim = q_tensor->dims->data[3];
+  int kv_len;
+  int num_kv_heads;
+  if (k_tensor->type == kTfLiteResource) {
+    // K and V are read in place from a paged KV cache. Its slots line up with
+    // the last dimension of the mask.
+    TF_LITE_ENSURE_TYPES_EQ(context, v_tensor->type, kTfLiteResource);
+    const resource::PagedCacheBuffer* cache = GetPagedCache(context, k_tensor);
+    TF_LITE_ENSURE(context, cache != nullptr);
+    TF_LITE_ENSURE(context, GetPagedCache(context, v_tensor) == cache);
+    TF_LITE_ENSURE_EQ(context, batches, 1);
+    TF_LITE_ENSURE_EQ(context, cache->head_dim(), head_dim);
+    kv_len = mask_tensor->dims->data[3];
+    num_kv_heads = cache->num_heads();
+  } else {
+    TF_LITE_ENSURE_TYPES_EQ(context, k_tensor->type, q_tensor->type);
+    TF_LITE_ENSURE_TYPES_EQ(context, v_tensor->type, q_tensor->type);
+    kv_len = k_tensor->dims->data[1];
+    num_kv_heads = k_tensor->dims->data[2];
+    TF_LITE_ENSURE_EQ(context, k_tensor->dims->data[0], batches);
+    TF_LITE_ENSURE_EQ(context, k_tensor->dims->data[3], head_dim);
+    for (int i = 0; i < 4; ++i) {
+      TF_LITE_ENSURE_EQ(context, v_tensor->dims->data[i],
+                        k_tensor->dims->data[i]);
+    }
+  }
+  TF_LITE_ENSURE(context, num_kv_heads > 0);
+  TF_LITE_ENSURE_EQ(context, num_heads % num_kv_heads, 0);
+  TF_LITE_ENSURE_EQ(context, NumElements(output_tensor),
+                    NumElements(q_tensor));
+
+  // The mask must broadcast to [batch, num_heads, q_len, kv_len].
+  const int score_dims[4] = {batches, num_heads, q_len, kv_len};
+  for (int i = 0; i < 4; ++i) {
+    TF_LITE_ENSURE(context, mask_tensor->dims->data[i] == 1 ||
+                                mask_tensor->dims->data[i] == score_dims[i]);
+  }
+
+  // No temporaries are needed; per-thread tiles are owned by the tasks.
+  TfLiteIntArrayFree(node->temporaries);
+  node->temporaries = TfLiteIntArrayCreate(0);
+  return kTfLiteOk;
+}
+
+template <KernelType kernel_type>
 TfLiteStatus SDPAPrepare(TfLiteContext* context, TfLiteNode* node) {
   TF_LITE_ENSURE_EQ(context, NumInputs(node), 4);
   TF_LITE_ENSURE_EQ(context, NumOutputs(node), 1);
@@ -86,10 +398,20 @@ TfLiteStatus SDPAPrepare(TfLiteContext* context, TfLiteNode* node) {
   const TfLiteTensor* mask_tensor;
   TF_LITE_ENSURE_OK(
       context, GetInputSafe(context, node, kAttentionMaskTensor, &mask_tensor));
-  TF_LITE_ENSURE_EQ(context, NumDimensions(q_tensor), NumDimensions(k_tensor));
-  TF_LITE_ENSURE_EQ(context, NumDimensions(k_tensor), NumDimensions(v_tensor));
-  TF_LITE_ENSURE_EQ(context, NumDimensions(v_tensor),
-                    NumDimensions(mask_tensor));
+  // K and V are either dense tensors or resource handles of a paged KV cache,
+  // see kvcache.cc.
+  const bool paged_kv = k_tensor->type == kTfLiteResource;
+  if (!paged_kv) {
+    TF_LITE_ENSURE_EQ(context, NumDimensions(q_tensor),
+                      NumDimensions(k_tensor));
+    TF_LITE_ENSURE_EQ(context, NumDimensions(k_tensor),
+                      NumDimensions(v_tensor));
+    TF_LITE_ENSURE_EQ(context, NumDimensions(v_tensor),
+                      NumDimensions(mask_tensor));
+  } else {
+    TF_LITE_ENSURE_EQ(context, NumDimensions(q_tensor),
+                      NumDimensions(mask_tensor));
+  }
   TF_LITE_ENSURE_EQ(context, NumDimensions(mask_tensor), 4);
 
   // Get custom op params
@@ -104,6 +426,15 @@ TfLiteStatus SDPAPrepare(TfLiteContext* context, TfLiteNode* node) {
   if (op_data->scale == 0.0f)
     op_data->scale = 1 / sqrt(q_tensor->dims->data[3]);
 
+  op_data->use_fused_kernel = kernel_type == kGenericOptimized;
+  if (op_data->use_fused_kernel) {
+    return PrepareFused(context, node, q_tensor, k_tensor, v_tensor,
+                        mask_tensor);
+  }
+  TF_LITE_ENSURE_TYPES_EQ(context, q_tensor->type, kTfLiteFloat32);
+  TF_LITE_ENSURE_TYPES_EQ(context, k_tensor->type, kTfLiteFloat32);
+  TF_LITE_ENSURE_TYPES_EQ(context, v_tensor->type, kTfLiteFloat32);
+
   TfLiteIntArrayFree(node->temporaries);
   node->temporaries = TfLiteIntArrayCreate(kNumTempTensors);
   bool mqa = k_tensor->dims->data[2] == 1;
@@ -358,7 +689,95 @@ void SDPAFree(TfLiteContext* context, void* buffer) {
   delete static_cast<OpData*>(buffer);
 }
 
-TfLiteStatus SDPAEval(TfLiteContext* context, TfLiteNode* node) {
+template <typename T, typename KV>
+void RunFusedAttention(CpuBackendContext* cpu_backend_context,
+                       const AttentionShape& shape, float scale,
+                       const T* query, const KV& key, const KV& value,
+                       const T* mask, T* output) {
+  // Heads are independent, so the work is split over [batch, num_heads].
+  const int total_heads = shape.batches * shape.num_heads;
+  const int thread_count = std::max(
+      1, std::min(total_heads, cpu_backend_context->max_num_threads()));
+  std::vector<FusedAttentionTask<T, KV>> tasks;
+  tasks.reserve(thread_count);
+  int head_start = 0;
+  for (int i = 0; i < thread_count; ++i) {
+    int head_end = head_start + total_heads / thread_count;
+    if (i < total_heads % thread_count) head_end++;
+    tasks.emplace_back(shape, scale, query, key, value, mask, output,
+                       head_start, head_end);
+    head_start = head_end;
+  }
+  cpu_backend_threadpool::Execute(tasks.size(), tasks.data(),
+                                  cpu_backend_context);
+}
+
+template <typename T>
+TfLiteStatus EvalFused(TfLiteContext* context, TfLiteNode* node,
+                       const OpData* op_data) {
+  const TfLiteTensor* query_tensor;
+  TF_LITE_ENSURE_OK(context,
+                    GetInputSafe(context, node, kQueryTensor, &query_tensor));
+  const TfLiteTensor* key_tensor;
+  TF_LITE_ENSURE_OK(context,
+                    GetInputSafe(context, node, kKeyTensor, &key_tensor));
+  const TfLiteTensor* value_tensor;
+  TF_LITE_ENSURE_OK(context,
+                    GetInputSafe(context, node, kValueTensor, &value_tensor));
+  const TfLiteTensor* attention_mask_tensor;
+  TF_LITE_ENSURE_OK(context, GetInputSafe(context, node, kAttentionMaskTensor,
+                                          &attention_mask_tensor));
+  TfLiteTensor* output_tensor;
+  TF_LITE_ENSURE_OK(
+      context, GetOutputSafe(context, node, kOutputTensor, &output_tensor));
+
+  AttentionShape shape;
+  shape.batches = query_tensor->dims->data[0];
+  shape.q_len = query_tensor->dims->data[1];
+  shape.num_heads = query_tensor->dims->data[2];
+  shape.head_dim = query_tensor->dims->data[3];
+  const TfLiteIntArray* mask_dims = attention_mask_tensor->dims;
+  int stride = 1;
+  for (int i = 3; i >= 0; --i) {
+    shape.mask_strides[i] = mask_dims->data[i] == 1 ? 0 : stride;
+    stride *= mask_dims->data[i];
+  }
+
+  CpuBackendContext* cpu_backend_context =
+      CpuBackendContext::GetFromContext(context);
+  const T* query = GetTensorData<T>(query_tensor);
+  const T* mask = GetTensorData<T>(attention_mask_tensor);
+  T* output = GetTensorData<T>(output_tensor);
+
+  if (key_tensor->type == kTfLiteResource) {
+    const resource::PagedCacheBuffer* cache =
+        GetPagedCache(context, key_tensor);
+    TF_LITE_ENSURE(context, cache != nullptr);
+    TF_LITE_ENSURE(context, GetPagedCache(context, value_tensor) == cache);
+    // Slots past the last written entry hold no data and are skipped, as if
+    // they were masked out.
+    shape.kv_len = std::min(mask_dims->data[3], cache->GetNumEntries());
+    shape.num_kv_heads = cache->num_heads();
+    TF_LITE_ENSURE_EQ(context, shape.num_heads % shape.num_kv_heads, 0);
+    RunFusedAttention(cpu_backend_context, shape, op_data->scale, query,
+                      PagedKV{cache, /*value=*/false},
+                      PagedKV{cache, /*value=*/true}, mask, output);
+    return kTfLiteOk;
+  }
+
+  shape.kv_len = key_tensor->dims->data[1];
+  shape.num_kv_heads = key_tensor->dims->data[2];
+  RunFusedAttention(
+      cpu_backend_context, shape, op_data->scale, query,
+      DenseKV<T>{GetTensorData<T>(key_tensor), shape.kv_len,
+                 shape.num_kv_heads, shape.head_dim},
+      DenseKV<T>{GetTensorData<T>(value_tensor), shape.kv_len,
+                 shape.num_kv_heads, shape.head_dim},
+      mask, output);
+  return kTfLiteOk;
+}
+
+TfLiteStatus EvalReference(TfLiteContext* context, TfLiteNode* node) {
   /*
   Simple implementation of Scaled Dot Product Attention.
   Takes query_proj, key_proj, value_proj, mask tensors as inputs, and
@@ -661,14 +1080,44 @@ TfLiteStatus SDPAEval(TfLiteContext* context, TfLiteNode* node) {
   return kTfLiteOk;
 }
 
+TfLiteStatus SDPAEval(TfLiteContext* context, TfLiteNode* node) {
+  const OpData* op_data = reinterpret_cast<OpData*>(node->user_data);
+  if (!op_data->use_fused_kernel) {
+    return EvalReference(context, node);
+  }
+  const TfLiteTensor* query_tensor;
+  TF_LITE_ENSURE_OK(context,
+                    GetInputSafe(context, node, kQueryTensor, &query_tensor));
+  switch (query_tensor->type) {
+    case kTfLiteFloat32:
+      return EvalFused<float>(context, node, op_data);
+    case kTfLiteFloat16:
+      return EvalFused<TfLiteFloat16>(context, node, op_data);
+    default:
+      TF_LITE_KERNEL_LOG(context, "Type %s is not supported by SDPA.",
+                         TfLiteTypeGetName(query_tensor->type));
+      return kTfLiteError;
+  }
+}
+
 }  // namespace llm
 
-TfLiteRegistration* Register_SDPA() {
-  static TfLiteRegistration r = {llm::SDPAInit, llm::SDPAFree, llm::SDPAPrepare,
+TfLiteRegistration* Register_SDPA_REF() {
+  static TfLiteRegistration r = {llm::SDPAInit, llm::SDPAFree,
+                                 llm::SDPAPrepare<llm::kReference>,
+                                 llm::SDPAEval};
+  return &r;
+}
+
+TfLiteRegistration* Register_SDPA_GENERIC_OPT() {
+  static TfLiteRegistration r = {llm::SDPAInit, llm::SDPAFree,
+                                 llm::SDPAPrepare<llm::kGenericOptimized>,
                                  llm::SDPAEval};
   return &r;
 }
 
+TfLiteRegistration* Register_SDPA() { return Register_SDPA_GENERIC_OPT(); }
+
 }  // namespace custom
 }  // namespace ops
 }  // namespace tflite
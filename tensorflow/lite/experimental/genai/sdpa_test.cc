@@ -0,0 +1,303 @@
+/* Copyright 2026 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <random>
+#include <vector>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include "benchmark/benchmark.h"  // from @com_google_benchmark
+#include "flatbuffers/flexbuffers.h"  // from @flatbuffers
+#include "tensorflow/lite/c/c_api_types.h"
+#include "tensorflow/lite/core/c/common.h"
+#include "tensorflow/lite/core/subgraph.h"
+#include "tensorflow/lite/experimental/genai/genai_ops.h"
+#include "tensorflow/lite/experimental/resource/paged_cache_buffer.h"
+#include "tensorflow/lite/kernels/test_util.h"
+#include "tensorflow/lite/schema/schema_generated.h"
+#include "tensorflow/lite/types/half.h"
+
+namespace tflite {
+namespace {
+
+using ::testing::ElementsAreArray;
+
+// Dimensions of an attention problem. Q is [batch, q_len, heads, head_dim],
+// K/V are [batch, kv_len, kv_heads, head_dim], the mask is
+// [1, 1, q_len, kv_len].
+struct SDPAShape {
+  int batch;
+  int q_len;
+  int kv_len;
+  int heads;
+  int kv_heads;
+  int head_dim;
+};
+
+class SDPAOpModel : public SingleOpModel {
+ public:
+  SDPAOpModel(const SDPAShape& shape, TensorType type,
+              const std::function<TfLiteRegistration*()>& registration,
+              int num_threads = 1) {
+    const std::vector<int> q_shape = {shape.batch, shape.q_len, shape.heads,
+                                      shape.head_dim};
+    const std::vector<int> kv_shape = {shape.batch, shape.kv_len,
+                                       shape.kv_heads, shape.head_dim};
+    const std::vector<int> mask_shape = {1, 1, shape.q_len, shape.kv_len};
+    q_ = AddInput({type, q_shape});
+    k_ = AddInput({type, kv_shape});
+    v_ = AddInput({type, kv_shape});
+    mask_ = AddInput({type, mask_shape});
+    output_ = AddOutput({type, q_shape});
+
+    flexbuffers::Builder fbb;
+    fbb.Map([&]() { fbb.Float("scale", 0.0f); });
+    fbb.Finish();
+    SetCustomOp("odml.scaled_dot_product_attention", fbb.GetBuffer(),
+                registration);
+    BuildInterpreter({q_shape, kv_shape, kv_shape, mask_shape}, num_threads,
+                     /*allow_fp32_relax_to_fp16=*/false,
+                     /*apply_delegate=*/true);
+  }
+
+  template <typename T>
+  void SetInputs(const std::vector<T>& q, const std::vector<T>& k,
+                 const std::vector<T>& v, const std::vector<T>& mask) {
+    PopulateTensor(q_, q);
+    PopulateTensor(k_, k);
+    PopulateTensor(v_, v);
+    PopulateTensor(mask_, mask);
+  }
+
+  template <typename T>
+  std::vector<T> GetOutput() {
+    return ExtractVector<T>(output_);
+  }
+
+ private:
+  int q_;
+  int k_;
+  int v_;
+  int mask_;
+  int output_;
+};
+
+std::vector<float> RandomData(int size, std::mt19937* rng) {
+  std::uniform_real_distribution<float> dist(-1.0f, 1.0f);
+  std::vector<float> data(size);
+  for (float& x : data) x = dist(*rng);
+  return data;
+}
+
+// Causal mask with `q_len` queries at the end of a `kv_len` long sequence.
+std::vector<float> CausalMask(int q_len, int kv_len) {
+  std::vector<float> mask(q_len * kv_len);
+  const int offset = kv_len - q_len;
+  for (int i = 0; i < q_len; ++i) {
+    for (int j = 0; j < kv_len; ++j) {
+      mask[i * kv_len + j] =
+          j <= i + offset ? 0.0f : -std::numeric_limits<float>::infinity();
+    }
+  }
+  return mask;
+}
+
+struct SDPAInputs {
+  std::vector<float> q;
+  std::vector<float> k;
+  std::vector<float> v;
+  std::vector<float> mask;
+};
+
+SDPAInputs MakeInputs(const SDPAShape& s) {
+  std::mt19937 rng(0);
+  SDPAInputs in;
+  in.q = RandomData(s.batch * s.q_len * s.heads * s.head_dim, &rng);
+  in.k = RandomData(s.batch * s.kv_len * s.kv_heads * s.head_dim, &rng);
+  in.v = RandomData(s.batch * s.kv_len * s.kv_heads * s.head_dim, &rng);
+  in.mask = CausalMask(s.q_len, s.kv_len);
+  return in;
+}
+
+std::vector<float> RunReference(const SDPAShape& shape,
+                                const SDPAInputs& in) {
+  SDPAOpModel ref(shape, TensorType_FLOAT32, ops::custom::Register_SDPA_REF);
+  ref.SetInputs(in.q, in.k, in.v, in.mask);
+  EXPECT_EQ(ref.Invoke(), kTfLiteOk);
+  return ref.GetOutput<float>();
+}
+
+// SDPA reading K and V from a paged KV cache that holds the dense K/V inputs
+// of `shape` in blocks of `block_size` entries.
+class PagedSDPAOpModel : public SingleOpModel {
+ public:
+  static constexpr int kCacheResourceId = 7;
+
+  PagedSDPAOpModel(const SDPAShape& shape, const SDPAInputs& in,
+                   int block_size) {
+    const std::vector<int> q_shape = {1, shape.q_len, shape.heads,
+                                      shape.head_dim};
+    const std::vector<int> mask_shape = {1, 1, shape.q_len, shape.kv_len};
+    q_ = AddInput({TensorType_FLOAT32, q_shape});
+    k_ = AddInput({TensorType_RESOURCE, {1}});
+    v_ = AddInput({TensorType_RESOURCE, {1}});
+    mask_ = AddInput({TensorType_FLOAT32, mask_shape});
+    output_ = AddOutput({TensorType_FLOAT32, q_shape});
+
+    flexbuffers::Builder fbb;
+    fbb.Map([&]() { fbb.Float("scale", 0.0f); });
+    fbb.Finish();
+    SetCustomOp("odml.scaled_dot_product_attention", fbb.GetBuffer(),
+                ops::custom::Register_SDPA_GENERIC_OPT);
+    BuildInterpreter({q_shape, {1}, {1}, mask_shape}, /*num_threads=*/1,
+                     /*allow_fp32_relax_to_fp16=*/false,
+                     /*apply_delegate=*/false,
+                     /*allocate_and_delegate=*/false);
+
+    const int entry_elements = shape.kv_heads * shape.head_dim;
+    auto pool = std::make_shared<resource::KVBlockPool>(
+        (shape.kv_len + block_size - 1) / block_size,
+        2 * block_size * entry_elements);
+    auto cache = std::make_unique<resource::PagedCacheBuffer>(
+        pool, block_size, shape.kv_heads, shape.head_dim);
+    EXPECT_EQ(cache->Reserve(shape.kv_len), kTfLiteOk);
+    for (int slot = 0; slot < shape.kv_len; ++slot) {
+      std::copy_n(&in.k[slot * entry_elements], entry_elements,
+                  cache->GetKey(slot));
+      std::copy_n(&in.v[slot * entry_elements], entry_elements,
+                  cache->GetValue(slot));
+    }
+    cache->SetNumEntries(shape.kv_len);
+    interpreter_->primary_subgraph().resources().emplace(kCacheResourceId,
+                                                         std::move(cache));
+    for (int tensor : {k_, v_}) {
+      TfLiteTensor* handle = interpreter_->tensor(tensor);
+      TfLiteTensorRealloc(sizeof(int32_t), handle);
+      handle->bytes = sizeof(int32_t);
+      handle->data.i32[0] = kCacheResourceId;
+    }
+    AllocateAndDelegate(/*apply_delegate=*/false);
+  }
+
+  void SetInputs(const std::vector<float>& q, const std::vector<float>& mask) {
+    PopulateTensor(q_, q);
+    PopulateTensor(mask_, mask);
+  }
+
+  std::vector<float> GetOutput() { return ExtractVector<float>(output_); }
+
+ private:
+  int q_;
+  int k_;
+  int v_;
+  int mask_;
+  int output_;
+};
+
+TEST(SDPAPagedTest, MatchesDenseReference) {
+  const SDPAShape shape{/*batch=*/1, /*q_len=*/3, /*kv_len=*/70,
+                        /*heads=*/4, /*kv_heads=*/2, /*head_dim=*/16};
+  const SDPAInputs in = MakeInputs(shape);
+  const std::vector<float> expected = RunReference(shape, in);
+
+  PagedSDPAOpModel paged(shape, in, /*block_size=*/16);
+  paged.SetInputs(in.q, in.mask);
+  ASSERT_EQ(paged.Invoke(), kTfLiteOk);
+  EXPECT_THAT(paged.GetOutput(),
+              ElementsAreArray(ArrayFloatNear(expected, 1e-5)));
+}
+
+class SDPAFusedTest : public ::testing::TestWithParam<SDPAShape> {};
+
+TEST_P(SDPAFusedTest, MatchesReference) {
+  const SDPAShape shape = GetParam();
+  const SDPAInputs in = MakeInputs(shape);
+  const std::vector<float> expected = RunReference(shape, in);
+
+  for (int num_threads : {1, 4}) {
+    SDPAOpModel fused(shape, TensorType_FLOAT32,
+                      ops::custom::Register_SDPA_GENERIC_OPT, num_threads);
+    fused.SetInputs(in.q, in.k, in.v, in.mask);
+    ASSERT_EQ(fused.Invoke(), kTfLiteOk);
+    EXPECT_THAT(fused.GetOutput<float>(),
+                ElementsAreArray(ArrayFloatNear(expected, 1e-5)));
+  }
+}
+
+TEST_P(SDPAFusedTest, Float16MatchesReference) {
+  const SDPAShape shape = GetParam();
+  const SDPAInputs in = MakeInputs(shape);
+  const std::vector<float> expected = RunReference(shape, in);
+
+  auto to_half = [](const std::vector<float>& data) {
+    return std::vector<half>(data.begin(), data.end());
+  };
+  SDPAOpModel fused(shape, TensorType_FLOAT16,
+                    ops::custom::Register_SDPA_GENERIC_OPT);
+  fused.SetInputs(to_half(in.q), to_half(in.k), to_half(in.v),
+                  to_half(in.mask));
+  ASSERT_EQ(fused.Invoke(), kTfLiteOk);
+  const std::vector<half> output = fused.GetOutput<half>();
+  EXPECT_THAT(std::vector<float>(output.begin(), output.end()),
+              ElementsAreArray(ArrayFloatNear(expected, 1e-2)));
+}
+
+INSTANTIATE_TEST_SUITE_P(
+    SDPAFusedTest, SDPAFusedTest,
+    ::testing::Values(
+        // MHA prefill spanning several query and key tiles.
+        SDPAShape{/*batch=*/1, /*q_len=*/37, /*kv_len=*/150, /*heads=*/4,
+                  /*kv_heads=*/4, /*head_dim=*/32},
+        // GQA decode.
+        SDPAShape{/*batch=*/2, /*q_len=*/1, /*kv_len=*/100, /*heads=*/8,
+                  /*kv_heads=*/2, /*head_dim=*/16},
+        // MQA.
+        SDPAShape{/*batch=*/1, /*q_len=*/5, /*kv_len=*/64, /*heads=*/4,
+                  /*kv_heads=*/1, /*head_dim=*/8}));
+
+}  // namespace
+}  // namespace tflite
+
+// Decode-style attention throughput: one query token against a KV cache of
+// `state.range(0)` entries. `state.range(1)` selects the fused kernel (1) or
+// the reference kernel (0).
+void BM_SDPADecode(benchmark::State& state) {
+  const int kv_len = state.range(0);
+  const bool fused = state.range(1);
+  const tflite::SDPAShape shape{/*batch=*/1, /*q_len=*/1, kv_len,
+                                /*heads=*/32, /*kv_heads=*/8,
+                                /*head_dim=*/128};
+  tflite::SDPAOpModel m(shape, tflite::TensorType_FLOAT32,
+                        fused ? tflite::ops::custom::Register_SDPA_GENERIC_OPT
+                              : tflite::ops::custom::Register_SDPA_REF,
+                        /*num_threads=*/4);
+  const tflite::SDPAInputs in = tflite::MakeInputs(shape);
+  m.SetInputs(in.q, in.k, in.v, in.mask);
+
+  for (auto _ : state) {
+    m.Invoke();
+  }
+  state.counters["tokens_per_second"] = benchmark::Counter(
+      state.iterations() * shape.q_len, benchmark::Counter::kIsRate);
+}
+BENCHMARK(BM_SDPADecode)
+    ->ArgsProduct({{256, 1024, 4096}, {0, 1}})
+    ->UseRealTime();
@@ -0,0 +1,150 @@
+/* Copyright 2026 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow/lite/experimental/resource/paged_cache_buffer.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <map>
+#include <memory>
+#include <mutex>  // NOLINT
+#include <string>
+#include <utility>
+
+#include "tensorflow/lite/core/c/common.h"
+#include "tensorflow/lite/kernels/internal/compatibility.h"
+
+namespace tflite {
+namespace resource {
+
+KVBlockPool::KVBlockPool(int max_blocks, size_t block_elements)
+    : max_blocks_(max_blocks),
+      block_elements_(block_elements),
+      blocks_(max_blocks) {}
+
+int KVBlockPool::Allocate() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (!free_list_.empty()) {
+    const int block_id = free_list_.back();
+    free_list_.pop_back();
+    return block_id;
+  }
+  if (num_created_ == max_blocks_) {
+    return -1;
+  }
+  const int block_id = num_created_++;
+  blocks_[block_id].reset(new float[block_elements_]);
+  memset(blocks_[block_id].get(), 0, sizeof(float) * block_elements_);
+  return block_id;
+}
+
+void KVBlockPool::Release(int block_id) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  TFLITE_DCHECK(block_id >= 0 && block_id < num_created_);
+  free_list_.push_back(block_id);
+}
+
+int KVBlockPool::NumBlocksInUse() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return num_created_ - static_cast<int>(free_list_.size());
+}
+
+size_t KVBlockPool::GetMemoryUsage() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return sizeof(float) * block_elements_ * num_created_;
+}
+
+std::shared_ptr<KVBlockPool> KVBlockPool::GetOrCreateShared(
+    const std::string& name, int max_blocks, size_t block_elements) {
+  static std::mutex* registry_mutex = new std::mutex;
+  static auto* registry =
+      new std::map<std::string, std::weak_ptr<KVBlockPool>>;
+  std::lock_guard<std::mutex> lock(*registry_mutex);
+  std::weak_ptr<KVBlockPool>& entry = (*registry)[name];
+  std::shared_ptr<KVBlockPool> pool = entry.lock();
+  if (pool == nullptr) {
+    pool = std::make_shared<KVBlockPool>(max_blocks, block_elements);
+    entry = pool;
+  } else if (pool->block_elements() != block_elements) {
+    return nullptr;
+  }
+  return pool;
+}
+
+PagedCacheBuffer::PagedCacheBuffer(std::shared_ptr<KVBlockPool> pool,
+                                   int block_size, int num_heads, int head_dim)
+    : pool_(std::move(pool)),
+      block_size_(block_size),
+      num_heads_(num_heads),
+      head_dim_(head_dim),
+      entry_elements_(num_heads * head_dim) {
+  TFLITE_DCHECK(pool_->block_elements() ==
+                2 * static_cast<size_t>(block_size_) * entry_elements_);
+}
+
+PagedCacheBuffer::~PagedCacheBuffer() { Clear(); }
+
+size_t PagedCacheBuffer::GetMemoryUsage() {
+  return sizeof(float) * pool_->block_elements() * block_table_.size();
+}
+
+TfLiteStatus PagedCacheBuffer::Reserve(int num_slots) {
+  const int blocks_needed =
+      (front_offset_ + num_slots + block_size_ - 1) / block_size_;
+  while (static_cast<int>(block_table_.size()) < blocks_needed) {
+    const int block_id = pool_->Allocate();
+    if (block_id < 0) {
+      return kTfLiteError;
+    }
+    block_table_.push_back(block_id);
+  }
+  return kTfLiteOk;
+}
+
+void PagedCacheBuffer::DropFront(int num_slots) {
+  front_offset_ += num_slots;
+  int blocks_to_drop = std::min(front_offset_ / block_size_,
+                                static_cast<int>(block_table_.size()));
+  for (int i = 0; i < blocks_to_drop; ++i) {
+    pool_->Release(block_table_[i]);
+  }
+  block_table_.erase(block_table_.begin(),
+                     block_table_.begin() + blocks_to_drop);
+  front_offset_ -= blocks_to_drop * block_size_;
+  if (block_table_.empty()) front_offset_ = 0;
+  num_entries_ = std::max(0, num_entries_ - num_slots);
+}
+
+void PagedCacheBuffer::Clear() {
+  for (int block_id : block_table_) {
+    pool_->Release(block_id);
+  }
+  block_table_.clear();
+  front_offset_ = 0;
+  num_entries_ = 0;
+}
+
+float* PagedCacheBuffer::GetEntry(int slot, bool value) {
+  const int index = front_offset_ + slot;
+  const int block = index / block_size_;
+  TFLITE_DCHECK(block < static_cast<int>(block_table_.size()));
+  float* data = pool_->GetBlock(block_table_[block]);
+  if (value) data += static_cast<size_t>(block_size_) * entry_elements_;
+  return data + static_cast<size_t>(index % block_size_) * entry_elements_;
+}
+
+}  // namespace resource
+}  // namespace tflite
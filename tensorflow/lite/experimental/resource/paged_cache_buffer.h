@@ -0,0 +1,140 @@
+/* Copyright 2026 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#ifndef TENSORFLOW_LITE_EXPERIMENTAL_RESOURCE_PAGED_CACHE_BUFFER_H_
+#define TENSORFLOW_LITE_EXPERIMENTAL_RESOURCE_PAGED_CACHE_BUFFER_H_
+
+#include <cstddef>
+#include <memory>
+#include <mutex>  // NOLINT
+#include <string>
+#include <vector>
+
+#include "tensorflow/lite/core/c/common.h"
+#include "tensorflow/lite/experimental/resource/resource_base.h"
+
+namespace tflite {
+namespace resource {
+
+/// WARNING: Experimental interface, subject to change.
+// A bounded pool of fixed-size float blocks. Blocks are allocated lazily, up
+// to `max_blocks`, and released blocks are recycled through a free list, so
+// memory grows with the number of cached entries rather than with the maximum
+// context length. Several caches, possibly owned by different interpreters,
+// can draw from one pool to share a single memory budget. Thread-safe.
+class KVBlockPool {
+ public:
+  KVBlockPool(int max_blocks, size_t block_elements);
+  KVBlockPool(const KVBlockPool &) = delete;
+  KVBlockPool &operator=(const KVBlockPool &) = delete;
+
+  // Returns the id of a free block, or -1 if the pool is exhausted.
+  int Allocate();
+  void Release(int block_id);
+
+  // Returns the storage of a block previously returned by Allocate().
+  float *GetBlock(int block_id) const { return blocks_[block_id].get(); }
+
+  int max_blocks() const { return max_blocks_; }
+  size_t block_elements() const { return block_elements_; }
+  // Number of blocks currently handed out to callers.
+  int NumBlocksInUse() const;
+  // Bytes of block storage allocated so far, including free blocks.
+  size_t GetMemoryUsage() const;
+
+  // Returns the process-wide pool registered under `name`, creating it if no
+  // live pool has that name. Returns nullptr if a live pool with that name
+  // has a different block size.
+  static std::shared_ptr<KVBlockPool> GetOrCreateShared(
+      const std::string &name, int max_blocks, size_t block_elements);
+
+ private:
+  const int max_blocks_;
+  const size_t block_elements_;
+  // Sized to `max_blocks_` up front so that GetBlock() never races with an
+  // allocation of another block.
+  std::vector<std::unique_ptr<float[]>> blocks_;
+  mutable std::mutex mutex_;
+  std::vector<int> free_list_;
+  int num_created_ = 0;
+};
+
+/// WARNING: Experimental interface, subject to change.
+// Paged key/value cache of one transformer layer. Entries are addressed by
+// slot, relative to the oldest slot still held, and live in blocks of
+// `block_size` entries taken from a KVBlockPool. Each block holds the keys of
+// its entries followed by their values; the block table lists the blocks of
+// the cache in slot order. Dropping the oldest slots returns whole blocks to
+// the pool instead of moving data.
+class PagedCacheBuffer : public ResourceBase {
+ public:
+  PagedCacheBuffer(std::shared_ptr<KVBlockPool> pool, int block_size,
+                   int num_heads, int head_dim);
+  PagedCacheBuffer(const PagedCacheBuffer &) = delete;
+  PagedCacheBuffer &operator=(const PagedCacheBuffer &) = delete;
+  ~PagedCacheBuffer() override;
+
+  ResourceType GetResourceType() const override {
+    return ResourceType::kPagedCacheBuffer;
+  }
+  bool IsInitialized() override { return true; }
+  size_t GetMemoryUsage() override;
+
+  // Makes slots [0, num_slots) addressable, allocating blocks as needed.
+  // Returns kTfLiteError if the pool runs out of blocks.
+  TfLiteStatus Reserve(int num_slots);
+  // Drops the oldest `num_slots` slots; blocks that no longer hold any slot
+  // are returned to the pool.
+  void DropFront(int num_slots);
+  // Returns all blocks to the pool.
+  void Clear();
+
+  // Pointers to the [num_heads, head_dim] key or value entry of `slot`, which
+  // must have been reserved.
+  float *GetKey(int slot) { return GetEntry(slot, /*value=*/false); }
+  float *GetValue(int slot) { return GetEntry(slot, /*value=*/true); }
+  const float *GetKey(int slot) const {
+    return const_cast<PagedCacheBuffer *>(this)->GetKey(slot);
+  }
+  const float *GetValue(int slot) const {
+    return const_cast<PagedCacheBuffer *>(this)->GetValue(slot);
+  }
+
+  int GetNumEntries() const { return num_entries_; }
+  void SetNumEntries(int count) { num_entries_ = count; }
+  int block_size() const { return block_size_; }
+  int num_heads() const { return num_heads_; }
+  int head_dim() const { return head_dim_; }
+  const std::vector<int> &block_table() const { return block_table_; }
+  const KVBlockPool &pool() const { return *pool_; }
+  std::shared_ptr<KVBlockPool> shared_pool() const { return pool_; }
+
+ private:
+  float *GetEntry(int slot, bool value);
+
+  std::shared_ptr<KVBlockPool> pool_;
+  const int block_size_;
+  const int num_heads_;
+  const int head_dim_;
+  const int entry_elements_;
+  std::vector<int> block_table_;
+  // Offset of slot 0 within the first block of the table.
+  int front_offset_ = 0;
+  int num_entries_ = 0;
+};
+
+}  // namespace resource
+}  // namespace tflite
+
+#endif  // TENSORFLOW_LITE_EXPERIMENTAL_RESOURCE_PAGED_CACHE_BUFFER_H_
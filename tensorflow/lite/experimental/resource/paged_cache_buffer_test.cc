@@ -0,0 +1,106 @@
+/* Copyright 2026 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#include "tensorflow/lite/experimental/resource/paged_cache_buffer.h"
+
+#include <memory>
+
+#include <gtest/gtest.h>
+#include "tensorflow/lite/core/c/common.h"
+
+namespace tflite {
+namespace resource {
+
+// Blocks of 2 entries with 3 heads of dim 2: 2 * 2 * 6 floats per block.
+constexpr int kBlockSize = 2;
+constexpr int kNumHeads = 3;
+constexpr int kHeadDim = 2;
+constexpr size_t kBlockElements = 2 * kBlockSize * kNumHeads * kHeadDim;
+
+TEST(KVBlockPoolTest, AllocatesLazilyAndRecyclesBlocks) {
+  KVBlockPool pool(/*max_blocks=*/2, kBlockElements);
+  EXPECT_EQ(pool.GetMemoryUsage(), 0);
+
+  const int a = pool.Allocate();
+  const int b = pool.Allocate();
+  EXPECT_NE(a, b);
+  EXPECT_EQ(pool.Allocate(), -1);
+  EXPECT_EQ(pool.NumBlocksInUse(), 2);
+  EXPECT_EQ(pool.GetMemoryUsage(), 2 * kBlockElements * sizeof(float));
+
+  pool.Release(a);
+  EXPECT_EQ(pool.NumBlocksInUse(), 1);
+  EXPECT_EQ(pool.Allocate(), a);
+}
+
+TEST(KVBlockPoolTest, SharedPoolsAreLookedUpByName) {
+  auto pool = KVBlockPool::GetOrCreateShared("test_pool", 4, kBlockElements);
+  ASSERT_NE(pool, nullptr);
+  EXPECT_EQ(KVBlockPool::GetOrCreateShared("test_pool", 8, kBlockElements),
+            pool);
+  EXPECT_EQ(KVBlockPool::GetOrCreateShared("test_pool", 4, kBlockElements + 1),
+            nullptr);
+  EXPECT_NE(KVBlockPool::GetOrCreateShared("other_pool", 4, kBlockElements),
+            pool);
+}
+
+TEST(PagedCacheBufferTest, ReserveWriteAndDropFront) {
+  auto pool = std::make_shared<KVBlockPool>(/*max_blocks=*/3, kBlockElements);
+  PagedCacheBuffer cache(pool, kBlockSize, kNumHeads, kHeadDim);
+  EXPECT_EQ(cache.GetResourceType(),
+            ResourceBase::ResourceType::kPagedCacheBuffer);
+
+  ASSERT_EQ(cache.Reserve(5), kTfLiteOk);
+  EXPECT_EQ(cache.block_table().size(), 3);
+  for (int slot = 0; slot < 5; ++slot) {
+    cache.GetKey(slot)[0] = slot;
+    cache.GetValue(slot)[0] = -slot;
+  }
+  cache.SetNumEntries(5);
+  // The pool is exhausted.
+  EXPECT_EQ(cache.Reserve(7), kTfLiteError);
+
+  // Dropping three slots frees the first block; slot 0 is now old slot 3.
+  cache.DropFront(3);
+  EXPECT_EQ(cache.block_table().size(), 2);
+  EXPECT_EQ(cache.GetNumEntries(), 2);
+  EXPECT_EQ(cache.GetKey(0)[0], 3);
+  EXPECT_EQ(cache.GetValue(1)[0], -4);
+  EXPECT_EQ(pool->NumBlocksInUse(), 2);
+
+  // The freed block is reused.
+  ASSERT_EQ(cache.Reserve(5), kTfLiteOk);
+  EXPECT_EQ(cache.block_table().size(), 3);
+  EXPECT_EQ(cache.GetKey(1)[0], 4);
+
+  cache.Clear();
+  EXPECT_EQ(pool->NumBlocksInUse(), 0);
+}
+
+TEST(PagedCacheBufferTest, CachesShareOnePool) {
+  auto pool = std::make_shared<KVBlockPool>(/*max_blocks=*/2, kBlockElements);
+  auto first =
+      std::make_unique<PagedCacheBuffer>(pool, kBlockSize, kNumHeads, kHeadDim);
+  PagedCacheBuffer second(pool, kBlockSize, kNumHeads, kHeadDim);
+
+  ASSERT_EQ(first->Reserve(4), kTfLiteOk);
+  EXPECT_EQ(second.Reserve(1), kTfLiteError);
+  // Destroying a cache returns its blocks to the pool.
+  first.reset();
+  EXPECT_EQ(second.Reserve(4), kTfLiteOk);
+  EXPECT_GT(second.GetMemoryUsage(), 0);
+}
+
+}  // namespace resource
+}  // namespace tflite
@@ -18,6 +18,7 @@ limitations under the License.
 #include <cstddef>
 #include <vector>
 
+#include "tensorflow/lite/builtin_ops.h"
 #include "tensorflow/lite/context_util.h"
 #include "tensorflow/lite/core/c/common.h"
 
@@ -300,6 +301,25 @@ class PartitionGraphIntoIndependentNodeSubsetsImpl {
 };
 // LINT.ThenChange(//tensorflow/lite/delegates/utils.h)
 
+// Returns true if the node may share state with other nodes beyond its
+// tensors, and so must not run concurrently with any other node.
+bool MustRunAlone(const TfLiteNode& node,
+                  const TfLiteRegistration& registration) {
+  if (node.might_have_side_effect || node.delegate != nullptr) return true;
+  switch (registration.builtin_code) {
+    case kTfLiteBuiltinCustom:
+    case kTfLiteBuiltinIf:
+    case kTfLiteBuiltinWhile:
+    case kTfLiteBuiltinCallOnce:
+    case kTfLiteBuiltinStablehloWhile:
+    case kTfLiteBuiltinStablehloCase:
+    case kTfLiteBuiltinStablehloComposite:
+      return true;
+    default:
+      return false;
+  }
+}
+
 }  // namespace
 
 TfLiteStatus PartitionGraphIntoIndependentNodeSubsets(
@@ -336,4 +356,51 @@ TfLiteStatus PartitionGraphIntoIndependentNodeSubsets(
       .Partition();
 }
 
+std::vector<int> AssignConcurrentStages(GraphInfo* info) {
+  const size_t num_nodes = info->num_execution_nodes();
+  const size_t num_tensors = info->num_tensors();
+  const TfLiteTensor* tensors = info->tensors();
+  std::vector<int> stages(num_nodes, 0);
+  // Latest stage writing each tensor and latest stage reading it.
+  std::vector<int> last_write(num_tensors, -1);
+  std::vector<int> last_read(num_tensors, -1);
+  // Stage of the latest node that must run alone.
+  int barrier = -1;
+  int max_stage = -1;
+  for (size_t i = 0; i < num_nodes; ++i) {
+    const TfLiteNode& node = info->node(i);
+    int stage = barrier + 1;
+    if (MustRunAlone(node, info->registration(i))) {
+      stage = max_stage + 1;
+      barrier = stage;
+    } else {
+      for (int tensor : TfLiteIntArrayView(node.inputs)) {
+        if (!IsValidIndex(tensor, num_tensors)) continue;
+        stage = std::max(stage, last_write[tensor] + 1);
+        // Variable tensors are updated in place by the ops that read them.
+        if (tensors[tensor].is_variable) {
+          stage = std::max(stage, last_read[tensor] + 1);
+        }
+      }
+      for (int tensor : TfLiteIntArrayView(node.outputs)) {
+        if (!IsValidIndex(tensor, num_tensors)) continue;
+        stage = std::max(
+            {stage, last_write[tensor] + 1, last_read[tensor] + 1});
+      }
+    }
+    stages[i] = stage;
+    max_stage = std::max(max_stage, stage);
+    for (int tensor : TfLiteIntArrayView(node.inputs)) {
+      if (!IsValidIndex(tensor, num_tensors)) continue;
+      last_read[tensor] = std::max(last_read[tensor], stage);
+      if (tensors[tensor].is_variable) last_write[tensor] = stage;
+    }
+    for (int tensor : TfLiteIntArrayView(node.outputs)) {
+      if (!IsValidIndex(tensor, num_tensors)) continue;
+      last_write[tensor] = stage;
+    }
+  }
+  return stages;
+}
+
 }  // namespace tflite
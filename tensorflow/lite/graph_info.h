@@ -157,6 +157,20 @@ TfLiteStatus PartitionGraphIntoIndependentNodeSubsets(
     const ControlEdges* control_edges = nullptr,
     bool disable_node_fusion = false);
 
+// Groups the nodes of the execution plan of `*info` into stages that may run
+// concurrently, and returns the stage of each node in execution plan order.
+// Stage numbers start at zero and are non-decreasing along data dependencies:
+// a node is placed one stage after the latest node that produces one of its
+// inputs, that writes one of its outputs, or, for outputs and variable
+// inputs, that reads the previous contents. Nodes within one stage therefore
+// touch disjoint tensors except for shared read-only inputs.
+//
+// Nodes that might have side effects, control flow ops, custom ops and
+// delegate kernels may share state that is not visible through tensors. Each
+// of them gets a stage of its own, ordered after all nodes before it in the
+// execution plan and before all nodes after it.
+std::vector<int> AssignConcurrentStages(GraphInfo* info);
+
 }  // namespace tflite
 
 #endif  // TENSORFLOW_LITE_GRAPH_INFO_H_
@@ -28,6 +28,7 @@ limitations under the License.
 namespace tflite {
 namespace {
 
+using ::testing::ElementsAre;
 using ::testing::Eq;
 using ::testing::ExplainMatchResult;
 using ::testing::Pointwise;
@@ -768,5 +769,50 @@ TEST(PartitionTest, ComplexNonGreedily) {
                                 })));
 }
 
+// Same graph as above: the two branches after node 1 run side by side.
+TEST(AssignConcurrentStagesTest, IndependentBranchesShareStages) {
+  SimpleTestGraph graph(/*inputs=*/{0}, /*outputs=*/{4, 7},
+                        /*nodes=*/
+                        {
+                            {{0}, {1}, false},
+                            {{1}, {2, 5}, false},
+                            {{2}, {3}, false},
+                            {{3}, {4}, false},
+                            {{5}, {6}, false},
+                            {{6}, {7}, false},
+                        });
+  EXPECT_THAT(AssignConcurrentStages(&graph),
+              ElementsAre(0, 1, 2, 3, 2, 3));
+}
+
+TEST(AssignConcurrentStagesTest, SideEffectsRunAlone) {
+  SimpleTestGraph graph(/*inputs=*/{0}, /*outputs=*/{4, 7},
+                        /*nodes=*/
+                        {
+                            {{0}, {1}, false},
+                            {{1}, {2, 5}, false},
+                            {{2}, {3}, false},
+                            {{3}, {4}, false},
+                            {{5}, {6}, true},
+                            {{6}, {7}, false},
+                        });
+  EXPECT_THAT(AssignConcurrentStages(&graph),
+              ElementsAre(0, 1, 2, 3, 4, 5));
+}
+
+TEST(AssignConcurrentStagesTest, VariableUpdatesAreOrdered) {
+  SimpleTestGraph graph(/*inputs=*/{0}, /*outputs=*/{3, 4},
+                        /*nodes=*/
+                        {
+                            {{0}, {1}, false},
+                            {{1, 2}, {3}, false},
+                            {{2}, {4}, false},
+                        });
+  EXPECT_THAT(AssignConcurrentStages(&graph), ElementsAre(0, 1, 0));
+  // Node 1 updates variable 2 in place, so node 2 must see the update.
+  graph.tensor(2)->is_variable = true;
+  EXPECT_THAT(AssignConcurrentStages(&graph), ElementsAre(0, 1, 2));
+}
+
 }  // namespace
 }  // namespace tflite
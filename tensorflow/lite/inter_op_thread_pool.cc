@@ -0,0 +1,117 @@
+/* Copyright 2026 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#include "tensorflow/lite/inter_op_thread_pool.h"
+
+#include <algorithm>
+#include <functional>
+#include <memory>
+#include <mutex>  // NOLINT(build/c++11)
+#include <thread>  // NOLINT(build/c++11)
+
+#include "tensorflow/lite/core/c/common.h"
+#include "tensorflow/lite/external_cpu_backend_context.h"
+
+namespace tflite {
+namespace {
+
+// Cpu backend context of the pool worker running on this thread.
+thread_local TfLiteExternalContext* current_cpu_backend_context = nullptr;
+// True while this thread runs work of a `ParallelFor` call.
+thread_local bool in_parallel_for = false;
+
+}  // namespace
+
+InterOpThreadPool::InterOpThreadPool(int num_threads) {
+  const int num_workers = std::max(num_threads - 1, 0);
+  worker_contexts_.reserve(num_workers);
+  workers_.reserve(num_workers);
+  for (int i = 0; i < num_workers; ++i) {
+    worker_contexts_.push_back(std::make_unique<ExternalCpuBackendContext>());
+  }
+  for (int i = 0; i < num_workers; ++i) {
+    workers_.emplace_back([this, i] { WorkerLoop(i); });
+  }
+}
+
+InterOpThreadPool::~InterOpThreadPool() {
+  {
+    std::lock_guard<std::mutex> lock(mu_);
+    stop_ = true;
+  }
+  work_cv_.notify_all();
+  for (std::thread& worker : workers_) {
+    worker.join();
+  }
+}
+
+TfLiteExternalContext* InterOpThreadPool::CurrentCpuBackendContext() {
+  return current_cpu_backend_context;
+}
+
+void InterOpThreadPool::ParallelFor(int n, const std::function<void(int)>& fn) {
+  if (n <= 0) return;
+  if (n == 1 || workers_.empty() || in_parallel_for) {
+    for (int i = 0; i < n; ++i) fn(i);
+    return;
+  }
+  std::lock_guard<std::mutex> run_lock(run_mu_);
+  Job job;
+  job.fn = &fn;
+  job.n = n;
+  {
+    std::lock_guard<std::mutex> lock(mu_);
+    job_ = job;
+    next_index_.store(0, std::memory_order_relaxed);
+    busy_workers_ = static_cast<int>(workers_.size());
+    ++generation_;
+  }
+  work_cv_.notify_all();
+  RunJob(job);
+  std::unique_lock<std::mutex> lock(mu_);
+  done_cv_.wait(lock, [this] { return busy_workers_ == 0; });
+}
+
+void InterOpThreadPool::RunJob(const Job& job) {
+  in_parallel_for = true;
+  for (int i = next_index_.fetch_add(1, std::memory_order_relaxed); i < job.n;
+       i = next_index_.fetch_add(1, std::memory_order_relaxed)) {
+    (*job.fn)(i);
+  }
+  in_parallel_for = false;
+}
+
+void InterOpThreadPool::WorkerLoop(int worker_index) {
+  current_cpu_backend_context = worker_contexts_[worker_index].get();
+  int64_t seen_generation = 0;
+  while (true) {
+    Job job;
+    {
+      std::unique_lock<std::mutex> lock(mu_);
+      work_cv_.wait(lock, [this, seen_generation] {
+        return stop_ || generation_ != seen_generation;
+      });
+      if (stop_) return;
+      seen_generation = generation_;
+      job = job_;
+    }
+    RunJob(job);
+    {
+      std::lock_guard<std::mutex> lock(mu_);
+      if (--busy_workers_ == 0) done_cv_.notify_all();
+    }
+  }
+}
+
+}  // namespace tflite
@@ -0,0 +1,92 @@
+/* Copyright 2026 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#ifndef TENSORFLOW_LITE_INTER_OP_THREAD_POOL_H_
+#define TENSORFLOW_LITE_INTER_OP_THREAD_POOL_H_
+
+#include <atomic>
+#include <condition_variable>  // NOLINT(build/c++11)
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>  // NOLINT(build/c++11)
+#include <thread>  // NOLINT(build/c++11)
+#include <vector>
+
+#include "tensorflow/lite/core/c/common.h"
+#include "tensorflow/lite/external_cpu_backend_context.h"
+
+namespace tflite {
+
+// A small fixed-size thread pool that runs independent nodes of a subgraph
+// concurrently. It is owned by the interpreter and shared by its subgraphs.
+//
+// Kernels fetch their gemm/ruy state from the `kTfLiteCpuBackendContext`
+// external context, which is not thread-safe. Each worker thread therefore
+// owns its own `ExternalCpuBackendContext`, returned by
+// `CurrentCpuBackendContext()`, and the subgraph hands it to kernels running
+// on that worker. The backend context is lazily initialized on first use with
+// the subgraph's recommended number of threads, like the interpreter's own.
+class InterOpThreadPool {
+ public:
+  // `num_threads` includes the thread calling `ParallelFor`, so
+  // `num_threads - 1` workers are started.
+  explicit InterOpThreadPool(int num_threads);
+  ~InterOpThreadPool();
+  InterOpThreadPool(const InterOpThreadPool&) = delete;
+  InterOpThreadPool& operator=(const InterOpThreadPool&) = delete;
+
+  int num_threads() const { return static_cast<int>(workers_.size()) + 1; }
+
+  // Calls `fn(i)` for all `i` in [0, n) and returns once all calls returned.
+  // The calling thread takes part in the work. Calls from within `fn`, or
+  // while another thread is in `ParallelFor`, wait for the pool or run inline
+  // rather than deadlock.
+  void ParallelFor(int n, const std::function<void(int)>& fn);
+
+  // Returns the cpu backend context owned by the current worker thread, or
+  // nullptr if the calling thread is not a worker of any pool.
+  static TfLiteExternalContext* CurrentCpuBackendContext();
+
+ private:
+  struct Job {
+    const std::function<void(int)>* fn = nullptr;
+    int n = 0;
+  };
+
+  void WorkerLoop(int worker_index);
+  void RunJob(const Job& job);
+
+  std::vector<std::thread> workers_;
+  std::vector<std::unique_ptr<ExternalCpuBackendContext>> worker_contexts_;
+
+  // Serializes calls to `ParallelFor` from different threads.
+  std::mutex run_mu_;
+
+  std::mutex mu_;
+  std::condition_variable work_cv_;
+  std::condition_variable done_cv_;
+  Job job_;
+  // Incremented for every job so that each worker runs each job once.
+  int64_t generation_ = 0;
+  // Next index of the current job to hand out.
+  std::atomic<int> next_index_{0};
+  // Number of workers that did not finish the current job yet.
+  int busy_workers_ = 0;
+  bool stop_ = false;
+};
+
+}  // namespace tflite
+
+#endif  // TENSORFLOW_LITE_INTER_OP_THREAD_POOL_H_
@@ -0,0 +1,84 @@
+/* Copyright 2026 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#include "tensorflow/lite/inter_op_thread_pool.h"
+
+#include <atomic>
+#include <set>
+#include <thread>  // NOLINT(build/c++11)
+#include <vector>
+
+#include <gtest/gtest.h>
+
+namespace tflite {
+namespace {
+
+TEST(InterOpThreadPoolTest, RunsEveryIndexOnce) {
+  InterOpThreadPool pool(4);
+  EXPECT_EQ(pool.num_threads(), 4);
+  for (int n : {0, 1, 3, 100}) {
+    std::vector<std::atomic<int>> counts(n);
+    pool.ParallelFor(n, [&counts](int i) { ++counts[i]; });
+    for (int i = 0; i < n; ++i) {
+      EXPECT_EQ(counts[i].load(), 1) << "n = " << n << ", i = " << i;
+    }
+  }
+}
+
+TEST(InterOpThreadPoolTest, WorkersHaveOwnCpuBackendContext) {
+  EXPECT_EQ(InterOpThreadPool::CurrentCpuBackendContext(), nullptr);
+  InterOpThreadPool pool(3);
+  // Blocks every call until all threads of the pool are inside `ParallelFor`,
+  // so that each thread runs exactly one index.
+  std::atomic<int> arrived{0};
+  std::vector<TfLiteExternalContext*> contexts(3);
+  pool.ParallelFor(3, [&](int i) {
+    ++arrived;
+    while (arrived.load() < 3) std::this_thread::yield();
+    contexts[i] = InterOpThreadPool::CurrentCpuBackendContext();
+  });
+  std::set<TfLiteExternalContext*> workers;
+  int caller = 0;
+  for (TfLiteExternalContext* context : contexts) {
+    if (context == nullptr) {
+      ++caller;
+    } else {
+      EXPECT_EQ(context->type, kTfLiteCpuBackendContext);
+      workers.insert(context);
+    }
+  }
+  EXPECT_EQ(caller, 1);
+  EXPECT_EQ(workers.size(), 2);
+}
+
+TEST(InterOpThreadPoolTest, NestedCallsRunInline) {
+  InterOpThreadPool pool(2);
+  std::atomic<int> total{0};
+  pool.ParallelFor(4, [&](int) {
+    pool.ParallelFor(5, [&](int j) { total += j; });
+  });
+  EXPECT_EQ(total.load(), 4 * (0 + 1 + 2 + 3 + 4));
+}
+
+TEST(InterOpThreadPoolTest, SingleThreadRunsInline) {
+  InterOpThreadPool pool(1);
+  EXPECT_EQ(pool.num_threads(), 1);
+  const std::thread::id caller = std::this_thread::get_id();
+  pool.ParallelFor(3, [caller](int) {
+    EXPECT_EQ(std::this_thread::get_id(), caller);
+  });
+}
+
+}  // namespace
+}  // namespace tflite
@@ -170,6 +170,58 @@ class InterpreterOptions {
     return experimental_force_delegate_node_profiling_;
   }
 
+  // If value == true, the arena planner searches several allocation orders for
+  // the tensor offsets that give the smallest arena, instead of using a single
+  // greedy pass. This lowers peak memory at the cost of slower planning in
+  // `AllocateTensors`.
+  // WARNING: This is an experimental API and subject to change.
+  void SetOptimizeMemoryPlan(bool value = true) {
+    experimental_optimize_memory_plan_ = value;
+  }
+
+  bool GetOptimizeMemoryPlan() const {
+    return experimental_optimize_memory_plan_;
+  }
+
+  // Number of memory plans the arena planner keeps per subgraph, keyed by the
+  // sizes and lifetimes of its tensors. Models that switch between a few
+  // recurring input shapes then skip planning when a shape comes back. Zero
+  // disables the cache.
+  // WARNING: This is an experimental API and subject to change.
+  void SetMemoryPlanCacheSize(int value) {
+    experimental_memory_plan_cache_size_ = value;
+  }
+
+  int GetMemoryPlanCacheSize() const {
+    return experimental_memory_plan_cache_size_;
+  }
+
+  // Number of threads used to run independent nodes of a subgraph
+  // concurrently, including the thread calling `Invoke`. Values of one or
+  // less run nodes one at a time in execution plan order, which is the
+  // default.
+  //
+  // When enabled, the execution plan is grouped into stages of nodes that do
+  // not depend on each other, and the memory plan keeps the tensors of a stage
+  // apart so that its nodes can run at the same time. Stages run one after
+  // another. Nodes that may have side effects, control flow, custom ops and
+  // delegate kernels run alone in a stage. Subgraphs with dynamic tensors, an
+  // installed profiler or preserved intermediates always run sequentially, as
+  // does the first invocation after `AllocateTensors`.
+  //
+  // Each inter-op thread runs kernels with its own cpu backend context, so the
+  // total number of threads may reach this value times the number of threads
+  // set with `SetNumThreads`. Peak memory may grow, as fewer tensors share
+  // memory.
+  // WARNING: This is an experimental API and subject to change.
+  void SetNumInterOpThreads(int value) {
+    experimental_num_inter_op_threads_ = value;
+  }
+
+  int GetNumInterOpThreads() const {
+    return experimental_num_inter_op_threads_;
+  }
+
  private:
   bool experimental_preserve_all_tensors_ = false;
   bool experimental_ensure_dynamic_tensors_are_released_ = false;
@@ -181,6 +233,9 @@ class InterpreterOptions {
   bool experimental_compress_quantization_zero_points_ = false;
   bool experimental_disable_delegate_node_fusion_ = false;
   bool experimental_force_delegate_node_profiling_ = false;
+  bool experimental_optimize_memory_plan_ = false;
+  int experimental_memory_plan_cache_size_ = 0;
+  int experimental_num_inter_op_threads_ = 1;
 };
 
 }  // namespace tflite
@@ -433,6 +433,33 @@ TfLiteStatus SimpleMemoryArena::Allocate(
   return kTfLiteOk;
 }
 
+TfLiteStatus SimpleMemoryArena::AllocateAt(
+    TfLiteContext* context, size_t alignment, size_t offset, size_t size,
+    int32_t tensor, int32_t first_node, int32_t last_node,
+    ArenaAllocWithUsageInterval* new_alloc) {
+  TF_LITE_ENSURE(context, new_alloc != nullptr);
+  TF_LITE_ENSURE(context, alignment != 0);
+  TF_LITE_ENSURE(context, alignment <= underlying_buffer_.GetAlignment());
+  new_alloc->tensor = tensor;
+  new_alloc->first_node = first_node;
+  new_alloc->last_node = last_node;
+  new_alloc->size = size;
+  if (size == 0) {
+    new_alloc->offset = 0;
+    return kTfLiteOk;
+  }
+  TF_LITE_ENSURE(context, offset % alignment == 0);
+  size_t required_buffer_size = 0;
+  TF_LITE_ENSURE(context, CheckedAdd(offset, size, &required_buffer_size));
+  high_water_mark_ = std::max(high_water_mark_, required_buffer_size);
+  new_alloc->offset = offset;
+
+  auto insertion_it = std::upper_bound(active_allocs_.begin(),
+                                       active_allocs_.end(), *new_alloc);
+  active_allocs_.insert(insertion_it, *new_alloc);
+  return kTfLiteOk;
+}
+
 TfLiteStatus SimpleMemoryArena::Commit(bool* arena_reallocated) {
   if (arena_reallocated == nullptr) {
     return kTfLiteError;
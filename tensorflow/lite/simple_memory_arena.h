@@ -148,6 +148,15 @@ class SimpleMemoryArena {
                         int32_t tensor, int32_t first_node, int32_t last_node,
                         ArenaAllocWithUsageInterval* new_alloc);
 
+  // Schedule memory allocation for a tensor at a precomputed `offset`, e.g.
+  // from a cached or searched plan. The caller guarantees that it does not
+  // overlap any allocation whose usage interval intersects
+  // [first_node, last_node].
+  TfLiteStatus AllocateAt(TfLiteContext* context, size_t alignment,
+                          size_t offset, size_t size, int32_t tensor,
+                          int32_t first_node, int32_t last_node,
+                          ArenaAllocWithUsageInterval* new_alloc);
+
   TfLiteStatus Commit(bool* arena_reallocated);
 
   TfLiteStatus ResolveAlloc(TfLiteContext* context,
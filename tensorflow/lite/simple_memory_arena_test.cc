@@ -200,6 +200,32 @@ TEST(ResizableAlignedBufferTest,
   EXPECT_TRUE(allocator.arguments_valid());
 }
 
+TEST(SimpleMemoryArenaTest, AllocateAtPrecomputedOffsets) {
+  TfLiteContext context;
+  context.ReportError = ReportError;
+  SimpleMemoryArena arena(64);
+  ArenaAllocWithUsageInterval allocs[3];
+
+  ASSERT_EQ(arena.AllocateAt(&context, 32, 1024, 1000, 0, 0, 2, &allocs[0]),
+            kTfLiteOk);
+  ASSERT_EQ(arena.AllocateAt(&context, 32, 0, 1000, 1, 1, 3, &allocs[1]),
+            kTfLiteOk);
+  EXPECT_EQ(allocs[0].offset, 1024);
+  EXPECT_EQ(allocs[1].offset, 0);
+
+  // Misaligned offsets are rejected.
+  EXPECT_EQ(arena.AllocateAt(&context, 32, 16, 8, 2, 3, 3, &allocs[2]),
+            kTfLiteError);
+
+  // Greedy allocations see the precomputed ones.
+  ASSERT_EQ(arena.Allocate(&context, 32, 8, 2, 3, 3, &allocs[2]), kTfLiteOk);
+  EXPECT_EQ(allocs[2].offset, 1024);
+
+  bool reallocated = false;
+  ASSERT_EQ(arena.Commit(&reallocated), kTfLiteOk);
+  EXPECT_EQ(arena.GetBufferSize(), 2024);
+}
+
 TEST(SimpleMemoryArenaTest, BasicZeroAlloc) {
   TfLiteContext context;
   SimpleMemoryArena arena(64);
@@ -701,6 +701,8 @@ BenchmarkParams BenchmarkTfLiteModel::DefaultParams() {
                           BenchmarkParam::Create<bool>(false));
   default_params.AddParam("optimize_memory_for_large_tensors",
                           BenchmarkParam::Create<int32_t>(0));
+  default_params.AddParam("num_inter_op_threads",
+                          BenchmarkParam::Create<int32_t>(1));
   default_params.AddParam("disable_delegate_clustering",
                           BenchmarkParam::Create<bool>(false));
   default_params.AddParam("enable_builtin_cast_constant_cache",
@@ -810,6 +812,10 @@ std::vector<Flag> BenchmarkTfLiteModel::GetFlags() {
       CreateFlag<int32_t>(
           "optimize_memory_for_large_tensors", &params_,
           "Optimize memory usage for large tensors with sacrificing latency."),
+      CreateFlag<int32_t>(
+          "num_inter_op_threads", &params_,
+          "Number of threads used to run independent nodes of the graph "
+          "concurrently. 1 runs the nodes one after another."),
       CreateFlag<bool>("disable_delegate_clustering", &params_,
                        "Disable delegate clustering."),
       CreateFlag<bool>(
@@ -901,6 +907,8 @@ void BenchmarkTfLiteModel::LogParams() {
                       "Release dynamic tensor memory", verbose);
   LOG_BENCHMARK_PARAM(int32_t, "optimize_memory_for_large_tensors",
                       "Optimize memory usage for large tensors", verbose);
+  LOG_BENCHMARK_PARAM(int32_t, "num_inter_op_threads",
+                      "Num inter-op threads", verbose);
   LOG_BENCHMARK_PARAM(bool, "disable_delegate_clustering",
                       "Disable delegate clustering", verbose);
   LOG_BENCHMARK_PARAM(bool, "enable_builtin_cast_constant_cache",
@@ -1134,6 +1142,7 @@ TfLiteStatus BenchmarkTfLiteModel::InitInterpreter() {
       params_.Get<bool>("release_dynamic_tensors"));
   options.OptimizeMemoryForLargeTensors(
       params_.Get<int32_t>("optimize_memory_for_large_tensors"));
+  options.SetNumInterOpThreads(params_.Get<int32_t>("num_inter_op_threads"));
   options.SetDisableDelegateClustering(
       params_.Get<bool>("disable_delegate_clustering"));
   options.SetCacheConstantCastOp(
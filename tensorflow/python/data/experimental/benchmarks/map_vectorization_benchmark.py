@@ -0,0 +1,127 @@
+# Copyright 2026 The TensorFlow Authors. All Rights Reserved.
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+# ==============================================================================
+"""Benchmarks for the `MapVectorization` optimization."""
+import numpy as np
+
+from tensorflow.core.example import example_pb2
+from tensorflow.core.example import feature_pb2
+from tensorflow.python.data.benchmarks import benchmark_base
+from tensorflow.python.data.ops import dataset_ops
+from tensorflow.python.data.ops import options as options_lib
+from tensorflow.python.framework import dtypes
+from tensorflow.python.ops import array_ops
+from tensorflow.python.ops import math_ops
+from tensorflow.python.ops import parsing_ops
+
+_NUMPY_RANDOM_SEED = 42
+_NUM_FEATURES = 16
+
+
+def _make_examples(num_examples):
+  """Returns `num_examples` serialized examples with a dense float feature."""
+  np.random.seed(_NUMPY_RANDOM_SEED)
+  examples = []
+  for _ in range(num_examples):
+    example = example_pb2.Example(
+        features=feature_pb2.Features(
+            feature={
+                "x":
+                    feature_pb2.Feature(
+                        float_list=feature_pb2.FloatList(
+                            value=np.random.rand(_NUM_FEATURES))),
+            }))
+    examples.append(example.SerializeToString())
+  return examples
+
+
+class MapVectorizationBenchmark(benchmark_base.DatasetBenchmarkBase):
+  """Benchmarks for the `MapVectorization` optimization."""
+
+  def _benchmark_map_and_batch(self, label, map_fn, input_dataset, batch_size,
+                               benchmark_id):
+    """Compares `map(map_fn).batch()` with and without vectorization."""
+    for map_vectorization in [False, True]:
+      dataset = input_dataset.map(map_fn).batch(batch_size)
+      options = options_lib.Options()
+      options.experimental_optimization.apply_default_optimizations = False
+      options.experimental_optimization.map_vectorization = map_vectorization
+      dataset = dataset.with_options(options)
+      self.run_and_report_benchmark(
+          dataset=dataset,
+          num_elements=100,
+          iters=10,
+          warmup=True,
+          extras={
+              "model_name": "map_vectorization.benchmark.%d" % benchmark_id,
+              "parameters": "%d.%s" % (batch_size, map_vectorization),
+          },
+          name="%s_batch_size_%d_%s" %
+          (label, batch_size,
+           "vectorized" if map_vectorization else "unvectorized"))
+
+  def benchmark_parse_and_normalize(self):
+    """Benchmarks parsing and normalizing a dense feature."""
+    mean = np.full([_NUM_FEATURES], 0.5, dtype=np.float32)
+    stddev = np.full([_NUM_FEATURES], 0.3, dtype=np.float32)
+
+    def parse_and_normalize(serialized):
+      features = parsing_ops.parse_single_example(
+          serialized, {
+              "x": parsing_ops.FixedLenFeature([_NUM_FEATURES], dtypes.float32)
+          })
+      return (features["x"] - mean) / stddev
+
+    examples = dataset_ops.Dataset.from_tensor_slices(
+        _make_examples(1024)).repeat()
+    for batch_size in [16, 128, 1024]:
+      self._benchmark_map_and_batch(
+          label="parse_and_normalize",
+          map_fn=parse_and_normalize,
+          input_dataset=examples,
+          batch_size=batch_size,
+          benchmark_id=1)
+
+  def benchmark_elementwise(self):
+    """Benchmarks a chain of element-wise ops."""
+
+    def elementwise(x):
+      x = math_ops.cast(x, dtypes.float32)
+      return math_ops.sigmoid(x * 0.01 + 1.0)
+
+    for batch_size in [16, 128, 1024]:
+      self._benchmark_map_and_batch(
+          label="elementwise",
+          map_fn=elementwise,
+          input_dataset=dataset_ops.Dataset.range(1000000000),
+          batch_size=batch_size,
+          benchmark_id=2)
+
+  def benchmark_map_defun_fallback(self):
+    """Benchmarks a function that falls back to `MapDefun`."""
+
+    def fallback(x):
+      return math_ops.reduce_sum(array_ops.fill([_NUM_FEATURES], x))
+
+    for batch_size in [16, 128, 1024]:
+      self._benchmark_map_and_batch(
+          label="map_defun_fallback",
+          map_fn=fallback,
+          input_dataset=dataset_ops.Dataset.range(1000000000),
+          batch_size=batch_size,
+          benchmark_id=3)
+
+
+if __name__ == "__main__":
+  benchmark_base.test.main()
@@ -0,0 +1,117 @@
+# Copyright 2026 The TensorFlow Authors. All Rights Reserved.
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+# ==============================================================================
+"""Tests for the `MapVectorization` optimization."""
+from absl.testing import parameterized
+
+from tensorflow.core.example import example_pb2
+from tensorflow.core.example import feature_pb2
+from tensorflow.python.data.experimental.ops import testing
+from tensorflow.python.data.kernel_tests import test_base
+from tensorflow.python.data.ops import dataset_ops
+from tensorflow.python.data.ops import options as options_lib
+from tensorflow.python.framework import combinations
+from tensorflow.python.framework import dtypes
+from tensorflow.python.ops import array_ops
+from tensorflow.python.ops import math_ops
+from tensorflow.python.ops import parsing_ops
+from tensorflow.python.ops import random_ops
+from tensorflow.python.platform import test
+
+
+def _with_map_vectorization(dataset):
+  options = options_lib.Options()
+  options.experimental_optimization.apply_default_optimizations = False
+  options.experimental_optimization.map_vectorization = True
+  return dataset.with_options(options)
+
+
+class MapVectorizationTest(test_base.DatasetTestBase, parameterized.TestCase):
+
+  @combinations.generate(
+      combinations.times(test_base.default_test_combinations(),
+                         combinations.combine(drop_remainder=[True, False])))
+  def testElementwiseFunction(self, drop_remainder):
+    dataset = dataset_ops.Dataset.range(10).apply(
+        testing.assert_next(["Batch", "Map"])).map(lambda x: x * 2 + 1).batch(
+            3, drop_remainder=drop_remainder)
+    dataset = _with_map_vectorization(dataset)
+    expected_output = [[1, 3, 5], [7, 9, 11], [13, 15, 17]]
+    if not drop_remainder:
+      expected_output.append([19])
+    self.assertDatasetProduces(dataset, expected_output=expected_output)
+
+  @combinations.generate(test_base.default_test_combinations())
+  def testNonElementwiseFunction(self):
+
+    def fn(x):
+      return math_ops.reduce_sum(array_ops.fill([3], x))
+
+    dataset = dataset_ops.Dataset.range(6).apply(
+        testing.assert_next(["Batch", "Map"])).map(fn).batch(4)
+    dataset = _with_map_vectorization(dataset)
+    self.assertDatasetProduces(
+        dataset, expected_output=[[0, 3, 6, 9], [12, 15]])
+
+  @combinations.generate(test_base.default_test_combinations())
+  def testParseAndNormalize(self):
+
+    def make_example(i):
+      example = example_pb2.Example(
+          features=feature_pb2.Features(
+              feature={
+                  "x":
+                      feature_pb2.Feature(
+                          float_list=feature_pb2.FloatList(
+                              value=[i, 2 * i]))
+              }))
+      return example.SerializeToString()
+
+    def parse_and_normalize(serialized):
+      features = parsing_ops.parse_single_example(
+          serialized, {"x": parsing_ops.FixedLenFeature([2], dtypes.float32)})
+      return (features["x"] - [1.0, 2.0]) / 2.0
+
+    dataset = dataset_ops.Dataset.from_tensor_slices(
+        [make_example(i) for i in range(4)]).apply(
+            testing.assert_next(["Batch", "Map"])).map(
+                parse_and_normalize).batch(2)
+    dataset = _with_map_vectorization(dataset)
+    self.assertDatasetProduces(
+        dataset,
+        expected_output=[[[-0.5, -1.0], [0.0, 0.0]], [[0.5, 1.0], [1.0, 2.0]]])
+
+  @combinations.generate(test_base.default_test_combinations())
+  def testNoVectorizationForUnknownShapes(self):
+    dataset = dataset_ops.Dataset.range(1, 4).map(
+        lambda x: array_ops.fill([x], x)).apply(
+            testing.assert_next(["Map", "Batch"])).map(
+                math_ops.reduce_sum).batch(2)
+    dataset = _with_map_vectorization(dataset)
+    self.assertDatasetProduces(dataset, expected_output=[[1, 4], [9]])
+
+  @combinations.generate(test_base.default_test_combinations())
+  def testNoVectorizationForStatefulFunction(self):
+
+    def fn(x):
+      return x + math_ops.cast(random_ops.random_uniform([]) * 0, dtypes.int64)
+
+    dataset = dataset_ops.Dataset.range(4).apply(
+        testing.assert_next(["Map", "Batch"])).map(fn).batch(2)
+    dataset = _with_map_vectorization(dataset)
+    self.assertDatasetProduces(dataset, expected_output=[[0, 1], [2, 3]])
+
+
+if __name__ == "__main__":
+  test.main()
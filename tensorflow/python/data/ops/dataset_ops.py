@@ -1549,6 +1549,14 @@ class DatasetV2(
     # [0, 1, 2, 3, 4]
     ```
 
+    When the filename starts with `mmap://`, the elements are cached in memory
+    and, once the cache is complete, also published to an arena file at the
+    rest of the filename (e.g. `mmap:///dev/shm/train_cache`). Other processes
+    on the same host, and restarted ones, map the arena read-only instead of
+    rebuilding the cache, so they share a single copy of the cached data. An
+    arena is only reused by datasets whose input pipeline has the same
+    fingerprint as the one that published it.
+
     Note: `cache` will produce exactly the same elements during each iteration
     through the dataset. If you wish to randomize the iteration order, make sure
     to call `shuffle` *after* calling `cache`.
@@ -45,12 +45,18 @@ class AutotuneAlgorithm(enum.Enum):
 
   STAGE_BASED: In each optimization step, this algorithm chooses the worst
   bottleneck parameter and increases its value by 1.
+
+  LEARNED_COST: Similar to STAGE_BASED but predicts the processing time of each
+  transformation from a cost model fit to the processing times it recorded at
+  different parallelism values, so that parallelism is not increased when
+  contention between parallel calls makes it ineffective.
   """
   DEFAULT = 0
   HILL_CLIMB = 1
   GRADIENT_DESCENT = 2
   MAX_PARALLELISM = 3
   STAGE_BASED = 4
+  LEARNED_COST = 5
 
   @classmethod
   def _to_proto(cls, obj):
@@ -64,9 +70,12 @@ class AutotuneAlgorithm(enum.Enum):
       return model_pb2.AutotuneAlgorithm.MAX_PARALLELISM
     if obj == cls.STAGE_BASED:
       return model_pb2.AutotuneAlgorithm.STAGE_BASED
+    if obj == cls.LEARNED_COST:
+      return model_pb2.AutotuneAlgorithm.LEARNED_COST
     raise ValueError(
         f"Invalid `obj.` Supported values include `DEFAULT`, `HILL_CLIMB` "
-        f"`GRADIENT_DESCENT`, and `STAGE_BASED`. Got {obj.name}.")
+        f"`GRADIENT_DESCENT`, `STAGE_BASED`, and `LEARNED_COST`. Got "
+        f"{obj.name}.")
 
   @classmethod
   def _from_proto(cls, pb):
@@ -80,9 +89,11 @@ class AutotuneAlgorithm(enum.Enum):
       return cls.MAX_PARALLELISM
     if pb == model_pb2.AutotuneAlgorithm.STAGE_BASED:
       return cls.STAGE_BASED
+    if pb == model_pb2.AutotuneAlgorithm.LEARNED_COST:
+      return cls.LEARNED_COST
     raise ValueError(
         f"Invalid `pb.` Supported values include `DEFAULT`, `HILL_CLIMB`, "
-        f"`GRADIENT_DESCENT` and `STAGE_BASED`. Got {pb}.")
+        f"`GRADIENT_DESCENT`, `STAGE_BASED` and `LEARNED_COST`. Got {pb}.")
 
 
 @tf_export("data.experimental.AutoShardPolicy")
@@ -251,6 +262,19 @@ class AutotuneOptions(options_lib.OptionsBase):
       ),
   )
 
+  performance_model_path = options_lib.create_option(
+      name="performance_model_path",
+      ty=str,
+      docstring=(
+          "When autotuning is enabled (through `autotune`), the path of a file"
+          " to which autotuning periodically saves its performance model,"
+          " including the processing times recorded for each transformation."
+          " If the file exists when the iterator is created, autotuning is"
+          " warm-started from the model saved by a previous run of the same"
+          " input pipeline. If None, autotuning starts from scratch."
+      ),
+  )
+
   def _to_proto(self):
     pb = dataset_options_pb2.AutotuneOptions()
     if self.enabled is not None:
@@ -266,6 +290,8 @@ class AutotuneOptions(options_lib.OptionsBase):
       pb.initial_parallelism = self.initial_parallelism
     if self.min_parallelism is not None:
       pb.min_parallelism = self.min_parallelism
+    if self.performance_model_path is not None:
+      pb.performance_model_path = self.performance_model_path
     return pb
 
   def _from_proto(self, pb):
@@ -282,6 +308,8 @@ class AutotuneOptions(options_lib.OptionsBase):
       self.initial_parallelism = pb.initial_parallelism
     if pb.WhichOneof("optional_min_parallelism") is not None:
       self.min_parallelism = pb.min_parallelism
+    if pb.WhichOneof("optional_performance_model_path") is not None:
+      self.performance_model_path = pb.performance_model_path
 
   def _set_mutable(self, mutable):
     """Change the mutability value to `mutable` on this options and children."""
@@ -415,6 +443,18 @@ class OptimizationOptions(options_lib.OptionsBase):
       "Whether to parallelize stateless map transformations. If None, defaults "
       "to True.")
 
+  map_vectorization = options_lib.create_option(
+      name="map_vectorization",
+      ty=bool,
+      docstring=(
+          "Whether to vectorize stateless map transformations followed by"
+          " batch, so that the map function is invoked once per batch instead"
+          " of once per element. Only applies if the input elements of the map"
+          " have fully defined shapes. If the map function fails on an element,"
+          " the whole batch fails. If None, defaults to False."
+      ),
+  )
+
   noop_elimination = options_lib.create_option(
       name="noop_elimination",
       ty=bool,
@@ -453,6 +493,8 @@ class OptimizationOptions(options_lib.OptionsBase):
       pb.map_fusion = self.map_fusion
     if self.map_parallelization is not None:
       pb.map_parallelization = self.map_parallelization
+    if self.map_vectorization is not None:
+      pb.map_vectorization = self.map_vectorization
     if self.noop_elimination is not None:
       pb.noop_elimination = self.noop_elimination
     if self.parallel_batch is not None:
@@ -480,6 +522,8 @@ class OptimizationOptions(options_lib.OptionsBase):
       self.map_fusion = pb.map_fusion
     if pb.WhichOneof("optional_map_parallelization") is not None:
       self.map_parallelization = pb.map_parallelization
+    if pb.WhichOneof("optional_map_vectorization") is not None:
+      self.map_vectorization = pb.map_vectorization
     if pb.WhichOneof("optional_noop_elimination") is not None:
       self.noop_elimination = pb.noop_elimination
     if pb.WhichOneof("optional_parallel_batch") is not None: